@@ -23,6 +23,7 @@
 class SubmitReduction;
 
 class APBSParameters;
+struct sIapbsSession;
 
 class GlobalMasterAPBS : public GlobalMaster {
  public: 
@@ -56,6 +57,8 @@ class GlobalMasterAPBS : public GlobalMaster {
   // in-memory grid data, ignored now
   double apbsgrid_meta[13];
   double *apbsgrid[0];
+  // persistent APBS setups for the solvent and vacuum calculations
+  struct sIapbsSession *session[2];
 
   // perform the actual APBS call.  If in_vacuum is true, ion concentrations
   // will be set to zero, and solvent dielectric will be set to the value of
@@ -26,6 +26,179 @@
 
 VEMBED(rcsid="$Id: apbs_driver.c rok $")
 
+/**
+ * @brief  Build the APBS input from the iAPBS parameters and parse it
+ * @return  The parsed input, or VNULL on error
+ */
+VPRIVATE NOsh *parseInputString(int rank, int size, double r_param[9],
+	int i_param[25], double grid[3], int dime[3], double ionq[MAXION],
+	double ionc[MAXION], double ionr[MAXION], double glen[3],
+	double center[3], double cglen[3], double fglen[3],
+	double ccenter[3], double fcenter[3], double *ofrac, int pdime[3],
+	int debug)
+{
+    NOsh *nosh = VNULL;
+    Vio *sock = VNULL;
+    char *inputString = VNULL;
+    int bufsize = MAX_BUF_SIZE;
+
+    nosh = NOsh_ctor(rank, size);
+
+//    sock = Vio_ctor("FILE", "ASC", VNULL, input_path, "r");
+//    Vnm_tprint( 1, "Parsing input file %s...\n", input_path);
+    
+    VASSERT( bufsize <= VMAX_BUFSIZE );
+    sock = Vio_ctor("BUFF","ASC",VNULL,"0","r");
+
+    /* generate input string */
+    inputString = setupString(r_param, i_param, grid, dime, ionq, ionc, 
+		  ionr, glen, center, cglen, fglen, ccenter, fcenter, ofrac, 
+		  pdime, debug);
+    if(debug>2) Vnm_tprint(1, "debug: Input string:\n%s\n", inputString);
+    Vio_bufTake(sock, inputString, bufsize);
+
+    if (!NOsh_parseInput(nosh, sock)) {
+	Vnm_tprint( 2, "Error while parsing input string.\n");
+	sock->VIObuffer = VNULL;
+	Vio_dtor(&sock);
+	NOsh_dtor(&nosh);
+	return VNULL;
+    } else if(debug>1) Vnm_tprint( 1, "Parsed input string.\n");
+    
+    sock->VIObuffer = VNULL;
+    Vio_dtor(&sock);
+
+    return nosh;
+}
+
+/**
+ * @brief  Move the atoms of a list and update its bounding box and center
+ */
+VPRIVATE void setPositions(Valist *alist, double x[NATOMS],
+	double y[NATOMS], double z[NATOMS])
+{
+    int i;
+    double coord[3];
+
+    alist->maxcrd[0] = -VLARGE;
+    alist->maxcrd[1] = -VLARGE;
+    alist->maxcrd[2] = -VLARGE;
+    alist->mincrd[0] = VLARGE;
+    alist->mincrd[1] = VLARGE;
+    alist->mincrd[2] = VLARGE;
+
+    for (i=0; i<alist->number; i++) {
+	if (x[i] < alist->mincrd[0]) alist->mincrd[0] = x[i];
+	if (y[i] < alist->mincrd[1]) alist->mincrd[1] = y[i];
+	if (z[i] < alist->mincrd[2]) alist->mincrd[2] = z[i];
+	if (x[i] > alist->maxcrd[0]) alist->maxcrd[0] = x[i];
+	if (y[i] > alist->maxcrd[1]) alist->maxcrd[1] = y[i];
+	if (z[i] > alist->maxcrd[2]) alist->maxcrd[2] = z[i];
+
+	coord[0] = x[i];
+	coord[1] = y[i];
+	coord[2] = z[i];
+	Vatom_setPosition(&(alist->atoms)[i], coord);
+    }
+
+    alist->center[0] = 0.5*(alist->maxcrd[0] + alist->mincrd[0]);
+    alist->center[1] = 0.5*(alist->maxcrd[1] + alist->mincrd[1]);
+    alist->center[2] = 0.5*(alist->maxcrd[2] + alist->mincrd[2]);
+}
+
+/**
+ * @brief  Build the atom list of the molecule
+ * @return  The new atom list
+ */
+VPRIVATE Valist *setupAtoms(int nat, double x[NATOMS], double y[NATOMS],
+	double z[NATOMS], double radius[NATOMS], double charge[NATOMS])
+{
+    int i;
+    Valist *alist = VNULL;
+
+    alist = Valist_ctor();
+
+    alist->center[0] = 0.;
+    alist->center[1] = 0.;
+    alist->center[2] = 0.;
+    alist->maxrad = 0.;
+    alist->charge = 0.;
+
+    alist->number = nat;
+    /* Allocate the necessary space for the atom array */
+    alist->atoms = Vmem_malloc(alist->vmem, alist->number,
+	    (sizeof(Vatom)));
+    VASSERT(alist->atoms != VNULL);
+
+
+    for (i=0; i<alist->number; i++) {
+	/* Fill atoms in the atom list */
+
+	/* atom[i]->partID = 1; FIXME */
+
+	if (radius[i] > alist->maxrad) alist->maxrad = radius[i];
+	alist->charge = alist->charge + charge[i];
+
+	Vatom_setCharge(&(alist->atoms)[i], charge[i]);
+	Vatom_setRadius(&(alist->atoms)[i], radius[i]);
+	Vatom_setAtomID(&(alist->atoms)[i], i);
+	// not necessary? Vatom_setPartID(&(alist->atoms)[i, );
+    }
+
+    setPositions(alist, x, y, z);
+
+    return alist;
+}
+
+/**
+ * @brief  Copy the forces of a calculation to the iAPBS arrays in kJ/(mol A)
+ */
+VPRIVATE void copyForces(PBEparm *pbeparm, AtomForce *atomForce, int natom,
+	double apbsdx[NATOMS], double apbsdy[NATOMS], double apbsdz[NATOMS],
+	double apbsqfx[NATOMS], double apbsqfy[NATOMS], double apbsqfz[NATOMS],
+	double apbsibx[NATOMS], double apbsiby[NATOMS], double apbsibz[NATOMS],
+	double apbsdbx[NATOMS], double apbsdby[NATOMS], double apbsdbz[NATOMS])
+{
+    int j, nf;
+    double scale;
+
+    /* calcforce total stores the net force in the first entry */
+    if (pbeparm->calcforce == PCF_TOTAL) {
+	nf = 1;
+    } else if (pbeparm->calcforce == PCF_COMPS) {
+	nf = natom;
+    } else {
+	return;
+    }
+
+    scale = Vunit_kb*pbeparm->temp*(1e-3)*Vunit_Na;
+    for (j=0; j < nf; j++) {
+
+	apbsdx[j] = scale * (atomForce[j].qfForce[0] +
+			     atomForce[j].ibForce[0] +
+			     atomForce[j].dbForce[0]);
+	apbsdy[j] = scale * (atomForce[j].qfForce[1] +
+			     atomForce[j].ibForce[1] +
+			     atomForce[j].dbForce[1]);
+	apbsdz[j] = scale * (atomForce[j].qfForce[2] +
+			     atomForce[j].ibForce[2] +
+			     atomForce[j].dbForce[2]);
+
+	/* individual components */
+	apbsqfx[j] = scale * atomForce[j].qfForce[0];
+	apbsqfy[j] = scale * atomForce[j].qfForce[1];
+	apbsqfz[j] = scale * atomForce[j].qfForce[2];
+
+	apbsibx[j] = scale * atomForce[j].ibForce[0];
+	apbsiby[j] = scale * atomForce[j].ibForce[1];
+	apbsibz[j] = scale * atomForce[j].ibForce[2];
+
+	apbsdbx[j] = scale * atomForce[j].dbForce[0];
+	apbsdby[j] = scale * atomForce[j].dbForce[1];
+	apbsdbz[j] = scale * atomForce[j].dbForce[2];
+    }
+}
+
 /**
  * @brief  Wrapper iAPBS function
  * @author Robert Konecny
@@ -89,7 +262,6 @@ int apbsdrv_(
 
     Vmem *mem = VNULL;
     Vcom *com = VNULL;
-    Vio *sock = VNULL;
 #ifdef HAVE_MC_H
     Vfetk *fetk[NOSH_MAXCALC];
     Gem *gm[NOSH_MAXMOL];
@@ -112,10 +284,7 @@ int apbsdrv_(
     size_t bytesTotal, highWater;
     Voutput_Format outputformat;
 
-    int bufsize = MAX_BUF_SIZE;
     int rc = 0;
-    double coord[3];
-    char *inputString;
 
     /* These variables require some explaining... The energy double arrays
      * store energies from the various calculations.  The energy int array
@@ -173,31 +342,14 @@ int apbsdrv_(
 
 
     /* *************** PARSE INPUT FILE ******************* */
-    nosh = NOsh_ctor(rank, size);
-
-//    sock = Vio_ctor("FILE", "ASC", VNULL, input_path, "r");
-//    Vnm_tprint( 1, "Parsing input file %s...\n", input_path);
-    
-    VASSERT( bufsize <= VMAX_BUFSIZE );
-    sock = Vio_ctor("BUFF","ASC",VNULL,"0","r");
-
     debug = *dbg;
 
-    /* generate input string */
-    inputString = VNULL;
-    inputString = setupString(r_param, i_param, grid, dime, ionq, ionc, 
-		  ionr, glen, center, cglen, fglen, ccenter, fcenter, ofrac, 
-		  pdime, debug);
-    if(debug>2) Vnm_tprint(1, "debug: Input string:\n%s\n", inputString);
-    Vio_bufTake(sock, inputString, bufsize);
-
-    if (!NOsh_parseInput(nosh, sock)) {
-	Vnm_tprint( 2, "Error while parsing input string.\n");
+    nosh = parseInputString(rank, size, r_param, i_param, grid, dime, ionq,
+			    ionc, ionr, glen, center, cglen, fglen, ccenter,
+			    fcenter, ofrac, pdime, debug);
+    if (nosh == VNULL) {
 	VJMPERR1(0);
-    } else if(debug>1) Vnm_tprint( 1, "Parsed input string.\n");
-    
-    sock->VIObuffer = VNULL;
-    Vio_dtor(&sock);
+    }
 
 
     /* *************** LOAD PARAMETERS AND MOLECULES ******************* */
@@ -212,55 +364,8 @@ int apbsdrv_(
 */
 
     /* alist fills nosh */
-    alist[0] = Valist_ctor();
-
-    alist[0]->center[0] = 0.;
-    alist[0]->center[1] = 0.;
-    alist[0]->center[2] = 0.;
-    alist[0]->maxcrd[0] = -VLARGE;
-    alist[0]->maxcrd[1] = -VLARGE;
-    alist[0]->maxcrd[2] = -VLARGE;
-    alist[0]->mincrd[0] = VLARGE;
-    alist[0]->mincrd[1] = VLARGE;
-    alist[0]->mincrd[2] = VLARGE;
-    alist[0]->maxrad = 0.;
-    alist[0]->charge = 0.;
-
-    alist[0]->number = *nat;
+    alist[0] = setupAtoms(*nat, x, y, z, radius, charge);
     natom =  alist[0]->number;
-    /* Allocate the necessary space for the atom array */
-    alist[0]->atoms = Vmem_malloc(alist[0]->vmem, alist[0]->number,
-	    (sizeof(Vatom)));
-    VASSERT(alist[0]->atoms != VNULL);
-
-
-    for (i=0; i<alist[0]->number; i++) {
-	/* Fill atoms in the atom list */
-
-	/* atom[i]->partID = 1; FIXME */
-
-	if (x[i] < alist[0]->mincrd[0]) alist[0]->mincrd[0] = x[i];
-	if (y[i] < alist[0]->mincrd[1]) alist[0]->mincrd[1] = y[i];
-	if (z[i] < alist[0]->mincrd[2]) alist[0]->mincrd[2] = z[i];
-	if (x[i] > alist[0]->maxcrd[0]) alist[0]->maxcrd[0] = x[i];
-	if (y[i] > alist[0]->maxcrd[1]) alist[0]->maxcrd[1] = y[i];
-	if (z[i] > alist[0]->maxcrd[2]) alist[0]->maxcrd[2] = z[i];
-	if (radius[i] > alist[0]->maxrad) alist[0]->maxrad = radius[i];
-	alist[0]->charge = alist[0]->charge + charge[i];
-
-	coord[0] = x[i];
-	coord[1] = y[i];
-	coord[2] = z[i];
-	Vatom_setPosition(&(alist[0]->atoms)[i], coord);
-	Vatom_setCharge(&(alist[0]->atoms)[i], charge[i]);
-	Vatom_setRadius(&(alist[0]->atoms)[i], radius[i]);
-	Vatom_setAtomID(&(alist[0]->atoms)[i], i);
-	// not necessary? Vatom_setPartID(&(alist[0]->atoms)[i, );
-    }
-
-    alist[0]->center[0] = 0.5*(alist[0]->maxcrd[0] + alist[0]->mincrd[0]);
-    alist[0]->center[1] = 0.5*(alist[0]->maxcrd[1] + alist[0]->mincrd[1]);
-    alist[0]->center[2] = 0.5*(alist[0]->maxcrd[2] + alist[0]->mincrd[2]);
 
     /* *************** SETUP CALCULATIONS *************** */
     if (NOsh_setupElecCalc(nosh, alist) != 1) {
@@ -389,85 +494,10 @@ int apbsdrv_(
 		forceMG(mem, nosh, pbeparm, mgparm, pmg[i], &(nforce[i]), 
 			&(atomForce[i]), alist);
 		
-		//if (pbeparm->calcforce > 0 && i == nosh->ncalc-1) {
-		if (pbeparm->calcforce == PCF_TOTAL) {
-		  //		  Vnm_tprint(2, "pcf_total\n");
-		  apbsdx[0] = Vunit_kb*pbeparm->temp*(1e-3)*Vunit_Na *
-		    (atomForce[i][0].qfForce[0] +
-		     atomForce[i][0].ibForce[0] +
-		     atomForce[i][0].dbForce[0]);
-		  apbsdy[0] = Vunit_kb*pbeparm->temp*(1e-3)*Vunit_Na *
-		    (atomForce[i][0].qfForce[1] +
-		     atomForce[i][0].ibForce[1] +
-		     atomForce[i][0].dbForce[1]);
-		  apbsdz[0] = Vunit_kb*pbeparm->temp*(1e-3)*Vunit_Na *
-		    (atomForce[i][0].qfForce[2] +
-		     atomForce[i][0].ibForce[2] +
-		     atomForce[i][0].dbForce[2]);
-
-		  apbsqfx[0] = Vunit_kb*pbeparm->temp*(1e-3)*Vunit_Na *
-		    atomForce[i][0].qfForce[0];
-		  apbsqfy[0] = Vunit_kb*pbeparm->temp*(1e-3)*Vunit_Na *
-		    atomForce[i][0].qfForce[1];
-		  apbsqfz[0] = Vunit_kb*pbeparm->temp*(1e-3)*Vunit_Na *
-		    atomForce[i][0].qfForce[2];
-
-		  apbsibx[0] = Vunit_kb*pbeparm->temp*(1e-3)*Vunit_Na *
-		    atomForce[i][0].ibForce[0];
-		  apbsiby[0] = Vunit_kb*pbeparm->temp*(1e-3)*Vunit_Na *
-		    atomForce[i][0].ibForce[1];
-		  apbsibz[0] = Vunit_kb*pbeparm->temp*(1e-3)*Vunit_Na *
-		    atomForce[i][0].ibForce[2];
-
-		  apbsdbx[0] = Vunit_kb*pbeparm->temp*(1e-3)*Vunit_Na *
-		    atomForce[i][0].dbForce[0];
-		  apbsdby[0] = Vunit_kb*pbeparm->temp*(1e-3)*Vunit_Na *
-		    atomForce[i][0].dbForce[1];
-		  apbsdbz[0] = Vunit_kb*pbeparm->temp*(1e-3)*Vunit_Na *
-		    atomForce[i][0].dbForce[2];
-		}
+		copyForces(pbeparm, atomForce[i], natom,
+			   apbsdx, apbsdy, apbsdz, apbsqfx, apbsqfy, apbsqfz,
+			   apbsibx, apbsiby, apbsibz, apbsdbx, apbsdby, apbsdbz);
 
-		if (pbeparm->calcforce == PCF_COMPS) {
-		  //		  Vnm_tprint(2, "pcf_comps\n");
-		    for (j=0; j < natom; j++) {
-
-			apbsdx[j] = Vunit_kb*pbeparm->temp*(1e-3)*Vunit_Na *
-			    (atomForce[i][j].qfForce[0] +
-			     atomForce[i][j].ibForce[0] +
-			     atomForce[i][j].dbForce[0]);
-			apbsdy[j] = Vunit_kb*pbeparm->temp*(1e-3)*Vunit_Na *
-			    (atomForce[i][j].qfForce[1] +
-			     atomForce[i][j].ibForce[1] +
-			     atomForce[i][j].dbForce[1]);
-			apbsdz[j] = Vunit_kb*pbeparm->temp*(1e-3)*Vunit_Na *
-			    (atomForce[i][j].qfForce[2] +
-			     atomForce[i][j].ibForce[2] +
-			     atomForce[i][j].dbForce[2]);
-
-			/* individual components */
-			apbsqfx[j] = Vunit_kb*pbeparm->temp*(1e-3)*Vunit_Na *
-			    atomForce[i][j].qfForce[0];
-			apbsqfy[j] = Vunit_kb*pbeparm->temp*(1e-3)*Vunit_Na *
-			    atomForce[i][j].qfForce[1];
-			apbsqfz[j] = Vunit_kb*pbeparm->temp*(1e-3)*Vunit_Na *
-			    atomForce[i][j].qfForce[2];
-
-			apbsibx[j] = Vunit_kb*pbeparm->temp*(1e-3)*Vunit_Na *
-			    atomForce[i][j].ibForce[0];
-			apbsiby[j] = Vunit_kb*pbeparm->temp*(1e-3)*Vunit_Na *
-			    atomForce[i][j].ibForce[1];
-			apbsibz[j] = Vunit_kb*pbeparm->temp*(1e-3)*Vunit_Na *
-			    atomForce[i][j].ibForce[2];
-
-			apbsdbx[j] = Vunit_kb*pbeparm->temp*(1e-3)*Vunit_Na *
-			    atomForce[i][j].dbForce[0];
-			apbsdby[j] = Vunit_kb*pbeparm->temp*(1e-3)*Vunit_Na *
-			    atomForce[i][j].dbForce[1];
-			apbsdbz[j] = Vunit_kb*pbeparm->temp*(1e-3)*Vunit_Na *
-			    atomForce[i][j].dbForce[2];
-		    }
-		    //		    if(debug>3) printElecForce(com, nosh, nforce, atomForce, i);
-		}
 		/* Write grid-dimensioned data to file if that's what user wants*/
 		if( is_grid2file ) {
 		  writedataMG(rank, nosh, pbeparm, pmg[i]);
@@ -784,6 +814,375 @@ VERROR1:
 }
 
 
+/**
+ * @brief  Set up the PBE object of a calculation for the current positions
+ * @return  The new PBE object
+ */
+VPRIVATE Vpbe *setupPbe(PBEparm *pbeparm, Valist *alist)
+{
+    double sparm;
+
+    if (pbeparm->srfm == VSM_SPLINE) {
+	sparm = pbeparm->swin;
+    } else {
+	sparm = pbeparm->srad;
+    }
+
+    return Vpbe_ctor(alist, pbeparm->nion,
+		     pbeparm->ionc, pbeparm->ionr, pbeparm->ionq,
+		     pbeparm->temp, pbeparm->pdie,
+		     pbeparm->sdie, sparm, (pbeparm->bcfl == BCFL_FOCUS),
+		     pbeparm->sdens, pbeparm->zmem, pbeparm->Lmem,
+		     pbeparm->mdie, pbeparm->memv);
+}
+
+/**
+ * @brief  Create an iAPBS session
+ */
+IapbsSession* IapbsSession_ctor(
+	     int *nat,
+	     double x[NATOMS],
+	     double y[NATOMS],
+	     double z[NATOMS], 
+	     double radius[NATOMS],
+	     double charge[NATOMS],
+	     double r_param[9],
+	     int i_param[25],
+	     double grid[3],
+	     int dime[3],
+	     int pdime[3],
+	     double glen[3],
+	     double center[3],
+	     double cglen[3],
+	     double fglen[3], 
+	     double ccenter[3],
+	     double fcenter[3], 
+	     double *ofrac,
+	     int *dbg,
+	     double ionq[MAXION],
+	     double ionc[MAXION],
+	     double ionr[MAXION]
+	     )
+{
+    IapbsSession *thee = VNULL;
+    NOsh *nosh = VNULL;
+    MGparm *mgparm = VNULL;
+    PBEparm *pbeparm = VNULL;
+    int i, j, rank, size;
+
+    /* Maps are read and written per call by apbsdrv_ only */
+    for (i=11; i<=17; i++) {
+	if (i_param[i] == 1) break;
+    }
+    if ((i <= 17) || (i_param[22] == 1) || (i_param[23] == 1) ||
+	(i_param[24] == 1)) {
+	Vnm_tprint(2, "IapbsSession_ctor: Map input and output are not supported in a session!\n");
+	return VNULL;
+    }
+
+    thee = (IapbsSession *)Vmem_malloc(VNULL, 1, sizeof(IapbsSession));
+    VASSERT(thee != VNULL);
+
+    thee->com = Vcom_ctor(1);
+    rank = Vcom_rank(thee->com);
+    size = Vcom_size(thee->com);
+    startVio(); 
+    Vnm_setIoTag(rank, size);
+
+    thee->mem = Vmem_ctor("IAPBS");
+    thee->nosh = VNULL;
+    thee->debug = *dbg;
+    for (i=0; i<NOSH_MAXCALC; i++) {
+	thee->pmg[i] = VNULL;
+	thee->pmgp[i] = VNULL;
+	thee->pbe[i] = VNULL;
+    }
+    for (i=0; i<NOSH_MAXMOL; i++) {
+	thee->alist[i] = VNULL;
+    }
+
+    /* Grids centered on the molecule move with it */
+    if (i_param[0] == 0) {
+	thee->follow = (i_param[2] == 1);
+    } else {
+	thee->follow = (i_param[3] == 1) && (i_param[4] == 1);
+    }
+
+    thee->nosh = parseInputString(rank, size, r_param, i_param, grid, dime,
+				  ionq, ionc, ionr, glen, center, cglen,
+				  fglen, ccenter, fcenter, ofrac, pdime,
+				  thee->debug);
+    if (thee->nosh == VNULL) {
+	VJMPERR1(0);
+    }
+    nosh = thee->nosh;
+
+    thee->alist[0] = setupAtoms(*nat, x, y, z, radius, charge);
+    for (j=0; j<3; j++) thee->center[j] = thee->alist[0]->center[j];
+
+    if (NOsh_setupElecCalc(nosh, thee->alist) != 1) {
+	Vnm_tprint(2, "Error setting up ELEC calculations\n");
+	VJMPERR1(0);
+    }
+    if (NOsh_setupApolCalc(nosh, thee->alist) == ACD_ERROR) {
+	Vnm_tprint(2, "Error setting up APOL calculations\n");
+	VJMPERR1(0);
+    }
+
+    /* Set up the meshes once; every focusing level is kept, since its
+     * solution is the initial guess of the next step */
+    for (i=0; i<nosh->ncalc; i++) {
+	if (nosh->calc[i]->calctype == NCT_APOL) continue;
+	if (nosh->calc[i]->calctype != NCT_MG) {
+	    Vnm_tprint(2, "IapbsSession_ctor: Only multigrid calculations are supported in a session!\n");
+	    VJMPERR1(0);
+	}
+
+	mgparm = nosh->calc[i]->mgparm;
+	pbeparm = nosh->calc[i]->pbeparm;
+
+	switch (pbeparm->pbetype) {
+	    case PBE_NPBE:
+		mgparm->nonlintype = NONLIN_NPBE;
+		mgparm->method = VSOL_Newton;
+		break;
+	    case PBE_LPBE:
+		mgparm->nonlintype = NONLIN_LPBE;
+		mgparm->method = VSOL_MG;
+		break;
+	    default:
+		Vnm_tprint(2, "IapbsSession_ctor: PBE type %d isn't supported with the MG solver!\n",
+			   pbeparm->pbetype);
+		VJMPERR1(0);
+	}
+	if (mgparm->useCGMG == 1) mgparm->method = VSOL_CGMG;
+
+	if ((pbeparm->bcfl == BCFL_FOCUS) && (i == 0)) {
+	    Vnm_tprint( 2, "Can't focus first calculation!\n");
+	    VJMPERR1(0);
+	}
+
+	thee->pbe[i] = setupPbe(pbeparm, thee->alist[pbeparm->molid-1]);
+	thee->pmgp[i] = Vpmgp_ctor(mgparm);
+	thee->pmgp[i]->bcfl = pbeparm->bcfl;
+	thee->pmgp[i]->bctol = pbeparm->bctol;
+	thee->pmgp[i]->xcent = mgparm->center[0];
+	thee->pmgp[i]->ycent = mgparm->center[1];
+	thee->pmgp[i]->zcent = mgparm->center[2];
+
+	/* The focusing boundary is filled by Vpmg_update on each step */
+	thee->pmg[i] = Vpmg_ctor(thee->pmgp[i], thee->pbe[i], 0, VNULL,
+				 mgparm, PCE_NO);
+    }
+
+    return thee;
+
+VERROR1:
+    IapbsSession_dtor(&thee);
+    return VNULL;
+}
+
+/**
+ * @brief  Solve the session's problem for new atom positions
+ */
+int IapbsSession_solve(
+	     IapbsSession *thee,
+	     double x[NATOMS],
+	     double y[NATOMS],
+	     double z[NATOMS], 
+	     double esenergy[NOSH_MAXCALC],
+	     double npenergy[NOSH_MAXCALC],
+	     double apbsdx[NATOMS], double apbsdy[NATOMS], double apbsdz[NATOMS],
+	     double apbsqfx[NATOMS], double apbsqfy[NATOMS], double apbsqfz[NATOMS],
+	     double apbsibx[NATOMS], double apbsiby[NATOMS], double apbsibz[NATOMS],
+	     double apbsnpx[NATOMS], double apbsnpy[NATOMS], double apbsnpz[NATOMS],
+	     double apbsdbx[NATOMS], double apbsdby[NATOMS], double apbsdbz[NATOMS]
+	     )
+{
+    NOsh *nosh = VNULL;
+    MGparm *mgparm = VNULL;
+    PBEparm *pbeparm = VNULL;
+    APOLparm *apolparm = VNULL;
+    Vpbe *pbe = VNULL;
+    Vpmg *pmgOLD = VNULL;
+    Valist *alist = VNULL;
+    int i, j, natom, rc;
+    double shift[3];
+    double qfEnergy[NOSH_MAXCALC], qmEnergy[NOSH_MAXCALC];
+    double dielEnergy[NOSH_MAXCALC], totEnergy[NOSH_MAXCALC];
+    AtomForce *atomForce[NOSH_MAXCALC];
+    int nenergy[NOSH_MAXCALC], nforce[NOSH_MAXCALC];
+
+    VASSERT(thee != VNULL);
+    nosh = thee->nosh;
+    alist = thee->alist[0];
+    natom = alist->number;
+    rc = 0;
+
+    for (i=0; i<NOSH_MAXCALC; i++) {
+	qfEnergy[i] = 0;
+	qmEnergy[i] = 0;
+	dielEnergy[i] = 0;
+	totEnergy[i] = 0;
+	atomForce[i] = VNULL;
+	nenergy[i] = 0;
+	nforce[i] = 0;
+    }
+
+    /* Move the atoms; the grids keep their size and, if they are centered
+     * on the molecule, their offset from its center */
+    setPositions(alist, x, y, z);
+    Vacc_invalidateSurf(alist);
+    for (j=0; j<3; j++) {
+	shift[j] = thee->follow ? (alist->center[j] - thee->center[j]) : 0.0;
+	thee->center[j] = alist->center[j];
+    }
+
+    for (i=0; i<nosh->ncalc; i++){
+	if (nosh->calc[i]->pbeparm->calcforce > 0) {
+	    for (j=0; j < natom; j++) {
+		apbsdx[j] = 0.0;
+		apbsdy[j] = 0.0;
+		apbsdz[j] = 0.0;
+		apbsqfx[j] = 0.0;
+		apbsqfy[j] = 0.0;
+		apbsqfz[j] = 0.0;
+		apbsibx[j] = 0.0;
+		apbsiby[j] = 0.0;
+		apbsibz[j] = 0.0;
+		apbsdbx[j] = 0.0;
+		apbsdby[j] = 0.0;
+		apbsdbz[j] = 0.0;
+		apbsnpx[j] = 0.0;
+		apbsnpy[j] = 0.0;
+		apbsnpz[j] = 0.0;
+	    }
+	    break;
+	}
+    }
+
+    for (i=0; i<nosh->ncalc; i++) {
+	switch (nosh->calc[i]->calctype) {
+	    case NCT_MG:
+		mgparm = nosh->calc[i]->mgparm;
+		pbeparm = nosh->calc[i]->pbeparm;
+
+		for (j=0; j<3; j++) {
+		    mgparm->center[j] += shift[j];
+		    if (mgparm->type == MCT_PARALLEL) {
+			mgparm->partDisjCenter[j] += shift[j];
+		    }
+		}
+		thee->pmgp[i]->xcent = mgparm->center[0];
+		thee->pmgp[i]->ycent = mgparm->center[1];
+		thee->pmgp[i]->zcent = mgparm->center[2];
+
+		/* Only the position-dependent objects are rebuilt; the
+		 * solve starts from the potential of the previous step */
+		pbe = setupPbe(pbeparm, thee->alist[pbeparm->molid-1]);
+		pmgOLD = (pbeparm->bcfl == BCFL_FOCUS) ? thee->pmg[i-1] : VNULL;
+		if (!Vpmg_update(thee->pmg[i], pbe, pmgOLD, mgparm,
+				 pbeparm->calcenergy)) {
+		    Vpbe_dtor(&pbe);
+		    Vnm_tprint( 2, "Error setting up MG calculation!\n");
+		    VJMPERR1(0);
+		}
+		Vpbe_dtor(&(thee->pbe[i]));
+		thee->pbe[i] = pbe;
+
+		if (!Vpmg_fillco(thee->pmg[i],
+				 pbeparm->srfm, pbeparm->swin, mgparm->chgm,
+				 0, VNULL, 0, VNULL, 0, VNULL,
+				 0, VNULL, 0, VNULL, 0, VNULL)) {
+		    Vnm_tprint( 2, "Error setting up MG calculation!\n");
+		    VJMPERR1(0);
+		}
+
+		if (solveMG(nosh, thee->pmg[i], mgparm->type) != 1) {
+		    Vnm_tprint(2, "Error solving PDE!\n");
+		    VJMPERR1(0);
+		}
+		if (setPartMG(nosh, mgparm, thee->pmg[i]) != 1) {
+		    Vnm_tprint(2, "Error setting partition info!\n");
+		    VJMPERR1(0);
+		}
+
+		energyMG(nosh, i, thee->pmg[i], 
+			&(nenergy[i]), &(totEnergy[i]), &(qfEnergy[i]), 
+			&(qmEnergy[i]), &(dielEnergy[i]));
+		esenergy[0] = getElecEnergy(thee->com, nosh, totEnergy, i);
+
+		forceMG(thee->mem, nosh, pbeparm, mgparm, thee->pmg[i],
+			&(nforce[i]), &(atomForce[i]), thee->alist);
+		copyForces(pbeparm, atomForce[i], natom,
+			   apbsdx, apbsdy, apbsdz, apbsqfx, apbsqfy, apbsqfz,
+			   apbsibx, apbsiby, apbsibz, apbsdbx, apbsdby, apbsdbz);
+		break;
+
+	    case NCT_APOL:
+		apolparm = nosh->calc[i]->apolparm;
+		if (initAPOL(nosh, thee->mem, VNULL, apolparm, &(nforce[i]),
+			     &(atomForce[i]),
+			     thee->alist[(apolparm->molid)-1]) == 0) {
+		    Vnm_tprint(2, "Error calculating apolar solvation quantities!\n");
+		    VJMPERR1(0);
+		}
+
+		npenergy[0] = apolparm->gamma*apolparm->sasa;
+		if (apolparm->calcforce == ACF_COMPS) {
+		    for (j=0; j < natom; j++) {
+		      apbsnpx[j] = (atomForce[i][j]).sasaForce[0];
+		      apbsnpy[j] = (atomForce[i][j]).sasaForce[1];
+		      apbsnpz[j] = (atomForce[i][j]).sasaForce[2];
+		    }
+		}
+		break;
+
+	    default:
+		Vnm_tprint(2, "  Unknown calculation type (%d)!\n", 
+			   nosh->calc[i]->calctype);
+		VJMPERR1(0);
+	}
+    }
+
+    rc = 1;
+
+VERROR1:
+    killForce(thee->mem, nosh, nforce, atomForce);
+    fflush(stdout);
+    fflush(stderr);
+    return rc;
+}
+
+/**
+ * @brief  Destroy an iAPBS session
+ */
+void IapbsSession_dtor(IapbsSession **thee)
+{
+    int i;
+
+    if ((*thee) == VNULL) return;
+
+    /* The Vpmg objects go before the Vpmgp objects, as in killMG */
+    for (i=0; i<NOSH_MAXCALC; i++) {
+	Vpmg_dtor(&((*thee)->pmg[i]));
+    }
+    for (i=0; i<NOSH_MAXCALC; i++) {
+	Vpbe_dtor(&((*thee)->pbe[i]));
+	Vpmgp_dtor(&((*thee)->pmgp[i]));
+    }
+    for (i=0; i<NOSH_MAXMOL; i++) {
+	if ((*thee)->alist[i] != VNULL) Valist_dtor(&((*thee)->alist[i]));
+    }
+    if ((*thee)->nosh != VNULL) NOsh_dtor(&((*thee)->nosh));
+
+    Vcom_dtor(&((*thee)->com));
+    Vmem_dtor(&((*thee)->mem));
+    Vmem_free(VNULL, 1, sizeof(IapbsSession), (void **)thee);
+    (*thee) = VNULL;
+}
+
+
 /**
 * @brief Creates APBS input string
 * @author Robert Konecny
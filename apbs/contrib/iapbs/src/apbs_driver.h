@@ -190,6 +190,111 @@ VEXTERNC int apbsdrv_(int *nat,
 		      double apbsgrid_meta[13],
 		      double * apbsgrid[]);
 
+/**
+ * @brief  Persistent iAPBS calculation for repeated solves of one molecule
+ * @note   A session parses the input and sets up the grids once.  Each
+ *         IapbsSession_solve moves the atoms, rebuilds only the objects that
+ *         depend on their positions and starts multigrid from the potential
+ *         of the previous call, so a simulation step costs a few multigrid
+ *         cycles instead of a full setup and solve.
+ */
+struct sIapbsSession {
+    Vmem *mem;  /**< Memory manager for the force arrays */
+    Vcom *com;  /**< Communications object */
+    NOsh *nosh;  /**< Parsed input */
+    Valist *alist[NOSH_MAXMOL];  /**< Molecule; its positions are updated */
+    Vpbe *pbe[NOSH_MAXCALC];  /**< PBE objects of the last call */
+    Vpmgp *pmgp[NOSH_MAXCALC];  /**< Mesh parameters of each calculation */
+    Vpmg *pmg[NOSH_MAXCALC];  /**< Solvers of each calculation, kept with
+                               * their solutions between calls */
+    double center[3];  /**< Molecule center of the last call */
+    int follow;  /**< 1 if the grids move with the molecule center */
+    int debug;  /**< Debug verbosity flag */
+};
+
+/** @typedef IapbsSession
+ *  @brief   Declaration of the IapbsSession class as the sIapbsSession
+ *           structure
+ */
+typedef struct sIapbsSession IapbsSession;
+
+/**
+ * @brief  Create an iAPBS session for repeated calculations on one molecule
+ *
+ * The arguments are those of apbsdrv_().  The grid dimensions and lengths are
+ * fixed for the life of the session.  Grids centered on the molecule
+ * (i_param[2], or i_param[3] and i_param[4] for mg-auto and mg-para) keep
+ * their offset from the molecule center as the atoms move; other grids stay
+ * in place.  Only multigrid and apolar calculations are supported, and maps
+ * can be neither read nor written (i_param[11-17] and i_param[22-24] must be
+ * 0).  All focusing levels are kept in memory.
+ *
+ * @return  The new session, or VNULL on error
+ */
+VEXTERNC IapbsSession* IapbsSession_ctor(int *nat,
+		      double x[NATOMS], 
+		      double y[NATOMS], 
+		      double z[NATOMS], 
+		      double radius[NATOMS], 
+		      double charge[NATOMS], 
+		      double r_param[9], 
+		      int i_param[25],
+		      double grid[3],
+		      int dime[3], 
+		      int pdime[3], 
+		      double glen[3], 
+		      double center[3], 
+		      double cglen[3],
+		      double fglen[3], 
+		      double ccenter[3], 
+		      double fcenter[3], 
+		      double *ofrac, 
+		      int *dbg, 
+		      double ionq[MAXION], 
+		      double ionc[MAXION], 
+		      double ionr[MAXION]);
+
+/**
+ * @brief  Calculate energies and forces for new atom positions
+ *
+ * @param thee The session
+ * @param x Atomic coordinate (x), in the order given to IapbsSession_ctor
+ * @param y Atomic coordinate (y)
+ * @param z Atomic coordinate (z)
+ *
+ * The outputs are those of apbsdrv_().
+ *
+ * @return  1 if successful, 0 otherwise
+ */
+VEXTERNC int IapbsSession_solve(IapbsSession *thee,
+		      double x[NATOMS], 
+		      double y[NATOMS], 
+		      double z[NATOMS], 
+		      double esEnergy[NOSH_MAXCALC],
+		      double npEnergy[NOSH_MAXCALC],
+		      double apbsdx[NATOMS], 
+		      double apbsdy[NATOMS], 
+		      double apbsdz[NATOMS],
+		      double apbsqfx[NATOMS], 
+		      double apbsqfy[NATOMS],
+		      double apbsqfz[NATOMS],
+		      double apbsibx[NATOMS], 
+		      double apbsiby[NATOMS],
+		      double apbsibz[NATOMS],
+		      double apbsnpx[NATOMS], 
+		      double apbsnpy[NATOMS],
+		      double apbsnpz[NATOMS],
+		      double apbsdbx[NATOMS], 
+		      double apbsdby[NATOMS],
+		      double apbsdbz[NATOMS]);
+
+/**
+ * @brief  Destroy an iAPBS session
+ *
+ * @param thee Pointer to the session, set to VNULL
+ */
+VEXTERNC void IapbsSession_dtor(IapbsSession **thee);
+
 /**
  * @brief  Calculate forces from MG solution
  * @author Robert Konecny (based on forceMG)
@@ -0,0 +1,160 @@
+/**
+ * @file    session.c
+ * @brief   Two-step test of an iAPBS session
+ *
+ * Solves apbs.pqr in a session, moves the atoms and solves again, then
+ * compares the energies of the second step with those of a new session
+ * built at the moved positions.  The molecular surface (srfm mol) and the
+ * apolar SASA both depend on the solvent-accessible surface, so a session
+ * that kept the surface of the first step fails this test.
+ *
+ * Built by CMake with -DBUILD_iAPBS_SESSION_TEST=ON and run by
+ * "test.sh session"; by hand (see also wrapper.cpp):
+ * gcc -g session.c -I${APBS_INCL} -I${APBS_INCL}/apbs -I${APBS_INCL}/iapbs
+ *   -I${APBS_INCL}/maloc -L${APBS_LIB} -liapbs -lapbs_routines -lapbs_mg
+ *   -lapbs_generic -lapbs_pmgc -lmaloc -lm -o session
+ *
+ * Usage:  session apbs.pqr
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "apbscfg.h"
+#include "apbs.h"
+#include "routines.h"
+#include "apbs_driver.h"
+
+/** @brief Relative tolerance of the energy comparison */
+#define ETOL 1.0e-5
+
+/** @brief Largest displacement of an atom between the steps (A) */
+#define SHIFT 0.3
+
+static double atomX[NATOMS], atomY[NATOMS], atomZ[NATOMS];
+static double atomRadius[NATOMS], atomCharge[NATOMS];
+static double force[15][NATOMS];
+
+/**
+ * @brief  Solve in a session and return the electrostatic and apolar
+ *         energies
+ */
+static int solve(IapbsSession *session, double *es, double *np)
+{
+    double esEnergy[NOSH_MAXCALC], npEnergy[NOSH_MAXCALC];
+
+    if (!IapbsSession_solve(session, atomX, atomY, atomZ, esEnergy, npEnergy,
+			    force[0], force[1], force[2], force[3], force[4],
+			    force[5], force[6], force[7], force[8], force[9],
+			    force[10], force[11], force[12], force[13],
+			    force[14])) {
+	return 0;
+    }
+    *es = esEnergy[0];
+    *np = npEnergy[0];
+    return 1;
+}
+
+int main(int argc, char **argv)
+{
+    IapbsSession *warm = VNULL, *cold = VNULL;
+    FILE *fp;
+    char line[256];
+    int i, natom, dbg, rc;
+    double r_param[9] = {2.0, 78.54, 1.4, 0.3, 298.15, 10.0, 0.105,
+			 10.0, 1000.0};
+    int i_param[25];
+    double grid[3] = {0.3, 0.3, 0.3};
+    int dime[3] = {65, 65, 65}, pdime[3] = {1, 1, 1};
+    double glen[3] = {0.0, 0.0, 0.0}, center[3] = {0.0, 0.0, 0.0};
+    double cglen[3] = {0.0, 0.0, 0.0}, fglen[3] = {0.0, 0.0, 0.0};
+    double ccenter[3] = {0.0, 0.0, 0.0}, fcenter[3] = {0.0, 0.0, 0.0};
+    double ofrac = 0.1;
+    double ionq[MAXION] = {1.0, -1.0}, ionc[MAXION] = {0.15, 0.15};
+    double ionr[MAXION] = {2.0, 2.0};
+    double es[2], np[2];
+
+    if (argc != 2) {
+	fprintf(stderr, "Usage: %s file.pqr\n", argv[0]);
+	return 2;
+    }
+
+    fp = fopen(argv[1], "r");
+    if (fp == NULL) {
+	fprintf(stderr, "Can't open %s\n", argv[1]);
+	return 2;
+    }
+    natom = 0;
+    while ((natom < NATOMS) && (fgets(line, sizeof(line), fp) != NULL)) {
+	if (strncmp(line, "ATOM", 4) && strncmp(line, "HETATM", 6)) continue;
+	if (sscanf(line+30, "%lf%lf%lf%lf%lf", &(atomX[natom]),
+		   &(atomY[natom]), &(atomZ[natom]), &(atomCharge[natom]),
+		   &(atomRadius[natom])) == 5) {
+	    natom++;
+	}
+    }
+    fclose(fp);
+
+    /* mg-manual LPBE on a grid centered on the molecule, srfm mol, with
+     * the electrostatic and apolar energies */
+    for (i=0; i<25; i++) i_param[i] = 0;
+    i_param[1] = 4;
+    i_param[2] = 1;
+    i_param[5] = 1;
+    i_param[7] = 1;
+    i_param[9] = 1;
+    i_param[20] = 1;
+    i_param[21] = 2;
+    dbg = 0;
+
+    rc = 1;
+    warm = IapbsSession_ctor(&natom, atomX, atomY, atomZ,
+			     atomRadius, atomCharge,
+			     r_param, i_param, grid, dime, pdime, glen, center,
+			     cglen, fglen, ccenter, fcenter, &ofrac, &dbg,
+			     ionq, ionc, ionr);
+    if ((warm == VNULL) || !solve(warm, &(es[0]), &(np[0]))) {
+	fprintf(stderr, "First step failed\n");
+	goto done;
+    }
+
+    /* Move every atom by up to SHIFT in each direction */
+    srand(1);
+    for (i=0; i<natom; i++) {
+	atomX[i] += SHIFT*(2.0*rand()/RAND_MAX - 1.0);
+	atomY[i] += SHIFT*(2.0*rand()/RAND_MAX - 1.0);
+	atomZ[i] += SHIFT*(2.0*rand()/RAND_MAX - 1.0);
+    }
+
+    if (!solve(warm, &(es[0]), &(np[0]))) {
+	fprintf(stderr, "Second step failed\n");
+	goto done;
+    }
+
+    cold = IapbsSession_ctor(&natom, atomX, atomY, atomZ,
+			     atomRadius, atomCharge,
+			     r_param, i_param, grid, dime, pdime, glen, center,
+			     cglen, fglen, ccenter, fcenter, &ofrac, &dbg,
+			     ionq, ionc, ionr);
+    if ((cold == VNULL) || !solve(cold, &(es[1]), &(np[1]))) {
+	fprintf(stderr, "Cold solve failed\n");
+	goto done;
+    }
+
+    printf("Electrostatic energy: session %.10e, cold %.10e\n", es[0], es[1]);
+    printf("Apolar energy:        session %.10e, cold %.10e\n", np[0], np[1]);
+    if ((fabs(es[0] - es[1]) > ETOL*fabs(es[1])) ||
+	(fabs(np[0] - np[1]) > ETOL*fabs(np[1]))) {
+	printf("FAILED\n");
+    } else {
+	printf("passed\n");
+	rc = 0;
+    }
+
+  done:
+    IapbsSession_dtor(&warm);
+    IapbsSession_dtor(&cold);
+    return rc;
+}
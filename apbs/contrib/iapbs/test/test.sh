@@ -4,6 +4,7 @@
 #
 
 wrapper=../src/wrapper
+session=../src/session
 time="/usr/bin/time -v"
 timing=./timing.log
 touch $timing
@@ -13,6 +14,12 @@ export MCSH_HOME=/dev/null
 # error for result comparison
 ABSERR=1.0e-6
 
+if [ "$1" = "session" ] ; then
+    $session apbs.pqr > session.out
+    tail -3 session.out
+    exit
+fi
+
 if [ "$1" = "single" ] ; then
     $wrapper apbs.in > apbs.out
     diff save/apbs.out.save apbs.out
@@ -88,6 +88,7 @@
 
 /* MG headers */
 #include "mg/vgrid.h"
+#include "mg/vmgdist.h"
 #include "mg/vmgrid.h"
 #include "mg/vopot.h"
 #include "mg/vpmg.h"
@@ -142,7 +142,8 @@ struct sAPOLparm {
     double sdens; /**< Vacc sphere density */
     int setsdens; /**< Flag, @see sdens */
 
-    double dpos; /**< Atom position offset */
+    double dpos; /**< Atom position offset for finite-difference surface
+                  * derivatives; forces use analytic ones and ignore it */
     int setdpos; /**< Flag, @see dpos */
 
     double press; /**< Solvent pressure */
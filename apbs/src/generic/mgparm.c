@@ -162,6 +162,14 @@ VPUBLIC Vrc_Codes MGparm_ctor2(MGparm *thee, MGparm_CalcType type) {
     thee->setofrac = 0;
     for (i=0; i<6; i++) thee->partDisjOwnSide[i] = 0;
     thee->setasync = 0;
+    thee->inproc = 0;
+    thee->setinproc = 0;
+    thee->distrib = 0;
+    thee->setdistrib = 0;
+    thee->distDime = 0;
+    thee->distOwn[0] = 0;
+    thee->distOwn[1] = 0;
+    thee->distStart = 0;
 
     /* *** Default parameters for TINKER *** */
     thee->chgs = VCM_CHARGE;
@@ -169,6 +177,22 @@ VPUBLIC Vrc_Codes MGparm_ctor2(MGparm *thee, MGparm_CalcType type) {
     thee->useAqua = 0;
     thee->setUseAqua = 0;
 
+    thee->useMixed = 0;
+    thee->setUseMixed = 0;
+
+    thee->useCGMG = 0;
+    thee->setUseCGMG = 0;
+
+    thee->reuse = 0;
+    thee->setreuse = 0;
+
+    thee->guess = MGG_ZERO;
+    thee->setguess = 0;
+
+    thee->nrhs = 0;
+    thee->rhsblock = 1;
+    thee->setrhsblock = 0;
+
     return VRC_SUCCESS;
 }
 
@@ -185,7 +209,7 @@ VPUBLIC void MGparm_dtor2(MGparm *thee) { ; }
 VPUBLIC Vrc_Codes MGparm_check(MGparm *thee) {
 
     Vrc_Codes rc;
-    int i, tdime[3], ti, tnlev[3], nlev;
+    int i, tdime[3], ti, tnlev[3], nlev, ncoar;
 
     rc = VRC_SUCCESS;
 
@@ -245,6 +269,20 @@ VPUBLIC Vrc_Codes MGparm_check(MGparm *thee) {
         }
     }
 
+    /* A distributed solve splits one manual mesh across the processors */
+    if (thee->distrib && (thee->type != MCT_MANUAL)) {
+        Vnm_print(2, "MGparm_check:  DISTRIB is only supported for \
+mg-manual calculations!\n");
+        rc = VRC_FAILURE;
+    }
+
+    /* The additional charge sets use the boundary values of one mesh */
+    if ((thee->nrhs > 0) && ((thee->type != MCT_MANUAL) || thee->distrib)) {
+        Vnm_print(2, "MGparm_check:  RHS is only supported for mg-manual \
+calculations without DISTRIB!\n");
+        rc = VRC_FAILURE;
+    }
+
     /* Check parallel automatic focusing settings */
     if (thee->type == MCT_PARALLEL) {
         if (!thee->setpdime) {
@@ -289,16 +327,28 @@ VPUBLIC Vrc_Codes MGparm_check(MGparm *thee) {
                 }
                 (tnlev[i])--;
                 /* We'd like to have at least VMGNLEV levels in the multigrid
-                 * hierarchy.  This means that the dimension needs to be
-                 * c*2^VMGNLEV + 1, where c is an integer. */
-                if ((tdime[i] > 65) && (tnlev[i] < VMGNLEV)) {
-                    Vnm_print(2, "NOsh:  Bad dime[%d]  = %d (%d nlev)!\n",
-                      i, tdime[i], tnlev[i]);
-                    ti = (int)(tdime[i]/VPOW(2.,(VMGNLEV+1)));
-                    if (ti < 1) ti = 1;
-                    tdime[i] = ti*(int)(VPOW(2.,(VMGNLEV+1))) + 1;
-                    tnlev[i] = 4;
-                    Vnm_print(2, "NOsh:  Reset dime[%d] to %d and (nlev = %d).\n", i, tdime[i], VMGNLEV);
+                 * hierarchy, or else a coarsest grid small enough for the
+                 * coarse solver (direct for linear problems, CG otherwise).
+                 * The coarsest grid can have any size, so the dimension
+                 * only needs to be c*2^(l-1) + 1 with c + 1 <= VMGNCMAX;
+                 * pad it to the nearest such value. */
+                if (tnlev[i] < 2) ncoar = tdime[i];
+                else ncoar = (tdime[i] - 1)/(int)VPOW(2, tnlev[i]-1) + 1;
+                if ((tnlev[i] < 2) ||
+                  ((tnlev[i] < VMGNLEV) && (ncoar > VMGNCMAX))) {
+                    for (tnlev[i]=2; ; (tnlev[i])++) {
+                        ti = (int)VPOW(2, tnlev[i]-1);
+                        ncoar = (thee->dime[i] - 2)/ti + 2;
+                        if (ncoar <= VMGNCMAX) break;
+                    }
+                    if (ncoar < 3) ncoar = 3;
+                    tdime[i] = (ncoar - 1)*ti + 1;
+                    if (tdime[i] != thee->dime[i]) {
+                        Vnm_print(2, "NOsh:  Bad dime[%d]  = %d!\n", i,
+                          thee->dime[i]);
+                        Vnm_print(2, "NOsh:  Reset dime[%d] to %d and (nlev = %d).\n",
+                          i, tdime[i], tnlev[i]);
+                    }
                 }
             }
         }
@@ -334,6 +384,13 @@ VPUBLIC Vrc_Codes MGparm_check(MGparm *thee) {
     }
 
     if (!thee->setUseAqua) thee->useAqua = 0;
+    if (!thee->setUseMixed) thee->useMixed = 0;
+    if (!thee->setUseCGMG) thee->useCGMG = 0;
+    if (!thee->setreuse) thee->reuse = 0;
+    if (!thee->setinproc) thee->inproc = 0;
+    if (!thee->setdistrib) thee->distrib = 0;
+    if (!thee->setguess) thee->guess = MGG_ZERO;
+    if (!thee->setrhsblock) thee->rhsblock = 1;
 
     return rc;
 }
@@ -410,6 +467,32 @@ VPUBLIC void MGparm_copy(MGparm *thee, MGparm *parm) {
 
     thee->useAqua = parm->useAqua;
     thee->setUseAqua = parm->setUseAqua;
+
+    thee->useMixed = parm->useMixed;
+    thee->setUseMixed = parm->setUseMixed;
+
+    thee->useCGMG = parm->useCGMG;
+    thee->setUseCGMG = parm->setUseCGMG;
+
+    thee->reuse = parm->reuse;
+    thee->setreuse = parm->setreuse;
+
+    thee->guess = parm->guess;
+    thee->setguess = parm->setguess;
+
+    thee->nrhs = parm->nrhs;
+    for (i=0; i<parm->nrhs; i++) thee->rhsmol[i] = parm->rhsmol[i];
+    thee->rhsblock = parm->rhsblock;
+    thee->setrhsblock = parm->setrhsblock;
+
+    thee->inproc = parm->inproc;
+    thee->setinproc = parm->setinproc;
+
+    thee->distrib = parm->distrib;
+    thee->setdistrib = parm->setdistrib;
+    thee->distDime = parm->distDime;
+    for (i=0; i<2; i++) thee->distOwn[i] = parm->distOwn[i];
+    thee->distStart = parm->distStart;
 }
 
 VPRIVATE Vrc_Codes MGparm_parseDIME(MGparm *thee, Vio *sock) {
@@ -909,6 +992,20 @@ keyword!\n", tok);
         return VRC_WARNING;
 }
 
+VPRIVATE Vrc_Codes MGparm_parseINPROC(MGparm *thee, Vio *sock) {
+    Vnm_print(0, "NOsh: parsed inproc\n");
+    thee->inproc = 1;
+    thee->setinproc = 1;
+    return VRC_SUCCESS;
+}
+
+VPRIVATE Vrc_Codes MGparm_parseDISTRIB(MGparm *thee, Vio *sock) {
+    Vnm_print(0, "NOsh: parsed distrib\n");
+    thee->distrib = 1;
+    thee->setdistrib = 1;
+    return VRC_SUCCESS;
+}
+
 VPRIVATE Vrc_Codes MGparm_parseUSEAQUA(MGparm *thee, Vio *sock) {
     Vnm_print(0, "NOsh: parsed useaqua\n");
     thee->useAqua = 1;
@@ -916,6 +1013,102 @@ VPRIVATE Vrc_Codes MGparm_parseUSEAQUA(MGparm *thee, Vio *sock) {
     return VRC_SUCCESS;
 }
 
+VPRIVATE Vrc_Codes MGparm_parseMIXEDPREC(MGparm *thee, Vio *sock) {
+    Vnm_print(0, "NOsh: parsed mixedprec\n");
+    thee->useMixed = 1;
+    thee->setUseMixed = 1;
+    return VRC_SUCCESS;
+}
+
+VPRIVATE Vrc_Codes MGparm_parseCGMG(MGparm *thee, Vio *sock) {
+    Vnm_print(0, "NOsh: parsed cgmg\n");
+    thee->useCGMG = 1;
+    thee->setUseCGMG = 1;
+    return VRC_SUCCESS;
+}
+
+VPRIVATE Vrc_Codes MGparm_parseREUSE(MGparm *thee, Vio *sock) {
+    Vnm_print(0, "NOsh: parsed reuse\n");
+    thee->reuse = 1;
+    thee->setreuse = 1;
+    return VRC_SUCCESS;
+}
+
+VPRIVATE Vrc_Codes MGparm_parseGUESS(MGparm *thee, Vio *sock) {
+
+    char tok[VMAX_BUFSIZE];
+
+    VJMPERR1(Vio_scanf(sock, "%s", tok) == 1);
+    if (Vstring_strcasecmp(tok, "zero") == 0) {
+        thee->guess = MGG_ZERO;
+    } else if (Vstring_strcasecmp(tok, "focus") == 0) {
+        thee->guess = MGG_FOCUS;
+    } else if (Vstring_strcasecmp(tok, "previous") == 0) {
+        thee->guess = MGG_PREVIOUS;
+    } else if (Vstring_strcasecmp(tok, "map") == 0) {
+        thee->guess = MGG_MAP;
+    } else {
+        Vnm_print(2, "NOsh:  Unrecognized parameter (%s) when parsing \
+guess!\n", tok);
+        return VRC_WARNING;
+    }
+    thee->setguess = 1;
+    return VRC_SUCCESS;
+
+    VERROR1:
+        Vnm_print(2, "parseMG:  ran out of tokens!\n");
+        return VRC_WARNING;
+}
+
+VPRIVATE Vrc_Codes MGparm_parseRHS(MGparm *thee, Vio *sock) {
+
+    char tok[VMAX_BUFSIZE];
+    int ti;
+
+    VJMPERR1(Vio_scanf(sock, "%s", tok) == 1);
+    if (sscanf(tok, "%d", &ti) == 0) {
+        Vnm_print(2, "NOsh:  Read non-integer (%s) while parsing RHS \
+keyword!\n", tok);
+        return VRC_WARNING;
+    } else if (ti < 1) {
+        Vnm_print(2, "parseMG:  rhs molecule ID must be at least 1!\n");
+        return VRC_WARNING;
+    } else if (thee->nrhs >= MGPARM_MAXRHS) {
+        Vnm_print(2, "parseMG:  Too many RHS keywords (max %d)!\n",
+          MGPARM_MAXRHS);
+        return VRC_WARNING;
+    }
+    thee->rhsmol[thee->nrhs] = ti;
+    (thee->nrhs)++;
+    return VRC_SUCCESS;
+
+    VERROR1:
+        Vnm_print(2, "parseMG:  ran out of tokens!\n");
+        return VRC_WARNING;
+}
+
+VPRIVATE Vrc_Codes MGparm_parseRHSBLOCK(MGparm *thee, Vio *sock) {
+
+    char tok[VMAX_BUFSIZE];
+    int ti;
+
+    VJMPERR1(Vio_scanf(sock, "%s", tok) == 1);
+    if (sscanf(tok, "%d", &ti) == 0) {
+        Vnm_print(2, "NOsh:  Read non-integer (%s) while parsing RHSBLOCK \
+keyword!\n", tok);
+        return VRC_WARNING;
+    } else if (ti < 1) {
+        Vnm_print(2, "parseMG:  rhsblock must be at least 1!\n");
+        return VRC_WARNING;
+    } else thee->rhsblock = ti;
+    thee->setrhsblock = 1;
+    return VRC_SUCCESS;
+
+    VERROR1:
+        Vnm_print(2, "parseMG:  ran out of tokens!\n");
+        return VRC_WARNING;
+}
+
 VPUBLIC Vrc_Codes MGparm_parseToken(MGparm *thee, char tok[VMAX_BUFSIZE],
   Vio *sock) {
 
@@ -960,10 +1153,26 @@ VPUBLIC Vrc_Codes MGparm_parseToken(MGparm *thee, char tok[VMAX_BUFSIZE],
         return MGparm_parseOFRAC(thee, sock);
     } else if (Vstring_strcasecmp(tok, "async") == 0) {
         return MGparm_parseASYNC(thee, sock);
+    } else if (Vstring_strcasecmp(tok, "inproc") == 0) {
+        return MGparm_parseINPROC(thee, sock);
+    } else if (Vstring_strcasecmp(tok, "distrib") == 0) {
+        return MGparm_parseDISTRIB(thee, sock);
     } else if (Vstring_strcasecmp(tok, "gamma") == 0) {
         return MGparm_parseGAMMA(thee, sock);
     } else if (Vstring_strcasecmp(tok, "useaqua") == 0) {
         return MGparm_parseUSEAQUA(thee, sock);
+    } else if (Vstring_strcasecmp(tok, "mixedprec") == 0) {
+        return MGparm_parseMIXEDPREC(thee, sock);
+    } else if (Vstring_strcasecmp(tok, "cgmg") == 0) {
+        return MGparm_parseCGMG(thee, sock);
+    } else if (Vstring_strcasecmp(tok, "reuse") == 0) {
+        return MGparm_parseREUSE(thee, sock);
+    } else if (Vstring_strcasecmp(tok, "guess") == 0) {
+        return MGparm_parseGUESS(thee, sock);
+    } else if (Vstring_strcasecmp(tok, "rhs") == 0) {
+        return MGparm_parseRHS(thee, sock);
+    } else if (Vstring_strcasecmp(tok, "rhsblock") == 0) {
+        return MGparm_parseRHSBLOCK(thee, sock);
     } else {
         Vnm_print(2, "parseMG:  Unrecognized keyword (%s)!\n", tok);
         return VRC_WARNING;
@@ -70,6 +70,12 @@
 #include "generic/vhal.h"
 #include "generic/vstring.h"
 
+/** @brief   Number of additional charge sets that can be solved in a single
+ *           calculation
+ *  @ingroup MGparm
+ */
+#define MGPARM_MAXRHS 20
+
 /**
  * @brief  Calculation type
  * @ingroup MGparm
@@ -103,6 +109,24 @@ enum eMGparm_CentMeth {
  * @ingroup  MGparm
  */
 typedef enum eMGparm_CentMeth MGparm_CentMeth;
+
+/**
+ * @brief  Initial guess of the multigrid solver
+ * @ingroup MGparm
+ */
+enum eMGparm_Guess {
+    MGG_ZERO=0,  /**< Start from zero */
+    MGG_FOCUS=1,  /**< Start focused calculations from the coarser solution */
+    MGG_PREVIOUS=2,  /**< Start from the solution of the previous
+                      * calculation */
+    MGG_MAP=3  /**< Start from the potential map given by usemap pot */
+};
+
+/**
+ * @brief  Declare MGparm_Guess type
+ * @ingroup  MGparm
+ */
+typedef enum eMGparm_Guess MGparm_Guess;
 /**
  *  @ingroup MGparm
  *  @author  Nathan Baker and Todd Dolinsky
@@ -185,6 +209,20 @@ struct sMGparm {
     int setofrac;  /**< Flag, @see ofrac */
     int async; /**< Processor ID for asynchronous calculation */
     int setasync; /**< Flag, @see asynch */
+    int inproc; /**< Solve all the subdomains of a parallel calculation
+                 * concurrently in this process and merge their results in
+                 * memory */
+    int setinproc; /**< Flag, @see inproc */
+    int distrib; /**< Split a single mg-manual mesh into z slabs, one per
+                  * processor, and solve it with one distributed multigrid
+                  * iteration */
+    int setdistrib; /**< Flag, @see distrib */
+    int distDime;  /**< Number of z planes in the undivided mesh of a
+                    * distributed calculation */
+    int distOwn[2];  /**< Global z planes [distOwn[0], distOwn[1]) owned by
+                      * this processor in a distributed calculation */
+    int distStart;  /**< Global index of the first z plane of this
+                     * processor's slab in a distributed calculation */
 
     int nonlintype; /**< Linearity Type Method to be used */
     int setnonlintype; /**< Flag, @see nonlintype */
@@ -194,6 +232,29 @@ struct sMGparm {
 
     int useAqua;  /**< Enable use of lpbe/aqua */
     int setUseAqua; /**< Flag, @see useAqua */
+
+    int useMixed;  /**< Run the multigrid cycles in single precision with
+                    * double precision defect correction */
+    int setUseMixed; /**< Flag, @see useMixed */
+
+    int useCGMG;  /**< Solve with conjugate gradients preconditioned by a
+                   * multigrid V-cycle */
+    int setUseCGMG; /**< Flag, @see useCGMG */
+
+    int reuse;  /**< Take the dielectric and kappa maps and the multigrid
+                 * operators from the previous calculation if it was done
+                 * on the same mesh for the same atoms */
+    int setreuse; /**< Flag, @see reuse */
+
+    MGparm_Guess guess;  /**< Where the solver takes its initial guess from */
+    int setguess; /**< Flag, @see guess */
+
+    int nrhs;  /**< Number of molecules whose charges are solved on the
+                * maps and operators of this calculation */
+    int rhsmol[MGPARM_MAXRHS];  /**< Molecule IDs of those charge sets
+                                 * (starting from 1) */
+    int rhsblock;  /**< Number of those charge sets solved at the same time */
+    int setrhsblock; /**< Flag, @see rhsblock */
 };
 
 /** @typedef MGparm
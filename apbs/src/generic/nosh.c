@@ -135,6 +135,11 @@ VPRIVATE int NOsh_setupCalcMGMANUAL(
                                     NOsh_calc *elec
                                     );
 
+VPRIVATE int NOsh_setupCalcMGDIST(
+                                  NOsh *thee,
+                                  NOsh_calc *calc
+                                  );
+
 VPRIVATE int NOsh_setupCalcMGPARA(
                                   NOsh *thee,
                                   NOsh_calc *elec
@@ -1597,6 +1602,34 @@ VPUBLIC int NOsh_parseMG(
         return 0;
     }
 
+    /* A distributed solve shares one mesh between all the processors */
+    if (mgparm->distrib) {
+        mgparm->proc_rank = thee->proc_rank;
+        mgparm->proc_size = thee->proc_size;
+        mgparm->setrank = 1;
+        mgparm->setsize = 1;
+        if (pbeparm->pbetype != PBE_LPBE) {
+            Vnm_print(2, "NOsh:  The 'distrib' keyword requires lpbe!\n");
+            return 0;
+        }
+        if (pbeparm->bcfl == BCFL_FOCUS) {
+            Vnm_print(2, "NOsh:  The 'distrib' keyword cannot be used with \
+bcfl focus!\n");
+            return 0;
+        }
+        if (mgparm->useCGMG || mgparm->useMixed || mgparm->useAqua) {
+            Vnm_print(2, "NOsh:  The 'distrib' keyword cannot be combined \
+with cgmg, mixedprec or useaqua!\n");
+            return 0;
+        }
+        if (mgparm->dime[2] < 3*mgparm->proc_size) {
+            Vnm_print(2, "NOsh:  Need at least 3 z planes per processor for \
+'distrib' (dime %d, %d processors)!\n", mgparm->dime[2],
+                      mgparm->proc_size);
+            return 0;
+        }
+    }
+
     return 1;
 }
 
@@ -1808,6 +1841,86 @@ set up?\n");
     /* Copy over contents of ELEC */
     NOsh_calc_copy(calc, elec);
 
+    if (mgparm->distrib) return NOsh_setupCalcMGDIST(thee, calc);
+
+    return 1;
+}
+
+/* Cut the mesh of a manual calculation into z slabs, one per processor.  Each
+ * processor owns a contiguous block of planes and keeps extra planes on
+ * either side so that the charges and coefficients it needs for its ghost
+ * planes, and the force integrals of the atoms it owns, are discretized
+ * exactly as on the undivided mesh.  The fill skips atoms off the slab, so
+ * the overlap covers VMGDISTOVERLAP planes plus the widest reach of an atom:
+ * its radius, the spline window and the larger of the ion and probe radii.
+ * The disjoint partition is set up so that energies and forces are only
+ * accumulated over the owned planes. */
+VPRIVATE int NOsh_setupCalcMGDIST(
+                                  NOsh *thee,
+                                  NOsh_calc *calc
+                                  ) {
+
+    MGparm *mgparm = VNULL;
+    PBEparm *pbeparm = VNULL;
+    Valist *alist = VNULL;
+    int rank, size, nz, own0, own1, m0, m1, over, i;
+    double hz, zmin, zlo, zhi, reach;
+
+    VASSERT(thee != VNULL);
+    VASSERT(calc != VNULL);
+    mgparm = calc->mgparm;
+    VASSERT(mgparm != VNULL);
+    pbeparm = calc->pbeparm;
+    VASSERT(pbeparm != VNULL);
+
+    rank = mgparm->proc_rank;
+    size = mgparm->proc_size;
+    nz = mgparm->dime[2];
+    hz = mgparm->grid[2];
+    zmin = mgparm->center[2] - 0.5*mgparm->glen[2];
+
+    /* Widest reach of an atom into the dielectric and kappa maps and the
+     * boundary force integrals */
+    reach = pbeparm->srad;
+    for (i=0; i<pbeparm->nion; i++) reach = VMAX2(reach, pbeparm->ionr[i]);
+    reach += pbeparm->swin;
+    if ((pbeparm->molid > 0) && (pbeparm->molid <= thee->nmol)) {
+        alist = thee->alist[pbeparm->molid-1];
+    }
+    if (alist != VNULL) reach += alist->maxrad;
+    over = VMGDISTOVERLAP + (int)ceil(reach/hz);
+
+    own0 = (rank*nz)/size;
+    own1 = ((rank + 1)*nz)/size;
+    m0 = VMAX2(0, own0 - over);
+    m1 = VMIN2(nz - 1, own1 - 1 + over);
+
+    Vnm_print(0, "NOsh_setupCalcMGDIST:  Processor %d owns z planes %d-%d \
+of %d (slab %d-%d)\n", rank, own0, own1 - 1, nz, m0, m1);
+
+    mgparm->distDime = nz;
+    mgparm->distOwn[0] = own0;
+    mgparm->distOwn[1] = own1;
+    mgparm->distStart = m0;
+
+    /* Each processor only accumulates over the planes it owns; the cuts
+     * between processors lie halfway between mesh planes */
+    zlo = (own0 > 0) ? (zmin + hz*((double)own0 - 0.5)) : zmin;
+    zhi = (own1 < nz) ? (zmin + hz*((double)own1 - 0.5)) : (zmin + mgparm->glen[2]);
+    for (i=0; i<2; i++) {
+        mgparm->partDisjCenter[i] = mgparm->center[i];
+        mgparm->partDisjLength[i] = mgparm->glen[i];
+    }
+    mgparm->partDisjCenter[2] = 0.5*(zlo + zhi);
+    mgparm->partDisjLength[2] = zhi - zlo;
+    for (i=0; i<6; i++) mgparm->partDisjOwnSide[i] = 0;
+    mgparm->partDisjOwnSide[VAPBS_DOWN] = (own0 > 0);
+    mgparm->partDisjOwnSide[VAPBS_UP] = (own1 < nz);
+
+    /* Shrink the mesh to this processor's slab */
+    mgparm->dime[2] = m1 - m0 + 1;
+    mgparm->glen[2] = hz*((double)(m1 - m0));
+    mgparm->center[2] = zmin + 0.5*hz*((double)(m0 + m1));
 
     return 1;
 }
@@ -2095,11 +2208,12 @@ VPUBLIC int NOsh_setupCalcMGPARA(
     /* NEW (25-Jul-2006):  This code should produce modify the ELEC statement
     and pass it on to MGAUTO for further processing. */
 
+    NOsh_calc *part = VNULL;
     MGparm *mgparm = VNULL;
     double ofrac;
     double hx, hy, hzed;
     double xofrac, yofrac, zofrac;
-    int rank, size, npx, npy, npz, nproc, ip, jp, kp;
+    int rc, rank, size, npx, npy, npz, nproc, ip, jp, kp;
     int xeffGlob, yeffGlob, zeffGlob, xDisj, yDisj, zDisj;
     int xigminDisj, xigmaxDisj, yigminDisj, yigmaxDisj, zigminDisj, zigmaxDisj;
     int xigminOlap, xigmaxOlap, yigminOlap, yigmaxOlap, zigminOlap, zigmaxOlap;
@@ -2125,9 +2239,34 @@ VPUBLIC int NOsh_setupCalcMGPARA(
     npz = mgparm->pdime[2];
     nproc = npx*npy*npz;
 
+    /* If the subdomains are solved in this process, then the calculations set
+        up here only stand in for the whole partition:  the ELEC statement
+        keeps the global mesh so each subdomain can be set up from it when it
+        is solved (see inprocMG) */
+    if (mgparm->setinproc) {
+
+        if (mgparm->setasync) {
+            Vnm_tprint(2, "NOsh_setupCalcMGPARA:  The 'async' and 'inproc' \
+keywords can't be used together!\n");
+            return 0;
+        }
+        if (thee->proc_size > 1) {
+            Vnm_tprint(2, "NOsh_setupCalcMGPARA:  The 'inproc' keyword \
+solves all %d subdomains in one process;\n", nproc);
+            Vnm_tprint(2, "NOsh_setupCalcMGPARA:  please run it with a single \
+MPI process (got %d)!\n", thee->proc_size);
+            return 0;
+        }
+
+        rank = 0;
+        part = NOsh_calc_ctor(NCT_MG);
+        NOsh_calc_copy(part, elec);
+        elec = part;
+        mgparm = elec->mgparm;
+
     /* If this is not an asynchronous calculation, then we need to make sure we
         have all the necessary MPI information */
-    if (mgparm->setasync == 0) {
+    } else if (mgparm->setasync == 0) {
 
 #ifndef HAVE_MPI_H
 
@@ -2378,7 +2517,11 @@ in  NOsh_setupMGAUTO\n", __FILE__, __LINE__);
 
 
     /* Setup the automatic focusing calculations associated with this processor */
-    return NOsh_setupCalcMGAUTO(thee, elec);
+    if (part == VNULL) return NOsh_setupCalcMGAUTO(thee, elec);
+
+    rc = NOsh_setupCalcMGAUTO(thee, part);
+    NOsh_calc_dtor(&part);
+    return rc;
 
 }
 
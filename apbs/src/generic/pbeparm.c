@@ -123,6 +123,8 @@ VPUBLIC int PBEparm_ctor2(PBEparm *thee) {
     thee->setmolid = 0;
     thee->setpbetype = 0;
     thee->setbcfl = 0;
+    thee->setbctol = 0;
+    thee->bctol = 1.0e-6;
     thee->setnion = 0;
     for (i=0; i<MAXION; i++){
         thee->setion[i] = 0;
@@ -301,6 +303,8 @@ VPUBLIC void PBEparm_copy(PBEparm *thee, PBEparm *parm) {
     thee->setpbetype = parm->setpbetype;
     thee->bcfl = parm->bcfl;
     thee->setbcfl = parm->setbcfl;
+    thee->bctol = parm->bctol;
+    thee->setbctol = parm->setbctol;
     thee->nion = parm->nion;
     thee->setnion = parm->setnion;
     for (i=0; i<MAXION; i++) {
@@ -505,6 +509,9 @@ statement\n", ti);
             case BCFL_MAP:
                 Vnm_print(2, "map");
                 break;
+            case BCFL_MDHTREE:
+                Vnm_print(2, "mdhtree");
+                break;
             default:
                 Vnm_print(2, "UKNOWN");
                 break;
@@ -539,6 +546,10 @@ statement\n", ti);
             thee->bcfl = BCFL_MAP;
             thee->setbcfl = 1;
             return 1;
+        } else if (Vstring_strcasecmp(tok, "mdhtree") == 0) {
+            thee->bcfl = BCFL_MDHTREE;
+            thee->setbcfl = 1;
+            return 1;
         } else {
             Vnm_print(2, "NOsh:  parsed unknown BCFL parameter (%s)!\n",
               tok);
@@ -552,6 +563,29 @@ statement\n", ti);
         return -1;
 }
 
+VPRIVATE int PBEparm_parseBCTOL(PBEparm *thee, Vio *sock) {
+    char tok[VMAX_BUFSIZE];
+    double tf;
+
+    VJMPERR1(Vio_scanf(sock, "%s", tok) == 1);
+    if (sscanf(tok, "%lf", &tf) == 0) {
+        Vnm_print(2, "NOsh:  Read non-float (%s) while parsing BCTOL \
+keyword!\n", tok);
+        return -1;
+    }
+    if ((tf <= 0.0) || (tf >= 1.0)) {
+        Vnm_print(2, "NOsh:  BCTOL (%g) must be between 0 and 1!\n", tf);
+        return -1;
+    }
+    thee->bctol = tf;
+    thee->setbctol = 1;
+    return 1;
+
+    VERROR1:
+        Vnm_print(2, "parsePBE:  ran out of tokens!\n");
+        return -1;
+}
+
 VPRIVATE int PBEparm_parseION(PBEparm *thee, Vio *sock) {
 
     int i;
@@ -1234,6 +1268,8 @@ VPUBLIC int PBEparm_parseToken(PBEparm *thee, char tok[VMAX_BUFSIZE],
         return PBEparm_parseSMPBE(thee, sock);
     } else if (Vstring_strcasecmp(tok, "bcfl") == 0) {
         return PBEparm_parseBCFL(thee, sock);
+    } else if (Vstring_strcasecmp(tok, "bctol") == 0) {
+        return PBEparm_parseBCTOL(thee, sock);
     } else if (Vstring_strcasecmp(tok, "ion") == 0) {
         return PBEparm_parseION(thee, sock);
     } else if (Vstring_strcasecmp(tok, "pdie") == 0) {
@@ -135,6 +135,8 @@ struct sPBEparm {
     int setpbetype;  /**< Flag, @see pbetype */
     Vbcfl bcfl;  /**< Boundary condition method */
     int setbcfl;  /**< Flag, @see bcfl */
+    double bctol;  /**< Relative accuracy of treecode boundary conditions */
+    int setbctol;  /**< Flag, @see bctol */
     int nion;  /**< Number of counterion species */
     int setnion;  /**< Flag, @see nion */
     double ionq[MAXION];  /**< Counterion charges (in e) */
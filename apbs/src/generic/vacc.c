@@ -129,6 +129,497 @@ VPRIVATE int ivdwAccExclus(
 
 }
 
+/**
+ * @brief  Atom surfaces shared between Vacc objects
+ * @note   Keyed on the atom list, probe radius, and reference sphere size;
+ *         the accessibility test only sees atoms within a probe radius of
+ *         each point, so every Vacc built on the same molecule produces the
+ *         same surfaces for a given key.  Moving the atoms makes the key
+ *         stale; see Vacc_invalidateSurf.
+ */
+struct sVaccSurfCache {
+    Vmem *mem;  /**< Memory object for the surfaces */
+    Valist *alist;  /**< Atom list */
+    double probe_radius;  /**< Probe radius for the surfaces */
+    int nsphere;  /**< Number of points on the reference sphere */
+    int natoms;  /**< Length of surf */
+    int nref;  /**< Number of Vacc objects using this cache */
+    VaccSurf **surf;  /**< Per-atom surfaces (VNULL until built) */
+    VaccSurfCache *next;  /**< Next cache in the list */
+};
+
+/** @brief  List of live surface caches */
+VPRIVATE VaccSurfCache *surfCacheList = VNULL;
+
+/**
+ * @brief  Drop this object's reference to its surface cache, destroying the
+ *         cache when it is no longer used
+ */
+VPRIVATE void Vacc_releaseSurf(Vacc *thee) {
+
+    VaccSurfCache *cache, **prev;
+    int i;
+
+    cache = thee->surfCache;
+    if (cache == VNULL) return;
+    thee->surfCache = VNULL;
+    thee->surf = VNULL;
+
+    cache->nref--;
+    if (cache->nref > 0) return;
+
+    for (prev=&surfCacheList; *prev!=VNULL; prev=&((*prev)->next)) {
+        if (*prev == cache) {
+            *prev = cache->next;
+            break;
+        }
+    }
+    for (i=0; i<cache->natoms; i++) VaccSurf_dtor(&(cache->surf[i]));
+    Vmem_free(cache->mem, cache->natoms, sizeof(VaccSurf *),
+            (void **)&(cache->surf));
+    Vmem_dtor(&(cache->mem));
+    Vmem_free(VNULL, 1, sizeof(VaccSurfCache), (void **)&cache);
+}
+
+VPUBLIC void Vacc_acquireSurf(Vacc *thee, double radius) {
+
+    VaccSurfCache *cache;
+    int i;
+
+    if ((thee->surfCache != VNULL) &&
+        (thee->surfCache->probe_radius == radius)) return;
+    if (thee->surfCache != VNULL) {
+        Vnm_print(0, "Vacc_acquireSurf:  probe radius changed from %g to %g\n",
+                thee->surfCache->probe_radius, radius);
+        Vacc_releaseSurf(thee);
+    }
+
+    for (cache=surfCacheList; cache!=VNULL; cache=cache->next) {
+        if ((cache->alist == thee->alist) &&
+            (cache->probe_radius == radius) &&
+            (cache->nsphere == thee->refSphere->npts)) break;
+    }
+
+    if (cache == VNULL) {
+        cache = (VaccSurfCache*)Vmem_malloc(VNULL, 1, sizeof(VaccSurfCache));
+        VASSERT(cache != VNULL);
+        cache->mem = Vmem_ctor("APBS::VACCSURF");
+        cache->alist = thee->alist;
+        cache->probe_radius = radius;
+        cache->nsphere = thee->refSphere->npts;
+        cache->natoms = Valist_getNumberAtoms(thee->alist);
+        cache->nref = 0;
+        cache->surf = (VaccSurf**)Vmem_malloc(cache->mem, cache->natoms,
+                sizeof(VaccSurf *));
+        VASSERT(cache->surf != VNULL);
+        for (i=0; i<cache->natoms; i++) cache->surf[i] = VNULL;
+        cache->next = surfCacheList;
+        surfCacheList = cache;
+    } else {
+        Vnm_print(0, "Vacc_acquireSurf:  sharing atom surfaces (probe radius \
+%g) with %d other object(s)\n", radius, cache->nref);
+    }
+
+    cache->nref++;
+    thee->surfCache = cache;
+    thee->surf = cache->surf;
+}
+
+VPUBLIC void Vacc_invalidateSurf(Valist *alist) {
+
+    VaccSurfCache *cache, **prev;
+
+    /* Unlink the caches so that no new object finds them; the objects that
+     * hold them free them on release as usual */
+    prev = &surfCacheList;
+    while (*prev != VNULL) {
+        cache = *prev;
+        if (cache->alist == alist) *prev = cache->next;
+        else prev = &(cache->next);
+    }
+}
+
+/**
+ * @brief  Overlapping neighbors of every atom, in compressed rows
+ */
+struct sVaccNbrList {
+    double prad;  /**< Largest probe radius the lists cover */
+    int natoms;  /**< Number of atoms */
+    int *start;  /**< The neighbors of atom i are ids[start[i]] to
+                  * ids[start[i+1]-1]; length natoms+1 */
+    int *ids;  /**< Neighbor atom IDs, in order of increasing ID within each
+                * bin of the build */
+};
+
+/**
+ * @brief  Destroy the neighbor lists, if any
+ */
+VPRIVATE void Vacc_freeNbrList(Vacc *thee) {
+
+    VaccNbrList *nbr;
+
+    nbr = thee->nbrList;
+    if (nbr == VNULL) return;
+    thee->nbrList = VNULL;
+#pragma omp critical (Vacc_mem)
+    {
+        Vmem_free(thee->mem, nbr->start[nbr->natoms], sizeof(int),
+                  (void **)&(nbr->ids));
+        Vmem_free(thee->mem, nbr->natoms+1, sizeof(int),
+                  (void **)&(nbr->start));
+        Vmem_free(thee->mem, 1, sizeof(VaccNbrList), (void **)&nbr);
+    }
+}
+
+/**
+ * @brief  Count (ids == VNULL) or list the neighbors of an atom whose probe
+ *         spheres, for probe radius prad, overlap its own
+ * @note   The atoms are binned in cubes at least as wide as the longest
+ *         possible overlap distance, so the neighbors are in the 27 bins
+ *         around the atom's own
+ */
+VPRIVATE int Vacc_binNeighbors(Valist *alist, double prad, int iatom,
+                               int *bin, int nbin[3], int *head, int *next,
+                               int *ids) {
+
+    Vatom *atom, *other;
+    int nnbr, i, j, k, ib[3], jatom;
+    double *apos, *bpos, dist2;
+
+    atom = Valist_getAtom(alist, iatom);
+    apos = Vatom_getPosition(atom);
+    nnbr = 0;
+    for (i=VMAX2(bin[3*iatom]-1, 0);
+         i<=VMIN2(bin[3*iatom]+1, nbin[0]-1); i++) {
+        ib[0] = i;
+        for (j=VMAX2(bin[3*iatom+1]-1, 0);
+             j<=VMIN2(bin[3*iatom+1]+1, nbin[1]-1); j++) {
+            ib[1] = j;
+            for (k=VMAX2(bin[3*iatom+2]-1, 0);
+                 k<=VMIN2(bin[3*iatom+2]+1, nbin[2]-1); k++) {
+                ib[2] = k;
+                jatom = head[(ib[0]*nbin[1] + ib[1])*nbin[2] + ib[2]];
+                for (; jatom>=0; jatom=next[jatom]) {
+                    if (jatom == iatom) continue;
+                    other = Valist_getAtom(alist, jatom);
+                    bpos = Vatom_getPosition(other);
+                    dist2 = VSQR(apos[0]-bpos[0]) + VSQR(apos[1]-bpos[1])
+                        + VSQR(apos[2]-bpos[2]);
+                    if (dist2 < VSQR(atom->radius + other->radius
+                                     + 2.0*prad)) {
+                        if (ids != VNULL) ids[nnbr] = jatom;
+                        nnbr++;
+                    }
+                }
+            }
+        }
+    }
+
+    return nnbr;
+}
+
+/**
+ * @brief  Build the overlapping-neighbor lists of all atoms for probes up to
+ *         radius prad
+ */
+VPRIVATE VaccNbrList* Vacc_buildNbrList(Vacc *thee, double prad) {
+
+    VaccNbrList *nbr;
+    Valist *alist;
+    Vatom *atom;
+    int natoms, nbins, iatom, i, nbin[3], *bin, *head, *next, *count;
+    double width, *apos;
+
+    alist = thee->alist;
+    natoms = Valist_getNumberAtoms(alist);
+
+    /* Bins no narrower than two of the largest inflated atoms, coarsened
+     * if a sparse system would need many more bins than atoms */
+    width = VMAX2(2.0*(alist->maxrad + prad), 1.0);
+    do {
+        nbins = 1;
+        for (i=0; i<3; i++) {
+            nbin[i] = (int)((alist->maxcrd[i] - alist->mincrd[i])/width) + 1;
+            nbins *= nbin[i];
+        }
+        if (nbins > 8*natoms + 27) width *= 2.0;
+    } while (nbins > 8*natoms + 27);
+
+#pragma omp critical (Vacc_mem)
+    {
+        nbr = (VaccNbrList*)Vmem_malloc(thee->mem, 1, sizeof(VaccNbrList));
+        nbr->start = (int*)Vmem_malloc(thee->mem, natoms+1, sizeof(int));
+        bin = (int*)Vmem_malloc(thee->mem, 3*VMAX2(natoms, 1), sizeof(int));
+        next = (int*)Vmem_malloc(thee->mem, VMAX2(natoms, 1), sizeof(int));
+        count = (int*)Vmem_malloc(thee->mem, VMAX2(natoms, 1), sizeof(int));
+        head = (int*)Vmem_malloc(thee->mem, nbins, sizeof(int));
+    }
+    VASSERT(nbr != VNULL);
+    nbr->prad = prad;
+    nbr->natoms = natoms;
+
+    /* Chain the atoms of each bin, in increasing ID */
+    for (i=0; i<nbins; i++) head[i] = -1;
+    for (iatom=natoms-1; iatom>=0; iatom--) {
+        atom = Valist_getAtom(alist, iatom);
+        apos = Vatom_getPosition(atom);
+        for (i=0; i<3; i++) {
+            bin[3*iatom+i] = (int)((apos[i] - alist->mincrd[i])/width);
+            bin[3*iatom+i] = VMAX2(VMIN2(bin[3*iatom+i], nbin[i]-1), 0);
+        }
+        i = (bin[3*iatom]*nbin[1] + bin[3*iatom+1])*nbin[2] + bin[3*iatom+2];
+        next[iatom] = head[i];
+        head[i] = iatom;
+    }
+
+    /* Count, then fill, the rows */
+#pragma omp parallel for default(shared) private(iatom) schedule(dynamic,64)
+    for (iatom=0; iatom<natoms; iatom++) {
+        count[iatom] = Vacc_binNeighbors(alist, prad, iatom, bin, nbin, head,
+                                         next, VNULL);
+    }
+    nbr->start[0] = 0;
+    for (iatom=0; iatom<natoms; iatom++) {
+        nbr->start[iatom+1] = nbr->start[iatom] + count[iatom];
+    }
+#pragma omp critical (Vacc_mem)
+    nbr->ids = (int*)Vmem_malloc(thee->mem, nbr->start[natoms], sizeof(int));
+#pragma omp parallel for default(shared) private(iatom) schedule(dynamic,64)
+    for (iatom=0; iatom<natoms; iatom++) {
+        Vacc_binNeighbors(alist, prad, iatom, bin, nbin, head, next,
+                          &(nbr->ids[nbr->start[iatom]]));
+    }
+
+#pragma omp critical (Vacc_mem)
+    {
+        Vmem_free(thee->mem, 3*VMAX2(natoms, 1), sizeof(int), (void **)&bin);
+        Vmem_free(thee->mem, VMAX2(natoms, 1), sizeof(int), (void **)&next);
+        Vmem_free(thee->mem, VMAX2(natoms, 1), sizeof(int), (void **)&count);
+        Vmem_free(thee->mem, nbins, sizeof(int), (void **)&head);
+    }
+
+    Vnm_print(0, "Vacc_buildNbrList:  %d neighbors for %d atoms (probe \
+radius %g)\n", nbr->start[natoms], natoms, prad);
+
+    return nbr;
+}
+
+/**
+ * @brief  Return the neighbor lists, building them on first use
+ * @note   The lists cover every probe radius the cell list can be queried
+ *         with, so they are built once per Vacc.  Safe to call from
+ *         parallel regions, but call it outside them first so that the
+ *         build runs in parallel.
+ */
+VPRIVATE VaccNbrList* Vacc_nbrList(Vacc *thee) {
+
+    VaccNbrList *nbr;
+
+    nbr = thee->nbrList;
+    if (nbr != VNULL) return nbr;
+
+#pragma omp critical (Vacc_nbr)
+    {
+        nbr = thee->nbrList;
+        if (nbr == VNULL) {
+            nbr = Vacc_buildNbrList(thee, Vclist_maxRadius(thee->clist));
+#pragma omp flush
+            thee->nbrList = nbr;
+        }
+    }
+
+    return nbr;
+}
+
+/**
+ * @brief  Set up the SAS points of an atom, allocating from the given memory
+ *         object
+ * @note   Thread-safe: the reference sphere is only read, and the memory
+ *         manager is only touched inside a critical section.  A point is
+ *         accessible if it is outside the inflated spheres of all the atom's
+ *         neighbors, which is the test ivdwAccExclus makes against the
+ *         point's cell
+ */
+VPRIVATE VaccSurf* Vacc_atomSurfMem(Vacc *thee, Vmem *mem, Vatom *atom,
+                                   VaccSurf *ref, double prad) {
+
+    VaccSurf *surf;
+    VaccNbrList *nbr;
+    Vatom *other;
+    char *flags;
+    int i, j, k, m, i0, i1, last, npts, nnbr, nblk, atomID;
+    double arad, rad, pos[3], *apos, *bpos, *nx, *ny, *nz, *nr2, *nr, *bx,
+           *by, *bz, *br2, ztop, zbot, dmin2;
+
+    /* Get atom information */
+    arad = Vatom_getRadius(atom);
+    apos = Vatom_getPosition(atom);
+    atomID = Vatom_getAtomID(atom);
+
+    if (arad < VSMALL) {
+#pragma omp critical (Vacc_mem)
+        surf = VaccSurf_ctor(mem, prad, 0);
+        return surf;
+    }
+
+    /* We can only test probes with radii less than the max specified */
+    if (prad > Vclist_maxRadius(thee->clist)) {
+        Vnm_print(2,
+                  "Vacc_atomSurf: got radius (%g) bigger than max radius (%g)\n",
+                  prad, Vclist_maxRadius(thee->clist));
+        VASSERT(0);
+    }
+
+    rad = arad + prad;
+    nbr = Vacc_nbrList(thee);
+    nnbr = nbr->start[atomID+1] - nbr->start[atomID];
+
+#pragma omp critical (Vacc_mem)
+    {
+        flags = (char*)Vmem_malloc(mem, ref->npts, sizeof(char));
+        nx = (double*)Vmem_malloc(mem, 9*VMAX2(nnbr, 1), sizeof(double));
+    }
+    ny = nx + nnbr;
+    nz = ny + nnbr;
+    nr2 = nz + nnbr;
+    nr = nr2 + nnbr;
+    bx = nr + nnbr;
+    by = bx + nnbr;
+    bz = by + nnbr;
+    br2 = bz + nnbr;
+
+    /* Gather the neighbors that overlap at this probe radius */
+    j = 0;
+    for (k=nbr->start[atomID]; k<nbr->start[atomID+1]; k++) {
+        other = Valist_getAtom(thee->alist, nbr->ids[k]);
+        bpos = Vatom_getPosition(other);
+        if ((VSQR(apos[0]-bpos[0]) + VSQR(apos[1]-bpos[1])
+             + VSQR(apos[2]-bpos[2])) < VSQR(rad + other->radius + prad)) {
+            nx[j] = bpos[0];
+            ny[j] = bpos[1];
+            nz[j] = bpos[2];
+            nr2[j] = VSQR(other->radius + prad);
+            nr[j] = other->radius + prad;
+            j++;
+        }
+    }
+    nnbr = j;
+
+    /* Determine which points will contribute; a point is buried once its
+     * squared distance to some neighbor falls short of the neighbor's.  The
+     * points come in order of non-increasing z, so each band of them is
+     * tested against only the neighbors that reach its z range, starting
+     * with the one that buried the previous point */
+    npts = 0;
+    for (i0=0; i0<ref->npts; i0+=VACC_SURF_BAND) {
+        i1 = VMIN2(i0 + VACC_SURF_BAND, ref->npts);
+        ztop = rad*(ref->zpts[i0]) + apos[2] + VSMALL;
+        zbot = rad*(ref->zpts[i1-1]) + apos[2] - VSMALL;
+        m = 0;
+        for (k=0; k<nnbr; k++) {
+            if ((nz[k] - nr[k] < ztop) && (nz[k] + nr[k] > zbot)) {
+                bx[m] = nx[k];
+                by[m] = ny[k];
+                bz[m] = nz[k];
+                br2[m] = nr2[k];
+                m++;
+            }
+        }
+        last = -1;
+        for (i=i0; i<i1; i++) {
+            pos[0] = rad*(ref->xpts[i]) + apos[0];
+            pos[1] = rad*(ref->ypts[i]) + apos[1];
+            pos[2] = rad*(ref->zpts[i]) + apos[2];
+            flags[i] = 1;
+            if ((last >= 0) && ((VSQR(pos[0]-bx[last]) + VSQR(pos[1]-by[last])
+                                 + VSQR(pos[2]-bz[last]) - br2[last]) < 0.0)) {
+                flags[i] = 0;
+                continue;
+            }
+            for (j=0; j<m; j+=VACC_PTS_BLOCK) {
+                nblk = VMIN2(VACC_PTS_BLOCK, m - j);
+                dmin2 = VLARGE;
+#pragma omp simd reduction(min:dmin2)
+                for (k=j; k<(j+nblk); k++) {
+                    dmin2 = VMIN2(dmin2, VSQR(pos[0]-bx[k])
+                                  + VSQR(pos[1]-by[k]) + VSQR(pos[2]-bz[k])
+                                  - br2[k]);
+                }
+                if (dmin2 < 0.0) {
+                    flags[i] = 0;
+                    for (last=j; last<(j+nblk-1); last++) {
+                        if ((VSQR(pos[0]-bx[last]) + VSQR(pos[1]-by[last])
+                             + VSQR(pos[2]-bz[last]) - br2[last]) < 0.0) break;
+                    }
+                    break;
+                }
+            }
+            npts += flags[i];
+        }
+    }
+
+    /* Allocate space for the points */
+#pragma omp critical (Vacc_mem)
+    surf = VaccSurf_ctor(mem, prad, npts);
+
+    /* Assign the points */
+    j = 0;
+    for (i=0; i<ref->npts; i++) {
+        if (flags[i]) {
+            surf->bpts[j] = 1;
+            surf->xpts[j] = rad*(ref->xpts[i]) + apos[0];
+            surf->ypts[j] = rad*(ref->ypts[i]) + apos[1];
+            surf->zpts[j] = rad*(ref->zpts[i]) + apos[2];
+            j++;
+        }
+    }
+
+#pragma omp critical (Vacc_mem)
+    {
+        Vmem_free(mem, ref->npts, sizeof(char), (void **)&flags);
+        Vmem_free(mem, 9*VMAX2(nbr->start[atomID+1] - nbr->start[atomID], 1),
+                  sizeof(double), (void **)&nx);
+    }
+
+    /* Assign the area */
+    surf->area = 4.0*VPI*rad*rad*((double)(surf->npts))/((double)(ref->npts));
+
+    return surf;
+
+}
+
+/**
+ * @brief  Return the surface for this atom, building it if needed
+ * @note   Safe to call from parallel regions; missing surfaces are built
+ *         one at a time
+ */
+VPRIVATE VaccSurf* Vacc_getSurf(Vacc *thee, double radius, Vatom *atom) {
+
+    VaccSurf *asurf;
+    int id;
+
+    id = Vatom_getAtomID(atom);
+
+    /* Already built?  Surfaces are complete before they are published */
+    if ((thee->surfCache != VNULL) &&
+        (thee->surfCache->probe_radius == radius) &&
+        (thee->surf[id] != VNULL)) return thee->surf[id];
+
+#pragma omp critical (Vacc_surf)
+    {
+        Vacc_acquireSurf(thee, radius);
+        asurf = thee->surf[id];
+        if (asurf == VNULL) {
+            asurf = Vacc_atomSurfMem(thee, thee->surfCache->mem, atom,
+                    thee->refSphere, radius);
+#pragma omp flush
+            thee->surf[id] = asurf;
+        }
+    }
+
+    return asurf;
+}
+
 VPUBLIC Vacc* Vacc_ctor(Valist *alist,
                         Vclist *clist,
                         double surf_density /* Surface density */
@@ -231,6 +722,9 @@ VPUBLIC int Vacc_ctor2(Vacc *thee,
 
     /* Setup and check probe */
     thee->surf = VNULL;
+    thee->surfCache = VNULL;
+    thee->wcaGrid = VNULL;
+    thee->nbrList = VNULL;
 
     /* Allocate space */
     if (!Vacc_allocate(thee)) {
@@ -252,10 +746,30 @@ VPUBLIC void Vacc_dtor(Vacc **thee) {
 
 }
 
+/**
+ * @brief  Destroy the WCA accessibility lattice, if any
+ */
+VPRIVATE void Vacc_freeWCAGrid(Vacc *thee) {
+
+    VaccWCAGrid *grid;
+
+    grid = thee->wcaGrid;
+    if (grid == VNULL) return;
+    thee->wcaGrid = VNULL;
+#pragma omp critical (Vacc_mem)
+    {
+        if (grid->acc != VNULL) {
+            Vmem_free(thee->mem,
+                      (size_t)grid->npts[0]*grid->npts[1]*grid->npts[2],
+                      sizeof(char), (void **)&(grid->acc));
+        }
+        Vmem_free(thee->mem, 1, sizeof(VaccWCAGrid), (void **)&grid);
+    }
+}
+
 VPUBLIC void Vacc_dtor2(Vacc *thee) {
 
-    int i,
-        natoms;
+    int natoms;
 
     natoms = Valist_getNumberAtoms(thee->alist);
     Vmem_free(thee->mem, natoms, sizeof(int), (void **)&(thee->atomFlags));
@@ -264,12 +778,9 @@ VPUBLIC void Vacc_dtor2(Vacc *thee) {
         VaccSurf_dtor(&(thee->refSphere));
         thee->refSphere = VNULL;
     }
-    if (thee->surf != VNULL) {
-        for (i=0; i<natoms; i++) VaccSurf_dtor(&(thee->surf[i]));
-        Vmem_free(thee->mem, natoms, sizeof(VaccSurf *),
-                (void **)&(thee->surf));
-        thee->surf = VNULL;
-    }
+    Vacc_releaseSurf(thee);
+    Vacc_freeWCAGrid(thee);
+    Vacc_freeNbrList(thee);
 
     Vmem_dtor(&(thee->mem));
 }
@@ -634,19 +1145,39 @@ VPUBLIC double Vacc_molAcc(Vacc *thee, double center[VAPBS_DIM],
 
 }
 
+/**
+ * @brief  Find the first of a set of points sorted by non-increasing z that
+ *         lies below a given height
+ * @returns Index of the first point with z < zcut (npts if there is none)
+ */
+VPRIVATE int Vacc_zBelow(double *zpts, int npts, double zcut) {
+
+    int lo, hi, mid;
+
+    lo = 0;
+    hi = npts;
+    while (lo < hi) {
+        mid = (lo + hi)/2;
+        if (zpts[mid] < zcut) hi = mid;
+        else lo = mid + 1;
+    }
+
+    return lo;
+}
+
 VPUBLIC double Vacc_fastMolAcc(Vacc *thee, double center[VAPBS_DIM],
         double radius) {
 
     Vatom *atom;
     VaccSurf *surf;
     VclistCell *cell;
-    int ipt, iatom, atomID;
-    double dist2, rad2;
+    int ipt, iatom, i, nblk, ilo, ihi;
+    double dist2, dmin2, rad2, dist, srad, cx, cy, cz, *apos, *xp, *yp, *zp;
 
     rad2 = radius*radius;
-
-    /* Check to see if the SAS has been defined */
-    if (thee->surf == VNULL) Vacc_SASA(thee, radius);
+    cx = center[0];
+    cy = center[1];
+    cz = center[2];
 
     /* Get the cell associated with this point */
     cell = Vclist_getCell(thee->clist, center);
@@ -658,15 +1189,35 @@ VPUBLIC double Vacc_fastMolAcc(Vacc *thee, double center[VAPBS_DIM],
     /* Loop through all the atoms in the cell */
     for (iatom=0; iatom<cell->natoms; iatom++) {
         atom = cell->atoms[iatom];
-        atomID = Vatom_getAtomID(atom);
-        surf = thee->surf[atomID];
-        /* Loop through all SAS points associated with this atom */
-        for (ipt=0; ipt<surf->npts; ipt++) {
-            /* See if we're within a probe radius of the point */
-            dist2 = VSQR(center[0]-(surf->xpts[ipt]))
-                + VSQR(center[1]-(surf->ypts[ipt]))
-                + VSQR(center[2]-(surf->zpts[ipt]));
-            if (dist2 < rad2) return 1.0;
+
+        /* The SAS points of this atom lie on a sphere of radius srad about
+         * its center; unless that sphere passes within a probe radius of
+         * the point, none of them can (the slack covers rounding in the
+         * stored points) */
+        apos = Vatom_getPosition(atom);
+        srad = Vatom_getRadius(atom) + radius;
+        dist = VSQRT(VSQR(cx-apos[0]) + VSQR(cy-apos[1]) + VSQR(cz-apos[2]));
+        if (VABS(dist - srad) > (radius + VSMALL*srad)) continue;
+
+        /* The points are sorted by z, so only a band of them can be within
+         * a probe radius; loop through those in blocks the compiler can
+         * vectorize */
+        surf = Vacc_getSurf(thee, radius, atom);
+        xp = surf->xpts;
+        yp = surf->ypts;
+        zp = surf->zpts;
+        ilo = Vacc_zBelow(zp, surf->npts, cz + radius*(1.0 + VSMALL) + VSMALL);
+        ihi = Vacc_zBelow(zp, surf->npts, cz - radius*(1.0 + VSMALL) - VSMALL);
+        for (ipt=ilo; ipt<ihi; ipt+=VACC_PTS_BLOCK) {
+            nblk = VMIN2(VACC_PTS_BLOCK, ihi - ipt);
+            dmin2 = VLARGE;
+#pragma omp simd private(dist2) reduction(min:dmin2)
+            for (i=ipt; i<(ipt+nblk); i++) {
+                dist2 = VSQR(cx-xp[i]) + VSQR(cy-yp[i]) + VSQR(cz-zp[i]);
+                dmin2 = VMIN2(dmin2, dist2);
+            }
+            /* See if we're within a probe radius of any of the points */
+            if (dmin2 < rad2) return 1.0;
         }
     }
 
@@ -710,6 +1261,55 @@ VPUBLIC void Vacc_writeGMV(Vacc *thee, double radius, int meth, Gem *gm,
 }
 #endif /* defined(HAVE_MC_H) */
 
+VPUBLIC int Vacc_buildSurf(Vacc *thee,
+                           double radius,
+                           double lower[VAPBS_DIM],
+                           double upper[VAPBS_DIM]
+                           ) {
+
+    int i,
+        idim,
+        natom,
+        nbuilt;
+    double pad,
+           *apos;
+    Vatom *atom;
+    VaccSurf **surf;
+    Vmem *mem;
+
+#pragma omp critical (Vacc_surf)
+    Vacc_acquireSurf(thee, radius);
+    surf = thee->surf;
+    mem = thee->surfCache->mem;
+    natom = Valist_getNumberAtoms(thee->alist);
+
+    /* Build the neighbor lists here, where the build can run in parallel */
+    if (natom > 0) Vacc_nbrList(thee);
+
+    nbuilt = 0;
+#pragma omp parallel for schedule(dynamic,16) default(shared) \
+    private(i,idim,atom,apos,pad) reduction(+:nbuilt)
+    for (i=0; i<natom; i++) {
+        if (surf[i] != VNULL) continue;
+        atom = Valist_getAtom(thee->alist, i);
+        /* Skip atoms whose probe spheres cannot reach the box */
+        if (lower != VNULL) {
+            apos = Vatom_getPosition(atom);
+            pad = Vatom_getRadius(atom) + 2.0*radius;
+            for (idim=0; idim<VAPBS_DIM; idim++) {
+                if ((apos[idim] < (lower[idim] - pad)) ||
+                    (apos[idim] > (upper[idim] + pad))) break;
+            }
+            if (idim < VAPBS_DIM) continue;
+        }
+        surf[i] = Vacc_atomSurfMem(thee, mem, atom, thee->refSphere, radius);
+        nbuilt++;
+    }
+
+    return nbuilt;
+
+}
+
 VPUBLIC double Vacc_SASA(Vacc *thee,
                          double radius
                          ) {
@@ -717,54 +1317,18 @@ VPUBLIC double Vacc_SASA(Vacc *thee,
     int i,
         natom;
     double area;
-           //*apos; // gcc says unused
-    Vatom *atom;
-    VaccSurf *asurf;
 
     time_t ts; // PCE: temp
     ts = clock();
 
-    //unsigned long long mbeg; // gcc says unused
-
     natom = Valist_getNumberAtoms(thee->alist);
 
-    /* Check to see if we need to build the surface */
-    if (thee->surf == VNULL) {
-        thee->surf = Vmem_malloc(thee->mem, natom, sizeof(VaccSurf *));
-
-#if defined(DEBUG_MAC_OSX_OCL) || defined(DEBUG_MAC_OSX_STANDARD)
-#include "mach_chud.h"
-        machm_(&mbeg);
-#pragma omp parallel for private(i,atom)
-#endif
-        for (i=0; i<natom; i++) {
-            atom = Valist_getAtom(thee->alist, i);
-            /* NOTE:  RIGHT NOW WE DO THIS FOR THE ENTIRE MOLECULE WHICH IS
-             * INCREDIBLY INEFFICIENT, PARTICULARLY DURING FOCUSING!!! */
-            thee->surf[i] = Vacc_atomSurf(thee, atom, thee->refSphere,
-                                          radius);
-        }
-    }
+    /* Build whichever atom surfaces are not yet in the cache */
+    Vacc_buildSurf(thee, radius, VNULL, VNULL);
 
     /* Calculate the area */
     area = 0.0;
-    for (i=0; i<natom; i++) {
-        atom = Valist_getAtom(thee->alist, i);
-        asurf = thee->surf[i];
-        /* See if this surface needs to be rebuilt */
-        if (asurf->probe_radius != radius) {
-            Vnm_print(2, "Vacc_SASA:  Warning -- probe radius changed from %g to %g!\n",
-                      asurf->probe_radius, radius);
-            VaccSurf_dtor2(asurf);
-            thee->surf[i] = Vacc_atomSurf(thee, atom, thee->refSphere, radius);
-            asurf = thee->surf[i];
-        }
-        area += (asurf->area);
-    }
-
-#if defined(DEBUG_MAC_OSX_OCL) || defined(DEBUG_MAC_OSX_STANDARD)
-    mets_(&mbeg, "Vacc_SASA - Parallel");
-#endif
+    for (i=0; i<natom; i++) area += (thee->surf[i]->area);
 
     Vnm_print(0, "Vacc_SASA: Time elapsed: %f\n", ((double)clock() - ts) / CLOCKS_PER_SEC);
     return area;
@@ -779,24 +1343,7 @@ VPUBLIC double Vacc_totalSASA(Vacc *thee, double radius) {
 
 VPUBLIC double Vacc_atomSASA(Vacc *thee, double radius, Vatom *atom) {
 
-    VaccSurf *asurf;
-    int id;
-
-    if (thee->surf == VNULL) Vacc_SASA(thee, radius);
-
-    id = Vatom_getAtomID(atom);
-    asurf = thee->surf[id];
-
-    /* See if this surface needs to be rebuilt */
-    if (asurf->probe_radius != radius) {
-        Vnm_print(2, "Vacc_SASA:  Warning -- probe radius changed from %g to %g!\n",
-                asurf->probe_radius, radius);
-        VaccSurf_dtor2(asurf);
-        thee->surf[id] = Vacc_atomSurf(thee, atom, thee->refSphere, radius);
-        asurf = thee->surf[id];
-    }
-
-    return asurf->area;
+    return Vacc_getSurf(thee, radius, atom)->area;
 
 }
 
@@ -868,58 +1415,7 @@ VPUBLIC void VaccSurf_dtor2(VaccSurf *thee) {
 VPUBLIC VaccSurf* Vacc_atomSurf(Vacc *thee, Vatom *atom,
                                 VaccSurf *ref, double prad) {
 
-	VaccSurf *surf;
-	size_t i, j, npts;
-    int atomID;
-    double arad, rad, pos[3], *apos;
-
-    /* Get atom information */
-    arad = Vatom_getRadius(atom);
-    apos = Vatom_getPosition(atom);
-    atomID = Vatom_getAtomID(atom);
-
-    if (arad < VSMALL) {
-        return VaccSurf_ctor(thee->mem, prad, 0);
-    }
-
-    rad = arad + prad;
-
-    /* Determine which points will contribute */
-    npts = 0;
-    for (i=0; i<ref->npts; i++) {
-        /* Reset point flag: zero-radius atoms do not contribute */
-        pos[0] = rad*(ref->xpts[i]) + apos[0];
-        pos[1] = rad*(ref->ypts[i]) + apos[1];
-        pos[2] = rad*(ref->zpts[i]) + apos[2];
-        if (ivdwAccExclus(thee, pos, prad, atomID)) {
-            npts++;
-            ref->bpts[i] = (ref->bpts[i] << 1) + 1;
-        } else {
-            ref->bpts[i] <<= 1;
-        }
-    }
-
-    /* Allocate space for the points */
-    surf = VaccSurf_ctor(thee->mem, prad, npts);
-
-    /* Assign the points */
-    j = 0;
-    for (i=0; i<ref->npts; i++) {
-	    char flag = ref->bpts[i] & 1;
-	    ref->bpts[i] >>= 1;
-	    if (flag) {
-            surf->bpts[j] = 1;
-            surf->xpts[j] = rad*(ref->xpts[i]) + apos[0];
-            surf->ypts[j] = rad*(ref->ypts[i]) + apos[1];
-            surf->zpts[j] = rad*(ref->zpts[i]) + apos[2];
-            j++;
-        }
-    }
-
-    /* Assign the area */
-    surf->area = 4.0*VPI*rad*rad*((double)(surf->npts))/((double)(ref->npts));
-
-    return surf;
+    return Vacc_atomSurfMem(thee, thee->mem, atom, ref, prad);
 
 }
 
@@ -982,24 +1478,7 @@ VPUBLIC VaccSurf* VaccSurf_refSphere(Vmem *mem, int npts) {
 VPUBLIC VaccSurf* Vacc_atomSASPoints(Vacc *thee, double radius,
         Vatom *atom) {
 
-    VaccSurf *asurf = VNULL;
-    int id;
-
-    if (thee->surf == VNULL) Vacc_SASA(thee, radius);
-    id = Vatom_getAtomID(atom);
-
-    asurf = thee->surf[id];
-
-    /* See if this surface needs to be rebuilt */
-    if (asurf->probe_radius != radius) {
-        Vnm_print(2, "Vacc_SASA:  Warning -- probe radius changed from %g to %g!\n",
-                asurf->probe_radius, radius);
-        VaccSurf_dtor2(asurf);
-        thee->surf[id] = Vacc_atomSurf(thee, atom, thee->refSphere, radius);
-        asurf = thee->surf[id];
-    }
-
-    return asurf;
+    return Vacc_getSurf(thee, radius, atom);
 
 }
 
@@ -1257,15 +1736,15 @@ VPRIVATE double Vacc_SASAPos(Vacc *thee, double radius) {
     VaccSurf *asurf;
 
     natom = Valist_getNumberAtoms(thee->alist);
+    Vacc_acquireSurf(thee, radius);
 
     /* Calculate the area */
     area = 0.0;
     for (i=0; i<natom; i++) {
         atom = Valist_getAtom(thee->alist, i);
-        asurf = thee->surf[i];
-
-        VaccSurf_dtor2(asurf);
-        thee->surf[i] = Vacc_atomSurf(thee, atom, thee->refSphere, radius);
+        VaccSurf_dtor(&(thee->surf[i]));
+        thee->surf[i] = Vacc_atomSurfMem(thee, thee->surfCache->mem, atom,
+                thee->refSphere, radius);
         asurf = thee->surf[i];
         area += (asurf->area);
     }
@@ -1293,10 +1772,9 @@ VPRIVATE double Vacc_atomSASAPos(Vacc *thee,
     }
 
     id = Vatom_getAtomID(atom);
-    asurf = thee->surf[id];
-
-    VaccSurf_dtor(&asurf);
-    thee->surf[id] = Vacc_atomSurf(thee, atom, thee->refSphere, radius);
+    VaccSurf_dtor(&(thee->surf[id]));
+    thee->surf[id] = Vacc_atomSurfMem(thee, thee->surfCache->mem, atom,
+            thee->refSphere, radius);
     asurf = thee->surf[id];
 
     //printf("%s: Time elapsed: %f\n", __func__, ((double)clock() - ts) / CLOCKS_PER_SEC);
@@ -1500,26 +1978,362 @@ VPUBLIC void Vacc_totalAtomdSAV(Vacc *thee, double dpos, double srad, Vatom *ato
     dSA[2] = (azt1-azb1)/(2.0 * dpos);
 }
 
-VPUBLIC double Vacc_totalSAV(Vacc *thee, Vclist *clist, APOLparm *apolparm, double radius) {
+/**
+ * @brief  Order intervals by their start
+ */
+VPRIVATE int Vacc_cmpInterval(const void *a, const void *b) {
 
-    int i;
-    int npts[3];
+    double sa, sb;
 
-    double spacs[3], vec[3];
-    double w, wx, wy, wz, len, fn, x, y, z, vol;
-    double vol_density,sav;
+    sa = ((double *)a)[0];
+    sb = ((double *)b)[0];
+    if (sa < sb) return -1;
+    if (sa > sb) return 1;
+    return 0;
+}
+
+/**
+ * @brief  Integrate the area and volume derivatives of an atom over the
+ *         exposed arcs of the circles its neighbors cut on its inflated
+ *         sphere
+ * @param  nbr  Atoms whose inflated spheres intersect this one's
+ * @param  arcs, merged  Scratch of 4 doubles per neighbor
+ */
+VPRIVATE void Vacc_arcdSASAdSAV(double srad, Vatom *atom, Vatom **nbr,
+                                int nnbr, double *arcs, double *merged,
+                                double *dSASA, double *dSAV) {
+
+    int i, j, k, nint, nmerge, buried;
+    double *apos, *bpos, rad, brad, dist, ctheta, stheta, rho, c[3], u[3],
+           e1[3], e2[3], v[3], a, b, m, rhs, t, phi, start, len, end, sa,
+           ssin, scos, fa, fv;
+
+    apos = Vatom_getPosition(atom);
+    rad = Vatom_getRadius(atom) + srad;
+
+    for (j=0; j<nnbr; j++) {
+        bpos = nbr[j]->position;
+        brad = nbr[j]->radius + srad;
+        for (i=0; i<3; i++) u[i] = bpos[i] - apos[i];
+        dist = VSQRT(VSQR(u[0]) + VSQR(u[1]) + VSQR(u[2]));
+        if (dist <= VABS(rad - brad)) continue;
+        for (i=0; i<3; i++) u[i] /= dist;
+        ctheta = (dist*dist + rad*rad - brad*brad)/(2.0*dist*rad);
+        stheta = VSQRT(VMAX2(0.0, 1.0 - ctheta*ctheta));
+        rho = rad*stheta;
+        for (i=0; i<3; i++) c[i] = apos[i] + rad*ctheta*u[i];
+
+        /* Orthonormal basis of the circle's plane */
+        if (VABS(u[0]) < 0.6) {
+            e1[0] = 0.0; e1[1] = u[2]; e1[2] = -u[1];
+        } else {
+            e1[0] = -u[2]; e1[1] = 0.0; e1[2] = u[0];
+        }
+        m = VSQRT(VSQR(e1[0]) + VSQR(e1[1]) + VSQR(e1[2]));
+        for (i=0; i<3; i++) e1[i] /= m;
+        e2[0] = u[1]*e1[2] - u[2]*e1[1];
+        e2[1] = u[2]*e1[0] - u[0]*e1[2];
+        e2[2] = u[0]*e1[1] - u[1]*e1[0];
+
+        /* The point at angle t is inside neighbor k when
+         * 2*rho*(a*cos(t) + b*sin(t)) < rhs */
+        nint = 0;
+        buried = 0;
+        for (k=0; k<nnbr; k++) {
+            if (k == j) continue;
+            bpos = nbr[k]->position;
+            for (i=0; i<3; i++) v[i] = c[i] - bpos[i];
+            a = v[0]*e1[0] + v[1]*e1[1] + v[2]*e1[2];
+            b = v[0]*e2[0] + v[1]*e2[1] + v[2]*e2[2];
+            m = 2.0*rho*VSQRT(a*a + b*b);
+            rhs = VSQR(nbr[k]->radius + srad)
+                - (VSQR(v[0]) + VSQR(v[1]) + VSQR(v[2])) - rho*rho;
+            if (m < VSMALL) {
+                if (rhs > 0.0) {
+                    buried = 1;
+                    break;
+                }
+                continue;
+            }
+            t = rhs/m;
+            if (t >= 1.0) {
+                buried = 1;
+                break;
+            }
+            if (t <= -1.0) continue;
+            phi = atan2(b, a);
+            start = phi + acos(t);
+            len = 2.0*(VPI - acos(t));
+            start = fmod(start, 2.0*VPI);
+            if (start < 0.0) start += 2.0*VPI;
+            if (start + len > 2.0*VPI) {
+                arcs[2*nint] = start;
+                arcs[2*nint+1] = 2.0*VPI;
+                nint++;
+                arcs[2*nint] = 0.0;
+                arcs[2*nint+1] = start + len - 2.0*VPI;
+                nint++;
+            } else {
+                arcs[2*nint] = start;
+                arcs[2*nint+1] = start + len;
+                nint++;
+            }
+        }
+        if (buried) continue;
+
+        /* Merge the buried arcs */
+        qsort(arcs, nint, 2*sizeof(double), Vacc_cmpInterval);
+        nmerge = 0;
+        for (i=0; i<nint; i++) {
+            if ((nmerge > 0) && (arcs[2*i] <= merged[2*nmerge-1])) {
+                merged[2*nmerge-1] = VMAX2(merged[2*nmerge-1], arcs[2*i+1]);
+            } else {
+                merged[2*nmerge] = arcs[2*i];
+                merged[2*nmerge+1] = arcs[2*i+1];
+                nmerge++;
+            }
+        }
+
+        /* Integrate over the exposed gaps between them */
+        sa = 0.0;
+        ssin = 0.0;
+        scos = 0.0;
+        end = 0.0;
+        for (i=0; i<=nmerge; i++) {
+            start = (i < nmerge) ? merged[2*i] : 2.0*VPI;
+            if (start > end) {
+                sa += start - end;
+                ssin += sin(start) - sin(end);
+                scos += cos(end) - cos(start);
+            }
+            if (i < nmerge) end = VMAX2(end, merged[2*i+1]);
+        }
+
+        /* Area: the arc moves by (x - x_j).delta/|tangential part|;
+         * volume: the exposed cap normals, by Stokes on the sphere */
+        fa = rad/dist;
+        fv = -0.5*rad*rad*stheta;
+        for (i=0; i<3; i++) {
+            dSASA[i] += fa*((rad*ctheta - dist)*sa*u[i]
+                            + rho*(ssin*e1[i] + scos*e2[i]));
+            dSAV[i] += fv*(stheta*sa*u[i]
+                           - ctheta*(ssin*e1[i] + scos*e2[i]));
+        }
+    }
+}
+
+/**
+ * @brief  Gather the neighbors whose inflated spheres cut an atom's for the
+ *         given probe radius
+ * @returns Number of neighbors stored in nbr
+ */
+VPRIVATE int Vacc_gatherNbrs(Vacc *thee, VaccNbrList *list, double srad,
+                             Vatom *atom, Vatom **nbr) {
+
+    Vatom *other;
+    int k, id, nnbr;
+    double *apos, *bpos, rad;
+
+    apos = Vatom_getPosition(atom);
+    rad = Vatom_getRadius(atom) + srad;
+    id = Vatom_getAtomID(atom);
+    nnbr = 0;
+    for (k=list->start[id]; k<list->start[id+1]; k++) {
+        other = Valist_getAtom(thee->alist, list->ids[k]);
+        bpos = Vatom_getPosition(other);
+        if ((VSQR(bpos[0]-apos[0]) + VSQR(bpos[1]-apos[1])
+             + VSQR(bpos[2]-apos[2])) < VSQR(rad + other->radius + srad)) {
+            nbr[nnbr] = other;
+            nnbr++;
+        }
+    }
+
+    return nnbr;
+}
+
+VPUBLIC void Vacc_atomdSASAdSAV(Vacc *thee,
+                                double srad,
+                                Vatom *atom,
+                                double *dSASA,
+                                double *dSAV
+                               ) {
+
+    VaccNbrList *list;
+    Vatom **nbr;
+    int i, id, nmax, nnbr;
+    double *arcs, *merged;
+
+    for (i=0; i<3; i++) {
+        dSASA[i] = 0.0;
+        dSAV[i] = 0.0;
+    }
+    if (Vatom_getRadius(atom) < VSMALL) return;
+
+    /* We can only find neighbors for probes up to the max specified */
+    if (srad > Vclist_maxRadius(thee->clist)) {
+        Vnm_print(2,
+                  "Vacc_atomdSASAdSAV: got radius (%g) bigger than max radius (%g)\n",
+                  srad, Vclist_maxRadius(thee->clist));
+        VASSERT(0);
+    }
+
+    list = Vacc_nbrList(thee);
+    id = Vatom_getAtomID(atom);
+    nmax = VMAX2(list->start[id+1] - list->start[id], 1);
+
+#pragma omp critical (Vacc_mem)
+    {
+        nbr = (Vatom**)Vmem_malloc(thee->mem, nmax, sizeof(Vatom *));
+        arcs = (double*)Vmem_malloc(thee->mem, 4*nmax, sizeof(double));
+        merged = (double*)Vmem_malloc(thee->mem, 4*nmax, sizeof(double));
+    }
+
+    nnbr = Vacc_gatherNbrs(thee, list, srad, atom, nbr);
+    Vacc_arcdSASAdSAV(srad, atom, nbr, nnbr, arcs, merged, dSASA, dSAV);
+
+#pragma omp critical (Vacc_mem)
+    {
+        Vmem_free(thee->mem, nmax, sizeof(Vatom *), (void **)&nbr);
+        Vmem_free(thee->mem, 4*nmax, sizeof(double), (void **)&arcs);
+        Vmem_free(thee->mem, 4*nmax, sizeof(double), (void **)&merged);
+    }
+}
+
+VPUBLIC void Vacc_dSASAdSAV(Vacc *thee,
+                            double srad,
+                            double *dSASA,
+                            double *dSAV
+                           ) {
+
+    VaccNbrList *list;
+    Vatom *atom, **nbr;
+    int iatom, natoms, i, nmax, nnbr;
+    double *arcs, *merged;
+
+    natoms = Valist_getNumberAtoms(thee->alist);
+    for (i=0; i<3*natoms; i++) {
+        dSASA[i] = 0.0;
+        dSAV[i] = 0.0;
+    }
+    if (natoms == 0) return;
+
+    /* We can only find neighbors for probes up to the max specified */
+    if (srad > Vclist_maxRadius(thee->clist)) {
+        Vnm_print(2,
+                  "Vacc_dSASAdSAV: got radius (%g) bigger than max radius (%g)\n",
+                  srad, Vclist_maxRadius(thee->clist));
+        VASSERT(0);
+    }
+
+    list = Vacc_nbrList(thee);
+    nmax = 1;
+    for (iatom=0; iatom<natoms; iatom++) {
+        nmax = VMAX2(nmax, list->start[iatom+1] - list->start[iatom]);
+    }
+
+#pragma omp parallel default(shared) private(iatom, nnbr, atom, nbr, arcs, merged)
+    {
+#pragma omp critical (Vacc_mem)
+        {
+            nbr = (Vatom**)Vmem_malloc(thee->mem, nmax, sizeof(Vatom *));
+            arcs = (double*)Vmem_malloc(thee->mem, 4*nmax, sizeof(double));
+            merged = (double*)Vmem_malloc(thee->mem, 4*nmax, sizeof(double));
+        }
+
+#pragma omp for schedule(dynamic,16)
+        for (iatom=0; iatom<natoms; iatom++) {
+            atom = Valist_getAtom(thee->alist, iatom);
+            if (Vatom_getRadius(atom) < VSMALL) continue;
+            nnbr = Vacc_gatherNbrs(thee, list, srad, atom, nbr);
+            Vacc_arcdSASAdSAV(srad, atom, nbr, nnbr, arcs, merged,
+                              &(dSASA[3*iatom]), &(dSAV[3*iatom]));
+        }
+
+#pragma omp critical (Vacc_mem)
+        {
+            Vmem_free(thee->mem, nmax, sizeof(Vatom *), (void **)&nbr);
+            Vmem_free(thee->mem, 4*nmax, sizeof(double), (void **)&arcs);
+            Vmem_free(thee->mem, 4*nmax, sizeof(double), (void **)&merged);
+        }
+    }
+}
+
+/**
+ * @brief  Classify the cells of the accessibility cell list for the volume
+ *         integral
+ * @param  flags  Set to VACC_SAVCELL_EMPTY if every point that maps to the
+ *                cell is accessible, VACC_SAVCELL_FULL if one of the cell's
+ *                inflated atoms covers the whole cell, and
+ *                VACC_SAVCELL_MIXED otherwise
+ */
+VPRIVATE void Vacc_savCells(Vacc *thee, double radius, char *flags) {
+
+    Vclist *clist;
+    VclistCell *cell;
+    Vatom *atom;
+    int icell, ic[3], i, iatom;
+    double lo, hi, far2;
+
+    clist = thee->clist;
+
+#pragma omp parallel for default(shared) private(icell, ic, i, iatom, lo, hi, far2, cell, atom) schedule(dynamic,256)
+    for (icell=0; icell<clist->n; icell++) {
+        cell = &(clist->cells[icell]);
+        flags[icell] = VACC_SAVCELL_EMPTY;
+        if (cell->natoms == 0) continue;
+        flags[icell] = VACC_SAVCELL_MIXED;
+        ic[2] = icell%(clist->npts[2]);
+        ic[1] = (icell/(clist->npts[2]))%(clist->npts[1]);
+        ic[0] = icell/((clist->npts[2])*(clist->npts[1]));
+        for (iatom=0; iatom<cell->natoms; iatom++) {
+            atom = cell->atoms[iatom];
+            /* Squared distance to the farthest corner of the cell; points
+             * just below the lower corner truncate into the first cell */
+            far2 = 0.0;
+            for (i=0; i<3; i++) {
+                lo = clist->lower_corner[i]
+                    + ((ic[i] == 0) ? -1.0 : (double)ic[i])*clist->spacs[i];
+                hi = clist->lower_corner[i] + (ic[i] + 1)*clist->spacs[i];
+                far2 += VMAX2(VSQR(lo - atom->position[i]),
+                              VSQR(hi - atom->position[i]));
+            }
+            if (VSQRT(far2) < atom->radius + radius - VACC_SAVCELL_TOL) {
+                flags[icell] = VACC_SAVCELL_FULL;
+                break;
+            }
+        }
+    }
+}
+
+VPUBLIC double Vacc_totalSAV(Vacc *thee, Vclist *clist, APOLparm *apolparm, double radius) {
+
+    Vclist *acclist;
+    VclistCell *cell;
+    Vatom *atom, **slab, **row;
+    int i, k, ix, iy, iz, iatom, ncell, icell, nmax, nslab, nrow, buried,
+        ic[3], npts[3], nlat[3], *first[3], *last[3];
+    char *flags, *wts[3];
+    double spacs[3], vec[3], dist2, wsum[3];
+    double w, len, fn;
+    double vol_density, sav, nsav;
     double *lower_corner, *upper_corner;
 
-    sav = 0.0;
-    vol = 1.0;
     vol_density = 2.0;
 
     lower_corner = clist->lower_corner;
     upper_corner = clist->upper_corner;
+    acclist = thee->clist;
+
+    /* We can only test probes with radii less than the max specified */
+    if (radius > Vclist_maxRadius(acclist)) {
+        Vnm_print(2,
+                  "Vacc_totalSAV: got radius (%g) bigger than max radius (%g)\n",
+                  radius, Vclist_maxRadius(acclist));
+        VASSERT(0);
+    }
 
     for (i=0; i<3; i++) {
         len = upper_corner[i] - lower_corner[i];
-        vol *= len;
         fn = len*vol_density + 1;
         npts[i] = (int)ceil(fn);
         spacs[i] = len/((double)(npts[i])-1.0);
@@ -1533,50 +2347,387 @@ VPUBLIC double Vacc_totalSAV(Vacc *thee, Vclist *clist, APOLparm *apolparm, doub
 
             }
         }
+        /* Lattice points run from the lower corner up to and including the
+         * upper one */
+        nlat[i] = (int)VFLOOR((len + VSMALL)/spacs[i]) + 1;
     }
 
-    for (x=lower_corner[0]; x<=upper_corner[0]; x=x+spacs[0]) {
-        if ( VABS(x - lower_corner[0]) < VSMALL) {
-            wx = 0.5;
-        } else if ( VABS(x - upper_corner[0]) < VSMALL) {
-            wx = 0.5;
-        } else {
-            wx = 1.0;
+    ncell = acclist->n;
+#pragma omp critical (Vacc_mem)
+    {
+        flags = (char*)Vmem_malloc(thee->mem, ncell, sizeof(char));
+        for (i=0; i<3; i++) {
+            wts[i] = (char*)Vmem_malloc(thee->mem, nlat[i], sizeof(char));
+            first[i] = (int*)Vmem_malloc(thee->mem, acclist->npts[i],
+                                         sizeof(int));
+            last[i] = (int*)Vmem_malloc(thee->mem, acclist->npts[i],
+                                        sizeof(int));
         }
-        vec[0] = x;
-        for (y=lower_corner[1]; y<=upper_corner[1]; y=y+spacs[1]) {
-            if ( VABS(y - lower_corner[1]) < VSMALL) {
-                wy = 0.5;
-            } else if ( VABS(y - upper_corner[1]) < VSMALL) {
-                wy = 0.5;
-            } else {
-                wy = 1.0;
+    }
+
+    /* Twice the trapezoid weights, so that the sum stays an exact integer
+     * and does not depend on the order the threads add it up.  The lattice
+     * points of each row of cells form a contiguous range, found with the
+     * same arithmetic as Vclist_getCell */
+    for (i=0; i<3; i++) {
+        for (ic[i]=0; ic[i]<acclist->npts[i]; ic[i]++) {
+            first[i][ic[i]] = 0;
+            last[i][ic[i]] = -1;
+        }
+        for (k=0; k<nlat[i]; k++) {
+            vec[i] = lower_corner[i] + k*spacs[i];
+            wts[i][k] = 2;
+            if ((k == 0) || (VABS(vec[i] - upper_corner[i]) < VSMALL)) {
+                wts[i][k] = 1;
             }
-            vec[1] = y;
-            for (z=lower_corner[2]; z<=upper_corner[2]; z=z+spacs[2]) {
-                if ( VABS(z - lower_corner[2]) < VSMALL) {
-                    wz = 0.5;
-                } else if ( VABS(z - upper_corner[2]) < VSMALL) {
-                    wz = 0.5;
-                } else {
-                    wz = 1.0;
-                }
-                vec[2] = z;
+            ic[i] = (int)((vec[i] - acclist->lower_corner[i])
+                          /acclist->spacs[i]);
+            if ((ic[i] < 0) || (ic[i] >= acclist->npts[i])) continue;
+            if (last[i][ic[i]] < first[i][ic[i]]) first[i][ic[i]] = k;
+            last[i][ic[i]] = k;
+        }
+    }
 
-                w = wx*wy*wz;
+    Vacc_savCells(thee, radius, flags);
+    nmax = 1;
+    for (icell=0; icell<ncell; icell++) {
+        nmax = VMAX2(nmax, acclist->cells[icell].natoms);
+    }
 
-                sav += (w*(1.0-Vacc_ivdwAcc(thee, vec, radius)));
+    /* Count the inaccessible points cell by cell.  Points outside the cell
+     * list or in empty cells are accessible and points in covered cells are
+     * not.  The rest get Vacc_ivdwAcc's test, against only the atoms of the
+     * cell that reach the plane and then the line of points being tested;
+     * an atom out of reach in x (or x-y) fails the full test everywhere on
+     * it */
+    nsav = 0.0;
+#pragma omp parallel default(shared) private(i, ix, iy, iz, iatom, icell, ic, vec, dist2, wsum, buried, cell, atom, slab, row, nslab, nrow) reduction(+:nsav)
+    {
+#pragma omp critical (Vacc_mem)
+        {
+            slab = (Vatom**)Vmem_malloc(thee->mem, nmax, sizeof(Vatom *));
+            row = (Vatom**)Vmem_malloc(thee->mem, nmax, sizeof(Vatom *));
+        }
 
-            } /* z loop */
-        } /* y loop */
-    } /* x loop */
+#pragma omp for schedule(dynamic,64)
+        for (icell=0; icell<ncell; icell++) {
+            if (flags[icell] == VACC_SAVCELL_EMPTY) continue;
+            ic[2] = icell%(acclist->npts[2]);
+            ic[1] = (icell/(acclist->npts[2]))%(acclist->npts[1]);
+            ic[0] = icell/((acclist->npts[2])*(acclist->npts[1]));
+            if (flags[icell] == VACC_SAVCELL_FULL) {
+                for (i=0; i<3; i++) {
+                    wsum[i] = 0.0;
+                    for (iz=first[i][ic[i]]; iz<=last[i][ic[i]]; iz++) {
+                        wsum[i] += wts[i][iz];
+                    }
+                }
+                nsav += wsum[0]*wsum[1]*wsum[2];
+                continue;
+            }
+            cell = &(acclist->cells[icell]);
+            for (ix=first[0][ic[0]]; ix<=last[0][ic[0]]; ix++) {
+                vec[0] = lower_corner[0] + ix*spacs[0];
+                nslab = 0;
+                for (iatom=0; iatom<cell->natoms; iatom++) {
+                    atom = cell->atoms[iatom];
+                    dist2 = VSQR(vec[0]-atom->position[0]);
+                    if (dist2 < VSQR(atom->radius+radius)) {
+                        slab[nslab] = atom;
+                        nslab++;
+                    }
+                }
+                for (iy=first[1][ic[1]]; iy<=last[1][ic[1]]; iy++) {
+                    vec[1] = lower_corner[1] + iy*spacs[1];
+                    nrow = 0;
+                    for (iatom=0; iatom<nslab; iatom++) {
+                        atom = slab[iatom];
+                        dist2 = VSQR(vec[0]-atom->position[0])
+                            + VSQR(vec[1]-atom->position[1]);
+                        if (dist2 < VSQR(atom->radius+radius)) {
+                            row[nrow] = atom;
+                            nrow++;
+                        }
+                    }
+                    if (nrow == 0) continue;
+                    for (iz=first[2][ic[2]]; iz<=last[2][ic[2]]; iz++) {
+                        vec[2] = lower_corner[2] + iz*spacs[2];
+                        buried = 0;
+                        for (iatom=0; iatom<nrow; iatom++) {
+                            atom = row[iatom];
+                            dist2 = VSQR(vec[0]-atom->position[0])
+                                + VSQR(vec[1]-atom->position[1])
+                                + VSQR(vec[2]-atom->position[2]);
+                            if (dist2 < VSQR(atom->radius+radius)) {
+                                buried = 1;
+                                break;
+                            }
+                        }
+                        if (buried) nsav += wts[0][ix]*wts[1][iy]*wts[2][iz];
+                    } /* z loop */
+                } /* y loop */
+            } /* x loop */
+        } /* cell loop */
+
+#pragma omp critical (Vacc_mem)
+        {
+            Vmem_free(thee->mem, nmax, sizeof(Vatom *), (void **)&slab);
+            Vmem_free(thee->mem, nmax, sizeof(Vatom *), (void **)&row);
+        }
+    }
+
+#pragma omp critical (Vacc_mem)
+    {
+        Vmem_free(thee->mem, ncell, sizeof(char), (void **)&flags);
+        for (i=0; i<3; i++) {
+            Vmem_free(thee->mem, nlat[i], sizeof(char), (void **)&(wts[i]));
+            Vmem_free(thee->mem, acclist->npts[i], sizeof(int),
+                      (void **)&(first[i]));
+            Vmem_free(thee->mem, acclist->npts[i], sizeof(int),
+                      (void **)&(last[i]));
+        }
+    }
 
+    sav = 0.125*nsav;
     w  = spacs[0]*spacs[1]*spacs[2];
     sav *= w;
 
     return sav;
 }
 
+/**
+ * @brief  Spacings of the WCA integration lattice
+ */
+VPRIVATE void Vacc_wcaSpacs(APOLparm *apolparm, double spacs[3]) {
+
+    int i;
+
+    for (i=0; i<3; i++) {
+        spacs[i] = 0.5;
+        if (apolparm->setgrid) spacs[i] = apolparm->grid[i];
+    }
+}
+
+/**
+ * @brief  Count the points that the box loops of the WCA integrals visit
+ *         from lo to hi in steps of h
+ * @returns Number of points; halfEnd is set if the last one is weighted as
+ *          an end point
+ */
+VPRIVATE int Vacc_wcaSteps(double lo, double hi, double h, int *halfEnd) {
+
+    int n;
+    double x, last;
+
+    n = 0;
+    last = lo;
+    for (x=lo; x<=hi; x=x+h) {
+        last = x;
+        n++;
+    }
+    *halfEnd = ((n > 1) && (VABS(last - hi) < VSMALL));
+
+    return n;
+}
+
+/**
+ * @brief  Sample the inflated van der Waals accessibility of the molecule on
+ *         a lattice covering the WCA integration boxes of all atoms
+ * @note   The boxes start on whole Angstroms, so if each spacing is a
+ *         rational p/m the points of every box lie on the lattice of
+ *         spacing 1/m, every p-th point
+ */
+VPRIVATE VaccWCAGrid* Vacc_buildWCAGrid(Vacc *thee, double srad,
+                                        double spacs[3]) {
+
+    VaccWCAGrid *grid;
+    Vatom *atom;
+    int i, m, natoms, iatom, ix, iy, iz;
+    double *pos, upper[3], vec[3], lo, hi, p, nlat, nbox;
+    size_t ntot, u;
+
+#pragma omp critical (Vacc_mem)
+    grid = (VaccWCAGrid*)Vmem_malloc(thee->mem, 1, sizeof(VaccWCAGrid));
+    grid->srad = srad;
+    grid->acc = VNULL;
+
+    natoms = Valist_getNumberAtoms(thee->alist);
+    if (natoms < 1) return grid;
+    for (i=0; i<3; i++) {
+        grid->spacs[i] = spacs[i];
+        grid->scale[i] = 0;
+        for (m=1; m<=VACC_WCA_MAXSCALE; m++) {
+            p = VFLOOR(m*spacs[i] + 0.5);
+            if ((p >= 1.0) && (VABS(m*spacs[i] - p) < VSMALL*m)) {
+                grid->scale[i] = m;
+                grid->stride[i] = (int)p;
+                break;
+            }
+        }
+        if (grid->scale[i] == 0) return grid;
+    }
+
+    /* Cover the boxes of all atoms */
+    for (i=0; i<3; i++) {
+        grid->lower[i] = VLARGE;
+        upper[i] = -VLARGE;
+    }
+    for (iatom=0; iatom<natoms; iatom++) {
+        atom = Valist_getAtom(thee->alist, iatom);
+        pos = Vatom_getPosition(atom);
+        for (i=0; i<3; i++) {
+            lo = (int)(pos[i] - VACC_WCA_CUTOFF);
+            hi = (int)(pos[i] + VACC_WCA_CUTOFF);
+            if (lo < grid->lower[i]) grid->lower[i] = lo;
+            if (hi > upper[i]) upper[i] = hi;
+        }
+    }
+    nlat = 1.0;
+    nbox = (double)natoms;
+    for (i=0; i<3; i++) {
+        grid->npts[i] = (int)(upper[i] - grid->lower[i])*grid->scale[i] + 1;
+        nlat *= grid->npts[i];
+        nbox *= 2.0*VACC_WCA_CUTOFF/spacs[i] + 1.0;
+    }
+
+    /* Sparse or very large systems are cheaper to sample box by box */
+    if ((nlat > nbox) || (nlat > 1073741824.0)) return grid;
+
+    ntot = (size_t)nlat;
+#pragma omp critical (Vacc_mem)
+    grid->acc = (char*)Vmem_malloc(thee->mem, ntot, sizeof(char));
+
+#pragma omp parallel for default(shared) private(ix,iy,iz,vec,u) \
+  schedule(dynamic,1)
+    for (ix=0; ix<grid->npts[0]; ix++) {
+        vec[0] = grid->lower[0] + ((double)ix)/grid->scale[0];
+        for (iy=0; iy<grid->npts[1]; iy++) {
+            vec[1] = grid->lower[1] + ((double)iy)/grid->scale[1];
+            u = ((size_t)ix*grid->npts[1] + iy)*grid->npts[2];
+            for (iz=0; iz<grid->npts[2]; iz++) {
+                vec[2] = grid->lower[2] + ((double)iz)/grid->scale[2];
+                grid->acc[u+iz] = (char)(Vacc_ivdwAcc(thee, vec, srad) != 0.0);
+            }
+        }
+    }
+
+    return grid;
+}
+
+/**
+ * @brief  Return the WCA accessibility lattice for these parameters, building
+ *         it if needed
+ * @note   Safe to call from parallel regions, but the lattice is sampled in
+ *         parallel only when it is first requested outside of one
+ */
+VPRIVATE VaccWCAGrid* Vacc_wcaGrid(Vacc *thee, double srad, double spacs[3]) {
+
+    VaccWCAGrid *grid;
+
+    grid = thee->wcaGrid;
+    if ((grid != VNULL) && (grid->srad == srad) &&
+        (grid->spacs[0] == spacs[0]) && (grid->spacs[1] == spacs[1]) &&
+        (grid->spacs[2] == spacs[2])) return grid;
+
+#pragma omp critical (Vacc_wca)
+    {
+        grid = thee->wcaGrid;
+        if ((grid == VNULL) || (grid->srad != srad) ||
+            (grid->spacs[0] != spacs[0]) || (grid->spacs[1] != spacs[1]) ||
+            (grid->spacs[2] != spacs[2])) {
+            Vacc_freeWCAGrid(thee);
+            grid = Vacc_buildWCAGrid(thee, srad, spacs);
+#pragma omp flush
+            thee->wcaGrid = grid;
+        }
+    }
+
+    return grid;
+}
+
+/**
+ * @brief  Integrate the WCA energy and force kernels of one atom over the
+ *         shared accessibility lattice
+ * @note   Visits the points and weights of the atom's box in
+ *         Vacc_wcaEnergyAtom, skipping the rows and columns outside the
+ *         cutoff sphere.  The sums omit the factors rho*epsilon and the
+ *         volume element
+ * @returns 1 if the box lies on the lattice, 0 otherwise
+ */
+VPRIVATE int Vacc_wcaGridIntegral(VaccWCAGrid *grid, double *pos,
+                                  double sigma, double *energy,
+                                  double force[3]) {
+
+    int i, k0[3], n[3], half[3], ix, iy, iz, kz0, kz1;
+    double cut, cutpad2, sigma6, bmin[3], wx, wy, w, dx, dy, dz, dx2, dxy2;
+    double r2, r, s6, fo, e, f[3];
+    char *row;
+
+    if ((grid == VNULL) || (grid->acc == VNULL)) return 0;
+
+    /* Box lattice indices and point counts, as in the box loops */
+    cut = VACC_WCA_CUTOFF;
+    for (i=0; i<3; i++) {
+        bmin[i] = (int)(pos[i] - cut);
+        n[i] = Vacc_wcaSteps(bmin[i], (int)(pos[i] + cut), grid->spacs[i],
+                             &(half[i]));
+        k0[i] = (int)(bmin[i] - grid->lower[i])*grid->scale[i];
+        if ((k0[i] < 0) ||
+            (k0[i] + (n[i]-1)*grid->stride[i] >= grid->npts[i])) return 0;
+    }
+
+    /* Rows are culled with a padded cutoff; the exact test is per point */
+    cutpad2 = VSQR(cut + VSMALL);
+    sigma6 = VPOW(sigma, 6);
+    e = 0.0;
+    for (i=0; i<3; i++) f[i] = 0.0;
+
+    for (ix=0; ix<n[0]; ix++) {
+        dx = bmin[0] + ((double)(ix*grid->stride[0]))/grid->scale[0] - pos[0];
+        dx2 = dx*dx;
+        if (dx2 > cutpad2) continue;
+        wx = ((ix == 0) || (half[0] && (ix == n[0]-1))) ? 0.5 : 1.0;
+        for (iy=0; iy<n[1]; iy++) {
+            dy = bmin[1] + ((double)(iy*grid->stride[1]))/grid->scale[1]
+                - pos[1];
+            dxy2 = dx2 + dy*dy;
+            if (dxy2 > cutpad2) continue;
+            wy = ((iy == 0) || (half[1] && (iy == n[1]-1))) ? 0.5*wx : wx;
+            dz = VSQRT(cutpad2 - dxy2);
+            kz0 = (int)ceil((pos[2] - dz - bmin[2])/grid->spacs[2]);
+            kz1 = (int)floor((pos[2] + dz - bmin[2])/grid->spacs[2]);
+            kz0 = VMAX2(kz0, 0);
+            kz1 = VMIN2(kz1, n[2]-1);
+            row = grid->acc + ((size_t)(k0[0] + ix*grid->stride[0])
+                               *grid->npts[1]
+                               + (k0[1] + iy*grid->stride[1]))*grid->npts[2]
+                + k0[2];
+            for (iz=kz0; iz<=kz1; iz++) {
+                if (!row[iz*grid->stride[2]]) continue;
+                dz = bmin[2] + ((double)(iz*grid->stride[2]))/grid->scale[2]
+                    - pos[2];
+                r2 = dxy2 + dz*dz;
+                r = VSQRT(r2);
+                if (r > cut) continue;
+                w = ((iz == 0) || (half[2] && (iz == n[2]-1))) ? 0.5*wy : wy;
+                if (r >= sigma) {
+                    s6 = sigma6/(r2*r2*r2);
+                    e += w*(s6*s6 - 2.0*s6);
+                    fo = 12.0*w*(s6 - s6*s6)/r2;
+                    f[0] += fo*dx;
+                    f[1] += fo*dy;
+                    f[2] += fo*dz;
+                } else e -= w;
+            }
+        }
+    }
+
+    *energy = e;
+    for (i=0; i<3; i++) force[i] = f[i];
+
+    return 1;
+}
+
 int Vacc_wcaEnergyAtom(Vacc *thee, APOLparm *apolparm, Valist *alist,
                                  Vclist *clist, int iatom, double *value) {
 
@@ -1597,8 +2748,10 @@ int Vacc_wcaEnergyAtom(Vacc *thee, APOLparm *apolparm, Valist *alist,
 
     double *pos;
     double *lower_corner, *upper_corner;
+    double gridEnergy, gridForce[3];
 
     Vatom *atom = VNULL;
+    VaccWCAGrid *grid;
     VASSERT(apolparm != VNULL);
 
     energy = 0.0;
@@ -1654,6 +2807,13 @@ int Vacc_wcaEnergyAtom(Vacc *thee, APOLparm *apolparm, Valist *alist,
         }
     }
 
+    /* Integrate over the shared accessibility lattice if there is one */
+    grid = Vacc_wcaGrid(thee, srad, spacs);
+    if (Vacc_wcaGridIntegral(grid, pos, sigma, &gridEnergy, gridForce)) {
+        *value = rho*epsilon*gridEnergy*spacs[0]*spacs[1]*spacs[2];
+        return VRC_SUCCESS;
+    }
+
     for (x=xmin; x<=xmax; x=x+spacs[0]) {
         if ( VABS(x - xmin) < VSMALL) {
             wx = 0.5;
@@ -1684,7 +2844,11 @@ int Vacc_wcaEnergyAtom(Vacc *thee, APOLparm *apolparm, Valist *alist,
 
                 w = wx*wy*wz;
 
-                chi = Vacc_ivdwAcc(thee, vec, srad);
+                /* Points past the cutoff contribute nothing */
+                r = VSQRT(VSQR(vec[0]-pos[0]) + VSQR(vec[1]-pos[1])
+                          + VSQR(vec[2]-pos[2]));
+                if (r <= VACC_WCA_CUTOFF) chi = Vacc_ivdwAcc(thee, vec, srad);
+                else chi = 0.0;
 
                 if (VABS(chi) > VSMALL) {
 
@@ -1721,10 +2885,24 @@ int Vacc_wcaEnergyAtom(Vacc *thee, APOLparm *apolparm, Valist *alist,
 VPUBLIC int Vacc_wcaEnergy(Vacc *acc, APOLparm *apolparm, Valist *alist,
                              Vclist *clist){
 
-    int iatom;
-    int rc = 0;
+    int natoms, rc;
+    double *energies;
+
+    natoms = VMAX2(1, Valist_getNumberAtoms(alist));
+    energies = (double*)Vmem_malloc(acc->mem, natoms, sizeof(double));
+    rc = Vacc_wcaEnergyAtoms(acc, apolparm, alist, clist, energies);
+    Vmem_free(acc->mem, natoms, sizeof(double), (void **)&energies);
+
+    return rc;
+
+}
+
+VPUBLIC int Vacc_wcaEnergyAtoms(Vacc *acc, APOLparm *apolparm, Valist *alist,
+                                Vclist *clist, double *energies){
 
-    double energy = 0.0;
+    int iatom, natoms, ok;
+
+    double spacs[3];
     double tenergy = 0.0;
     double rho = apolparm->bconc;
 
@@ -1735,17 +2913,28 @@ VPUBLIC int Vacc_wcaEnergy(Vacc *acc, APOLparm *apolparm, Valist *alist,
         return VRC_FAILURE;
     }
 
+    natoms = Valist_getNumberAtoms(alist);
     if (VABS(rho) < VSMALL) {
+        for (iatom=0; iatom<natoms; iatom++) energies[iatom] = 0.0;
         apolparm->wcaEnergy = tenergy;
         return 1;
     }
 
-    for (iatom=0; iatom<Valist_getNumberAtoms(alist); iatom++){
-        rc = Vacc_wcaEnergyAtom(acc, apolparm, alist, clist, iatom, &energy);
-        if(rc == 0) return 0;
+    /* Sample the shared lattice up front, with all threads */
+    Vacc_wcaSpacs(apolparm, spacs);
+    Vacc_wcaGrid(acc, apolparm->srad, spacs);
 
-        tenergy += energy;
+    ok = 1;
+#pragma omp parallel for default(shared) private(iatom) schedule(dynamic,16) \
+  reduction(&&:ok)
+    for (iatom=0; iatom<natoms; iatom++){
+        ok = (Vacc_wcaEnergyAtom(acc, apolparm, alist, clist, iatom,
+                                 &(energies[iatom])) != 0) && ok;
     }
+    if (!ok) return 0;
+
+    /* Sum in atom order so the total does not depend on the thread count */
+    for (iatom=0; iatom<natoms; iatom++) tenergy += energies[iatom];
 
     apolparm->wcaEnergy = tenergy;
 
@@ -1801,7 +2990,10 @@ VPUBLIC int Vacc_wcaForceAtom(Vacc *thee,
            chi,
            *pos,
            *lower_corner,
-           *upper_corner;
+           *upper_corner,
+           gridEnergy;
+
+    VaccWCAGrid *grid;
 
     /* Allocate needed variables now that we've asserted required conditions. */
     time_t ts;
@@ -1855,6 +3047,15 @@ VPUBLIC int Vacc_wcaForceAtom(Vacc *thee,
         }
     }
 
+    /* Integrate over the shared accessibility lattice if there is one */
+    grid = Vacc_wcaGrid(thee, srad, spacs);
+    if (Vacc_wcaGridIntegral(grid, pos, sigma, &gridEnergy, fpt)) {
+        for (i=0; i<3; i++) {
+            force[i] = rho*epsilon*fpt[i]*spacs[0]*spacs[1]*spacs[2];
+        }
+        return VRC_SUCCESS;
+    }
+
     xmin = pos[0] - pad;
     xmax = pos[0] + pad;
     ymin = pos[1] - pad;
@@ -1892,7 +3093,11 @@ VPUBLIC int Vacc_wcaForceAtom(Vacc *thee,
 
                 w = wx*wy*wz;
 
-                chi = Vacc_ivdwAcc(thee, vec, srad);
+                /* Points past the cutoff contribute nothing */
+                r = VSQRT(VSQR(vec[0]-pos[0]) + VSQR(vec[1]-pos[1])
+                          + VSQR(vec[2]-pos[2]));
+                if (r <= VACC_WCA_CUTOFF) chi = Vacc_ivdwAcc(thee, vec, srad);
+                else chi = 0.0;
 
                 if (chi != 0.0) {
 
@@ -1930,3 +3135,36 @@ VPUBLIC int Vacc_wcaForceAtom(Vacc *thee,
     return VRC_SUCCESS;
 }
 
+VPUBLIC int Vacc_wcaForceAtoms(Vacc *thee,
+                               APOLparm *apolparm,
+                               Vclist *clist,
+                               double *force
+                              ){
+
+    int iatom, natoms, ok;
+    double spacs[3];
+
+    natoms = Valist_getNumberAtoms(thee->alist);
+    for (iatom=0; iatom<3*natoms; iatom++) force[iatom] = 0.0;
+
+    if(apolparm->setwat == 0){
+        Vnm_print(2,"Vacc_wcaEnergy: Error. No value was set for watsigma and watepsilon.\n");
+        return VRC_FAILURE;
+    }
+
+    /* Sample the shared lattice up front, with all threads */
+    Vacc_wcaSpacs(apolparm, spacs);
+    Vacc_wcaGrid(thee, apolparm->srad, spacs);
+
+    ok = 1;
+#pragma omp parallel for default(shared) private(iatom) schedule(dynamic,16) \
+  reduction(&&:ok)
+    for (iatom=0; iatom<natoms; iatom++){
+        ok = (Vacc_wcaForceAtom(thee, apolparm, clist,
+                                Valist_getAtom(thee->alist, iatom),
+                                &(force[3*iatom])) != 0) && ok;
+    }
+
+    return ok;
+}
+
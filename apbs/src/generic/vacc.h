@@ -80,6 +80,8 @@
  * @ingroup  Vacc
  * @author  Nathan Baker
  * @brief  Surface object list of per-atom surface points
+ * @note  The points of a reference sphere, and of the atom surfaces built
+ *  from it, are ordered by non-increasing z; Vacc_fastMolAcc relies on this
  */
 struct sVaccSurf {
     Vmem *mem;  /**< Memory object */
@@ -100,6 +102,96 @@ struct sVaccSurf {
  */
 typedef struct sVaccSurf VaccSurf;
 
+/**
+ *  @ingroup Vacc
+ *  @brief   Number of surface points Vacc_fastMolAcc tests per vectorized
+ *           block before checking for a hit
+ */
+#define VACC_PTS_BLOCK 16
+
+/**
+ *  @ingroup Vacc
+ *  @brief   Number of consecutive reference sphere points the SAS builder
+ *           tests against one z-filtered set of neighbors
+ */
+#define VACC_SURF_BAND 128
+
+/**
+ *  @ingroup Vacc
+ *  @brief   Per-atom surfaces shared by all Vacc objects built on the same
+ *           atom list with the same probe radius and reference sphere
+ *  @note    Private to vacc.c; focusing levels and ELEC blocks on the same
+ *           molecule use one copy of each atom surface
+ */
+typedef struct sVaccSurfCache VaccSurfCache;
+
+/**
+ *  @ingroup Vacc
+ *  @brief   For each atom, the atoms whose probe-inflated spheres overlap its
+ *           own for any probe radius up to the cell list's max radius
+ *  @note    Private to vacc.c; built once and used by the SAS builder and the
+ *           analytic area and volume derivatives
+ */
+typedef struct sVaccNbrList VaccNbrList;
+
+/**
+ *  @ingroup Vacc
+ *  @brief   Cutoff (A) of the WCA dispersion integrals around each atom
+ */
+#define VACC_WCA_CUTOFF 14
+
+/**
+ *  @ingroup Vacc
+ *  @brief   Finest WCA accessibility lattice, in points per A, used to hold
+ *           the integration points of all atoms
+ */
+#define VACC_WCA_MAXSCALE 20
+
+/**
+ *  @ingroup Vacc
+ *  @brief   Vacc_totalSAV cell classes: every point accessible, every point
+ *           inside one inflated atom, or test each point
+ */
+#define VACC_SAVCELL_EMPTY 0
+#define VACC_SAVCELL_FULL 1
+#define VACC_SAVCELL_MIXED 2
+
+/**
+ *  @ingroup Vacc
+ *  @brief   Margin (A) by which an inflated atom must cover a whole cell
+ *           for Vacc_totalSAV to skip the cell's point tests
+ */
+#define VACC_SAVCELL_TOL 1e-6
+
+/**
+ *  @ingroup Vacc
+ *  @brief   Inflated van der Waals accessibility of the whole molecule on the
+ *           lattice of the WCA integrals
+ *  @note    Built on first use and shared by the integrals of all atoms.  acc
+ *           is VNULL if the spacings are not fractions with denominators up
+ *           to VACC_WCA_MAXSCALE or the lattice would cost more than the
+ *           per-atom boxes; the integrals then query the accessibility point
+ *           by point
+ */
+struct sVaccWCAGrid {
+    double srad;  /**< Probe radius (A) of the accessibility */
+    double spacs[3];  /**< Spacings (A) of the integration points */
+    int scale[3];  /**< Lattice points per A in each direction */
+    int stride[3];  /**< Lattice points per integration step, so that
+                     * spacs = stride/scale */
+    double lower[3];  /**< Lower lattice corner (A) */
+    int npts[3];  /**< Number of lattice points in each direction */
+    char *acc;  /**< Accessibility (1) or not (0) of each lattice point, with
+                 * z varying fastest */
+};
+
+/**
+ *  @ingroup Vacc
+ *  @brief   Declaration of the VaccWCAGrid class as the sVaccWCAGrid
+ *           structure
+ */
+typedef struct sVaccWCAGrid VaccWCAGrid;
+
 /**
  *  @ingroup Vacc
  *  @author  Nathan Baker
@@ -116,7 +208,13 @@ struct sVacc {
   VaccSurf *refSphere;  /**< Reference sphere for SASA calculations */
   VaccSurf **surf;  /**< Array of surface points for each atom; is not
                     * initialized until needed (test against VNULL to
-                    * determine initialization state) */
+                    * determine initialization state).  Individual entries
+                    * are VNULL until that atom's surface is needed */
+  VaccSurfCache *surfCache;  /**< Shared cache which owns the surf array */
+  VaccNbrList *nbrList;  /**< Overlapping neighbors of each atom; VNULL until
+                         * needed */
+  VaccWCAGrid *wcaGrid;  /**< Accessibility lattice for the WCA integrals;
+                         * VNULL until needed */
   Vset acc;  /**< An integer array (to be treated as bitfields) of Vset type
               * with length equal to the number of vertices in the mesh */
   double surf_density;  /**< Minimum solvent accessible surface point density
@@ -479,6 +577,52 @@ VEXTERNC double Vacc_SASA(
         double radius  /**< Probe molecule radius (&Aring;) */
         );
 
+/**
+ * @brief  Attach to the per-atom surfaces shared by all accessibility
+ *         objects on this molecule with this probe radius, creating an empty
+ *         set if there is none
+ * @ingroup Vacc
+ * @note  Surfaces are built lazily and live as long as any object holds
+ *        them, so attaching a new object before its predecessor (e.g., the
+ *        previous focusing level) is destroyed lets it reuse that work.
+ *        Not thread-safe.
+ */
+VEXTERNC void Vacc_acquireSurf(
+        Vacc *thee,  /**< Accessibility object */
+        double radius  /**< Probe molecule radius (&Aring;) */
+        );
+
+/**
+ * @brief  Stop sharing the per-atom surfaces of a molecule with objects
+ *         constructed from now on
+ * @ingroup Vacc
+ * @note  Call this after moving the atoms of the list; objects that already
+ *        hold the old surfaces keep them until they are destroyed.
+ *        Not thread-safe.
+ */
+VEXTERNC void Vacc_invalidateSurf(
+        Valist *alist  /**< Atom list whose surfaces are out of date */
+        );
+
+/**
+ * @brief  Build, in parallel, the missing per-atom SAS point sets for the
+ *         atoms whose surfaces can reach into a box
+ * @ingroup Vacc
+ * @note  An atom is built if its center lies within the van der Waals
+ *        radius plus twice the probe radius of the box, i.e., if a probe
+ *        sphere centered on its SAS can overlap the box.  Surfaces already
+ *        present in the shared cache are not rebuilt.
+ * @return  Number of atom surfaces constructed by this call
+ */
+VEXTERNC int Vacc_buildSurf(
+        Vacc *thee,  /**< Accessibility object */
+        double radius,  /**< Probe molecule radius (&Aring;) */
+        double lower[VAPBS_DIM],  /**< Lower corner of the box, or VNULL to
+                                   * build the surfaces of all atoms */
+        double upper[VAPBS_DIM]  /**< Upper corner of the box (ignored if
+                                  * lower is VNULL) */
+        );
+
 /**
  * @brief  Return the total solvent accessible surface area (SASA)
  * @ingroup  Vacc
@@ -568,6 +712,36 @@ VEXTERNC void Vacc_totalAtomdSAV(
                                  Vclist *clist /**< clist for this calculation */
                                  );
 
+/**
+ * @brief  Get the analytic derivatives of an atom's solvent accessible area
+ *         and volume with respect to its position
+ * @ingroup  Vacc
+ * @note  The derivatives are integrals over the arcs where the neighbors'
+ *        probe-inflated spheres cut the atom's, so they are exact for the
+ *        union of spheres rather than finite differences of the sampled
+ *        surface.  The probe radius can be at most the cell list's max
+ *        radius.
+ */
+VEXTERNC void Vacc_atomdSASAdSAV(
+        Vacc *thee,  /**< Accessibility object */
+        double radius,  /**< Probe radius (&Aring;) */
+        Vatom *atom,  /**< Atom of interest */
+        double *dSASA,  /**< Set to the 3 area derivatives (&Aring;) */
+        double *dSAV  /**< Set to the 3 volume derivatives (&Aring;<sup>2</sup>) */
+        );
+
+/**
+ * @brief  Get the analytic area and volume derivatives of every atom
+ * @ingroup  Vacc
+ * @note  Threaded over atoms; see Vacc_atomdSASAdSAV
+ */
+VEXTERNC void Vacc_dSASAdSAV(
+        Vacc *thee,  /**< Accessibility object */
+        double radius,  /**< Probe radius (&Aring;) */
+        double *dSASA,  /**< Set to the area derivatives, 3 per atom */
+        double *dSAV  /**< Set to the volume derivatives, 3 per atom */
+        );
+
 /**
  * @brief  Return the total solvent accessible volume (SAV)
  * @ingroup  Vacc
@@ -595,6 +769,22 @@ VEXTERNC int Vacc_wcaEnergy(
                              Valist *alist, /**< Alist for acc object */
                              Vclist *clist /**< Clist for acc object */
                              );
+/**
+ * @brief  Calculate the WCA integral energies of all atoms and their total
+ * @ingroup  Vacc
+ * @note   The atoms are integrated in parallel over one accessibility
+ *         lattice; the total is stored in apolparm->wcaEnergy
+ * @return Success flag
+ */
+VEXTERNC int Vacc_wcaEnergyAtoms(
+                           Vacc *thee,  /**< Accessibility object */
+                           APOLparm *apolparm,  /**< Apolar calculation parameters */
+                           Valist *alist, /**< Alist for acc object */
+                           Vclist *clist, /**< Clist for acc object */
+                           double *energies /**< Set to the energy of each
+                                             * atom (kJ/mol) */
+                           );
+
 /**
  * @brief  Return the WCA integral force
  * @ingroup  Vacc
@@ -608,6 +798,20 @@ VEXTERNC int Vacc_wcaForceAtom(Vacc *thee, /**< Accessibility object */
                               double *force /**< Force for atom */
                            );
 
+/**
+ * @brief  Calculate the WCA integral forces on all atoms
+ * @ingroup  Vacc
+ * @note   The atoms are integrated in parallel over one accessibility
+ *         lattice
+ * @return Success flag
+ */
+VEXTERNC int Vacc_wcaForceAtoms(Vacc *thee, /**< Accessibility object */
+                               APOLparm *apolparm,  /**< Apolar calculation parameters */
+                               Vclist *clist, /**< Clist for acc object */
+                               double *force /**< Set to the forces, 3 per
+                                              * atom of the acc object */
+                               );
+
 /**	@brief	Calculate the WCA energy for an atom
     @ingroup Vacc
     @author	Dave Gohara and Nathan Baker
@@ -213,7 +213,10 @@ enum eVbcfl {
     BCFL_UNUSED=3,  /**< Unused boundary condition method (placeholder) */
     BCFL_FOCUS=4,  /**< Focusing Dirichlet boundary condition */
     BCFL_MEM=5,  /**< Focusing membrane boundary condition */
-    BCFL_MAP=6    /**< Skip first level of focusing use an external map */
+    BCFL_MAP=6,    /**< Skip first level of focusing use an external map */
+    BCFL_MDHTREE=7  /**< Multiple-sphere Debye-Huckel Dirichlet boundary
+                     * condition evaluated with a hierarchical (treecode)
+                     * approximation */
 };
 
 /**
@@ -386,6 +389,21 @@ typedef enum eVdata_Format Vdata_Format;
  */
 #define VMGNLEV 4
 
+/** @brief   Largest coarsest-grid dimension chosen when a grid dimension
+ *           has to be padded to fit the multigrid hierarchy
+ *  @ingroup Vhal
+ */
+#define VMGNCMAX 17
+
+/** @brief   Number of z planes a processor's slab of a distributed
+ *           multigrid calculation carries beyond the ones it owns on
+ *           either side, on top of the planes the atoms reach into the
+ *           coefficient maps: three ghost planes and the reach of the
+ *           charge splines that fill them
+ *  @ingroup Vhal
+ */
+#define VMGDISTOVERLAP 6
+
 /** @brief   Maximum reduction of grid spacing during a focusing calculation
  *  @ingroup Vhal
  */
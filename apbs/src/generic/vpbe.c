@@ -440,6 +440,11 @@ function\n", thee->maxIonRadius);
 
     VASSERT(thee->acc != VNULL);
 
+    /* Claim the molecule's atom surfaces now so any built by a previous
+     * calculation (e.g., the coarser focusing level) survive its teardown */
+    if (thee->solventRadius > VSMALL)
+        Vacc_acquireSurf(thee->acc, thee->solventRadius);
+
     /* SMPBE Added */
     thee->smsize = 0.0;
     thee->smvolume = 0.0;
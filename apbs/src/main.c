@@ -469,6 +469,22 @@ int main(
                 mgparm = nosh->calc[i]->mgparm;
                 pbeparm = nosh->calc[i]->pbeparm;
 
+                /* Solve all the subdomains of the ELEC statement here */
+                if ((mgparm->type == MCT_PARALLEL) && mgparm->inproc) {
+                    if (!inprocMG(mem, nosh, k, i, alist, dielXMap, dielYMap,
+                                  dielZMap, kappaMap, chargeMap, potMap, pbe,
+                                  pmgp, pmg, nenergy, totEnergy, qfEnergy,
+                                  qmEnergy, dielEnergy, atomEnergy, nforce,
+                                  atomForce)) {
+                        Vnm_tprint( 2, "Error solving MG subdomains!\n");
+                        VJMPERR1(0);
+                    }
+                    i = nosh->elec2calc[k];
+                    fflush(stdout);
+                    fflush(stderr);
+                    break;
+                }
+
                 /* Set up problem */
                 Vnm_tprint( 1, "  Setting up problem...\n");
 
@@ -484,7 +500,12 @@ int main(
                 printPBEPARM(pbeparm);
 
                 /* Solve PDE */
-                if (solveMG(nosh, pmg[i], mgparm->type) != 1) {
+                if (mgparm->distrib) {
+                    if (solveDistMG(com, nosh, mgparm, pmg[i]) != 1) {
+                        Vnm_tprint(2, "Error solving PDE!\n");
+                        VJMPERR1(0);
+                    }
+                } else if (solveMG(nosh, pmg[i], mgparm->type) != 1) {
                     Vnm_tprint(2, "Error solving PDE!\n");
                     VJMPERR1(0);
                 }
@@ -500,6 +521,12 @@ int main(
                         &(nenergy[i]), &(totEnergy[i]), &(qfEnergy[i]),
                         &(qmEnergy[i]), &(dielEnergy[i]));
 
+                /* Solve and write out the energies of other charge sets */
+                if (rhsMG(nosh, i, pmg[i], alist) != 1) {
+                    Vnm_tprint(2, "Error solving the other charge sets!\n");
+                    VJMPERR1(0);
+                }
+
                 /* Write out forces */
                 forceMG(mem, nosh, pbeparm, mgparm, pmg[i], &(nforce[i]),
                         &(atomForce[i]), alist);
@@ -56,6 +56,7 @@
 
 #include "vgrid.h"
 #include <stdio.h>
+#include <stdarg.h>
 
 VEMBED(rcsid="$Id$")
 
@@ -580,7 +581,228 @@ VPUBLIC int Vgrid_readGZ(Vgrid *thee, const char *fname) {
 }
 
 /**
- * Load grid from an input file using sockets.
+ * Fill tok with the next token of DX text held in memory, skipping the same
+ * white space and comment characters as the Vio sockets.
+ * @returns 1 if a token was found, 0 at the end of the text
+ */
+VPRIVATE int Vgrid_textToken(const char *text, size_t len, size_t *pos,
+  char *tok) {
+
+    size_t i, n;
+
+    i = *pos;
+    while (i < len) {
+        if (strchr(MCcommChars, text[i]) != VNULL) {
+            while ((i < len) && (text[i] != '\n')) i++;
+        } else if (strchr(MCwhiteChars, text[i]) != VNULL) {
+            i++;
+        } else break;
+    }
+    n = 0;
+    while ((i < len) && (strchr(MCwhiteChars, text[i]) == VNULL)) {
+        if (n < VMAX_BUFSIZE-1) tok[n++] = text[i];
+        i++;
+    }
+    tok[n] = '\0';
+    *pos = i;
+
+    return (n > 0);
+}
+
+/**
+ * Read the next DX token from a socket or, if sock is VNULL, from text held
+ * in memory.
+ * @returns 1 if a token was found, 0 otherwise
+ */
+VPRIVATE int Vgrid_dxToken(Vio *sock, const char *text, size_t len,
+  size_t *pos, char *tok) {
+
+    if (sock != VNULL) return Vio_scanf(sock, "%s", tok);
+    return Vgrid_textToken(text, len, pos, tok);
+}
+
+/**
+ * Parse the data section of a DX file held in memory.  The text is cut into
+ * chunks at line breaks; the chunks are first scanned in parallel to count
+ * their values, which gives each chunk the index of its first value, and are
+ * then parsed in parallel straight into the data array.  Values past the
+ * first nx*ny*nz (the trailing field description) are ignored.
+ * @returns 1 if successful, 0 if a value could not be parsed and -1 if there
+ *          were too few values
+ */
+VPRIVATE int Vgrid_parseDXData(Vgrid *thee, char *text, size_t len) {
+
+    size_t nchunk, ichunk, i, n, pos, ndata, itok, nyz, *start, *count;
+    int nx, ny, nz, ii, jj, kk, rc;
+    char *end;
+
+    nx = thee->nx;
+    ny = thee->ny;
+    nz = thee->nz;
+    nyz = (size_t)ny*nz;
+    ndata = (size_t)nx*nyz;
+
+    /* Chunk boundaries, each moved forward to the start of a line */
+    nchunk = len/VGRID_CHUNK + 1;
+    start = (size_t*)Vmem_malloc(thee->mem, nchunk+1, sizeof(size_t));
+    count = (size_t*)Vmem_malloc(thee->mem, nchunk+1, sizeof(size_t));
+    start[0] = 0;
+    for (ichunk=1; ichunk<nchunk; ichunk++) {
+        pos = VMAX2(ichunk*VGRID_CHUNK, start[ichunk-1]);
+        while ((pos < len) && (text[pos-1] != '\n')) pos++;
+        start[ichunk] = pos;
+    }
+    start[nchunk] = len;
+
+    /* Count the values in each chunk */
+#pragma omp parallel for default(shared) private(ichunk,pos,n) \
+  schedule(dynamic,1)
+    for (ichunk=0; ichunk<nchunk; ichunk++) {
+        n = 0;
+        pos = start[ichunk];
+        while (pos < start[ichunk+1]) {
+            if (strchr(MCcommChars, text[pos]) != VNULL) {
+                while ((pos < start[ichunk+1]) && (text[pos] != '\n')) pos++;
+            } else if (strchr(MCwhiteChars, text[pos]) != VNULL) {
+                pos++;
+            } else {
+                n++;
+                while ((pos < start[ichunk+1]) &&
+                       (strchr(MCwhiteChars, text[pos]) == VNULL)) pos++;
+            }
+        }
+        count[ichunk+1] = n;
+    }
+    count[0] = 0;
+    for (ichunk=0; ichunk<nchunk; ichunk++) count[ichunk+1] += count[ichunk];
+    if (count[nchunk] < ndata) {
+        Vmem_free(thee->mem, nchunk+1, sizeof(size_t), (void **)&start);
+        Vmem_free(thee->mem, nchunk+1, sizeof(size_t), (void **)&count);
+        return -1;
+    }
+
+    /* Parse them; the values are stored with z varying fastest */
+    rc = 1;
+#pragma omp parallel for default(shared) \
+  private(ichunk,pos,itok,i,ii,jj,kk,end) schedule(dynamic,1) reduction(&&:rc)
+    for (ichunk=0; ichunk<nchunk; ichunk++) {
+        itok = count[ichunk];
+        pos = start[ichunk];
+        while ((pos < start[ichunk+1]) && (itok < ndata)) {
+            if (strchr(MCcommChars, text[pos]) != VNULL) {
+                while ((pos < start[ichunk+1]) && (text[pos] != '\n')) pos++;
+            } else if (strchr(MCwhiteChars, text[pos]) != VNULL) {
+                pos++;
+            } else {
+                ii = (int)(itok/nyz);
+                jj = (int)((itok/nz)%ny);
+                kk = (int)(itok%nz);
+                i = (size_t)kk*nx*ny + (size_t)jj*nx + ii;
+                thee->data[i] = strtod(text + pos, &end);
+                if (end == text + pos) rc = 0;
+                itok++;
+                while ((pos < start[ichunk+1]) &&
+                       (strchr(MCwhiteChars, text[pos]) == VNULL)) pos++;
+            }
+        }
+    }
+
+    Vmem_free(thee->mem, nchunk+1, sizeof(size_t), (void **)&start);
+    Vmem_free(thee->mem, nchunk+1, sizeof(size_t), (void **)&count);
+
+    return rc;
+}
+
+/**
+ * Formatted output to a socket or, if sock is VNULL, to a plain file.
+ */
+VPRIVATE void Vgrid_dxPrintf(Vio *sock, FILE *fp, const char *format, ...) {
+
+    char buf[VMAX_BUFSIZE];
+    va_list ap;
+
+    va_start(ap, format);
+    if (sock != VNULL) {
+        vsnprintf(buf, VMAX_BUFSIZE, format, ap);
+        Vio_printf(sock, "%s", buf);
+    } else vfprintf(fp, format, ap);
+    va_end(ap);
+}
+
+/**
+ * Write the data section of a DX file to a plain file.  Slabs of constant
+ * x are formatted in parallel into their own buffers, in batches, and each
+ * batch is written out in order, so the output is the same as printing the
+ * values one at a time.  Only the points with positive pvec are written if
+ * pvec is given.
+ */
+VPRIVATE void Vgrid_writeDXData(Vgrid *thee, FILE *fp, double *pvec) {
+
+    size_t nyz, slablen, *first, nwrite, *blen, icol;
+    int nx, ny, nz, i, j, k, i0, nbatch, ib;
+    char *buf, *p;
+
+    nx = thee->nx;
+    ny = thee->ny;
+    nz = thee->nz;
+    nyz = (size_t)ny*nz;
+
+    /* Number of values written before each slab, which fixes where the
+     * line breaks fall */
+    first = (size_t*)Vmem_malloc(thee->mem, nx+1, sizeof(size_t));
+    first[0] = 0;
+    for (i=0; i<nx; i++) {
+        if (pvec == VNULL) first[i+1] = first[i] + nyz;
+        else {
+            nwrite = 0;
+            for (k=0; k<nz; k++) {
+                for (j=0; j<ny; j++) {
+                    if (pvec[IJK(i,j,k)] > 0.0) nwrite++;
+                }
+            }
+            first[i+1] = first[i] + nwrite;
+        }
+    }
+
+    /* Each value takes at most VGRID_DXWIDTH characters and a line break */
+    slablen = nyz*(VGRID_DXWIDTH+1) + 1;
+    nbatch = (int)VMAX2(1, VMIN2((size_t)nx, VGRID_CHUNK*16/slablen));
+    buf = (char*)Vmem_malloc(thee->mem, nbatch*slablen, sizeof(char));
+    blen = (size_t*)Vmem_malloc(thee->mem, nbatch, sizeof(size_t));
+    for (i0=0; i0<nx; i0+=nbatch) {
+#pragma omp parallel for default(shared) private(i,j,k,p,icol) \
+  schedule(dynamic,1)
+        for (i=i0; i<VMIN2(nx, i0+nbatch); i++) {
+            p = buf + (i-i0)*slablen;
+            icol = first[i]%3;
+            for (j=0; j<ny; j++) {
+                for (k=0; k<nz; k++) {
+                    if ((pvec != VNULL) && !(pvec[IJK(i,j,k)] > 0.0)) continue;
+                    p += sprintf(p, "%12.6e ", thee->data[IJK(i,j,k)]);
+                    icol++;
+                    if (icol == 3) {
+                        icol = 0;
+                        *p = '\n';
+                        p++;
+                    }
+                }
+            }
+            blen[i-i0] = p - (buf + (i-i0)*slablen);
+        }
+        for (ib=0; ib<VMIN2(nbatch, nx-i0); ib++) {
+            fwrite(buf + ib*slablen, sizeof(char), blen[ib], fp);
+        }
+    }
+    if (first[nx]%3 != 0) fputc('\n', fp);
+
+    Vmem_free(thee->mem, nbatch*slablen, sizeof(char), (void **)&buf);
+    Vmem_free(thee->mem, nbatch, sizeof(size_t), (void **)&blen);
+    Vmem_free(thee->mem, nx+1, sizeof(size_t), (void **)&first);
+}
+
+/**
+ * Load grid from an input file using sockets.  Plain ASCII files are read
+ * whole and parsed in memory instead.
  * @author Nathan Baker
  */
 VPUBLIC int Vgrid_readDX(Vgrid *thee,
@@ -590,10 +812,13 @@ VPUBLIC int Vgrid_readDX(Vgrid *thee,
                          const char *fname
                         ) {
 
-    size_t i, j, k, itmp, u;
+    size_t i, j, k, itmp, u, len, pos;
+    long flen;
     double dtmp;
-    char tok[VMAX_BUFSIZE];
+    char tok[VMAX_BUFSIZE], *text;
     Vio *sock;
+    FILE *fp;
+    int rc;
 
     /* Check to see if the existing data is null and, if not, clear it out */
     if (thee->data != VNULL) {
@@ -603,159 +828,191 @@ VPUBLIC int Vgrid_readDX(Vgrid *thee,
     thee->readdata = 1;
     thee->ctordata = 0;
 
-    /* Set up the virtual socket */
-    sock = Vio_ctor(iodev,iofmt,thost,fname,"r");
-    if (sock == VNULL) {
-        Vnm_print(2, "Vgrid_readDX: Problem opening virtual socket %s\n",
-          fname);
-        return 0;
-    }
-    if (Vio_accept(sock, 0) < 0) {
-        Vnm_print(2, "Vgrid_readDX: Problem accepting virtual socket %s\n",
-          fname);
-        return 0;
-    }
+    sock = VNULL;
+    text = VNULL;
+    len = 0;
+    pos = 0;
+    if ((Vstring_strcasecmp(iodev, "FILE") == 0) &&
+        (Vstring_strcasecmp(iofmt, "ASC") == 0)) {
+        /* Read plain files whole; they are parsed in memory */
+        fp = fopen(fname, "rb");
+        if (fp == VNULL) {
+            Vnm_print(2, "Vgrid_readDX: Problem opening file %s\n", fname);
+            return 0;
+        }
+        flen = -1;
+        if (fseek(fp, 0, SEEK_END) == 0) flen = ftell(fp);
+        if ((flen < 0) || (fseek(fp, 0, SEEK_SET) != 0)) {
+            Vnm_print(2, "Vgrid_readDX: Problem finding the size of file %s\n",
+              fname);
+            fclose(fp);
+            return 0;
+        }
+        len = (size_t)flen;
+        text = (char*)Vmem_malloc(thee->mem, len+1, sizeof(char));
+        if (fread(text, sizeof(char), len, fp) != len) {
+            Vnm_print(2, "Vgrid_readDX: Problem reading file %s\n", fname);
+            fclose(fp);
+            Vmem_free(thee->mem, len+1, sizeof(char), (void **)&text);
+            return 0;
+        }
+        fclose(fp);
+        text[len] = '\0';
+    } else {
+        /* Set up the virtual socket */
+        sock = Vio_ctor(iodev,iofmt,thost,fname,"r");
+        if (sock == VNULL) {
+            Vnm_print(2, "Vgrid_readDX: Problem opening virtual socket %s\n",
+              fname);
+            return 0;
+        }
+        if (Vio_accept(sock, 0) < 0) {
+            Vnm_print(2, "Vgrid_readDX: Problem accepting virtual socket %s\n",
+              fname);
+            return 0;
+        }
 
-    Vio_setWhiteChars(sock, MCwhiteChars);
-    Vio_setCommChars(sock, MCcommChars);
+        Vio_setWhiteChars(sock, MCwhiteChars);
+        Vio_setCommChars(sock, MCcommChars);
+    }
 
     /* Read in the DX regular positions */
     /* Get "object" */
-    VJMPERR2(1 == Vio_scanf(sock, "%s", tok));
+    VJMPERR2(1 == Vgrid_dxToken(sock, text, len, &pos, tok));
     VJMPERR1(!strcmp(tok, "object"));
     /* Get "1" */
-    VJMPERR2(1 == Vio_scanf(sock, "%d", &itmp));
+    VJMPERR2(1 == Vgrid_dxToken(sock, text, len, &pos, tok));
     /* Get "class" */
-    VJMPERR2(1 == Vio_scanf(sock, "%s", tok));
+    VJMPERR2(1 == Vgrid_dxToken(sock, text, len, &pos, tok));
     VJMPERR1(!strcmp(tok, "class"));
     /* Get "gridpositions" */
-    VJMPERR2(1 == Vio_scanf(sock, "%s", tok));
+    VJMPERR2(1 == Vgrid_dxToken(sock, text, len, &pos, tok));
     VJMPERR1(!strcmp(tok, "gridpositions"));
     /* Get "counts" */
-    VJMPERR2(1 == Vio_scanf(sock, "%s", tok));
+    VJMPERR2(1 == Vgrid_dxToken(sock, text, len, &pos, tok));
     VJMPERR1(!strcmp(tok, "counts"));
     /* Get nx */
-    VJMPERR2(1 == Vio_scanf(sock, "%s", tok));
+    VJMPERR2(1 == Vgrid_dxToken(sock, text, len, &pos, tok));
     VJMPERR1(1 == sscanf(tok, "%d", &(thee->nx)));
     /* Get ny */
-    VJMPERR2(1 == Vio_scanf(sock, "%s", tok));
+    VJMPERR2(1 == Vgrid_dxToken(sock, text, len, &pos, tok));
     VJMPERR1(1 == sscanf(tok, "%d", &(thee->ny)));
     /* Get nz */
-    VJMPERR2(1 == Vio_scanf(sock, "%s", tok));
+    VJMPERR2(1 == Vgrid_dxToken(sock, text, len, &pos, tok));
     VJMPERR1(1 == sscanf(tok, "%d", &(thee->nz)));
     Vnm_print(0, "Vgrid_readDX:  Grid dimensions %d x %d x %d grid\n",
      thee->nx, thee->ny, thee->nz);
     /* Get "origin" */
-    VJMPERR2(1 == Vio_scanf(sock, "%s", tok));
+    VJMPERR2(1 == Vgrid_dxToken(sock, text, len, &pos, tok));
     VJMPERR1(!strcmp(tok, "origin"));
     /* Get xmin */
-    VJMPERR2(1 == Vio_scanf(sock, "%s", tok));
+    VJMPERR2(1 == Vgrid_dxToken(sock, text, len, &pos, tok));
     VJMPERR1(1 == sscanf(tok, "%lf", &(thee->xmin)));
     /* Get ymin */
-    VJMPERR2(1 == Vio_scanf(sock, "%s", tok));
+    VJMPERR2(1 == Vgrid_dxToken(sock, text, len, &pos, tok));
     VJMPERR1(1 == sscanf(tok, "%lf", &(thee->ymin)));
     /* Get zmin */
-    VJMPERR2(1 == Vio_scanf(sock, "%s", tok));
+    VJMPERR2(1 == Vgrid_dxToken(sock, text, len, &pos, tok));
     VJMPERR1(1 == sscanf(tok, "%lf", &(thee->zmin)));
     Vnm_print(0, "Vgrid_readDX:  Grid origin = (%g, %g, %g)\n",
       thee->xmin, thee->ymin, thee->zmin);
     /* Get "delta" */
-    VJMPERR2(1 == Vio_scanf(sock, "%s", tok));
+    VJMPERR2(1 == Vgrid_dxToken(sock, text, len, &pos, tok));
     VJMPERR1(!strcmp(tok, "delta"));
     /* Get hx */
-    VJMPERR2(1 == Vio_scanf(sock, "%s", tok));
+    VJMPERR2(1 == Vgrid_dxToken(sock, text, len, &pos, tok));
     VJMPERR1(1 == sscanf(tok, "%lf", &(thee->hx)));
     /* Get 0.0 */
-    VJMPERR2(1 == Vio_scanf(sock, "%s", tok));
+    VJMPERR2(1 == Vgrid_dxToken(sock, text, len, &pos, tok));
     VJMPERR1(1 == sscanf(tok, "%lf", &dtmp));
     VJMPERR1(dtmp == 0.0);
     /* Get 0.0 */
-    VJMPERR2(1 == Vio_scanf(sock, "%s", tok));
+    VJMPERR2(1 == Vgrid_dxToken(sock, text, len, &pos, tok));
     VJMPERR1(1 == sscanf(tok, "%lf", &dtmp));
     VJMPERR1(dtmp == 0.0);
     /* Get "delta" */
-    VJMPERR2(1 == Vio_scanf(sock, "%s", tok));
+    VJMPERR2(1 == Vgrid_dxToken(sock, text, len, &pos, tok));
     VJMPERR1(!strcmp(tok, "delta"));
     /* Get 0.0 */
-    VJMPERR2(1 == Vio_scanf(sock, "%s", tok));
+    VJMPERR2(1 == Vgrid_dxToken(sock, text, len, &pos, tok));
     VJMPERR1(1 == sscanf(tok, "%lf", &dtmp));
     VJMPERR1(dtmp == 0.0);
     /* Get hy */
-    VJMPERR2(1 == Vio_scanf(sock, "%s", tok));
+    VJMPERR2(1 == Vgrid_dxToken(sock, text, len, &pos, tok));
     VJMPERR1(1 == sscanf(tok, "%lf", &(thee->hy)));
     /* Get 0.0 */
-    VJMPERR2(1 == Vio_scanf(sock, "%s", tok));
+    VJMPERR2(1 == Vgrid_dxToken(sock, text, len, &pos, tok));
     VJMPERR1(1 == sscanf(tok, "%lf", &dtmp));
     VJMPERR1(dtmp == 0.0);
     /* Get "delta" */
-    VJMPERR2(1 == Vio_scanf(sock, "%s", tok));
+    VJMPERR2(1 == Vgrid_dxToken(sock, text, len, &pos, tok));
     VJMPERR1(!strcmp(tok, "delta"));
     /* Get 0.0 */
-    VJMPERR2(1 == Vio_scanf(sock, "%s", tok));
+    VJMPERR2(1 == Vgrid_dxToken(sock, text, len, &pos, tok));
     VJMPERR1(1 == sscanf(tok, "%lf", &dtmp));
     VJMPERR1(dtmp == 0.0);
     /* Get 0.0 */
-    VJMPERR2(1 == Vio_scanf(sock, "%s", tok));
+    VJMPERR2(1 == Vgrid_dxToken(sock, text, len, &pos, tok));
     VJMPERR1(1 == sscanf(tok, "%lf", &dtmp));
     VJMPERR1(dtmp == 0.0);
     /* Get hz */
-    VJMPERR2(1 == Vio_scanf(sock, "%s", tok));
+    VJMPERR2(1 == Vgrid_dxToken(sock, text, len, &pos, tok));
     VJMPERR1(1 == sscanf(tok, "%lf", &(thee->hzed)));
     Vnm_print(0, "Vgrid_readDX:  Grid spacings = (%g, %g, %g)\n",
       thee->hx, thee->hy, thee->hzed);
     /* Get "object" */
-    VJMPERR2(1 == Vio_scanf(sock, "%s", tok));
+    VJMPERR2(1 == Vgrid_dxToken(sock, text, len, &pos, tok));
     VJMPERR1(!strcmp(tok, "object"));
     /* Get "2" */
-    VJMPERR2(1 == Vio_scanf(sock, "%s", tok));
+    VJMPERR2(1 == Vgrid_dxToken(sock, text, len, &pos, tok));
     /* Get "class" */
-    VJMPERR2(1 == Vio_scanf(sock, "%s", tok));
+    VJMPERR2(1 == Vgrid_dxToken(sock, text, len, &pos, tok));
     VJMPERR1(!strcmp(tok, "class"));
     /* Get "gridconnections" */
-    VJMPERR2(1 == Vio_scanf(sock, "%s", tok));
+    VJMPERR2(1 == Vgrid_dxToken(sock, text, len, &pos, tok));
     VJMPERR1(!strcmp(tok, "gridconnections"));
     /* Get "counts" */
-    VJMPERR2(1 == Vio_scanf(sock, "%s", tok));
+    VJMPERR2(1 == Vgrid_dxToken(sock, text, len, &pos, tok));
     VJMPERR1(!strcmp(tok, "counts"));
     /* Get the dimensions again */
-    VJMPERR2(1 == Vio_scanf(sock, "%s", tok));
-    VJMPERR2(1 == Vio_scanf(sock, "%s", tok));
-    VJMPERR2(1 == Vio_scanf(sock, "%s", tok));
+    VJMPERR2(1 == Vgrid_dxToken(sock, text, len, &pos, tok));
+    VJMPERR2(1 == Vgrid_dxToken(sock, text, len, &pos, tok));
+    VJMPERR2(1 == Vgrid_dxToken(sock, text, len, &pos, tok));
     /* Get "object" */
-    VJMPERR2(1 == Vio_scanf(sock, "%s", tok));
+    VJMPERR2(1 == Vgrid_dxToken(sock, text, len, &pos, tok));
     VJMPERR1(!strcmp(tok, "object"));
     /* Get # */
-    VJMPERR2(1 == Vio_scanf(sock, "%s", tok));
+    VJMPERR2(1 == Vgrid_dxToken(sock, text, len, &pos, tok));
     /* Get "class" */
-    VJMPERR2(1 == Vio_scanf(sock, "%s", tok));
+    VJMPERR2(1 == Vgrid_dxToken(sock, text, len, &pos, tok));
     VJMPERR1(!strcmp(tok, "class"));
     /* Get "array" */
-    VJMPERR2(1 == Vio_scanf(sock, "%s", tok));
+    VJMPERR2(1 == Vgrid_dxToken(sock, text, len, &pos, tok));
     VJMPERR1(!strcmp(tok, "array"));
     /* Get "type" */
-    VJMPERR2(1 == Vio_scanf(sock, "%s", tok));
+    VJMPERR2(1 == Vgrid_dxToken(sock, text, len, &pos, tok));
     VJMPERR1(!strcmp(tok, "type"));
     /* Get "double" */
-    VJMPERR2(1 == Vio_scanf(sock, "%s", tok));
+    VJMPERR2(1 == Vgrid_dxToken(sock, text, len, &pos, tok));
     VJMPERR1(!strcmp(tok, "double"));
     /* Get "rank" */
-    VJMPERR2(1 == Vio_scanf(sock, "%s", tok));
+    VJMPERR2(1 == Vgrid_dxToken(sock, text, len, &pos, tok));
     VJMPERR1(!strcmp(tok, "rank"));
     /* Get # */
-    VJMPERR2(1 == Vio_scanf(sock, "%s", tok));
+    VJMPERR2(1 == Vgrid_dxToken(sock, text, len, &pos, tok));
     /* Get "items" */
-    VJMPERR2(1 == Vio_scanf(sock, "%s", tok));
+    VJMPERR2(1 == Vgrid_dxToken(sock, text, len, &pos, tok));
     VJMPERR1(!strcmp(tok, "items"));
     /* Get # */
-    VJMPERR2(1 == Vio_scanf(sock, "%s", tok));
+    VJMPERR2(1 == Vgrid_dxToken(sock, text, len, &pos, tok));
     VJMPERR1(1 == sscanf(tok, "%lu", &itmp));
     u = (size_t)thee->nx * thee->ny * thee->nz;
     VJMPERR1(u == itmp);
     /* Get "data" */
-    VJMPERR2(1 == Vio_scanf(sock, "%s", tok));
+    VJMPERR2(1 == Vgrid_dxToken(sock, text, len, &pos, tok));
     VJMPERR1(!strcmp(tok, "data"));
     /* Get "follows" */
-    VJMPERR2(1 == Vio_scanf(sock, "%s", tok));
+    VJMPERR2(1 == Vgrid_dxToken(sock, text, len, &pos, tok));
     VJMPERR1(!strcmp(tok, "follows"));
 
     /* Allocate space for the data */
@@ -768,13 +1025,19 @@ VPUBLIC int Vgrid_readDX(Vgrid *thee,
         return 0;
     }
 
-    for (i=0; i<thee->nx; i++) {
-        for (j=0; j<thee->ny; j++) {
-            for (k=0; k<thee->nz; k++) {
-                u = k*(thee->nx)*(thee->ny)+j*(thee->nx)+i;
-                VJMPERR2(1 == Vio_scanf(sock, "%s", tok));
-                VJMPERR1(1 == sscanf(tok, "%lf", &dtmp));
-                (thee->data)[u] = dtmp;
+    if (sock == VNULL) {
+        rc = Vgrid_parseDXData(thee, text + pos, len - pos);
+        VJMPERR2(rc >= 0);
+        VJMPERR1(rc == 1);
+    } else {
+        for (i=0; i<thee->nx; i++) {
+            for (j=0; j<thee->ny; j++) {
+                for (k=0; k<thee->nz; k++) {
+                    u = k*(thee->nx)*(thee->ny)+j*(thee->nx)+i;
+                    VJMPERR2(1 == Vio_scanf(sock, "%s", tok));
+                    VJMPERR1(1 == sscanf(tok, "%lf", &dtmp));
+                    (thee->data)[u] = dtmp;
+                }
             }
         }
     }
@@ -785,19 +1048,23 @@ VPUBLIC int Vgrid_readDX(Vgrid *thee,
     thee->zmax = thee->zmin + (thee->nz-1)*thee->hzed;
 
     /* Close off the socket */
-    Vio_acceptFree(sock);
-    Vio_dtor(&sock);
+    if (sock != VNULL) {
+        Vio_acceptFree(sock);
+        Vio_dtor(&sock);
+    } else Vmem_free(thee->mem, len+1, sizeof(char), (void **)&text);
 
     return 1;
 
   VERROR1:
-    Vio_dtor(&sock);
+    if (sock != VNULL) Vio_dtor(&sock);
+    else Vmem_free(thee->mem, len+1, sizeof(char), (void **)&text);
     Vnm_print(2, "Vgrid_readDX:  Format problem with input file <%s>\n",
       fname);
     return 0;
 
   VERROR2:
-    Vio_dtor(&sock);
+    if (sock != VNULL) Vio_dtor(&sock);
+    else Vmem_free(thee->mem, len+1, sizeof(char), (void **)&text);
     Vnm_print(2, "Vgrid_readDX:  I/O problem with input file <%s>\n",
       fname);
     return 0;
@@ -1208,10 +1475,11 @@ VPUBLIC void Vgrid_writeDX(Vgrid *thee, const char *iodev, const char *iofmt,
 
     double xmin, ymin, zmin, hx, hy, hzed;
     int nx, ny, nz, nxPART, nyPART, nzPART;
-    int usepart, gotit;
+    int usepart, gotit, ioerr;
     size_t icol, i, j, k, u;
     double x, y, z, xminPART, yminPART, zminPART;
     Vio *sock;
+    FILE *fp;
     char precFormat[VMAX_BUFSIZE];
 
     if (thee == VNULL) {
@@ -1236,22 +1504,36 @@ VPUBLIC void Vgrid_writeDX(Vgrid *thee, const char *iodev, const char *iofmt,
     if (pvec == VNULL) usepart = 0;
     else usepart = 1;
 
-    /* Set up the virtual socket */
-    Vnm_print(0, "Vgrid_writeDX:  Opening virtual socket...\n");
-    sock = Vio_ctor(iodev,iofmt,thost,fname,"w");
-    if (sock == VNULL) {
-        Vnm_print(2, "Vgrid_writeDX:  Problem opening virtual socket %s\n",
-          fname);
-        return;
-    }
-    if (Vio_connect(sock, 0) < 0) {
-        Vnm_print(2, "Vgrid_writeDX: Problem connecting virtual socket %s\n",
-          fname);
-        return;
-    }
+    sock = VNULL;
+    fp = VNULL;
+    if ((Vstring_strcasecmp(iodev, "FILE") == 0) &&
+        (Vstring_strcasecmp(iofmt, "ASC") == 0)) {
+        /* Plain files are written directly, with the data formatted in
+         * buffers */
+        Vnm_print(0, "Vgrid_writeDX:  Opening file...\n");
+        fp = fopen(fname, "w");
+        if (fp == VNULL) {
+            Vnm_print(2, "Vgrid_writeDX:  Problem opening file %s\n", fname);
+            return;
+        }
+    } else {
+        /* Set up the virtual socket */
+        Vnm_print(0, "Vgrid_writeDX:  Opening virtual socket...\n");
+        sock = Vio_ctor(iodev,iofmt,thost,fname,"w");
+        if (sock == VNULL) {
+            Vnm_print(2, "Vgrid_writeDX:  Problem opening virtual socket %s\n",
+              fname);
+            return;
+        }
+        if (Vio_connect(sock, 0) < 0) {
+            Vnm_print(2, "Vgrid_writeDX: Problem connecting virtual socket %s\n",
+              fname);
+            return;
+        }
 
-    Vio_setWhiteChars(sock, MCwhiteChars);
-    Vio_setCommChars(sock, MCcommChars);
+        Vio_setWhiteChars(sock, MCwhiteChars);
+        Vio_setCommChars(sock, MCcommChars);
+    }
 
     Vnm_print(0, "Vgrid_writeDX:  Writing to virtual socket...\n");
 
@@ -1333,58 +1615,61 @@ VPUBLIC void Vgrid_writeDX(Vgrid *thee, const char *iodev, const char *iofmt,
         } else {
             Vnm_print(0, "Vgrid_writeDX:  Writing comments for %s format.\n",
               iofmt);
-            Vio_printf(sock, "# Data from %s\n", PACKAGE_STRING);
-            Vio_printf(sock, "# \n");
-            Vio_printf(sock, "# %s\n", title);
-            Vio_printf(sock, "# \n");
+            Vgrid_dxPrintf(sock, fp, "# Data from %s\n", PACKAGE_STRING);
+            Vgrid_dxPrintf(sock, fp, "# \n");
+            Vgrid_dxPrintf(sock, fp, "# %s\n", title);
+            Vgrid_dxPrintf(sock, fp, "# \n");
         }
 
         /* Write off the DX regular positions */
-        Vio_printf(sock, "object 1 class gridpositions counts %d %d %d\n",
+        Vgrid_dxPrintf(sock, fp, "object 1 class gridpositions counts %d %d %d\n",
           nxPART, nyPART, nzPART);
 
         sprintf(precFormat, Vprecision, xminPART, yminPART, zminPART);
-        Vio_printf(sock, "origin %s\n", precFormat);
+        Vgrid_dxPrintf(sock, fp, "origin %s\n", precFormat);
         sprintf(precFormat, Vprecision, hx, 0.0, 0.0);
-        Vio_printf(sock, "delta %s\n", precFormat);
+        Vgrid_dxPrintf(sock, fp, "delta %s\n", precFormat);
         sprintf(precFormat, Vprecision, 0.0, hy, 0.0);
-        Vio_printf(sock, "delta %s\n", precFormat);
+        Vgrid_dxPrintf(sock, fp, "delta %s\n", precFormat);
         sprintf(precFormat, Vprecision, 0.0, 0.0, hzed);
-        Vio_printf(sock, "delta %s\n", precFormat);
+        Vgrid_dxPrintf(sock, fp, "delta %s\n", precFormat);
 
         /* Write off the DX regular connections */
-        Vio_printf(sock, "object 2 class gridconnections counts %d %d %d\n",
+        Vgrid_dxPrintf(sock, fp, "object 2 class gridconnections counts %d %d %d\n",
           nxPART, nyPART, nzPART);
 
         /* Write off the DX data */
-        Vio_printf(sock, "object 3 class array type double rank 0 items %lu \
+        Vgrid_dxPrintf(sock, fp, "object 3 class array type double rank 0 items %lu \
 data follows\n", (nxPART*nyPART*nzPART));
-        icol = 0;
-        for (i=0; i<nx; i++) {
-            for (j=0; j<ny; j++) {
-                for (k=0; k<nz; k++) {
-                    u = k*(nx)*(ny)+j*(nx)+i;
-                    if (pvec[u] > 0.0) {
-                        Vio_printf(sock, "%12.6e ", thee->data[u]);
-                        icol++;
-                        if (icol == 3) {
-                            icol = 0;
-                            Vio_printf(sock, "\n");
+        if (sock == VNULL) Vgrid_writeDXData(thee, fp, pvec);
+        else {
+            icol = 0;
+            for (i=0; i<nx; i++) {
+                for (j=0; j<ny; j++) {
+                    for (k=0; k<nz; k++) {
+                        u = k*(nx)*(ny)+j*(nx)+i;
+                        if (pvec[u] > 0.0) {
+                            Vio_printf(sock, "%12.6e ", thee->data[u]);
+                            icol++;
+                            if (icol == 3) {
+                                icol = 0;
+                                Vio_printf(sock, "\n");
+                            }
                         }
                     }
                 }
             }
-        }
 
-        if (icol != 0) Vio_printf(sock, "\n");
+            if (icol != 0) Vio_printf(sock, "\n");
+        }
 
         /* Create the field */
-        Vio_printf(sock, "attribute \"dep\" string \"positions\"\n");
-        Vio_printf(sock, "object \"regular positions regular connections\" \
+        Vgrid_dxPrintf(sock, fp, "attribute \"dep\" string \"positions\"\n");
+        Vgrid_dxPrintf(sock, fp, "object \"regular positions regular connections\" \
 class field\n");
-        Vio_printf(sock, "component \"positions\" value 1\n");
-        Vio_printf(sock, "component \"connections\" value 2\n");
-        Vio_printf(sock, "component \"data\" value 3\n");
+        Vgrid_dxPrintf(sock, fp, "component \"positions\" value 1\n");
+        Vgrid_dxPrintf(sock, fp, "component \"connections\" value 2\n");
+        Vgrid_dxPrintf(sock, fp, "component \"data\" value 3\n");
 
     } else {
         /* Write off the title (if we're not XDR) */
@@ -1393,61 +1678,72 @@ class field\n");
         } else {
             Vnm_print(0, "Vgrid_writeDX:  Writing comments for %s format.\n",
               iofmt);
-            Vio_printf(sock, "# Data from %s\n", PACKAGE_STRING);
-            Vio_printf(sock, "# \n");
-            Vio_printf(sock, "# %s\n", title);
-            Vio_printf(sock, "# \n");
+            Vgrid_dxPrintf(sock, fp, "# Data from %s\n", PACKAGE_STRING);
+            Vgrid_dxPrintf(sock, fp, "# \n");
+            Vgrid_dxPrintf(sock, fp, "# %s\n", title);
+            Vgrid_dxPrintf(sock, fp, "# \n");
         }
 
 
         /* Write off the DX regular positions */
-        Vio_printf(sock, "object 1 class gridpositions counts %d %d %d\n",
+        Vgrid_dxPrintf(sock, fp, "object 1 class gridpositions counts %d %d %d\n",
           nx, ny, nz);
 
         sprintf(precFormat, Vprecision, xmin, ymin, zmin);
-        Vio_printf(sock, "origin %s\n", precFormat);
+        Vgrid_dxPrintf(sock, fp, "origin %s\n", precFormat);
         sprintf(precFormat, Vprecision, hx, 0.0, 0.0);
-        Vio_printf(sock, "delta %s\n", precFormat);
+        Vgrid_dxPrintf(sock, fp, "delta %s\n", precFormat);
         sprintf(precFormat, Vprecision, 0.0, hy, 0.0);
-        Vio_printf(sock, "delta %s\n", precFormat);
+        Vgrid_dxPrintf(sock, fp, "delta %s\n", precFormat);
         sprintf(precFormat, Vprecision, 0.0, 0.0, hzed);
-        Vio_printf(sock, "delta %s\n", precFormat);
+        Vgrid_dxPrintf(sock, fp, "delta %s\n", precFormat);
 
         /* Write off the DX regular connections */
-        Vio_printf(sock, "object 2 class gridconnections counts %d %d %d\n",
+        Vgrid_dxPrintf(sock, fp, "object 2 class gridconnections counts %d %d %d\n",
           nx, ny, nz);
 
         /* Write off the DX data */
-        Vio_printf(sock, "object 3 class array type double rank 0 items %lu \
+        Vgrid_dxPrintf(sock, fp, "object 3 class array type double rank 0 items %lu \
 data follows\n", (nx*ny*nz));
-        icol = 0;
-        for (i=0; i<nx; i++) {
-            for (j=0; j<ny; j++) {
-                for (k=0; k<nz; k++) {
-                    u = k*(nx)*(ny)+j*(nx)+i;
-                    Vio_printf(sock, "%12.6e ", thee->data[u]);
-                    icol++;
-                    if (icol == 3) {
-                        icol = 0;
-                        Vio_printf(sock, "\n");
+        if (sock == VNULL) Vgrid_writeDXData(thee, fp, VNULL);
+        else {
+            icol = 0;
+            for (i=0; i<nx; i++) {
+                for (j=0; j<ny; j++) {
+                    for (k=0; k<nz; k++) {
+                        u = k*(nx)*(ny)+j*(nx)+i;
+                        Vio_printf(sock, "%12.6e ", thee->data[u]);
+                        icol++;
+                        if (icol == 3) {
+                            icol = 0;
+                            Vio_printf(sock, "\n");
+                        }
                     }
                 }
             }
+            if (icol != 0) Vio_printf(sock, "\n");
         }
-        if (icol != 0) Vio_printf(sock, "\n");
 
         /* Create the field */
-        Vio_printf(sock, "attribute \"dep\" string \"positions\"\n");
-        Vio_printf(sock, "object \"regular positions regular connections\" \
+        Vgrid_dxPrintf(sock, fp, "attribute \"dep\" string \"positions\"\n");
+        Vgrid_dxPrintf(sock, fp, "object \"regular positions regular connections\" \
 class field\n");
-        Vio_printf(sock, "component \"positions\" value 1\n");
-        Vio_printf(sock, "component \"connections\" value 2\n");
-        Vio_printf(sock, "component \"data\" value 3\n");
+        Vgrid_dxPrintf(sock, fp, "component \"positions\" value 1\n");
+        Vgrid_dxPrintf(sock, fp, "component \"connections\" value 2\n");
+        Vgrid_dxPrintf(sock, fp, "component \"data\" value 3\n");
     }
 
     /* Close off the socket */
-    Vio_connectFree(sock);
-    Vio_dtor(&sock);
+    if (sock == VNULL) {
+        ioerr = ferror(fp);
+        if ((fclose(fp) != 0) || ioerr) {
+            Vnm_print(2, "Vgrid_writeDX:  Problem writing file %s\n", fname);
+        }
+    }
+    else {
+        Vio_connectFree(sock);
+        Vio_dtor(&sock);
+    }
 }
 
 /* ///////////////////////////////////////////////////////////////////////////
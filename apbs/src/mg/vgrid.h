@@ -73,6 +73,15 @@
  *  @ingroup Vgrid */
 #define VGRID_DIGITS 6
 
+/** @brief Bytes of OpenDX text handled per task by the buffered reader and
+ *         writer
+ *  @ingroup Vgrid */
+#define VGRID_CHUNK 1048576
+
+/** @brief Widest value printed to OpenDX files by the "%12.6e " format
+ *  @ingroup Vgrid */
+#define VGRID_DXWIDTH 16
+
 /**
  *  @ingroup Vgrid
  *  @author  Nathan Baker
@@ -0,0 +1,955 @@
+/**
+ *  @file    vmgdist.c
+ *  @brief   Class Vmgdist methods
+ *  @ingroup Vmgdist
+ *  @version $Id$
+ *  @attention
+ *  @verbatim
+ *
+ * APBS -- Adaptive Poisson-Boltzmann Solver
+ *
+ * Nathan A. Baker (nathan.baker@pnl.gov)
+ * Pacific Northwest National Laboratory
+ *
+ * Additional contributing authors listed in the code documentation.
+ *
+ * Copyright (c) 2010, Pacific Northwest National Laboratory.  Portions Copyright (c) 2002-2010, Washington University in St. Louis.  Portions Copyright (c) 2002-2010, Nathan A. Baker.  Portions Copyright (c) 1999-2002, The Regents of the University of California. Portions Copyright (c) 1995, Michael Holst.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * -  Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * - Neither the name of Washington University in St. Louis nor the names of its
+ * contributors may be used to endorse or promote products derived from this
+ * software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @endverbatim
+ */
+
+#include "vmgdist.h"
+
+VEMBED(rcsid="$Id$")
+
+/* Copy the planes [lo, hi] of src, which starts at plane srcLo, to dst,
+ * which starts at plane dstLo */
+VPRIVATE void copyPlanes(int nxy, int lo, int hi,
+        double *src, int srcLo, double *dst, int dstLo) {
+
+    if ((lo > hi) || ((src == dst) && (srcLo == dstLo))) return;
+    memcpy(dst + (lo - dstLo)*nxy, src + (lo - srcLo)*nxy,
+           (size_t)(hi - lo + 1)*nxy*sizeof(double));
+}
+
+/* ///////////////////////////////////////////////////////////////////////////
+// Routine:  Vmgdist_exchange
+//
+// Purpose:  Every processor p asks for the planes [reqLo[p], reqHi[p]] of a
+//           grid function whose plane k lives on the processor that owns it
+//           in the partition own (processor p owns [own[p], own[p+1])).
+//           The owner sends them from src, which starts at plane srcLo, and
+//           the requester stores them in dst, which starts at plane dstLo.
+//           The halo exchange of the smoother, the redistribution of the
+//           restricted residual and the fetch of the coarse correction are
+//           all instances of this.
+//
+// Notes:    Processors are paired as (p, p+d) with (p/d)%2 == phase.  The
+//           pairs of one (d, phase) round are disjoint, so they all talk at
+//           once, and every pair meets in exactly one round.  The lower
+//           processor of a pair sends first.  Pairs with nothing to
+//           exchange are skipped by both sides, so a halo exchange only
+//           costs the rounds in which neighbours meet.
+/////////////////////////////////////////////////////////////////////////// */
+VPRIVATE void Vmgdist_exchange(Vmgdist *thee, int nxy, int *own,
+        double *src, int srcLo, double *dst, int dstLo,
+        int *reqLo, int *reqHi) {
+
+    int me, p, d, phase, step, lo, hi;
+
+    me = thee->rank;
+
+    /* Planes this processor owns itself */
+    copyPlanes(nxy, VMAX2(own[me], reqLo[me]), VMIN2(own[me+1]-1, reqHi[me]),
+               src, srcLo, dst, dstLo);
+
+    for (d=1; d<thee->size; d++) {
+        for (phase=0; phase<2; phase++) {
+            if (((me/d) % 2) == phase) p = me + d;
+            else p = me - d;
+            if ((p < 0) || (p >= thee->size)) continue;
+            for (step=0; step<2; step++) {
+                if ((step == 0) == (me < p)) {
+                    /* Send the planes we own that p asked for */
+                    lo = VMAX2(own[me], reqLo[p]);
+                    hi = VMIN2(own[me+1]-1, reqHi[p]);
+                    if (lo <= hi) {
+                        Vcom_send(thee->com, p, src + (lo - srcLo)*nxy,
+                                  (hi - lo + 1)*nxy, 2, 1);
+                    }
+                } else {
+                    /* Receive the planes p owns that we asked for */
+                    lo = VMAX2(own[p], reqLo[me]);
+                    hi = VMIN2(own[p+1]-1, reqHi[me]);
+                    if (lo <= hi) {
+                        Vcom_recv(thee->com, p, dst + (lo - dstLo)*nxy,
+                                  (hi - lo + 1)*nxy, 2, 1);
+                    }
+                }
+            }
+        }
+    }
+}
+
+/* Refresh the ghost planes of a grid function on a level */
+VPRIVATE void Vmgdist_halo(Vmgdist *thee, VmgdistLevel *lev, double *x) {
+
+    int lo;
+
+    lo = lev->lo[thee->rank];
+    Vmgdist_exchange(thee, lev->nx*lev->ny, lev->own, x, lo, x, lo,
+                     lev->lo, lev->hi);
+}
+
+/* Sum of x*y (or of |x| if y is VNULL) over the interior points of the
+ * planes this processor owns; callers reduce it across processors */
+VPRIVATE double Vmgdist_sum(Vmgdist *thee, VmgdistLevel *lev,
+        double *x, double *y) {
+
+    int i, j, k, kl, nx, ny, me;
+    double sum;
+
+    me = thee->rank;
+    if (lev->nzl == 0) return 0.0;
+    nx = lev->nx;
+    ny = lev->ny;
+
+    sum = 0.0;
+    for (k=VMAX2(lev->own[me], 1); k<VMIN2(lev->own[me+1], lev->nz-1); k++) {
+        kl = k - lev->lo[me];
+        for (j=1; j<ny-1; j++) {
+            for (i=1; i<nx-1; i++) {
+                if (y == VNULL) sum += VABS(x[IJK(i,j,kl)]);
+                else sum += x[IJK(i,j,kl)]*y[IJK(i,j,kl)];
+            }
+        }
+    }
+
+    return sum;
+}
+
+/* Compute the planes each processor stores on a level: the planes it owns
+ * plus at least two ghost planes on either side, which is what one red and
+ * one black sweep read.  The range is widened to even planes so that the
+ * red/black coloring and the coarse mesh of a slab line up with those of
+ * the undivided mesh. */
+VPRIVATE void Vmgdist_stored(int size, int nz, int *own, int *lo, int *hi) {
+
+    int p;
+
+    for (p=0; p<size; p++) {
+        if (own[p] >= own[p+1]) {
+            lo[p] = 0;
+            hi[p] = -1;
+            continue;
+        }
+        lo[p] = VMAX2(0, own[p] - 2);
+        lo[p] -= lo[p] % 2;
+        hi[p] = own[p+1] + 1;
+        hi[p] += hi[p] % 2;
+        hi[p] = VMIN2(nz - 1, hi[p]);
+    }
+}
+
+/* Set up the partitions of all levels from the partition of the finest */
+VPRIVATE void Vmgdist_layout(Vmgdist *thee) {
+
+    int l, p, size, nzc, nmin, nact, np;
+    VmgdistLevel *lev, *next;
+
+    size = thee->size;
+
+    for (l=0; l<thee->nlev; l++) {
+        lev = &(thee->level[l]);
+        Vmgdist_stored(size, lev->nz, lev->own, lev->lo, lev->hi);
+        lev->nzl = lev->hi[thee->rank] - lev->lo[thee->rank] + 1;
+        if (l == thee->nlev-1) break;
+
+        /* Each processor restricts to and interpolates from the coarse
+         * planes under its own */
+        next = &(thee->level[l+1]);
+        nzc = next->nz;
+        for (p=0; p<=size; p++) lev->town[p] = (lev->own[p] + 1)/2;
+        for (p=0; p<size; p++) {
+            if (lev->lo[p] <= lev->hi[p]) {
+                lev->tlo[p] = lev->lo[p]/2;
+                lev->thi[p] = lev->hi[p]/2;
+            } else {
+                lev->tlo[p] = 0;
+                lev->thi[p] = -1;
+            }
+        }
+        lev->nzt = lev->thi[thee->rank] - lev->tlo[thee->rank] + 1;
+
+        /* The coarse level keeps that partition unless a processor would
+         * be left with too few planes; it is then spread over fewer
+         * processors.  The coarsest level always lives on one. */
+        nmin = nzc;
+        nact = 0;
+        for (p=0; p<size; p++) {
+            if (lev->own[p] < lev->own[p+1]) {
+                nact++;
+                nmin = VMIN2(nmin, lev->town[p+1] - lev->town[p]);
+            }
+        }
+        if (l+1 == thee->nlev-1) {
+            np = 1;
+        } else if (nmin < VMGDIST_MINPLANES) {
+            np = VMIN2(nact, VMAX2(1, nzc/VMGDIST_MINPLANES));
+        } else {
+            np = 0;
+        }
+        for (p=0; p<=size; p++) {
+            if (np == 0) next->own[p] = lev->town[p];
+            else next->own[p] = (p < np) ? (p*nzc)/np : nzc;
+        }
+    }
+}
+
+/* Discretize the operator of a level on the planes this processor stores.
+ * VbuildA_fv treats the first and last stored planes as a Dirichlet
+ * boundary; where they are ghost planes the couplings across them are put
+ * back, so that the owned rows are those of the undivided mesh. */
+VPRIVATE void Vmgdist_buildOp(Vmgdist *thee, VmgdistLevel *lev,
+        double *gxcf, double *gycf, double *gzcf,
+        double *a1cf, double *a2cf, double *a3cf,
+        double *ccf, double *fcf) {
+
+    int i, j, k, n, nx, ny, nz, side, mgfree, numdia, ipkey;
+    double *uC, hx, hy, hz;
+
+    nx = lev->nx;
+    ny = lev->ny;
+    nz = lev->nzl;
+    n = nx*ny*nz;
+    uC = lev->ac + 3*n;
+    mgfree = 0;
+    ipkey = thee->pmg->pmgp->ipkey;
+
+    VbuildA_fv(&nx, &ny, &nz, &ipkey, &mgfree, &numdia,
+               lev->ipc, lev->rpc,
+               lev->ac, lev->cc, lev->fc, lev->ac + n, lev->ac + 2*n, uC,
+               lev->xf, lev->yf, lev->zf, gxcf, gycf, gzcf,
+               a1cf, a2cf, a3cf, ccf, fcf);
+
+    for (side=0; side<2; side++) {
+        if (side == 0) {
+            if (lev->lo[thee->rank] == 0) continue;
+            k = 0;
+        } else {
+            if (lev->hi[thee->rank] == lev->nz-1) continue;
+            k = nz - 2;
+        }
+        hz = lev->zf[k+1] - lev->zf[k];
+        for (j=1; j<ny-1; j++) {
+            hy = (lev->yf[j] - lev->yf[j-1]) + (lev->yf[j+1] - lev->yf[j]);
+            for (i=1; i<nx-1; i++) {
+                hx = (lev->xf[i] - lev->xf[i-1]) + (lev->xf[i+1] - lev->xf[i]);
+                uC[IJK(i,j,k)] = hx*hy/(4.0*hz)*a3cf[IJK(i,j,k)];
+            }
+        }
+    }
+}
+
+/* Harmonically average the coefficients of a level onto the coarse planes
+ * under this processor's owned planes (the 7-point analogue of the PMG
+ * harmonic coarsening), inject the Helmholtz term, and hand the results to
+ * the processors that store them on the next level */
+VPRIVATE void Vmgdist_coarsen(Vmgdist *thee, int l,
+        double *a1f, double *a2f, double *a3f, double *ccf,
+        double *a1c, double *a2c, double *a3c, double *ccc) {
+
+    int i, j, k, ii, jj, kk, im, ip, jm, jp, km, kp, me, nt, nxy;
+    int nxf, nyf, nzf, lof, nx, ny, lo;
+    double *t1, *t2, *t3, *tc, *src[4], *dst[4];
+    VmgdistLevel *lev, *next;
+
+    me = thee->rank;
+    lev = &(thee->level[l]);
+    next = &(thee->level[l+1]);
+    nxf = lev->nx;
+    nyf = lev->ny;
+    nzf = lev->nz;
+    lof = lev->lo[me];
+    nx = next->nx;
+    ny = next->ny;
+    nxy = nx*ny;
+    lo = lev->tlo[me];
+    nt = nxy*VMAX2(lev->nzt, 0);
+
+    t1 = t2 = t3 = tc = VNULL;
+    if (nt > 0) {
+        t1 = (double *)Vmem_malloc(thee->vmem, nt, sizeof(double));
+        t2 = (double *)Vmem_malloc(thee->vmem, nt, sizeof(double));
+        t3 = (double *)Vmem_malloc(thee->vmem, nt, sizeof(double));
+        tc = (double *)Vmem_malloc(thee->vmem, nt, sizeof(double));
+    }
+
+#define AF(a, i, j, k) ((a)[((k)-lof)*nxf*nyf + (j)*nxf + (i)])
+    for (k=lev->town[me]; k<lev->town[me+1]; k++) {
+        kk = 2*k;
+        km = VMAX2(0, kk-1);
+        kp = VMIN2(nzf-1, kk+1);
+        for (j=0; j<ny; j++) {
+            jj = 2*j;
+            jm = VMAX2(0, jj-1);
+            jp = VMIN2(nyf-1, jj+1);
+            for (i=0; i<nx; i++) {
+                ii = 2*i;
+                im = VMAX2(0, ii-1);
+                ip = VMIN2(nxf-1, ii+1);
+
+                tc[IJK(i,j,k-lo)] = AF(ccf, ii, jj, kk);
+
+                t1[IJK(i,j,k-lo)] =
+                    0.500*HARMO2(AF(a1f, ii, jj, kk), AF(a1f, ip, jj, kk))
+                  + 0.125*HARMO2(AF(a1f, ii, jj, km), AF(a1f, ip, jj, km))
+                  + 0.125*HARMO2(AF(a1f, ii, jj, kp), AF(a1f, ip, jj, kp))
+                  + 0.125*HARMO2(AF(a1f, ii, jm, kk), AF(a1f, ip, jm, kk))
+                  + 0.125*HARMO2(AF(a1f, ii, jp, kk), AF(a1f, ip, jp, kk));
+
+                t2[IJK(i,j,k-lo)] =
+                    0.500*HARMO2(AF(a2f, ii, jj, kk), AF(a2f, ii, jp, kk))
+                  + 0.125*HARMO2(AF(a2f, ii, jj, km), AF(a2f, ii, jp, km))
+                  + 0.125*HARMO2(AF(a2f, ii, jj, kp), AF(a2f, ii, jp, kp))
+                  + 0.125*HARMO2(AF(a2f, im, jj, kk), AF(a2f, im, jp, kk))
+                  + 0.125*HARMO2(AF(a2f, ip, jj, kk), AF(a2f, ip, jp, kk));
+
+                t3[IJK(i,j,k-lo)] =
+                    0.500*HARMO2(AF(a3f, ii, jj, kk), AF(a3f, ii, jj, kp))
+                  + 0.125*HARMO2(AF(a3f, ii, jm, kk), AF(a3f, ii, jm, kp))
+                  + 0.125*HARMO2(AF(a3f, ii, jp, kk), AF(a3f, ii, jp, kp))
+                  + 0.125*HARMO2(AF(a3f, im, jj, kk), AF(a3f, im, jj, kp))
+                  + 0.125*HARMO2(AF(a3f, ip, jj, kk), AF(a3f, ip, jj, kp));
+            }
+        }
+    }
+#undef AF
+
+    src[0] = t1; src[1] = t2; src[2] = t3; src[3] = tc;
+    dst[0] = a1c; dst[1] = a2c; dst[2] = a3c; dst[3] = ccc;
+    for (i=0; i<4; i++) {
+        Vmgdist_exchange(thee, nxy, lev->town, src[i], lo,
+                         dst[i], next->lo[me], next->lo, next->hi);
+    }
+
+    if (nt > 0) {
+        Vmem_free(thee->vmem, nt, sizeof(double), (void **)&t1);
+        Vmem_free(thee->vmem, nt, sizeof(double), (void **)&t2);
+        Vmem_free(thee->vmem, nt, sizeof(double), (void **)&t3);
+        Vmem_free(thee->vmem, nt, sizeof(double), (void **)&tc);
+    }
+}
+
+/* ///////////////////////////////////////////////////////////////////////////
+// Routine:  Vmgdist_ctor
+/////////////////////////////////////////////////////////////////////////// */
+VPUBLIC Vmgdist* Vmgdist_ctor(Vcom *com, Vpmg *pmg, MGparm *mgparm) {
+
+    Vmgdist *thee = VNULL;
+
+    thee = (Vmgdist *)Vmem_malloc(VNULL, 1, sizeof(Vmgdist));
+    VASSERT(thee != VNULL);
+    if (!Vmgdist_ctor2(thee, com, pmg, mgparm)) {
+        Vmgdist_dtor(&thee);
+        return VNULL;
+    }
+
+    return thee;
+}
+
+/* ///////////////////////////////////////////////////////////////////////////
+// Routine:  Vmgdist_ctor2
+/////////////////////////////////////////////////////////////////////////// */
+VPUBLIC int Vmgdist_ctor2(Vmgdist *thee, Vcom *com, Vpmg *pmg,
+        MGparm *mgparm) {
+
+    int i, j, k, l, p, n, nx, ny, nz, nxy, size, me, off;
+    int *ibuf, *obuf;
+    double zkappa2, z0, hz;
+    double *a1, *a2, *a3, *ccf, *gx, *gy, *gz, *fcf;
+    double *a1c, *a2c, *a3c, *ccc;
+    VmgdistLevel *lev, *next;
+    Vpmgp *pmgp;
+
+    VASSERT(thee != VNULL);
+    VASSERT(com != VNULL);
+    VASSERT(pmg != VNULL);
+    VASSERT(mgparm != VNULL);
+
+    thee->vmem = Vmem_ctor("APBS:VMGDIST");
+    thee->com = com;
+    thee->pmg = pmg;
+    thee->rank = Vcom_rank(com);
+    thee->size = Vcom_size(com);
+    thee->nlev = 0;
+    thee->level = VNULL;
+    thee->slo = VNULL;
+    thee->shi = VNULL;
+    thee->iters = 0;
+    thee->rsnrm = 0.0;
+    pmgp = pmg->pmgp;
+    me = thee->rank;
+    size = thee->size;
+
+    if (!mgparm->distrib) {
+        Vnm_print(2, "Vmgdist_ctor2:  Calculation was not set up as distributed!\n");
+        return 0;
+    }
+    if (mgparm->proc_size != size) {
+        Vnm_print(2, "Vmgdist_ctor2:  Calculation was set up for %d processors, \
+but %d are running!\n", mgparm->proc_size, size);
+        return 0;
+    }
+    if (!pmg->filled) {
+        Vnm_print(2, "Vmgdist_ctor2:  Need to call Vpmg_fillco()!\n");
+        return 0;
+    }
+
+    /* The hierarchy of the undivided mesh */
+    nx = pmgp->nx;
+    ny = pmgp->ny;
+    nz = mgparm->distDime;
+    i = 1 << (mgparm->nlev - 1);
+    if ((mgparm->nlev < 2) || ((nx-1) % i) || ((ny-1) % i) || ((nz-1) % i)) {
+        Vnm_print(2, "Vmgdist_ctor2:  A %d x %d x %d mesh does not coarsen \
+over %d levels!\n", nx, ny, nz, mgparm->nlev);
+        return 0;
+    }
+    thee->nlev = mgparm->nlev;
+    thee->nu1 = pmgp->nu1;
+    thee->nu2 = pmgp->nu2;
+    thee->itmax = pmgp->itmax;
+    thee->errtol = pmgp->errtol;
+
+    /* Gather the owned planes and the slab of every processor */
+    ibuf = (int *)Vmem_malloc(thee->vmem, 4*size, sizeof(int));
+    obuf = (int *)Vmem_malloc(thee->vmem, 4*size, sizeof(int));
+    for (i=0; i<4*size; i++) ibuf[i] = 0;
+    ibuf[4*me] = mgparm->distOwn[0];
+    ibuf[4*me+1] = mgparm->distOwn[1];
+    ibuf[4*me+2] = mgparm->distStart;
+    ibuf[4*me+3] = mgparm->distStart + pmgp->nz - 1;
+    Vcom_reduce(com, ibuf, obuf, 4*size, 1, 0);
+
+    thee->slo = (int *)Vmem_malloc(thee->vmem, size, sizeof(int));
+    thee->shi = (int *)Vmem_malloc(thee->vmem, size, sizeof(int));
+    thee->level = (VmgdistLevel *)Vmem_malloc(thee->vmem, thee->nlev,
+                                              sizeof(VmgdistLevel));
+    for (l=0; l<thee->nlev; l++) {
+        lev = &(thee->level[l]);
+        memset(lev, 0, sizeof(VmgdistLevel));
+        lev->nx = (nx - 1)/(1 << l) + 1;
+        lev->ny = (ny - 1)/(1 << l) + 1;
+        lev->nz = (nz - 1)/(1 << l) + 1;
+        lev->own = (int *)Vmem_malloc(thee->vmem, size+1, sizeof(int));
+        lev->lo = (int *)Vmem_malloc(thee->vmem, size, sizeof(int));
+        lev->hi = (int *)Vmem_malloc(thee->vmem, size, sizeof(int));
+        lev->town = (int *)Vmem_malloc(thee->vmem, size+1, sizeof(int));
+        lev->tlo = (int *)Vmem_malloc(thee->vmem, size, sizeof(int));
+        lev->thi = (int *)Vmem_malloc(thee->vmem, size, sizeof(int));
+    }
+    lev = &(thee->level[0]);
+    for (p=0; p<size; p++) {
+        lev->own[p] = obuf[4*p];
+        thee->slo[p] = obuf[4*p+2];
+        thee->shi[p] = obuf[4*p+3];
+    }
+    lev->own[size] = nz;
+    for (p=0; p<size; p++) {
+        if (obuf[4*p+1] != ((p < size-1) ? obuf[4*(p+1)] : nz)) {
+            Vnm_print(2, "Vmgdist_ctor2:  Processors do not own consecutive \
+planes!\n");
+            Vmem_free(thee->vmem, 4*size, sizeof(int), (void **)&ibuf);
+            Vmem_free(thee->vmem, 4*size, sizeof(int), (void **)&obuf);
+            return 0;
+        }
+    }
+    Vmem_free(thee->vmem, 4*size, sizeof(int), (void **)&ibuf);
+    Vmem_free(thee->vmem, 4*size, sizeof(int), (void **)&obuf);
+
+    Vmgdist_layout(thee);
+
+    /* Mesh coordinates and work arrays */
+    hz = pmgp->hzed;
+    z0 = pmg->zf[0] - hz*((double)mgparm->distStart);
+    for (l=0; l<thee->nlev; l++) {
+        lev = &(thee->level[l]);
+        if (lev->nzl <= 0) {
+            lev->nzl = 0;
+            continue;
+        }
+        n = lev->nx*lev->ny*lev->nzl;
+        lev->ac = (double *)Vmem_malloc(thee->vmem, 4*n, sizeof(double));
+        lev->cc = (double *)Vmem_malloc(thee->vmem, n, sizeof(double));
+        lev->fc = (double *)Vmem_malloc(thee->vmem, n, sizeof(double));
+        lev->x = (double *)Vmem_malloc(thee->vmem, n, sizeof(double));
+        lev->r = (double *)Vmem_malloc(thee->vmem, n, sizeof(double));
+        for (i=0; i<n; i++) {
+            lev->x[i] = 0.0;
+            lev->r[i] = 0.0;
+        }
+        if (l == thee->nlev-1) {
+            lev->w1 = (double *)Vmem_malloc(thee->vmem, n, sizeof(double));
+            lev->w2 = (double *)Vmem_malloc(thee->vmem, n, sizeof(double));
+        }
+        lev->xf = (double *)Vmem_malloc(thee->vmem, lev->nx, sizeof(double));
+        lev->yf = (double *)Vmem_malloc(thee->vmem, lev->ny, sizeof(double));
+        lev->zf = (double *)Vmem_malloc(thee->vmem, lev->nzl, sizeof(double));
+        for (i=0; i<lev->nx; i++) lev->xf[i] = pmg->xf[i << l];
+        for (j=0; j<lev->ny; j++) lev->yf[j] = pmg->yf[j << l];
+        for (k=0; k<lev->nzl; k++) {
+            lev->zf[k] = z0 + hz*((double)((lev->lo[me] + k) << l));
+        }
+        if ((l < thee->nlev-1) && (lev->nzt > 0)) {
+            next = &(thee->level[l+1]);
+            n = next->nx*next->ny*lev->nzt;
+            lev->t = (double *)Vmem_malloc(thee->vmem, n, sizeof(double));
+            lev->pc = (double *)Vmem_malloc(thee->vmem, 27*n, sizeof(double));
+            for (i=0; i<n; i++) lev->t[i] = 0.0;
+            i = 0;
+            VbuildP(&(lev->nx), &(lev->ny), &(lev->nzl),
+                    &(next->nx), &(next->ny), &(lev->nzt),
+                    &i, lev->ipc, lev->rpc, lev->pc, lev->ac,
+                    lev->xf, lev->yf, lev->zf);
+        } else {
+            lev->nzt = 0;
+        }
+    }
+
+    /* The finest operator comes from this processor's slab; the ghost
+     * planes and the atoms that reach them are inside it by construction
+     * (see NOsh_setupCalcMGDIST) */
+    lev = &(thee->level[0]);
+    nxy = nx*ny;
+    n = nxy*lev->nzl;
+    if ((lev->lo[me] < thee->slo[me]) || (lev->hi[me] > thee->shi[me])) {
+        Vnm_print(2, "Vmgdist_ctor2:  Planes %d-%d are not all in this \
+processor's slab (%d-%d)!\n", lev->lo[me], lev->hi[me], thee->slo[me],
+                  thee->shi[me]);
+        return 0;
+    }
+    off = nxy*(lev->lo[me] - thee->slo[me]);
+    a1 = pmg->epsx + off;
+    a2 = pmg->epsy + off;
+    a3 = pmg->epsz + off;
+    fcf = pmg->charge + off;
+    ccf = (double *)Vmem_malloc(thee->vmem, n, sizeof(double));
+    zkappa2 = Vpbe_getZkappa2(pmg->pbe);
+    for (i=0; i<n; i++) {
+        ccf[i] = (zkappa2 > VPMGSMALL) ? zkappa2*pmg->kappa[off+i] : 0.0;
+    }
+    gx = (double *)Vmem_malloc(thee->vmem, 2*ny*lev->nzl, sizeof(double));
+    gy = (double *)Vmem_malloc(thee->vmem, 2*nx*lev->nzl, sizeof(double));
+    gz = (double *)Vmem_malloc(thee->vmem, 2*nxy, sizeof(double));
+    for (p=0; p<2; p++) {
+        for (k=0; k<lev->nzl; k++) {
+            for (j=0; j<ny; j++) {
+                gx[(p*lev->nzl + k)*ny + j] = pmg->gxcf[(p*pmgp->nz
+                    + k + lev->lo[me] - thee->slo[me])*ny + j];
+            }
+            for (i=0; i<nx; i++) {
+                gy[(p*lev->nzl + k)*nx + i] = pmg->gycf[(p*pmgp->nz
+                    + k + lev->lo[me] - thee->slo[me])*nx + i];
+            }
+        }
+    }
+    for (i=0; i<2*nxy; i++) gz[i] = 0.0;
+    if (lev->lo[me] == 0) {
+        for (i=0; i<nxy; i++) gz[i] = pmg->gzcf[i];
+    }
+    if (lev->hi[me] == nz-1) {
+        for (i=0; i<nxy; i++) gz[nxy+i] = pmg->gzcf[nxy+i];
+    }
+    Vmgdist_buildOp(thee, lev, gx, gy, gz, a1, a2, a3, ccf, fcf);
+    Vmem_free(thee->vmem, 2*ny*lev->nzl, sizeof(double), (void **)&gx);
+    Vmem_free(thee->vmem, 2*nx*lev->nzl, sizeof(double), (void **)&gy);
+    Vmem_free(thee->vmem, 2*nxy, sizeof(double), (void **)&gz);
+
+    /* Coarser operators from averaged coefficients, with zero boundary
+     * values and source */
+    for (l=0; l<thee->nlev-1; l++) {
+        lev = &(thee->level[l]);
+        next = &(thee->level[l+1]);
+        nxy = next->nx*next->ny;
+        n = nxy*next->nzl;
+        a1c = a2c = a3c = ccc = VNULL;
+        if (n > 0) {
+            a1c = (double *)Vmem_malloc(thee->vmem, n, sizeof(double));
+            a2c = (double *)Vmem_malloc(thee->vmem, n, sizeof(double));
+            a3c = (double *)Vmem_malloc(thee->vmem, n, sizeof(double));
+            ccc = (double *)Vmem_malloc(thee->vmem, n, sizeof(double));
+        }
+        Vmgdist_coarsen(thee, l, a1, a2, a3, ccf, a1c, a2c, a3c, ccc);
+
+        /* Done with the finer coefficients */
+        i = lev->nx*lev->ny*lev->nzl;
+        if (l > 0 && i > 0) {
+            Vmem_free(thee->vmem, i, sizeof(double), (void **)&a1);
+            Vmem_free(thee->vmem, i, sizeof(double), (void **)&a2);
+            Vmem_free(thee->vmem, i, sizeof(double), (void **)&a3);
+        }
+        if (i > 0) Vmem_free(thee->vmem, i, sizeof(double), (void **)&ccf);
+        a1 = a1c;
+        a2 = a2c;
+        a3 = a3c;
+        ccf = ccc;
+
+        if (n > 0) {
+            gx = (double *)Vmem_malloc(thee->vmem, 2*next->ny*next->nzl,
+                                       sizeof(double));
+            gy = (double *)Vmem_malloc(thee->vmem, 2*next->nx*next->nzl,
+                                       sizeof(double));
+            gz = (double *)Vmem_malloc(thee->vmem, 2*nxy, sizeof(double));
+            fcf = (double *)Vmem_malloc(thee->vmem, n, sizeof(double));
+            for (i=0; i<2*next->ny*next->nzl; i++) gx[i] = 0.0;
+            for (i=0; i<2*next->nx*next->nzl; i++) gy[i] = 0.0;
+            for (i=0; i<2*nxy; i++) gz[i] = 0.0;
+            for (i=0; i<n; i++) fcf[i] = 0.0;
+            Vmgdist_buildOp(thee, next, gx, gy, gz, a1, a2, a3, ccf, fcf);
+            Vmem_free(thee->vmem, 2*next->ny*next->nzl, sizeof(double),
+                      (void **)&gx);
+            Vmem_free(thee->vmem, 2*next->nx*next->nzl, sizeof(double),
+                      (void **)&gy);
+            Vmem_free(thee->vmem, 2*nxy, sizeof(double), (void **)&gz);
+            Vmem_free(thee->vmem, n, sizeof(double), (void **)&fcf);
+        }
+    }
+    lev = &(thee->level[thee->nlev-1]);
+    n = lev->nx*lev->ny*lev->nzl;
+    if (n > 0) {
+        if (thee->nlev > 1) {
+            Vmem_free(thee->vmem, n, sizeof(double), (void **)&a1);
+            Vmem_free(thee->vmem, n, sizeof(double), (void **)&a2);
+            Vmem_free(thee->vmem, n, sizeof(double), (void **)&a3);
+        }
+        Vmem_free(thee->vmem, n, sizeof(double), (void **)&ccf);
+    }
+
+    if (me == 0) {
+        for (l=0; l<thee->nlev; l++) {
+            lev = &(thee->level[l]);
+            for (p=0; (p<size) && (lev->own[p] < lev->own[p+1]); p++);
+            Vnm_print(0, "Vmgdist_ctor2:  Level %d is %d x %d x %d on %d \
+processors\n", l, lev->nx, lev->ny, lev->nz, p);
+        }
+    }
+
+    return 1;
+}
+
+/* ///////////////////////////////////////////////////////////////////////////
+// Routine:  Vmgdist_dtor
+/////////////////////////////////////////////////////////////////////////// */
+VPUBLIC void Vmgdist_dtor(Vmgdist **thee) {
+
+    if ((*thee) != VNULL) {
+        Vmgdist_dtor2(*thee);
+        Vmem_free(VNULL, 1, sizeof(Vmgdist), (void **)thee);
+        (*thee) = VNULL;
+    }
+}
+
+/* ///////////////////////////////////////////////////////////////////////////
+// Routine:  Vmgdist_dtor2
+/////////////////////////////////////////////////////////////////////////// */
+VPUBLIC void Vmgdist_dtor2(Vmgdist *thee) {
+
+    int l, n, nt, size;
+    VmgdistLevel *lev;
+
+    size = thee->size;
+    if (thee->level != VNULL) {
+        for (l=0; l<thee->nlev; l++) {
+            lev = &(thee->level[l]);
+            n = lev->nx*lev->ny*lev->nzl;
+            if (n > 0) {
+                Vmem_free(thee->vmem, 4*n, sizeof(double), (void **)&(lev->ac));
+                Vmem_free(thee->vmem, n, sizeof(double), (void **)&(lev->cc));
+                Vmem_free(thee->vmem, n, sizeof(double), (void **)&(lev->fc));
+                Vmem_free(thee->vmem, n, sizeof(double), (void **)&(lev->x));
+                Vmem_free(thee->vmem, n, sizeof(double), (void **)&(lev->r));
+                if (lev->w1 != VNULL) {
+                    Vmem_free(thee->vmem, n, sizeof(double),
+                              (void **)&(lev->w1));
+                    Vmem_free(thee->vmem, n, sizeof(double),
+                              (void **)&(lev->w2));
+                }
+                Vmem_free(thee->vmem, lev->nx, sizeof(double),
+                          (void **)&(lev->xf));
+                Vmem_free(thee->vmem, lev->ny, sizeof(double),
+                          (void **)&(lev->yf));
+                Vmem_free(thee->vmem, lev->nzl, sizeof(double),
+                          (void **)&(lev->zf));
+            }
+            if (lev->t != VNULL) {
+                nt = thee->level[l+1].nx*thee->level[l+1].ny*lev->nzt;
+                Vmem_free(thee->vmem, nt, sizeof(double), (void **)&(lev->t));
+                Vmem_free(thee->vmem, 27*nt, sizeof(double),
+                          (void **)&(lev->pc));
+            }
+            Vmem_free(thee->vmem, size+1, sizeof(int), (void **)&(lev->own));
+            Vmem_free(thee->vmem, size, sizeof(int), (void **)&(lev->lo));
+            Vmem_free(thee->vmem, size, sizeof(int), (void **)&(lev->hi));
+            Vmem_free(thee->vmem, size+1, sizeof(int), (void **)&(lev->town));
+            Vmem_free(thee->vmem, size, sizeof(int), (void **)&(lev->tlo));
+            Vmem_free(thee->vmem, size, sizeof(int), (void **)&(lev->thi));
+        }
+        Vmem_free(thee->vmem, thee->nlev, sizeof(VmgdistLevel),
+                  (void **)&(thee->level));
+    }
+    if (thee->slo != VNULL) {
+        Vmem_free(thee->vmem, size, sizeof(int), (void **)&(thee->slo));
+        Vmem_free(thee->vmem, size, sizeof(int), (void **)&(thee->shi));
+    }
+    Vmem_dtor(&(thee->vmem));
+}
+
+/* Sweeps of red/black Gauss-Seidel, each after a halo exchange */
+VPRIVATE void Vmgdist_smooth(Vmgdist *thee, VmgdistLevel *lev, int nu,
+        int iadjoint) {
+
+    int s, n, one, iters, iresid;
+    double errtol, omega;
+
+    one = 1;
+    iresid = 0;
+    errtol = 0.0;
+    omega = thee->pmg->pmgp->omegal;
+    n = lev->nx*lev->ny*lev->nzl;
+    for (s=0; s<nu; s++) {
+        Vmgdist_halo(thee, lev, lev->x);
+        if (n == 0) continue;
+        Vgsrb7x(&(lev->nx), &(lev->ny), &(lev->nzl), lev->ipc, lev->rpc,
+                lev->ac, lev->cc, lev->fc, lev->ac + n, lev->ac + 2*n,
+                lev->ac + 3*n, lev->x, lev->r, lev->r, lev->r,
+                &one, &iters, &errtol, &omega, &iresid, &iadjoint);
+    }
+}
+
+/* Residual of a level in r */
+VPRIVATE void Vmgdist_resid(Vmgdist *thee, VmgdistLevel *lev) {
+
+    int n;
+
+    Vmgdist_halo(thee, lev, lev->x);
+    n = lev->nx*lev->ny*lev->nzl;
+    if (n == 0) return;
+    Vmresid7_1s(&(lev->nx), &(lev->ny), &(lev->nzl), lev->ipc, lev->rpc,
+                lev->ac, lev->cc, lev->fc, lev->ac + n, lev->ac + 2*n,
+                lev->ac + 3*n, lev->x, lev->r);
+}
+
+/* Restrict the residual of level l to the right-hand side of level l+1 */
+VPRIVATE void Vmgdist_restrict(Vmgdist *thee, int l) {
+
+    int me;
+    VmgdistLevel *lev, *next;
+
+    me = thee->rank;
+    lev = &(thee->level[l]);
+    next = &(thee->level[l+1]);
+    if (lev->nzt > 0) {
+        Vrestrc(&(lev->nx), &(lev->ny), &(lev->nzl),
+                &(next->nx), &(next->ny), &(lev->nzt),
+                lev->r, lev->t, lev->pc);
+    }
+    Vmgdist_exchange(thee, next->nx*next->ny, lev->town, lev->t, lev->tlo[me],
+                     next->fc, next->lo[me], next->lo, next->hi);
+}
+
+/* Interpolate the solution of level l+1 into r of level l */
+VPRIVATE void Vmgdist_interp(Vmgdist *thee, int l) {
+
+    int me;
+    VmgdistLevel *lev, *next;
+
+    me = thee->rank;
+    lev = &(thee->level[l]);
+    next = &(thee->level[l+1]);
+    Vmgdist_exchange(thee, next->nx*next->ny, next->own, next->x,
+                     next->lo[me], lev->t, lev->tlo[me], lev->tlo, lev->thi);
+    if (lev->nzt > 0) {
+        VinterpPMG(&(next->nx), &(next->ny), &(lev->nzt),
+                   &(lev->nx), &(lev->ny), &(lev->nzl),
+                   lev->t, lev->r, lev->pc);
+    }
+}
+
+/* ///////////////////////////////////////////////////////////////////////////
+// Routine:  Vmgdist_solve
+//
+// Purpose:  V-cycles as in Vmvcs: nu1 pre-smoothing sweeps, restriction of
+//           the residual down to the coarsest level, conjugate gradients
+//           there, and back up with interpolation, the Hackbusch/Reusken
+//           damping of the correction and nu2 adjoint post-smoothing sweeps,
+//           until the relative residual (istop = 1) drops below errtol.
+/////////////////////////////////////////////////////////////////////////// */
+VPUBLIC int Vmgdist_solve(Vmgdist *thee) {
+
+    int i, j, k, l, n, nx, ny, nz, nxy, me, nlev;
+    int itmax_s, iters_s, iresid, iadjoint;
+    double sums[2], tsums[2], rsden, xdamp, errtol_s, omega;
+    double *u;
+    VmgdistLevel *lev, *next;
+    Vpmg *pmg;
+
+    VASSERT(thee != VNULL);
+
+    me = thee->rank;
+    nlev = thee->nlev;
+    pmg = thee->pmg;
+    lev = &(thee->level[0]);
+    nx = lev->nx;
+    ny = lev->ny;
+    nxy = nx*ny;
+
+    /* Start from the interior of the slab's solution if it holds a guess */
+    n = nxy*lev->nzl;
+    for (i=0; i<n; i++) lev->x[i] = 0.0;
+    if (pmg->iparm[29] == 1) {
+        for (k=1; k<lev->nzl-1; k++) {
+            for (j=1; j<ny-1; j++) {
+                for (i=1; i<nx-1; i++) {
+                    lev->x[IJK(i,j,k)] = pmg->u[nxy*(lev->lo[me]
+                        - thee->slo[me] + k) + IJK(i,j,0)];
+                }
+            }
+        }
+    }
+
+    sums[0] = Vmgdist_sum(thee, lev, lev->fc, VNULL);
+    Vcom_reduce(thee->com, sums, tsums, 1, 2, 0);
+    rsden = tsums[0];
+    if (rsden == 0.0) {
+        rsden = 1.0;
+        Vnm_print(2, "Vmgdist_solve:  rhs is zero on finest level\n");
+    }
+
+    thee->iters = 0;
+    do {
+        /* Down to the coarsest level */
+        Vmgdist_smooth(thee, lev, thee->nu1, 0);
+        Vmgdist_resid(thee, lev);
+        for (l=1; l<nlev; l++) {
+            Vmgdist_restrict(thee, l-1);
+            if (l < nlev-1) {
+                next = &(thee->level[l]);
+                n = next->nx*next->ny*next->nzl;
+                for (i=0; i<n; i++) next->x[i] = 0.0;
+                Vmgdist_smooth(thee, next, thee->nu1, 0);
+                Vmgdist_resid(thee, next);
+            }
+        }
+
+        /* Solve on the coarsest level with conjugate gradients */
+        next = &(thee->level[nlev-1]);
+        n = next->nx*next->ny*next->nzl;
+        if (n > 0) {
+            for (i=0; i<n; i++) next->x[i] = 0.0;
+            itmax_s = 100;
+            iters_s = 0;
+            errtol_s = Vnm_epsmac();
+            omega = pmg->pmgp->omegal;
+            iresid = 0;
+            iadjoint = 0;
+            Vcghs(&(next->nx), &(next->ny), &(next->nzl),
+                  next->ipc, next->rpc, next->ac, next->cc, next->fc,
+                  next->x, next->w1, next->w2, next->r,
+                  &itmax_s, &iters_s, &errtol_s, &omega, &iresid, &iadjoint);
+        }
+
+        /* Back up to the finest level */
+        for (l=nlev-2; l>=0; l--) {
+            lev = &(thee->level[l]);
+            next = &(thee->level[l+1]);
+            Vmgdist_interp(thee, l);
+
+            /* Damping parameter (the linear CG step length) */
+            Vmgdist_halo(thee, next, next->x);
+            if (next->nzl > 0) {
+                Vmatvec(&(next->nx), &(next->ny), &(next->nzl),
+                        next->ipc, next->rpc, next->ac, next->cc,
+                        next->x, next->r);
+            }
+            sums[0] = Vmgdist_sum(thee, next, next->x, next->fc);
+            sums[1] = Vmgdist_sum(thee, next, next->x, next->r);
+            Vcom_reduce(thee->com, sums, tsums, 2, 2, 0);
+            xdamp = tsums[0]/tsums[1];
+
+            n = lev->nx*lev->ny*lev->nzl;
+            for (i=0; i<n; i++) lev->x[i] += xdamp*lev->r[i];
+            Vmgdist_smooth(thee, lev, thee->nu2, 1);
+        }
+
+        (thee->iters)++;
+        Vmgdist_resid(thee, lev);
+        sums[0] = Vmgdist_sum(thee, lev, lev->r, VNULL);
+        Vcom_reduce(thee->com, sums, tsums, 1, 2, 0);
+        thee->rsnrm = tsums[0]/rsden;
+    } while ((thee->iters < thee->itmax) && (thee->rsnrm > thee->errtol));
+
+    /* Fetch every plane of the slab from its owner and put the boundary
+     * values back on the faces of the undivided mesh */
+    u = pmg->u;
+    nz = pmg->pmgp->nz;
+    Vmgdist_exchange(thee, nxy, lev->own, lev->x, lev->lo[me],
+                     u, thee->slo[me], thee->slo, thee->shi);
+    for (k=0; k<nz; k++) {
+        for (j=0; j<ny; j++) {
+            u[IJK(0,j,k)] = pmg->gxcf[IJKx(j,k,0)];
+            u[IJK(nx-1,j,k)] = pmg->gxcf[IJKx(j,k,1)];
+        }
+    }
+    for (k=0; k<nz; k++) {
+        for (i=0; i<nx; i++) {
+            u[IJK(i,0,k)] = pmg->gycf[IJKy(i,k,0)];
+            u[IJK(i,ny-1,k)] = pmg->gycf[IJKy(i,k,1)];
+        }
+    }
+    if (thee->slo[me] == 0) {
+        for (j=0; j<ny; j++) {
+            for (i=0; i<nx; i++) u[IJK(i,j,0)] = pmg->gzcf[IJKz(i,j,0)];
+        }
+    }
+    if (thee->shi[me] == lev->nz-1) {
+        for (j=0; j<ny; j++) {
+            for (i=0; i<nx; i++) u[IJK(i,j,nz-1)] = pmg->gzcf[IJKz(i,j,1)];
+        }
+    }
+
+    if (thee->rsnrm > thee->errtol) {
+        Vnm_print(2, "Vmgdist_solve:  Relative residual %g after %d \
+iterations is above the tolerance %g\n", thee->rsnrm, thee->iters,
+                  thee->errtol);
+    }
+
+    return 1;
+}
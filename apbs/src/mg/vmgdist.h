@@ -0,0 +1,214 @@
+/** @defgroup Vmgdist Vmgdist class
+ *  @brief    Multigrid solver for a mesh distributed across processors
+ */
+
+/**
+ *  @file    vmgdist.h
+ *  @ingroup Vmgdist
+ *  @brief   Contains declarations for class Vmgdist
+ *  @version $Id$
+ *  @attention
+ *  @verbatim
+ *
+ * APBS -- Adaptive Poisson-Boltzmann Solver
+ *
+ *  Nathan A. Baker (nathan.baker@pnnl.gov)
+ *  Pacific Northwest National Laboratory
+ *
+ *  Additional contributing authors listed in the code documentation.
+ *
+ * Copyright (c) 2010-2014 Battelle Memorial Institute. Developed at the
+ * Pacific Northwest National Laboratory, operated by Battelle Memorial
+ * Institute, Pacific Northwest Division for the U.S. Department of Energy.
+ *
+ * Portions Copyright (c) 2002-2010, Washington University in St. Louis.
+ * Portions Copyright (c) 2002-2010, Nathan A. Baker.
+ * Portions Copyright (c) 1999-2002, The Regents of the University of
+ * California.
+ * Portions Copyright (c) 1995, Michael Holst.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of the developer nor the names of its contributors may be
+ * used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @endverbatim
+ */
+
+
+#ifndef _VMGDIST_H_
+#define _VMGDIST_H_
+
+#include "apbscfg.h"
+
+#include "maloc/maloc.h"
+
+#include "generic/vhal.h"
+#include "generic/mgparm.h"
+#include "pmgc/buildAd.h"
+#include "pmgc/buildPd.h"
+#include "pmgc/cgd.h"
+#include "pmgc/gsd.h"
+#include "pmgc/matvecd.h"
+#include "pmgc/mgsubd.h"
+#include "pmgc/mikpckd.h"
+#include "mg/vpmg.h"
+
+/** @def VMGDIST_MINPLANES
+ *  @brief Fewest z planes a processor may own on a coarse level before
+ *         that level is gathered onto fewer processors
+ *  @ingroup Vmgdist
+ */
+#define VMGDIST_MINPLANES 4
+
+/**
+ *  @ingroup Vmgdist
+ *  @brief   One level of the distributed multigrid hierarchy
+ *  @note    Plane indices are global z indices on this level.  A processor
+ *           that owns no planes on a level has no local arrays there.
+ */
+struct sVmgdistLevel {
+
+    int nx;  /**< Number of x grid points */
+    int ny;  /**< Number of y grid points */
+    int nz;  /**< Number of z planes of the whole level */
+    int *own;  /**< Processor p owns planes [own[p], own[p+1]) */
+    int *lo;  /**< First plane stored by each processor (owned planes plus
+               * ghosts) */
+    int *hi;  /**< Last plane stored by each processor */
+    int nzl;  /**< Number of planes stored by this processor */
+    int ipc[100];  /**< Integer parameters of the operator */
+    double rpc[100];  /**< Real parameters of the operator */
+    double *ac;  /**< 7-point operator (oC, oE, oN and uC) on the stored
+                  * planes */
+    double *cc;  /**< Helmholtz term */
+    double *fc;  /**< Right-hand side: the source on the finest level and
+                  * the restricted residual on the others */
+    double *x;  /**< Solution or correction */
+    double *r;  /**< Residual and interpolated correction */
+    double *w1;  /**< Conjugate gradient work array (coarsest level only) */
+    double *w2;  /**< Conjugate gradient work array (coarsest level only) */
+    double *xf;  /**< Mesh x coordinates */
+    double *yf;  /**< Mesh y coordinates */
+    double *zf;  /**< Mesh z coordinates of the stored planes */
+    int *town;  /**< Coarse planes each processor restricts to and
+                 * interpolates from: [town[p], town[p+1]) */
+    int *tlo;  /**< First coarse plane of each processor's transfer array */
+    int *thi;  /**< Last coarse plane of each processor's transfer array */
+    int nzt;  /**< Number of planes in this processor's transfer array */
+    double *t;  /**< Transfer array on the next coarser mesh */
+    double *pc;  /**< Prolongation operator for the transfer array */
+};
+
+/** @typedef VmgdistLevel
+ *  @ingroup Vmgdist
+ *  @brief   Declaration of the VmgdistLevel structure
+ */
+typedef struct sVmgdistLevel VmgdistLevel;
+
+/**
+ *  @ingroup Vmgdist
+ *  @brief   Linear multigrid solver for a mesh split into z slabs across
+ *           processors
+ *  @note    Each processor holds one slab of the mesh in a Vpmg (see the
+ *           distrib keyword of MGparm) and owns a contiguous block of its
+ *           planes.  The smoother, residual, restriction and prolongation
+ *           are the PMG kernels applied to the owned planes plus ghost
+ *           planes that are exchanged with the neighbouring processors.
+ *           Coarse levels inherit the partition until processors would own
+ *           too few planes; they are then gathered onto fewer processors,
+ *           and the coarsest level is solved on one.
+ */
+struct sVmgdist {
+
+    Vmem *vmem;  /**< Memory management object */
+    Vcom *com;  /**< Communications object */
+    Vpmg *pmg;  /**< This processor's slab */
+    int rank;  /**< Rank of this processor */
+    int size;  /**< Number of processors */
+    int nlev;  /**< Number of levels */
+    VmgdistLevel *level;  /**< Levels, finest first */
+    int *slo;  /**< First global plane of each processor's slab */
+    int *shi;  /**< Last global plane of each processor's slab */
+    int nu1;  /**< Number of pre-smoothing sweeps */
+    int nu2;  /**< Number of post-smoothing sweeps */
+    int itmax;  /**< Maximum number of v-cycles */
+    double errtol;  /**< Relative residual tolerance */
+    int iters;  /**< Number of v-cycles of the last solve */
+    double rsnrm;  /**< Relative residual at the end of the last solve */
+};
+
+/** @typedef Vmgdist
+ *  @ingroup Vmgdist
+ *  @brief   Declaration of the Vmgdist class as the Vmgdist structure
+ */
+typedef struct sVmgdist Vmgdist;
+
+/** @brief   Construct the distributed multigrid hierarchy for a slab
+ *  @ingroup Vmgdist
+ *  @note    Collective: every processor of the calculation must call it.
+ *  @param   com     Communications object
+ *  @param   pmg     This processor's slab, with Vpmg_fillco already called
+ *  @param   mgparm  Parameters of the distributed calculation
+ *  @returns Newly allocated and initialized Vmgdist object, or VNULL if the
+ *           mesh cannot be distributed
+ */
+VEXTERNC Vmgdist* Vmgdist_ctor(Vcom *com, Vpmg *pmg, MGparm *mgparm);
+
+/** @brief   FORTRAN stub to construct the distributed multigrid hierarchy
+ *  @ingroup Vmgdist
+ *  @param   thee    Memory for the new object
+ *  @param   com     Communications object
+ *  @param   pmg     This processor's slab, with Vpmg_fillco already called
+ *  @param   mgparm  Parameters of the distributed calculation
+ *  @returns 1 if successful, 0 otherwise
+ */
+VEXTERNC int Vmgdist_ctor2(Vmgdist *thee, Vcom *com, Vpmg *pmg,
+        MGparm *mgparm);
+
+/** @brief   Object destructor
+ *  @ingroup Vmgdist
+ *  @param   thee  Pointer to memory location of object to be destroyed
+ */
+VEXTERNC void Vmgdist_dtor(Vmgdist **thee);
+
+/** @brief   FORTRAN stub object destructor
+ *  @ingroup Vmgdist
+ *  @param   thee  Pointer to object to be destroyed
+ */
+VEXTERNC void Vmgdist_dtor2(Vmgdist *thee);
+
+/** @brief   Solve the linearized PBE on the distributed mesh
+ *  @ingroup Vmgdist
+ *  @note    Collective.  Runs v-cycles until the relative residual of the
+ *           whole mesh is below the tolerance, then stores the solution of
+ *           every plane of this processor's slab (ghosts included) and the
+ *           boundary values in pmg->u.
+ *  @param   thee  Vmgdist object
+ *  @returns 1 if successful, 0 otherwise
+ */
+VEXTERNC int Vmgdist_solve(Vmgdist *thee);
+
+#endif
@@ -156,6 +156,7 @@ VPUBLIC int Vopot_pot(Vopot *thee, double pt[3], double *value) {
                 break;
 
             case BCFL_MDH:
+            case BCFL_MDHTREE:
                 u = 0;
                 for (iatom=0; iatom<Valist_getNumberAtoms(alist); iatom++) {
                     atom = Valist_getAtom(alist, iatom);
@@ -254,6 +255,7 @@ VPUBLIC int Vopot_curvature(Vopot *thee, double pt[3], int cflag,
                 break;
 
             case BCFL_MDH:
+            case BCFL_MDHTREE:
                 u = 0;
                 for (iatom=0; iatom<Valist_getNumberAtoms(alist); iatom++) {
                     atom = Valist_getAtom(alist, iatom);
@@ -345,6 +347,7 @@ VPUBLIC int Vopot_gradient(Vopot *thee, double pt[3], double grad[3]) {
                 break;
 
             case BCFL_MDH:
+            case BCFL_MDHTREE:
                 grad[0] = 0.0;
                 grad[1] = 0.0;
                 grad[2] = 0.0;
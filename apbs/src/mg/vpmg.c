@@ -74,6 +74,661 @@
 
 VEMBED(rcsid="$Id$")
 
+/** @brief   Build a column-compressed matrix in Harwell-Boeing format
+ *  @ingroup Vpmg
+ *  @author  Tucker Beck [C Translation]
+ *           Nathan Baker [Original] (mostly ripped off from Harwell-Boeing
+ *                                    format documentation)Michael Schnieders)
+ */
+VPRIVATE void bcolcomp(
+        int    *iparm,  ///< @todo Document
+        double *rparm,  ///< @todo Document
+        int    *iwork,  ///< @todo Document
+        double *rwork,  ///< @todo Document
+        double *values, ///< @todo Document
+        int    *rowind, ///< @todo Document
+        int    *colptr, ///< @todo Document
+        int    *flag    /**< Operation selection parameter
+                         *     0 = Use Poisson operator only
+                         *     1 = Use linearization of full operation around
+                         *         current solution.
+                         */
+        );
+
+
+
+/** @brief   Build a column-compressed matrix in Harwell-Boeing format
+ *  @ingroup Vpmg
+ *  @author  Tucker Beck [C Translation]
+ *           Nathan Baker [Original] (mostly ripped off from Harwell-Boeing
+ *                                    format documentation)Michael Schnieders)
+ */
+VPRIVATE void bcolcomp2(
+        int    *iparm,  ///< @todo Document
+        double *rparm,  ///< @todo Document
+        int    *nx,     ///< @todo Document
+        int    *ny,     ///< @todo Document
+        int    *nz,     ///< @todo Document
+        int    *iz,     ///< @todo Document
+        int    *ipc,    ///< @todo Document
+        double *rpc,    ///< @todo Document
+        double *ac,     ///< @todo Document
+        double *cc,     ///< @todo Document
+        double *values, ///< @todo Document
+        int    *rowind, ///< @todo Document
+        int    *colptr, ///< @todo Document
+        int    *flag    /**< Operation selection parameter
+                         *     0 = Use Poisson operator only
+                         *     1 = Use linearization of full operation around
+                         *         current solution.
+                         */
+        );
+
+
+
+/** @brief   Build a column-compressed matrix in Harwell-Boeing format
+ *  @ingroup Vpmg
+ *  @author  Tucker Beck [C Translation]
+ *           Nathan Baker [Original] (mostly ripped off from Harwell-Boeing
+ *                                    format documentation)Michael Schnieders)
+ */
+VPRIVATE void bcolcomp3(
+        int    *nx,     ///< @todo Document
+        int    *ny,     ///< @todo Document
+        int    *nz,     ///< @todo Document
+        int    *ipc,    ///< @todo Document
+        double *rpc,    ///< @todo Document
+        double *ac,     ///< @todo Document
+        double *cc,     ///< @todo Document
+        double *values, ///< @todo Document
+        int    *rowind, ///< @todo Document
+        int    *colptr, ///< @todo Document
+        int    *flag    ///< @todo Document
+        );
+
+
+
+/** @brief   Build a column-compressed matrix in Harwell-Boeing format
+ *  @ingroup Vpmg
+ *  @author  Tucker Beck [C Translation]
+ *           Nathan Baker [Original] (mostly ripped off from Harwell-Boeing
+ *                                    format documentation)Michael Schnieders)
+ */
+VPRIVATE void bcolcomp4(
+        int    *nx,     ///< @todo Document
+        int    *ny,     ///< @todo Document
+        int    *nz,     ///< @todo Document
+        int    *ipc,    ///< @todo Document
+        double *rpc,    ///< @todo Document
+        double *oC,     ///< @todo Document
+        double *cc,     ///< @todo Document
+        double *oE,     ///< @todo Document
+        double *oN,     ///< @todo Document
+        double *uC,     ///< @todo Document
+        double *values, ///< @todo Document
+        int    *rowind, ///< @todo Document
+        int    *colptr, ///< @todo Document
+        int    *flag    ///< @todo Document
+        );
+
+
+
+/** @brief   Print a column-compressed matrix in Harwell-Boeing format
+ *  @ingroup Vpmg
+ *  @author  Tucker Beck [C Translation]
+ *           Nathan Baker [Original] (mostly ripped off from Harwell-Boeing
+ *                                    format documentation)Michael Schnieders)
+ */
+VPRIVATE void pcolcomp(
+        int    *nrow,   ///< @todo Document
+        int    *ncol,   ///< @todo Document
+        int    *nnzero, ///< @todo Document
+        double *values, ///< @todo Document
+        int    *rowind, ///< @todo Document
+        int    *colptr, ///< @todo Document
+        char   *path,   ///< @todo Document
+        char   *title,  ///< @todo Document
+        char   *mxtype  ///< @todo Document
+        );
+
+
+
+/* ///////////////////////////////////////////////////////////////////////////
+// Internal routines
+/////////////////////////////////////////////////////////////////////////// */
+
+/**
+ * @brief  Evaluate a cubic B-spline
+ * @author  Nathan Baker
+ * @return  Cubic B-spline value
+ */
+VPRIVATE double bspline2(
+        double x  /** Position */
+        );
+
+/**
+ * @brief  Evaluate a cubic B-spline derivative
+ * @author  Nathan Baker
+ * @return  Cubic B-spline derivative
+ */
+VPRIVATE double dbspline2(
+        double x  /** Position */
+        );
+
+/**
+ * @brief   Return 2.5 plus difference of i - f
+ * @author  Michael Schnieders
+ * @return  (2.5+((double)(i)-(f)))
+ */
+VPRIVATE double VFCHI4(
+        int i,
+        double f
+        );
+
+/**
+ * @brief   Evaluate a 5th Order B-Spline (4th order polynomial)
+ * @author: Michael Schnieders
+ * @return  5th Order B-Spline
+ */
+VPRIVATE double bspline4(
+         double x /** Position */
+         );
+
+/**
+ * @brief   Evaluate a 5th Order B-Spline derivative (4th order polynomial)
+ * @author: Michael Schnieders
+ * @return  5th Order B-Spline derivative
+ */
+VPRIVATE double dbspline4(
+         double x /** Position */
+         );
+
+/**
+ * @brief   Evaluate the 2nd derivative of a 5th Order B-Spline
+ * @author: Michael Schnieders
+ * @return  2nd derivative of a 5th Order B-Spline
+ */
+VPRIVATE double d2bspline4(
+         double x /** Position */
+         );
+
+/**
+ * @brief   Evaluate the 3rd derivative of a 5th Order B-Spline
+ * @author: Michael Schnieders
+ * @return  3rd derivative of a 5th Order B-Spline
+ */
+VPRIVATE double d3bspline4(
+         double x /** Position */
+         );
+
+/**
+ * @brief  Determines energy from polarizeable charge and interaction with
+ *         fixed charges according to Rocchia et al.
+ * @author  Nathan Baker
+ * @return  Energy in kT
+ */
+VPRIVATE double Vpmg_polarizEnergy(
+         Vpmg *thee,
+         int extFlag  /** If 1, add external energy contributions to
+                       result */
+         );
+/**
+ * @brief  Calculates charge-potential energy using summation over delta
+ *         function positions (i.e. something like an Linf norm)
+ * @author  Nathan Baker
+ * @return  Energy in kT
+ */
+VPRIVATE double Vpmg_qfEnergyPoint(
+        Vpmg *thee,
+        int extFlag  /** If 1, add external energy contributions to
+                       result */
+        );
+
+/**
+ * @brief  Calculates charge-potential energy as integral over a volume
+ * @author  Nathan Baker
+ * @return  Energy in kT
+ */
+VPRIVATE double Vpmg_qfEnergyVolume(
+        Vpmg *thee,
+        int extFlag  /** If 1, add external energy contributions to
+                       result */
+        );
+
+/**
+* @brief Selects a spline based surface method from either VSM_SPLINE,
+ *        VSM_SPLINE5 or VSM_SPLINE7
+ * @author David Gohara
+ */
+VPRIVATE void Vpmg_splineSelect(
+        int srfm,		/** Surface method, currently VSM_SPLINE,
+        VSM_SPLINE5, or VSM_SPLINE7 */
+        Vacc *acc,		/** Accessibility object */
+        double *gpos,	/** Position array -> array[3] */
+        double win,		/** Spline window */
+        double infrad,	/** Inflation radius */
+        Vatom *atom,	/** Atom object */
+        double *force	/** Force array -> array[3] */
+        );
+
+/**
+ * @brief  Pass the ion concentrations and valencies of the PBE object to the
+ *         PMG routines
+ */
+VPRIVATE void initIons(
+        Vpmg *thee  /** PMG object */
+        );
+
+/**
+ * @brief  Size the atom partition weights for the atoms of the PBE object
+ */
+VPRIVATE void sizeAtomPart(
+        Vpmg *thee  /** PMG object */
+        );
+
+/**
+ * @brief  For focusing, switch to focusing boundary conditions, fill the
+ *         boundaries from the old mesh and compute the energies outside the
+ *         new one
+ */
+VPRIVATE void focusSetup(
+        Vpmg *thee,  /** New PMG object */
+        Vpmg *pmgOLD,  /** Old PMG object */
+        MGparm *mgparm,  /** Parameters of the new calculation */
+        PBEparm_calcEnergy energyFlag  /** Energy calculation flag */
+        );
+
+/**
+ * @brief  Interpolate a potential on another mesh onto the interior of u
+ *         and have the solver start from it
+ * @returns  The number of interior points on the other mesh
+ */
+VPRIVATE int guessFill(
+        Vpmg *thee,  /** PMG object */
+        int nxOLD,  /** Points of the other mesh in x */
+        int nyOLD,  /** Points of the other mesh in y */
+        int nzOLD,  /** Points of the other mesh in z */
+        double hxOLD,  /** Spacing of the other mesh in x */
+        double hyOLD,  /** Spacing of the other mesh in y */
+        double hzOLD,  /** Spacing of the other mesh in z */
+        double xminOLD,  /** Lower corner of the other mesh */
+        double yminOLD,  /** Lower corner of the other mesh */
+        double zminOLD,  /** Lower corner of the other mesh */
+        double *data  /** Potential on the other mesh (kT/e) */
+        );
+
+/**
+ * @brief  For focusing, fill in the boundaries of the new mesh based on the
+ * potential values in the old mesh
+ * @author  Nathan Baker
+ */
+VPRIVATE void focusFillBound(
+        Vpmg *thee,  /** New PMG object (the one just created) */
+        Vpmg *pmg  /** Old PMG object */
+        );
+
+/**
+ * @brief  Increment all boundary points by
+ *         pre1*(charge/d)*(exp(-xkappa*(d-size))/(1+xkappa*size) to add the
+ *         effect of the Debye-Huckel potential due to a single charge
+ * @author  Nathan Baker
+ */
+VPRIVATE void bcfl1(
+        double size,  /** Size of the ion */
+        double *apos,  /** Position of the ion */
+        double charge,  /** Charge of the ion */
+        double xkappa,  /** Exponential screening factor */
+        double pre1,  /** Unit- and dielectric-dependent prefactor */
+        double *gxcf,  /** Set to x-boundary values */
+        double *gycf,  /** Set to y-boundary values */
+        double *gzcf,  /** Set to z-boundary values */
+        double *xf,  /** Boundary point x-coordinates */
+        double *yf,  /** Boundary point y-coordinates */
+        double *zf,  /** Boundary point z-coordinates */
+        int nx,  /** Number of grid points in x-direction */
+        int ny,  /** Number of grid points in y-direction */
+        int nz /** Number of grid points in y-direction */
+        );
+
+/**
+ * @brief  Increment all boundary points to include the Debye-Huckel
+ *         potential due to a single multipole site. (truncated at quadrupole)
+ * @author Michael Schnieders
+ */
+VPRIVATE void bcfl2(
+        double size,  /** Size of the ion */
+        double *apos,  /** Position of the ion */
+        double charge,  /** Charge of the ion */
+        double *dipole, /** Dipole of the ion */
+        double *quad,   /** Traceless Quadrupole of the ion */
+        double xkappa,  /** Exponential screening factor */
+        double eps_p,   /** Solute dielectric */
+        double eps_w,   /** Solvent dielectric */
+        double T,       /** Temperature */
+        double *gxcf,  /** Set to x-boundary values */
+        double *gycf,  /** Set to y-boundary values */
+        double *gzcf,  /** Set to z-boundary values */
+        double *xf,  /** Boundary point x-coordinates */
+        double *yf,  /** Boundary point y-coordinates */
+        double *zf,  /** Boundary point z-coordinates */
+        int nx,  /** Number of grid points in x-direction */
+        int ny,  /** Number of grid points in y-direction */
+        int nz /** Number of grid points in y-direction */
+        );
+
+/**
+ * @brief  This routine serves bcfl2. It returns (in tsr) the contraction
+ *         independent portion of the Debye-Huckel potential tensor
+ *         for a spherical ion with a central charge, dipole and quadrupole.
+ *         See the code for an in depth description.
+ *
+ * @author Michael Schnieders
+ */
+VPRIVATE void multipolebc(
+        double r,      /** Distance to the boundary */
+        double kappa,  /** Exponential screening factor */
+        double eps_p,  /** Solute dielectric */
+        double eps_w,  /** Solvent dielectric */
+        double rad,    /** Radius of the sphere */
+        double tsr[3]  /** Contraction-independent portion of each tensor */
+        );
+
+/**
+ * @brief  Calculate
+ *         pre1*(charge/d)*(exp(-xkappa*(d-size))/(1+xkappa*size) due to a
+ *         specific ion at a specific point
+ * @author  Nathan Baker
+ * @returns  Value of above function in arbitrary units (dependent on
+ *           pre-factor)
+ */
+VPRIVATE double bcfl1sp(
+        double size,  /** Atom size */
+        double *apos,  /** Atom position */
+        double charge,  /** Atom charge */
+        double xkappa,  /** Exponential screening factor */
+        double pre1,  /** Unit- and dielectric-dependent prefactor */
+        double *pos  /** Function evaluation position */
+        );
+
+/**
+ * @brief  Increment all boundary points by the multiple Debye-Huckel
+ *         potential using a treecode approximation whose accuracy is set by
+ *         thee->pmgp->bctol
+ */
+VPRIVATE void bcflTree(
+        Vpmg *thee  /** PMG object with packed atoms and boundary arrays */
+        );
+
+/**
+ * @brief  Fill boundary condition arrays
+ * @author  Nathan Baker
+ */
+VPRIVATE void bcCalc(
+        Vpmg *thee
+        );
+
+/**
+ * @brief  Top-level driver to fill all operator coefficient arrays
+ * @author  Nathan Baker
+ */
+VPRIVATE void fillcoCoef(
+        Vpmg *thee
+        );
+
+/**
+ * @brief  Fill operator coefficient arrays from pre-calculated maps
+ * @author  Nathan Baker
+ */
+VPRIVATE void fillcoCoefMap(
+        Vpmg *thee
+        );
+
+/**
+ * @brief  Fill operator coefficient arrays from a molecular surface
+ *         calculation
+ * @author  Nathan Baker
+ */
+VPRIVATE void fillcoCoefMol(
+        Vpmg *thee
+        );
+
+/**
+ * @brief  Fill ion (nonlinear) operator coefficient array from a molecular
+ * surface calculation
+ * @author  Nathan Baker
+ */
+VPRIVATE void fillcoCoefMolIon(
+        Vpmg *thee
+        );
+
+/**
+ * @brief  Fill differential operator coefficient arrays from a molecular
+ *         surface calculation
+ * @author  Nathan Baker
+ */
+VPRIVATE void fillcoCoefMolDiel(
+        Vpmg *thee
+        );
+
+/**
+ * @brief  Fill differential operator coefficient arrays from a molecular
+ *         surface calculation without smoothing
+ * @author  Nathan Baker
+ */
+VPRIVATE void fillcoCoefMolDielNoSmooth(
+        Vpmg *thee
+        );
+
+/**
+ * @brief  Fill differential operator coefficient arrays from a molecular
+ *         surface calculation with smoothing.
+ *
+ *         Molecular surface, dielectric smoothing following an implementation
+ *         of Bruccoleri, et al.  J Comput Chem 18 268-276 (1997).
+ *
+ *         This algorithm uses a 9 point harmonic smoothing technique - the point
+ *         in question and all grid points 1/sqrt(2) grid spacings away.
+ *
+ * @note   This allocates thee->a1cf, thee->a2cf, thee->a3cf as temporary
+ *         storage and frees them on return.
+ * @author  Todd Dolinsky
+ */
+VPRIVATE void fillcoCoefMolDielSmooth(
+        Vpmg *thee
+        );
+
+/**
+ * @brief  Fill operator coefficient arrays from a spline-based surface
+ *         calculation
+ * @author  Nathan Baker
+ */
+VPRIVATE void fillcoCoefSpline(
+        Vpmg *thee
+        );
+
+/**
+* @brief  Fill operator coefficient arrays from a 5th order polynomial
+*         based surface calculation
+* @author  Michael Schnieders
+*/
+VPRIVATE void fillcoCoefSpline3(
+        Vpmg *thee
+        );
+
+/**
+ * @brief  Fill operator coefficient arrays from a 7th order polynomial
+ *         based surface calculation
+ * @author  Michael Schnieders
+ */
+VPRIVATE void fillcoCoefSpline4(
+        Vpmg *thee
+        );
+
+/**
+ * @brief  Top-level driver to fill source term charge array
+ * @returns  Success/failure status
+ * @author  Nathan Baker
+ */
+VPRIVATE Vrc_Codes fillcoCharge(
+        Vpmg *thee
+        );
+
+/**
+ * @brief  Fill source term charge array from a pre-calculated map
+ * @returns  Success/failure status
+ * @author  Nathan Baker
+ */
+VPRIVATE Vrc_Codes fillcoChargeMap(
+        Vpmg *thee
+        );
+
+/**
+ * @brief  List the atoms touching each z-plane of the charge grid, so the
+ *         charge fills can assign each plane to a single thread
+ * @returns Length of the atom list
+ */
+VPRIVATE int fillcoChargePlanes(
+        Vpmg *thee,  /**< Vpmg object */
+        int natoms,  /**< Number of atoms */
+        int *kmin,  /**< Lowest plane touched by each atom */
+        int *kmax,  /**< Highest plane touched by each atom (less than kmin
+                      for atoms that are skipped) */
+        int **plane,  /**< Set to the nz+1 offsets of each plane's atoms in
+                        list */
+        int **list  /**< Set to the indices of the atoms in each plane, in
+                      atom order */
+        );
+
+/**
+ * @brief  Fill source term charge array from linear interpolation
+ * @author  Nathan Baker
+ */
+VPRIVATE void fillcoChargeSpline1(
+        Vpmg *thee
+        );
+
+/**
+ * @brief  Fill source term charge array from cubic spline interpolation
+ * @author  Nathan Baker
+ */
+VPRIVATE void fillcoChargeSpline2(
+        Vpmg *thee
+        );
+
+/**
+ * @brief  Fill source term charge array for the use of permanent multipoles
+ * @author  Michael Schnieders
+ */
+VPRIVATE void fillcoPermanentMultipole(
+        Vpmg *thee
+        );
+
+/**
+ * @brief  Fill source term charge array for use of induced dipoles
+ * @author  Michael Schnieders
+ */
+VPRIVATE void fillcoInducedDipole(
+        Vpmg *thee
+        );
+
+/**
+ * @brief  Fill source term charge array for non-local induced
+ * dipoles
+ * @author  Michael Schnieders
+ */
+VPRIVATE void fillcoNLInducedDipole(
+        Vpmg *thee
+        );
+
+/**
+ * @brief  For focusing, set external energy data members in new Vpmg object
+ *         based on energy calculations on old Vpmg object from regions
+ *         outside the indicated partition.
+ * @author  Nathan Baker, Todd Dolinsky
+ */
+VPRIVATE void extEnergy(
+        Vpmg *thee,  /** Newly created PMG manager */
+        Vpmg *pmgOLD,  /** Old PMG manager, source of energies */
+        PBEparm_calcEnergy extFlag,  /** Energy calculation flag */
+        double partMin[3],  /** Partition lower corner */
+        double partMax[3],  /** Partition upper corner */
+        int bflags[6]  /** Which boundaries to include the calculation */
+        );
+
+/**
+ * @brief  Charge-field force due to a linear spline charge function
+ * @author  Nathan Baker
+ */
+VPRIVATE void qfForceSpline1(
+        Vpmg *thee,
+        double *force,  /** Set to force */
+        int atomID  /** Valist atom ID */
+        );
+
+/**
+ * @brief  Charge-field force due to a cubic spline charge function
+ * @author  Nathan Baker
+ */
+VPRIVATE void qfForceSpline2(
+        Vpmg *thee,
+        double *force,  /** Set to force */
+        int atomID  /** Valist atom ID */
+        );
+
+/**
+* @brief  Charge-field force due to a quintic spline charge function
+* @author  Michael Schnieders
+*/
+VPRIVATE void qfForceSpline4(
+                             Vpmg *thee,
+                             double *force,  /** Set to force */
+                             int atomID  /** Valist atom ID */
+                             );
+
+
+/**
+ * @brief  Calculate the solution to Poisson's equation with a simple
+ *         Laplacian operator and zero-valued Dirichlet boundary conditions.
+ *         Store the solution in thee->u.
+ * @author  Nathan Baker
+ * @note  Vpmg_fillco must be called first
+ */
+VPRIVATE void zlapSolve(
+        Vpmg *thee,
+        double **solution,  /** Solution term vector */
+        double **source,  /** Source term vector */
+        double **work1  /** Work vector */
+        );
+
+/**
+ * @brief  Mark the grid points inside a sphere with a particular value.  This
+ *         marks by resetting the the grid points inside the sphere to the
+ *         specified value.
+ * @author  Nathan Baker
+ */
+VPRIVATE void markSphere(
+        double rtot,  /** Sphere radius */
+        double *tpos,  /** Sphere position */
+        int nx,  /** Number of grid points */
+        int ny,  /** Number of grid points */
+        int nz,  /** Number of grid points */
+        double hx,  /** Grid spacing */
+        double hy,  /** Grid spacing */
+        double hzed,  /** Grid spacing */
+        double xmin,  /** Grid lower corner */
+        double ymin,  /** Grid lower corner */
+        double zmin,  /** Grid lower corner */
+        double *array,  /** Grid values */
+        double markVal  /** Value to mark with */
+        );
+
+/**
+ * @brief Vpmg_qmEnergy for SMPBE
+ * @author Vincent Chu
+ */
+VPRIVATE double Vpmg_qmEnergySMPBE(Vpmg *thee, int extFlag);
+VPRIVATE double Vpmg_qmEnergyNONLIN(Vpmg *thee, int extFlag);
+
 #if !defined(VINLINE_VPMG)
 
 VPUBLIC unsigned long int Vpmg_memChk(Vpmg *thee) {
@@ -153,9 +808,6 @@ VPUBLIC Vpmg* Vpmg_ctor(Vpmgp *pmgp, Vpbe *pbe, int focusFlag,
 VPUBLIC int Vpmg_ctor2(Vpmg *thee, Vpmgp *pmgp, Vpbe *pbe, int focusFlag,
                        Vpmg *pmgOLD, MGparm *mgparm, PBEparm_calcEnergy energyFlag) {
 
-    int i, j, nion;
-    double ionConc[MAXION], ionQ[MAXION], ionRadii[MAXION], zkappa2, zks2;
-    double ionstr, partMin[3], partMax[3];
 	size_t size;
 
     /* Get the parameters */
@@ -169,14 +821,6 @@ VPUBLIC int Vpmg_ctor2(Vpmg *thee, Vpmgp *pmgp, Vpbe *pbe, int focusFlag,
 
 
 
-    /// @note  this is common to both replace/noreplace options
-    /* Initialize ion concentrations and valencies in PMG routines */
-    zkappa2 = Vpbe_getZkappa2(thee->pbe);
-    ionstr = Vpbe_getBulkIonicStrength(thee->pbe);
-    if (ionstr > 0.0) zks2 = 0.5/ionstr;
-    else zks2 = 0.0;
-    Vpbe_getIons(thee->pbe, &nion, ionConc, ionRadii, ionQ);
-
     /* TEMPORARY USEAQUA */
         /* Calculate storage requirements */
     if(mgparm->useAqua == 0){
@@ -193,6 +837,20 @@ VPUBLIC int Vpmg_ctor2(Vpmg *thee, Vpmgp *pmgp, Vpbe *pbe, int focusFlag,
         thee->pmgp->nrwk += (2*(thee->pmgp->nf));
     }
 
+    /* Nonlinear CGMG runs Newton with CG on the corrections, which also
+     * needs the Newton work vectors and a multilevel residual array */
+    if ((thee->pmgp->meth == VSOL_CGMG) && (thee->pmgp->nonlin != NONLIN_LPBE))
+    {
+        thee->pmgp->nrwk += (2*(thee->pmgp->nf) + thee->pmgp->narr);
+    }
+
+    /* The Newton driver indexes the ion-accessible points on each level */
+    if ((thee->pmgp->meth == VSOL_Newton) ||
+        ((thee->pmgp->meth == VSOL_CGMG) && (thee->pmgp->nonlin != NONLIN_LPBE)))
+    {
+        thee->pmgp->niwk += (thee->pmgp->narr + thee->pmgp->nlev);
+    }
+
 
         if (thee->pmgp->iinfo > 1) {
             Vnm_print(2, "Vpmg_ctor2:  PMG chose nx = %d, ny = %d, nz = %d\n",
@@ -241,40 +899,7 @@ VPUBLIC int Vpmg_ctor2(Vpmg *thee, Vpmgp *pmgp, Vpbe *pbe, int focusFlag,
 
     if (focusFlag) {
 
-        /* Overwrite any default or user-specified boundary condition
-        * arguments; we are now committed to a calculation via focusing */
-        if (thee->pmgp->bcfl != BCFL_FOCUS) {
-            Vnm_print(2,
-                      "Vpmg_ctor2: reset boundary condition flag to BCFL_FOCUS!\n");
-            thee->pmgp->bcfl = BCFL_FOCUS;
-        }
-
-        /* Fill boundaries */
-        Vnm_print(0, "Vpmg_ctor2:  Filling boundary with old solution!\n");
-        focusFillBound(thee, pmgOLD);
-
-        /* Calculate energetic contributions from region outside focusing
-            * domain */
-        if (energyFlag != PCE_NO) {
-
-            if (mgparm->type == MCT_PARALLEL) {
-
-                for (j=0; j<3; j++) {
-                    partMin[j] = mgparm->partDisjCenter[j]
-                    - 0.5*mgparm->partDisjLength[j];
-                    partMax[j] = mgparm->partDisjCenter[j]
-                        + 0.5*mgparm->partDisjLength[j];
-                }
-
-            } else {
-                for (j=0; j<3; j++) {
-                    partMin[j] = mgparm->center[j] - 0.5*mgparm->glen[j];
-                    partMax[j] = mgparm->center[j] + 0.5*mgparm->glen[j];
-                }
-            }
-            extEnergy(thee, pmgOLD, energyFlag, partMin, partMax,
-                      mgparm->partDisjOwnSide);
-        }
+        focusSetup(thee, pmgOLD, mgparm, energyFlag);
 
     } else {
 
@@ -291,6 +916,8 @@ VPUBLIC int Vpmg_ctor2(Vpmg *thee, Vpmgp *pmgp, Vpbe *pbe, int focusFlag,
         size,
         sizeof(double)
         );
+    thee->apvec = VNULL;
+    thee->napvec = 0;
 
     /* Allocate remaining storage */
     thee->iparm  = (   int *)Vmem_malloc(thee->vmem,                100, sizeof(   int));
@@ -303,12 +930,13 @@ VPUBLIC int Vpmg_ctor2(Vpmg *thee, Vpmgp *pmgp, Vpbe *pbe, int focusFlag,
     thee->epsx   = (double *)Vmem_malloc(thee->vmem,   thee->pmgp->narr, sizeof(double));
     thee->epsy   = (double *)Vmem_malloc(thee->vmem,   thee->pmgp->narr, sizeof(double));
     thee->epsz   = (double *)Vmem_malloc(thee->vmem,   thee->pmgp->narr, sizeof(double));
-    thee->a1cf   = (double *)Vmem_malloc(thee->vmem,   thee->pmgp->narr, sizeof(double));
-    thee->a2cf   = (double *)Vmem_malloc(thee->vmem,   thee->pmgp->narr, sizeof(double));
-    thee->a3cf   = (double *)Vmem_malloc(thee->vmem,   thee->pmgp->narr, sizeof(double));
-    thee->ccf    = (double *)Vmem_malloc(thee->vmem,   thee->pmgp->narr, sizeof(double));
-    thee->fcf    = (double *)Vmem_malloc(thee->vmem,   thee->pmgp->narr, sizeof(double));
-    thee->tcf    = (double *)Vmem_malloc(thee->vmem,   thee->pmgp->narr, sizeof(double));
+    /* The solver coefficient arrays are only allocated by Vpmg_solve */
+    thee->a1cf   = VNULL;
+    thee->a2cf   = VNULL;
+    thee->a3cf   = VNULL;
+    thee->ccf    = VNULL;
+    thee->fcf    = VNULL;
+    thee->tcf    = VNULL;
     thee->u      = (double *)Vmem_malloc(thee->vmem,   thee->pmgp->narr, sizeof(double));
     thee->xf     = (double *)Vmem_malloc(thee->vmem, 5*(thee->pmgp->nx), sizeof(double));
     thee->yf     = (double *)Vmem_malloc(thee->vmem, 5*(thee->pmgp->ny), sizeof(double));
@@ -325,66 +953,29 @@ VPUBLIC int Vpmg_ctor2(Vpmg *thee, Vpmgp *pmgp, Vpbe *pbe, int focusFlag,
             &(thee->pmgp->mgprol), &(thee->pmgp->mgcoar), &(thee->pmgp->mgsolv),
             &(thee->pmgp->mgdisc), &(thee->pmgp->iinfo), &(thee->pmgp->errtol),
             &(thee->pmgp->ipkey), &(thee->pmgp->omegal), &(thee->pmgp->omegan),
-            &(thee->pmgp->irite), &(thee->pmgp->iperf));
-
-
-
-    /* Currently for SMPBE type calculations we do not want to apply a scale
-        factor to the ionConc */
-    /** @note  The fortran replacement functions are run along side the old
-     *         fortran functions.  This is due to the use of common variables
-     *         in the fortran sub-routines.  Once the fortran code has been
-     *         successfully excised, these functions will no longer need to be
-     *         called in tandem, and the fortran version may be dropped
-     */
-    switch(pmgp->ipkey){
-
-        case IPKEY_SMPBE:
-
-                        Vmypdefinitsmpbe(&nion, ionQ, ionConc, &pbe->smvolume, &pbe->smsize);
-            break;
-
-
-
-        case IPKEY_NPBE:
-
-            /* Else adjust the inoConc by scaling factor zks2 */
-            for (i=0; i<nion; i++)
-                ionConc[i] = zks2 * ionConc[i];
-
-                        Vmypdefinitnpbe(&nion, ionQ, ionConc);
-            break;
-
-
-
-        case IPKEY_LPBE:
-
-            /* Else adjust the inoConc by scaling factor zks2 */
-            for (i=0; i<nion; i++)
-                            ionConc[i] = zks2 * ionConc[i];
-
-            Vmypdefinitlpbe(&nion, ionQ, ionConc);
-            break;
+            &(thee->pmgp->irite), &(thee->pmgp->iperf), &(thee->pmgp->mgprec),
+            &(thee->pmgp->mgcach), &(thee->pmgp->mgfree));
 
 
 
-        default:
-            Vnm_print(2, "PMG: Warning: PBE structure not initialized!\n");
-            /* Else adjust the inoConc by scaling factor zks2 */
-            for (i=0; i<nion; i++)
-                ionConc[i] = zks2 * ionConc[i];
-            break;
-    }
+    /* Initialize ion concentrations and valencies in PMG routines */
+    initIons(thee);
 
     /* Set the default chargeSrc for 5th order splines */
     thee->chargeSrc = mgparm->chgs;
 
+    /* A slab of a distributed mesh only sees part of the molecule */
+    thee->distrib = mgparm->distrib;
+
     /* Turn off restriction of observable calculations to a specific
     * partition */
     Vpmg_unsetPart(thee);
 
     /* The coefficient arrays have not been filled */
     thee->filled = 0;
+    thee->keepCoef = 0;
+    thee->coefKey = 0;
+    thee->zeroIters = -1;
 
 
     /*
@@ -393,45 +984,106 @@ VPUBLIC int Vpmg_ctor2(Vpmg *thee, Vpmgp *pmgp, Vpbe *pbe, int focusFlag,
      *       has been removed from initMG and placed back here to keep memory
      *       usage low. killMG has been modified accordingly.
      */
+    /* Start from the coarser solution if asked to, while it is still
+     * around */
+    if (focusFlag && ((mgparm->guess == MGG_FOCUS)
+                      || (mgparm->guess == MGG_PREVIOUS))) {
+        Vpmg_setGuess(thee, pmgOLD);
+    }
+
     Vpmg_dtor(&pmgOLD);
 
     return 1;
 }
 
-VPUBLIC int Vpmg_solve(Vpmg *thee) {
+VPUBLIC int Vpmg_update(Vpmg *thee, Vpbe *pbe, Vpmg *pmgOLD,
+                        MGparm *mgparm, PBEparm_calcEnergy energyFlag) {
 
-    int i,
-        nx,
-        ny,
-        nz,
-        n;
-    double zkappa2;
+    VASSERT(thee != VNULL);
+    VASSERT(pbe != VNULL);
 
-    nx = thee->pmgp->nx;
-    ny = thee->pmgp->ny;
-    nz = thee->pmgp->nz;
-    n = nx*ny*nz;
+    /* The mesh, the work arrays and the solution stay; only the problem
+     * description changes */
+    thee->pbe = pbe;
 
-    if (!(thee->filled)) {
-        Vnm_print(2, "Vpmg_solve:  Need to call Vpmg_fillco()!\n");
-        return 0;
-    }
+    /* The ion parameters of the PMG routines are shared by all Vpmg
+     * objects, so they must be set again for this one */
+    initIons(thee);
 
-    /* Fill the "true solution" array */
-    for (i=0; i<n; i++) {
-        thee->tcf[i] = 0.0;
+    if (pmgOLD != VNULL) {
+        focusSetup(thee, pmgOLD, mgparm, energyFlag);
+    } else {
+        if (thee->pmgp->bcfl == BCFL_FOCUS) {
+            Vnm_print(2, "Vpmg_update:  Focusing needs the coarser solution!\n");
+            return 0;
+        }
+        thee->extQmEnergy = 0;
+        thee->extDiEnergy = 0;
+        thee->extQfEnergy = 0;
     }
 
-    /* Fill the RHS array */
-    for (i=0; i<n; i++) {
-        thee->fcf[i] = thee->charge[i];
-    }
+    Vpmg_unsetPart(thee);
+    thee->filled = 0;
+    thee->keepCoef = 0;
+    thee->coefKey = 0;
+
+    /* Start the next solve from the current solution */
+    VAT(thee->iparm, 30) = 1;
+
+    return 1;
+}
+
+VPUBLIC int Vpmg_setGuess(Vpmg *thee, Vpmg *pmgOLD) {
+
+    int nx,
+        ny,
+        nz;
+    double hx,
+           hy,
+           hzed;
+
+    VASSERT(thee != VNULL);
+    VASSERT(pmgOLD != VNULL);
+
+    nx = pmgOLD->pmgp->nx;
+    ny = pmgOLD->pmgp->ny;
+    nz = pmgOLD->pmgp->nz;
+    hx = pmgOLD->pmgp->hx;
+    hy = pmgOLD->pmgp->hy;
+    hzed = pmgOLD->pmgp->hzed;
+
+    return guessFill(thee, nx, ny, nz, hx, hy, hzed,
+                     pmgOLD->pmgp->xcent - ((double)(nx-1)*hx)/2.0,
+                     pmgOLD->pmgp->ycent - ((double)(ny-1)*hy)/2.0,
+                     pmgOLD->pmgp->zcent - ((double)(nz-1)*hzed)/2.0,
+                     pmgOLD->u);
+}
+
+VPUBLIC int Vpmg_setGuessMap(Vpmg *thee, Vgrid *potMap) {
+
+    VASSERT(thee != VNULL);
+    VASSERT(potMap != VNULL);
+
+    return guessFill(thee, potMap->nx, potMap->ny, potMap->nz,
+                     potMap->hx, potMap->hy, potMap->hzed,
+                     potMap->xmin, potMap->ymin, potMap->zmin,
+                     potMap->data);
+}
+
+/* Fill the operator coefficient arrays of a solve from the dielectric and
+ * kappa maps */
+VPRIVATE void solveCoef(Vpmg *thee, double *a1cf, double *a2cf,
+                        double *a3cf, double *ccf) {
+
+    int i, n;
+    double zkappa2;
+
+    n = (thee->pmgp->nx)*(thee->pmgp->ny)*(thee->pmgp->nz);
 
-    /* Fill the operator coefficient array. */
     for (i=0; i<n; i++) {
-        thee->a1cf[i] = thee->epsx[i];
-        thee->a2cf[i] = thee->epsy[i];
-        thee->a3cf[i] = thee->epsz[i];
+        a1cf[i] = thee->epsx[i];
+        a2cf[i] = thee->epsy[i];
+        a3cf[i] = thee->epsz[i];
     }
 
     /* Fill the nonlinear coefficient array by multiplying the kappa
@@ -439,22 +1091,45 @@ VPUBLIC int Vpmg_solve(Vpmg *thee) {
     zkappa2 = Vpbe_getZkappa2(thee->pbe);
     if (zkappa2 > VPMGSMALL) {
         for (i=0; i<n; i++) {
-            thee->ccf[i] = zkappa2*thee->kappa[i];
+            ccf[i] = zkappa2*thee->kappa[i];
         }
     } else {
         for (i=0; i<n; i++) {
-            thee->ccf[i] = 0.0;
+            ccf[i] = 0.0;
         }
     }
+}
 
+/* The linear multigrid driver never writes the RHS (unless it is asked to
+ * build an algebraic one), so there the charge map can be used directly */
+VPRIVATE int solveAliasRHS(Vpmg *thee) {
+
+    return (thee->pmgp->meth == VSOL_MG)
+        && (thee->pmgp->nonlin == NONLIN_LPBE)
+        && (thee->pmgp->istop != 4) && (thee->pmgp->istop != 5)
+        && (thee->pmgp->iperf == 0);
+}
+
+/* Run the solver selected by thee->pmgp->meth on the given work arrays */
+VPRIVATE int solveDriv(Vpmg *thee, int *iparm, double *rparm, int *iwork,
+                       double *rwork, double *u, double *gxcf, double *gycf,
+                       double *gzcf, double *a1cf, double *a2cf, double *a3cf,
+                       double *ccf, double *fcf, double *tcf) {
+
+    int rc;
+
+    rc = 1;
     switch(thee->pmgp->meth) {
-        /* CGMG (linear) */
+        /* CGMG (linear/nonlinear) */
         case VSOL_CGMG:
 
             if (thee->pmgp->iinfo > 1)
                 Vnm_print(2, "Driving with CGMGDRIV\n");
 
-            VABORT_MSG0("CGMGDRIV is not currently supported");
+            Vcgmgdriv(iparm, rparm, iwork, rwork,
+                       u, thee->xf, thee->yf, thee->zf, gxcf, gycf,
+                       gzcf, a1cf, a2cf, a3cf, ccf,
+                       fcf, tcf);
             break;
 
         /* Newton (nonlinear) */
@@ -464,10 +1139,10 @@ VPUBLIC int Vpmg_solve(Vpmg *thee) {
                 Vnm_print(2, "Driving with NEWDRIV\n");
 
             Vnewdriv
-                      (thee->iparm, thee->rparm, thee->iwork, thee->rwork,
-                       thee->u, thee->xf, thee->yf, thee->zf, thee->gxcf, thee->gycf,
-                       thee->gzcf, thee->a1cf, thee->a2cf, thee->a3cf, thee->ccf,
-                       thee->fcf, thee->tcf);
+                      (iparm, rparm, iwork, rwork,
+                       u, thee->xf, thee->yf, thee->zf, gxcf, gycf,
+                       gzcf, a1cf, a2cf, a3cf, ccf,
+                       fcf, tcf);
             break;
 
         /* MG (linear/nonlinear) */
@@ -476,87 +1151,469 @@ VPUBLIC int Vpmg_solve(Vpmg *thee) {
             if (thee->pmgp->iinfo > 1)
                 Vnm_print(2, "Driving with MGDRIV\n");
 
-            Vmgdriv(thee->iparm, thee->rparm, thee->iwork, thee->rwork,
-                                        thee->u, thee->xf, thee->yf, thee->zf, thee->gxcf, thee->gycf,
-                                        thee->gzcf, thee->a1cf, thee->a2cf, thee->a3cf, thee->ccf,
-                                        thee->fcf, thee->tcf);
+            Vmgdriv(iparm, rparm, iwork, rwork,
+                                        u, thee->xf, thee->yf, thee->zf, gxcf, gycf,
+                                        gzcf, a1cf, a2cf, a3cf, ccf,
+                                        fcf, tcf);
             break;
 
         /* CGHS (linear/nonlinear) */
         case VSOL_CG:
 
-            if (thee->pmgp->iinfo > 1)
-                Vnm_print(2, "Driving with NCGHSDRIV\n");
+            if (thee->pmgp->iinfo > 1)
+                Vnm_print(2, "Driving with NCGHSDRIV\n");
+
+            VABORT_MSG0("NCGHSDRIV is not currently supported");
+            break;
+
+        /* SOR (linear/nonlinear) */
+        case VSOL_SOR:
+
+            if (thee->pmgp->iinfo > 1)
+                Vnm_print(2, "Driving with NSORDRIV\n");
+
+            VABORT_MSG0("NSORDRIV is not currently supported");
+            break;
+
+        /* GSRB (linear/nonlinear) */
+        case VSOL_RBGS:
+
+            if (thee->pmgp->iinfo > 1)
+                Vnm_print(2, "Driving with NGSRBDRIV\n");
+
+            VABORT_MSG0("NGSRBDRIV is not currently supported");
+            break;
+
+        /* WJAC (linear/nonlinear) */
+        case VSOL_WJ:
+
+            if (thee->pmgp->iinfo > 1)
+                Vnm_print(2, "Driving with NWJACDRIV\n");
+
+            VABORT_MSG0("NWJACDRIV is not currently supported");
+            break;
+
+        /* RICH (linear/nonlinear) */
+        case VSOL_Richardson:
+
+            if (thee->pmgp->iinfo > 1)
+                Vnm_print(2, "Driving with NRICHDRIV\n");
+
+            VABORT_MSG0("NRICHDRIV is not currently supported");
+            break;
+
+        /* CGMG (linear) TEMPORARY USEAQUA */
+        case VSOL_CGMGAqua:
+
+            if (thee->pmgp->iinfo > 1)
+                Vnm_print(2, "Driving with CGMGDRIVAQUA\n");
+
+            VABORT_MSG0("CGMGDRIVAQUA is not currently supported");
+            break;
+
+        /* Newton (nonlinear) TEMPORARY USEAQUA */
+        case VSOL_NewtonAqua:
+
+            if (thee->pmgp->iinfo > 1)
+                Vnm_print(2, "Driving with NEWDRIVAQUA\n");
+
+            VABORT_MSG0("NEWDRIVAQUA is not currently supported");
+            break;
+
+        /* Error handling */
+        default:
+            Vnm_print(2, "Vpmg_solve: invalid solver method key (%d)\n",
+              thee->pmgp->key);
+            rc = 0;
+            break;
+    }
+
+    return rc;
+}
+
+VPUBLIC int Vpmg_solve(Vpmg *thee) {
+
+    int i,
+        nx,
+        ny,
+        nz,
+        n,
+        narr,
+        aliasRHS,
+        rc;
+
+    nx = thee->pmgp->nx;
+    ny = thee->pmgp->ny;
+    nz = thee->pmgp->nz;
+    n = nx*ny*nz;
+    narr = thee->pmgp->narr;
+
+    if (!(thee->filled)) {
+        Vnm_print(2, "Vpmg_solve:  Need to call Vpmg_fillco()!\n");
+        return 0;
+    }
+
+    /* The drivers use the operator coefficient arrays as multigrid
+     * workspace once the operators are built, so they cannot alias the
+     * dielectric and kappa maps that the observables read afterwards.
+     * They are allocated for the duration of the solve only. */
+    aliasRHS = solveAliasRHS(thee);
+    thee->a1cf = (double *)Vmem_malloc(thee->vmem, narr, sizeof(double));
+    thee->a2cf = (double *)Vmem_malloc(thee->vmem, narr, sizeof(double));
+    thee->a3cf = (double *)Vmem_malloc(thee->vmem, narr, sizeof(double));
+    thee->ccf  = (double *)Vmem_malloc(thee->vmem, narr, sizeof(double));
+    thee->tcf  = (double *)Vmem_malloc(thee->vmem, narr, sizeof(double));
+    if (aliasRHS) {
+        thee->fcf = thee->charge;
+    } else {
+        thee->fcf = (double *)Vmem_malloc(thee->vmem, narr, sizeof(double));
+    }
+
+    /* Fill the "true solution" array */
+    for (i=0; i<n; i++) {
+        thee->tcf[i] = 0.0;
+    }
+
+    /* Fill the RHS array */
+    if (!aliasRHS) {
+        for (i=0; i<n; i++) {
+            thee->fcf[i] = thee->charge[i];
+        }
+    }
+
+    /* Fill the operator coefficient array. */
+    solveCoef(thee, thee->a1cf, thee->a2cf, thee->a3cf, thee->ccf);
+
+    rc = solveDriv(thee, thee->iparm, thee->rparm, thee->iwork, thee->rwork,
+                   thee->u, thee->gxcf, thee->gycf, thee->gzcf,
+                   thee->a1cf, thee->a2cf, thee->a3cf, thee->ccf,
+                   thee->fcf, thee->tcf);
+
+    Vmem_free(thee->vmem, narr, sizeof(double), (void **)&(thee->a1cf));
+    Vmem_free(thee->vmem, narr, sizeof(double), (void **)&(thee->a2cf));
+    Vmem_free(thee->vmem, narr, sizeof(double), (void **)&(thee->a3cf));
+    Vmem_free(thee->vmem, narr, sizeof(double), (void **)&(thee->ccf));
+    Vmem_free(thee->vmem, narr, sizeof(double), (void **)&(thee->tcf));
+    if (aliasRHS) {
+        thee->fcf = VNULL;
+    } else {
+        Vmem_free(thee->vmem, narr, sizeof(double), (void **)&(thee->fcf));
+    }
+
+    return rc;
+
+}
+
+/* Work arrays of one right-hand side of Vpmg_solveMulti.  The maps and the
+ * mesh are shared; everything the solver writes is private, so several
+ * right-hand sides can be solved at once. */
+typedef struct sVpmgRhs {
+    int *iparm;  /* Solver parameters */
+    double *rparm;  /* Solver parameters */
+    int *iwork;  /* Integer work array */
+    double *rwork;  /* Real work array, with the multigrid operators */
+    double *u;  /* Solution */
+    double *charge;  /* Charge map */
+    double *fcf;  /* RHS; the charge map itself if the driver keeps it */
+    double *gxcf;  /* Boundary values */
+    double *gycf;  /* Boundary values */
+    double *gzcf;  /* Boundary values */
+    double *a1cf;  /* Operator coefficients and workspace */
+    double *a2cf;  /* Operator coefficients and workspace */
+    double *a3cf;  /* Operator coefficients and workspace */
+    double *ccf;  /* Operator coefficients and workspace */
+    double *tcf;  /* True solution and workspace */
+} VpmgRhs;
+
+/* Allocate the work arrays of a right-hand side and copy the solver state,
+ * including any operators kept in the work arrays, from thee */
+VPRIVATE void solveMultiCtor(Vpmg *thee, VpmgRhs *rhs) {
+
+    Vmem *mem;
+    int i, nx, ny, nz, narr;
+    size_t k;
+
+    mem = thee->vmem;
+    nx = thee->pmgp->nx;
+    ny = thee->pmgp->ny;
+    nz = thee->pmgp->nz;
+    narr = thee->pmgp->narr;
+
+    rhs->iparm = (int *)Vmem_malloc(mem, 100, sizeof(int));
+    rhs->rparm = (double *)Vmem_malloc(mem, 100, sizeof(double));
+    rhs->iwork = (int *)Vmem_malloc(mem, thee->pmgp->niwk, sizeof(int));
+    rhs->rwork = (double *)Vmem_malloc(mem, thee->pmgp->nrwk, sizeof(double));
+    rhs->u = (double *)Vmem_malloc(mem, narr, sizeof(double));
+    rhs->charge = (double *)Vmem_malloc(mem, narr, sizeof(double));
+    rhs->gxcf = (double *)Vmem_malloc(mem, 10*ny*nz, sizeof(double));
+    rhs->gycf = (double *)Vmem_malloc(mem, 10*nx*nz, sizeof(double));
+    rhs->gzcf = (double *)Vmem_malloc(mem, 10*nx*ny, sizeof(double));
+    rhs->a1cf = (double *)Vmem_malloc(mem, narr, sizeof(double));
+    rhs->a2cf = (double *)Vmem_malloc(mem, narr, sizeof(double));
+    rhs->a3cf = (double *)Vmem_malloc(mem, narr, sizeof(double));
+    rhs->ccf = (double *)Vmem_malloc(mem, narr, sizeof(double));
+    rhs->tcf = (double *)Vmem_malloc(mem, narr, sizeof(double));
+    if (solveAliasRHS(thee)) {
+        rhs->fcf = rhs->charge;
+    } else {
+        rhs->fcf = (double *)Vmem_malloc(mem, narr, sizeof(double));
+    }
+
+    for (i=0; i<100; i++) rhs->iparm[i] = thee->iparm[i];
+    for (i=0; i<100; i++) rhs->rparm[i] = thee->rparm[i];
+    for (i=0; i<thee->pmgp->niwk; i++) rhs->iwork[i] = thee->iwork[i];
+    for (k=0; k<thee->pmgp->nrwk; k++) rhs->rwork[k] = thee->rwork[k];
+    for (i=0; i<narr; i++) rhs->u[i] = 0.0;
+
+    /* Keep the operators between the solves and start each from zero */
+    VAT(rhs->iparm, 24) = 1;
+    VAT(rhs->iparm, 30) = 0;
+}
+
+VPRIVATE void solveMultiDtor(Vpmg *thee, VpmgRhs *rhs) {
+
+    Vmem *mem;
+    int nx, ny, nz, narr;
+
+    mem = thee->vmem;
+    nx = thee->pmgp->nx;
+    ny = thee->pmgp->ny;
+    nz = thee->pmgp->nz;
+    narr = thee->pmgp->narr;
+
+    if (rhs->fcf != rhs->charge) {
+        Vmem_free(mem, narr, sizeof(double), (void **)&(rhs->fcf));
+    }
+    Vmem_free(mem, 100, sizeof(int), (void **)&(rhs->iparm));
+    Vmem_free(mem, 100, sizeof(double), (void **)&(rhs->rparm));
+    Vmem_free(mem, thee->pmgp->niwk, sizeof(int), (void **)&(rhs->iwork));
+    Vmem_free(mem, thee->pmgp->nrwk, sizeof(double), (void **)&(rhs->rwork));
+    Vmem_free(mem, narr, sizeof(double), (void **)&(rhs->u));
+    Vmem_free(mem, narr, sizeof(double), (void **)&(rhs->charge));
+    Vmem_free(mem, 10*ny*nz, sizeof(double), (void **)&(rhs->gxcf));
+    Vmem_free(mem, 10*nx*nz, sizeof(double), (void **)&(rhs->gycf));
+    Vmem_free(mem, 10*nx*ny, sizeof(double), (void **)&(rhs->gzcf));
+    Vmem_free(mem, narr, sizeof(double), (void **)&(rhs->a1cf));
+    Vmem_free(mem, narr, sizeof(double), (void **)&(rhs->a2cf));
+    Vmem_free(mem, narr, sizeof(double), (void **)&(rhs->a3cf));
+    Vmem_free(mem, narr, sizeof(double), (void **)&(rhs->ccf));
+    Vmem_free(mem, narr, sizeof(double), (void **)&(rhs->tcf));
+}
+
+/* Give the atoms one set of charges */
+VPRIVATE void solveMultiCharges(Vpmg *thee, double *charges) {
+
+    Valist *alist;
+    int i;
+
+    alist = thee->pbe->alist;
+    for (i=0; i<Valist_getNumberAtoms(alist); i++) {
+        Vatom_setCharge(Valist_getAtom(alist, i), charges[i]);
+    }
+}
+
+/* Swap the charge, boundary and solution arrays of thee with those of a
+ * right-hand side, so the fill and energy routines work on the latter */
+VPRIVATE void solveMultiSwap(Vpmg *thee, VpmgRhs *rhs) {
 
-            VABORT_MSG0("NCGHSDRIV is not currently supported");
-            break;
+    double *tmp;
 
-        /* SOR (linear/nonlinear) */
-        case VSOL_SOR:
+    tmp = thee->charge; thee->charge = rhs->charge; rhs->charge = tmp;
+    tmp = thee->gxcf; thee->gxcf = rhs->gxcf; rhs->gxcf = tmp;
+    tmp = thee->gycf; thee->gycf = rhs->gycf; rhs->gycf = tmp;
+    tmp = thee->gzcf; thee->gzcf = rhs->gzcf; rhs->gzcf = tmp;
+    tmp = thee->u; thee->u = rhs->u; rhs->u = tmp;
+}
 
-            if (thee->pmgp->iinfo > 1)
-                Vnm_print(2, "Driving with NSORDRIV\n");
+/* Solve one right-hand side; only touches the arrays of rhs */
+VPRIVATE int solveMultiSolve(Vpmg *thee, VpmgRhs *rhs) {
 
-            VABORT_MSG0("NSORDRIV is not currently supported");
-            break;
+    int i, n;
 
-        /* GSRB (linear/nonlinear) */
-        case VSOL_RBGS:
+    n = (thee->pmgp->nx)*(thee->pmgp->ny)*(thee->pmgp->nz);
+    for (i=0; i<n; i++) rhs->tcf[i] = 0.0;
+    if (rhs->fcf != rhs->charge) {
+        for (i=0; i<n; i++) rhs->fcf[i] = rhs->charge[i];
+    }
+    solveCoef(thee, rhs->a1cf, rhs->a2cf, rhs->a3cf, rhs->ccf);
 
-            if (thee->pmgp->iinfo > 1)
-                Vnm_print(2, "Driving with NGSRBDRIV\n");
+    return solveDriv(thee, rhs->iparm, rhs->rparm, rhs->iwork, rhs->rwork,
+                     rhs->u, rhs->gxcf, rhs->gycf, rhs->gzcf,
+                     rhs->a1cf, rhs->a2cf, rhs->a3cf, rhs->ccf,
+                     rhs->fcf, rhs->tcf);
+}
 
-            VABORT_MSG0("NGSRBDRIV is not currently supported");
-            break;
+VPUBLIC int Vpmg_solveMulti(Vpmg *thee, int nrhs, double *charges,
+                            int nblock, double *energy, double *atomPot) {
 
-        /* WJAC (linear/nonlinear) */
-        case VSOL_WJ:
+    VpmgRhs *rhs;
+    Valist *alist;
+    Vgrid *grid;
+    double *saved,
+           value;
+    int i,
+        j,
+        irhs,
+        iblk,
+        nblk,
+        first,
+        natoms,
+        ok;
+    size_t k;
 
-            if (thee->pmgp->iinfo > 1)
-                Vnm_print(2, "Driving with NWJACDRIV\n");
+    VASSERT(thee != VNULL);
 
-            VABORT_MSG0("NWJACDRIV is not currently supported");
-            break;
+    if (!(thee->filled)) {
+        Vnm_print(2, "Vpmg_solveMulti:  Need to call Vpmg_fillco()!\n");
+        return 0;
+    }
+    if (thee->useChargeMap) {
+        Vnm_print(2, "Vpmg_solveMulti:  Can't replace the charges of a charge map!\n");
+        return 0;
+    }
+    if (thee->pmgp->bcfl == BCFL_FOCUS) {
+        Vnm_print(2, "Vpmg_solveMulti:  Can't solve other charges with focusing boundary values!\n");
+        return 0;
+    }
+    if (nrhs <= 0) return 1;
+    if (nblock < 1) nblock = 1;
+    if (nblock > nrhs) nblock = nrhs;
 
-        /* RICH (linear/nonlinear) */
-        case VSOL_Richardson:
+    alist = thee->pbe->alist;
+    natoms = Valist_getNumberAtoms(alist);
+    saved = (double *)Vmem_malloc(thee->vmem, VMAX2(natoms, 1),
+                                  sizeof(double));
+    for (i=0; i<natoms; i++) {
+        saved[i] = Vatom_getCharge(Valist_getAtom(alist, i));
+    }
 
-            if (thee->pmgp->iinfo > 1)
-                Vnm_print(2, "Driving with NRICHDRIV\n");
+    rhs = (VpmgRhs *)Vmem_malloc(thee->vmem, nblock, sizeof(VpmgRhs));
+    for (j=0; j<nblock; j++) solveMultiCtor(thee, &(rhs[j]));
 
-            VABORT_MSG0("NRICHDRIV is not currently supported");
-            break;
+    /* If thee did not keep its operators, the first solve builds them and
+     * the other right-hand sides take them from it */
+    first = (VAT(thee->iparm, 25) != 1);
 
-        /* CGMG (linear) TEMPORARY USEAQUA */
-        case VSOL_CGMGAqua:
+    ok = 1;
+    for (irhs=0; (irhs<nrhs) && ok; irhs+=nblock) {
 
-            if (thee->pmgp->iinfo > 1)
-                Vnm_print(2, "Driving with CGMGDRIVAQUA\n");
+        nblk = VMIN2(nblock, nrhs-irhs);
 
-            VABORT_MSG0("CGMGDRIVAQUA is not currently supported");
-            break;
+        /* The charge maps and boundary values are filled from the atoms,
+         * one right-hand side at a time */
+        for (j=0; j<nblk; j++) {
+            solveMultiCharges(thee, charges + (irhs+j)*natoms);
+            solveMultiSwap(thee, &(rhs[j]));
+            if (fillcoCharge(thee) == VRC_FAILURE) ok = 0;
+            if (ok) bcCalc(thee);
+            solveMultiSwap(thee, &(rhs[j]));
+        }
+        if (!ok) break;
 
-        /* Newton (nonlinear) TEMPORARY USEAQUA */
-        case VSOL_NewtonAqua:
+        iblk = 0;
+        if (first) {
+            if (!solveMultiSolve(thee, &(rhs[0]))) {
+                ok = 0;
+                break;
+            }
+            for (j=1; j<nblock; j++) {
+                for (i=0; i<thee->pmgp->niwk; i++) {
+                    rhs[j].iwork[i] = rhs[0].iwork[i];
+                }
+                for (k=0; k<thee->pmgp->nrwk; k++) {
+                    rhs[j].rwork[k] = rhs[0].rwork[k];
+                }
+                for (i=24; i<27; i++) rhs[j].iparm[i] = rhs[0].iparm[i];
+            }
+            first = 0;
+            iblk = 1;
+        }
 
-            if (thee->pmgp->iinfo > 1)
-                Vnm_print(2, "Driving with NEWDRIVAQUA\n");
+        /* The right-hand sides of a block are independent; the solver loops
+         * inside each run on its own thread */
+#pragma omp parallel for default(shared) private(j) schedule(dynamic,1) \
+        reduction(&&:ok)
+        for (j=iblk; j<nblk; j++) {
+            ok = solveMultiSolve(thee, &(rhs[j])) && ok;
+        }
+        if (!ok) break;
+
+        for (j=0; j<nblk; j++) {
+            solveMultiCharges(thee, charges + (irhs+j)*natoms);
+            solveMultiSwap(thee, &(rhs[j]));
+            if (energy != VNULL) energy[irhs+j] = Vpmg_energy(thee, 1);
+            if (atomPot != VNULL) {
+                grid = Vgrid_ctor(thee->pmgp->nx, thee->pmgp->ny,
+                                  thee->pmgp->nz, thee->pmgp->hx,
+                                  thee->pmgp->hy, thee->pmgp->hzed,
+                                  thee->pmgp->xmin, thee->pmgp->ymin,
+                                  thee->pmgp->zmin, thee->u);
+                for (i=0; i<natoms; i++) {
+                    if (!Vgrid_value(grid, Vatom_getPosition(
+                                     Valist_getAtom(alist, i)), &value)) {
+                        value = 0.0;
+                    }
+                    atomPot[(irhs+j)*natoms + i] = value;
+                }
+                Vgrid_dtor(&grid);
+            }
+            solveMultiSwap(thee, &(rhs[j]));
+        }
+    }
 
-            VABORT_MSG0("NEWDRIVAQUA is not currently supported");
-            break;
+    for (j=0; j<nblock; j++) solveMultiDtor(thee, &(rhs[j]));
+    Vmem_free(thee->vmem, nblock, sizeof(VpmgRhs), (void **)&rhs);
 
-        /* Error handling */
-        default:
-            Vnm_print(2, "Vpmg_solve: invalid solver method key (%d)\n",
-              thee->pmgp->key);
-            return 0;
-            break;
+    solveMultiCharges(thee, saved);
+    Vmem_free(thee->vmem, VMAX2(natoms, 1), sizeof(double), (void **)&saved);
+
+    if (!ok) {
+        Vnm_print(2, "Vpmg_solveMulti:  Failed to solve right-hand side %d!\n",
+                  irhs+1);
     }
+    return ok;
+}
 
-    return 1;
 
-}
+VPUBLIC void Vpmg_printMemChk(Vpmg *thee, int unit) {
 
+    int i, nx, ny, nz, narr, nsolve;
+    double mb, bytes[12];
+    const char *name[12] = {
+        "charge", "kappa", "pot", "epsx", "epsy", "epsz", "u", "pvec/apvec",
+        "gxcf/gycf/gzcf", "xf/yf/zf", "rwork", "iwork"
+    };
+
+    VASSERT(thee != VNULL);
+
+    nx = thee->pmgp->nx;
+    ny = thee->pmgp->ny;
+    nz = thee->pmgp->nz;
+    narr = thee->pmgp->narr;
+    mb = 1024.*1024.;
+
+    for (i=0; i<7; i++) bytes[i] = (double)narr*sizeof(double);
+    bytes[7] = (double)(nx*ny*nz + thee->napvec)*sizeof(double);
+    bytes[8] = 10.0*(ny*nz + nx*nz + nx*ny)*sizeof(double);
+    bytes[9] = 5.0*(nx + ny + nz)*sizeof(double);
+    bytes[10] = (double)thee->pmgp->nrwk*sizeof(double);
+    bytes[11] = (double)thee->pmgp->niwk*sizeof(int);
+
+    Vnm_print(unit, "Vpmg_memChk:  %4.3f MB held by this object\n",
+      (double)Vpmg_memChk(thee)/mb);
+    for (i=0; i<12; i++) {
+        Vnm_print(unit, "Vpmg_memChk:    %-16s %10.3f MB\n", name[i],
+          bytes[i]/mb);
+    }
+    /* See Vpmg_solve: linear multigrid reads the charge map directly */
+    nsolve = 6;
+    if ((thee->pmgp->meth == VSOL_MG)
+      && (thee->pmgp->nonlin == NONLIN_LPBE)
+      && (thee->pmgp->istop != 4) && (thee->pmgp->istop != 5)
+      && (thee->pmgp->iperf == 0)) nsolve = 5;
+    Vnm_print(unit, "Vpmg_memChk:    %-16s %10.3f MB (during solve only)\n",
+      "solver coeffs", (double)nsolve*narr*sizeof(double)/mb);
+}
 
 VPUBLIC void Vpmg_dtor(Vpmg **thee) {
 
@@ -592,18 +1649,6 @@ VPUBLIC void Vpmg_dtor2(Vpmg *thee) {
       (void **)&(thee->epsy));
     Vmem_free(thee->vmem, thee->pmgp->narr, sizeof(double),
       (void **)&(thee->epsz));
-    Vmem_free(thee->vmem, thee->pmgp->narr, sizeof(double),
-      (void **)&(thee->a1cf));
-    Vmem_free(thee->vmem, thee->pmgp->narr, sizeof(double),
-      (void **)&(thee->a2cf));
-    Vmem_free(thee->vmem, thee->pmgp->narr, sizeof(double),
-      (void **)&(thee->a3cf));
-    Vmem_free(thee->vmem, thee->pmgp->narr, sizeof(double),
-      (void **)&(thee->ccf));
-    Vmem_free(thee->vmem, thee->pmgp->narr, sizeof(double),
-      (void **)&(thee->fcf));
-    Vmem_free(thee->vmem, thee->pmgp->narr, sizeof(double),
-      (void **)&(thee->tcf));
     Vmem_free(thee->vmem, thee->pmgp->narr, sizeof(double),
       (void **)&(thee->u));
     Vmem_free(thee->vmem, 5*(thee->pmgp->nx), sizeof(double),
@@ -620,6 +1665,10 @@ VPUBLIC void Vpmg_dtor2(Vpmg *thee) {
       (void **)&(thee->gzcf));
     Vmem_free(thee->vmem, (thee->pmgp->nx)*(thee->pmgp->ny)*(thee->pmgp->nz),
       sizeof(double), (void **)&(thee->pvec));
+    if (thee->apvec != VNULL) {
+        Vmem_free(thee->vmem, thee->napvec, sizeof(double),
+          (void **)&(thee->apvec));
+    }
 
     Vmem_dtor(&(thee->vmem));
 }
@@ -650,6 +1699,7 @@ VPUBLIC void Vpmg_setPart(Vpmg *thee, double lowerCorner[3],
     /* We need have called Vpmg_fillco first */
 
     alist = thee->pbe->alist;
+    sizeAtomPart(thee);
 
     Vnm_print(0, "Vpmg_setPart:  lower corner = (%g, %g, %g)\n",
       lowerCorner[0], lowerCorner[1], lowerCorner[2]);
@@ -720,7 +1770,7 @@ VPUBLIC void Vpmg_setPart(Vpmg *thee, double lowerCorner[3],
             else zok = 0;
         }
 
-        atom->partID = xok*yok*zok;
+        thee->apvec[i] = xok*yok*zok;
         /*
         Vnm_print(1, "DEBUG (%s, %d):  atom->position[0] - upperCorner[0] = %g\n",
                   __FILE__, __LINE__, atom->position[0] - upperCorner[0]);
@@ -872,21 +1922,16 @@ VPUBLIC void Vpmg_setPart(Vpmg *thee, double lowerCorner[3],
 VPUBLIC void Vpmg_unsetPart(Vpmg *thee) {
 
     int i, nx, ny, nz;
-    Vatom *atom;
-    Valist *alist;
 
     VASSERT(thee != VNULL);
 
     nx = thee->pmgp->nx;
     ny = thee->pmgp->ny;
     nz = thee->pmgp->nz;
-    alist = thee->pbe->alist;
 
+    sizeAtomPart(thee);
     for (i=0; i<(nx*ny*nz); i++) thee->pvec[i] = 1;
-    for (i=0; i<Valist_getNumberAtoms(alist); i++) {
-        atom = Valist_getAtom(alist, i);
-        atom->partID = 1;
-    }
+    for (i=0; i<thee->napvec; i++) thee->apvec[i] = 1;
 }
 
 VPUBLIC int Vpmg_fillArray(Vpmg *thee, double *vec, Vdata_Type type,
@@ -1756,7 +2801,7 @@ VPRIVATE double Vpmg_qfEnergyPoint(Vpmg *thee,
         khi = (int)ceil(kfloat);
         klo = (int)floor(kfloat);
 
-        if (atom->partID > 0) {
+        if (thee->apvec[iatom] > 0) {
 
             if ((ihi<nx) && (jhi<ny) && (khi<nz) &&
                 (ilo>=0) && (jlo>=0) && (klo>=0)) {
@@ -1774,8 +2819,8 @@ VPRIVATE double Vpmg_qfEnergyPoint(Vpmg *thee,
                 + (1.0-dx)*(1.0-dy)*dz*u[IJK(ilo,jlo,khi)]
                 + (1.0-dx)*dy*(1.0-dz)*u[IJK(ilo,jhi,klo)]
                 + (1.0-dx)*(1.0-dy)*(1.0-dz)*u[IJK(ilo,jlo,klo)];
-                energy += (uval*charge*atom->partID);
-            } else if (thee->pmgp->bcfl != BCFL_FOCUS) {
+                energy += (uval*charge*thee->apvec[iatom]);
+            } else if ((thee->pmgp->bcfl != BCFL_FOCUS) && !thee->distrib) {
                 Vnm_print(2, "Vpmg_qfEnergy:  Atom #%d at (%4.3f, %4.3f, \
 %4.3f) is off the mesh (ignoring)!\n",
                 iatom, position[0], position[1], position[2]);
@@ -1790,7 +2835,7 @@ VPRIVATE double Vpmg_qfEnergyPoint(Vpmg *thee,
 
 VPUBLIC double Vpmg_qfAtomEnergy(Vpmg *thee, Vatom *atom) {
 
-    int nx, ny, nz, ihi, ilo, jhi, jlo, khi, klo;
+    int nx, ny, nz, ihi, ilo, jhi, jlo, khi, klo, iatom;
     double xmax, xmin, ymax, ymin, zmax, zmin, hx, hy, hzed, ifloat, jfloat;
     double charge, kfloat, dx, dy, dz, energy, uval, *position;
     double *u;
@@ -1810,105 +2855,322 @@ VPUBLIC double Vpmg_qfAtomEnergy(Vpmg *thee, Vatom *atom) {
     ymin = thee->yf[0];
     zmin = thee->zf[0];
 
-    u = thee->u;
+    u = thee->u;
+
+    energy = 0.0;
+
+    iatom = Vatom_getAtomID(atom);
+    VASSERT((iatom >= 0) && (iatom < thee->napvec));
+
+    position = Vatom_getPosition(atom);
+    charge = Vatom_getCharge(atom);
+
+    /* Figure out which vertices we're next to */
+    ifloat = (position[0] - xmin)/hx;
+    jfloat = (position[1] - ymin)/hy;
+    kfloat = (position[2] - zmin)/hzed;
+    ihi = (int)ceil(ifloat);
+    ilo = (int)floor(ifloat);
+    jhi = (int)ceil(jfloat);
+    jlo = (int)floor(jfloat);
+    khi = (int)ceil(kfloat);
+    klo = (int)floor(kfloat);
+
+    if (thee->apvec[iatom] > 0) {
+
+        if ((ihi<nx) && (jhi<ny) && (khi<nz) &&
+            (ilo>=0) && (jlo>=0) && (klo>=0)) {
+
+            /* Now get trilinear interpolation constants */
+            dx = ifloat - (double)(ilo);
+            dy = jfloat - (double)(jlo);
+            dz = kfloat - (double)(klo);
+            uval =
+              dx*dy*dz*u[IJK(ihi,jhi,khi)]
+            + dx*(1.0-dy)*dz*u[IJK(ihi,jlo,khi)]
+            + dx*dy*(1.0-dz)*u[IJK(ihi,jhi,klo)]
+            + dx*(1.0-dy)*(1.0-dz)*u[IJK(ihi,jlo,klo)]
+            + (1.0-dx)*dy*dz*u[IJK(ilo,jhi,khi)]
+            + (1.0-dx)*(1.0-dy)*dz*u[IJK(ilo,jlo,khi)]
+            + (1.0-dx)*dy*(1.0-dz)*u[IJK(ilo,jhi,klo)]
+            + (1.0-dx)*(1.0-dy)*(1.0-dz)*u[IJK(ilo,jlo,klo)];
+            energy += (uval*charge*thee->apvec[iatom]);
+        } else if ((thee->pmgp->bcfl != BCFL_FOCUS) && !thee->distrib) {
+            Vnm_print(2, "Vpmg_qfAtomEnergy:  Atom at (%4.3f, %4.3f, \
+%4.3f) is off the mesh (ignoring)!\n",
+            position[0], position[1], position[2]);
+        }
+    }
+
+    return energy;
+}
+
+VPRIVATE double Vpmg_qfEnergyVolume(Vpmg *thee, int extFlag) {
+
+    double hx, hy, hzed, energy;
+    int i, nx, ny, nz;
+
+    VASSERT(thee != VNULL);
+
+    /* Get the mesh information */
+    nx = thee->pmgp->nx;
+    ny = thee->pmgp->ny;
+    nz = thee->pmgp->nz;
+    hx = thee->pmgp->hx;
+    hy = thee->pmgp->hy;
+    hzed = thee->pmgp->hzed;
+
+    if (!thee->filled) {
+        Vnm_print(2, "Vpmg_qfEnergyVolume:  need to call Vpmg_fillco!\n");
+        VASSERT(0);
+    }
+
+    energy = 0.0;
+    Vnm_print(0, "Vpmg_qfEnergyVolume:  Calculating energy\n");
+    for (i=0; i<(nx*ny*nz); i++) {
+        energy += (thee->pvec[i]*thee->u[i]*thee->charge[i]);
+    }
+    energy = energy*hx*hy*hzed/Vpbe_getZmagic(thee->pbe);
+
+    if (extFlag == 1) energy += thee->extQfEnergy;
+
+    return energy;
+}
+
+VPRIVATE void Vpmg_splineSelect(int srfm,Vacc *acc,double *gpos,double win,
+                                      double infrad,Vatom *atom,double *force){
+
+    switch (srfm) {
+        case VSM_SPLINE :
+            Vacc_splineAccGradAtomNorm(acc, gpos, win, infrad, atom, force);
+            break;
+        case VSM_SPLINE3:
+            Vacc_splineAccGradAtomNorm3(acc, gpos, win, infrad, atom, force);
+            break;
+        case VSM_SPLINE4 :
+            Vacc_splineAccGradAtomNorm4(acc, gpos, win, infrad, atom, force);
+            break;
+        default:
+            Vnm_print(2, "Vpmg_dbnbForce: Unknown surface method.\n");
+            return;
+    }
+
+    return;
+}
+
+VPRIVATE void sizeAtomPart(Vpmg *thee) {
+
+    int natoms;
+
+    /* A Vpmg can be given a new PBE object (see Vpmg_update) */
+    natoms = Valist_getNumberAtoms(thee->pbe->alist);
+    if (thee->napvec == natoms) return;
+
+    if (thee->apvec != VNULL) {
+        Vmem_free(thee->vmem, thee->napvec, sizeof(double),
+          (void **)&(thee->apvec));
+    }
+    thee->apvec = (double *)Vmem_malloc(thee->vmem, natoms, sizeof(double));
+    thee->napvec = natoms;
+}
+
+VPRIVATE void initIons(Vpmg *thee) {
+
+    int i, nion;
+    double ionConc[MAXION], ionQ[MAXION], ionRadii[MAXION], zks2, ionstr;
+
+    /// @note  this is common to both replace/noreplace options
+    ionstr = Vpbe_getBulkIonicStrength(thee->pbe);
+    if (ionstr > 0.0) zks2 = 0.5/ionstr;
+    else zks2 = 0.0;
+    Vpbe_getIons(thee->pbe, &nion, ionConc, ionRadii, ionQ);
+
+    /* Currently for SMPBE type calculations we do not want to apply a scale
+        factor to the ionConc */
+    /** @note  The fortran replacement functions are run along side the old
+     *         fortran functions.  This is due to the use of common variables
+     *         in the fortran sub-routines.  Once the fortran code has been
+     *         successfully excised, these functions will no longer need to be
+     *         called in tandem, and the fortran version may be dropped
+     */
+    switch(thee->pmgp->ipkey){
+
+        case IPKEY_SMPBE:
+
+            Vmypdefinitsmpbe(&nion, ionQ, ionConc, &(thee->pbe->smvolume),
+                             &(thee->pbe->smsize));
+            break;
+
+
+
+        case IPKEY_NPBE:
+
+            /* Else adjust the inoConc by scaling factor zks2 */
+            for (i=0; i<nion; i++)
+                ionConc[i] = zks2 * ionConc[i];
+
+            Vmypdefinitnpbe(&nion, ionQ, ionConc);
+            break;
+
+
+
+        case IPKEY_LPBE:
+
+            /* Else adjust the inoConc by scaling factor zks2 */
+            for (i=0; i<nion; i++)
+                ionConc[i] = zks2 * ionConc[i];
+
+            Vmypdefinitlpbe(&nion, ionQ, ionConc);
+            break;
+
+
+
+        default:
+            Vnm_print(2, "PMG: Warning: PBE structure not initialized!\n");
+            /* Else adjust the inoConc by scaling factor zks2 */
+            for (i=0; i<nion; i++)
+                ionConc[i] = zks2 * ionConc[i];
+            break;
+    }
+}
+
+VPRIVATE void focusSetup(Vpmg *thee, Vpmg *pmgOLD, MGparm *mgparm,
+                         PBEparm_calcEnergy energyFlag) {
 
-    energy = 0.0;
+    int j;
+    double partMin[3], partMax[3];
 
+    /* Overwrite any default or user-specified boundary condition
+    * arguments; we are now committed to a calculation via focusing */
+    if (thee->pmgp->bcfl != BCFL_FOCUS) {
+        Vnm_print(2,
+                  "Vpmg_ctor2: reset boundary condition flag to BCFL_FOCUS!\n");
+        thee->pmgp->bcfl = BCFL_FOCUS;
+    }
 
-    position = Vatom_getPosition(atom);
-    charge = Vatom_getCharge(atom);
+    /* Fill boundaries */
+    Vnm_print(0, "Vpmg_ctor2:  Filling boundary with old solution!\n");
+    focusFillBound(thee, pmgOLD);
 
-    /* Figure out which vertices we're next to */
-    ifloat = (position[0] - xmin)/hx;
-    jfloat = (position[1] - ymin)/hy;
-    kfloat = (position[2] - zmin)/hzed;
-    ihi = (int)ceil(ifloat);
-    ilo = (int)floor(ifloat);
-    jhi = (int)ceil(jfloat);
-    jlo = (int)floor(jfloat);
-    khi = (int)ceil(kfloat);
-    klo = (int)floor(kfloat);
+    /* Calculate energetic contributions from region outside focusing
+        * domain */
+    if (energyFlag != PCE_NO) {
 
-    if (atom->partID > 0) {
+        if (mgparm->type == MCT_PARALLEL) {
 
-        if ((ihi<nx) && (jhi<ny) && (khi<nz) &&
-            (ilo>=0) && (jlo>=0) && (klo>=0)) {
+            for (j=0; j<3; j++) {
+                partMin[j] = mgparm->partDisjCenter[j]
+                - 0.5*mgparm->partDisjLength[j];
+                partMax[j] = mgparm->partDisjCenter[j]
+                    + 0.5*mgparm->partDisjLength[j];
+            }
 
-            /* Now get trilinear interpolation constants */
-            dx = ifloat - (double)(ilo);
-            dy = jfloat - (double)(jlo);
-            dz = kfloat - (double)(klo);
-            uval =
-              dx*dy*dz*u[IJK(ihi,jhi,khi)]
-            + dx*(1.0-dy)*dz*u[IJK(ihi,jlo,khi)]
-            + dx*dy*(1.0-dz)*u[IJK(ihi,jhi,klo)]
-            + dx*(1.0-dy)*(1.0-dz)*u[IJK(ihi,jlo,klo)]
-            + (1.0-dx)*dy*dz*u[IJK(ilo,jhi,khi)]
-            + (1.0-dx)*(1.0-dy)*dz*u[IJK(ilo,jlo,khi)]
-            + (1.0-dx)*dy*(1.0-dz)*u[IJK(ilo,jhi,klo)]
-            + (1.0-dx)*(1.0-dy)*(1.0-dz)*u[IJK(ilo,jlo,klo)];
-            energy += (uval*charge*atom->partID);
-        } else if (thee->pmgp->bcfl != BCFL_FOCUS) {
-            Vnm_print(2, "Vpmg_qfAtomEnergy:  Atom at (%4.3f, %4.3f, \
-%4.3f) is off the mesh (ignoring)!\n",
-            position[0], position[1], position[2]);
+        } else {
+            for (j=0; j<3; j++) {
+                partMin[j] = mgparm->center[j] - 0.5*mgparm->glen[j];
+                partMax[j] = mgparm->center[j] + 0.5*mgparm->glen[j];
+            }
         }
+        extEnergy(thee, pmgOLD, energyFlag, partMin, partMax,
+                  mgparm->partDisjOwnSide);
     }
-
-    return energy;
 }
 
-VPRIVATE double Vpmg_qfEnergyVolume(Vpmg *thee, int extFlag) {
-
-    double hx, hy, hzed, energy;
-    int i, nx, ny, nz;
+VPRIVATE int guessFill(Vpmg *thee, int nxOLD, int nyOLD, int nzOLD,
+                       double hxOLD, double hyOLD, double hzOLD,
+                       double xminOLD, double yminOLD, double zminOLD,
+                       double *data) {
 
-    VASSERT(thee != VNULL);
+    int nx,
+        ny,
+        nz,
+        i,
+        j,
+        k,
+        ilo,
+        jlo,
+        klo,
+        sy,
+        sz,
+        m,
+        nhit;
+    double hx,
+           hy,
+           hzed,
+           xmin,
+           ymin,
+           zmin,
+           ifloat,
+           jfloat,
+           kfloat,
+           dx,
+           dy,
+           dz,
+           *u;
 
-    /* Get the mesh information */
     nx = thee->pmgp->nx;
     ny = thee->pmgp->ny;
     nz = thee->pmgp->nz;
     hx = thee->pmgp->hx;
     hy = thee->pmgp->hy;
     hzed = thee->pmgp->hzed;
+    xmin = thee->pmgp->xcent - ((double)(nx-1)*hx)/2.0;
+    ymin = thee->pmgp->ycent - ((double)(ny-1)*hy)/2.0;
+    zmin = thee->pmgp->zcent - ((double)(nz-1)*hzed)/2.0;
+    u = thee->u;
 
-    if (!thee->filled) {
-        Vnm_print(2, "Vpmg_qfEnergyVolume:  need to call Vpmg_fillco!\n");
-        VASSERT(0);
-    }
-
-    energy = 0.0;
-    Vnm_print(0, "Vpmg_qfEnergyVolume:  Calculating energy\n");
-    for (i=0; i<(nx*ny*nz); i++) {
-        energy += (thee->pvec[i]*thee->u[i]*thee->charge[i]);
-    }
-    energy = energy*hx*hy*hzed/Vpbe_getZmagic(thee->pbe);
-
-    if (extFlag == 1) energy += thee->extQfEnergy;
-
-    return energy;
-}
+    if ((nxOLD < 2) || (nyOLD < 2) || (nzOLD < 2)) return 0;
+    sy = nxOLD;
+    sz = nxOLD*nyOLD;
 
-VPRIVATE void Vpmg_splineSelect(int srfm,Vacc *acc,double *gpos,double win,
-                                      double infrad,Vatom *atom,double *force){
+    /* Trilinear interpolation at the interior points that lie on the old
+     * mesh; the others start from zero.  The boundary values are imposed
+     * by the solver. */
+    nhit = 0;
+#pragma omp parallel for default(shared) reduction(+:nhit) \
+    private(i,j,ifloat,jfloat,kfloat,ilo,jlo,klo,dx,dy,dz,m)
+    for (k=0; k<nz; k++) {
+        for (j=0; j<ny; j++) {
+            for (i=0; i<nx; i++) {
+                u[IJK(i,j,k)] = 0.0;
+                if ((i == 0) || (j == 0) || (k == 0) ||
+                    (i == nx-1) || (j == ny-1) || (k == nz-1)) continue;
+
+                ifloat = (xmin + i*hx - xminOLD)/hxOLD;
+                jfloat = (ymin + j*hy - yminOLD)/hyOLD;
+                kfloat = (zmin + k*hzed - zminOLD)/hzOLD;
+                if ((ifloat < -VSMALL) || (ifloat > (nxOLD-1) + VSMALL) ||
+                    (jfloat < -VSMALL) || (jfloat > (nyOLD-1) + VSMALL) ||
+                    (kfloat < -VSMALL) || (kfloat > (nzOLD-1) + VSMALL)) {
+                    continue;
+                }
 
-    switch (srfm) {
-        case VSM_SPLINE :
-            Vacc_splineAccGradAtomNorm(acc, gpos, win, infrad, atom, force);
-            break;
-        case VSM_SPLINE3:
-            Vacc_splineAccGradAtomNorm3(acc, gpos, win, infrad, atom, force);
-            break;
-        case VSM_SPLINE4 :
-            Vacc_splineAccGradAtomNorm4(acc, gpos, win, infrad, atom, force);
-            break;
-        default:
-            Vnm_print(2, "Vpmg_dbnbForce: Unknown surface method.\n");
-            return;
+                ilo = VMIN2(VMAX2((int)floor(ifloat), 0), nxOLD-2);
+                jlo = VMIN2(VMAX2((int)floor(jfloat), 0), nyOLD-2);
+                klo = VMIN2(VMAX2((int)floor(kfloat), 0), nzOLD-2);
+                dx = VMIN2(VMAX2(ifloat - (double)ilo, 0.0), 1.0);
+                dy = VMIN2(VMAX2(jfloat - (double)jlo, 0.0), 1.0);
+                dz = VMIN2(VMAX2(kfloat - (double)klo, 0.0), 1.0);
+                m = klo*sz + jlo*sy + ilo;
+
+                u[IJK(i,j,k)] =
+                      (1.0-dx)*(1.0-dy)*(1.0-dz)*data[m]
+                    + dx      *(1.0-dy)*(1.0-dz)*data[m+1]
+                    + (1.0-dx)*dy      *(1.0-dz)*data[m+sy]
+                    + dx      *dy      *(1.0-dz)*data[m+sy+1]
+                    + (1.0-dx)*(1.0-dy)*dz      *data[m+sz]
+                    + dx      *(1.0-dy)*dz      *data[m+sz+1]
+                    + (1.0-dx)*dy      *dz      *data[m+sz+sy]
+                    + dx      *dy      *dz      *data[m+sz+sy+1];
+                nhit++;
+            }
+        }
     }
 
-    return;
+    /* Have the solver start from u */
+    if (nhit > 0) VAT(thee->iparm, 30) = 1;
+
+    return nhit;
 }
 
 VPRIVATE void focusFillBound(Vpmg *thee,
@@ -2516,6 +3778,7 @@ VPRIVATE void extEnergy(Vpmg *thee, Vpmg *pmgOLD, PBEparm_calcEnergy extFlag,
         }
     }
 
+    VASSERT(pmgOLD->napvec == Valist_getNumberAtoms(thee->pbe->alist));
     for (i=0; i<Valist_getNumberAtoms(thee->pbe->alist); i++) {
         xval=1;
         yval=1;
@@ -2530,8 +3793,8 @@ VPRIVATE void extEnergy(Vpmg *thee, Vpmg *pmgOLD, PBEparm_calcEnergy extFlag,
         else if (y > partMax[1] && bflags[VAPBS_FRONT] == 1) yval = 0;
         if (z < partMin[2] && bflags[VAPBS_DOWN] == 1) zval = 0;
         else if (z > partMax[2] && bflags[VAPBS_UP] == 1) zval = 0;
-        if (atom->partID > VSMALL) atom->partID = 1.0;
-        atom->partID = (1 - atom->partID) * (xval*yval*zval);
+        if (pmgOLD->apvec[i] > VSMALL) pmgOLD->apvec[i] = 1.0;
+        pmgOLD->apvec[i] = (1 - pmgOLD->apvec[i]) * (xval*yval*zval);
     }
 
     /* Now calculate the energy on inverted subset of the domain */
@@ -3484,6 +4747,567 @@ VPRIVATE void bcflnew(Vpmg *thee){
     free(val);
 }
 
+/*
+ Hierarchical (treecode) evaluation of the multiple Debye-Huckel boundary
+ condition.  The atoms are partitioned by recursive bisection of the Vclist
+ hash grid; each cluster carries Cartesian Taylor moments of its charges and
+ the screened Coulomb kernel exp(-xkappa*r)/r is expanded about the cluster
+ center (Li, Johnston and Krasny, J Comput Phys 228, 2009).  The same
+ recurrence covers xkappa = 0, where it reduces to the Coulomb case.
+ */
+typedef struct sVpmgTreeNode {
+    int lo[3];  /* Lower Vclist cell index (inclusive) */
+    int hi[3];  /* Upper Vclist cell index (exclusive) */
+    int ibeg;  /* First atom in the sorted atom arrays */
+    int iend;  /* One past the last atom */
+    int nchild;  /* Number of children (0 for leaves) */
+    int child[8];  /* Child node indices */
+    int moff;  /* Offset into the moment array (-1 if not expanded) */
+    double center[3];  /* Expansion center */
+    double radius;  /* Cluster radius about the center */
+    double qabs;  /* Sum of absolute effective charges */
+} VpmgTreeNode;
+
+typedef struct sVpmgTree {
+    int order;  /* Taylor expansion order */
+    int nterms;  /* Number of multi-indices with |k| <= order */
+    int *kx, *ky, *kz;  /* Multi-index table */
+    int *kidx;  /* (order+1)^3 lookup from (i,j,k) into the multi-index table */
+    double theta;  /* Multipole acceptance parameter */
+    double reltol;  /* Error allowed relative to the cluster's own magnitude */
+    double tol;  /* Absolute error allowed for each cluster interaction */
+    int nnodes;  /* Number of tree nodes */
+    int maxnodes;  /* Allocated node storage */
+    VpmgTreeNode *nodes;  /* Tree nodes; node 0 is the root */
+    double *moments;  /* Cluster moments, nterms per expanded node */
+    double *ax, *ay, *az, *aq;  /* Sorted atom positions and effective charges */
+} VpmgTree;
+
+#define VPMGTREE_LEAF 8
+#define VPMGTREE_MINEXP 32
+#define VPMGTREE_MAXORDER 12
+#define VPMGTREE_KIDX(tree,i,j,k) \
+    ((tree)->kidx[((i)*((tree)->order+1) + (j))*((tree)->order+1) + (k)])
+
+VPRIVATE int bcflTreeNewNode(VpmgTree *tree, int lo[3], int hi[3],
+                             int ibeg, int iend) {
+
+    int i;
+    VpmgTreeNode *node;
+
+    if (tree->nnodes == tree->maxnodes) {
+        tree->maxnodes = 2*tree->maxnodes;
+        tree->nodes = (VpmgTreeNode*)realloc(tree->nodes,
+                                    tree->maxnodes*sizeof(VpmgTreeNode));
+        VASSERT(tree->nodes != VNULL);
+    }
+    node = &(tree->nodes[tree->nnodes]);
+    for (i=0; i<3; i++) {
+        node->lo[i] = lo[i];
+        node->hi[i] = hi[i];
+    }
+    node->ibeg = ibeg;
+    node->iend = iend;
+    node->nchild = 0;
+    node->moff = -1;
+
+    return (tree->nnodes)++;
+}
+
+/*
+ Split a node at the midpoint of its Vclist index box.  The atoms of the node
+ are partitioned in place into the eight octants using their home cells.
+ */
+VPRIVATE void bcflTreeSplit(VpmgTree *tree, int inode, int *cell,
+                            int *perm, int *scratch) {
+
+    int i, j, n, oct, mid[3], lo[3], hi[3], count[9], start[9];
+    int ibeg, iend, ichild, split;
+    VpmgTreeNode *node;
+
+    node = &(tree->nodes[inode]);
+    ibeg = node->ibeg;
+    iend = node->iend;
+    if ((iend - ibeg) <= VPMGTREE_LEAF) return;
+
+    split = 0;
+    for (i=0; i<3; i++) {
+        mid[i] = (node->lo[i] + node->hi[i])/2;
+        if ((node->hi[i] - node->lo[i]) > 1) split = 1;
+    }
+    /* A single Vclist cell is the finest partition available */
+    if (!split) return;
+
+    for (oct=0; oct<9; oct++) count[oct] = 0;
+    for (n=ibeg; n<iend; n++) {
+        oct = 0;
+        for (i=0; i<3; i++) {
+            if (cell[3*perm[n]+i] >= mid[i] && (node->hi[i]-node->lo[i]) > 1)
+                oct |= (1 << i);
+        }
+        scratch[n] = oct;
+        count[oct+1]++;
+    }
+    start[0] = ibeg;
+    for (oct=0; oct<8; oct++) start[oct+1] = start[oct] + count[oct+1];
+
+    /* Stable counting sort keeps the ordering deterministic */
+    {
+        int *tmp = (int*)malloc((iend-ibeg)*sizeof(int));
+        int pos[8];
+        VASSERT(tmp != VNULL);
+        for (oct=0; oct<8; oct++) pos[oct] = start[oct];
+        for (n=ibeg; n<iend; n++) tmp[pos[scratch[n]]++ - ibeg] = perm[n];
+        for (n=ibeg; n<iend; n++) perm[n] = tmp[n-ibeg];
+        free(tmp);
+    }
+
+    for (oct=0; oct<8; oct++) {
+        if (start[oct+1] == start[oct]) continue;
+        for (i=0; i<3; i++) {
+            node = &(tree->nodes[inode]);
+            if ((node->hi[i] - node->lo[i]) <= 1) {
+                lo[i] = node->lo[i];
+                hi[i] = node->hi[i];
+            } else if (oct & (1 << i)) {
+                lo[i] = mid[i];
+                hi[i] = node->hi[i];
+            } else {
+                lo[i] = node->lo[i];
+                hi[i] = mid[i];
+            }
+        }
+        ichild = bcflTreeNewNode(tree, lo, hi, start[oct], start[oct+1]);
+        node = &(tree->nodes[inode]);
+        node->child[node->nchild] = ichild;
+        (node->nchild)++;
+    }
+
+    node = &(tree->nodes[inode]);
+    j = node->nchild;
+    for (i=0; i<j; i++) {
+        bcflTreeSplit(tree, tree->nodes[inode].child[i], cell, perm, scratch);
+    }
+}
+
+/*
+ Taylor coefficients a_k = (1/k!) D_y^k [exp(-xkappa*|x-y|)/|x-y|] at y = c
+ for d = x - c.  b holds the companion coefficients of exp(-xkappa*|x-y|).
+ */
+VPRIVATE void bcflTreeCoeffs(VpmgTree *tree, int nterms, double d[3],
+                             double xkappa, double *a, double *b) {
+
+    int t, n, i, j, k, m;
+    double r2, r, s1, s2, t1, t2;
+
+    r2 = VSQR(d[0]) + VSQR(d[1]) + VSQR(d[2]);
+    r = VSQRT(r2);
+    a[0] = VEXP(-xkappa*r)/r;
+    b[0] = VEXP(-xkappa*r);
+
+    for (t=1; t<nterms; t++) {
+        i = tree->kx[t];
+        j = tree->ky[t];
+        k = tree->kz[t];
+        n = i + j + k;
+        s1 = 0.0; s2 = 0.0; t1 = 0.0; t2 = 0.0;
+        if (i > 0) {
+            m = VPMGTREE_KIDX(tree, i-1, j, k);
+            s1 += d[0]*a[m]; t1 += d[0]*b[m];
+        }
+        if (j > 0) {
+            m = VPMGTREE_KIDX(tree, i, j-1, k);
+            s1 += d[1]*a[m]; t1 += d[1]*b[m];
+        }
+        if (k > 0) {
+            m = VPMGTREE_KIDX(tree, i, j, k-1);
+            s1 += d[2]*a[m]; t1 += d[2]*b[m];
+        }
+        if (i > 1) {
+            m = VPMGTREE_KIDX(tree, i-2, j, k);
+            s2 += a[m]; t2 += b[m];
+        }
+        if (j > 1) {
+            m = VPMGTREE_KIDX(tree, i, j-2, k);
+            s2 += a[m]; t2 += b[m];
+        }
+        if (k > 1) {
+            m = VPMGTREE_KIDX(tree, i, j, k-2);
+            s2 += a[m]; t2 += b[m];
+        }
+        b[t] = xkappa*(s1 - s2)/((double)n);
+        a[t] = ((2.0*n - 1.0)*s1 - (n - 1.0)*s2 + xkappa*(t1 - t2))
+               /(((double)n)*r2);
+    }
+}
+
+/*
+ Build the cluster tree over the packed atoms.  Effective charges fold the
+ per-atom Debye-Huckel size factor into the charge so that every cluster sees
+ the same kernel.
+ */
+VPRIVATE void bcflTreeBuild(VpmgTree *tree, Vclist *clist, int natoms,
+                            double *ax, double *ay, double *az,
+                            double *charge, double *size, double pre1,
+                            double xkappa) {
+
+    int i, j, k, n, t, inode, ic, lo[3], hi[3];
+    int *cell, *perm, *scratch;
+    double pos[3], dx, dy, dz, r, pw[3][VPMGTREE_MAXORDER+1];
+    double lower[3], upper[3];
+    VpmgTreeNode *node;
+
+    /* Multi-index table ordered by total degree */
+    tree->nterms = (tree->order+1)*(tree->order+2)*(tree->order+3)/6;
+    tree->kx = (int*)malloc(tree->nterms*sizeof(int));
+    tree->ky = (int*)malloc(tree->nterms*sizeof(int));
+    tree->kz = (int*)malloc(tree->nterms*sizeof(int));
+    tree->kidx = (int*)malloc(VCUB(tree->order+1)*sizeof(int));
+    t = 0;
+    for (n=0; n<=tree->order; n++) {
+        for (i=n; i>=0; i--) {
+            for (j=n-i; j>=0; j--) {
+                k = n - i - j;
+                tree->kx[t] = i;
+                tree->ky[t] = j;
+                tree->kz[t] = k;
+                VPMGTREE_KIDX(tree, i, j, k) = t;
+                t++;
+            }
+        }
+    }
+
+    /* Home cell of each atom on the Vclist hash grid */
+    cell = (int*)malloc(3*natoms*sizeof(int));
+    perm = (int*)malloc(natoms*sizeof(int));
+    scratch = (int*)malloc(natoms*sizeof(int));
+    VASSERT((cell != VNULL) && (perm != VNULL) && (scratch != VNULL));
+    for (n=0; n<natoms; n++) {
+        pos[0] = ax[n];
+        pos[1] = ay[n];
+        pos[2] = az[n];
+        for (i=0; i<3; i++) {
+            ic = (int)floor((pos[i] - clist->lower_corner[i])/clist->spacs[i]);
+            if (ic < 0) ic = 0;
+            if (ic > clist->npts[i]-1) ic = clist->npts[i]-1;
+            cell[3*n+i] = ic;
+        }
+        perm[n] = n;
+    }
+
+    tree->maxnodes = VMAX2(64, natoms/2);
+    tree->nodes = (VpmgTreeNode*)malloc(tree->maxnodes*sizeof(VpmgTreeNode));
+    VASSERT(tree->nodes != VNULL);
+    tree->nnodes = 0;
+    for (i=0; i<3; i++) {
+        lo[i] = 0;
+        hi[i] = clist->npts[i];
+    }
+    bcflTreeNewNode(tree, lo, hi, 0, natoms);
+    bcflTreeSplit(tree, 0, cell, perm, scratch);
+
+    /* Sorted atom data */
+    tree->ax = (double*)malloc(natoms*sizeof(double));
+    tree->ay = (double*)malloc(natoms*sizeof(double));
+    tree->az = (double*)malloc(natoms*sizeof(double));
+    tree->aq = (double*)malloc(natoms*sizeof(double));
+    for (n=0; n<natoms; n++) {
+        i = perm[n];
+        tree->ax[n] = ax[i];
+        tree->ay[n] = ay[i];
+        tree->az[n] = az[i];
+        if (xkappa > VSMALL) {
+            tree->aq[n] = pre1*charge[i]*VEXP(xkappa*size[i])
+                          /(1+xkappa*size[i]);
+        } else tree->aq[n] = pre1*charge[i];
+    }
+
+    /* Geometry of each cluster; only clusters larger than their expansion
+     * get moments */
+    t = 0;
+    for (inode=0; inode<tree->nnodes; inode++) {
+        node = &(tree->nodes[inode]);
+        for (i=0; i<3; i++) {
+            lower[i] = VLARGE;
+            upper[i] = -VLARGE;
+        }
+        for (n=node->ibeg; n<node->iend; n++) {
+            lower[0] = VMIN2(lower[0], tree->ax[n]);
+            lower[1] = VMIN2(lower[1], tree->ay[n]);
+            lower[2] = VMIN2(lower[2], tree->az[n]);
+            upper[0] = VMAX2(upper[0], tree->ax[n]);
+            upper[1] = VMAX2(upper[1], tree->ay[n]);
+            upper[2] = VMAX2(upper[2], tree->az[n]);
+        }
+        for (i=0; i<3; i++) node->center[i] = 0.5*(lower[i] + upper[i]);
+        node->radius = 0.0;
+        node->qabs = 0.0;
+        for (n=node->ibeg; n<node->iend; n++) {
+            node->qabs += VABS(tree->aq[n]);
+            r = VSQR(tree->ax[n] - node->center[0])
+                + VSQR(tree->ay[n] - node->center[1])
+                + VSQR(tree->az[n] - node->center[2]);
+            node->radius = VMAX2(node->radius, r);
+        }
+        node->radius = VSQRT(node->radius);
+        if ((node->iend - node->ibeg) >= VPMGTREE_MINEXP) {
+            node->moff = t;
+            t += tree->nterms;
+        }
+    }
+
+    tree->moments = (double*)calloc(VMAX2(t, 1), sizeof(double));
+    VASSERT(tree->moments != VNULL);
+#pragma omp parallel for default(shared) private(inode,node,n,i,t,dx,dy,dz,pw)
+    for (inode=0; inode<tree->nnodes; inode++) {
+        node = &(tree->nodes[inode]);
+        if (node->moff < 0) continue;
+        for (n=node->ibeg; n<node->iend; n++) {
+            dx = tree->ax[n] - node->center[0];
+            dy = tree->ay[n] - node->center[1];
+            dz = tree->az[n] - node->center[2];
+            pw[0][0] = 1.0;
+            pw[1][0] = 1.0;
+            pw[2][0] = 1.0;
+            for (i=1; i<=tree->order; i++) {
+                pw[0][i] = pw[0][i-1]*dx;
+                pw[1][i] = pw[1][i-1]*dy;
+                pw[2][i] = pw[2][i-1]*dz;
+            }
+            for (t=0; t<tree->nterms; t++) {
+                tree->moments[node->moff + t] += tree->aq[n]
+                    *pw[0][tree->kx[t]]*pw[1][tree->ky[t]]*pw[2][tree->kz[t]];
+            }
+        }
+    }
+
+    free(cell);
+    free(perm);
+    free(scratch);
+}
+
+VPRIVATE void bcflTreeDestroy(VpmgTree *tree) {
+
+    free(tree->kx);
+    free(tree->ky);
+    free(tree->kz);
+    free(tree->kidx);
+    free(tree->nodes);
+    free(tree->moments);
+    free(tree->ax);
+    free(tree->ay);
+    free(tree->az);
+    free(tree->aq);
+}
+
+/*
+ Lowest expansion order whose estimated truncation error for the cluster
+ seen from distance dist meets the absolute tolerance; returns -1 if none
+ does.  The estimate combines the geometric (rad/dist)^(p+1) decay with the
+ (xkappa*rad)^(p+1)/(p+1)! growth of the screened kernel derivatives,
+ scaled by the largest value the kernel takes over the cluster.
+ */
+VPRIVATE int bcflTreeOrder(VpmgTree *tree, VpmgTreeNode *node, double dist,
+                           double xkappa) {
+
+    int p;
+    double rad, scale, ratio, geom, screen;
+
+    rad = node->radius;
+    scale = node->qabs*VEXP(-xkappa*(dist - rad))/(dist - rad);
+    ratio = rad/dist;
+    geom = ratio;
+    screen = xkappa*rad;
+    for (p=0; p<=tree->order; p++) {
+        if ((geom + screen) <= tree->reltol) return p;
+        if (scale*(geom + screen) <= tree->tol) return p;
+        geom *= ratio;
+        screen *= xkappa*rad/((double)(p+2));
+    }
+    return -1;
+}
+
+/*
+ Evaluate the Debye-Huckel potential at gpos by a depth-first traversal:
+ well-separated clusters use their expansion, the rest are opened or summed
+ directly.
+ */
+VPRIVATE double bcflTreeEval(VpmgTree *tree, double gpos[3], double xkappa,
+                             int *stack, double *a, double *b) {
+
+    int top, inode, n, t, p, nterms;
+    double d[3], dist, val, sum;
+    VpmgTreeNode *node;
+
+    val = 0.0;
+    top = 0;
+    stack[top++] = 0;
+    while (top > 0) {
+        inode = stack[--top];
+        node = &(tree->nodes[inode]);
+        d[0] = gpos[0] - node->center[0];
+        d[1] = gpos[1] - node->center[1];
+        d[2] = gpos[2] - node->center[2];
+        dist = VSQRT(VSQR(d[0]) + VSQR(d[1]) + VSQR(d[2]));
+        p = -1;
+        nterms = 0;
+        if ((node->moff >= 0) && (node->radius < tree->theta*dist)) {
+            p = bcflTreeOrder(tree, node, dist, xkappa);
+            if (p >= 0) nterms = (p+1)*(p+2)*(p+3)/6;
+        }
+        if ((p >= 0) && (nterms < (node->iend - node->ibeg))) {
+            bcflTreeCoeffs(tree, nterms, d, xkappa, a, b);
+            sum = 0.0;
+            for (t=0; t<nterms; t++) {
+                sum += a[t]*tree->moments[node->moff + t];
+            }
+            val += sum;
+        } else if (node->nchild == 0) {
+            for (n=node->ibeg; n<node->iend; n++) {
+                dist = VSQRT(VSQR(gpos[0]-tree->ax[n])
+                             + VSQR(gpos[1]-tree->ay[n])
+                             + VSQR(gpos[2]-tree->az[n]));
+                val += tree->aq[n]*VEXP(-xkappa*dist)/dist;
+            }
+        } else {
+            for (n=node->nchild-1; n>=0; n--) stack[top++] = node->child[n];
+        }
+    }
+
+    return val;
+}
+
+/*
+ Reference magnitude for the tolerance: the largest unsigned Debye-Huckel
+ sum over the boundary points nearest to the molecule on each face.
+ */
+VPRIVATE double bcflTreeScale(VpmgTree *tree, int ngrid, double *gx,
+                              double *gy, double *gz, double xkappa) {
+
+    int igrid, iface, n, best[6];
+    double d, dist, bestd[6], *c, u, umax;
+
+    c = tree->nodes[0].center;
+    for (iface=0; iface<6; iface++) {
+        best[iface] = -1;
+        bestd[iface] = VLARGE;
+    }
+    for (igrid=0; igrid<ngrid; igrid++) {
+        d = VSQR(gx[igrid]-c[0]) + VSQR(gy[igrid]-c[1])
+            + VSQR(gz[igrid]-c[2]);
+        iface = 0;
+        if (VABS(gy[igrid]-c[1]) > VABS(gx[igrid]-c[0])) iface = 1;
+        if (VABS(gz[igrid]-c[2]) > VMAX2(VABS(gx[igrid]-c[0]),
+                                         VABS(gy[igrid]-c[1]))) iface = 2;
+        iface = 2*iface + (((iface == 0) ? gx[igrid]-c[0] :
+                            (iface == 1) ? gy[igrid]-c[1] :
+                            gz[igrid]-c[2]) > 0.0);
+        if (d < bestd[iface]) {
+            bestd[iface] = d;
+            best[iface] = igrid;
+        }
+    }
+
+    umax = 0.0;
+    for (iface=0; iface<6; iface++) {
+        if (best[iface] < 0) continue;
+        igrid = best[iface];
+        u = 0.0;
+        for (n=0; n<tree->nodes[0].iend; n++) {
+            dist = VSQRT(VSQR(gx[igrid]-tree->ax[n])
+                         + VSQR(gy[igrid]-tree->ay[n])
+                         + VSQR(gz[igrid]-tree->az[n]));
+            u += VABS(tree->aq[n])*VEXP(-xkappa*dist)/dist;
+        }
+        umax = VMAX2(umax, u);
+    }
+
+    return umax;
+}
+
+VPRIVATE void bcflTree(Vpmg *thee){
+
+    int igrid, natoms, ngrid, nx, ny, nz;
+    int *stack;
+
+    double pre1, eps_w, T, xkappa, gpos[3];
+    double *ax, *ay, *az, *charge, *size, *val;
+    double *gx, *gy, *gz, *a, *b;
+
+    VpmgTree tree;
+    Vpbe *pbe = thee->pbe;
+
+    nx = thee->pmgp->nx;
+    ny = thee->pmgp->ny;
+    nz = thee->pmgp->nz;
+
+    eps_w = Vpbe_getSolventDiel(pbe);           /* Dimensionless */
+    T = Vpbe_getTemperature(pbe);               /* K             */
+    pre1 = ((Vunit_ec)/(4*VPI*Vunit_eps0*eps_w*Vunit_kb*T))*(1.0e10);
+    xkappa = Vpbe_getXkappa(pbe);
+    if (xkappa <= VSMALL) xkappa = 0.0;
+
+    natoms = Valist_getNumberAtoms(thee->pbe->alist);
+    ngrid = 2*((nx*ny) + (ny*nz) + (nx*nz));
+
+    ax = (double*)malloc(natoms * sizeof(double));
+    ay = (double*)malloc(natoms * sizeof(double));
+    az = (double*)malloc(natoms * sizeof(double));
+    charge = (double*)malloc(natoms * sizeof(double));
+    size = (double*)malloc(natoms * sizeof(double));
+
+    gx = (double*)malloc(ngrid * sizeof(double));
+    gy = (double*)malloc(ngrid * sizeof(double));
+    gz = (double*)malloc(ngrid * sizeof(double));
+    val = (double*)malloc(ngrid * sizeof(double));
+
+    packAtoms(ax,ay,az,charge,size,thee);
+    packUnpack(nx,ny,nz,ngrid,gx,gy,gz,val,thee,1);
+
+    tree.order = VPMGTREE_MAXORDER;
+    tree.theta = 0.6;
+    bcflTreeBuild(&tree, pbe->clist, natoms, ax, ay, az, charge, size,
+                  pre1, xkappa);
+    tree.reltol = thee->pmgp->bctol;
+    tree.tol = thee->pmgp->bctol*bcflTreeScale(&tree, ngrid, gx, gy, gz,
+                                               xkappa);
+    Vnm_print(0, "bcflTree:  %d atoms, %d clusters, tolerance %g (%g)\n",
+              natoms, tree.nnodes, thee->pmgp->bctol, tree.tol);
+
+#pragma omp parallel default(shared) private(igrid,gpos,stack,a,b)
+    {
+        stack = (int*)malloc(8*tree.nnodes*sizeof(int));
+        a = (double*)malloc(tree.nterms*sizeof(double));
+        b = (double*)malloc(tree.nterms*sizeof(double));
+        VASSERT((stack != VNULL) && (a != VNULL) && (b != VNULL));
+#pragma omp for schedule(dynamic,64)
+        for (igrid=0; igrid<ngrid; igrid++) {
+            gpos[0] = gx[igrid];
+            gpos[1] = gy[igrid];
+            gpos[2] = gz[igrid];
+            val[igrid] = bcflTreeEval(&tree, gpos, xkappa, stack, a, b);
+        }
+        free(stack);
+        free(a);
+        free(b);
+    }
+
+    packUnpack(nx,ny,nz,ngrid,gx,gy,gz,val,thee,0);
+
+    bcflTreeDestroy(&tree);
+
+    free(ax);
+    free(ay);
+    free(az);
+    free(charge);
+    free(size);
+
+    free(gx);
+    free(gy);
+    free(gz);
+    free(val);
+}
+
 VPRIVATE void multipolebc(double r, double kappa, double eps_p,
                           double eps_w, double rad, double tsr[3]) {
     double r2,r3,r5;
@@ -4452,6 +6276,9 @@ VPRIVATE void bcCalc(Vpmg *thee){
 
 #endif	/* WITH_TINKER */
             break;
+        case BCFL_MDHTREE:
+            bcflTree(thee);
+            break;
         case BCFL_MEM:
 
             zmem  = Vpbe_getzmem(thee->pbe);
@@ -4695,7 +6522,7 @@ VPRIVATE void fillcoCoefMolIon(Vpmg *thee) {
                 (apos[1]<(ymin-irad-arad)) || (apos[1]>(ymax+irad+arad))  || \
                 (apos[2]<(zmin-irad-arad)) || (apos[2]>(zmax+irad+arad))) {
                 if ((thee->pmgp->bcfl != BCFL_FOCUS) &&
-                    (thee->pmgp->bcfl != BCFL_MAP)) {
+                    (thee->pmgp->bcfl != BCFL_MAP) && !thee->distrib) {
                     Vnm_print(2,
     "Vpmg_fillco:  Atom #%d at (%4.3f, %4.3f, %4.3f) is off the mesh (ignoring):\n",
                       iatom, apos[0], apos[1], apos[2]);
@@ -4744,8 +6571,8 @@ VPRIVATE void fillcoCoefMolDielNoSmooth(Vpmg *thee) {
     double xmin, xmax, ymin, ymax, zmin, zmax;
     double xlen, ylen, zlen, position[3];
     double srad, epsw, epsp, deps, area;
-    double hx, hy, hzed, *apos, arad;
-    int i, nx, ny, nz, ntot, iatom, ipt;
+    double hx, hy, hzed, *apos, arad, lower[3], upper[3];
+    int i, nx, ny, nz, ntot, iatom, ipt, nbuilt;
 
     /* Get PBE info */
     pbe = thee->pbe;
@@ -4798,7 +6625,7 @@ VPRIVATE void fillcoCoefMolDielNoSmooth(Vpmg *thee) {
             (apos[1]<=ymin) || (apos[1]>=ymax)  || \
             (apos[2]<=zmin) || (apos[2]>=zmax)) {
             if ((thee->pmgp->bcfl != BCFL_FOCUS) &&
-                (thee->pmgp->bcfl != BCFL_MAP)) {
+                (thee->pmgp->bcfl != BCFL_MAP) && !thee->distrib) {
                 Vnm_print(2, "Vpmg_fillco:  Atom #%d at (%4.3f, %4.3f,\
  %4.3f) is off the mesh (ignoring):\n",
                   iatom, apos[0], apos[1], apos[2]);
@@ -4839,16 +6666,33 @@ VPRIVATE void fillcoCoefMolDielNoSmooth(Vpmg *thee) {
         } /* endif (on the mesh) */
     } /* endfor (over all atoms) */
 
-    area = Vacc_SASA(acc, srad);
-
     /* We only need to do the next step for non-zero solvent radii */
     if (srad > VSMALL) {
 
+        /* Only atoms whose probe spheres can reach the (shifted) grids need
+         * surfaces; build those in parallel, reusing any already built for
+         * this molecule by other calculations */
+        lower[0] = xmin;
+        lower[1] = ymin;
+        lower[2] = zmin;
+        upper[0] = xmax + 0.5*hx;
+        upper[1] = ymax + 0.5*hy;
+        upper[2] = zmax + 0.5*hzed;
+        nbuilt = Vacc_buildSurf(acc, srad, lower, upper);
+        Vnm_print(0, "Vpmg_fillco:  built %d atom surfaces\n", nbuilt);
+
         /* Now loop over the solvent accessible surface points */
 
-#pragma omp parallel for default(shared) private(iatom,atom,area,asurf,ipt,position)
+#pragma omp parallel for default(shared) private(iatom,atom,area,asurf,ipt,position,apos,arad)
         for (iatom=0; iatom<Valist_getNumberAtoms(alist); iatom++) {
             atom = Valist_getAtom(alist, iatom);
+            apos = Vatom_getPosition(atom);
+            arad = Vatom_getRadius(atom) + 2.0*srad;
+            if ((apos[0] < (lower[0] - arad)) || (apos[0] > (upper[0] + arad)) ||
+                (apos[1] < (lower[1] - arad)) || (apos[1] > (upper[1] + arad)) ||
+                (apos[2] < (lower[2] - arad)) || (apos[2] > (upper[2] + arad))) {
+                continue;
+            }
             area = Vacc_atomSASA(acc, srad, atom);
             if (area > 0.0 ) {
                 asurf = Vacc_atomSASPoints(acc, srad, atom);
@@ -4910,7 +6754,11 @@ VPRIVATE void fillcoCoefMolDielSmooth(Vpmg *thee) {
     pbe = thee->pbe;
     epsw = Vpbe_getSolventDiel(pbe);
 
-    /* Copy the existing diel arrays to work arrays */
+    /* Copy the existing diel arrays to work arrays; the solver coefficient
+     * arrays are not allocated outside of Vpmg_solve */
+    thee->a1cf = (double *)Vmem_malloc(thee->vmem, nx*ny*nz, sizeof(double));
+    thee->a2cf = (double *)Vmem_malloc(thee->vmem, nx*ny*nz, sizeof(double));
+    thee->a3cf = (double *)Vmem_malloc(thee->vmem, nx*ny*nz, sizeof(double));
     for (i=0; i<(nx*ny*nz); i++) {
         thee->a1cf[i] = thee->epsx[i];
         thee->a2cf[i] = thee->epsy[i];
@@ -5016,6 +6864,10 @@ VPRIVATE void fillcoCoefMolDielSmooth(Vpmg *thee) {
             }
         }
     }
+
+    Vmem_free(thee->vmem, nx*ny*nz, sizeof(double), (void **)&(thee->a1cf));
+    Vmem_free(thee->vmem, nx*ny*nz, sizeof(double), (void **)&(thee->a2cf));
+    Vmem_free(thee->vmem, nx*ny*nz, sizeof(double), (void **)&(thee->a3cf));
 }
 
 
@@ -5094,7 +6946,7 @@ VPRIVATE void fillcoCoefSpline(Vpmg *thee) {
             (apos[1]<=ymin) || (apos[1]>=ymax)  || \
             (apos[2]<=zmin) || (apos[2]>=zmax)) {
             if ((thee->pmgp->bcfl != BCFL_FOCUS) &&
-                (thee->pmgp->bcfl != BCFL_MAP)) {
+                (thee->pmgp->bcfl != BCFL_MAP) && !thee->distrib) {
                 Vnm_print(2, "Vpmg_fillco:  Atom #%d at (%4.3f, %4.3f,\
  %4.3f) is off the mesh (ignoring):\n",
                   iatom, apos[0], apos[1], apos[2]);
@@ -5388,6 +7240,37 @@ VPRIVATE Vrc_Codes fillcoChargeMap(Vpmg *thee) {
     return VRC_SUCCESS;
 }
 
+VPRIVATE int fillcoChargePlanes(Vpmg *thee, int natoms, int *kmin, int *kmax,
+  int **plane, int **list) {
+
+    int k, iatom, nz, nlist, *next;
+
+    nz = thee->pmgp->nz;
+
+    /* Count the atoms touching each plane */
+    *plane = (int*)Vmem_malloc(thee->vmem, nz+1, sizeof(int));
+    for (k=0; k<=nz; k++) (*plane)[k] = 0;
+    for (iatom=0; iatom<natoms; iatom++) {
+        for (k=kmin[iatom]; k<=kmax[iatom]; k++) (*plane)[k+1]++;
+    }
+    for (k=0; k<nz; k++) (*plane)[k+1] += (*plane)[k];
+    nlist = (*plane)[nz];
+
+    /* List them plane by plane, keeping the atom order within each plane */
+    *list = (int*)Vmem_malloc(thee->vmem, VMAX2(nlist,1), sizeof(int));
+    next = (int*)Vmem_malloc(thee->vmem, nz, sizeof(int));
+    for (k=0; k<nz; k++) next[k] = (*plane)[k];
+    for (iatom=0; iatom<natoms; iatom++) {
+        for (k=kmin[iatom]; k<=kmax[iatom]; k++) {
+            (*list)[next[k]] = iatom;
+            next[k]++;
+        }
+    }
+    Vmem_free(thee->vmem, nz, sizeof(int), (void **)&next);
+
+    return nlist;
+}
+
 VPRIVATE void fillcoChargeSpline1(Vpmg *thee) {
 
     Valist *alist;
@@ -5396,7 +7279,8 @@ VPRIVATE void fillcoChargeSpline1(Vpmg *thee) {
     double xmin, xmax, ymin, ymax, zmin, zmax;
     double xlen, ylen, zlen, position[3], ifloat, jfloat, kfloat;
     double charge, dx, dy, dz, zmagic, hx, hy, hzed, *apos;
-    int i, nx, ny, nz, iatom, ihi, ilo, jhi, jlo, khi, klo;
+    int i, k, nx, ny, nz, iatom, ihi, ilo, jhi, jlo, khi, klo;
+    int natoms, nlist, ilist, *kmin, *kmax, *plane, *list;
 
 
     VASSERT(thee != VNULL);
@@ -5430,20 +7314,23 @@ VPRIVATE void fillcoChargeSpline1(Vpmg *thee) {
     /* Reset the charge array */
     for (i=0; i<(nx*ny*nz); i++) thee->charge[i] = 0.0;
 
-    /* Fill in the source term (atomic charges) */
-    Vnm_print(0, "Vpmg_fillco:  filling in source term.\n");
-    for (iatom=0; iatom<Valist_getNumberAtoms(alist); iatom++) {
+    /* Find the z-planes each atom touches */
+    natoms = Valist_getNumberAtoms(alist);
+    kmin = (int*)Vmem_malloc(thee->vmem, VMAX2(natoms,1), sizeof(int));
+    kmax = (int*)Vmem_malloc(thee->vmem, VMAX2(natoms,1), sizeof(int));
+    for (iatom=0; iatom<natoms; iatom++) {
 
         atom = Valist_getAtom(alist, iatom);
         apos = Vatom_getPosition(atom);
-        charge = Vatom_getCharge(atom);
+        kmin[iatom] = 0;
+        kmax[iatom] = -1;
 
         /* Make sure we're on the grid */
         if ((apos[0]<=xmin) || (apos[0]>=xmax)  || \
             (apos[1]<=ymin) || (apos[1]>=ymax)  || \
             (apos[2]<=zmin) || (apos[2]>=zmax)) {
             if ((thee->pmgp->bcfl != BCFL_FOCUS) &&
-                (thee->pmgp->bcfl != BCFL_MAP)) {
+                (thee->pmgp->bcfl != BCFL_MAP) && !thee->distrib) {
                 Vnm_print(2, "Vpmg_fillco:  Atom #%d at (%4.3f, %4.3f, \
 %4.3f) is off the mesh (ignoring):\n",
                   iatom, apos[0], apos[1], apos[2]);
@@ -5456,6 +7343,27 @@ VPRIVATE void fillcoChargeSpline1(Vpmg *thee) {
             }
             fflush(stderr);
         } else {
+            position[2] = apos[2] - zmin;
+            kfloat = position[2]/hzed;
+            kmin[iatom] = (int)floor(kfloat);
+            kmax[iatom] = (int)ceil(kfloat);
+        } /* endif (on the mesh) */
+    } /* endfor (each atom) */
+    nlist = fillcoChargePlanes(thee, natoms, kmin, kmax, &plane, &list);
+
+    /* Fill in the source term (atomic charges).  Each z-plane is filled by
+     * one thread in atom order, so the sums do not depend on the number of
+     * threads. */
+    Vnm_print(0, "Vpmg_fillco:  filling in source term.\n");
+#pragma omp parallel for default(shared) schedule(dynamic,1) \
+  private(k,ilist,atom,apos,charge,position,ifloat,jfloat,kfloat,\
+  ihi,ilo,jhi,jlo,khi,klo,dx,dy,dz)
+    for (k=0; k<nz; k++) {
+        for (ilist=plane[k]; ilist<plane[k+1]; ilist++) {
+
+            atom = Valist_getAtom(alist, list[ilist]);
+            apos = Vatom_getPosition(atom);
+            charge = Vatom_getCharge(atom);
 
             /* Convert the atom position to grid reference frame */
             position[0] = apos[0] - xmin;
@@ -5477,20 +7385,34 @@ VPRIVATE void fillcoChargeSpline1(Vpmg *thee) {
             khi = (int)ceil(kfloat);
             klo = (int)floor(kfloat);
 
-            /* Now assign fractions of the charge to the nearby verts */
+            /* Now assign fractions of the charge to the nearby verts in
+             * this plane */
             dx = ifloat - (double)(ilo);
             dy = jfloat - (double)(jlo);
             dz = kfloat - (double)(klo);
-            thee->charge[IJK(ihi,jhi,khi)] += (dx*dy*dz*charge);
-            thee->charge[IJK(ihi,jlo,khi)] += (dx*(1.0-dy)*dz*charge);
-            thee->charge[IJK(ihi,jhi,klo)] += (dx*dy*(1.0-dz)*charge);
-            thee->charge[IJK(ihi,jlo,klo)] += (dx*(1.0-dy)*(1.0-dz)*charge);
-            thee->charge[IJK(ilo,jhi,khi)] += ((1.0-dx)*dy*dz *charge);
-            thee->charge[IJK(ilo,jlo,khi)] += ((1.0-dx)*(1.0-dy)*dz *charge);
-            thee->charge[IJK(ilo,jhi,klo)] += ((1.0-dx)*dy*(1.0-dz)*charge);
-            thee->charge[IJK(ilo,jlo,klo)] += ((1.0-dx)*(1.0-dy)*(1.0-dz)*charge);
-        } /* endif (on the mesh) */
-    } /* endfor (each atom) */
+            if (khi == k) {
+                thee->charge[IJK(ihi,jhi,khi)] += (dx*dy*dz*charge);
+                thee->charge[IJK(ihi,jlo,khi)] += (dx*(1.0-dy)*dz*charge);
+            }
+            if (klo == k) {
+                thee->charge[IJK(ihi,jhi,klo)] += (dx*dy*(1.0-dz)*charge);
+                thee->charge[IJK(ihi,jlo,klo)] += (dx*(1.0-dy)*(1.0-dz)*charge);
+            }
+            if (khi == k) {
+                thee->charge[IJK(ilo,jhi,khi)] += ((1.0-dx)*dy*dz *charge);
+                thee->charge[IJK(ilo,jlo,khi)] += ((1.0-dx)*(1.0-dy)*dz *charge);
+            }
+            if (klo == k) {
+                thee->charge[IJK(ilo,jhi,klo)] += ((1.0-dx)*dy*(1.0-dz)*charge);
+                thee->charge[IJK(ilo,jlo,klo)] += ((1.0-dx)*(1.0-dy)*(1.0-dz)*charge);
+            }
+        } /* endfor (each atom in the plane) */
+    } /* endfor (each plane) */
+
+    Vmem_free(thee->vmem, VMAX2(nlist,1), sizeof(int), (void **)&list);
+    Vmem_free(thee->vmem, nz+1, sizeof(int), (void **)&plane);
+    Vmem_free(thee->vmem, VMAX2(natoms,1), sizeof(int), (void **)&kmax);
+    Vmem_free(thee->vmem, VMAX2(natoms,1), sizeof(int), (void **)&kmin);
 }
 
 VPRIVATE double bspline2(double x) {
@@ -5533,8 +7455,9 @@ VPRIVATE void fillcoChargeSpline2(Vpmg *thee) {
     double xmin, xmax, ymin, ymax, zmin, zmax, zmagic;
     double xlen, ylen, zlen, position[3], ifloat, jfloat, kfloat;
     double charge, hx, hy, hzed, *apos, mx, my, mz;
-    int i, ii, jj, kk, nx, ny, nz, iatom;
-    int im2, im1, ip1, ip2, jm2, jm1, jp1, jp2, km2, km1, kp1, kp2;
+    int i, ii, jj, kk, k, nx, ny, nz, iatom;
+    int im2, im1, ip1, ip2, jm2, jm1, jp1, jp2;
+    int natoms, nlist, ilist, *kmin, *kmax, *plane, *list;
 
 
     VASSERT(thee != VNULL);
@@ -5568,20 +7491,23 @@ VPRIVATE void fillcoChargeSpline2(Vpmg *thee) {
     /* Reset the charge array */
     for (i=0; i<(nx*ny*nz); i++) thee->charge[i] = 0.0;
 
-    /* Fill in the source term (atomic charges) */
-    Vnm_print(0, "Vpmg_fillco:  filling in source term.\n");
-    for (iatom=0; iatom<Valist_getNumberAtoms(alist); iatom++) {
+    /* Find the z-planes each atom touches */
+    natoms = Valist_getNumberAtoms(alist);
+    kmin = (int*)Vmem_malloc(thee->vmem, VMAX2(natoms,1), sizeof(int));
+    kmax = (int*)Vmem_malloc(thee->vmem, VMAX2(natoms,1), sizeof(int));
+    for (iatom=0; iatom<natoms; iatom++) {
 
         atom = Valist_getAtom(alist, iatom);
         apos = Vatom_getPosition(atom);
-        charge = Vatom_getCharge(atom);
+        kmin[iatom] = 0;
+        kmax[iatom] = -1;
 
         /* Make sure we're on the grid */
         if ((apos[0]<=(xmin-hx)) || (apos[0]>=(xmax+hx))  || \
             (apos[1]<=(ymin-hy)) || (apos[1]>=(ymax+hy))  || \
             (apos[2]<=(zmin-hzed)) || (apos[2]>=(zmax+hzed))) {
             if ((thee->pmgp->bcfl != BCFL_FOCUS) &&
-                (thee->pmgp->bcfl != BCFL_MAP)) {
+                (thee->pmgp->bcfl != BCFL_MAP) && !thee->distrib) {
                 Vnm_print(2, "Vpmg_fillco:  Atom #%d at (%4.3f, %4.3f, \
 %4.3f) is off the mesh (for cubic splines!!) (ignoring this atom):\n",
                   iatom, apos[0], apos[1], apos[2]);
@@ -5594,6 +7520,27 @@ VPRIVATE void fillcoChargeSpline2(Vpmg *thee) {
             }
             fflush(stderr);
         } else {
+            position[2] = apos[2] - zmin;
+            kfloat = position[2]/hzed;
+            kmin[iatom] = VMAX2((int)floor(kfloat) - 1, 0);
+            kmax[iatom] = VMIN2((int)ceil(kfloat) + 1, nz-1);
+        } /* endif (on the mesh) */
+    } /* endfor (each atom) */
+    nlist = fillcoChargePlanes(thee, natoms, kmin, kmax, &plane, &list);
+
+    /* Fill in the source term (atomic charges).  Each z-plane is filled by
+     * one thread in atom order, so the sums do not depend on the number of
+     * threads. */
+    Vnm_print(0, "Vpmg_fillco:  filling in source term.\n");
+#pragma omp parallel for default(shared) schedule(dynamic,1) \
+  private(k,ilist,atom,apos,charge,position,ifloat,jfloat,kfloat,\
+  im2,im1,ip1,ip2,jm2,jm1,jp1,jp2,ii,jj,kk,mx,my,mz)
+    for (k=0; k<nz; k++) {
+        for (ilist=plane[k]; ilist<plane[k+1]; ilist++) {
+
+            atom = Valist_getAtom(alist, list[ilist]);
+            apos = Vatom_getPosition(atom);
+            charge = Vatom_getCharge(atom);
 
             /* Convert the atom position to grid reference frame */
             position[0] = apos[0] - xmin;
@@ -5616,10 +7563,6 @@ VPRIVATE void fillcoChargeSpline2(Vpmg *thee) {
             jp2   = jp1 + 1;
             jm1   = (int)floor(jfloat);
             jm2   = jm1 - 1;
-            kp1   = (int)ceil(kfloat);
-            kp2   = kp1 + 1;
-            km1   = (int)floor(kfloat);
-            km2   = km1 - 1;
 
             /* This step shouldn't be necessary, but it saves nasty debugging
              * later on if something goes wrong */
@@ -5631,25 +7574,121 @@ VPRIVATE void fillcoChargeSpline2(Vpmg *thee) {
             jp1 = VMIN2(jp1,ny-1);
             jm1 = VMAX2(jm1,0);
             jm2 = VMAX2(jm2,0);
-            kp2 = VMIN2(kp2,nz-1);
-            kp1 = VMIN2(kp1,nz-1);
-            km1 = VMAX2(km1,0);
-            km2 = VMAX2(km2,0);
 
-            /* Now assign fractions of the charge to the nearby verts */
+            /* Now assign fractions of the charge to the nearby verts in
+             * this plane */
+            kk = k;
+            mz = bspline2(VFCHI(kk,kfloat));
             for (ii=im2; ii<=ip2; ii++) {
                 mx = bspline2(VFCHI(ii,ifloat));
                 for (jj=jm2; jj<=jp2; jj++) {
                     my = bspline2(VFCHI(jj,jfloat));
-                    for (kk=km2; kk<=kp2; kk++) {
-                        mz = bspline2(VFCHI(kk,kfloat));
-                        thee->charge[IJK(ii,jj,kk)] += (charge*mx*my*mz);
-                    }
+                    thee->charge[IJK(ii,jj,kk)] += (charge*mx*my*mz);
                 }
             }
+        } /* endfor (each atom in the plane) */
+    } /* endfor (each plane) */
 
-        } /* endif (on the mesh) */
-    } /* endfor (each atom) */
+    Vmem_free(thee->vmem, VMAX2(nlist,1), sizeof(int), (void **)&list);
+    Vmem_free(thee->vmem, nz+1, sizeof(int), (void **)&plane);
+    Vmem_free(thee->vmem, VMAX2(natoms,1), sizeof(int), (void **)&kmax);
+    Vmem_free(thee->vmem, VMAX2(natoms,1), sizeof(int), (void **)&kmin);
+}
+
+/* FNV-1a hash of the bytes of len values */
+VPRIVATE unsigned long long fillcoKeyAdd(unsigned long long key,
+                                         double *val, int len) {
+
+    unsigned char *byte;
+    int i;
+
+    byte = (unsigned char *)val;
+    for (i=0; i<len*(int)sizeof(double); i++) {
+        key = (key ^ byte[i])*1099511628211ULL;
+    }
+    return key;
+}
+
+/* Hash of everything the dielectric and kappa maps depend on besides the
+ * mesh: the surface definition, the dielectric and ion parameters, and the
+ * positions and radii of the atoms */
+VPRIVATE unsigned long long fillcoCoefKey(Vpmg *thee, int islap) {
+
+    Valist *alist;
+    Vatom *atom;
+    unsigned long long key;
+    double parm[10], *pos, rad;
+    int i;
+
+    alist = thee->pbe->alist;
+    parm[0] = (double)islap;
+    parm[1] = (double)(thee->surfMeth);
+    parm[2] = thee->splineWin;
+    parm[3] = Vpbe_getSoluteDiel(thee->pbe);
+    parm[4] = Vpbe_getSolventDiel(thee->pbe);
+    parm[5] = Vpbe_getBulkIonicStrength(thee->pbe);
+    parm[6] = Vpbe_getMaxIonRadius(thee->pbe);
+    parm[7] = Vpbe_getSolventRadius(thee->pbe);
+    parm[8] = thee->pbe->acc->surf_density;
+    parm[9] = (double)Valist_getNumberAtoms(alist);
+
+    key = fillcoKeyAdd(14695981039346656037ULL, parm, 10);
+    for (i=0; i<Valist_getNumberAtoms(alist); i++) {
+        atom = Valist_getAtom(alist, i);
+        pos = Vatom_getPosition(atom);
+        rad = Vatom_getRadius(atom);
+        key = fillcoKeyAdd(key, pos, 3);
+        key = fillcoKeyAdd(key, &rad, 1);
+    }
+    return key;
+}
+
+VPUBLIC int Vpmg_copyCoef(Vpmg *thee, Vpmg *pmgOLD) {
+
+    double *rtmp;
+    int *itmp;
+    int i;
+
+    if ((thee == VNULL) || (pmgOLD == VNULL)) {
+        Vnm_print(2, "Vpmg_copyCoef:  got NULL object!\n");
+        return 0;
+    }
+    if (!(pmgOLD->filled)) return 0;
+
+    /* Same work array sizes, grid and number of levels (iparm(1-6)) and
+     * the same domain (rparm(3-8), as set by Vpmg_fillco) */
+    for (i=0; i<6; i++) {
+        if (thee->iparm[i] != pmgOLD->iparm[i]) return 0;
+    }
+    if ((pmgOLD->rparm[2] != thee->pmgp->xcent - (thee->pmgp->xlen/2.0)) ||
+        (pmgOLD->rparm[3] != thee->pmgp->xcent + (thee->pmgp->xlen/2.0)) ||
+        (pmgOLD->rparm[4] != thee->pmgp->ycent - (thee->pmgp->ylen/2.0)) ||
+        (pmgOLD->rparm[5] != thee->pmgp->ycent + (thee->pmgp->ylen/2.0)) ||
+        (pmgOLD->rparm[6] != thee->pmgp->zcent - (thee->pmgp->zlen/2.0)) ||
+        (pmgOLD->rparm[7] != thee->pmgp->zcent + (thee->pmgp->zlen/2.0))) {
+        return 0;
+    }
+
+    /* Swap the maps and the work arrays, which hold the operators */
+    rtmp = thee->epsx;  thee->epsx = pmgOLD->epsx;  pmgOLD->epsx = rtmp;
+    rtmp = thee->epsy;  thee->epsy = pmgOLD->epsy;  pmgOLD->epsy = rtmp;
+    rtmp = thee->epsz;  thee->epsz = pmgOLD->epsz;  pmgOLD->epsz = rtmp;
+    rtmp = thee->kappa; thee->kappa = pmgOLD->kappa; pmgOLD->kappa = rtmp;
+    rtmp = thee->rwork; thee->rwork = pmgOLD->rwork; pmgOLD->rwork = rtmp;
+    itmp = thee->iwork; thee->iwork = pmgOLD->iwork; pmgOLD->iwork = itmp;
+
+    /* The operator cache flag and key (iparm(25-27)) go with the work
+     * arrays; see Vmgdriv2 */
+    for (i=24; i<27; i++) {
+        thee->iparm[i] = pmgOLD->iparm[i];
+        pmgOLD->iparm[i] = 0;
+    }
+
+    thee->coefKey = pmgOLD->coefKey;
+    thee->keepCoef = 1;
+    pmgOLD->filled = 0;
+
+    return 1;
 }
 
 VPUBLIC int Vpmg_fillco(Vpmg *thee,
@@ -5691,6 +7730,7 @@ VPUBLIC int Vpmg_fillco(Vpmg *thee,
         ny,
         nz,
         islap;
+    unsigned long long coefKey;
     Vrc_Codes rc;
 
     if (thee == VNULL) {
@@ -5770,9 +7810,6 @@ VPUBLIC int Vpmg_fillco(Vpmg *thee,
     for (i=0; i<ny; i++) thee->yf[i] = ymin + i*hy;
     for (i=0; i<nz; i++) thee->zf[i] = zmin + i*hzed;
 
-    /* Reset the tcf array */
-    for (i=0; i<(nx*ny*nz); i++) thee->tcf[i] = 0.0;
-
     /* Fill in the source term (atomic charges) */
     Vnm_print(0, "Vpmg_fillco:  filling in source term.\n");
     rc = fillcoCharge(thee);
@@ -5788,9 +7825,19 @@ VPUBLIC int Vpmg_fillco(Vpmg *thee,
             break;
     }
 
-    /* THE FOLLOWING NEEDS TO BE DONE IF WE'RE NOT USING A SIMPLE LAPLACIAN
-     * OPERATOR */
-    if (!islap) {
+    /* Maps taken over with Vpmg_copyCoef can be kept if they were built
+     * for the same atoms and parameters; OTHERWISE, THE FOLLOWING NEEDS TO
+     * BE DONE IF WE'RE NOT USING A SIMPLE LAPLACIAN OPERATOR */
+    coefKey = fillcoCoefKey(thee, islap);
+    if (thee->keepCoef && (thee->coefKey == coefKey) &&
+        !(thee->useDielXMap || thee->useDielYMap || thee->useDielZMap ||
+          thee->useKappaMap)) {
+        Vnm_print(0, "Vpmg_fillco:  keeping the dielectric and kappa maps\n");
+    } else if (!islap) {
+        if (thee->keepCoef) {
+            Vnm_print(1, "Vpmg_fillco:  atoms or parameters differ from the \
+reused calculation; filling the maps again\n");
+        }
         Vnm_print(0, "Vpmg_fillco:  marking ion and solvent accessibility.\n");
         fillcoCoef(thee);
         Vnm_print(0, "Vpmg_fillco:  done filling coefficient arrays\n");
@@ -5805,6 +7852,8 @@ VPUBLIC int Vpmg_fillco(Vpmg *thee,
         }
 
     } /* endif (!islap) */
+    thee->coefKey = coefKey;
+    thee->keepCoef = 0;
 
     /* Fill the boundary arrays (except when focusing, bcfl = 4) */
     if (thee->pmgp->bcfl != BCFL_FOCUS) {
@@ -5853,7 +7902,7 @@ VPUBLIC int Vpmg_ibForce(Vpmg *thee, double *force, int atomID,
     double *apos, position[3], arad, irad, zkappa2, hx, hy, hzed;
     double xlen, ylen, zlen, xmin, ymin, zmin, xmax, ymax, zmax, rtot2;
     double rtot, dx, dx2, dy, dy2, dz, dz2, gpos[3], tgrad[3], fmag;
-    double izmagic;
+    double izmagic, rin, rin2;
     int i, j, k, nx, ny, nz, imin, imax, jmin, jmax, kmin, kmax;
 
     /* For nonlinear forces */
@@ -5882,7 +7931,7 @@ calculation!\n");
     }
 
     /* If we aren't in the current position, then we're done */
-    if (atom->partID == 0) return 1;
+    if (thee->apvec[atomID] == 0) return 1;
 
     /* Get PBE info */
     pbe = thee->pbe;
@@ -5925,7 +7974,7 @@ calculation!\n");
       (apos[1]<=ymin) || (apos[1]>=ymax)  || \
       (apos[2]<=zmin) || (apos[2]>=zmax)) {
         if ((thee->pmgp->bcfl != BCFL_FOCUS) &&
-            (thee->pmgp->bcfl != BCFL_MAP)) {
+            (thee->pmgp->bcfl != BCFL_MAP) && !thee->distrib) {
             Vnm_print(2, "Vpmg_ibForce:  Atom #%d at (%4.3f, %4.3f, %4.3f) is off the mesh (ignoring):\n",
                   atom, apos[0], apos[1], apos[2]);
             Vnm_print(2, "Vpmg_ibForce:    xmin = %g, xmax = %g\n",
@@ -5943,9 +7992,13 @@ calculation!\n");
         position[1] = apos[1] - ymin;
         position[2] = apos[2] - zmin;
 
-        /* Integrate over points within this atom's (inflated) radius */
+        /* Integrate over points within this atom's (inflated) radius; the
+         * spline gradient also vanishes inside the smoothing window */
         rtot = (irad + arad + thee->splineWin);
         rtot2 = VSQR(rtot);
+        rin = irad + arad - thee->splineWin - VSMALL;
+        if (rin > 0.0) rin2 = VSQR(rin);
+        else rin2 = -1.0;
         dx = rtot + 0.5*hx;
         imin = VMAX2(0,(int)ceil((position[0] - dx)/hx));
         imax = VMIN2(nx-1,(int)floor((position[0] + dx)/hx));
@@ -5965,7 +8018,8 @@ calculation!\n");
                     dz2 = VSQR(k*hzed - position[2]);
                     /* See if grid point is inside ivdw radius and set kappa
                      * accordingly (do spline assignment here) */
-                    if ((dz2 + dy2 + dx2) <= rtot2) {
+                    if (((dz2 + dy2 + dx2) <= rtot2) &&
+                        ((dz2 + dy2 + dx2) >= rin2)) {
                         gpos[0] = i*hx + xmin;
                         gpos[1] = j*hy + ymin;
                         gpos[2] = k*hzed + zmin;
@@ -6019,8 +8073,8 @@ VPUBLIC int Vpmg_dbForce(Vpmg *thee, double *dbForce, int atomID,
     double rtot, dx, gpos[3], tgrad[3], dbFmag, epsw, kT;
     double *u, Hxijk, Hyijk, Hzijk, Hxim1jk, Hyijm1k, Hzijkm1;
     double dHxijk[3], dHyijk[3], dHzijk[3], dHxim1jk[3], dHyijm1k[3];
-    double dHzijkm1[3];
-    int i, j, k, l, nx, ny, nz, imin, imax, jmin, jmax, kmin, kmax;
+    double dHzijkm1[3], pad, rin, rin2, rout2, dx2, dy2, dz2, dz;
+    int i, j, k, l, nx, ny, nz, imin, imax, jmin, jmax, kmin, kmax, klo, khi;
 
     VASSERT(thee != VNULL);
     if (!thee->filled) {
@@ -6050,7 +8104,7 @@ force calculation!\n");
 
 
     /* If we aren't in the current position, then we're done */
-    if (atom->partID == 0) return 1;
+    if (thee->apvec[atomID] == 0) return 1;
 
     /* Get PBE info */
     pbe = thee->pbe;
@@ -6093,7 +8147,7 @@ force calculation!\n");
         (apos[1]<=ymin + rtot) || (apos[1]>=ymax - rtot)  || \
         (apos[2]<=zmin + rtot) || (apos[2]>=zmax - rtot)) {
         if ((thee->pmgp->bcfl != BCFL_FOCUS) &&
-            (thee->pmgp->bcfl != BCFL_MAP)) {
+            (thee->pmgp->bcfl != BCFL_MAP) && !thee->distrib) {
             Vnm_print(2, "Vpmg_dbForce:  Atom #%d at (%4.3f, %4.3f, %4.3f) is off the mesh (ignoring):\n",
                       atomID, apos[0], apos[1], apos[2]);
             Vnm_print(2, "Vpmg_dbForce:    xmin = %g, xmax = %g\n",
@@ -6144,9 +8198,28 @@ force calculation!\n");
             Vnm_print(2, "Vpmg_dbForce:  Atom %d off grid!\n", atomID);
             return 0;
         }
+
+        /* The spline gradient vanishes outside this atom's smoothing
+         * window, so only points with a face in the window shell
+         * contribute; the faces are within half a spacing of the point */
+        pad = 0.5*VMAX2(hx, VMAX2(hy, hzed)) + VSMALL;
+        rout2 = VSQR(arad + thee->splineWin + pad);
+        rin = arad - thee->splineWin - pad;
+        if (rin > 0.0) rin2 = VSQR(rin);
+        else rin2 = -1.0;
         for (i=imin; i<=imax; i++) {
+            dx2 = VSQR(hx*i - position[0]);
+            if (dx2 > rout2) continue;
             for (j=jmin; j<=jmax; j++) {
-                for (k=kmin; k<=kmax; k++) {
+                dy2 = VSQR(hy*j - position[1]);
+                if ((dx2 + dy2) > rout2) continue;
+                dz = VSQRT(rout2 - dx2 - dy2);
+                klo = VMAX2(kmin, (int)floor((position[2] - dz)/hzed));
+                khi = VMIN2(kmax, (int)ceil((position[2] + dz)/hzed));
+                for (k=klo; k<=khi; k++) {
+                    dz2 = VSQR(hzed*k - position[2]);
+                    if (((dx2 + dy2 + dz2) > rout2) ||
+                        ((dx2 + dy2 + dz2) < rin2)) continue;
                     /* i,j,k */
                     gpos[0] = (i+0.5)*hx + xmin;
                     gpos[1] = j*hy + ymin;
@@ -6330,7 +8403,7 @@ VPRIVATE void qfForceSpline1(Vpmg *thee, double *force, int atomID) {
     force[2] = 0.0;
 
     /* If we aren't in the current position, then we're done */
-    if (atom->partID == 0) return;
+    if (thee->apvec[atomID] == 0) return;
 
     /* Mesh info */
     nx = thee->pmgp->nx;
@@ -6351,7 +8424,7 @@ VPRIVATE void qfForceSpline1(Vpmg *thee, double *force, int atomID) {
     if ((apos[0]<=xmin) || (apos[0]>=xmax) || (apos[1]<=ymin) || \
         (apos[1]>=ymax) || (apos[2]<=zmin) || (apos[2]>=zmax)) {
         if ((thee->pmgp->bcfl != BCFL_FOCUS) &&
-            (thee->pmgp->bcfl != BCFL_MAP)) {
+            (thee->pmgp->bcfl != BCFL_MAP) && !thee->distrib) {
             Vnm_print(2, "Vpmg_qfForce:  Atom #%d at (%4.3f, %4.3f, %4.3f) is off the mesh (ignoring):\n", atomID, apos[0], apos[1], apos[2]);
             Vnm_print(2, "Vpmg_qfForce:    xmin = %g, xmax = %g\n", xmin, xmax);
             Vnm_print(2, "Vpmg_qfForce:    ymin = %g, ymax = %g\n", ymin, ymax);
@@ -6468,7 +8541,7 @@ VPRIVATE void qfForceSpline2(Vpmg *thee, double *force, int atomID) {
     force[2] = 0.0;
 
     /* If we aren't in the current position, then we're done */
-    if (atom->partID == 0) return;
+    if (thee->apvec[atomID] == 0) return;
 
     /* Mesh info */
     nx = thee->pmgp->nx;
@@ -6493,7 +8566,7 @@ VPRIVATE void qfForceSpline2(Vpmg *thee, double *force, int atomID) {
      || (apos[1]<=(ymin+hy))   || (apos[1]>=(ymax-hy)) \
      || (apos[2]<=(zmin+hzed)) || (apos[2]>=(zmax-hzed))) {
         if ((thee->pmgp->bcfl != BCFL_FOCUS) &&
-            (thee->pmgp->bcfl != BCFL_MAP)) {
+            (thee->pmgp->bcfl != BCFL_MAP) && !thee->distrib) {
             Vnm_print(2, "qfForceSpline2:  Atom #%d off the mesh \
                 (ignoring)\n", atomID);
         }
@@ -7041,13 +9114,14 @@ VPRIVATE void zlapSolve(
 
 VPUBLIC int Vpmg_solveLaplace(Vpmg *thee) {
 
-    int i, j, k, ijk, nx, ny, nz, n, dilo, dihi, djlo, djhi, dklo, dkhi;
+    int i, j, k, ijk, nx, ny, nz, n, narr, dilo, dihi, djlo, djhi, dklo, dkhi;
     double hx, hy, hzed, epsw, iepsw, scal, scalx, scaly, scalz;
 
     nx = thee->pmgp->nx;
     ny = thee->pmgp->ny;
     nz = thee->pmgp->nz;
     n = nx*ny*nz;
+    narr = thee->pmgp->narr;
     hx = thee->pmgp->hx;
     hy = thee->pmgp->hy;
     hzed = thee->pmgp->hzed;
@@ -7063,6 +9137,14 @@ VPUBLIC int Vpmg_solveLaplace(Vpmg *thee) {
         return 0;
     }
 
+    /* The RHS and work arrays only live for the solve (see Vpmg_solve) */
+    thee->fcf = (double *)Vmem_malloc(thee->vmem, narr, sizeof(double));
+    thee->tcf = (double *)Vmem_malloc(thee->vmem, narr, sizeof(double));
+    for (i=0; i<n; i++) {
+        thee->fcf[i] = 0.0;
+        thee->tcf[i] = 0.0;
+    }
+
     /* Load boundary conditions into the RHS array */
     for (i=1; i<(nx-1); i++) {
 
@@ -7101,6 +9183,8 @@ VPUBLIC int Vpmg_solveLaplace(Vpmg *thee) {
 
     /* Solve */
     zlapSolve( thee, &(thee->u), &(thee->fcf), &(thee->tcf) );
+    Vmem_free(thee->vmem, narr, sizeof(double), (void **)&(thee->fcf));
+    Vmem_free(thee->vmem, narr, sizeof(double), (void **)&(thee->tcf));
 
     /* Add boundary conditions to solution */
     /* i faces */
@@ -7250,17 +9334,15 @@ VPUBLIC void fillcoPermanentMultipole(Vpmg *thee) {
     double hx, hy, hzed, *apos;
     /* Multipole */
     double charge, *dipole,*quad;
-    double c,ux,uy,uz,qxx,qyx,qyy,qzx,qzy,qzz,qave;
+    double c,ux,uy,uz,qxx,qyx,qyy,qzx,qzy,qzz;
     /* B-spline weights */
     double mx,my,mz,dmx,dmy,dmz,d2mx,d2my,d2mz;
     double mi,mj,mk;
     /* Loop variables */
-    int i, ii, jj, kk, nx, ny, nz, iatom;
-    int im2, im1, ip1, ip2, jm2, jm1, jp1, jp2, km2, km1, kp1, kp2;
-
-    /* sanity check */
-    double mir,mjr,mkr,mr2;
-    double debye,mc,mux,muy,muz,mqxx,mqyx,mqyy,mqzx,mqzy,mqzz;
+    int ii, jj, kk, k, nx, ny, nz, iatom;
+    int im2, im1, ip1, ip2, jm2, jm1, jp1, jp2;
+    /* Atoms in each z-plane */
+    int natoms, nlist, ilist, *kmin, *kmax, *plane, *list;
 
     VASSERT(thee != VNULL);
 
@@ -7293,50 +9375,16 @@ VPUBLIC void fillcoPermanentMultipole(Vpmg *thee) {
     ymax = thee->pmgp->ycent + (ylen/2.0);
     zmax = thee->pmgp->zcent + (zlen/2.0);
 
-    /* Fill in the source term (permanent atomic multipoles) */
-    Vnm_print(0, "fillcoPermanentMultipole:  filling in source term.\n");
-    for (iatom=0; iatom<Valist_getNumberAtoms(alist); iatom++) {
+    /* Find the z-planes each atom touches */
+    natoms = Valist_getNumberAtoms(alist);
+    kmin = (int*)Vmem_malloc(thee->vmem, VMAX2(natoms,1), sizeof(int));
+    kmax = (int*)Vmem_malloc(thee->vmem, VMAX2(natoms,1), sizeof(int));
+    for (iatom=0; iatom<natoms; iatom++) {
 
         atom = Valist_getAtom(alist, iatom);
         apos = Vatom_getPosition(atom);
-
-        c = Vatom_getCharge(atom)*f;
-
-#if defined(WITH_TINKER)
-        dipole = Vatom_getDipole(atom);
-        ux = dipole[0]/hx*f;
-        uy = dipole[1]/hy*f;
-        uz = dipole[2]/hzed*f;
-        quad = Vatom_getQuadrupole(atom);
-        qxx = (1.0/3.0)*quad[0]/(hx*hx)*f;
-        qyx = (2.0/3.0)*quad[3]/(hx*hy)*f;
-        qyy = (1.0/3.0)*quad[4]/(hy*hy)*f;
-        qzx = (2.0/3.0)*quad[6]/(hzed*hx)*f;
-        qzy = (2.0/3.0)*quad[7]/(hzed*hy)*f;
-        qzz = (1.0/3.0)*quad[8]/(hzed*hzed)*f;
-#else
-        ux = 0.0;
-        uy = 0.0;
-        uz = 0.0;
-        qxx = 0.0;
-        qyx = 0.0;
-        qyy = 0.0;
-        qzx = 0.0;
-        qzy = 0.0;
-        qzz = 0.0;
-#endif /* if defined(WITH_TINKER) */
-
-        /* check
-        mc = 0.0;
-        mux = 0.0;
-        muy = 0.0;
-        muz = 0.0;
-        mqxx = 0.0;
-        mqyx = 0.0;
-        mqyy = 0.0;
-        mqzx = 0.0;
-        mqzy = 0.0;
-        mqzz = 0.0; */
+        kmin[iatom] = 0;
+        kmax[iatom] = -1;
 
         /* Make sure we're on the grid */
         if ((apos[0]<=(xmin-2*hx)) || (apos[0]>=(xmax+2*hx))  || \
@@ -7348,6 +9396,53 @@ VPUBLIC void fillcoPermanentMultipole(Vpmg *thee) {
             Vnm_print(2, "fillcoPermanentMultipole: zmin = %g, zmax = %g\n", zmin, zmax);
             fflush(stderr);
         } else {
+            position[2] = apos[2] - zmin;
+            kfloat = position[2]/hzed;
+            kmin[iatom] = VMAX2((int)floor(kfloat) - 2, 0);
+            kmax[iatom] = VMIN2((int)ceil(kfloat) + 2, nz-1);
+        } /* endif (on the mesh) */
+    } /* endfor (each atom) */
+    nlist = fillcoChargePlanes(thee, natoms, kmin, kmax, &plane, &list);
+
+    /* Fill in the source term (permanent atomic multipoles).  Each z-plane
+     * is filled by one thread in atom order, so the sums do not depend on
+     * the number of threads. */
+    Vnm_print(0, "fillcoPermanentMultipole:  filling in source term.\n");
+#pragma omp parallel for default(shared) schedule(dynamic,1) \
+  private(k,ilist,atom,apos,dipole,quad,c,ux,uy,uz,qxx,qyx,qyy,qzx,qzy,qzz,\
+  position,ifloat,jfloat,kfloat,im2,im1,ip1,ip2,jm2,jm1,jp1,jp2,ii,jj,kk,\
+  mi,mj,mk,mx,my,mz,dmx,dmy,dmz,d2mx,d2my,d2mz,charge)
+    for (k=0; k<nz; k++) {
+        for (ilist=plane[k]; ilist<plane[k+1]; ilist++) {
+
+            atom = Valist_getAtom(alist, list[ilist]);
+            apos = Vatom_getPosition(atom);
+
+            c = Vatom_getCharge(atom)*f;
+
+#if defined(WITH_TINKER)
+            dipole = Vatom_getDipole(atom);
+            ux = dipole[0]/hx*f;
+            uy = dipole[1]/hy*f;
+            uz = dipole[2]/hzed*f;
+            quad = Vatom_getQuadrupole(atom);
+            qxx = (1.0/3.0)*quad[0]/(hx*hx)*f;
+            qyx = (2.0/3.0)*quad[3]/(hx*hy)*f;
+            qyy = (1.0/3.0)*quad[4]/(hy*hy)*f;
+            qzx = (2.0/3.0)*quad[6]/(hzed*hx)*f;
+            qzy = (2.0/3.0)*quad[7]/(hzed*hy)*f;
+            qzz = (1.0/3.0)*quad[8]/(hzed*hzed)*f;
+#else
+            ux = 0.0;
+            uy = 0.0;
+            uz = 0.0;
+            qxx = 0.0;
+            qyx = 0.0;
+            qyy = 0.0;
+            qzx = 0.0;
+            qzy = 0.0;
+            qzz = 0.0;
+#endif /* if defined(WITH_TINKER) */
 
             /* Convert the atom position to grid reference frame */
             position[0] = apos[0] - xmin;
@@ -7367,10 +9462,6 @@ VPUBLIC void fillcoPermanentMultipole(Vpmg *thee) {
             jp2   = jp1 + 2;
             jm1   = (int)floor(jfloat);
             jm2   = jm1 - 2;
-            kp1   = (int)ceil(kfloat);
-            kp2   = kp1 + 2;
-            km1   = (int)floor(kfloat);
-            km2   = km1 - 2;
 
             /* This step shouldn't be necessary, but it saves nasty debugging
              * later on if something goes wrong */
@@ -7382,12 +9473,14 @@ VPUBLIC void fillcoPermanentMultipole(Vpmg *thee) {
             jp1 = VMIN2(jp1,ny-1);
             jm1 = VMAX2(jm1,0);
             jm2 = VMAX2(jm2,0);
-            kp2 = VMIN2(kp2,nz-1);
-            kp1 = VMIN2(kp1,nz-1);
-            km1 = VMAX2(km1,0);
-            km2 = VMAX2(km2,0);
 
-            /* Now assign fractions of the charge to the nearby verts */
+            /* Now assign fractions of the charge to the nearby verts in
+             * this plane */
+            kk = k;
+            mk = VFCHI4(kk,kfloat);
+            mz = bspline4(mk);
+            dmz = dbspline4(mk);
+            d2mz = d2bspline4(mk);
             for (ii=im2; ii<=ip2; ii++) {
                 mi = VFCHI4(ii,ifloat);
                 mx = bspline4(mi);
@@ -7398,74 +9491,21 @@ VPUBLIC void fillcoPermanentMultipole(Vpmg *thee) {
                     my = bspline4(mj);
                     dmy = dbspline4(mj);
                     d2my = d2bspline4(mj);
-                    for (kk=km2; kk<=kp2; kk++) {
-                        mk = VFCHI4(kk,kfloat);
-                        mz = bspline4(mk);
-                        dmz = dbspline4(mk);
-                        d2mz = d2bspline4(mk);
-                        charge = mx*my*mz*c -
-                         dmx*my*mz*ux - mx*dmy*mz*uy - mx*my*dmz*uz +
-                         d2mx*my*mz*qxx +
-                         dmx*dmy*mz*qyx + mx*d2my*mz*qyy +
-                         dmx*my*dmz*qzx + mx*dmy*dmz*qzy + mx*my*d2mz*qzz;
-                        thee->charge[IJK(ii,jj,kk)] += charge;
-
-                        /* sanity check - recalculate traceless multipoles
-                           from the grid charge distribution for this
-                           site.
-
-                        mir = (mi - 2.5) * hx;
-                        mjr = (mj - 2.5) * hy;
-                        mkr = (mk - 2.5) * hzed;
-                        mr2 = mir*mir+mjr*mjr+mkr*mkr;
-                        mc += charge;
-                        mux += mir * charge;
-                        muy += mjr * charge;
-                        muz += mkr * charge;
-                        mqxx += (1.5*mir*mir - 0.5*mr2) * charge;
-                        mqyx += 1.5*mjr*mir * charge;
-                        mqyy += (1.5*mjr*mjr - 0.5*mr2) * charge;
-                        mqzx += 1.5*mkr*mir * charge;
-                        mqzy += 1.5*mkr*mjr * charge;
-                        mqzz += (1.5*mkr*mkr - 0.5*mr2) * charge;
-                         */
-                    }
+                    charge = mx*my*mz*c -
+                     dmx*my*mz*ux - mx*dmy*mz*uy - mx*my*dmz*uz +
+                     d2mx*my*mz*qxx +
+                     dmx*dmy*mz*qyx + mx*d2my*mz*qyy +
+                     dmx*my*dmz*qzx + mx*dmy*dmz*qzy + mx*my*d2mz*qzz;
+                    thee->charge[IJK(ii,jj,kk)] += charge;
                 }
             }
-        } /* endif (on the mesh) */
-
-        /* print out the Grid vs. Ideal Point Multipole. */
-
-        /*
-        debye = 4.8033324;
-        mc = mc/f;
-        mux = mux/f*debye;
-        muy = muy/f*debye;
-        muz = muz/f*debye;
-        mqxx = mqxx/f*debye;
-        mqyy = mqyy/f*debye;
-        mqzz = mqzz/f*debye;
-        mqyx = mqyx/f*debye;
-        mqzx = mqzx/f*debye;
-        mqzy = mqzy/f*debye;
-
-        printf(" Grid v. Actual Permanent Multipole for Site %i\n",iatom);
-        printf(" G: %10.6f\n",mc);
-        printf(" A: %10.6f\n\n",c/f);
-        printf(" G: %10.6f %10.6f %10.6f\n",mux,muy,muz);
-        printf(" A: %10.6f %10.6f %10.6f\n\n",
-                 (ux * hx / f) * debye,
-                 (uy * hy / f) * debye,
-                 (uz * hzed /f) * debye);
-        printf(" G: %10.6f\n",mqxx);
-        printf(" A: %10.6f\n",quad[0]*debye);
-        printf(" G: %10.6f %10.6f\n",mqyx,mqyy);
-        printf(" A: %10.6f %10.6f\n",quad[3]*debye,quad[4]*debye);
-        printf(" G: %10.6f %10.6f %10.6f\n",mqzx,mqzy,mqzz);
-        printf(" A: %10.6f %10.6f %10.6f\n\n",
-                quad[6]*debye,quad[7]*debye,quad[8]*debye);  */
+        } /* endfor (each atom in the plane) */
+    } /* endfor (each plane) */
 
-    } /* endfor (each atom) */
+    Vmem_free(thee->vmem, VMAX2(nlist,1), sizeof(int), (void **)&list);
+    Vmem_free(thee->vmem, nz+1, sizeof(int), (void **)&plane);
+    Vmem_free(thee->vmem, VMAX2(natoms,1), sizeof(int), (void **)&kmax);
+    Vmem_free(thee->vmem, VMAX2(natoms,1), sizeof(int), (void **)&kmin);
 }
 
 #if defined(WITH_TINKER)
@@ -7479,20 +9519,18 @@ VPUBLIC void fillcoInducedDipole(Vpmg *thee) {
     double zmagic, f;
     /* Grid */
     double xmin, xmax, ymin, ymax, zmin, zmax;
-    double xlen, ylen, zlen, ifloat, jfloat, kfloat;
-    double hx, hy, hzed, *apos, position[3];
+    double xlen, ylen, zlen, position[3], ifloat, jfloat, kfloat;
+    double hx, hy, hzed, *apos;
     /* B-spline weights */
     double mx, my, mz, dmx, dmy, dmz;
     /* Dipole */
     double charge, *dipole, ux,uy,uz;
     double mi,mj,mk;
     /* Loop indeces */
-    int i, ii, jj, kk, nx, ny, nz, iatom;
-    int im2, im1, ip1, ip2, jm2, jm1, jp1, jp2, km2, km1, kp1, kp2;
-
-    double debye;
-    double mux,muy,muz;
-    double mir,mjr,mkr;
+    int ii, jj, kk, k, nx, ny, nz, iatom;
+    int im2, im1, ip1, ip2, jm2, jm1, jp1, jp2;
+    /* Atoms in each z-plane */
+    int natoms, nlist, ilist, *kmin, *kmax, *plane, *list;
 
     VASSERT(thee != VNULL);
 
@@ -7525,21 +9563,16 @@ VPUBLIC void fillcoInducedDipole(Vpmg *thee) {
     ymax = thee->pmgp->ycent + (ylen/2.0);
     zmax = thee->pmgp->zcent + (zlen/2.0);
 
-    /* Fill in the source term (induced dipoles) */
-    Vnm_print(0, "fillcoInducedDipole:  filling in the source term.\n");
-    for (iatom=0; iatom<Valist_getNumberAtoms(alist); iatom++) {
+    /* Find the z-planes each atom touches */
+    natoms = Valist_getNumberAtoms(alist);
+    kmin = (int*)Vmem_malloc(thee->vmem, VMAX2(natoms,1), sizeof(int));
+    kmax = (int*)Vmem_malloc(thee->vmem, VMAX2(natoms,1), sizeof(int));
+    for (iatom=0; iatom<natoms; iatom++) {
 
         atom = Valist_getAtom(alist, iatom);
         apos = Vatom_getPosition(atom);
-
-        dipole = Vatom_getInducedDipole(atom);
-        ux = dipole[0]/hx*f;
-        uy = dipole[1]/hy*f;
-        uz = dipole[2]/hzed*f;
-
-        mux = 0.0;
-        muy = 0.0;
-        muz = 0.0;
+        kmin[iatom] = 0;
+        kmax[iatom] = -1;
 
         /* Make sure we're on the grid */
         if ((apos[0]<=(xmin-2*hx)) || (apos[0]>=(xmax+2*hx))  || \
@@ -7551,6 +9584,32 @@ VPUBLIC void fillcoInducedDipole(Vpmg *thee) {
             Vnm_print(2, "fillcoInducedDipole: zmin = %g, zmax = %g\n", zmin, zmax);
             fflush(stderr);
         } else {
+            position[2] = apos[2] - zmin;
+            kfloat = position[2]/hzed;
+            kmin[iatom] = VMAX2((int)floor(kfloat) - 2, 0);
+            kmax[iatom] = VMIN2((int)ceil(kfloat) + 2, nz-1);
+        } /* endif (on the mesh) */
+    } /* endfor (each atom) */
+    nlist = fillcoChargePlanes(thee, natoms, kmin, kmax, &plane, &list);
+
+    /* Fill in the source term (induced dipoles).  Each z-plane is filled by
+     * one thread in atom order, so the sums do not depend on the number of
+     * threads. */
+    Vnm_print(0, "fillcoInducedDipole:  filling in the source term.\n");
+#pragma omp parallel for default(shared) schedule(dynamic,1) \
+  private(k,ilist,atom,apos,dipole,ux,uy,uz,position,ifloat,jfloat,kfloat,\
+  im2,im1,ip1,ip2,jm2,jm1,jp1,jp2,ii,jj,kk,mi,mj,mk,mx,my,mz,dmx,dmy,dmz,\
+  charge)
+    for (k=0; k<nz; k++) {
+        for (ilist=plane[k]; ilist<plane[k+1]; ilist++) {
+
+            atom = Valist_getAtom(alist, list[ilist]);
+            apos = Vatom_getPosition(atom);
+
+            dipole = Vatom_getInducedDipole(atom);
+            ux = dipole[0]/hx*f;
+            uy = dipole[1]/hy*f;
+            uz = dipole[2]/hzed*f;
 
             /* Convert the atom position to grid reference frame */
             position[0] = apos[0] - xmin;
@@ -7570,10 +9629,6 @@ VPUBLIC void fillcoInducedDipole(Vpmg *thee) {
             jp2   = jp1 + 2;
             jm1   = (int)floor(jfloat);
             jm2   = jm1 - 2;
-            kp1   = (int)ceil(kfloat);
-            kp2   = kp1 + 2;
-            km1   = (int)floor(kfloat);
-            km2   = km1 - 2;
 
             /* This step shouldn't be necessary, but it saves nasty debugging
              * later on if something goes wrong */
@@ -7585,12 +9640,13 @@ VPUBLIC void fillcoInducedDipole(Vpmg *thee) {
             jp1 = VMIN2(jp1,ny-1);
             jm1 = VMAX2(jm1,0);
             jm2 = VMAX2(jm2,0);
-            kp2 = VMIN2(kp2,nz-1);
-            kp1 = VMIN2(kp1,nz-1);
-            km1 = VMAX2(km1,0);
-            km2 = VMAX2(km2,0);
 
-            /* Now assign fractions of the dipole to the nearby verts */
+            /* Now assign fractions of the dipole to the nearby verts in
+             * this plane */
+            kk = k;
+            mk = VFCHI4(kk,kfloat);
+            mz = bspline4(mk);
+            dmz = dbspline4(mk);
             for (ii=im2; ii<=ip2; ii++) {
                 mi = VFCHI4(ii,ifloat);
                 mx = bspline4(mi);
@@ -7599,41 +9655,17 @@ VPUBLIC void fillcoInducedDipole(Vpmg *thee) {
                     mj = VFCHI4(jj,jfloat);
                     my = bspline4(mj);
                     dmy = dbspline4(mj);
-                    for (kk=km2; kk<=kp2; kk++) {
-                        mk = VFCHI4(kk,kfloat);
-                        mz = bspline4(mk);
-                        dmz = dbspline4(mk);
-                        charge = -dmx*my*mz*ux - mx*dmy*mz*uy - mx*my*dmz*uz;
-                        thee->charge[IJK(ii,jj,kk)] += charge;
-
-                        /*
-                        mir = (mi - 2.5) * hx;
-                        mjr = (mj - 2.5) * hy;
-                        mkr = (mk - 2.5) * hzed;
-                        mux += mir * charge;
-                        muy += mjr * charge;
-                        muz += mkr * charge;
-                        */
-                    }
+                    charge = -dmx*my*mz*ux - mx*dmy*mz*uy - mx*my*dmz*uz;
+                    thee->charge[IJK(ii,jj,kk)] += charge;
                 }
             }
-        } /* endif (on the mesh) */
+        } /* endfor (each atom in the plane) */
+    } /* endfor (each plane) */
 
-        /* check
-        debye = 4.8033324;
-        mux = mux/f*debye;
-        muy = muy/f*debye;
-        muz = muz/f*debye;
-
-        printf(" Grid v. Actual Induced Dipole for Site %i\n",iatom);
-        printf(" G: %10.6f %10.6f %10.6f\n",mux,muy,muz);
-        printf(" A: %10.6f %10.6f %10.6f\n\n",
-                 (ux * hx / f) * debye,
-                 (uy * hy / f) * debye,
-                 (uz * hzed /f) * debye);
-         */
-
-    } /* endfor (each atom) */
+    Vmem_free(thee->vmem, VMAX2(nlist,1), sizeof(int), (void **)&list);
+    Vmem_free(thee->vmem, nz+1, sizeof(int), (void **)&plane);
+    Vmem_free(thee->vmem, VMAX2(natoms,1), sizeof(int), (void **)&kmax);
+    Vmem_free(thee->vmem, VMAX2(natoms,1), sizeof(int), (void **)&kmin);
 }
 
 VPUBLIC void fillcoNLInducedDipole(Vpmg *thee) {
@@ -7645,22 +9677,18 @@ VPUBLIC void fillcoNLInducedDipole(Vpmg *thee) {
     double zmagic, f;
     /* Grid */
     double xmin, xmax, ymin, ymax, zmin, zmax;
-    double xlen, ylen, zlen, ifloat, jfloat, kfloat;
-    double hx, hy, hzed, *apos, position[3];
+    double xlen, ylen, zlen, position[3], ifloat, jfloat, kfloat;
+    double hx, hy, hzed, *apos;
     /* B-spline weights */
     double mx, my, mz, dmx, dmy, dmz;
     /* Dipole */
     double charge, *dipole, ux,uy,uz;
     double mi,mj,mk;
     /* Loop indeces */
-    int i, ii, jj, kk, nx, ny, nz, iatom;
-    int im2, im1, ip1, ip2, jm2, jm1, jp1, jp2, km2, km1, kp1, kp2;
-
-    /* sanity check
-    double debye;
-    double mux,muy,muz;
-    double mir,mjr,mkr;
-     */
+    int ii, jj, kk, k, nx, ny, nz, iatom;
+    int im2, im1, ip1, ip2, jm2, jm1, jp1, jp2;
+    /* Atoms in each z-plane */
+    int natoms, nlist, ilist, *kmin, *kmax, *plane, *list;
 
     VASSERT(thee != VNULL);
 
@@ -7693,23 +9721,16 @@ VPUBLIC void fillcoNLInducedDipole(Vpmg *thee) {
     ymax = thee->pmgp->ycent + (ylen/2.0);
     zmax = thee->pmgp->zcent + (zlen/2.0);
 
-    /* Fill in the source term (non-local induced dipoles) */
-    Vnm_print(0, "fillcoNLInducedDipole:  filling in source term.\n");
-    for (iatom=0; iatom<Valist_getNumberAtoms(alist); iatom++) {
+    /* Find the z-planes each atom touches */
+    natoms = Valist_getNumberAtoms(alist);
+    kmin = (int*)Vmem_malloc(thee->vmem, VMAX2(natoms,1), sizeof(int));
+    kmax = (int*)Vmem_malloc(thee->vmem, VMAX2(natoms,1), sizeof(int));
+    for (iatom=0; iatom<natoms; iatom++) {
 
         atom = Valist_getAtom(alist, iatom);
         apos = Vatom_getPosition(atom);
-
-        dipole = Vatom_getNLInducedDipole(atom);
-        ux = dipole[0]/hx*f;
-        uy = dipole[1]/hy*f;
-        uz = dipole[2]/hzed*f;
-
-        /*
-        mux = 0.0;
-        muy = 0.0;
-        muz = 0.0;
-         */
+        kmin[iatom] = 0;
+        kmax[iatom] = -1;
 
         /* Make sure we're on the grid */
         if ((apos[0]<=(xmin-2*hx)) || (apos[0]>=(xmax+2*hx))  || \
@@ -7721,6 +9742,32 @@ VPUBLIC void fillcoNLInducedDipole(Vpmg *thee) {
             Vnm_print(2, "fillcoNLInducedDipole: zmin = %g, zmax = %g\n", zmin, zmax);
             fflush(stderr);
         } else {
+            position[2] = apos[2] - zmin;
+            kfloat = position[2]/hzed;
+            kmin[iatom] = VMAX2((int)floor(kfloat) - 2, 0);
+            kmax[iatom] = VMIN2((int)ceil(kfloat) + 2, nz-1);
+        } /* endif (on the mesh) */
+    } /* endfor (each atom) */
+    nlist = fillcoChargePlanes(thee, natoms, kmin, kmax, &plane, &list);
+
+    /* Fill in the source term (non-local induced dipoles).  Each z-plane is
+     * filled by one thread in atom order, so the sums do not depend on the
+     * number of threads. */
+    Vnm_print(0, "fillcoNLInducedDipole:  filling in source term.\n");
+#pragma omp parallel for default(shared) schedule(dynamic,1) \
+  private(k,ilist,atom,apos,dipole,ux,uy,uz,position,ifloat,jfloat,kfloat,\
+  im2,im1,ip1,ip2,jm2,jm1,jp1,jp2,ii,jj,kk,mi,mj,mk,mx,my,mz,dmx,dmy,dmz,\
+  charge)
+    for (k=0; k<nz; k++) {
+        for (ilist=plane[k]; ilist<plane[k+1]; ilist++) {
+
+            atom = Valist_getAtom(alist, list[ilist]);
+            apos = Vatom_getPosition(atom);
+
+            dipole = Vatom_getNLInducedDipole(atom);
+            ux = dipole[0]/hx*f;
+            uy = dipole[1]/hy*f;
+            uz = dipole[2]/hzed*f;
 
             /* Convert the atom position to grid reference frame */
             position[0] = apos[0] - xmin;
@@ -7740,10 +9787,6 @@ VPUBLIC void fillcoNLInducedDipole(Vpmg *thee) {
             jp2   = jp1 + 2;
             jm1   = (int)floor(jfloat);
             jm2   = jm1 - 2;
-            kp1   = (int)ceil(kfloat);
-            kp2   = kp1 + 2;
-            km1   = (int)floor(kfloat);
-            km2   = km1 - 2;
 
             /* This step shouldn't be necessary, but it saves nasty debugging
              * later on if something goes wrong */
@@ -7755,13 +9798,13 @@ VPUBLIC void fillcoNLInducedDipole(Vpmg *thee) {
             jp1 = VMIN2(jp1,ny-1);
             jm1 = VMAX2(jm1,0);
             jm2 = VMAX2(jm2,0);
-            kp2 = VMIN2(kp2,nz-1);
-            kp1 = VMIN2(kp1,nz-1);
-            km1 = VMAX2(km1,0);
-            km2 = VMAX2(km2,0);
 
             /* Now assign fractions of the non local induced dipole
-               to the nearby verts */
+             * to the nearby verts in this plane */
+            kk = k;
+            mk = VFCHI4(kk,kfloat);
+            mz = bspline4(mk);
+            dmz = dbspline4(mk);
             for (ii=im2; ii<=ip2; ii++) {
                 mi = VFCHI4(ii,ifloat);
                 mx = bspline4(mi);
@@ -7770,40 +9813,17 @@ VPUBLIC void fillcoNLInducedDipole(Vpmg *thee) {
                     mj = VFCHI4(jj,jfloat);
                     my = bspline4(mj);
                     dmy = dbspline4(mj);
-                    for (kk=km2; kk<=kp2; kk++) {
-                        mk = VFCHI4(kk,kfloat);
-                        mz = bspline4(mk);
-                        dmz = dbspline4(mk);
-                        charge = -dmx*my*mz*ux - mx*dmy*mz*uy - mx*my*dmz*uz;
-                        thee->charge[IJK(ii,jj,kk)] += charge;
-
-                        /*
-                        mir = (mi - 2.5) * hx;
-                        mjr = (mj - 2.5) * hy;
-                        mkr = (mk - 2.5) * hzed;
-                        mux += mir * charge;
-                        muy += mjr * charge;
-                        muz += mkr * charge;
-                         */
-                    }
+                    charge = -dmx*my*mz*ux - mx*dmy*mz*uy - mx*my*dmz*uz;
+                    thee->charge[IJK(ii,jj,kk)] += charge;
                 }
             }
-        } /* endif (on the mesh) */
-
-        /*
-        debye = 4.8033324;
-        mux = mux/f*debye;
-        muy = muy/f*debye;
-        muz = muz/f*debye;
-
-        printf(" Grid v. Actual Non-Local Induced Dipole for Site %i\n",iatom);
-        printf(" G: %10.6f %10.6f %10.6f\n",mux,muy,muz);
-        printf(" A: %10.6f %10.6f %10.6f\n\n",
-                 (ux * hx / f) * debye,
-                 (uy * hy / f) * debye,
-                 (uz * hzed /f) * debye); */
+        } /* endfor (each atom in the plane) */
+    } /* endfor (each plane) */
 
-    } /* endfor (each atom) */
+    Vmem_free(thee->vmem, VMAX2(nlist,1), sizeof(int), (void **)&list);
+    Vmem_free(thee->vmem, nz+1, sizeof(int), (void **)&plane);
+    Vmem_free(thee->vmem, VMAX2(natoms,1), sizeof(int), (void **)&kmax);
+    Vmem_free(thee->vmem, VMAX2(natoms,1), sizeof(int), (void **)&kmin);
 }
 
 VPUBLIC double Vpmg_qfPermanentMultipoleEnergy(Vpmg *thee, int atomID) {
@@ -7850,7 +9870,7 @@ VPUBLIC double Vpmg_qfPermanentMultipoleEnergy(Vpmg *thee, int atomID) {
 
     /* Currently all atoms must be in the same partition. */
 
-    VASSERT(atom->partID != 0);
+    VASSERT(thee->apvec[atomID] != 0);
 
     /* Convert the atom position to grid coordinates */
 
@@ -7989,7 +10009,7 @@ VPUBLIC void Vpmg_fieldSpline4(Vpmg *thee, int atomID, double field[3]) {
 
     /* Currently all atoms must be in the same partition. */
 
-    VASSERT (atom->partID != 0);
+    VASSERT (thee->apvec[atomID] != 0);
 
     /* Convert the atom position to grid coordinates */
 
@@ -8087,7 +10107,7 @@ VPUBLIC void Vpmg_qfPermanentMultipoleForce(Vpmg *thee, int atomID,
 
     /* Currently all atoms must be in the same partition. */
 
-    VASSERT(atom->partID != 0);
+    VASSERT(thee->apvec[atomID] != 0);
 
     apos = Vatom_getPosition(atom);
 
@@ -8310,7 +10330,7 @@ VPUBLIC void Vpmg_ibPermanentMultipoleForce(Vpmg *thee, int atomID,
 
     /* Currently all atoms must be in the same partition. */
 
-    VASSERT(atom->partID != 0);
+    VASSERT(thee->apvec[atomID] != 0);
     apos = Vatom_getPosition(atom);
     arad = Vatom_getRadius(atom);
 
@@ -8430,7 +10450,7 @@ VPUBLIC void Vpmg_dbPermanentMultipoleForce(Vpmg *thee, int atomID,
 
     /* Currently all atoms must be in the same partition. */
 
-    VASSERT(atom->partID != 0);
+    VASSERT(thee->apvec[atomID] != 0);
     arad = Vatom_getRadius(atom);
     apos = Vatom_getPosition(atom);
 
@@ -8641,7 +10661,7 @@ VPUBLIC void Vpmg_qfDirectPolForce(Vpmg *thee, Vgrid* perm, Vgrid *induced,
     VASSERT(thee->pbe->alist != VNULL);
 
     atom = Valist_getAtom(thee->pbe->alist, atomID);
-    VASSERT(atom->partID != 0); /* all atoms must be in the same partition.*/
+    VASSERT(thee->apvec[atomID] != 0); /* all atoms must be in the same partition.*/
     apos = Vatom_getPosition(atom);
 
     c = Vatom_getCharge(atom);
@@ -8893,7 +10913,7 @@ VPUBLIC void Vpmg_qfNLDirectPolForce(Vpmg *thee, Vgrid *perm, Vgrid *nlInduced,
     VASSERT(!thee->pmgp->nonlin); /* Nonlinear PBE is not implemented for AMOEBA */
 
     atom = Valist_getAtom(thee->pbe->alist, atomID);
-    VASSERT(atom->partID != 0);   /* Currently all atoms must be in the same partition. */
+    VASSERT(thee->apvec[atomID] != 0);   /* Currently all atoms must be in the same partition. */
     apos = Vatom_getPosition(atom);
 
     c = Vatom_getCharge(atom);
@@ -9146,7 +11166,7 @@ VPUBLIC void Vpmg_ibDirectPolForce(Vpmg *thee, Vgrid *perm, Vgrid *induced,
     acc = thee->pbe->acc;
     srfm = thee->surfMeth;
     atom = Valist_getAtom(thee->pbe->alist, atomID);
-    VASSERT(atom->partID != 0);   /* Currently all atoms must be in the same partition. */
+    VASSERT(thee->apvec[atomID] != 0);   /* Currently all atoms must be in the same partition. */
     apos = Vatom_getPosition(atom);
     arad = Vatom_getRadius(atom);
 
@@ -9272,7 +11292,7 @@ VPUBLIC void Vpmg_dbDirectPolForce(Vpmg *thee, Vgrid *perm, Vgrid *induced,
 
     acc = thee->pbe->acc;
     atom = Valist_getAtom(thee->pbe->alist, atomID);
-    VASSERT (atom->partID != 0);   /* Currently all atoms must be in the same partition. */
+    VASSERT (thee->apvec[atomID] != 0);   /* Currently all atoms must be in the same partition. */
     apos = Vatom_getPosition(atom);
     arad = Vatom_getRadius(atom);
 
@@ -9475,7 +11495,7 @@ VPUBLIC void Vpmg_qfMutualPolForce(Vpmg *thee, Vgrid *induced,
     VASSERT(induced != VNULL); /* potential due to induced dipoles. */
     VASSERT(nlinduced != VNULL); /* potential due to non-local induced dipoles. */
     atom = Valist_getAtom(thee->pbe->alist, atomID);
-    VASSERT(atom->partID != 0);    /* all atoms must be in the same partition. */
+    VASSERT(thee->apvec[atomID] != 0);    /* all atoms must be in the same partition. */
     apos = Vatom_getPosition(atom);
     dipole = Vatom_getInducedDipole(atom);
     uix = dipole[0];
@@ -9513,7 +11533,7 @@ VPUBLIC void Vpmg_qfMutualPolForce(Vpmg *thee, Vgrid *induced,
     zlen = zmax-zmin;
 
     /* If we aren't in the current position, then we're done */
-    if (atom->partID == 0) return;
+    if (thee->apvec[atomID] == 0) return;
 
     /* Make sure we're on the grid */
     if ((apos[0]<=(xmin+2*hx))   || (apos[0]>=(xmax-2*hx)) \
@@ -9633,7 +11653,7 @@ VPUBLIC void Vpmg_ibMutualPolForce(Vpmg *thee, Vgrid *induced, Vgrid *nlinduced,
     VASSERT (!thee->pmgp->nonlin); /* Nonlinear PBE is not implemented for AMOEBA */
 
     atom = Valist_getAtom(thee->pbe->alist, atomID);
-    VASSERT (atom->partID != 0);   /* Currently all atoms must be in the same partition. */
+    VASSERT (thee->apvec[atomID] != 0);   /* Currently all atoms must be in the same partition. */
 
     acc = thee->pbe->acc;
     srfm = thee->surfMeth;
@@ -9646,7 +11666,7 @@ VPUBLIC void Vpmg_ibMutualPolForce(Vpmg *thee, Vgrid *induced, Vgrid *nlinduced,
     force[2] = 0.0;
 
     /* If we aren't in the current position, then we're done */
-    if (atom->partID == 0) return;
+    if (thee->apvec[atomID] == 0) return;
 
     /* Get PBE info */
     pbe = thee->pbe;
@@ -9760,7 +11780,7 @@ VPUBLIC void Vpmg_dbMutualPolForce(Vpmg *thee, Vgrid *induced,
     acc = thee->pbe->acc;
     srfm = thee->surfMeth;
     atom = Valist_getAtom(thee->pbe->alist, atomID);
-    VASSERT (atom->partID != 0); /* all atoms must be in the same partition.*/
+    VASSERT (thee->apvec[atomID] != 0); /* all atoms must be in the same partition.*/
     apos = Vatom_getPosition(atom);
     arad = Vatom_getRadius(atom);
 
@@ -10063,7 +12083,7 @@ VPRIVATE void fillcoCoefSpline4(Vpmg *thee) {
             (apos[1]<=ymin) || (apos[1]>=ymax)  || \
             (apos[2]<=zmin) || (apos[2]>=zmax)) {
             if ((thee->pmgp->bcfl != BCFL_FOCUS) &&
-                (thee->pmgp->bcfl != BCFL_MAP)) {
+                (thee->pmgp->bcfl != BCFL_MAP) && !thee->distrib) {
                 Vnm_print(2, "Vpmg_fillco:  Atom #%d at (%4.3f, %4.3f,\
  %4.3f) is off the mesh (ignoring):\n",
                   iatom, apos[0], apos[1], apos[2]);
@@ -10552,7 +12572,7 @@ VPRIVATE void fillcoCoefSpline3(Vpmg *thee) {
             (apos[1]<=ymin) || (apos[1]>=ymax)  || \
             (apos[2]<=zmin) || (apos[2]>=zmax)) {
             if ((thee->pmgp->bcfl != BCFL_FOCUS) &&
-                (thee->pmgp->bcfl != BCFL_MAP)) {
+                (thee->pmgp->bcfl != BCFL_MAP) && !thee->distrib) {
                 Vnm_print(2, "Vpmg_fillco:  Atom #%d at (%4.3f, %4.3f,\
  %4.3f) is off the mesh (ignoring):\n",
                   iatom, apos[0], apos[1], apos[2]);
@@ -10744,7 +12764,7 @@ VPRIVATE void bcolcomp(int *iparm, double *rparm, int *iwork, double *rwork,
     int nxc, nyc, nzc, nf, nc, narr, narrc, n_rpc;
     int n_iz, n_ipc, iretot, iintot;
     int nrwk, niwk, nx, ny, nz, nlev, ierror, maxlev, mxlv;
-    int mgcoar, mgdisc, mgsolv;
+    int mgcoar, mgdisc, mgsolv, mgfree;
     int k_iz;
     int k_ipc, k_rpc, k_ac, k_cc, k_fc, k_pc;
 
@@ -10765,7 +12785,8 @@ VPRIVATE void bcolcomp(int *iparm, double *rparm, int *iwork, double *rwork,
     mgcoar = VAT(iparm, 18);
     mgdisc = VAT(iparm, 19);
     mgsolv = VAT(iparm, 21);
-    Vmgsz(&mgcoar, &mgdisc, &mgsolv,
+    mgfree = VAT(iparm, 28);
+    Vmgsz(&mgcoar, &mgdisc, &mgsolv, &mgfree,
             &nx, &ny, &nz,
             &nlev,
             &nxc, &nyc, &nzc,
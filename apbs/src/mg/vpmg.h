@@ -93,6 +93,7 @@
 #include "generic/vmatrix.h"
 #include "pmgc/mgdrvd.h"
 #include "pmgc/newdrvd.h"
+#include "pmgc/cgmgdrvd.h"
 #include "pmgc/mgsubd.h"
 #include "pmgc/mikpckd.h"
 #include "pmgc/matvecd.h"
@@ -136,14 +137,18 @@ struct sVpmg {
   int *iwork;  /**< Work array */
   double *rwork;  /**< Work array */
   double *a1cf;  /**< Operator coefficient values (a11) -- this array can be
-                  * overwritten */
+                  * overwritten; only allocated during Vpmg_solve, epsx is
+                  * the canonical copy */
   double *a2cf;  /**< Operator coefficient values (a22) -- this array can be
-                   overwritten */
+                   overwritten; only allocated during Vpmg_solve */
   double *a3cf;  /**< Operator coefficient values (a33) -- this array can be
-                   overwritten */
-  double *ccf;  /**< Helmholtz term -- this array can be overwritten */
-  double *fcf;  /**< Right-hand side -- this array can be overwritten */
-  double *tcf;  /**< True solution */
+                   overwritten; only allocated during Vpmg_solve */
+  double *ccf;  /**< Helmholtz term -- this array can be overwritten; only
+                  * allocated during Vpmg_solve */
+  double *fcf;  /**< Right-hand side -- this array can be overwritten; only
+                  * set during Vpmg_solve, where it aliases charge for
+                  * linear multigrid solves */
+  double *tcf;  /**< True solution; only allocated during Vpmg_solve */
   double *u;  /**< Solution */
   double *xf;  /**< Mesh point x coordinates */
   double *yf;  /**< Mesh point y coordinates */
@@ -152,6 +157,9 @@ struct sVpmg {
   double *gycf;  /**< Boundary conditions for y faces */
   double *gzcf;  /**< Boundary conditions for z faces */
   double *pvec;  /**< Partition mask array */
+  double *apvec;  /**< Partition weights of the atoms; the atom counterpart of
+                   * pvec, kept here rather than in the shared Valist */
+  int napvec;  /**< Number of atoms in apvec */
   double extDiEnergy;  /**< Stores contributions to the dielectric energy from
                         * regions outside the problem domain */
   double extQmEnergy;  /**< Stores contributions to the mobile ion energy from
@@ -166,6 +174,17 @@ struct sVpmg {
   Vchrg_Src chargeSrc;  /**< Charge source */
 
   int filled;  /**< Indicates whether Vpmg_fillco has been called */
+  int distrib;  /**< Indicates that this mesh is one processor's slab of a
+                 * distributed calculation (see Vmgdist), so atoms off it
+                 * are expected */
+  int keepCoef;  /**< Indicates whether Vpmg_copyCoef handed this object
+                  * dielectric and kappa maps that Vpmg_fillco may keep */
+  unsigned long long coefKey;  /**< Hash of the atoms and parameters the
+                                * dielectric and kappa maps were built
+                                * from */
+  int zeroIters;  /**< Iterations an earlier solve of this mesh took from
+                  * a zero guess, or -1 if unknown; solveMG measures the
+                  * iterations saved by a guess against it */
 
   int useDielXMap;  /**< Indicates whether Vpmg_fillco was called with an
                       external x-shifted dielectric map */
@@ -253,6 +272,63 @@ VEXTERNC int Vpmg_ctor2(
                                         * = 0) */
         );
 
+/** @brief   Prepare a solved object for the next solve of a changed problem
+ *           on the same mesh
+ *  @ingroup Vpmg
+ *  @returns 1 if successful, 0 otherwise
+ *  @note    Use this instead of a new Vpmg_ctor when the same calculation is
+ *           repeated for new atom positions, as in a simulation.  The mesh
+ *           size is kept; the caller may move its center through
+ *           Vpmgp.xcent, ycent and zcent beforehand.  Vpmg_fillco must be
+ *           called again afterwards.  The next Vpmg_solve starts from the
+ *           current solution instead of zero, which saves most of the
+ *           iterations when the atoms have moved little.  pmgOLD is not
+ *           destroyed.
+ */
+VEXTERNC int Vpmg_update(
+        Vpmg *thee,  /**< Object solved for the previous positions */
+        Vpbe *pbe,  /**< PBE-specific variables for the new positions; the
+                     * previous one may be destroyed afterwards */
+        Vpmg *pmgOLD,  /**< Solved coarser object for focusing, or VNULL */
+        MGparm *mgparm,  /**< MGparm parameter object for boundary
+                          * conditions (can be VNULL if pmgOLD is VNULL) */
+        PBEparm_calcEnergy energyFlag  /**< What types of energies to
+                                        * calculate (ignored if pmgOLD is
+                                        * VNULL) */
+        );
+
+/** @brief   Start the next solve from the solution of another object
+ *  @ingroup Vpmg
+ *  @returns The number of interior points that lie on the mesh of pmgOLD;
+ *           if there are none, the solve starts from zero as usual
+ *  @note    The solution of pmgOLD is interpolated trilinearly onto the
+ *           interior of this mesh, which may be finer, coarser or shifted.
+ *           Points off the old mesh start from zero.  Use this for a focused
+ *           calculation (pmgOLD is the coarser level) or to repeat a solve
+ *           for a similar problem.  The stopping test is not changed: it is
+ *           still relative to the residual of a zero guess, so the solve
+ *           ends at the same accuracy in fewer iterations.  After the solve,
+ *           Vpmg.rparm[10] holds the residual of the guess relative to that
+ *           of a zero guess.  Nonlinear solves start from zero instead if
+ *           that is not below 1, since Newton may diverge from a poor
+ *           guess.  Call this after Vpmg_ctor; pmgOLD is only read.
+ */
+VEXTERNC int Vpmg_setGuess(
+        Vpmg *thee,  /**< Vpmg object to be solved */
+        Vpmg *pmgOLD  /**< Solved Vpmg object */
+        );
+
+/** @brief   Start the next solve from a potential map
+ *  @ingroup Vpmg
+ *  @returns The number of interior points that lie on the map
+ *  @note    As Vpmg_setGuess, but the guess is interpolated from a map in
+ *           units of kT/e, such as one read with "usemap pot".
+ */
+VEXTERNC int Vpmg_setGuessMap(
+        Vpmg *thee,  /**< Vpmg object to be solved */
+        Vgrid *potMap  /**< Potential map (kT/e) */
+        );
+
 /** @brief   Object destructor
  *  @ingroup Vpmg
  *  @author  Nathan Baker
@@ -270,6 +346,17 @@ VEXTERNC void Vpmg_dtor2(
         Vpmg *thee  /**< Pointer to object to be destroyed */
         );
 
+/** @brief   Print the memory used by each array of this structure
+ *  @ingroup Vpmg
+ *  @note    The operator coefficient arrays (a1cf, a2cf, a3cf, ccf, tcf and,
+ *           for nonlinear solves, fcf) only exist during Vpmg_solve; their
+ *           size is reported separately from the persistent arrays.
+ */
+VEXTERNC void Vpmg_printMemChk(
+        Vpmg *thee,  /**< Object for memory check */
+        int unit  /**< Vnm_print output unit */
+        );
+
 /** @brief  Fill the coefficient arrays prior to solving the equation
  *  @ingroup  Vpmg
  *  @author  Nathan Baker
@@ -298,6 +385,24 @@ VEXTERNC int Vpmg_fillco(
         Vgrid *chargeMap  /**< External charge map */
         );
 
+/** @brief  Take over the dielectric and kappa maps and the multigrid
+ *          operators of a solved calculation on the same mesh
+ *  @ingroup  Vpmg
+ *  @returns  1 if the maps were taken over, 0 if the meshes differ
+ *  @note  Call this between Vpmg_ctor and Vpmg_fillco.  The arrays are
+ *         swapped, not copied, so pmgOLD cannot be used for observables
+ *         afterwards.  Vpmg_fillco keeps the maps only if this object has
+ *         the same atom positions and radii and the same dielectric, ion
+ *         and surface parameters as pmgOLD; otherwise it fills them again.
+ *         With Vpmgp.mgcach set on both objects, Vpmg_solve also keeps the
+ *         coarse operators and the coarse factorization, so only the
+ *         charges and the boundary values are computed anew.
+ */
+VEXTERNC int Vpmg_copyCoef(
+        Vpmg *thee,  /**< Vpmg object, constructed but not yet filled */
+        Vpmg *pmgOLD  /**< Filled (and usually solved) Vpmg object */
+        );
+
 /** @brief   Solve the PBE using PMG
  *  @ingroup Vpmg
  *  @author  Nathan Baker
@@ -307,6 +412,32 @@ VEXTERNC int Vpmg_solve(
         Vpmg *thee  /**< Vpmg object */
         );
 
+/** @brief   Solve the PBE for several sets of atom charges on the mesh,
+ *           maps and multigrid operators of one Vpmg object
+ *  @ingroup Vpmg
+ *  @returns  1 if successful, 0 otherwise
+ *  @note  Each set is solved with its own charge map and boundary values;
+ *         the dielectric and kappa maps are shared.  If thee was solved
+ *         with Vpmgp.mgcach set, its coarse operators and coarse
+ *         factorization are used for every set; otherwise they are built
+ *         by the first solve and copied to the others.  The sets of a
+ *         block are solved at the same time on separate threads, each
+ *         with its own copy of the work arrays.  thee itself, including
+ *         its solution and the charges of its atoms, is left unchanged.
+ *         Focusing boundary values and charge maps are not supported.
+ */
+VEXTERNC int Vpmg_solveMulti(
+        Vpmg *thee,  /**< Vpmg object, filled (and usually solved) */
+        int nrhs,  /**< Number of charge sets */
+        double *charges,  /**< nrhs sets of atom charges (e), one after
+                           * the other, in the order of the atom list */
+        int nblock,  /**< Number of sets solved at the same time */
+        double *energy,  /**< Set to the total electrostatic energy (kT)
+                          * of each set; may be VNULL */
+        double *atomPot  /**< Set to the potential (kT/e) at each atom for
+                          * each set, laid out as charges; may be VNULL */
+        );
+
 /** @brief   Solve Poisson's equation with a homogeneous Laplacian operator
  *           using the solvent dielectric constant.  This solution is
  *           performed by a sine wave decomposition.
@@ -802,590 +933,6 @@ VEXTERNC void Vpmg_printColComp(
 
 
 
-/** @brief   Build a column-compressed matrix in Harwell-Boeing format
- *  @ingroup Vpmg
- *  @author  Tucker Beck [C Translation]
- *           Nathan Baker [Original] (mostly ripped off from Harwell-Boeing
- *                                    format documentation)Michael Schnieders)
- */
-VPRIVATE void bcolcomp(
-        int    *iparm,  ///< @todo Document
-        double *rparm,  ///< @todo Document
-        int    *iwork,  ///< @todo Document
-        double *rwork,  ///< @todo Document
-        double *values, ///< @todo Document
-        int    *rowind, ///< @todo Document
-        int    *colptr, ///< @todo Document
-        int    *flag    /**< Operation selection parameter
-                         *     0 = Use Poisson operator only
-                         *     1 = Use linearization of full operation around
-                         *         current solution.
-                         */
-        );
-
-
-
-/** @brief   Build a column-compressed matrix in Harwell-Boeing format
- *  @ingroup Vpmg
- *  @author  Tucker Beck [C Translation]
- *           Nathan Baker [Original] (mostly ripped off from Harwell-Boeing
- *                                    format documentation)Michael Schnieders)
- */
-VPRIVATE void bcolcomp2(
-        int    *iparm,  ///< @todo Document
-        double *rparm,  ///< @todo Document
-        int    *nx,     ///< @todo Document
-        int    *ny,     ///< @todo Document
-        int    *nz,     ///< @todo Document
-        int    *iz,     ///< @todo Document
-        int    *ipc,    ///< @todo Document
-        double *rpc,    ///< @todo Document
-        double *ac,     ///< @todo Document
-        double *cc,     ///< @todo Document
-        double *values, ///< @todo Document
-        int    *rowind, ///< @todo Document
-        int    *colptr, ///< @todo Document
-        int    *flag    /**< Operation selection parameter
-                         *     0 = Use Poisson operator only
-                         *     1 = Use linearization of full operation around
-                         *         current solution.
-                         */
-        );
-
-
-
-/** @brief   Build a column-compressed matrix in Harwell-Boeing format
- *  @ingroup Vpmg
- *  @author  Tucker Beck [C Translation]
- *           Nathan Baker [Original] (mostly ripped off from Harwell-Boeing
- *                                    format documentation)Michael Schnieders)
- */
-VPRIVATE void bcolcomp3(
-        int    *nx,     ///< @todo Document
-        int    *ny,     ///< @todo Document
-        int    *nz,     ///< @todo Document
-        int    *ipc,    ///< @todo Document
-        double *rpc,    ///< @todo Document
-        double *ac,     ///< @todo Document
-        double *cc,     ///< @todo Document
-        double *values, ///< @todo Document
-        int    *rowind, ///< @todo Document
-        int    *colptr, ///< @todo Document
-        int    *flag    ///< @todo Document
-        );
-
-
-
-/** @brief   Build a column-compressed matrix in Harwell-Boeing format
- *  @ingroup Vpmg
- *  @author  Tucker Beck [C Translation]
- *           Nathan Baker [Original] (mostly ripped off from Harwell-Boeing
- *                                    format documentation)Michael Schnieders)
- */
-VPRIVATE void bcolcomp4(
-        int    *nx,     ///< @todo Document
-        int    *ny,     ///< @todo Document
-        int    *nz,     ///< @todo Document
-        int    *ipc,    ///< @todo Document
-        double *rpc,    ///< @todo Document
-        double *oC,     ///< @todo Document
-        double *cc,     ///< @todo Document
-        double *oE,     ///< @todo Document
-        double *oN,     ///< @todo Document
-        double *uC,     ///< @todo Document
-        double *values, ///< @todo Document
-        int    *rowind, ///< @todo Document
-        int    *colptr, ///< @todo Document
-        int    *flag    ///< @todo Document
-        );
-
-
-
-/** @brief   Print a column-compressed matrix in Harwell-Boeing format
- *  @ingroup Vpmg
- *  @author  Tucker Beck [C Translation]
- *           Nathan Baker [Original] (mostly ripped off from Harwell-Boeing
- *                                    format documentation)Michael Schnieders)
- */
-VPRIVATE void pcolcomp(
-        int    *nrow,   ///< @todo Document
-        int    *ncol,   ///< @todo Document
-        int    *nnzero, ///< @todo Document
-        double *values, ///< @todo Document
-        int    *rowind, ///< @todo Document
-        int    *colptr, ///< @todo Document
-        char   *path,   ///< @todo Document
-        char   *title,  ///< @todo Document
-        char   *mxtype  ///< @todo Document
-        );
-
-
-
-/* ///////////////////////////////////////////////////////////////////////////
-// Internal routines
-/////////////////////////////////////////////////////////////////////////// */
-
-/**
- * @brief  Evaluate a cubic B-spline
- * @author  Nathan Baker
- * @return  Cubic B-spline value
- */
-VPRIVATE double bspline2(
-        double x  /** Position */
-        );
-
-/**
- * @brief  Evaluate a cubic B-spline derivative
- * @author  Nathan Baker
- * @return  Cubic B-spline derivative
- */
-VPRIVATE double dbspline2(
-        double x  /** Position */
-        );
-
-/**
- * @brief   Return 2.5 plus difference of i - f
- * @author  Michael Schnieders
- * @return  (2.5+((double)(i)-(f)))
- */
-VPRIVATE double VFCHI4(
-        int i,
-        double f
-        );
-
-/**
- * @brief   Evaluate a 5th Order B-Spline (4th order polynomial)
- * @author: Michael Schnieders
- * @return  5th Order B-Spline
- */
-VPRIVATE double bspline4(
-         double x /** Position */
-         );
-
-/**
- * @brief   Evaluate a 5th Order B-Spline derivative (4th order polynomial)
- * @author: Michael Schnieders
- * @return  5th Order B-Spline derivative
- */
-VPRIVATE double dbspline4(
-         double x /** Position */
-         );
-
-/**
- * @brief   Evaluate the 2nd derivative of a 5th Order B-Spline
- * @author: Michael Schnieders
- * @return  2nd derivative of a 5th Order B-Spline
- */
-VPRIVATE double d2bspline4(
-         double x /** Position */
-         );
-
-/**
- * @brief   Evaluate the 3rd derivative of a 5th Order B-Spline
- * @author: Michael Schnieders
- * @return  3rd derivative of a 5th Order B-Spline
- */
-VPRIVATE double d3bspline4(
-         double x /** Position */
-         );
-
-/**
- * @brief  Determines energy from polarizeable charge and interaction with
- *         fixed charges according to Rocchia et al.
- * @author  Nathan Baker
- * @return  Energy in kT
- */
-VPRIVATE double Vpmg_polarizEnergy(
-         Vpmg *thee,
-         int extFlag  /** If 1, add external energy contributions to
-                       result */
-         );
-/**
- * @brief  Calculates charge-potential energy using summation over delta
- *         function positions (i.e. something like an Linf norm)
- * @author  Nathan Baker
- * @return  Energy in kT
- */
-VPRIVATE double Vpmg_qfEnergyPoint(
-        Vpmg *thee,
-        int extFlag  /** If 1, add external energy contributions to
-                       result */
-        );
-
-/**
- * @brief  Calculates charge-potential energy as integral over a volume
- * @author  Nathan Baker
- * @return  Energy in kT
- */
-VPRIVATE double Vpmg_qfEnergyVolume(
-        Vpmg *thee,
-        int extFlag  /** If 1, add external energy contributions to
-                       result */
-        );
-
-/**
-* @brief Selects a spline based surface method from either VSM_SPLINE,
- *        VSM_SPLINE5 or VSM_SPLINE7
- * @author David Gohara
- */
-VPRIVATE void Vpmg_splineSelect(
-        int srfm,		/** Surface method, currently VSM_SPLINE,
-        VSM_SPLINE5, or VSM_SPLINE7 */
-        Vacc *acc,		/** Accessibility object */
-        double *gpos,	/** Position array -> array[3] */
-        double win,		/** Spline window */
-        double infrad,	/** Inflation radius */
-        Vatom *atom,	/** Atom object */
-        double *force	/** Force array -> array[3] */
-        );
-
-/**
- * @brief  For focusing, fill in the boundaries of the new mesh based on the
- * potential values in the old mesh
- * @author  Nathan Baker
- */
-VPRIVATE void focusFillBound(
-        Vpmg *thee,  /** New PMG object (the one just created) */
-        Vpmg *pmg  /** Old PMG object */
-        );
-
-/**
- * @brief  Increment all boundary points by
- *         pre1*(charge/d)*(exp(-xkappa*(d-size))/(1+xkappa*size) to add the
- *         effect of the Debye-Huckel potential due to a single charge
- * @author  Nathan Baker
- */
-VPRIVATE void bcfl1(
-        double size,  /** Size of the ion */
-        double *apos,  /** Position of the ion */
-        double charge,  /** Charge of the ion */
-        double xkappa,  /** Exponential screening factor */
-        double pre1,  /** Unit- and dielectric-dependent prefactor */
-        double *gxcf,  /** Set to x-boundary values */
-        double *gycf,  /** Set to y-boundary values */
-        double *gzcf,  /** Set to z-boundary values */
-        double *xf,  /** Boundary point x-coordinates */
-        double *yf,  /** Boundary point y-coordinates */
-        double *zf,  /** Boundary point z-coordinates */
-        int nx,  /** Number of grid points in x-direction */
-        int ny,  /** Number of grid points in y-direction */
-        int nz /** Number of grid points in y-direction */
-        );
-
-/**
- * @brief  Increment all boundary points to include the Debye-Huckel
- *         potential due to a single multipole site. (truncated at quadrupole)
- * @author Michael Schnieders
- */
-VPRIVATE void bcfl2(
-        double size,  /** Size of the ion */
-        double *apos,  /** Position of the ion */
-        double charge,  /** Charge of the ion */
-        double *dipole, /** Dipole of the ion */
-        double *quad,   /** Traceless Quadrupole of the ion */
-        double xkappa,  /** Exponential screening factor */
-        double eps_p,   /** Solute dielectric */
-        double eps_w,   /** Solvent dielectric */
-        double T,       /** Temperature */
-        double *gxcf,  /** Set to x-boundary values */
-        double *gycf,  /** Set to y-boundary values */
-        double *gzcf,  /** Set to z-boundary values */
-        double *xf,  /** Boundary point x-coordinates */
-        double *yf,  /** Boundary point y-coordinates */
-        double *zf,  /** Boundary point z-coordinates */
-        int nx,  /** Number of grid points in x-direction */
-        int ny,  /** Number of grid points in y-direction */
-        int nz /** Number of grid points in y-direction */
-        );
-
-/**
- * @brief  This routine serves bcfl2. It returns (in tsr) the contraction
- *         independent portion of the Debye-Huckel potential tensor
- *         for a spherical ion with a central charge, dipole and quadrupole.
- *         See the code for an in depth description.
- *
- * @author Michael Schnieders
- */
-VPRIVATE void multipolebc(
-        double r,      /** Distance to the boundary */
-        double kappa,  /** Exponential screening factor */
-        double eps_p,  /** Solute dielectric */
-        double eps_w,  /** Solvent dielectric */
-        double rad,    /** Radius of the sphere */
-        double tsr[3]  /** Contraction-independent portion of each tensor */
-        );
-
-/**
- * @brief  Calculate
- *         pre1*(charge/d)*(exp(-xkappa*(d-size))/(1+xkappa*size) due to a
- *         specific ion at a specific point
- * @author  Nathan Baker
- * @returns  Value of above function in arbitrary units (dependent on
- *           pre-factor)
- */
-VPRIVATE double bcfl1sp(
-        double size,  /** Atom size */
-        double *apos,  /** Atom position */
-        double charge,  /** Atom charge */
-        double xkappa,  /** Exponential screening factor */
-        double pre1,  /** Unit- and dielectric-dependent prefactor */
-        double *pos  /** Function evaluation position */
-        );
-
-/**
- * @brief  Fill boundary condition arrays
- * @author  Nathan Baker
- */
-VPRIVATE void bcCalc(
-        Vpmg *thee
-        );
-
-/**
- * @brief  Top-level driver to fill all operator coefficient arrays
- * @author  Nathan Baker
- */
-VPRIVATE void fillcoCoef(
-        Vpmg *thee
-        );
-
-/**
- * @brief  Fill operator coefficient arrays from pre-calculated maps
- * @author  Nathan Baker
- */
-VPRIVATE void fillcoCoefMap(
-        Vpmg *thee
-        );
-
-/**
- * @brief  Fill operator coefficient arrays from a molecular surface
- *         calculation
- * @author  Nathan Baker
- */
-VPRIVATE void fillcoCoefMol(
-        Vpmg *thee
-        );
-
-/**
- * @brief  Fill ion (nonlinear) operator coefficient array from a molecular
- * surface calculation
- * @author  Nathan Baker
- */
-VPRIVATE void fillcoCoefMolIon(
-        Vpmg *thee
-        );
-
-/**
- * @brief  Fill differential operator coefficient arrays from a molecular
- *         surface calculation
- * @author  Nathan Baker
- */
-VPRIVATE void fillcoCoefMolDiel(
-        Vpmg *thee
-        );
-
-/**
- * @brief  Fill differential operator coefficient arrays from a molecular
- *         surface calculation without smoothing
- * @author  Nathan Baker
- */
-VPRIVATE void fillcoCoefMolDielNoSmooth(
-        Vpmg *thee
-        );
-
-/**
- * @brief  Fill differential operator coefficient arrays from a molecular
- *         surface calculation with smoothing.
- *
- *         Molecular surface, dielectric smoothing following an implementation
- *         of Bruccoleri, et al.  J Comput Chem 18 268-276 (1997).
- *
- *         This algorithm uses a 9 point harmonic smoothing technique - the point
- *         in question and all grid points 1/sqrt(2) grid spacings away.
- *
- * @note   This uses thee->a1cf, thee->a2cf, thee->a3cf as temporary storage.
- * @author  Todd Dolinsky
- */
-VPRIVATE void fillcoCoefMolDielSmooth(
-        Vpmg *thee
-        );
-
-/**
- * @brief  Fill operator coefficient arrays from a spline-based surface
- *         calculation
- * @author  Nathan Baker
- */
-VPRIVATE void fillcoCoefSpline(
-        Vpmg *thee
-        );
-
-/**
-* @brief  Fill operator coefficient arrays from a 5th order polynomial
-*         based surface calculation
-* @author  Michael Schnieders
-*/
-VPRIVATE void fillcoCoefSpline3(
-        Vpmg *thee
-        );
-
-/**
- * @brief  Fill operator coefficient arrays from a 7th order polynomial
- *         based surface calculation
- * @author  Michael Schnieders
- */
-VPRIVATE void fillcoCoefSpline4(
-        Vpmg *thee
-        );
-
-/**
- * @brief  Top-level driver to fill source term charge array
- * @returns  Success/failure status
- * @author  Nathan Baker
- */
-VPRIVATE Vrc_Codes fillcoCharge(
-        Vpmg *thee
-        );
-
-/**
- * @brief  Fill source term charge array from a pre-calculated map
- * @returns  Success/failure status
- * @author  Nathan Baker
- */
-VPRIVATE Vrc_Codes fillcoChargeMap(
-        Vpmg *thee
-        );
-
-/**
- * @brief  Fill source term charge array from linear interpolation
- * @author  Nathan Baker
- */
-VPRIVATE void fillcoChargeSpline1(
-        Vpmg *thee
-        );
-
-/**
- * @brief  Fill source term charge array from cubic spline interpolation
- * @author  Nathan Baker
- */
-VPRIVATE void fillcoChargeSpline2(
-        Vpmg *thee
-        );
-
-/**
- * @brief  Fill source term charge array for the use of permanent multipoles
- * @author  Michael Schnieders
- */
-VPRIVATE void fillcoPermanentMultipole(
-        Vpmg *thee
-        );
-
-/**
- * @brief  Fill source term charge array for use of induced dipoles
- * @author  Michael Schnieders
- */
-VPRIVATE void fillcoInducedDipole(
-        Vpmg *thee
-        );
-
-/**
- * @brief  Fill source term charge array for non-local induced
- * dipoles
- * @author  Michael Schnieders
- */
-VPRIVATE void fillcoNLInducedDipole(
-        Vpmg *thee
-        );
-
-/**
- * @brief  For focusing, set external energy data members in new Vpmg object
- *         based on energy calculations on old Vpmg object from regions
- *         outside the indicated partition.
- * @author  Nathan Baker, Todd Dolinsky
- */
-VPRIVATE void extEnergy(
-        Vpmg *thee,  /** Newly created PMG manager */
-        Vpmg *pmgOLD,  /** Old PMG manager, source of energies */
-        PBEparm_calcEnergy extFlag,  /** Energy calculation flag */
-        double partMin[3],  /** Partition lower corner */
-        double partMax[3],  /** Partition upper corner */
-        int bflags[6]  /** Which boundaries to include the calculation */
-        );
-
-/**
- * @brief  Charge-field force due to a linear spline charge function
- * @author  Nathan Baker
- */
-VPRIVATE void qfForceSpline1(
-        Vpmg *thee,
-        double *force,  /** Set to force */
-        int atomID  /** Valist atom ID */
-        );
-
-/**
- * @brief  Charge-field force due to a cubic spline charge function
- * @author  Nathan Baker
- */
-VPRIVATE void qfForceSpline2(
-        Vpmg *thee,
-        double *force,  /** Set to force */
-        int atomID  /** Valist atom ID */
-        );
-
-/**
-* @brief  Charge-field force due to a quintic spline charge function
-* @author  Michael Schnieders
-*/
-VPRIVATE void qfForceSpline4(
-                             Vpmg *thee,
-                             double *force,  /** Set to force */
-                             int atomID  /** Valist atom ID */
-                             );
-
-
-/**
- * @brief  Calculate the solution to Poisson's equation with a simple
- *         Laplacian operator and zero-valued Dirichlet boundary conditions.
- *         Store the solution in thee->u.
- * @author  Nathan Baker
- * @note  Vpmg_fillco must be called first
- */
-VPRIVATE void zlapSolve(
-        Vpmg *thee,
-        double **solution,  /** Solution term vector */
-        double **source,  /** Source term vector */
-        double **work1  /** Work vector */
-        );
-
-/**
- * @brief  Mark the grid points inside a sphere with a particular value.  This
- *         marks by resetting the the grid points inside the sphere to the
- *         specified value.
- * @author  Nathan Baker
- */
-VPRIVATE void markSphere(
-        double rtot,  /** Sphere radius */
-        double *tpos,  /** Sphere position */
-        int nx,  /** Number of grid points */
-        int ny,  /** Number of grid points */
-        int nz,  /** Number of grid points */
-        double hx,  /** Grid spacing */
-        double hy,  /** Grid spacing */
-        double hzed,  /** Grid spacing */
-        double xmin,  /** Grid lower corner */
-        double ymin,  /** Grid lower corner */
-        double zmin,  /** Grid lower corner */
-        double *array,  /** Grid values */
-        double markVal  /** Value to mark with */
-        );
-
-/**
- * @brief Vpmg_qmEnergy for SMPBE
- * @author Vincent Chu
- */
-VPRIVATE double Vpmg_qmEnergySMPBE(Vpmg *thee, int extFlag);
-VPRIVATE double Vpmg_qmEnergyNONLIN(Vpmg *thee, int extFlag);
-
-
-
 // Additional macros and definitions.  May not be needed
 
 // Added by Vincent Chu 9/13/06 for SMPB
@@ -133,6 +133,7 @@ value: %g \n", thee->errtol);
     thee->iinfo = 1;         /* I'd recommend either 1 (for debugging LPBE) or 2 (for debugging NPBE), higher values give too much output */
 
     thee->bcfl = BCFL_SDH;
+    thee->bctol = 1.0e-6;
     thee->key = 0;
     thee->iperf = 0;
     thee->mgcoar = 2;
@@ -149,16 +150,17 @@ value: %g \n", thee->errtol);
     thee->ycent = 0.0;
     thee->zcent = 0.0;
 
-    /* Default value for all APBS runs */
-    thee->mgsmoo = 1;
+    /* Default value for all APBS runs: red-black Gauss-Seidel, with the
+     * sweeps and residual of the fine 7-point operator fused into one pass */
+    thee->mgsmoo = 5;
     if (thee->nonlin == NONLIN_NPBE || thee->nonlin == NONLIN_SMPBE) {
         /* SMPBE Added - SMPBE needs to mimic NPBE */
         Vnm_print(0, "Vpmp_ctor2:  Using meth = 1, mgsolv = 0\n");
         thee->mgsolv = 0;
     } else {
         /* Most rigorous (good for testing) */
-        Vnm_print(0, "Vpmp_ctor2:  Using meth = 2, mgsolv = 1\n");
-        thee->mgsolv = 1;
+        Vnm_print(0, "Vpmp_ctor2:  Using meth = 2, mgsolv = 2\n");
+        thee->mgsolv = 2;
     }
 
     /* TEMPORARY USEAQUA */
@@ -167,6 +169,21 @@ value: %g \n", thee->errtol);
      */
     if(mgparm->useAqua == 1) thee->mgsolv = 0;
 
+    thee->mgprec = mgparm->useMixed;
+
+    /* Solvers that change only the charges between solves of one Vpmg
+     * can turn this on before constructing it */
+    thee->mgcach = 0;
+
+    /* Linear multigrid solves with the red/black smoothers keep only the
+     * face weights of the fine operator; the other paths need its diagonal
+     * stored */
+    thee->mgfree = ((thee->meth == VSOL_MG) || (thee->meth == VSOL_CGMG))
+        && (thee->nonlin == NONLIN_LPBE)
+        && (thee->mgprec == 0) && (thee->nlev > 1) && (thee->iperf == 0)
+        && (thee->mgdisc == 0) && (thee->mgprol == 0)
+        && ((thee->mgsmoo == 1) || (thee->mgsmoo == 5));
+
     return 1;
 }
 
@@ -202,6 +219,7 @@ VPUBLIC void Vpmgp_size(
     int num_narr = 2;
     int num_narrc = 27;
     int nxf, nyf, nzf, level, num_nf_oper, num_narrc_oper, n_band, nc_band, num_band, iretot;
+    int numdia, n_sparse;
 
     thee->nf = thee->nx * thee->ny * thee->nz;
     thee->narr = thee->nf;
@@ -226,7 +244,7 @@ VPUBLIC void Vpmgp_size(
     /* Box or FEM discretization on fine grid? */
     switch (thee->mgdisc) { /* NAB TO-DO:  This needs to be changed into an enumeration */
     case 0:
-        num_nf_oper = 4;
+        num_nf_oper = (thee->mgfree == 1) ? 3 : 4;
         break;
     case 1:
         num_nf_oper = 14;
@@ -260,11 +278,20 @@ VPUBLIC void Vpmgp_size(
         VASSERT(0);
     }
 
-    /* LINPACK storage on coarse grid */
+    /* LINPACK or sparse storage on coarse grid */
+    n_sparse = 0;
     switch (thee->mgsolv) { /* NAB TO-DO:  This needs to be changed into an enumeration */
     case 0:
         n_band = 0;
         break;
+    case 2:
+        if ( ( (thee->mgcoar == 0) || (thee->mgcoar == 1)) && (thee->mgdisc == 0) ) {
+            numdia = 7;
+        } else {
+            numdia = 27;
+        }
+        Vsparsz(&numdia, &(thee->nxc), &(thee->nyc), &(thee->nzc), &n_band, &n_sparse);
+        break;
     case 1:
         if ( ( (thee->mgcoar == 0) || (thee->mgcoar == 1)) && (thee->mgdisc == 0) ) {
             num_band = 1 + (thee->nxc-2)*(thee->nyc-2);
@@ -287,7 +314,7 @@ VPUBLIC void Vpmgp_size(
 
     /* Integer storage parameters */
     thee->n_iz = 50*(thee->nlev+1);
-    thee->n_ipc = 100*(thee->nlev+1);
+    thee->n_ipc = 100*(thee->nlev+1) + n_sparse;
     thee->niwk = thee->n_iz + thee->n_ipc;
 }
 
@@ -70,6 +70,7 @@
 
 #include "generic/vhal.h"
 #include "generic/mgparm.h"
+#include "pmgc/buildSd.h"
 
 /**
  *  @ingroup Vpmgp
@@ -133,6 +134,8 @@ struct sVpmgp {
                  * \li 2: lots
                  * \li 3: more */
     Vbcfl bcfl;  /**< Boundary condition method [default = BCFL_SDH] */
+    double bctol;  /**< Relative accuracy of the treecode boundary condition
+                    * (BCFL_MDHTREE) [default = 1e-6] */
     int key;  /**< Print solution to file [default = 0]
                * \li   0: no
                * \li   1: yes */
@@ -157,12 +160,14 @@ struct sVpmgp {
                  * \li   1: nested iteration */
     int nu1;  /**< Number of pre-smoothings [default = 2] */
     int nu2;  /**< Number of post-smoothings [default = 2] */
-    int mgsmoo;  /**< Smoothing method [default = 1]
+    int mgsmoo;  /**< Smoothing method [default = 5]
                   * \li   0: weighted jacobi
                   * \li   1: gauss-seidel
                   * \li   2: SOR
                   * \li   3: richardson
-                  * \li   4: cghs */
+                  * \li   4: cghs
+                  * \li   5: temporally blocked gauss-seidel (same
+                  *           iterates as 1) */
     int mgprol;  /**< Prolongation method [default = 0]
                   * \li   0: trilinear
                   * \li   1: operator-based
@@ -171,9 +176,30 @@ struct sVpmgp {
                   * \li   0: standard
                   * \li   1: harmonic
                   * \li   2: galerkin */
-    int mgsolv;  /**< Coarse equation solve method [default = 1]
+    int mgsolv;  /**< Coarse equation solve method [default = 2]
                   * \li   0: cghs
-                  * \li   1: banded linpack */
+                  * \li   1: banded linpack
+                  * \li   2: sparse LDL^T with nested dissection
+                  *           ordering */
+    int mgprec;  /**< Precision of the multigrid cycles [default = 0]
+                  * \li   0: double
+                  * \li   1: single, with double precision defect
+                  *           correction (linear solves only) */
+    int mgcach;  /**< Reuse of the coarse operators across solves
+                  * [default = 0]
+                  * \li   0: rebuild them on every solve
+                  * \li   1: keep them in the work arrays, and reuse them
+                  *           when the next solve has the same dielectric
+                  *           and kappa (multigrid driver, galerkin
+                  *           coarsening only) */
+    int mgfree;  /**< Storage of the finest level operator [default = 1
+                  * for linear multigrid solves, 0 otherwise]
+                  * \li   0: all seven stencil weights
+                  * \li   1: only the three face weights; the diagonal
+                  *           is formed from them and kappa inside the
+                  *           matvec, residual and Gauss-Seidel kernels
+                  *           (finite volume, trilinear prolongation and
+                  *           at least two levels only) */
     int mgdisc;  /**< Discretization method [default = 0]
                   * \li   0: finite volume
                   * \li   1: finite element */
@@ -50,7 +50,7 @@
 #include "buildAd.h"
 
 VPUBLIC void VbuildA(int* nx, int* ny, int* nz,
-        int* ipkey, int* mgdisc, int* numdia,
+        int* ipkey, int* mgdisc, int* mgfree, int* numdia,
         int* ipc, double* rpc,
         double* ac, double* cc, double* fc,
         double* xf, double* yf, double* zf,
@@ -60,10 +60,23 @@ VPUBLIC void VbuildA(int* nx, int* ny, int* nz,
 
     MAT2(ac, *nx * *ny * *nz, 14);
 
-    if (*mgdisc == 0) {
+    if (*mgdisc == 0 && *mgfree == 1) {
 
+        // Only the face weights are stored; there is no diagonal column
         VbuildA_fv(nx, ny, nz,
-                ipkey, numdia,
+                ipkey, mgfree, numdia,
+                ipc, rpc,
+                VNULL, cc, fc,
+                RAT2(ac, 1,1), RAT2(ac, 1,2), RAT2(ac, 1,3),
+                xf, yf, zf,
+                gxcf, gycf, gzcf,
+                a1cf, a2cf, a3cf,
+                ccf, fcf);
+
+    } else if (*mgdisc == 0) {
+
+        VbuildA_fv(nx, ny, nz,
+                ipkey, mgfree, numdia,
                 ipc, rpc,
                 RAT2(ac, 1,1), cc, fc,
                 RAT2(ac, 1,2), RAT2(ac, 1,3), RAT2(ac, 1,4),
@@ -98,7 +111,7 @@ VPUBLIC void VbuildA(int* nx, int* ny, int* nz,
 
 
 VPUBLIC void VbuildA_fv(int *nx, int *ny, int *nz,
-        int *ipkey, int *numdia,
+        int *ipkey, int *mgfree, int *numdia,
         int *ipc, double *rpc,
         double *oC, double *cc, double *fc, double *oE, double *oN, double *uC,
         double *xf, double *yf, double *zf,
@@ -169,6 +182,16 @@ VPUBLIC void VbuildA_fv(int *nx, int *ny, int *nz,
     VAT(ipc, 12) = 1;
     *numdia = 4;
 
+    /* Without the diagonal, the faces on the boundary are kept as well, so
+     * that the kernels can form the diagonal from them */
+    VAT(ipc, 13) = *mgfree;
+    if (*mgfree == 1)
+        *numdia = 3;
+
+    // No index of the ion-accessible points until Vbuildnlidx makes one
+    VAT(ipc, 14) = 0;
+    VAT(ipc, 15) = 0;
+
     // Define n and determine number of mesh points
     nxm1 = *nx - 1;
     nym1 = *ny - 1;
@@ -223,33 +246,42 @@ VPUBLIC void VbuildA_fv(int *nx, int *ny, int *nz,
                 //fprintf(data, "%19.12E\n", VAT3(cc, i, j, k));
 
                 // Calculate the diagonal for matvecs and smoothings
-                
-                VAT3(oC, i, j, k) = coef_oE   * VAT3(a1cf,   i,   j,   k) +
-                              coef_oEm1 * VAT3(a1cf, i-1,   j,   k) +
-                              coef_oN   * VAT3(a2cf,   i,   j,   k) +
-                              coef_oNm1 * VAT3(a2cf,   i, j-1,   k) +
-                              coef_uC   * VAT3(a3cf,   i,   j,   k) +
-                              coef_uCm1 * VAT3(a3cf,   i,   j, k-1);
+                if (*mgfree == 0) {
+                    VAT3(oC, i, j, k) = coef_oE   * VAT3(a1cf,   i,   j,   k) +
+                                  coef_oEm1 * VAT3(a1cf, i-1,   j,   k) +
+                                  coef_oN   * VAT3(a2cf,   i,   j,   k) +
+                                  coef_oNm1 * VAT3(a2cf,   i, j-1,   k) +
+                                  coef_uC   * VAT3(a3cf,   i,   j,   k) +
+                                  coef_uCm1 * VAT3(a3cf,   i,   j, k-1);
+                } else {
+                    // The west, south and down boundary faces
+                    if (i == 2)
+                        VAT3(oE, 1, j, k) = coef_oEm1 * VAT3(a1cf, 1, j, k);
+                    if (j == 2)
+                        VAT3(oN, i, 1, k) = coef_oNm1 * VAT3(a2cf, i, 1, k);
+                    if (k == 2)
+                        VAT3(uC, i, j, 1) = coef_uCm1 * VAT3(a3cf, i, j, 1);
+                }
 
                 //fprintf(data, "%19.12E\n", VAT3(oC, i, j, k));
 
                 // Calculate the east neighbor
                 ike = VMIN2(1, VABS(i - nxm1));
-                VAT3(oE, i, j, k) = ike * coef_oE * VAT3(a1cf, i, j, k);
+                VAT3(oE, i, j, k) = VMAX2(ike, *mgfree) * coef_oE * VAT3(a1cf, i, j, k);
                 //fprintf(data, "%19.12E\n", VAT3(oE, i, j, k));
                 bc_cond_e = (1 - ike) * coef_oE * VAT3(a1cf, i, j, k) * VAT3(gxcf,  j, k, 2);
                 VAT3(fc, i, j, k) += bc_cond_e;
 
                 // Calculate the north neighbor
                 jke = VMIN2(1, VABS(j - nym1));
-                VAT3(oN, i, j, k) = jke * coef_oN * VAT3(a2cf, i, j, k);
+                VAT3(oN, i, j, k) = VMAX2(jke, *mgfree) * coef_oN * VAT3(a2cf, i, j, k);
                 //fprintf(data, "%19.12E\n", VAT3(oN, i, j, k));
                 bc_cond_n = (1 - jke) * coef_oN * VAT3(a2cf, i, j, k) * VAT3(gycf, i, k, 2);
                 VAT3(fc, i, j, k) += bc_cond_n;
 
                 // Calculate the up neighbor
                 kke = VMIN2(1, VABS(k - nzm1));
-                VAT3(uC, i, j, k) = kke * coef_uC * VAT3(a3cf, i, j, k);
+                VAT3(uC, i, j, k) = VMAX2(kke, *mgfree) * coef_uC * VAT3(a3cf, i, j, k);
                 //fprintf(data, "%19.12E\n", VAT3(uC, i, j, k));
                 bc_cond_u = (1 - kke) * coef_uC * VAT3(a3cf, i, j, k) * VAT3(gzcf, i, j, 2);
                 VAT3(fc, i, j, k) += bc_cond_u;
@@ -67,6 +67,8 @@ VEXTERNC void VbuildA(
         int*    nz,      /**< @todo:Doc */
         int*    ipkey,   /**< @todo:Doc */
         int*    mgdisc,  /**< @todo:Doc */
+        int*    mgfree,  /**< 1 to store only the face weights of a finite
+                          *   volume operator (see VbuildA_fv) */
         int*    numdia,  /**< @todo:Doc */
         int*    ipc,     /**< @todo:Doc */
         double* rpc,     /**< @todo:Doc */
@@ -163,10 +165,15 @@ VEXTERNC void VbuildA_fv(
         int*    ny,     /**< @todo:Doc */
         int*    nz,     /**< @todo:Doc */
         int*    ipkey,  /**< @todo:Doc */
+        int*    mgfree, /**< 1 to leave out the diagonal oC, and keep the
+                         *   east, north and up weights of the boundary
+                         *   faces instead, so that the diagonal can be
+                         *   formed from the faces (ipc[12] is set to 1 and
+                         *   numdia to 3) */
         int*    numdia, /**< @todo:Doc */
         int*    ipc,    /**< @todo:Doc */
         double* rpc,    /**< @todo:Doc */
-        double* oC,     /**< @todo:Doc */
+        double* oC,     /**< @todo:Doc (unused if mgfree is 1) */
         double* cc,     /**< @todo:Doc */
         double* fc,     /**< @todo:Doc */
         double* oE,     /**< @todo:Doc */
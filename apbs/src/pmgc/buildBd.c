@@ -135,6 +135,11 @@ VPUBLIC void Vbuildband1_7(int *nx, int *ny, int *nz,
     VAT(ipcB, 3) = *lda;
     VAT(ipcB, 4) = 0;
 
+    // Clear the band: only the stencil entries are set below, and a reused
+    // work array may still hold the fill of an earlier factorization
+    for (jj=1; jj<=*lda * *n; jj++)
+        VAT(acB, jj) = 0.0;
+
     jj = 0;
 
     //fprintf(data, "%s\n", PRINT_FUNC);
@@ -213,6 +218,11 @@ VPUBLIC void Vbuildband1_27(int *nx, int *ny, int *nz,
     VAT(ipcB, 3) = *lda;
     VAT(ipcB, 4) = 0;
 
+    // Clear the band: only the stencil entries are set below, and a reused
+    // work array may still hold the fill of an earlier factorization
+    for (jj=1; jj<=*lda * *n; jj++)
+        VAT(acB, jj) = 0.0;
+
     jj = 0;
 
     //fprintf(data, "%s\n", PRINT_FUNC);
@@ -52,88 +52,143 @@
 VPUBLIC void VbuildG(int *nxf, int *nyf, int *nzf,
         int *nxc, int *nyc, int *nzc,
         int *numdia,
-        double *pcFF, double *acFF, double *ac) {
+        double *pcFF, double *acFF, double *oCFF, double *ac) {
+
+    int i, j, k;
+    double *oEF, *oNF, *uCF;
 
     MAT2(pcFF, *nxc * *nyc * *nzc, 27);
     MAT2(acFF, *nxf * *nyf * *nzf, 27);
     MAT2(  ac, *nxc * *nyc * *nzc, 27);
 
-    // Call the build routine ***
-    if (*numdia == 1) {
+    MAT3(oCFF, *nxf, *nyf, *nzf);
+    MAT3( oEF, *nxf, *nyf, *nzf);
+    MAT3( oNF, *nxf, *nyf, *nzf);
+    MAT3( uCF, *nxf, *nyf, *nzf);
+
+    oEF = RAT2(acFF, 1, 1);
+    oNF = RAT2(acFF, 1, 2);
+    uCF = RAT2(acFF, 1, 3);
+
+    /* Call the build routine.  The coarse points are independent, so the
+     * routines share their planes among the threads of this region */
+    #pragma omp parallel private(i, j, k)
+    {
+        if (*numdia == 1) {
+
+            VbuildG_1(
+
+                    nxf, nyf, nzf, nxc, nyc, nzc,
+
+                    RAT2(pcFF, 1,  1), RAT2(pcFF, 1,  2), RAT2(pcFF, 1,  3), RAT2(pcFF, 1,  4), RAT2(pcFF, 1,  5),
+                    RAT2(pcFF, 1,  6), RAT2(pcFF, 1,  7), RAT2(pcFF, 1,  8), RAT2(pcFF, 1,  9),
+                    RAT2(pcFF, 1, 10), RAT2(pcFF, 1, 11), RAT2(pcFF, 1, 12), RAT2(pcFF, 1, 13), RAT2(pcFF, 1, 14),
+                    RAT2(pcFF, 1, 15), RAT2(pcFF, 1, 16), RAT2(pcFF, 1, 17), RAT2(pcFF, 1, 18),
+                    RAT2(pcFF, 1, 19), RAT2(pcFF, 1, 20), RAT2(pcFF, 1, 21), RAT2(pcFF, 1, 22), RAT2(pcFF, 1, 23),
+                    RAT2(pcFF, 1, 24), RAT2(pcFF, 1, 25), RAT2(pcFF, 1, 26), RAT2(pcFF, 1, 27),
+
+                    RAT2(acFF, 1, 1),
 
-        VbuildG_1(
+                    RAT2(ac, 1,  1), RAT2(ac, 1,  2), RAT2(ac, 1,  3),
+                    RAT2(ac, 1,  4),
+                    RAT2(ac, 1,  5), RAT2(ac, 1,  6),
+                    RAT2(ac, 1,  7), RAT2(ac, 1,  8), RAT2(ac, 1,  9), RAT2(ac, 1, 10),
+                    RAT2(ac, 1, 11), RAT2(ac, 1, 12), RAT2(ac, 1, 13), RAT2(ac, 1, 14)
 
-                nxf, nyf, nzf, nxc, nyc, nzc,
+                    );
 
-                RAT2(pcFF, 1,  1), RAT2(pcFF, 1,  2), RAT2(pcFF, 1,  3), RAT2(pcFF, 1,  4), RAT2(pcFF, 1,  5),
-                RAT2(pcFF, 1,  6), RAT2(pcFF, 1,  7), RAT2(pcFF, 1,  8), RAT2(pcFF, 1,  9),
-                RAT2(pcFF, 1, 10), RAT2(pcFF, 1, 11), RAT2(pcFF, 1, 12), RAT2(pcFF, 1, 13), RAT2(pcFF, 1, 14),
-                RAT2(pcFF, 1, 15), RAT2(pcFF, 1, 16), RAT2(pcFF, 1, 17), RAT2(pcFF, 1, 18),
-                RAT2(pcFF, 1, 19), RAT2(pcFF, 1, 20), RAT2(pcFF, 1, 21), RAT2(pcFF, 1, 22), RAT2(pcFF, 1, 23),
-                RAT2(pcFF, 1, 24), RAT2(pcFF, 1, 25), RAT2(pcFF, 1, 26), RAT2(pcFF, 1, 27),
+        } else if (*numdia == 7 && oCFF != VNULL) {
 
-                RAT2(acFF, 1, 1),
+            /* The fine operator is stored as its face weights only; form
+             * its diagonal in the given workspace, in the order VbuildA
+             * sums it */
+            #pragma omp for
+            for (k=2; k<=*nzf-1; k++)
+                for (j=2; j<=*nyf-1; j++)
+                    for (i=2; i<=*nxf-1; i++)
+                        VAT3(oCFF, i, j, k) = VAT3(oEF, i, j, k)
+                                            + VAT3(oEF, i-1, j, k)
+                                            + VAT3(oNF, i, j, k)
+                                            + VAT3(oNF, i, j-1, k)
+                                            + VAT3(uCF, i, j, k)
+                                            + VAT3(uCF, i, j, k-1);
 
-                RAT2(ac, 1,  1), RAT2(ac, 1,  2), RAT2(ac, 1,  3),
-                RAT2(ac, 1,  4),
-                RAT2(ac, 1,  5), RAT2(ac, 1,  6),
-                RAT2(ac, 1,  7), RAT2(ac, 1,  8), RAT2(ac, 1,  9), RAT2(ac, 1, 10),
-                RAT2(ac, 1, 11), RAT2(ac, 1, 12), RAT2(ac, 1, 13), RAT2(ac, 1, 14)
+            VbuildG_7(
 
-                );
+                    nxf, nyf, nzf,
+                    nxc, nyc, nzc,
 
-    } else if (*numdia == 7) {
+                    RAT2(pcFF, 1,  1), RAT2(pcFF, 1,  2), RAT2(pcFF, 1,  3), RAT2(pcFF, 1,  4), RAT2(pcFF, 1,  5),
+                    RAT2(pcFF, 1,  6), RAT2(pcFF, 1,  7), RAT2(pcFF, 1,  8), RAT2(pcFF, 1,  9),
+                    RAT2(pcFF, 1, 10), RAT2(pcFF, 1, 11), RAT2(pcFF, 1, 12), RAT2(pcFF, 1, 13), RAT2(pcFF, 1, 14),
+                    RAT2(pcFF, 1, 15), RAT2(pcFF, 1, 16), RAT2(pcFF, 1, 17), RAT2(pcFF, 1, 18),
+                    RAT2(pcFF, 1, 19), RAT2(pcFF, 1, 20), RAT2(pcFF, 1, 21), RAT2(pcFF, 1, 22), RAT2(pcFF, 1, 23),
+                    RAT2(pcFF, 1, 24), RAT2(pcFF, 1, 25), RAT2(pcFF, 1, 26), RAT2(pcFF, 1, 27),
 
-        VbuildG_7(
+                    oCFF, oEF, oNF, uCF,
 
-                nxf, nyf, nzf,
-                nxc, nyc, nzc,
+                    RAT2(ac, 1,  1), RAT2(ac, 1,  2), RAT2(ac, 1,  3),
+                    RAT2(ac, 1,  4),
+                    RAT2(ac, 1,  5), RAT2(ac, 1,  6),
+                    RAT2(ac, 1,  7), RAT2(ac, 1,  8), RAT2(ac, 1,  9), RAT2(ac, 1, 10),
+                    RAT2(ac, 1, 11), RAT2(ac, 1, 12), RAT2(ac, 1, 13), RAT2(ac, 1, 14)
 
-                RAT2(pcFF, 1,  1), RAT2(pcFF, 1,  2), RAT2(pcFF, 1,  3), RAT2(pcFF, 1,  4), RAT2(pcFF, 1,  5),
-                RAT2(pcFF, 1,  6), RAT2(pcFF, 1,  7), RAT2(pcFF, 1,  8), RAT2(pcFF, 1,  9),
-                RAT2(pcFF, 1, 10), RAT2(pcFF, 1, 11), RAT2(pcFF, 1, 12), RAT2(pcFF, 1, 13), RAT2(pcFF, 1, 14),
-                RAT2(pcFF, 1, 15), RAT2(pcFF, 1, 16), RAT2(pcFF, 1, 17), RAT2(pcFF, 1, 18),
-                RAT2(pcFF, 1, 19), RAT2(pcFF, 1, 20), RAT2(pcFF, 1, 21), RAT2(pcFF, 1, 22), RAT2(pcFF, 1, 23),
-                RAT2(pcFF, 1, 24), RAT2(pcFF, 1, 25), RAT2(pcFF, 1, 26), RAT2(pcFF, 1, 27),
+            );
 
-                RAT2(acFF, 1,  1), RAT2(acFF, 1,  2), RAT2(acFF, 1,  3), RAT2(acFF, 1,  4),
+        } else if (*numdia == 7) {
 
-                RAT2(ac, 1,  1), RAT2(ac, 1,  2), RAT2(ac, 1,  3),
-                RAT2(ac, 1,  4),
-                RAT2(ac, 1,  5), RAT2(ac, 1,  6),
-                RAT2(ac, 1,  7), RAT2(ac, 1,  8), RAT2(ac, 1,  9), RAT2(ac, 1, 10),
-                RAT2(ac, 1, 11), RAT2(ac, 1, 12), RAT2(ac, 1, 13), RAT2(ac, 1, 14)
+            VbuildG_7(
 
-        );
+                    nxf, nyf, nzf,
+                    nxc, nyc, nzc,
 
-    } else if (*numdia == 27) {
+                    RAT2(pcFF, 1,  1), RAT2(pcFF, 1,  2), RAT2(pcFF, 1,  3), RAT2(pcFF, 1,  4), RAT2(pcFF, 1,  5),
+                    RAT2(pcFF, 1,  6), RAT2(pcFF, 1,  7), RAT2(pcFF, 1,  8), RAT2(pcFF, 1,  9),
+                    RAT2(pcFF, 1, 10), RAT2(pcFF, 1, 11), RAT2(pcFF, 1, 12), RAT2(pcFF, 1, 13), RAT2(pcFF, 1, 14),
+                    RAT2(pcFF, 1, 15), RAT2(pcFF, 1, 16), RAT2(pcFF, 1, 17), RAT2(pcFF, 1, 18),
+                    RAT2(pcFF, 1, 19), RAT2(pcFF, 1, 20), RAT2(pcFF, 1, 21), RAT2(pcFF, 1, 22), RAT2(pcFF, 1, 23),
+                    RAT2(pcFF, 1, 24), RAT2(pcFF, 1, 25), RAT2(pcFF, 1, 26), RAT2(pcFF, 1, 27),
 
-        VbuildG_27(
+                    RAT2(acFF, 1,  1), RAT2(acFF, 1,  2), RAT2(acFF, 1,  3), RAT2(acFF, 1,  4),
 
-                nxf, nyf, nzf,
-                nxc, nyc, nzc,
+                    RAT2(ac, 1,  1), RAT2(ac, 1,  2), RAT2(ac, 1,  3),
+                    RAT2(ac, 1,  4),
+                    RAT2(ac, 1,  5), RAT2(ac, 1,  6),
+                    RAT2(ac, 1,  7), RAT2(ac, 1,  8), RAT2(ac, 1,  9), RAT2(ac, 1, 10),
+                    RAT2(ac, 1, 11), RAT2(ac, 1, 12), RAT2(ac, 1, 13), RAT2(ac, 1, 14)
 
-                RAT2(pcFF, 1,  1), RAT2(pcFF, 1,  2), RAT2(pcFF, 1,  3), RAT2(pcFF, 1,  4), RAT2(pcFF, 1,  5),
-                RAT2(pcFF, 1,  6), RAT2(pcFF, 1,  7), RAT2(pcFF, 1,  8), RAT2(pcFF, 1,  9),
-                RAT2(pcFF, 1, 10), RAT2(pcFF, 1, 11), RAT2(pcFF, 1, 12), RAT2(pcFF, 1, 13), RAT2(pcFF, 1, 14),
-                RAT2(pcFF, 1, 15), RAT2(pcFF, 1, 16), RAT2(pcFF, 1, 17), RAT2(pcFF, 1, 18),
-                RAT2(pcFF, 1, 19), RAT2(pcFF, 1, 20), RAT2(pcFF, 1, 21), RAT2(pcFF, 1, 22), RAT2(pcFF, 1, 23),
-                RAT2(pcFF, 1, 24), RAT2(pcFF, 1, 25), RAT2(pcFF, 1, 26), RAT2(pcFF, 1, 27),
+            );
 
-                RAT2(acFF, 1,  1), RAT2(acFF, 1,  2), RAT2(acFF, 1,  3), RAT2(acFF, 1,  4),
-                RAT2(acFF, 1,  5), RAT2(acFF, 1,  6), RAT2(acFF, 1,  7), RAT2(acFF, 1,  8), RAT2(acFF, 1,  9),
-                RAT2(acFF, 1, 10), RAT2(acFF, 1, 11), RAT2(acFF, 1, 12), RAT2(acFF, 1, 13), RAT2(acFF, 1, 14),
+        } else if (*numdia == 27) {
 
-                RAT2(ac, 1,  1), RAT2(ac, 1,  2), RAT2(ac, 1,  3),
-                RAT2(ac, 1,  4),
-                RAT2(ac, 1,  5), RAT2(ac, 1,  6),
-                RAT2(ac, 1,  7), RAT2(ac, 1,  8), RAT2(ac, 1,  9), RAT2(ac, 1, 10),
-                RAT2(ac, 1, 11), RAT2(ac, 1, 12), RAT2(ac, 1, 13), RAT2(ac, 1, 14)
+            VbuildG_27(
 
-        );
+                    nxf, nyf, nzf,
+                    nxc, nyc, nzc,
 
-    } else {
-        Vnm_print(2, "BUILDG: invalid stencil type given...\n");
+                    RAT2(pcFF, 1,  1), RAT2(pcFF, 1,  2), RAT2(pcFF, 1,  3), RAT2(pcFF, 1,  4), RAT2(pcFF, 1,  5),
+                    RAT2(pcFF, 1,  6), RAT2(pcFF, 1,  7), RAT2(pcFF, 1,  8), RAT2(pcFF, 1,  9),
+                    RAT2(pcFF, 1, 10), RAT2(pcFF, 1, 11), RAT2(pcFF, 1, 12), RAT2(pcFF, 1, 13), RAT2(pcFF, 1, 14),
+                    RAT2(pcFF, 1, 15), RAT2(pcFF, 1, 16), RAT2(pcFF, 1, 17), RAT2(pcFF, 1, 18),
+                    RAT2(pcFF, 1, 19), RAT2(pcFF, 1, 20), RAT2(pcFF, 1, 21), RAT2(pcFF, 1, 22), RAT2(pcFF, 1, 23),
+                    RAT2(pcFF, 1, 24), RAT2(pcFF, 1, 25), RAT2(pcFF, 1, 26), RAT2(pcFF, 1, 27),
+
+                    RAT2(acFF, 1,  1), RAT2(acFF, 1,  2), RAT2(acFF, 1,  3), RAT2(acFF, 1,  4),
+                    RAT2(acFF, 1,  5), RAT2(acFF, 1,  6), RAT2(acFF, 1,  7), RAT2(acFF, 1,  8), RAT2(acFF, 1,  9),
+                    RAT2(acFF, 1, 10), RAT2(acFF, 1, 11), RAT2(acFF, 1, 12), RAT2(acFF, 1, 13), RAT2(acFF, 1, 14),
+
+                    RAT2(ac, 1,  1), RAT2(ac, 1,  2), RAT2(ac, 1,  3),
+                    RAT2(ac, 1,  4),
+                    RAT2(ac, 1,  5), RAT2(ac, 1,  6),
+                    RAT2(ac, 1,  7), RAT2(ac, 1,  8), RAT2(ac, 1,  9), RAT2(ac, 1, 10),
+                    RAT2(ac, 1, 11), RAT2(ac, 1, 12), RAT2(ac, 1, 13), RAT2(ac, 1, 14)
+
+            );
+
+        } else {
+            #pragma omp master
+            Vnm_print(2, "BUILDG: invalid stencil type given...\n");
+        }
     }
 }
 
@@ -218,13 +273,14 @@ VPUBLIC void VbuildG_1(int *nxf, int *nyf, int *nzf,
     //fprintf(data, "%s\n", PRINT_FUNC);
 
     // Build the operator
+    #pragma omp for
     for(kk=2; kk<=*nz-1; kk++) {
         k = 2 * kk - 1;
 
         for(jj=2; jj<=*ny-1; jj++) {
             j = 2 * jj - 1;
 
-            for(ii=2; ii<=*nx-1; i++) {
+            for(ii=2; ii<=*nx-1; ii++) {
                i = 2 * ii - 1;
 
                // Index computations
@@ -534,6 +590,7 @@ VPUBLIC void VbuildG_7(int *nxf, int *nyf, int *nzf,
     //fprintf(data, "%s\n", PRINT_FUNC);
 
     // Build the operator ***
+    #pragma omp for
     for(kk=2; kk<=*nz-1; kk++) {
         k = 2 * kk - 1;
 
@@ -1382,6 +1439,7 @@ VPUBLIC void VbuildG_27(int *nxf, int *nyf, int *nzf,
     //fprintf(data, "%s\n", PRINT_FUNC);
 
     // Build the operator ***
+    #pragma omp for
     for(kk=2; kk<=*nz-1; kk++) {
          k = 2 * kk - 1;
 
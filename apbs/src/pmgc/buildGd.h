@@ -56,6 +56,14 @@
 #include "generic/vhal.h"
 #include "generic/vmatrix.h"
 
+/** @brief   Build the Galerkin coarse grid matrix P^T A P with the routine
+ *           for the stencil of the fine operator (numdia = 1, 7 or 27)
+ *  @note    The routines split their coarse planes among the threads of a
+ *           parallel region opened here, so they run in parallel even
+ *           though each one is written as a plain loop nest.  Called on
+ *           their own, they run serially.
+ *  @ingroup PMGC
+ */
 VEXTERNC void VbuildG(
         int    *nxf,    ///< @todo: doc
         int    *nyf,    ///< @todo: doc
@@ -66,6 +74,9 @@ VEXTERNC void VbuildG(
         int    *numdia, ///< @todo: doc
         double *pcFF,   ///< @todo: doc
         double *acFF,   ///< @todo: doc
+        double *oCFF,   ///< VNULL, or fine level workspace if acFF holds
+                        ///< only the face weights of a 7-point operator
+                        ///< (see VbuildA_fv); the diagonal is formed there
         double *ac      ///< @todo: doc
         );
 
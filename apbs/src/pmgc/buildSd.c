@@ -0,0 +1,384 @@
+/**
+ *  @ingroup PMGC
+ *  @brief   Sparse LDL^T factorization of the coarsest grid operator
+ *  @version $Id:
+ *
+ *  @attention
+ *  @verbatim
+ *
+ * APBS -- Adaptive Poisson-Boltzmann Solver
+ *
+ * Nathan A. Baker (nathan.baker@pnl.gov)
+ * Pacific Northwest National Laboratory
+ *
+ * Additional contributing authors listed in the code documentation.
+ *
+ * Copyright (c) 2010-2014 Battelle Memorial Institute. Developed at the Pacific Northwest National Laboratory, operated by Battelle Memorial Institute, Pacific Northwest Division for the U.S. Department Energy.  Portions Copyright (c) 2002-2010, Washington University in St. Louis.  Portions Copyright (c) 2002-2010, Nathan A. Baker.  Portions Copyright (c) 1999-2002, The Regents of the University of California. Portions Copyright (c) 1995, Michael Holst.
+ * All rights reserved.
+ *
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * -  Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * - Neither the name of Washington University in St. Louis nor the names of its
+ * contributors may be used to endorse or promote products derived from this
+ * software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @endverbatim
+ */
+
+#include "buildSd.h"
+
+/* The neighbors of a point: offset, the column of ac that holds their
+ * weight, and the point at which Vmatvec reads the weight.  The first six
+ * make up the 7-point stencil. */
+VPRIVATE const int sparsStn[26][7] = {
+    { 1, 0, 0,  2,  0, 0, 0}, {-1, 0, 0,  2, -1, 0, 0},   // oE
+    { 0, 1, 0,  3,  0, 0, 0}, { 0,-1, 0,  3,  0,-1, 0},   // oN
+    { 0, 0, 1,  4,  0, 0, 0}, { 0, 0,-1,  4,  0, 0,-1},   // uC
+    { 1, 1, 0,  5,  0, 0, 0}, {-1,-1, 0,  5, -1,-1, 0},   // oNE
+    {-1, 1, 0,  6,  0, 0, 0}, { 1,-1, 0,  6,  1,-1, 0},   // oNW
+    { 1, 0, 1,  7,  0, 0, 0}, {-1, 0,-1,  7, -1, 0,-1},   // uE
+    {-1, 0, 1,  8,  0, 0, 0}, { 1, 0,-1,  8,  1, 0,-1},   // uW
+    { 0, 1, 1,  9,  0, 0, 0}, { 0,-1,-1,  9,  0,-1,-1},   // uN
+    { 0,-1, 1, 10,  0, 0, 0}, { 0, 1,-1, 10,  0, 1,-1},   // uS
+    { 1, 1, 1, 11,  0, 0, 0}, {-1,-1,-1, 11, -1,-1,-1},   // uNE
+    {-1, 1, 1, 12,  0, 0, 0}, { 1,-1,-1, 12,  1,-1,-1},   // uNW
+    { 1,-1, 1, 13,  0, 0, 0}, {-1, 1,-1, 13, -1, 1,-1},   // uSE
+    {-1,-1, 1, 14,  0, 0, 0}, { 1, 1,-1, 14,  1, 1,-1}    // uSW
+};
+
+/* Packed index of neighbor s of interior point (i, j, k), or -1 if it is
+ * on the boundary */
+VPRIVATE int Vsparsnbr(int s, int i, int j, int k, int ni, int nj, int nk) {
+
+    i += sparsStn[s][0];
+    j += sparsStn[s][1];
+    k += sparsStn[s][2];
+    if ((i < 0) || (i >= ni) || (j < 0) || (j >= nj) || (k < 0) || (k >= nk))
+        return -1;
+    return i + ni * (j + nj * k);
+}
+
+/* Number the interior points of the box [i0,i1]x[j0,j1]x[k0,k1] by
+ * nested dissection: the two halves first, then the plane between them */
+VPRIVATE void Vnestdis(int i0, int i1, int j0, int j1, int k0, int k1,
+        int ni, int nj, int *perm, int *cnt) {
+
+    int i, j, k, m;
+    int di, dj, dk;
+
+    di = i1 - i0 + 1;
+    dj = j1 - j0 + 1;
+    dk = k1 - k0 + 1;
+    if ((di <= 0) || (dj <= 0) || (dk <= 0))
+        return;
+
+    if ((di <= 2) && (dj <= 2) && (dk <= 2)) {
+        for (k=k0; k<=k1; k++)
+            for (j=j0; j<=j1; j++)
+                for (i=i0; i<=i1; i++)
+                    perm[(*cnt)++] = i + ni * (j + nj * k);
+
+    } else if ((dk >= dj) && (dk >= di)) {
+        m = (k0 + k1) / 2;
+        Vnestdis(i0, i1, j0, j1, k0, m-1, ni, nj, perm, cnt);
+        Vnestdis(i0, i1, j0, j1, m+1, k1, ni, nj, perm, cnt);
+        for (j=j0; j<=j1; j++)
+            for (i=i0; i<=i1; i++)
+                perm[(*cnt)++] = i + ni * (j + nj * m);
+
+    } else if (dj >= di) {
+        m = (j0 + j1) / 2;
+        Vnestdis(i0, i1, j0, m-1, k0, k1, ni, nj, perm, cnt);
+        Vnestdis(i0, i1, m+1, j1, k0, k1, ni, nj, perm, cnt);
+        for (k=k0; k<=k1; k++)
+            for (i=i0; i<=i1; i++)
+                perm[(*cnt)++] = i + ni * (m + nj * k);
+
+    } else {
+        m = (i0 + i1) / 2;
+        Vnestdis(i0, m-1, j0, j1, k0, k1, ni, nj, perm, cnt);
+        Vnestdis(m+1, i1, j0, j1, k0, k1, ni, nj, perm, cnt);
+        for (k=k0; k<=k1; k++)
+            for (j=j0; j<=j1; j++)
+                perm[(*cnt)++] = m + ni * (j + nj * k);
+    }
+}
+
+/* Ascending order of two row indices, for qsort */
+VPRIVATE int Vsparscmp(const void *a, const void *b) {
+
+    return *(const int *)a - *(const int *)b;
+}
+
+/* Order the unknowns by nested dissection and find the rows of each column
+ * of the factor below the diagonal: the rows of the operator merged with
+ * those of the column's children in the elimination tree, sorted, in
+ * rind[cptr[j]] to rind[cptr[j+1]-1].  The parent of a column is its first
+ * row.  Returns the number of off-diagonal entries of the factor, or -1 if
+ * they do not fit in the mxnz entries of rind (mxnz < 0 for no limit). */
+VPRIVATE int Vsparsym(int nstn, int ni, int nj, int nk, int *perm,
+        int *iperm, int *cptr, int *parent, int *child, int *sibl,
+        int *mark, int *rind, int mxnz) {
+
+    int n, cnt, nnz, j, p, q, r, s, c, e;
+
+    n = ni * nj * nk;
+    cnt = 0;
+    Vnestdis(0, ni-1, 0, nj-1, 0, nk-1, ni, nj, perm, &cnt);
+    for (j=0; j<n; j++) {
+        iperm[perm[j]] = j;
+        child[j] = -1;
+        mark[j] = -1;
+    }
+
+    nnz = 0;
+    for (j=0; j<n; j++) {
+        cptr[j] = nnz;
+        mark[j] = j;
+        p = perm[j];
+
+        // Later neighbors of the unknown
+        for (s=0; s<nstn; s++) {
+            q = Vsparsnbr(s, p % ni, (p / ni) % nj, p / (ni * nj), ni, nj, nk);
+            if (q < 0)
+                continue;
+            r = iperm[q];
+            if ((r < j) || (mark[r] == j))
+                continue;
+            if ((mxnz >= 0) && (nnz >= mxnz))
+                return -1;
+            mark[r] = j;
+            rind[nnz++] = r;
+        }
+
+        // Fill from the columns eliminated into this one
+        for (c=child[j]; c>=0; c=sibl[c]) {
+            for (e=cptr[c]; e<cptr[c+1]; e++) {
+                r = rind[e];
+                if (mark[r] == j)
+                    continue;
+                if ((mxnz >= 0) && (nnz >= mxnz))
+                    return -1;
+                mark[r] = j;
+                rind[nnz++] = r;
+            }
+        }
+
+        qsort(rind + cptr[j], nnz - cptr[j], sizeof(int), Vsparscmp);
+        parent[j] = -1;
+        if (nnz > cptr[j]) {
+            parent[j] = rind[cptr[j]];
+            sibl[j] = child[parent[j]];
+            child[parent[j]] = j;
+        }
+    }
+    cptr[n] = nnz;
+
+    return nnz;
+}
+
+VPUBLIC void Vsparsz(int *numdia, int *nx, int *ny, int *nz,
+        int *n_rsp, int *n_isp) {
+
+    int ni, nj, nk, n, nstn, lnz, mxnz;
+    int *iwk;
+
+    ni = *nx - 2;
+    nj = *ny - 2;
+    nk = *nz - 2;
+    n  = ni * nj * nk;
+    nstn = (*numdia == 7) ? 6 : 26;
+
+    // The rows of the factor are only known once they are built; start
+    // from a guess and grow it until they fit
+    mxnz = 8 * nstn * n;
+    do {
+        iwk = (int *)Vmem_malloc(VNULL, 7*n + 1 + mxnz, sizeof(int));
+        lnz = Vsparsym(nstn, ni, nj, nk, iwk, iwk + n, iwk + 2*n,
+                iwk + 3*n + 1, iwk + 4*n + 1, iwk + 5*n + 1, iwk + 6*n + 1,
+                iwk + 7*n + 1, mxnz);
+        Vmem_free(VNULL, 7*n + 1 + mxnz, sizeof(int), (void **)&iwk);
+        mxnz *= 2;
+    } while (lnz < 0);
+
+    // The diagonal, a dense work column and the factor; the header, seven
+    // integer vectors and the rows of the factor
+    *n_rsp = 2*n + lnz;
+    *n_isp = 10 + 7*n + 1 + lnz;
+}
+
+VPUBLIC void Vbuildsparse(int *key, int *nx, int *ny, int *nz,
+        int *ipc, double *rpc, double *ac, double *cc,
+        int *ipcS, double *rpcS, double *acS) {
+
+    int numdia, nstn;
+    int ni, nj, nk, n, nxyz, lnz;
+    int i, j, k, s, p, q, r, e, f, kn, pk;
+    int *perm, *iperm, *cptr, *parent, *head, *link, *pos, *rind;
+    double *diag, *work, *lval;
+    double t;
+
+    numdia = VAT(ipc, 11);
+    if (numdia == 7) {
+        nstn = 6;
+    } else if (numdia == 27) {
+        nstn = 26;
+    } else {
+        Vnm_print(2, "Vbuildsparse: invalid stencil type given...");
+        *key = 1;
+        return;
+    }
+
+    ni   = *nx - 2;
+    nj   = *ny - 2;
+    nk   = *nz - 2;
+    n    = ni * nj * nk;
+    nxyz = *nx * *ny * *nz;
+
+    // The child and sibling lists of the symbolic step are reused as the
+    // lists of columns waiting to update each row, and the marks as the
+    // position of each column's next row
+    perm   = RAT(ipcS, 11);
+    iperm  = perm + n;
+    cptr   = perm + 2*n;
+    parent = perm + 3*n + 1;
+    head   = perm + 4*n + 1;
+    link   = perm + 5*n + 1;
+    pos    = perm + 6*n + 1;
+    rind   = perm + 7*n + 1;
+
+    diag = acS;
+    work = acS + n;
+    lval = acS + 2*n;
+
+    lnz = Vsparsym(nstn, ni, nj, nk, perm, iperm, cptr, parent, head, link,
+            pos, rind, -1);
+
+    VAT(ipcS, 1) = n;
+    VAT(ipcS, 2) = lnz;
+    VAT(ipcS, 3) = numdia;
+    VAT(ipcS, 4) = 0;
+
+    for (j=0; j<n; j++) {
+        head[j] = -1;
+        work[j] = 0.0;
+    }
+
+    // Left-looking LDL^T, one column at a time: gather column j of the
+    // operator, subtract the contributions of the finished columns with a
+    // row j, then scale by the pivot
+    *key = 0;
+    for (j=0; j<n; j++) {
+
+        p  = perm[j];
+        i  = p % ni;
+        k  = (p / ni) % nj;
+        pk = p / (ni * nj);
+
+        q = (i + 1) + *nx * ((k + 1) + *ny * (pk + 1));
+        work[j] = ac[q] + cc[q];
+        for (s=0; s<nstn; s++) {
+            q = Vsparsnbr(s, i, k, pk, ni, nj, nk);
+            if ((q < 0) || (iperm[q] < j))
+                continue;
+            work[iperm[q]] -= ac[(sparsStn[s][3] - 1) * nxyz
+                + (i + 1 + sparsStn[s][4])
+                + *nx * ((k + 1 + sparsStn[s][5])
+                + *ny * (pk + 1 + sparsStn[s][6]))];
+        }
+
+        for (r=head[j]; r>=0; r=kn) {
+            kn = link[r];
+            e = pos[r];
+            t = lval[e] * diag[r];
+            for (f=e; f<cptr[r+1]; f++)
+                work[rind[f]] -= lval[f] * t;
+            // Column r now waits for its next row
+            pos[r] = ++e;
+            if (e < cptr[r+1]) {
+                link[r] = head[rind[e]];
+                head[rind[e]] = r;
+            }
+        }
+
+        diag[j] = work[j];
+        work[j] = 0.0;
+        if (diag[j] <= 0.0) {
+            Vnm_print(2, "Vbuildsparse: ldl problem: %d\n", j + 1);
+            Vnm_print(2, "Vbuildsparse: leading principle minor not PD...\n");
+            *key = 1;
+            return;
+        }
+        for (e=cptr[j]; e<cptr[j+1]; e++) {
+            lval[e] = work[rind[e]] / diag[j];
+            work[rind[e]] = 0.0;
+        }
+
+        pos[j] = cptr[j];
+        if (cptr[j] < cptr[j+1]) {
+            link[j] = head[rind[cptr[j]]];
+            head[rind[cptr[j]]] = j;
+        }
+    }
+
+    VAT(ipcS, 4) = 1;
+}
+
+VPUBLIC void Vsparsl(int *ipcS, double *acS, double *x) {
+
+    int n, j, e;
+    int *perm, *cptr, *rind;
+    double *diag, *work, *lval;
+    double t;
+
+    n    = VAT(ipcS, 1);
+    perm = RAT(ipcS, 11);
+    cptr = perm + 2*n;
+    rind = perm + 7*n + 1;
+
+    diag = acS;
+    work = acS + n;
+    lval = acS + 2*n;
+
+    for (j=0; j<n; j++)
+        work[j] = x[perm[j]];
+
+    // Forward solve with L, scale by D, back solve with L^T
+    for (j=0; j<n; j++) {
+        t = work[j];
+        for (e=cptr[j]; e<cptr[j+1]; e++)
+            work[rind[e]] -= lval[e] * t;
+    }
+    for (j=0; j<n; j++)
+        work[j] /= diag[j];
+    for (j=n-1; j>=0; j--) {
+        t = work[j];
+        for (e=cptr[j]; e<cptr[j+1]; e++)
+            t -= lval[e] * work[rind[e]];
+        work[j] = t;
+    }
+
+    for (j=0; j<n; j++)
+        x[perm[j]] = work[j];
+}
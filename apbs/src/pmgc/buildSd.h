@@ -0,0 +1,114 @@
+/**
+ *  @ingroup PMGC
+ *  @brief  Sparse LDL^T factorization of the coarsest grid operator
+ *  @version $Id:
+ *
+ *  @attention
+ *  @verbatim
+ *
+ * APBS -- Adaptive Poisson-Boltzmann Solver
+ *
+ * Nathan A. Baker (nathan.baker@pnl.gov)
+ * Pacific Northwest National Laboratory
+ *
+ * Additional contributing authors listed in the code documentation.
+ *
+ * Copyright (c) 2010-2014 Battelle Memorial Institute. Developed at the Pacific Northwest National Laboratory, operated by Battelle Memorial Institute, Pacific Northwest Division for the U.S. Department Energy.  Portions Copyright (c) 2002-2010, Washington University in St. Louis.  Portions Copyright (c) 2002-2010, Nathan A. Baker.  Portions Copyright (c) 1999-2002, The Regents of the University of California. Portions Copyright (c) 1995, Michael Holst.
+ * All rights reserved.
+ *
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * -  Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * - Neither the name of Washington University in St. Louis nor the names of its
+ * contributors may be used to endorse or promote products derived from this
+ * software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @endverbatim
+ */
+
+#ifndef _BUILDSD_H_
+#define _BUILDSD_H_
+
+#include "apbscfg.h"
+
+#include "maloc/maloc.h"
+
+#include "generic/vhal.h"
+#include "generic/vmatrix.h"
+
+/** @brief   Storage needed by the sparse factor of a coarse operator.
+ *
+ *    The interior unknowns are ordered by geometric nested dissection,
+ *    and the nonzero pattern of the factor follows from the stencil
+ *    alone, so the sizes are known before any operator is built.  The
+ *    integer storage includes the 100 entries reserved for the level
+ *    info array that holds the factor.
+ *
+ *  @ingroup PMGC
+ */
+VEXTERNC void Vsparsz(
+        int *numdia,  ///< Number of stencil diagonals (7 or 27)
+        int *nx,      ///< Coarse grid points in x, including the boundary
+        int *ny,      ///< Coarse grid points in y, including the boundary
+        int *nz,      ///< Coarse grid points in z, including the boundary
+        int *n_rsp,   ///< Set to the required real storage
+        int *n_isp    ///< Set to the required integer storage
+        );
+
+/** @brief   Build and factor the coarse operator in sparse form.
+ *
+ *    Sparse counterpart of Vbuildband.  The matrix is the one applied by
+ *    Vmatvec: the off-diagonal stencil weights and oC + cc on the
+ *    diagonal.  Only the fill of the nested dissection ordering is
+ *    stored, so much larger coarse grids can be factored than with the
+ *    banded LINPACK solver.
+ *
+ *  @ingroup PMGC
+ */
+VEXTERNC void Vbuildsparse(
+        int *key,     ///< Set to 1 if the operator is not positive definite
+        int *nx,      ///< Grid points in x
+        int *ny,      ///< Grid points in y
+        int *nz,      ///< Grid points in z
+        int *ipc,     ///< Integer info of the operator
+        double *rpc,  ///< Real info of the operator
+        double *ac,   ///< Operator in diagonal form
+        double *cc,   ///< Helmholtz term
+        int *ipcS,    ///< Integer storage of the factor
+        double *rpcS, ///< Real info of the factor
+        double *acS   ///< Real storage of the factor
+        );
+
+/** @brief   Solve with the sparse factor built by Vbuildsparse.
+ *  @ingroup PMGC
+ *  @note    Sparse counterpart of Vdpbsl; x holds the interior unknowns
+ *           as packed by Vxcopy_small and is overwritten with the
+ *           solution.
+ */
+VEXTERNC void Vsparsl(
+        int *ipcS,    ///< Integer storage of the factor
+        double *acS,  ///< Real storage of the factor
+        double *x     ///< Right hand side on input, solution on output
+        );
+
+#endif /* _BUILDSD_H_ */
@@ -0,0 +1,217 @@
+/**
+ *  @ingroup PMGC
+ *  @brief  Conjugate gradient method preconditioned with a multigrid
+ *          v-cycle
+ *  @version $Id:
+ *
+ *  @attention
+ *  @verbatim
+ *
+ * APBS -- Adaptive Poisson-Boltzmann Solver
+ *
+ * Nathan A. Baker (nathan.baker@pnl.gov)
+ * Pacific Northwest National Laboratory
+ *
+ * Additional contributing authors listed in the code documentation.
+ *
+ * Copyright (c) 2010-2014 Battelle Memorial Institute. Developed at the Pacific Northwest National Laboratory, operated by Battelle Memorial Institute, Pacific Northwest Division for the U.S. Department Energy.  Portions Copyright (c) 2002-2010, Washington University in St. Louis.  Portions Copyright (c) 2002-2010, Nathan A. Baker.  Portions Copyright (c) 1999-2002, The Regents of the University of California. Portions Copyright (c) 1995, Michael Holst.
+ * All rights reserved.
+ *
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * -  Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * - Neither the name of Washington University in St. Louis nor the names of its
+ * contributors may be used to endorse or promote products derived from this
+ * software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @endverbatim
+ */
+
+#include "cgmgd.h"
+
+VPUBLIC void Vcgmg(int *nx, int *ny, int *nz,
+        double *x,
+        int *iz,
+        double *w0, double *w1, double *w2, double *w3,
+        double *z, double *p, double *q,
+        int *istop, int *itmax, int *iters, int *ierror,
+        int *nlev, int *ilev, int *nlev_real,
+        int *mgsolv, int *iok, int *iinfo,
+        double *epsiln, double *errtol, double *omega,
+        int *nu1, int *nu2,
+        int *mgsmoo,
+        int *ipc, double *rpc,
+        double *pc, double *ac, double *cc, double *fc, double *tru) {
+
+    int level, lev;
+    int itmax_s, iters_s, ierror_s, iok_s, iinfo_s, istop_s;
+    double errtol_s;
+    double rsden, rsnrm, orsnrm;
+    double rho, rho_old, alpha, beta, pq, zq;
+
+    // Utility variable used to pass a parameter to xaxpy
+    double fac;
+
+    MAT2(iz, 50, 1);
+
+    // Recover level information
+    level = 1;
+    lev = (*ilev - 1) + level;
+
+    // Do some i/o if requested
+    if (*iinfo > 1) {
+        VMESSAGE0("Starting cgmg operation");
+        VMESSAGE3("Fine Grid Size:   (%d, %d, %d)", *nx, *ny, *nz);
+    }
+
+    if (*iok != 0) {
+        Vprtstp(*iok, -1, 0.0, 0.0, 0.0);
+    }
+
+    // Compute denominator for stopping criterion
+    if (*istop == 0) {
+        rsden = 1.0;
+    } else if (*istop == 1) {
+        rsden = Vxnrm1(nx, ny, nz, RAT(fc, VAT2(iz, 1, lev)));
+    } else if (*istop == 2) {
+        rsden = VSQRT(*nx * *ny * *nz);
+    } else if (*istop == 3 || *istop == 4) {
+        rsden = Vxnrm2(nx, ny, nz, RAT(tru, VAT2(iz, 1, lev)));
+    } else if (*istop == 5) {
+        Vmatvec(nx, ny, nz,
+                RAT(ipc, VAT2(iz, 5, lev)), RAT(rpc, VAT2(iz, 6, lev)),
+                RAT( ac, VAT2(iz, 7, lev)), RAT( cc, VAT2(iz, 1, lev)),
+                RAT(tru, VAT2(iz, 1, lev)), w1);
+        rsden = VSQRT(Vxdot(nx, ny, nz, RAT(tru, VAT2(iz, 1, lev)), w1));
+    } else {
+        VABORT_MSG1("Bad istop value: %d", *istop);
+    }
+
+    if (rsden == 0.0) {
+        rsden = 1.0;
+        VERRMSG0("rhs is zero on finest level");
+    }
+    rsnrm = rsden;
+    orsnrm = rsnrm;
+
+    if (*iok != 0) {
+        Vprtstp(*iok, 0, rsnrm, rsden, orsnrm);
+    }
+
+    // The residual of the initial guess replaces the source function
+    Vmresid(nx, ny, nz,
+            RAT(ipc, VAT2(iz, 5, lev)), RAT(rpc, VAT2(iz, 6, lev)),
+            RAT( ac, VAT2(iz, 7, lev)), RAT( cc, VAT2(iz, 1, lev)),
+            RAT( fc, VAT2(iz, 1, lev)), RAT(  x, VAT2(iz, 1, lev)), q);
+    Vxcopy(nx, ny, nz, q, RAT(fc, VAT2(iz, 1, lev)));
+
+    // The preconditioner is one v-cycle, without a stopping test
+    istop_s = -1;
+    itmax_s = 1;
+    iok_s = 0;
+    iinfo_s = 0;
+    errtol_s = 0.0;
+
+    rho_old = 1.0;
+    alpha = 0.0;
+    *iters = 0;
+    do {
+
+        // Apply the preconditioner: z = M r
+        Vazeros(nx, ny, nz, RAT(z, VAT2(iz, 1, lev)));
+        iters_s = 0;
+        ierror_s = 0;
+        Vmvcs(nx, ny, nz,
+                z, iz,
+                w0, w1, w2, w3,
+                &istop_s, &itmax_s, &iters_s, &ierror_s,
+                nlev, ilev, nlev_real, mgsolv,
+                &iok_s, &iinfo_s,
+                epsiln, &errtol_s, omega,
+                nu1, nu2, mgsmoo,
+                ipc, rpc, pc, ac, cc, fc, tru);
+
+        rho = Vxdot(nx, ny, nz,
+                RAT(fc, VAT2(iz, 1, lev)), RAT(z, VAT2(iz, 1, lev)));
+
+        // New search direction; q still holds A p from the last step
+        if (*iters == 0) {
+            Vxcopy(nx, ny, nz, RAT(z, VAT2(iz, 1, lev)), p);
+        } else {
+            zq = Vxdot(nx, ny, nz, RAT(z, VAT2(iz, 1, lev)), q);
+            beta = -alpha * zq / rho_old;
+            Vxscal(nx, ny, nz, &beta, p);
+            fac = 1.0;
+            Vxaxpy(nx, ny, nz, &fac, RAT(z, VAT2(iz, 1, lev)), p);
+        }
+
+        // Step along p
+        Vmatvec(nx, ny, nz,
+                RAT(ipc, VAT2(iz, 5, lev)), RAT(rpc, VAT2(iz, 6, lev)),
+                RAT( ac, VAT2(iz, 7, lev)), RAT( cc, VAT2(iz, 1, lev)),
+                p, q);
+        pq = Vxdot(nx, ny, nz, p, q);
+        VWARN_MSG1(pq > 0.0, "Operator is not positive along p: %g", pq);
+        if (pq <= 0.0) {
+            break;
+        }
+        alpha = rho / pq;
+        rho_old = rho;
+
+        Vxaxpy(nx, ny, nz, &alpha, p, RAT(x, VAT2(iz, 1, lev)));
+        fac = -alpha;
+        Vxaxpy(nx, ny, nz, &fac, q, RAT(fc, VAT2(iz, 1, lev)));
+
+        // Increment the iteration counter
+        (*iters)++;
+
+        // Compute/check the current stopping test
+        orsnrm = rsnrm;
+        if (*istop == 0 || *istop == 1) {
+            rsnrm = Vxnrm1(nx, ny, nz, RAT(fc, VAT2(iz, 1, lev)));
+        } else if (*istop == 2) {
+            rsnrm = VABS(alpha) * Vxnrm1(nx, ny, nz, p);
+        } else if (*istop == 3 || *istop == 4) {
+            Vxcopy(nx, ny, nz, RAT(tru, VAT2(iz, 1, lev)), w1);
+            fac = -1.0;
+            Vxaxpy(nx, ny, nz, &fac, RAT(x, VAT2(iz, 1, lev)), w1);
+            rsnrm = Vxnrm2(nx, ny, nz, w1);
+        } else {
+            Vxcopy(nx, ny, nz, RAT(tru, VAT2(iz, 1, lev)), w1);
+            fac = -1.0;
+            Vxaxpy(nx, ny, nz, &fac, RAT(x, VAT2(iz, 1, lev)), w1);
+            Vmatvec(nx, ny, nz,
+                    RAT(ipc, VAT2(iz, 5, lev)), RAT(rpc, VAT2(iz, 6, lev)),
+                    RAT( ac, VAT2(iz, 7, lev)), RAT( cc, VAT2(iz, 1, lev)),
+                    w1, w2);
+            rsnrm = VSQRT(Vxdot(nx, ny, nz, w1, w2));
+        }
+
+        if (*iok != 0) {
+            Vprtstp(*iok, *iters, rsnrm, rsden, orsnrm);
+        }
+
+    } while (*iters < *itmax && (rsnrm / rsden) > *errtol);
+
+    *ierror = (rsnrm / rsden) > *errtol ? 1 : 0;
+}
@@ -0,0 +1,102 @@
+/**
+ *  @ingroup PMGC
+ *  @brief  Conjugate gradient method preconditioned with a multigrid
+ *          v-cycle
+ *  @version $Id:
+ *
+ *  @attention
+ *  @verbatim
+ *
+ * APBS -- Adaptive Poisson-Boltzmann Solver
+ *
+ * Nathan A. Baker (nathan.baker@pnl.gov)
+ * Pacific Northwest National Laboratory
+ *
+ * Additional contributing authors listed in the code documentation.
+ *
+ * Copyright (c) 2010-2014 Battelle Memorial Institute. Developed at the Pacific Northwest National Laboratory, operated by Battelle Memorial Institute, Pacific Northwest Division for the U.S. Department Energy.  Portions Copyright (c) 2002-2010, Washington University in St. Louis.  Portions Copyright (c) 2002-2010, Nathan A. Baker.  Portions Copyright (c) 1999-2002, The Regents of the University of California. Portions Copyright (c) 1995, Michael Holst.
+ * All rights reserved.
+ *
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * -  Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * - Neither the name of Washington University in St. Louis nor the names of its
+ * contributors may be used to endorse or promote products derived from this
+ * software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @endverbatim
+ */
+
+#ifndef _CGMGD_H_
+#define _CGMGD_H_
+
+#include "apbscfg.h"
+
+#include "maloc/maloc.h"
+
+#include "generic/vhal.h"
+#include "generic/vmatrix.h"
+#include "pmgc/mgsubd.h"
+#include "pmgc/mikpckd.h"
+#include "pmgc/mgcsd.h"
+#include "pmgc/matvecd.h"
+
+/** @brief   Multigrid preconditioned conjugate gradient method.
+ *
+ *    Solves the linear system on level ilev with conjugate gradients,
+ *    applying one Vmvcs v-cycle with a zero initial guess to the
+ *    residual as the preconditioner.  The cycle is symmetric for equal
+ *    nu1 and nu2 (the post-smoothing sweeps in adjoint order), but its
+ *    coarse grid correction is scaled by a step length that depends on
+ *    the residual, so the search directions are orthogonalized with the
+ *    flexible (Polak-Ribiere) form of beta.  This does not assume that
+ *    the preconditioner is a fixed linear operator.
+ *
+ *    Arguments are those of Vmvcs, plus:
+ *       z - multilevel array (iz offsets) for the preconditioned
+ *           residual, which the v-cycle uses on every level
+ *       p, q - fine grid vectors for the search direction and its image
+ *
+ *    The fine grid part of fc holds the source function on entry and is
+ *    overwritten with the residual; w0-w3 are the v-cycle workspace.
+ *    All stopping tests (istop 0-5) of Vmvcs are supported; for istop 2
+ *    the difference of successive iterates is the step alpha*p, so tru
+ *    is only read for istop 3-5.
+ *
+ *  @ingroup PMGC
+ */
+VEXTERNC void Vcgmg(int *nx, int *ny, int *nz,
+        double *x,
+        int *iz,
+        double *w0, double *w1, double *w2, double *w3,
+        double *z, double *p, double *q,
+        int *istop, int *itmax, int *iters, int *ierror,
+        int *nlev, int *ilev, int *nlev_real,
+        int *mgsolv, int *iok, int *iinfo,
+        double *epsiln, double *errtol, double *omega,
+        int *nu1, int *nu2,
+        int *mgsmoo,
+        int *ipc, double *rpc,
+        double *pc, double *ac, double *cc, double *fc, double *tru);
+
+#endif /* _CGMGD_H_ */
@@ -0,0 +1,380 @@
+/**
+ *  @ingroup PMGC
+ *  @brief  Driver for the multigrid preconditioned conjugate gradient
+ *          solver
+ *  @version $Id:
+ *
+ *  @attention
+ *  @verbatim
+ *
+ * APBS -- Adaptive Poisson-Boltzmann Solver
+ *
+ * Nathan A. Baker (nathan.baker@pnl.gov)
+ * Pacific Northwest National Laboratory
+ *
+ * Additional contributing authors listed in the code documentation.
+ *
+ * Copyright (c) 2010-2014 Battelle Memorial Institute. Developed at the Pacific Northwest National Laboratory, operated by Battelle Memorial Institute, Pacific Northwest Division for the U.S. Department Energy.  Portions Copyright (c) 2002-2010, Washington University in St. Louis.  Portions Copyright (c) 2002-2010, Nathan A. Baker.  Portions Copyright (c) 1999-2002, The Regents of the University of California. Portions Copyright (c) 1995, Michael Holst.
+ * All rights reserved.
+ *
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * -  Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * - Neither the name of Washington University in St. Louis nor the names of its
+ * contributors may be used to endorse or promote products derived from this
+ * software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @endverbatim
+ */
+
+#include "cgmgdrvd.h"
+
+VPUBLIC void Vcgmgdriv(int *iparm, double *rparm,
+        int *iwork, double *rwork, double *u,
+        double *xf, double *yf, double *zf,
+        double *gxcf, double *gycf, double *gzcf,
+        double *a1cf, double *a2cf, double *a3cf,
+        double *ccf, double *fcf, double *tcf) {
+
+    // The following variables will be returned from mgsz
+    int nxc    = 0;
+    int nyc    = 0;
+    int nzc    = 0;
+    int nf     = 0;
+    int nc     = 0;
+    int narr   = 0;
+    int narrc  = 0;
+    int n_rpc  = 0;
+    int n_iz   = 0;
+    int n_ipc  = 0;
+    int iretot = 0;
+    int iintot = 0;
+
+    // Miscellaneous variables
+    int nrwk   = 0;
+    int niwk   = 0;
+    int nx     = 0;
+    int ny     = 0;
+    int nz     = 0;
+    int nlev   = 0;
+    int mxlv   = 0;
+    int mode   = 0;
+    int mgcoar = 0;
+    int mgdisc = 0;
+    int mgsolv = 0;
+    int mgfree = 0;
+    int k_iz   = 0;
+    int k_ipc  = 0;
+    int k_idx  = 0;
+    int k_rpc  = 0;
+    int k_ac   = 0;
+    int k_cc   = 0;
+    int k_fc   = 0;
+    int k_w1   = 0;
+    int k_w2   = 0;
+    int k_z    = 0;
+    int k_p    = 0;
+    int k_q    = 0;
+    int k_pc   = 0;
+
+    // Decode some parameters
+    nrwk   = VAT(iparm, 1);
+    niwk   = VAT(iparm, 2);
+    nx     = VAT(iparm, 3);
+    ny     = VAT(iparm, 4);
+    nz     = VAT(iparm, 5);
+    nlev   = VAT(iparm, 6);
+    mode   = VAT(iparm, 16);
+
+    // Perform some checks on input
+    VASSERT_MSG1(nlev > 0, "nlev must be positive: %d", nlev);
+    VASSERT_MSG1(  nx > 0, "nx must be positive: %d", nx);
+    VASSERT_MSG1(  ny > 0, "ny must be positive: %d", ny);
+    VASSERT_MSG1(  nz > 0, "nz must be positive: %d", nz);
+
+    mxlv = Vmaxlev(nx, ny, nz);
+    VASSERT_MSG2(
+        nlev <= mxlv,
+        "number of levels exceeds maximum: %d > %d",
+        nlev, mxlv
+        );
+
+    // Extract basic grid sizes, etc.
+    mgcoar = VAT(iparm, 18);
+    mgdisc = VAT(iparm, 19);
+    mgsolv = VAT(iparm, 21);
+
+    // The nonlinear kernels need the diagonal of the fine operator stored
+    mgfree = (mode == 0) ? VAT(iparm, 28) : 0;
+
+    Vmgsz(&mgcoar, &mgdisc, &mgsolv, &mgfree,
+                &nx, &ny, &nz,
+                &nlev,
+                &nxc, &nyc, &nzc,
+                &nf, &nc,
+                &narr, &narrc,
+                &n_rpc, &n_iz, &n_ipc,
+                &iretot, &iintot);
+
+    /* Linear problems need the two search direction vectors; the Newton
+     * iteration needs two more work vectors and a multilevel array for
+     * the preconditioned residual */
+    if (mode == 0) {
+        iretot = iretot + 2 * nf;
+    } else {
+        iretot = iretot + 4 * nf + narr;
+        iintot = iintot + narr + nlev;
+    }
+
+    // Perform some more checks on input
+    VASSERT_MSG1(nrwk >= iretot, "Real work space must be: %d", iretot);
+    VASSERT_MSG1(niwk >= iintot, "Integer work space must be: %d", iintot);
+
+    // Split up the integer work array
+    k_iz  = 1;
+    k_ipc = k_iz + n_iz;
+    k_idx = k_ipc + n_ipc;
+
+    // Split up the real work array
+    k_rpc = 1;
+    k_cc  = k_rpc + n_rpc;
+    k_fc  = k_cc  + narr;
+    k_w1  = k_fc  + narr;
+    k_w2  = k_w1  + nf;
+    if (mode == 0) {
+        k_pc = k_w2 + nf;
+    } else {
+        k_z  = k_w2 + nf;
+        k_p  = k_z  + narr;
+        k_q  = k_p  + nf;
+        k_pc = k_q  + nf;
+    }
+    k_ac  = k_pc  + 27 * narrc;
+
+    if (mode == 0) {
+
+        Vcgmgdriv2(iparm, rparm,
+                &nx, &ny, &nz,
+                u, RAT(iwork, k_iz),
+                RAT(rwork, k_w1), RAT(rwork, k_w2),
+                RAT(iwork, k_ipc), RAT(rwork, k_rpc),
+                RAT(rwork, k_pc), RAT(rwork, k_ac),
+                RAT(rwork, k_cc), RAT(rwork, k_fc),
+                xf, yf, zf,
+                gxcf, gycf, gzcf,
+                a1cf, a2cf, a3cf,
+                ccf, fcf, tcf);
+
+    } else {
+
+        Vnewdriv2(iparm, rparm,
+                &nx, &ny, &nz,
+                u, RAT(iwork, k_iz),
+                RAT(rwork, k_w1), RAT(rwork, k_w2),
+                RAT(rwork, k_z), RAT(rwork, k_p), RAT(rwork, k_q),
+                RAT(iwork, k_idx),
+                RAT(iwork, k_ipc), RAT(rwork, k_rpc),
+                RAT(rwork, k_pc), RAT(rwork, k_ac),
+                RAT(rwork, k_cc), RAT(rwork, k_fc),
+                xf, yf, zf,
+                gxcf, gycf, gzcf,
+                a1cf, a2cf, a3cf,
+                ccf, fcf, tcf);
+    }
+}
+
+VPUBLIC void Vcgmgdriv2(int *iparm, double *rparm,
+        int *nx, int *ny, int *nz,
+        double *u, int *iz,
+        double *p, double *q,
+        int *ipc, double *rpc,
+        double *pc, double *ac, double *cc, double *fc,
+        double *xf, double *yf, double *zf,
+        double *gxcf, double *gycf, double *gzcf,
+        double *a1cf, double *a2cf, double *a3cf,
+        double *ccf, double *fcf, double *tcf) {
+
+    int nlev      = 0;
+    int nu1       = 0;
+    int nu2       = 0;
+    int itmax     = 0;
+    int istop     = 0;
+    int iinfo     = 0;
+    int ipkey     = 0;
+    int mode      = 0;
+    int mgprol    = 0;
+    int mgcoar    = 0;
+    int mgdisc    = 0;
+    int mgsmoo    = 0;
+    int mgsolv    = 0;
+    int mgcach    = 0;
+    int mgfree    = 0;
+    int ido       = 0;
+    int iok       = 0;
+    int ilev      = 0;
+    int iters     = 0;
+    int ierror    = 0;
+    int nlev_real = 0;
+    int ibound    = 0;
+    int reuse     = 0;
+    int key[2]    = {0, 0};
+
+    double epsiln = 0.0;
+    double errtol = 0.0;
+    double omegal = 0.0;
+
+    MAT2(iz, 50, 1);
+
+    // Decode integer parameters from the iparm array
+    nlev   = VAT(iparm,  6);
+    nu1    = VAT(iparm,  7);
+    nu2    = VAT(iparm,  8);
+    itmax  = VAT(iparm, 10);
+    istop  = VAT(iparm, 11);
+    iinfo  = VAT(iparm, 12);
+    ipkey  = VAT(iparm, 14);
+    mode   = VAT(iparm, 16);
+    mgprol = VAT(iparm, 17);
+    mgcoar = VAT(iparm, 18);
+    mgdisc = VAT(iparm, 19);
+    mgsmoo = VAT(iparm, 20);
+    mgsolv = VAT(iparm, 21);
+    mgcach = VAT(iparm, 24);
+    mgfree = VAT(iparm, 28);
+
+    // The preconditioning cycle uses the same kernels as Vmgdriv2
+    if (mgfree == 1) {
+        VASSERT_MSG0((mgdisc == 0) && (mgprol == 0) && (nlev > 1)
+                && ((mgsmoo == 1) || (mgsmoo == 5)),
+                "Fine operator without diagonal needs linear red/black multigrid");
+    }
+
+    // Decode real parameters from the rparm array
+    errtol = VAT(rparm,  1);
+    omegal = VAT(rparm,  9);
+
+    Vprtstp(0, -99, 0.0, 0.0, 0.0);
+
+    // Build the multigrid data structure in iz
+    Vbuildstr(nx, ny, nz, &nlev, iz);
+
+    // Galerkin coarse operators can be reused as in Vmgdriv2
+    if (mgcach == 1 && mgcoar == 2) {
+        Vbuildkey(nx, ny, nz, &nlev, &ipkey, &mgprol, &mgdisc,
+                xf, yf, zf, a1cf, a2cf, a3cf, ccf, key);
+        reuse = (VAT(iparm, 25) == 1)
+            && (VAT(iparm, 26) == key[0]) && (VAT(iparm, 27) == key[1]);
+    }
+    VAT(iparm, 25) = 0;
+
+    // Start the timer
+    Vnm_tstart(30, "Vcgmgdrv2: fine problem setup");
+
+    // Build operator and rhs on fine grid
+    ido = 0;
+    Vbuildops(nx, ny, nz,
+            &nlev, &ipkey, &iinfo, &ido, iz,
+            &mgprol, &mgcoar, &mgsolv, &mgdisc, &mgfree,
+            ipc, rpc, pc, ac, cc, fc,
+            xf, yf, zf,
+            gxcf, gycf, gzcf,
+            a1cf, a2cf, a3cf,
+            ccf, fcf, tcf);
+
+    // Stop the timer
+    Vnm_tstop(30, "Vcgmgdrv2: fine problem setup");
+
+    // Start the timer
+    Vnm_tstart(30, "Vcgmgdrv2: coarse problem setup");
+
+    // Build operator and rhs on all coarse grids
+    ido = reuse ? 4 : 1;
+    Vbuildops(nx, ny, nz,
+            &nlev, &ipkey, &iinfo, &ido, iz,
+            &mgprol, &mgcoar, &mgsolv, &mgdisc, &mgfree,
+            ipc, rpc, pc, ac, cc, fc,
+            xf, yf, zf,
+            gxcf, gycf, gzcf,
+            a1cf, a2cf, a3cf,
+            ccf, fcf, tcf);
+
+    // Stop the timer
+    Vnm_tstop(30, "Vcgmgdrv2: coarse problem setup");
+
+    // Keep the operators unless the coarse solver had to be changed
+    if (mgcach == 1 && mgcoar == 2 && mgsolv == VAT(iparm, 21)) {
+        VAT(iparm, 25) = 1;
+        VAT(iparm, 26) = key[0];
+        VAT(iparm, 27) = key[1];
+    }
+
+    // Compute an algebraically produced rhs for the given tcf
+    if (istop == 4 || istop == 5) {
+        Vbuildalg(nx, ny, nz, &mode, &nlev, iz,
+                ipc, rpc, ac, cc, ccf, tcf, fc, fcf);
+    }
+
+    // Determine machine epsilon
+    epsiln = Vnm_epsmac();
+
+    // Impose zero dirichlet boundary conditions (now in source fcn)
+    if (VAT(iparm, 30) != 1) {
+        Vazeros(nx, ny, nz, u);
+    }
+    VfboundPMG00(nx, ny, nz, u);
+
+    // Relative residual of the initial guess; the coefficient arrays are free
+    VAT(rparm, 11) = 1.0;
+    if (VAT(iparm, 30) == 1) {
+        VAT(rparm, 11) = Vguessres(nx, ny, nz, &mode,
+                RAT(ipc, VAT2(iz, 5, 1)), RAT(rpc, VAT2(iz, 6, 1)),
+                RAT( ac, VAT2(iz, 7, 1)), RAT( cc, VAT2(iz, 1, 1)),
+                RAT( fc, VAT2(iz, 1, 1)), u, a1cf, a2cf, a3cf);
+    }
+
+    // Start the timer
+    Vnm_tstart(30, "Vcgmgdrv2: solve");
+
+    /* The coefficient arrays are the v-cycle workspace and fcf holds the
+     * preconditioned residual on all levels */
+    nlev_real = nlev;
+    iok  = 1;
+    ilev = 1;
+    Vcgmg(nx, ny, nz,
+            u, iz,
+            a1cf, a2cf, a3cf, ccf,
+            fcf, p, q,
+            &istop, &itmax, &iters, &ierror,
+            &nlev, &ilev, &nlev_real, &mgsolv,
+            &iok, &iinfo, &epsiln, &errtol, &omegal,
+            &nu1, &nu2, &mgsmoo,
+            ipc, rpc, pc, ac, cc, fc, tcf);
+
+    // Stop the timer
+    Vnm_tstop(30, "Vcgmgdrv2: solve");
+    VAT(iparm, 29) = iters;
+
+    // Restore boundary conditions
+    ibound = 1;
+    VfboundPMG(&ibound, nx, ny, nz, u, gxcf, gycf, gzcf);
+}
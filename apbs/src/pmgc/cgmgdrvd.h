@@ -0,0 +1,137 @@
+/**
+ *  @ingroup PMGC
+ *  @brief  Driver for the multigrid preconditioned conjugate gradient
+ *          solver
+ *  @version $Id:
+ *
+ *  @attention
+ *  @verbatim
+ *
+ * APBS -- Adaptive Poisson-Boltzmann Solver
+ *
+ * Nathan A. Baker (nathan.baker@pnl.gov)
+ * Pacific Northwest National Laboratory
+ *
+ * Additional contributing authors listed in the code documentation.
+ *
+ * Copyright (c) 2010-2014 Battelle Memorial Institute. Developed at the Pacific Northwest National Laboratory, operated by Battelle Memorial Institute, Pacific Northwest Division for the U.S. Department Energy.  Portions Copyright (c) 2002-2010, Washington University in St. Louis.  Portions Copyright (c) 2002-2010, Nathan A. Baker.  Portions Copyright (c) 1999-2002, The Regents of the University of California. Portions Copyright (c) 1995, Michael Holst.
+ * All rights reserved.
+ *
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * -  Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * - Neither the name of Washington University in St. Louis nor the names of its
+ * contributors may be used to endorse or promote products derived from this
+ * software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @endverbatim
+ */
+
+#ifndef _CGMGDRVD_H_
+#define _CGMGDRVD_H_
+
+#include "apbscfg.h"
+
+#include "maloc/maloc.h"
+
+#include "generic/vhal.h"
+#include "generic/vmatrix.h"
+#include "pmgc/mgsubd.h"
+#include "pmgc/mikpckd.h"
+#include "pmgc/cgmgd.h"
+#include "pmgc/mgdrvd.h"
+#include "pmgc/newdrvd.h"
+
+/** @brief   Driver for the multigrid preconditioned conjugate gradient
+ *           solver.
+ *
+ *    Takes the same arguments as Vmgdriv.  Linear problems (iparm(16) = 0)
+ *    are solved with Vcgmg; for nonlinear problems the Newton correction
+ *    equations of Vnewdriv2 are solved with Vcgmg in place of v-cycles.
+ *    Beyond the Vmgdriv workspace, rwork holds two fine grid vectors for
+ *    linear problems, and four fine grid vectors and a multilevel array
+ *    for nonlinear ones.  The linear solver uses fcf as workspace once
+ *    the operators are built, so it must not alias the caller's data.
+ *
+ *  @ingroup PMGC
+ */
+VEXTERNC void Vcgmgdriv(
+        int    *iparm,
+        double *rparm,
+        int    *iwork,
+        double *rwork,
+        double *u,
+        double *xf,
+        double *yf,
+        double *zf,
+        double *gxcf,
+        double *gycf,
+        double *gzcf,
+        double *a1cf,
+        double *a2cf,
+        double *a3cf,
+        double *ccf,
+        double *fcf,
+        double *tcf
+        );
+
+/** @brief   Solves a linear problem with the multigrid preconditioned
+ *           conjugate gradient method.
+ *
+ *    Builds the operators as Vmgdriv2 does (reusing the cached Galerkin
+ *    operators if iparm(24) asks for it) and calls Vcgmg with p and q as
+ *    the search direction vectors.
+ *
+ *  @ingroup PMGC
+ */
+VEXTERNC void Vcgmgdriv2(
+        int    *iparm,
+        double *rparm,
+        int    *nx,
+        int    *ny,
+        int    *nz,
+        double *u,
+        int    *iz,
+        double *p,
+        double *q,
+        int    *ipc,
+        double *rpc,
+        double *pc,
+        double *ac,
+        double *cc,
+        double *fc,
+        double *xf,
+        double *yf,
+        double *zf,
+        double *gxcf,
+        double *gycf,
+        double *gzcf,
+        double *a1cf,
+        double *a2cf,
+        double *a3cf,
+        double *ccf,
+        double *fcf,
+        double *tcf
+        );
+
+#endif /* _CGMGDRVD_H_ */
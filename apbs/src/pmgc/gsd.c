@@ -63,7 +63,14 @@ VPUBLIC void Vgsrb(int *nx, int *ny, int *nz,
 
     // Do in one step ***
     numdia = VAT(ipc, 11);
-    if (numdia == 7) {
+    if (numdia == 7 && VAT(ipc, 13) == 1) {
+        Vgsrb7xmf(nx, ny, nz,
+                ipc, rpc,
+                cc, fc,
+                RAT2(ac, 1,1), RAT2(ac, 1,2), RAT2(ac, 1,3),
+                x, w1, w2, r,
+                itmax, iters, errtol, omega, iresid, iadjoint);
+    } else if (numdia == 7) {
         Vgsrb7x(nx, ny, nz,
                 ipc, rpc,
                 RAT2(ac, 1,1), cc, fc,
@@ -159,6 +166,265 @@ VPUBLIC void Vgsrb7x(int *nx,int *ny,int *nz,
 
 
 
+VPUBLIC void Vgsrb7xmf(int *nx,int *ny,int *nz,
+        int *ipc, double *rpc,
+        double *cc, double *fc,
+        double *oE, double *oN, double *uC,
+        double *x, double *w1, double *w2, double *r,
+        int *itmax, int *iters,
+        double *errtol, double *omega,
+        int *iresid, int *iadjoint) {
+
+    int i, j, k, ioff, color;
+
+    MAT3(cc, *nx, *ny, *nz);
+    MAT3(fc, *nx, *ny, *nz);
+    MAT3( x, *nx, *ny, *nz);
+
+    MAT3(oE, *nx, *ny, *nz);
+    MAT3(oN, *nx, *ny, *nz);
+    MAT3(uC, *nx, *ny, *nz);
+
+    for (*iters=1; *iters<=*itmax; (*iters)++) {
+
+        // Red points, then black ones; the diagonal is formed from the faces
+        for (color=0; color<2; color++) {
+            #pragma omp parallel for private(i, j, k, ioff)
+            for (k=2; k<=*nz-1; k++) {
+                for (j=2; j<=*ny-1; j++) {
+                    ioff = ((j + k) % 2 + *iadjoint + color) % 2;
+                    for (i=2+ioff; i<=*nx-1; i+=2) {
+                        VAT3(x, i, j, k) = (
+                                VAT3(fc,   i,  j,  k)
+                             +  VAT3(oN,   i,   j,   k) * VAT3(x,   i, j+1,   k)
+                             +  VAT3(oN,   i, j-1,   k) * VAT3(x,   i, j-1,   k)
+                             +  VAT3(oE,   i,   j,   k) * VAT3(x, i+1,   j,   k)
+                             +  VAT3(oE, i-1,   j,   k) * VAT3(x, i-1,   j,   k)
+                             + VAT3( uC,   i,   j, k-1) * VAT3(x,   i,   j, k-1)
+                             + VAT3( uC,   i,   j,   k) * VAT3(x,   i,   j, k+1)
+                             ) / (VAT3(oE, i, j, k) + VAT3(oE, i-1, j, k)
+                               + VAT3(oN, i, j, k) + VAT3(oN, i, j-1, k)
+                               + VAT3(uC, i, j, k) + VAT3(uC, i, j, k-1)
+                               + VAT3(cc, i, j, k));
+                    }
+                }
+            }
+        }
+    }
+
+    if (*iresid == 1)
+        Vmresid7_1smf(nx, ny, nz, ipc, rpc, cc, fc, oE, oN, uC, x, r);
+}
+
+
+
+VPUBLIC void Vgsrbtb(int *nx, int *ny, int *nz,
+        int *ipc, double *rpc,
+        double *ac, double *cc, double *fc,
+        double *x, double *w1, double *w2, double *r,
+        int *itmax, int *iters,
+        double *errtol, double *omega,
+        int *iresid, int *iadjoint) {
+
+    int numdia;
+
+    MAT2(ac, *nx * *ny * *nz, 1);
+
+    // Only the 7-point operator has a pipelined kernel
+    numdia = VAT(ipc, 11);
+    if (numdia == 7 && VAT(ipc, 13) == 1) {
+        Vgsrb7xtbmf(nx, ny, nz,
+                    ipc, rpc,
+                    cc, fc,
+                    RAT2(ac, 1,1), RAT2(ac, 1,2), RAT2(ac, 1,3),
+                    x, w1, w2, r,
+                    itmax, iters, errtol, omega, iresid, iadjoint);
+    } else if (numdia == 7) {
+        Vgsrb7xtb(nx, ny, nz,
+                  ipc, rpc,
+                  RAT2(ac, 1,1), cc, fc,
+                  RAT2(ac, 1,2), RAT2(ac, 1,3), RAT2(ac, 1,4),
+                  x, w1, w2, r,
+                  itmax, iters, errtol, omega, iresid, iadjoint);
+    } else {
+        Vgsrb(nx, ny, nz,
+              ipc, rpc,
+              ac, cc, fc,
+              x, w1, w2, r,
+              itmax, iters, errtol, omega, iresid, iadjoint);
+    }
+}
+
+
+
+VPUBLIC void Vgsrb7xtb(int *nx,int *ny,int *nz,
+        int *ipc, double *rpc,
+        double *oC, double *cc, double *fc,
+        double *oE, double *oN, double *uC,
+        double *x, double *w1, double *w2, double *r,
+        int *itmax, int *iters,
+        double *errtol, double *omega,
+        int *iresid, int *iadjoint) {
+
+    int i, j, k, ioff;
+    int kk, kend, stage, nsweep, nstage;
+
+    MAT3(cc, *nx, *ny, *nz);
+    MAT3(fc, *nx, *ny, *nz);
+    MAT3( x, *nx, *ny, *nz);
+    MAT3(w1, *nx, *ny, *nz);
+    MAT3(w2, *nx, *ny, *nz);
+    MAT3( r, *nx, *ny, *nz);
+
+    MAT3(oE, *nx, *ny, *nz);
+    MAT3(oN, *nx, *ny, *nz);
+    MAT3(uC, *nx, *ny, *nz);
+    MAT3(oC, *nx, *ny, *nz);
+
+    /* Each red or black half-sweep is a pipeline stage, followed by the
+     * residual if requested.  Stage s works on plane kk-s, so a stage only
+     * reads planes that the previous stage has already finished and the
+     * next stage has not yet touched.  All stages therefore see exactly
+     * the values of the plain sweeps in Vgsrb7x and Vmresid7_1s, and the
+     * 2*itmax+2 planes in flight stay in cache between stages. */
+    nsweep = 2 * *itmax;
+    nstage = nsweep + ((*iresid == 1) ? 1 : 0);
+    kend = *nz - 1 + nstage - 1;
+
+    #pragma omp parallel private(i, j, k, ioff, kk, stage)
+    for (kk=2; kk<=kend; kk++) {
+        for (stage=0; stage<nstage; stage++) {
+
+            k = kk - stage;
+            if ((k < 2) || (k > *nz-1)) continue;
+
+            if (stage < nsweep) {
+
+                // Red points on even stages, black on odd ones
+                #pragma omp for
+                for (j=2; j<=*ny-1; j++) {
+                    ioff = ((j + k) % 2 + *iadjoint + stage) % 2;
+                    for (i=2+ioff; i<=*nx-1; i+=2) {
+                        VAT3(x, i, j, k) = (
+                                VAT3(fc,   i,  j,  k)
+                             +  VAT3(oN,   i,   j,   k) * VAT3(x,   i, j+1,   k)
+                             +  VAT3(oN,   i, j-1,   k) * VAT3(x,   i, j-1,   k)
+                             +  VAT3(oE,   i,   j,   k) * VAT3(x, i+1,   j,   k)
+                             +  VAT3(oE, i-1,   j,   k) * VAT3(x, i-1,   j,   k)
+                             + VAT3( uC,   i,   j, k-1) * VAT3(x,   i,   j, k-1)
+                             + VAT3( uC,   i,   j,   k) * VAT3(x,   i,   j, k+1)
+                             ) / (VAT3(oC, i, j, k) + VAT3(cc, i, j, k));
+                    }
+                }
+
+            } else {
+
+                // Closing residual on a plane whose neighbours are final
+                #pragma omp for
+                for (j=2; j<=*ny-1; j++) {
+                    for (i=2; i<=*nx-1; i++) {
+                        VAT3(r, i,j,k) =  VAT3(fc,   i,   j,   k)
+                                 + VAT3( oN,   i,   j,   k)                * VAT3(x,   i, j+1,   k)
+                                 + VAT3( oN,   i, j-1,   k)                * VAT3(x,   i, j-1,   k)
+                                 + VAT3( oE,   i,   j,   k)                * VAT3(x, i+1,   j,   k)
+                                 + VAT3( oE, i-1,   j,   k)                * VAT3(x, i-1,   j,   k)
+                                 + VAT3( uC,   i,   j, k-1)                * VAT3(x,   i,   j, k-1)
+                                 + VAT3( uC,   i,   j,   k)                * VAT3(x,   i,   j, k+1)
+                                 - (VAT3(oC,   i,   j,   k) + VAT3(cc, i, j, k)) * VAT3(x,   i,   j,   k);
+                    }
+                }
+            }
+        }
+    }
+
+    *iters = *itmax + 1;
+}
+
+
+
+VPUBLIC void Vgsrb7xtbmf(int *nx,int *ny,int *nz,
+        int *ipc, double *rpc,
+        double *cc, double *fc,
+        double *oE, double *oN, double *uC,
+        double *x, double *w1, double *w2, double *r,
+        int *itmax, int *iters,
+        double *errtol, double *omega,
+        int *iresid, int *iadjoint) {
+
+    int i, j, k, ioff;
+    int kk, kend, stage, nsweep, nstage;
+
+    MAT3(cc, *nx, *ny, *nz);
+    MAT3(fc, *nx, *ny, *nz);
+    MAT3( x, *nx, *ny, *nz);
+    MAT3( r, *nx, *ny, *nz);
+
+    MAT3(oE, *nx, *ny, *nz);
+    MAT3(oN, *nx, *ny, *nz);
+    MAT3(uC, *nx, *ny, *nz);
+
+    // The pipeline of Vgsrb7xtb, with the diagonal formed from the faces
+    nsweep = 2 * *itmax;
+    nstage = nsweep + ((*iresid == 1) ? 1 : 0);
+    kend = *nz - 1 + nstage - 1;
+
+    #pragma omp parallel private(i, j, k, ioff, kk, stage)
+    for (kk=2; kk<=kend; kk++) {
+        for (stage=0; stage<nstage; stage++) {
+
+            k = kk - stage;
+            if ((k < 2) || (k > *nz-1)) continue;
+
+            if (stage < nsweep) {
+
+                // Red points on even stages, black on odd ones
+                #pragma omp for
+                for (j=2; j<=*ny-1; j++) {
+                    ioff = ((j + k) % 2 + *iadjoint + stage) % 2;
+                    for (i=2+ioff; i<=*nx-1; i+=2) {
+                        VAT3(x, i, j, k) = (
+                                VAT3(fc,   i,  j,  k)
+                             +  VAT3(oN,   i,   j,   k) * VAT3(x,   i, j+1,   k)
+                             +  VAT3(oN,   i, j-1,   k) * VAT3(x,   i, j-1,   k)
+                             +  VAT3(oE,   i,   j,   k) * VAT3(x, i+1,   j,   k)
+                             +  VAT3(oE, i-1,   j,   k) * VAT3(x, i-1,   j,   k)
+                             + VAT3( uC,   i,   j, k-1) * VAT3(x,   i,   j, k-1)
+                             + VAT3( uC,   i,   j,   k) * VAT3(x,   i,   j, k+1)
+                             ) / (VAT3(oE, i, j, k) + VAT3(oE, i-1, j, k)
+                               + VAT3(oN, i, j, k) + VAT3(oN, i, j-1, k)
+                               + VAT3(uC, i, j, k) + VAT3(uC, i, j, k-1)
+                               + VAT3(cc, i, j, k));
+                    }
+                }
+
+            } else {
+
+                // Closing residual on a plane whose neighbours are final
+                #pragma omp for
+                for (j=2; j<=*ny-1; j++) {
+                    for (i=2; i<=*nx-1; i++) {
+                        VAT3(r, i,j,k) =  VAT3(fc,   i,   j,   k)
+                                 + VAT3( oN,   i,   j,   k)                * VAT3(x,   i, j+1,   k)
+                                 + VAT3( oN,   i, j-1,   k)                * VAT3(x,   i, j-1,   k)
+                                 + VAT3( oE,   i,   j,   k)                * VAT3(x, i+1,   j,   k)
+                                 + VAT3( oE, i-1,   j,   k)                * VAT3(x, i-1,   j,   k)
+                                 + VAT3( uC,   i,   j, k-1)                * VAT3(x,   i,   j, k-1)
+                                 + VAT3( uC,   i,   j,   k)                * VAT3(x,   i,   j, k+1)
+                                 - (VAT3(oE, i, j, k) + VAT3(oE, i-1, j, k)
+                                  + VAT3(oN, i, j, k) + VAT3(oN, i, j-1, k)
+                                  + VAT3(uC, i, j, k) + VAT3(uC, i, j, k-1)
+                                  + VAT3(cc, i, j, k)) * VAT3(x,   i,   j,   k);
+                    }
+                }
+            }
+        }
+    }
+
+    *iters = *itmax + 1;
+}
+
+
+
 VPUBLIC void Vgsrb27x(int *nx,int *ny,int *nz,
         int *ipc, double *rpc,
         double  *oC, double  *cc, double  *fc,
@@ -172,9 +438,13 @@ VPUBLIC void Vgsrb27x(int *nx,int *ny,int *nz,
 
     int  i,  j,  k;
     int i1, j1, k1;
-    int i2, j2, k2;
-    int ioff;
-    int istep;
+    int ic, icolor;
+
+    /* Parity offsets of the eight colors, red (i+j+k even) first */
+    static const int color[8][3] = {
+        {0, 0, 0}, {1, 1, 0}, {1, 0, 1}, {0, 1, 1},
+        {1, 0, 0}, {0, 1, 0}, {0, 0, 1}, {1, 1, 1}
+    };
 
     double tmpO, tmpU, tmpD;
 
@@ -202,121 +472,65 @@ VPUBLIC void Vgsrb27x(int *nx,int *ny,int *nz,
     MAT3(uSE, *nx, *ny, *nz);
     MAT3(uSW, *nx, *ny, *nz);
 
-    // Do the gauss-seidel iteration itmax times
-
-    /*
-    i1    = (1 - *iadjoint) *   2  + (    *iadjoint) * (*nx - 1);
-    i2    = (    *iadjoint) *   2  + (1 - *iadjoint) * (*nx - 1);
-    j1    = (1 - *iadjoint) *   2  + (    *iadjoint) * (*ny - 1);
-    j2    = (    *iadjoint) *   2  + (1 - *iadjoint) * (*ny - 1);
-    k1    = (1 - *iadjoint) *   2  + (    *iadjoint) * (*nz - 1);
-    k2    = (    *iadjoint) *   2  + (1 - *iadjoint) * (*nz - 1);
-    istep = (    *iadjoint) * (-1) + (1 - *iadjoint) * (1);
-    */
-
-    i1 = (1-*iadjoint) * 2 + *iadjoint     * (*nx-1);
-    i2 = *iadjoint     * 2 + (1-*iadjoint) * (*nx-1);
-    j1 = (1-*iadjoint) * 2 + *iadjoint     * (*ny-1);
-    j2 = *iadjoint     * 2 + (1-*iadjoint) * (*ny-1);
-    k1 = (1-*iadjoint) * 2 + *iadjoint     * (*nz-1);
-    k2 = *iadjoint     * 2 + (1-*iadjoint) * (*nz-1);
-    istep = *iadjoint*(-1) + (1-*iadjoint)*(1);
-
+    /* The 27-point stencil couples each point to neighbours of the same
+     * red/black parity, so the sweep is split into eight colors by the
+     * parity of (i,j,k).  Points of one color never neighbour each other,
+     * which makes every color sweep independent of the update order: the
+     * result is identical for any number of threads.  The four red colors
+     * (i+j+k even) go first, and the adjoint sweep visits the colors in
+     * reverse. */
     for (*iters=1; *iters<=*itmax; (*iters)++) {
 
-        //#pragma omp parallel for private(i, j, k, ioff, tmpO, tmpU, tmpD)
-        for (k=2; k<=*nz-1; k++) {
-
-            for (j=2; j<=*ny-1; j++) {
-
-                ioff = (1 - *iadjoint) * (    (j + k + 2) % 2)
-                     + (    *iadjoint) * (1 - (j + k + 2) % 2);
-
-                for (i=2+ioff; i<=*nx-1; i+=2) {
-
-                    tmpO =
-                         + VAT3(  oN,   i,   j,   k) * VAT3(x,   i, j+1,   k)
-                         + VAT3(  oN,   i, j-1,   k) * VAT3(x,   i, j-1,   k)
-                         + VAT3(  oE,   i,   j,   k) * VAT3(x, i+1,   j,   k)
-                         + VAT3(  oE, i-1,   j,   k) * VAT3(x, i-1,   j,   k)
-                         + VAT3( oNE,   i,   j,   k) * VAT3(x, i+1, j+1,   k)
-                         + VAT3( oNW,   i,   j,   k) * VAT3(x, i-1, j+1,   k)
-                         + VAT3( oNW, i+1, j-1,   k) * VAT3(x, i+1, j-1,   k)
-                         + VAT3( oNE, i-1, j-1,   k) * VAT3(x, i-1, j-1,   k);
-
-                   tmpU =
-                         + VAT3(  uC,   i,   j,   k) * VAT3(x,   i,   j, k+1)
-                         + VAT3(  uN,   i,   j,   k) * VAT3(x,   i, j+1, k+1)
-                         + VAT3(  uS,   i,   j,   k) * VAT3(x,   i, j-1, k+1)
-                         + VAT3(  uE,   i,   j,   k) * VAT3(x, i+1,   j, k+1)
-                         + VAT3(  uW,   i,   j,   k) * VAT3(x, i-1,   j, k+1)
-                         + VAT3( uNE,   i,   j,   k) * VAT3(x, i+1, j+1, k+1)
-                         + VAT3( uNW,   i,   j,   k) * VAT3(x, i-1, j+1, k+1)
-                         + VAT3( uSE,   i,   j,   k) * VAT3(x, i+1, j-1, k+1)
-                         + VAT3( uSW,   i,   j,   k) * VAT3(x, i-1, j-1, k+1);
-
-                   tmpD =
-                         + VAT3(  uC,   i,   j, k-1) * VAT3(x,   i,   j, k-1)
-                         + VAT3(  uS,   i, j+1, k-1) * VAT3(x,   i, j+1, k-1)
-                         + VAT3(  uN,   i, j-1, k-1) * VAT3(x,   i, j-1, k-1)
-                         + VAT3(  uW, i+1,   j, k-1) * VAT3(x, i+1,   j, k-1)
-                         + VAT3(  uE, i-1,   j, k-1) * VAT3(x, i-1,   j, k-1)
-                         + VAT3( uSW, i+1, j+1, k-1) * VAT3(x, i+1, j+1, k-1)
-                         + VAT3( uSE, i-1, j+1, k-1) * VAT3(x, i-1, j+1, k-1)
-                         + VAT3( uNW, i+1, j-1, k-1) * VAT3(x, i+1, j-1, k-1)
-                         + VAT3( uNE, i-1, j-1, k-1) * VAT3(x, i-1, j-1, k-1);
-
-                       VAT3(x, i,j,k) = (VAT3(fc, i, j, k) + (tmpO + tmpU + tmpD))
-                                / (VAT3(oC, i, j, k) + VAT3(cc, i, j, k));
-
-                }
-            }
-        }
-
-        //#pragma omp parallel for private(i, j, k, ioff, tmpO, tmpU, tmpD)
-        for (k=2; k<=*nz-1; k++) {
-
-            for (j=2; j<=*ny-1; j++) {
-
-                ioff = (    *iadjoint) * (    (j + k + 2) % 2)
-                     + (1 - *iadjoint) * (1 - (j + k + 2) % 2);
-
-                for (i=2+ioff; i<=*nx-1; i+=2) {
-
-                    tmpO =
-                         + VAT3(  oN,   i,   j,   k) * VAT3(x,   i, j+1,   k)
-                         + VAT3(  oN,   i, j-1,   k) * VAT3(x,   i, j-1,   k)
-                         + VAT3(  oE,   i,   j,   k) * VAT3(x, i+1,   j,   k)
-                         + VAT3(  oE, i-1,   j,   k) * VAT3(x, i-1,   j,   k)
-                         + VAT3( oNE,   i,   j,   k) * VAT3(x, i+1, j+1,   k)
-                         + VAT3( oNW,   i,   j,   k) * VAT3(x, i-1, j+1,   k)
-                         + VAT3( oNW, i+1, j-1,   k) * VAT3(x, i+1, j-1,   k)
-                         + VAT3( oNE, i-1, j-1,   k) * VAT3(x, i-1, j-1,   k);
-
-                    tmpU =
-                         + VAT3(  uC,   i,   j,   k) * VAT3(x,   i,   j, k+1)
-                         + VAT3(  uN,   i,   j,   k) * VAT3(x,   i, j+1, k+1)
-                         + VAT3(  uS,   i,   j,   k) * VAT3(x,   i, j-1, k+1)
-                         + VAT3(  uE,   i,   j,   k) * VAT3(x, i+1,   j, k+1)
-                         + VAT3(  uW,   i,   j,   k) * VAT3(x, i-1,   j, k+1)
-                         + VAT3( uNE,   i,   j,   k) * VAT3(x, i+1, j+1, k+1)
-                         + VAT3( uNW,   i,   j,   k) * VAT3(x, i-1, j+1, k+1)
-                         + VAT3( uSE,   i,   j,   k) * VAT3(x, i+1, j-1, k+1)
-                         + VAT3( uSW,   i,   j,   k) * VAT3(x, i-1, j-1, k+1);
-
-                   tmpD =
-                         + VAT3(  uC,   i,   j, k-1) * VAT3(x,   i,   j, k-1)
-                         + VAT3(  uS,   i, j+1, k-1) * VAT3(x,   i, j+1, k-1)
-                         + VAT3(  uN,   i, j-1, k-1) * VAT3(x,   i, j-1, k-1)
-                         + VAT3(  uW, i+1,   j, k-1) * VAT3(x, i+1,   j, k-1)
-                         + VAT3(  uE, i-1,   j, k-1) * VAT3(x, i-1,   j, k-1)
-                         + VAT3( uSW, i+1, j+1, k-1) * VAT3(x, i+1, j+1, k-1)
-                         + VAT3( uSE, i-1, j+1, k-1) * VAT3(x, i-1, j+1, k-1)
-                         + VAT3( uNW, i+1, j-1, k-1) * VAT3(x, i+1, j-1, k-1)
-                         + VAT3( uNE, i-1, j-1, k-1) * VAT3(x, i-1, j-1, k-1);
-
-                   VAT3(x, i,j,k) = (VAT3(fc, i, j, k) + (tmpO + tmpU + tmpD))
-                            / (VAT3(oC, i, j, k) + VAT3(cc, i, j, k));
+        for (ic=0; ic<8; ic++) {
+
+            icolor = (1 - *iadjoint) * ic + (*iadjoint) * (7 - ic);
+            i1 = 2 + color[icolor][0];
+            j1 = 2 + color[icolor][1];
+            k1 = 2 + color[icolor][2];
+
+            #pragma omp parallel for collapse(2) private(i, j, k, tmpO, tmpU, tmpD)
+            for (k=k1; k<=*nz-1; k+=2) {
+
+                for (j=j1; j<=*ny-1; j+=2) {
+
+                    #pragma omp simd private(tmpO, tmpU, tmpD)
+                    for (i=i1; i<=*nx-1; i+=2) {
+
+                        tmpO =
+                             + VAT3(  oN,   i,   j,   k) * VAT3(x,   i, j+1,   k)
+                             + VAT3(  oN,   i, j-1,   k) * VAT3(x,   i, j-1,   k)
+                             + VAT3(  oE,   i,   j,   k) * VAT3(x, i+1,   j,   k)
+                             + VAT3(  oE, i-1,   j,   k) * VAT3(x, i-1,   j,   k)
+                             + VAT3( oNE,   i,   j,   k) * VAT3(x, i+1, j+1,   k)
+                             + VAT3( oNW,   i,   j,   k) * VAT3(x, i-1, j+1,   k)
+                             + VAT3( oNW, i+1, j-1,   k) * VAT3(x, i+1, j-1,   k)
+                             + VAT3( oNE, i-1, j-1,   k) * VAT3(x, i-1, j-1,   k);
+
+                        tmpU =
+                             + VAT3(  uC,   i,   j,   k) * VAT3(x,   i,   j, k+1)
+                             + VAT3(  uN,   i,   j,   k) * VAT3(x,   i, j+1, k+1)
+                             + VAT3(  uS,   i,   j,   k) * VAT3(x,   i, j-1, k+1)
+                             + VAT3(  uE,   i,   j,   k) * VAT3(x, i+1,   j, k+1)
+                             + VAT3(  uW,   i,   j,   k) * VAT3(x, i-1,   j, k+1)
+                             + VAT3( uNE,   i,   j,   k) * VAT3(x, i+1, j+1, k+1)
+                             + VAT3( uNW,   i,   j,   k) * VAT3(x, i-1, j+1, k+1)
+                             + VAT3( uSE,   i,   j,   k) * VAT3(x, i+1, j-1, k+1)
+                             + VAT3( uSW,   i,   j,   k) * VAT3(x, i-1, j-1, k+1);
+
+                        tmpD =
+                             + VAT3(  uC,   i,   j, k-1) * VAT3(x,   i,   j, k-1)
+                             + VAT3(  uS,   i, j+1, k-1) * VAT3(x,   i, j+1, k-1)
+                             + VAT3(  uN,   i, j-1, k-1) * VAT3(x,   i, j-1, k-1)
+                             + VAT3(  uW, i+1,   j, k-1) * VAT3(x, i+1,   j, k-1)
+                             + VAT3(  uE, i-1,   j, k-1) * VAT3(x, i-1,   j, k-1)
+                             + VAT3( uSW, i+1, j+1, k-1) * VAT3(x, i+1, j+1, k-1)
+                             + VAT3( uSE, i-1, j+1, k-1) * VAT3(x, i-1, j+1, k-1)
+                             + VAT3( uNW, i+1, j-1, k-1) * VAT3(x, i+1, j-1, k-1)
+                             + VAT3( uNE, i-1, j-1, k-1) * VAT3(x, i-1, j-1, k-1);
+
+                        VAT3(x, i,j,k) = (VAT3(fc, i, j, k) + (tmpO + tmpU + tmpD))
+                                 / (VAT3(oC, i, j, k) + VAT3(cc, i, j, k));
+                    }
                 }
             }
         }
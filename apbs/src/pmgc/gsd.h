@@ -108,6 +108,130 @@ VEXTERNC void Vgsrb7x(
         int    *iadjoint ///< @todo:  Doc
         );
 
+/** @brief   Red-black Gauss-Seidel sweeps for a 7-point operator stored
+ *           as its face weights.
+ *  @ingroup PMGC
+ *
+ *  @note    The face arrays also hold the weights of the faces on the
+ *           boundary, and the diagonal is formed from the six faces and cc
+ *           at each point instead of being read from memory.  The result
+ *           is bitwise identical to Vgsrb7x on the stored operator.
+ */
+VEXTERNC void Vgsrb7xmf(
+        int    *nx,      ///< Number of grid points in the x direction
+        int    *ny,      ///< Number of grid points in the y direction
+        int    *nz,      ///< Number of grid points in the z direction
+        int    *ipc,     ///< Integer parameters
+        double *rpc,     ///< Real parameters
+        double *cc,      ///< Helmholtz term
+        double *fc,      ///< Right-hand side
+        double *oE,      ///< East face weights
+        double *oN,      ///< North face weights
+        double *uC,      ///< Up face weights
+        double *x,       ///< Solution, updated in place
+        double *w1,      ///< Work array (unused)
+        double *w2,      ///< Work array (unused)
+        double *r,       ///< Residual, set if iresid is 1
+        int    *itmax,   ///< Number of red-black sweeps
+        int    *iters,   ///< Set to itmax+1 on return
+        double *errtol,  ///< Unused
+        double *omega,   ///< Unused
+        int    *iresid,  ///< 1 to return the residual in r
+        int    *iadjoint ///< 1 to sweep black points before red
+        );
+
+/** @brief   Temporally blocked red-black Gauss-Seidel smoother.
+ *  @ingroup PMGC
+ *
+ *  @note    Same interface and results as Vgsrb.  7-point operators use
+ *           the pipelined Vgsrb7xtb kernel; other stencils fall back to
+ *           Vgsrb.
+ */
+VEXTERNC void Vgsrbtb(
+        int    *nx,      ///< Number of grid points in the x direction
+        int    *ny,      ///< Number of grid points in the y direction
+        int    *nz,      ///< Number of grid points in the z direction
+        int    *ipc,     ///< Integer parameters (ipc[10] is the stencil size,
+                         ///< ipc[12] is 1 for an operator stored as its
+                         ///< face weights)
+        double *rpc,     ///< Real parameters
+        double *ac,      ///< Operator stencil coefficients
+        double *cc,      ///< Helmholtz term
+        double *fc,      ///< Right-hand side
+        double *x,       ///< Solution, updated in place
+        double *w1,      ///< Work array (unused)
+        double *w2,      ///< Work array (unused)
+        double *r,       ///< Residual, set if iresid is 1
+        int    *itmax,   ///< Number of red-black sweeps
+        int    *iters,   ///< Set to itmax+1 on return
+        double *errtol,  ///< Unused
+        double *omega,   ///< Unused
+        int    *iresid,  ///< 1 to return the residual in r
+        int    *iadjoint ///< 1 to sweep black points before red
+        );
+
+/** @brief   Pipelined red-black Gauss-Seidel sweeps for 7-point operators.
+ *  @ingroup PMGC
+ *
+ *  @note    All itmax sweeps and the optional closing residual are
+ *           applied in a single wavefront over z-planes, so each plane of
+ *           coefficients is read from memory once per call instead of
+ *           once per half-sweep.  The result is bitwise identical to
+ *           Vgsrb7x followed by Vmresid7_1s.
+ */
+VEXTERNC void Vgsrb7xtb(
+        int    *nx,      ///< Number of grid points in the x direction
+        int    *ny,      ///< Number of grid points in the y direction
+        int    *nz,      ///< Number of grid points in the z direction
+        int    *ipc,     ///< Integer parameters
+        double *rpc,     ///< Real parameters
+        double *oC,      ///< Diagonal stencil coefficients
+        double *cc,      ///< Helmholtz term
+        double *fc,      ///< Right-hand side
+        double *oE,      ///< East stencil coefficients
+        double *oN,      ///< North stencil coefficients
+        double *uC,      ///< Up stencil coefficients
+        double *x,       ///< Solution, updated in place
+        double *w1,      ///< Work array (unused)
+        double *w2,      ///< Work array (unused)
+        double *r,       ///< Residual, set if iresid is 1
+        int    *itmax,   ///< Number of red-black sweeps
+        int    *iters,   ///< Set to itmax+1 on return
+        double *errtol,  ///< Unused
+        double *omega,   ///< Unused
+        int    *iresid,  ///< 1 to return the residual in r
+        int    *iadjoint ///< 1 to sweep black points before red
+        );
+
+/** @brief   Pipelined red-black Gauss-Seidel sweeps for a 7-point
+ *           operator stored as its face weights.
+ *  @ingroup PMGC
+ *
+ *  @note    Vgsrb7xtb with the diagonal formed as in Vgsrb7xmf.
+ */
+VEXTERNC void Vgsrb7xtbmf(
+        int    *nx,      ///< Number of grid points in the x direction
+        int    *ny,      ///< Number of grid points in the y direction
+        int    *nz,      ///< Number of grid points in the z direction
+        int    *ipc,     ///< Integer parameters
+        double *rpc,     ///< Real parameters
+        double *cc,      ///< Helmholtz term
+        double *fc,      ///< Right-hand side
+        double *oE,      ///< East face weights
+        double *oN,      ///< North face weights
+        double *uC,      ///< Up face weights
+        double *x,       ///< Solution, updated in place
+        double *w1,      ///< Work array (unused)
+        double *w2,      ///< Work array (unused)
+        double *r,       ///< Residual, set if iresid is 1
+        int    *itmax,   ///< Number of red-black sweeps
+        int    *iters,   ///< Set to itmax+1 on return
+        double *errtol,  ///< Unused
+        double *omega,   ///< Unused
+        int    *iresid,  ///< 1 to return the residual in r
+        int    *iadjoint ///< 1 to sweep black points before red
+        );
+
 VEXTERNC void Vgsrb27x(
         int *nx,        ///< @todo:  Doc
         int *ny,        ///< @todo:  Doc
@@ -81,6 +81,15 @@ VPUBLIC void Vmatvec7(int *nx, int *ny, int *nz,
 
     MAT2(ac, *nx * *ny * *nz, 1);
 
+    // A fine operator may keep only its face weights
+    if (VAT(ipc, 13) == 1) {
+        Vmatvec7_1smf(nx, ny, nz,
+                ipc, rpc, cc,
+                RAT2(ac, 1, 1), RAT2(ac, 1, 2), RAT2(ac, 1, 3),
+                x, y);
+        return;
+    }
+
     Vmatvec7_1s(nx, ny, nz,
                 ipc,     rpc,
             RAT2(ac, 1, 1),      cc,
@@ -126,6 +135,44 @@ VEXTERNC void Vmatvec7_1s(int *nx, int *ny, int *nz,
 
 
 
+VPUBLIC void Vmatvec7_1smf(int *nx, int *ny, int *nz,
+        int *ipc, double *rpc,
+        double *cc,
+        double *oE, double *oN, double *uC,
+        double  *x, double  *y) {
+
+    int i, j, k;
+
+    MAT3(oE, *nx, *ny, *nz);
+    MAT3(oN, *nx, *ny, *nz);
+    MAT3(uC, *nx, *ny, *nz);
+    MAT3(cc, *nx, *ny, *nz);
+    MAT3(x, *nx, *ny, *nz);
+    MAT3(y, *nx, *ny, *nz);
+
+    // The diagonal is the sum of the six face weights, as in VbuildA_fv
+    #pragma omp parallel for private(i, j, k)
+    for (k=2; k<=*nz-1; k++) {
+        for (j=2; j<=*ny-1; j++) {
+            for(i=2; i<=*nx-1; i++) {
+                VAT3(y, i, j, k) =
+                           - VAT3( oN,   i,   j,   k)                * VAT3(x,   i, j+1,  k)
+                           - VAT3( oN,   i, j-1,   k)                * VAT3(x,   i, j-1,  k)
+                           - VAT3( oE,   i,   j,   k)                * VAT3(x, i+1,   j,  k)
+                           - VAT3( oE, i-1,   j,   k)                * VAT3(x, i-1,   j,  k)
+                           - VAT3( uC,   i,   j, k-1)                * VAT3(x,   i,   j,k-1)
+                           - VAT3( uC,   i,   j,   k)                * VAT3(x,   i,   j,k+1)
+                           + (VAT3(oE, i, j, k) + VAT3(oE, i-1, j, k)
+                            + VAT3(oN, i, j, k) + VAT3(oN, i, j-1, k)
+                            + VAT3(uC, i, j, k) + VAT3(uC, i, j, k-1)
+                            + VAT3(cc, i, j, k)) * VAT3(x,   i,   j,  k);
+            }
+        }
+    }
+}
+
+
+
 VPUBLIC void Vmatvec27(int *nx, int *ny, int *nz,
         int    *ipc, double *rpc,
         double  *ac, double  *cc,
@@ -275,7 +322,6 @@ VPUBLIC void Vnmatvecd7_1s(int *nx, int *ny, int *nz,
         double   *x, double   *y, double *w1) {
 
     int i, j, k;
-    int ipkey;
 
     MAT3(oE, *nx, *ny, *nz);
     MAT3(oN, *nx, *ny, *nz);
@@ -289,8 +335,7 @@ VPUBLIC void Vnmatvecd7_1s(int *nx, int *ny, int *nz,
     WARN_UNTESTED;
 
     // first get vector nonlinear term to avoid subroutine calls
-    ipkey = VAT(ipc, 10);
-    Vc_vec(cc, x, w1, nx, ny, nz, &ipkey);
+    Vc_vecjac(nx, ny, nz, ipc, cc, x, w1, VNULL);
 
     // The operator
     #pragma omp parallel for private(i, j, k)
@@ -341,7 +386,6 @@ VPUBLIC void Vnmatvecd27_1s(int *nx, int *ny, int *nz,
         double *x, double *y, double *w1) {
 
     int i, j, k;
-    int ipkey;
 
     double tmpO, tmpU, tmpD;
 
@@ -367,8 +411,7 @@ VPUBLIC void Vnmatvecd27_1s(int *nx, int *ny, int *nz,
     WARN_UNTESTED;
 
     // First get vector noNlinear term to avoid subroutine calls
-    ipkey = VAT(ipc, 10);
-    Vc_vec(cc, x, w1, nx, ny, nz, &ipkey);
+    Vc_vecjac(nx, ny, nz, ipc, cc, x, w1, VNULL);
 
     // The operator
     #pragma omp parallel for private(i, j, k, tmpO, tmpU, tmpD)
@@ -445,6 +488,15 @@ VPUBLIC void Vmresid7(int *nx, int *ny, int *nz,
 
     MAT2(ac, *nx * *ny * *nz, 1);
 
+    // A fine operator may keep only its face weights
+    if (VAT(ipc, 13) == 1) {
+        Vmresid7_1smf(nx, ny, nz,
+                ipc, rpc, cc, fc,
+                RAT2(ac, 1,1), RAT2(ac, 1,2), RAT2(ac, 1,3),
+                x, r);
+        return;
+    }
+
     // Do in one step
     Vmresid7_1s(nx, ny, nz,
             ipc, rpc,
@@ -490,6 +542,45 @@ VPUBLIC void Vmresid7_1s(int *nx, int *ny, int *nz,
 
 
 
+VPUBLIC void Vmresid7_1smf(int *nx, int *ny, int *nz,
+        int *ipc, double *rpc,
+        double *cc, double *fc,
+        double *oE, double *oN, double *uC,
+        double *x, double *r) {
+
+    int i, j, k;
+
+    MAT3(oE, *nx, *ny, *nz);
+    MAT3(oN, *nx, *ny, *nz);
+    MAT3(uC, *nx, *ny, *nz);
+    MAT3(cc, *nx, *ny, *nz);
+    MAT3(fc, *nx, *ny, *nz);
+    MAT3(x, *nx, *ny, *nz);
+    MAT3(r, *nx, *ny, *nz);
+
+    // The diagonal is the sum of the six face weights, as in VbuildA_fv
+    #pragma omp parallel for private(i, j, k)
+    for (k=2; k<=*nz-1; k++) {
+        for (j=2; j<=*ny-1; j++) {
+            for(i=2; i<=*nx-1; i++) {
+                VAT3(r, i,j,k) =  VAT3(fc,   i,   j,   k)
+                         + VAT3( oN,   i,   j,   k)                * VAT3(x,   i, j+1,   k)
+                         + VAT3( oN,   i, j-1,   k)                * VAT3(x,   i, j-1,   k)
+                         + VAT3( oE,   i,   j,   k)                * VAT3(x, i+1,   j,   k)
+                         + VAT3( oE, i-1,   j,   k)                * VAT3(x, i-1,   j,   k)
+                         + VAT3( uC,   i,   j, k-1)                * VAT3(x,   i,   j, k-1)
+                         + VAT3( uC,   i,   j,   k)                * VAT3(x,   i,   j, k+1)
+                         - (VAT3(oE, i, j, k) + VAT3(oE, i-1, j, k)
+                          + VAT3(oN, i, j, k) + VAT3(oN, i, j-1, k)
+                          + VAT3(uC, i, j, k) + VAT3(uC, i, j, k-1)
+                          + VAT3(cc, i, j, k)) * VAT3(x,   i,   j,   k);
+            }
+        }
+    }
+}
+
+
+
 VPUBLIC void Vmresid27(int *nx, int *ny, int *nz,
         int *ipc, double *rpc,
         double *ac, double *cc, double *fc,
@@ -595,14 +686,24 @@ VPUBLIC void Vnmresid(int *nx, int *ny, int *nz,
         double *ac, double *cc, double *fc,
         double *x, double *r, double *w1) {
 
+    Vnmresidjac(nx, ny, nz, ipc, rpc, ac, cc, fc, x, r, w1, VNULL);
+}
+
+
+
+VPUBLIC void Vnmresidjac(int *nx, int *ny, int *nz,
+        int *ipc, double *rpc,
+        double *ac, double *cc, double *fc,
+        double *x, double *r, double *w1, double *dc) {
+
     int numdia;
 
     // Do in oNe step ***
     numdia = VAT(ipc, 11);
     if (numdia == 7) {
-        Vnmresid7(nx, ny, nz, ipc, rpc, ac, cc, fc, x, r, w1);
+        Vnmresid7(nx, ny, nz, ipc, rpc, ac, cc, fc, x, r, w1, dc);
     } else if (numdia == 27) {
-        Vnmresid27(nx, ny, nz, ipc, rpc, ac, cc, fc, x, r, w1);
+        Vnmresid27(nx, ny, nz, ipc, rpc, ac, cc, fc, x, r, w1, dc);
     } else {
         Vnm_print(2, "Vnmresid: invalid stencil type given...\n");
     }
@@ -613,7 +714,7 @@ VPUBLIC void Vnmresid(int *nx, int *ny, int *nz,
 VPUBLIC void Vnmresid7(int *nx, int *ny, int *nz,
         int *ipc, double *rpc,
         double *ac, double *cc, double *fc,
-        double *x, double *r, double *w1) {
+        double *x, double *r, double *w1, double *dc) {
 
     MAT2(ac, *nx * *ny * *nz, 1);
 
@@ -622,17 +723,16 @@ VPUBLIC void Vnmresid7(int *nx, int *ny, int *nz,
             ipc, rpc,
             RAT2(ac, 1, 1), cc, fc,
             RAT2(ac, 1, 2), RAT2(ac, 1, 3), RAT2(ac, 1, 4),
-            x, r, w1);
+            x, r, w1, dc);
 }
 
 VPUBLIC void Vnmresid7_1s(int *nx, int *ny, int *nz,
         int *ipc, double *rpc,
         double *oC, double *cc, double *fc,
         double *oE, double *oN, double *uC,
-        double *x, double *r, double *w1) {
+        double *x, double *r, double *w1, double *dc) {
 
     int i, j, k;
-    int ipkey;
 
     MAT3(oE, *nx, *ny, *nz);
     MAT3(oN, *nx, *ny, *nz);
@@ -645,10 +745,10 @@ VPUBLIC void Vnmresid7_1s(int *nx, int *ny, int *nz,
     MAT3(w1, *nx, *ny, *nz);
 
     // First get vector nonlinear term to avoid subroutine calls
-    ipkey = VAT(ipc, 10);
-    Vc_vec(cc, x, w1, nx, ny, nz, &ipkey);
+    Vc_vecjac(nx, ny, nz, ipc, cc, x, w1, dc);
 
     // The residual
+    #pragma omp parallel for private(i, j, k)
     for (k=2; k<=*nz-1; k++) {
         for (j=2; j<=*ny-1; j++) {
             for (i=2; i<=*nx-1; i++) {
@@ -671,7 +771,7 @@ VPUBLIC void Vnmresid7_1s(int *nx, int *ny, int *nz,
 VPUBLIC void Vnmresid27(int *nx, int *ny, int *nz,
         int *ipc, double *rpc,
         double *ac, double *cc, double *fc,
-        double *x, double *r, double *w1) {
+        double *x, double *r, double *w1, double *dc) {
 
     MAT2(ac, *nx * *ny * *nz, 1);
 
@@ -683,7 +783,7 @@ VPUBLIC void Vnmresid27(int *nx, int *ny, int *nz,
             RAT2(ac, 1,  5), RAT2(ac, 1,  6),
             RAT2(ac, 1,  7), RAT2(ac, 1,  8), RAT2(ac, 1,  9), RAT2(ac, 1, 10),
             RAT2(ac, 1, 11), RAT2(ac, 1, 12), RAT2(ac, 1, 13), RAT2(ac, 1, 14),
-            x, r, w1);
+            x, r, w1, dc);
 }
 
 
@@ -695,10 +795,9 @@ VPUBLIC void Vnmresid27_1s(int *nx, int *ny, int *nz,
         double *oNE, double *oNW,
         double *uE, double *uW, double *uN, double *uS,
         double *uNE, double *uNW, double *uSE, double *uSW,
-        double *x, double *r, double *w1) {
+        double *x, double *r, double *w1, double *dc) {
 
     int i, j, k;
-    int ipkey;
     double tmpO, tmpU, tmpD;
 
     MAT3( oC, *nx, *ny, *nz);
@@ -722,10 +821,10 @@ VPUBLIC void Vnmresid27_1s(int *nx, int *ny, int *nz,
     MAT3( w1, *nx, *ny, *nz);
 
     // First get vector noNlinear term to avoid subroutine calls
-    ipkey = VAT(ipc, 10);
-    Vc_vec(cc, x, w1, nx, ny, nz, &ipkey);
+    Vc_vecjac(nx, ny, nz, ipc, cc, x, w1, dc);
 
     // The residual
+    #pragma omp parallel for private(i, j, k, tmpO, tmpU, tmpD)
     for (k=2; k<=*nz-1; k++) {
         for (j=2; j<=*ny-1; j++) {
             for (i=2; i<=*nx-1; i++) {
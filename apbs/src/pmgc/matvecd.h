@@ -102,6 +102,25 @@ VEXTERNC void Vmatvec7_1s(
         double *y    ///< @todo:  Doc
         );
 
+/** @brief   Matrix-vector product with a 7-point operator stored as its
+ *           face weights.
+ *  @ingroup PMGC
+ *  @note    See Vmresid7_1smf.
+ */
+VEXTERNC void Vmatvec7_1smf(
+        int    *nx,  ///< Number of grid points in the x direction
+        int    *ny,  ///< Number of grid points in the y direction
+        int    *nz,  ///< Number of grid points in the z direction
+        int    *ipc, ///< Integer parameters
+        double *rpc, ///< Real parameters
+        double *cc,  ///< Helmholtz term
+        double *oE,  ///< East face weights
+        double *oN,  ///< North face weights
+        double *uC,  ///< Up face weights
+        double *x,   ///< Vector to multiply
+        double *y    ///< Product
+        );
+
 
 
 VEXTERNC void Vmatvec27(
@@ -280,6 +299,28 @@ VEXTERNC void Vmresid7_1s(
         double *r    ///< @todo:  Doc
         );
 
+/** @brief   Residual of a 7-point operator stored as its face weights.
+ *  @ingroup PMGC
+ *  @note    The face arrays also hold the weights of the faces on the
+ *           boundary, and the diagonal is formed from them and cc on the
+ *           fly, so it is never read from memory.  The result is bitwise
+ *           identical to Vmresid7_1s on the stored operator.
+ */
+VEXTERNC void Vmresid7_1smf(
+        int *nx,     ///< Number of grid points in the x direction
+        int *ny,     ///< Number of grid points in the y direction
+        int *nz,     ///< Number of grid points in the z direction
+        int *ipc,    ///< Integer parameters
+        double *rpc, ///< Real parameters
+        double *cc,  ///< Helmholtz term
+        double *fc,  ///< Right-hand side
+        double *oE,  ///< East face weights
+        double *oN,  ///< North face weights
+        double *uC,  ///< Up face weights
+        double *x,   ///< Solution
+        double *r    ///< Residual
+        );
+
 VEXTERNC void Vmresid27(
         int    *nx,  ///< @todo:  Doc
         int    *ny,  ///< @todo:  Doc
@@ -342,6 +383,25 @@ VEXTERNC void Vnmresid(
         double *w1   ///< @todo:  Doc
         );
 
+/** @brief   Compute the nonlinear residual as Vnmresid, and the derivative
+ *           of the nonlinear term at x in the same pass over the grid
+ *  @ingroup PMGC
+ */
+VEXTERNC void Vnmresidjac(
+        int    *nx,  ///< Grid x dimension
+        int    *ny,  ///< Grid y dimension
+        int    *nz,  ///< Grid z dimension
+        int    *ipc, ///< Integer info of the operator
+        double *rpc, ///< Real info of the operator
+        double *ac,  ///< The operator
+        double *cc,  ///< Coefficient of the nonlinear term
+        double *fc,  ///< Source function
+        double *x,   ///< Current solution
+        double *r,   ///< The residual
+        double *w1,  ///< Work array; holds the nonlinear term on return
+        double *dc   ///< Derivative of the nonlinear term, or VNULL
+        );
+
 VEXTERNC void Vnmresid7(
         int *nx,     ///< @todo:  Doc
         int *ny,     ///< @todo:  Doc
@@ -353,7 +413,8 @@ VEXTERNC void Vnmresid7(
         double *fc,  ///< @todo:  Doc
         double *x,   ///< @todo:  Doc
         double *r,   ///< @todo:  Doc
-        double *w1   ///< @todo:  Doc
+        double *w1,  ///< @todo:  Doc
+        double *dc   ///< Derivative of the nonlinear term, or VNULL
         );
 
 VEXTERNC void Vnmresid7_1s(
@@ -370,7 +431,8 @@ VEXTERNC void Vnmresid7_1s(
         double *uC,  ///< @todo:  Doc
         double *x,   ///< @todo:  Doc
         double *r,   ///< @todo:  Doc
-        double *w1   ///< @todo:  Doc
+        double *w1,  ///< @todo:  Doc
+        double *dc   ///< Derivative of the nonlinear term, or VNULL
         );
 
 VEXTERNC void Vnmresid27(
@@ -384,7 +446,8 @@ VEXTERNC void Vnmresid27(
         double *fc,  ///< @todo:  Doc
         double *x,   ///< @todo:  Doc
         double *r,   ///< @todo:  Doc
-        double *w1   ///< @todo:  Doc
+        double *w1,  ///< @todo:  Doc
+        double *dc   ///< Derivative of the nonlinear term, or VNULL
         );
 
 VEXTERNC void Vnmresid27_1s(
@@ -411,7 +474,8 @@ VEXTERNC void Vnmresid27_1s(
         double *uSW, ///< @todo:  Doc
         double *x,   ///< @todo:  Doc
         double *r,   ///< @todo:  Doc
-        double *w1   ///< @todo:  Doc
+        double *w1,  ///< @todo:  Doc
+        double *dc   ///< Derivative of the nonlinear term, or VNULL
         );
 
 
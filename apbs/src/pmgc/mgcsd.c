@@ -90,6 +90,7 @@ VEXTERNC void Vmvcs(int *nx, int *ny, int *nz,
 
     double alpha;     // A utility variable used to pass a parameter to xaxpy
     int numlev;       // A utility variable used to pass a parameter to mkcors
+    int fuseres;      // Fine post-smoothing also returns the stopping residual
 
     MAT2(iz, 50, 1);
 
@@ -117,9 +118,11 @@ VEXTERNC void Vmvcs(int *nx, int *ny, int *nz,
     }
 
     /*    **************************************************************
-     *    *** Note: if (iok != 0) then:  use a stopping test.        ***
-     *    ***       else:  use just the itmax to stop iteration.     ***
+     *    *** Note: if (iok != 0) then:  print the stopping test.    ***
+     *    ***       if (istop == -1) then:  use just the itmax to    ***
+     *    ***       stop iteration.                                  ***
      *    **************************************************************
+     *    *** istop=-1 none, exactly itmax cycles (preconditioner)   ***
      *    *** istop=0 most efficient (whatever it is)                ***
      *    *** istop=1 relative residual                              ***
      *    *** istop=2 rms difference of successive iterates          ***
@@ -127,7 +130,7 @@ VEXTERNC void Vmvcs(int *nx, int *ny, int *nz,
      *    **************************************************************/
 
     // Compute denominator for stopping criterion
-    if (*iok != 0) {
+    if (*istop != -1) {
         if (*istop == 0) {
             rsden = 1.0;
         }
@@ -162,7 +165,8 @@ VEXTERNC void Vmvcs(int *nx, int *ny, int *nz,
         orsnrm = rsnrm;
         iters_s = 0;
 
-        Vprtstp(*iok, 0, rsnrm, rsden, orsnrm);
+        if (*iok != 0)
+            Vprtstp(*iok, 0, rsnrm, rsden, orsnrm);
     }
 
 
@@ -217,6 +221,16 @@ VEXTERNC void Vmvcs(int *nx, int *ny, int *nz,
             Vxcopy_large(&nxf, &nyf, &nzf, w1, RAT(x, VAT2(iz, 1,lev)));
             VfboundPMG00(&nxf, &nyf, &nzf, RAT(x, VAT2(iz, 1,lev)));
 
+        } else if (*mgsolv == 2) {
+
+            // Use the sparse factor
+            lpv = lev + 1;
+
+            Vxcopy_small(&nxf, &nyf, &nzf, RAT(fc, VAT2(iz, 1,lev)), w1);
+            Vsparsl(RAT(ipc, VAT2(iz, 5,lpv)), RAT(ac, VAT2(iz, 7,lpv)), w1);
+            Vxcopy_large(&nxf, &nyf, &nzf, w1, RAT(x, VAT2(iz, 1,lev)));
+            VfboundPMG00(&nxf, &nyf, &nzf, RAT(x, VAT2(iz, 1,lev)));
+
         } else {
             VABORT_MSG1("Invalid coarse solver requested: %d", *mgsolv);
         }
@@ -224,7 +238,7 @@ VEXTERNC void Vmvcs(int *nx, int *ny, int *nz,
 
         // Compute the stopping test
         *iters = 1;
-        if (*iok != 0) {
+        if (*istop != -1) {
 
             orsnrm = rsnrm;
 
@@ -295,7 +309,8 @@ VEXTERNC void Vmvcs(int *nx, int *ny, int *nz,
             else {
                 VABORT_MSG1("Bad istop value: %d\n", *istop);
             }
-            Vprtstp(*iok, *iters, rsnrm, rsden, orsnrm);
+            if (*iok != 0)
+                Vprtstp(*iok, *iters, rsnrm, rsden, orsnrm);
         }
         return;
     }
@@ -307,6 +322,7 @@ VEXTERNC void Vmvcs(int *nx, int *ny, int *nz,
 
     // Setup for the v-cycle looping
     *iters = 0;
+    fuseres = 0;
     do {
 
         // Finest level initialization
@@ -428,6 +444,16 @@ VEXTERNC void Vmvcs(int *nx, int *ny, int *nz,
             Vxcopy_large(&nxf, &nyf, &nzf, w1, RAT(x, VAT2(iz, 1,lev)));
             VfboundPMG00(&nxf, &nyf, &nzf, RAT(x, VAT2(iz, 1,lev)));
 
+        } else if (*mgsolv == 2) {
+
+            // Use the sparse factor
+            lpv = lev + 1;
+
+            Vxcopy_small(&nxf, &nyf, &nzf, RAT(w0, VAT2(iz, 1,lev)), w1);
+            Vsparsl(RAT(ipc, VAT2(iz, 5,lpv)), RAT(ac, VAT2(iz, 7,lpv)), w1);
+            Vxcopy_large(&nxf, &nyf, &nzf, w1, RAT(x, VAT2(iz, 1,lev)));
+            VfboundPMG00(&nxf, &nyf, &nzf, RAT(x, VAT2(iz, 1,lev)));
+
         } else {
             VABORT_MSG1("Invalid coarse solver requested: %d", *mgsolv);
         }
@@ -486,12 +512,26 @@ VEXTERNC void Vmvcs(int *nx, int *ny, int *nz,
             errtol_s = 0.0;
             nuuu = Vivariv(nu2, &lev);
             if (level == 1) {
-                Vsmooth(&nxf, &nyf, &nzf,
-                        RAT(ipc, VAT2(iz, 5,lev)), RAT(rpc, VAT2(iz, 6,lev)),
-                         RAT(ac, VAT2(iz, 7,lev)), RAT(cc, VAT2(iz, 1,lev)), RAT(fc, VAT2(iz, 1,lev)),
-                          RAT(x, VAT2(iz, 1,lev)),w1,w2,w3,
-                         &nuuu, &iters_s, &errtol_s, omega,
-                         &iresid, &iadjoint, mgsmoo);
+
+                /* The temporally blocked smoother computes the residual for
+                 * the stopping test in the same pass, directly into w1 */
+                fuseres = (*mgsmoo == 5) && (*istop == 0 || *istop == 1);
+                if (fuseres) {
+                    iresid = 1;
+                    Vsmooth(&nxf, &nyf, &nzf,
+                            RAT(ipc, VAT2(iz, 5,lev)), RAT(rpc, VAT2(iz, 6,lev)),
+                             RAT(ac, VAT2(iz, 7,lev)), RAT(cc, VAT2(iz, 1,lev)), RAT(fc, VAT2(iz, 1,lev)),
+                              RAT(x, VAT2(iz, 1,lev)),w2,w3,w1,
+                             &nuuu, &iters_s, &errtol_s, omega,
+                             &iresid, &iadjoint, mgsmoo);
+                } else {
+                    Vsmooth(&nxf, &nyf, &nzf,
+                            RAT(ipc, VAT2(iz, 5,lev)), RAT(rpc, VAT2(iz, 6,lev)),
+                             RAT(ac, VAT2(iz, 7,lev)), RAT(cc, VAT2(iz, 1,lev)), RAT(fc, VAT2(iz, 1,lev)),
+                              RAT(x, VAT2(iz, 1,lev)),w1,w2,w3,
+                             &nuuu, &iters_s, &errtol_s, omega,
+                             &iresid, &iadjoint, mgsmoo);
+                }
             } else {
                 Vsmooth(&nxf, &nyf, &nzf,
                         RAT(ipc, VAT2(iz, 5,lev)), RAT(rpc, VAT2(iz, 6,lev)),
@@ -510,19 +550,21 @@ VEXTERNC void Vmvcs(int *nx, int *ny, int *nz,
         (*iters)++;
 
         // Compute/check the current stopping test
-        if (iok != 0) {
+        if (*istop != -1) {
             orsnrm = rsnrm;
             if (*istop == 0) {
-                Vmresid(&nxf, &nyf, &nzf,
-                        RAT(ipc, VAT2(iz, 5,lev)), RAT(rpc, VAT2(iz, 6,lev)),
-                         RAT(ac, VAT2(iz, 7,lev)), RAT(cc, VAT2(iz, 1,lev)), RAT(fc, VAT2(iz, 1,lev)),
-                          RAT(x, VAT2(iz, 1,lev)), w1);
+                if (!fuseres)
+                    Vmresid(&nxf, &nyf, &nzf,
+                            RAT(ipc, VAT2(iz, 5,lev)), RAT(rpc, VAT2(iz, 6,lev)),
+                             RAT(ac, VAT2(iz, 7,lev)), RAT(cc, VAT2(iz, 1,lev)), RAT(fc, VAT2(iz, 1,lev)),
+                              RAT(x, VAT2(iz, 1,lev)), w1);
                 rsnrm = Vxnrm1(&nxf, &nyf, &nzf, w1);
             } else if(*istop == 1) {
-                Vmresid(&nxf, &nyf, &nzf,
-                        RAT(ipc, VAT2(iz, 5,lev)), RAT(rpc, VAT2(iz, 6,lev)),
-                         RAT(ac, VAT2(iz, 7,lev)),  RAT(cc, VAT2(iz, 1,lev)), RAT(fc, VAT2(iz, 1,lev)),
-                          RAT(x, VAT2(iz, 1,lev)), w1);
+                if (!fuseres)
+                    Vmresid(&nxf, &nyf, &nzf,
+                            RAT(ipc, VAT2(iz, 5,lev)), RAT(rpc, VAT2(iz, 6,lev)),
+                             RAT(ac, VAT2(iz, 7,lev)),  RAT(cc, VAT2(iz, 1,lev)), RAT(fc, VAT2(iz, 1,lev)),
+                              RAT(x, VAT2(iz, 1,lev)), w1);
                 rsnrm = Vxnrm1(&nxf, &nyf, &nzf, w1);
             } else if (*istop == 2) {
                 Vxcopy(&nxf, &nyf, &nzf, RAT(tru, VAT2(iz, 1,lev)), w1);
@@ -552,9 +594,10 @@ VEXTERNC void Vmvcs(int *nx, int *ny, int *nz,
             } else {
                 VABORT_MSG1("Bad istop value: %d", *istop);
             }
-            Vprtstp(*iok, *iters, rsnrm, rsden, orsnrm);
+            if (*iok != 0)
+                Vprtstp(*iok, *iters, rsnrm, rsden, orsnrm);
         }
-    } while (*iters<*itmax && (rsnrm/rsden) > *errtol);
+    } while (*iters<*itmax && (*istop == -1 || (rsnrm/rsden) > *errtol));
 
     *ierror = *iters < *itmax ? 0 : 1;
 }
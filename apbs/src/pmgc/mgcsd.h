@@ -113,7 +113,7 @@ VEXTERNC void Vmvcs(
         double *w1,        ///< @todo: doc
         double *w2,        ///< @todo: doc
         double *w3,        ///< @todo: doc
-        int    *istop,     ///< @todo: doc
+        int    *istop,     ///< Stopping test; -1 to do exactly itmax cycles
         int    *itmax,     ///< @todo: doc
         int    *iters,     ///< @todo: doc
         int    *ierror,    ///< @todo: doc
@@ -82,6 +82,7 @@ VPUBLIC void Vmgdriv(int* iparm, double* rparm,
     int mgcoar = 0;
     int mgdisc = 0;
     int mgsolv = 0;
+    int mgfree = 0;
     int k_iz   = 0;
     int k_ipc  = 0;
     int k_rpc  = 0;
@@ -125,8 +126,9 @@ VPUBLIC void Vmgdriv(int* iparm, double* rparm,
     mgcoar = VAT(iparm, 18);
     mgdisc = VAT(iparm, 19);
     mgsolv = VAT(iparm, 21);
+    mgfree = VAT(iparm, 28);
 
-    Vmgsz(&mgcoar, &mgdisc, &mgsolv,
+    Vmgsz(&mgcoar, &mgdisc, &mgsolv, &mgfree,
                 &nx, &ny, &nz,
                 &nlev,
                 &nxc, &nyc, &nzc,
@@ -215,7 +217,13 @@ VPUBLIC void Vmgdriv2(int *iparm, double *rparm,
     int mgdisc    = 0;
     int mgsmoo    = 0;
     int iperf     = 0;
+    int mgprec    = 0;
+    int mgcach    = 0;
+    int mgfree    = 0;
+    int reuse     = 0;
+    int iguess    = 0;
     int mode      = 0;
+    int key[2]    = {0, 0};
 
     double epsiln  = 0.0;
     double epsmac  = 0.0;
@@ -276,6 +284,23 @@ VPUBLIC void Vmgdriv2(int *iparm, double *rparm,
     mgsmoo = VAT(iparm, 20);
     mgsolv = VAT(iparm, 21);
     iperf  = VAT(iparm, 22);
+    mgprec = VAT(iparm, 23);
+    mgcach = VAT(iparm, 24);
+    mgfree = VAT(iparm, 28);
+
+    /* Start from the interior of u if iparm(30) asks for it; the analysis
+     * below uses u as workspace and nonlinear full multigrid builds its own
+     * guess from the coarsest grid */
+    iguess = (VAT(iparm, 30) == 1) && (iperf == 0)
+        && ((mode == 0) || (mgkey == 0));
+
+    // Only the linear red/black kernels can work without a stored diagonal
+    if (mgfree == 1) {
+        VASSERT_MSG0((mgdisc == 0) && (mgprol == 0) && (mgprec == 0)
+                && (iperf == 0) && (nlev > 1)
+                && ((mgsmoo == 1) || (mgsmoo == 5)),
+                "Fine operator without diagonal needs linear red/black multigrid");
+    }
 
     // Decode real parameters from the rparm array
     errtol = VAT(rparm,  1);
@@ -288,6 +313,18 @@ VPUBLIC void Vmgdriv2(int *iparm, double *rparm,
     // Build the multigrid data structure in iz
     Vbuildstr(nx, ny, nz, &nlev, iz);
 
+    /* Galerkin coarse operators left in the work arrays by the previous
+     * solve can be reused if the fine operator they came from is the same.
+     * iparm(25) flags that operators were kept, under the key in
+     * iparm(26-27); the flag is cleared until the new ones are built. */
+    if (mgcach == 1 && mgcoar == 2) {
+        Vbuildkey(nx, ny, nz, &nlev, &ipkey, &mgprol, &mgdisc,
+                xf, yf, zf, a1cf, a2cf, a3cf, ccf, key);
+        reuse = (VAT(iparm, 25) == 1)
+            && (VAT(iparm, 26) == key[0]) && (VAT(iparm, 27) == key[1]);
+    }
+    VAT(iparm, 25) = 0;
+
     // Start the timer
     Vnm_tstart(30, "Vmgdrv2: fine problem setup");
 
@@ -295,7 +332,7 @@ VPUBLIC void Vmgdriv2(int *iparm, double *rparm,
     ido = 0;
     Vbuildops(nx, ny, nz,
             &nlev, &ipkey, &iinfo, &ido, iz,
-            &mgprol, &mgcoar, &mgsolv, &mgdisc,
+            &mgprol, &mgcoar, &mgsolv, &mgdisc, &mgfree,
             ipc, rpc, pc, ac, cc, fc,
             xf, yf, zf,
             gxcf, gycf, gzcf,
@@ -309,10 +346,10 @@ VPUBLIC void Vmgdriv2(int *iparm, double *rparm,
     Vnm_tstart(30, "Vmgdrv2: coarse problem setup");
 
     // Build operator and rhs on all coarse grids
-    ido = 1;
+    ido = reuse ? 4 : 1;
     Vbuildops(nx, ny, nz,
             &nlev, &ipkey, &iinfo, &ido, iz,
-            &mgprol, &mgcoar, &mgsolv, &mgdisc,
+            &mgprol, &mgcoar, &mgsolv, &mgdisc, &mgfree,
             ipc, rpc, pc, ac, cc, fc,
             xf, yf, zf,
             gxcf, gycf, gzcf,
@@ -322,6 +359,13 @@ VPUBLIC void Vmgdriv2(int *iparm, double *rparm,
     // Stop the timer
     Vnm_tstop(30, "Vmgdrv2: coarse problem setup");
 
+    // Keep the operators unless the coarse solver had to be changed
+    if (mgcach == 1 && mgcoar == 2 && mgsolv == VAT(iparm, 21)) {
+        VAT(iparm, 25) = 1;
+        VAT(iparm, 26) = key[0];
+        VAT(iparm, 27) = key[1];
+    }
+
     // Determine Machine Epsilon
     epsiln = Vnm_epsmac();
 
@@ -447,14 +491,17 @@ VPUBLIC void Vmgdriv2(int *iparm, double *rparm,
         }
 
         // Reinitialize the solution function
-
-        Vazeros(&nxf, &nyf, &nzf, RAT(u, VAT2(iz, 1, level)));
+        if (!iguess) {
+            Vazeros(&nxf, &nyf, &nzf, RAT(u, VAT2(iz, 1, level)));
+        }
 
         // Next grid
     }
 
     // Reinitialize the solution function
+    if (!iguess) {
         Vazeros(nx, ny, nz, u);
+    }
 
     /*******************************************************************
      *** this overwrites the rhs array provided by pde specification ***
@@ -477,6 +524,20 @@ VPUBLIC void Vmgdriv2(int *iparm, double *rparm,
     // Impose zero dirichlet boundary conditions (now in source fcn)
         VfboundPMG00(nx, ny, nz, u);
 
+    // Relative residual of the initial guess; the coefficient arrays are free
+    VAT(rparm, 11) = 1.0;
+    if (iguess) {
+        VAT(rparm, 11) = Vguessres(nx, ny, nz, &mode,
+                RAT(ipc, VAT2(iz, 5, 1)), RAT(rpc, VAT2(iz, 6, 1)),
+                RAT( ac, VAT2(iz, 7, 1)), RAT( cc, VAT2(iz, 1, 1)),
+                RAT( fc, VAT2(iz, 1, 1)), u, a1cf, a2cf, a3cf);
+
+        // Nonlinear iterations need not converge from a guess worse than 0
+        if ((mode != 0) && (VAT(rparm, 11) >= 1.0)) {
+            Vazeros(nx, ny, nz, u);
+        }
+    }
+
     // Start the timer
     Vnm_tstart(30, "Vmgdrv2: solve");
 
@@ -486,7 +547,17 @@ VPUBLIC void Vmgdriv2(int *iparm, double *rparm,
             iok  = 1;
             ilev = 1;
 
-            if (mgkey == 0) {
+            if (mgkey == 0 && mgprec == 1) {
+
+                Vmvcsmix(nx, ny, nz,
+                        u, iz, a1cf, a2cf, a3cf, ccf,
+                        &istop, &itmax, &iters, &ierror, &nlev,
+                        &ilev, &nlev_real, &mgsolv,
+                        &iok, &iinfo, &epsiln, &errtol, &omegal,
+                        &nu1, &nu2, &mgsmoo,
+                        ipc, rpc, pc, ac, cc, fc, tcf);
+
+            } else if (mgkey == 0) {
 
                 Vmvcs(nx, ny, nz,
                         u, iz, a1cf, a2cf, a3cf, ccf,
@@ -545,6 +616,7 @@ VPUBLIC void Vmgdriv2(int *iparm, double *rparm,
 
     // Stop the timer
     Vnm_tstop(30, "Vmgdrv2: solve");
+    VAT(iparm, 29) = iters;
 
     // Restore boundary conditions
     ibound = 1;
@@ -554,7 +626,7 @@ VPUBLIC void Vmgdriv2(int *iparm, double *rparm,
 
 
 
-VPUBLIC void Vmgsz(int *mgcoar, int *mgdisc, int *mgsolv,
+VPUBLIC void Vmgsz(int *mgcoar, int *mgdisc, int *mgsolv, int *mgfree,
         int *nx, int *ny, int *nz,
         int *nlev,
         int *nxc, int *nyc, int *nzc,
@@ -569,7 +641,7 @@ VPUBLIC void Vmgsz(int *mgcoar, int *mgdisc, int *mgsolv,
     int num_narrc = 27;
 
     // Misc variables
-    int nc_band, num_band, n_band;
+    int nc_band, num_band, n_band, n_sparse, numdia;
     int nxf, nyf, nzf;
     int level;
     int num_nf_oper, num_narrc_oper;
@@ -610,7 +682,7 @@ VPUBLIC void Vmgsz(int *mgcoar, int *mgdisc, int *mgsolv,
 
     // Box or fem on fine grid?
     if (*mgdisc == 0) {
-        num_nf_oper = 4;
+        num_nf_oper = (*mgfree == 1) ? 3 : 4;
     } else if (*mgdisc == 1) {
         num_nf_oper = 14;
     } else {
@@ -626,9 +698,17 @@ VPUBLIC void Vmgsz(int *mgcoar, int *mgdisc, int *mgsolv,
         Vnm_print(2, "Vmgsz: invalid mgcoar parameter: %d\n", *mgcoar);
     }
 
-    // Symmetric banded linpack storage on coarse grid
+    // Symmetric banded linpack or sparse storage on coarse grid
+    n_sparse = 0;
     if (*mgsolv == 0) {
         n_band = 0;
+    } else if (*mgsolv == 2) {
+        if ((*mgcoar == 0 || *mgcoar == 1) && *mgdisc == 0) {
+            numdia = 7;
+        } else {
+            numdia = 27;
+        }
+        Vsparsz(&numdia, nxc, nyc, nzc, &n_band, &n_sparse);
     } else if (*mgsolv == 1) {
         if ((*mgcoar == 0 || *mgcoar == 1) && *mgdisc == 0) {
             num_band = 1 + (*nxc - 2) * (*nyc - 2);
@@ -653,7 +733,7 @@ VPUBLIC void Vmgsz(int *mgcoar, int *mgdisc, int *mgsolv,
 
     // The integer storage parameters ***
     *n_iz  = 50  * (*nlev + 1);
-    *n_ipc = 100 * (*nlev + 1);
+    *n_ipc = 100 * (*nlev + 1) + n_sparse;
 
     // Resulting total required integer storage for method
     *iintot = *n_iz + *n_ipc;
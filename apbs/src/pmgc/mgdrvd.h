@@ -62,6 +62,7 @@
 #include "generic/vmatrix.h"
 #include "pmgc/mgsubd.h"
 #include "pmgc/mgcsd.h"
+#include "pmgc/mgmixd.h"
 #include "pmgc/powerd.h"
 #include "pmgc/mgfasd.h"
 
@@ -230,6 +231,7 @@ VEXTERNC void Vmgsz(
         int *mgcoar, ///< @todo: Doc
         int *mgdisc, ///< @todo: Doc
         int *mgsolv, ///< @todo: Doc
+        int *mgfree, ///< Fine operator kept as its three face weights
         int *nx,     ///< @todo: Doc
         int *ny,     ///< @todo: Doc
         int *nz,     ///< @todo: Doc
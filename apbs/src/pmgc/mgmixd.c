@@ -0,0 +1,1281 @@
+/**
+ *  @ingroup PMGC
+ *  @brief   Single-precision multigrid cycle with double-precision
+ *           defect correction
+ *  @version $Id:
+ *
+ *  @attention
+ *  @verbatim
+ *
+ * APBS -- Adaptive Poisson-Boltzmann Solver
+ *
+ * Nathan A. Baker (nathan.baker@pnl.gov)
+ * Pacific Northwest National Laboratory
+ *
+ * Additional contributing authors listed in the code documentation.
+ *
+ * Copyright (c) 2010-2014 Battelle Memorial Institute. Developed at the Pacific Northwest National Laboratory, operated by Battelle Memorial Institute, Pacific Northwest Division for the U.S. Department Energy.  Portions Copyright (c) 2002-2010, Washington University in St. Louis.  Portions Copyright (c) 2002-2010, Nathan A. Baker.  Portions Copyright (c) 1999-2002, The Regents of the University of California. Portions Copyright (c) 1995, Michael Holst.
+ * All rights reserved.
+ *
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * -  Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * - Neither the name of Washington University in St. Louis nor the names of its
+ * contributors may be used to endorse or promote products derived from this
+ * software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @endverbatim
+ */
+
+#include "mgmixd.h"
+
+VPUBLIC void Vmvcsmix(int *nx, int *ny, int *nz,
+        double *x,
+        int *iz,
+        double *w0, double *w1, double *w2, double *w3,
+        int *istop, int *itmax, int *iters, int *ierror,
+        int *nlev, int *ilev, int *nlev_real,
+        int *mgsolv, int *iok, int *iinfo,
+        double *epsiln, double *errtol, double *omega,
+        int *nu1, int *nu2,
+        int *mgsmoo,
+        int *ipc, double *rpc,
+        double *pc, double *ac, double *cc, double *fc, double *tru) {
+
+    int level, lev, i, n, nf, nac, npc, numdia, numlev;
+    int nxf, nyf, nzf, nxc, nyc, nzc;
+    double rsden, rsnrm, orsnrm;
+    float *xs, *w0s, *w1s, *w2s, *w3s, *fcs, *ccs, *acs, *pcs;
+    double *wd;
+
+    MAT2(iz, 50, 1);
+
+    // Only the residual-based stopping tests are supported here
+    if ((*istop != 0) && (*istop != 1)) {
+        Vmvcs(nx, ny, nz, x, iz, w0, w1, w2, w3,
+              istop, itmax, iters, ierror, nlev, ilev, nlev_real,
+              mgsolv, iok, iinfo, epsiln, errtol, omega, nu1, nu2, mgsmoo,
+              ipc, rpc, pc, ac, cc, fc, tru);
+        return;
+    }
+
+    level = 1;
+    lev = (*ilev - 1) + level;
+    nxf = *nx;
+    nyf = *ny;
+    nzf = *nz;
+    n = nxf * nyf * nzf;
+
+    /* Sizes of the multilevel arrays: grid functions, operators and
+     * prolongations, all indexed with the same iz offsets as the double
+     * precision arrays */
+    nf = 0;
+    nxc = nxf;
+    nyc = nyf;
+    nzc = nzf;
+    for (level=1; level<=*nlev; level++) {
+        lev = (*ilev - 1) + level;
+        if (level != 1) {
+            numlev = 1;
+            Vmkcors(&numlev, &nxf, &nyf, &nzf, &nxc, &nyc, &nzc);
+            nxf = nxc;
+            nyf = nyc;
+            nzf = nzc;
+        }
+        nf = VAT2(iz, 1, lev) - 1 + nxf * nyf * nzf;
+    }
+    // Symmetric storage: 4 diagonals for the 7-point and 14 for the 27-point
+    numdia = (VAT(RAT(ipc, VAT2(iz, 5, lev)), 11) == 7) ? 4 : 14;
+    nac = VAT2(iz, 7, lev) - 1 + numdia * nxc * nyc * nzc;
+    npc = (*nlev > 1) ? VAT2(iz, 11, lev - 1) - 1 + 27 * nxc * nyc * nzc : 0;
+
+    // Single precision copies of the operator hierarchy
+    xs  = (float *)Vmem_malloc(VNULL, nf, sizeof(float));
+    w0s = (float *)Vmem_malloc(VNULL, nf, sizeof(float));
+    ccs = (float *)Vmem_malloc(VNULL, nf, sizeof(float));
+    w1s = (float *)Vmem_malloc(VNULL, n, sizeof(float));
+    w2s = (float *)Vmem_malloc(VNULL, n, sizeof(float));
+    w3s = (float *)Vmem_malloc(VNULL, n, sizeof(float));
+    fcs = (float *)Vmem_malloc(VNULL, n, sizeof(float));
+    acs = (float *)Vmem_malloc(VNULL, nac, sizeof(float));
+    pcs = (float *)Vmem_malloc(VNULL, VMAX2(npc, 1), sizeof(float));
+    wd  = (double *)Vmem_malloc(VNULL, 5 * nxc * nyc * nzc, sizeof(double));
+
+    for (i=0; i<nf; i++) ccs[i] = (float)cc[i];
+    for (i=0; i<nac; i++) acs[i] = (float)ac[i];
+    for (i=0; i<npc; i++) pcs[i] = (float)pc[i];
+
+    // Recover level information
+    level = 1;
+    lev = (*ilev - 1) + level;
+    nxf = *nx;
+    nyf = *ny;
+    nzf = *nz;
+
+    if (*iinfo > 1) {
+        VMESSAGE0("Starting mixed precision mvcs operation");
+        VMESSAGE3("Fine Grid Size:   (%d, %d, %d)", nxf, nyf, nzf);
+    }
+
+    if (*iok != 0) {
+        Vprtstp(*iok, -1, 0.0, 0.0, 0.0);
+    }
+
+    // Compute denominator for stopping criterion
+    if (*istop == 0) {
+        rsden = 1.0;
+    } else {
+        rsden = Vxnrm1(&nxf, &nyf, &nzf, RAT(fc, VAT2(iz, 1,lev)));
+    }
+    if (rsden == 0.0) {
+        rsden = 1.0;
+        VERRMSG0("rhs is zero on finest level");
+    }
+    rsnrm = rsden;
+    orsnrm = rsnrm;
+    if (*iok != 0) {
+        Vprtstp(*iok, 0, rsnrm, rsden, orsnrm);
+    }
+
+    // Initial defect in double precision
+    Vmresid(&nxf, &nyf, &nzf,
+            RAT(ipc, VAT2(iz, 5,lev)), RAT(rpc, VAT2(iz, 6,lev)),
+             RAT(ac, VAT2(iz, 7,lev)), RAT(cc, VAT2(iz, 1,lev)), RAT(fc, VAT2(iz, 1,lev)),
+              RAT(x, VAT2(iz, 1,lev)), w1);
+
+    /* Defect correction: each single precision V-cycle only has to reduce
+     * the current defect, so its rounding error shrinks along with it and
+     * the double precision iterate converges to full accuracy */
+    *iters = 0;
+    do {
+
+        for (i=0; i<n; i++) fcs[i] = (float)w1[i];
+
+        Vmvcsf(&nxf, &nyf, &nzf,
+               xs, iz, w0s, w1s, w2s, w3s,
+               nlev, ilev, mgsolv, epsiln, omega, nu1, nu2,
+               ipc, rpc, pcs, acs, ccs, fcs,
+               ac, cc, wd);
+
+        for (i=0; i<n; i++) VAT(x, VAT2(iz, 1,lev) + i) += (double)xs[i];
+
+        (*iters)++;
+
+        // Compute/check the current stopping test
+        orsnrm = rsnrm;
+        Vmresid(&nxf, &nyf, &nzf,
+                RAT(ipc, VAT2(iz, 5,lev)), RAT(rpc, VAT2(iz, 6,lev)),
+                 RAT(ac, VAT2(iz, 7,lev)), RAT(cc, VAT2(iz, 1,lev)), RAT(fc, VAT2(iz, 1,lev)),
+                  RAT(x, VAT2(iz, 1,lev)), w1);
+        rsnrm = Vxnrm1(&nxf, &nyf, &nzf, w1);
+        if (*iok != 0) {
+            Vprtstp(*iok, *iters, rsnrm, rsden, orsnrm);
+        }
+
+    } while (*iters<*itmax && (rsnrm/rsden) > *errtol);
+
+    *ierror = *iters < *itmax ? 0 : 1;
+
+    Vmem_free(VNULL, nf, sizeof(float), (void **)&xs);
+    Vmem_free(VNULL, nf, sizeof(float), (void **)&w0s);
+    Vmem_free(VNULL, nf, sizeof(float), (void **)&ccs);
+    Vmem_free(VNULL, n, sizeof(float), (void **)&w1s);
+    Vmem_free(VNULL, n, sizeof(float), (void **)&w2s);
+    Vmem_free(VNULL, n, sizeof(float), (void **)&w3s);
+    Vmem_free(VNULL, n, sizeof(float), (void **)&fcs);
+    Vmem_free(VNULL, nac, sizeof(float), (void **)&acs);
+    Vmem_free(VNULL, VMAX2(npc, 1), sizeof(float), (void **)&pcs);
+    Vmem_free(VNULL, 5 * nxc * nyc * nzc, sizeof(double), (void **)&wd);
+}
+
+
+
+VPUBLIC void Vmvcsf(int *nx, int *ny, int *nz,
+        float *x,
+        int *iz,
+        float *w0, float *w1, float *w2, float *w3,
+        int *nlev, int *ilev,
+        int *mgsolv,
+        double *epsiln, double *omega,
+        int *nu1, int *nu2,
+        int *ipc, double *rpc,
+        float *pc, float *ac, float *cc, float *fc,
+        double *acd, double *ccd, double *wd) {
+
+    int level, lev, lpv, n, m, lda, numlev, nuuu;
+    int nxf, nyf, nzf, nxc, nyc, nzc, nc;
+    int iresid, iadjoint, itmax_s, iters_s, mgsmoo_s, i;
+    double errtol_s, xnum, xden;
+    float xdamp;
+    double *xd, *fd, *w1d, *w2d, *w3d;
+
+    MAT2(iz, 50, 1);
+
+    nxf = *nx;
+    nyf = *ny;
+    nzf = *nz;
+
+    // Finest level: the correction starts from zero
+    level = 1;
+    lev   = (*ilev - 1) + level;
+    Vazerosf(&nxf, &nyf, &nzf, RAT(x, VAT2(iz, 1,lev)));
+
+    // nu1 pre-smoothings on fine grid (with residual)
+    iresid = 1;
+    iadjoint = 0;
+    iters_s  = 0;
+    errtol_s = 0.0;
+    nuuu = Vivariv(nu1, &lev);
+    Vgsrbf(&nxf, &nyf, &nzf,
+           RAT(ipc, VAT2(iz, 5,lev)), RAT(rpc, VAT2(iz, 6,lev)),
+            RAT(ac, VAT2(iz, 7,lev)), RAT(cc, VAT2(iz, 1,lev)), fc,
+             RAT(x, VAT2(iz, 1,lev)), w2, w3, w1,
+           &nuuu, &iters_s, &errtol_s, omega,
+           &iresid, &iadjoint);
+    Vxcopyf(&nxf, &nyf, &nzf, w1, RAT(w0, VAT2(iz, 1,lev)));
+
+    // Go down grids: restrict resid to coarser and smooth
+    for (level=2; level<=*nlev; level++) {
+
+        lev = (*ilev - 1) + level;
+
+        numlev = 1;
+        Vmkcors(&numlev, &nxf, &nyf, &nzf, &nxc, &nyc, &nzc);
+
+        Vrestrcf(&nxf, &nyf, &nzf,
+                 &nxc, &nyc, &nzc,
+                 w1, RAT(w0, VAT2(iz, 1,lev)), RAT(pc, VAT2(iz, 11,lev-1)));
+
+        nxf = nxc;
+        nyf = nyc;
+        nzf = nzc;
+
+        if (level != *nlev) {
+            Vazerosf(&nxf, &nyf, &nzf, RAT(x, VAT2(iz, 1,lev)));
+            iresid = 1;
+            iadjoint = 0;
+            iters_s  = 0;
+            errtol_s = 0.0;
+            nuuu = Vivariv(nu1, &lev);
+            Vgsrbf(&nxf, &nyf, &nzf,
+                   RAT(ipc, VAT2(iz, 5,lev)), RAT(rpc, VAT2(iz, 6,lev)),
+                    RAT(ac, VAT2(iz, 7,lev)), RAT(cc, VAT2(iz, 1,lev)), RAT(w0, VAT2(iz, 1,lev)),
+                     RAT(x, VAT2(iz, 1,lev)), w2, w3, w1,
+                   &nuuu, &iters_s, &errtol_s, omega,
+                   &iresid, &iadjoint);
+        }
+    }
+
+    /* Coarsest level: solved in double precision with the original
+     * operator, which is small enough that the conversion is free */
+    level = *nlev;
+    lev = (*ilev - 1) + level;
+    nc = nxf * nyf * nzf;
+    xd  = wd;
+    fd  = wd + nc;
+    w1d = wd + 2*nc;
+    w2d = wd + 3*nc;
+    w3d = wd + 4*nc;
+    for (i=0; i<nc; i++) fd[i] = (double)VAT(w0, VAT2(iz, 1,lev) + i);
+
+    if (*mgsolv == 0) {
+
+        iresid = 0;
+        iadjoint = 0;
+        itmax_s  = 100;
+        iters_s  = 0;
+        errtol_s = *epsiln;
+        mgsmoo_s = 4;
+        Vazeros(&nxf, &nyf, &nzf, xd);
+        Vsmooth(&nxf, &nyf, &nzf,
+                RAT(ipc, VAT2(iz, 5,lev)), RAT(rpc, VAT2(iz, 6,lev)),
+                 RAT(acd, VAT2(iz, 7,lev)), RAT(ccd, VAT2(iz, 1,lev)), fd,
+                   xd, w1d, w2d, w3d,
+                &itmax_s, &iters_s,
+                &errtol_s, omega,
+                &iresid, &iadjoint, &mgsmoo_s);
+
+        VWARN_MSG2(iters_s <= itmax_s,
+            "Exceeded maximum iterations: iters_s=%d, itmax_s=%d",
+            iters_s, itmax_s);
+
+    } else if (*mgsolv == 1) {
+
+        lpv = lev + 1;
+        n   = VAT(ipc, (VAT2(iz, 5, lpv) - 1) + 1);
+        m   = VAT(ipc, (VAT2(iz, 5, lpv) - 1) + 2);
+        lda = VAT(ipc, (VAT2(iz, 5, lpv) - 1) + 3);
+
+        Vxcopy_small(&nxf, &nyf, &nzf, fd, w1d);
+        Vdpbsl(RAT(acd, VAT2(iz, 7,lpv)), &lda, &n, &m, w1d);
+        Vxcopy_large(&nxf, &nyf, &nzf, w1d, xd);
+        VfboundPMG00(&nxf, &nyf, &nzf, xd);
+
+    } else if (*mgsolv == 2) {
+
+        lpv = lev + 1;
+        Vxcopy_small(&nxf, &nyf, &nzf, fd, w1d);
+        Vsparsl(RAT(ipc, VAT2(iz, 5,lpv)), RAT(acd, VAT2(iz, 7,lpv)), w1d);
+        Vxcopy_large(&nxf, &nyf, &nzf, w1d, xd);
+        VfboundPMG00(&nxf, &nyf, &nzf, xd);
+
+    } else {
+        VABORT_MSG1("Invalid coarse solver requested: %d", *mgsolv);
+    }
+
+    for (i=0; i<nc; i++) VAT(x, VAT2(iz, 1,lev) + i) = (float)xd[i];
+
+    // Move up grids: interpolate resid to finer and smooth
+    for (level=*nlev-1; level>=1; level--) {
+
+        lev = (*ilev - 1) + level;
+
+        numlev = 1;
+        Vmkfine(&numlev,
+                &nxf, &nyf, &nzf,
+                &nxc, &nyc, &nzc);
+
+        VinterpPMGf(&nxf, &nyf, &nzf,
+                    &nxc, &nyc, &nzc,
+                    RAT(x, VAT2(iz, 1,lev+1)), w1, RAT(pc, VAT2(iz, 11,lev)));
+
+        // Hackbusch/reusken damping parameter, accumulated in double
+        Vmatvecf(&nxf, &nyf, &nzf,
+                 RAT(ipc, VAT2(iz, 5,lev+1)), RAT(rpc, VAT2(iz, 6,lev+1)),
+                  RAT(ac, VAT2(iz, 7,lev+1)),  RAT(cc, VAT2(iz, 1,lev+1)),
+                   RAT(x, VAT2(iz, 1,lev+1)),  w2);
+        xnum = Vxdotf(&nxf, &nyf, &nzf,
+                      RAT(x, VAT2(iz, 1,lev+1)), RAT(w0, VAT2(iz, 1,lev+1)));
+        xden = Vxdotf(&nxf, &nyf, &nzf,
+                      RAT(x, VAT2(iz, 1,lev+1)), w2);
+        xdamp = (float)(xnum / xden);
+
+        nxf = nxc;
+        nyf = nyc;
+        nzf = nzc;
+
+        Vxaxpyf(&nxf, &nyf, &nzf, &xdamp, w1, RAT(x, VAT2(iz, 1,lev)));
+
+        // nu2 post-smoothings for correction (no residual)
+        iresid = 0;
+        iadjoint = 1;
+        iters_s  = 0;
+        errtol_s = 0.0;
+        nuuu = Vivariv(nu2, &lev);
+        Vgsrbf(&nxf, &nyf, &nzf,
+               RAT(ipc, VAT2(iz, 5,lev)), RAT(rpc, VAT2(iz, 6,lev)),
+                RAT(ac, VAT2(iz, 7,lev)), RAT(cc, VAT2(iz, 1,lev)),
+               (level == 1) ? fc : RAT(w0, VAT2(iz, 1,lev)),
+                 RAT(x, VAT2(iz, 1,lev)), w1, w2, w3,
+               &nuuu, &iters_s, &errtol_s, omega,
+               &iresid, &iadjoint);
+    }
+}
+
+
+
+VPUBLIC void Vgsrbf(int *nx, int *ny, int *nz,
+        int *ipc, double *rpc,
+        float *ac, float *cc, float *fc,
+        float *x, float *w1, float *w2, float *r,
+        int *itmax, int *iters,
+        double *errtol, double *omega,
+        int *iresid, int *iadjoint) {
+
+    int numdia;
+
+    MAT2(ac, *nx * *ny * *nz, 1);
+
+    numdia = VAT(ipc, 11);
+    if (numdia == 7) {
+        Vgsrb7xf(nx, ny, nz,
+                 ipc, rpc,
+                 RAT2(ac, 1,1), cc, fc,
+                 RAT2(ac, 1,2), RAT2(ac, 1,3), RAT2(ac, 1,4),
+                 x, w1, w2, r,
+                 itmax, iters, errtol, omega, iresid, iadjoint);
+    } else if (numdia == 27) {
+        Vgsrb27xf(nx, ny, nz,
+                  ipc, rpc,
+                  RAT2(ac, 1, 1), cc, fc,
+                  RAT2(ac, 1, 2), RAT2(ac, 1, 3), RAT2(ac, 1, 4),
+                  RAT2(ac, 1, 5), RAT2(ac, 1, 6),
+                  RAT2(ac, 1, 7), RAT2(ac, 1, 8), RAT2(ac, 1, 9), RAT2(ac, 1,10),
+                  RAT2(ac, 1,11), RAT2(ac, 1,12), RAT2(ac, 1,13), RAT2(ac, 1,14),
+                  x, w1, w2, r,
+                  itmax, iters, errtol, omega, iresid, iadjoint);
+    } else {
+        Vnm_print(2, "GSRBF: invalid stencil type given...\n");
+    }
+}
+
+
+
+VPUBLIC void Vmatvecf(int *nx, int *ny, int *nz,
+        int    *ipc, double *rpc,
+        float  *ac, float  *cc,
+        float   *x, float   *y) {
+
+    int numdia;
+
+    MAT2(ac, *nx * *ny * *nz, 1);
+
+    numdia = VAT(ipc, 11);
+    if (numdia == 7) {
+        Vmatvec7_1sf(nx, ny, nz,
+                     ipc, rpc,
+                     RAT2(ac, 1, 1), cc,
+                     RAT2(ac, 1, 2), RAT2(ac, 1, 3), RAT2(ac, 1, 4),
+                     x, y);
+    } else if (numdia == 27) {
+        Vmatvec27_1sf(nx, ny, nz,
+                      ipc, rpc,
+                      RAT2(ac, 1, 1), cc,
+                      RAT2(ac, 1, 2), RAT2(ac, 1, 3), RAT2(ac, 1, 4),
+                      RAT2(ac, 1, 5), RAT2(ac, 1, 6),
+                      RAT2(ac, 1, 7), RAT2(ac, 1, 8), RAT2(ac, 1, 9), RAT2(ac, 1,10),
+                      RAT2(ac, 1,11), RAT2(ac, 1,12), RAT2(ac, 1,13), RAT2(ac, 1,14),
+                      x, y);
+    } else {
+        Vnm_print(2, "MATVECF: invalid stencil type given...\n");
+    }
+}
+
+
+
+VPUBLIC void Vrestrcf(int *nxf, int *nyf, int *nzf,
+        int *nxc, int *nyc, int *nzc,
+        float *xin, float *xout, float *pc) {
+
+    MAT2(pc, *nxc * *nyc * *nzc, 1 );
+
+    Vrestrc2f(nxf, nyf, nzf,
+            nxc, nyc, nzc,
+            xin, xout,
+            RAT2(pc, 1, 1), RAT2(pc, 1, 2), RAT2(pc, 1, 3), RAT2(pc, 1, 4), RAT2(pc, 1, 5),
+            RAT2(pc, 1, 6), RAT2(pc, 1, 7), RAT2(pc, 1, 8), RAT2(pc, 1, 9),
+            RAT2(pc, 1,10), RAT2(pc, 1,11), RAT2(pc, 1,12), RAT2(pc, 1,13), RAT2(pc, 1,14),
+            RAT2(pc, 1,15), RAT2(pc, 1,16), RAT2(pc, 1,17), RAT2(pc, 1,18),
+            RAT2(pc, 1,19), RAT2(pc, 1,20), RAT2(pc, 1,21), RAT2(pc, 1,22), RAT2(pc, 1,23),
+            RAT2(pc, 1,24), RAT2(pc, 1,25), RAT2(pc, 1,26), RAT2(pc, 1,27));
+}
+
+
+
+VPUBLIC void VinterpPMGf(int *nxc, int *nyc, int *nzc,
+        int *nxf, int *nyf, int *nzf,
+        float *xin, float *xout,
+        float *pc) {
+
+    MAT2(pc, *nxc * *nyc * *nzc, 1);
+
+    VinterpPMG2f(nxc, nyc, nzc,
+            nxf, nyf, nzf,
+            xin, xout,
+            RAT2(pc, 1, 1), RAT2(pc, 1, 2), RAT2(pc, 1, 3), RAT2(pc, 1, 4), RAT2(pc, 1, 5),
+            RAT2(pc, 1, 6), RAT2(pc, 1, 7), RAT2(pc, 1, 8), RAT2(pc, 1, 9),
+            RAT2(pc, 1,10), RAT2(pc, 1,11), RAT2(pc, 1,12), RAT2(pc, 1,13), RAT2(pc, 1,14),
+            RAT2(pc, 1,15), RAT2(pc, 1,16), RAT2(pc, 1,17), RAT2(pc, 1,18),
+            RAT2(pc, 1,19), RAT2(pc, 1,20), RAT2(pc, 1,21), RAT2(pc, 1,22), RAT2(pc, 1,23),
+            RAT2(pc, 1,24), RAT2(pc, 1,25), RAT2(pc, 1,26), RAT2(pc, 1,27));
+}
+
+
+
+VPUBLIC void Vazerosf(int *nx, int *ny, int *nz, float *x) {
+
+    int i, n;
+
+    n = *nx * *ny * *nz;
+    #pragma omp parallel for private(i)
+    for (i=0; i<n; i++)
+        x[i] = 0.0;
+}
+
+
+
+VPUBLIC void Vxcopyf(int *nx, int *ny, int *nz, float *x, float *y) {
+
+    int i, j, k;
+
+    MAT3(x, *nx, *ny, *nz);
+    MAT3(y, *nx, *ny, *nz);
+
+    #pragma omp parallel for private(i, j, k)
+    for (k=2; k<=*nz-1; k++)
+        for (j=2; j<=*ny-1; j++)
+            for (i=2; i<=*nx-1; i++)
+                VAT3(y, i, j, k) = VAT3(x, i, j, k);
+}
+
+
+
+VPUBLIC void Vxaxpyf(int *nx, int *ny, int *nz,
+        float *alpha, float *x, float *y) {
+
+    int i, j, k;
+
+    MAT3(x, *nx, *ny, *nz);
+    MAT3(y, *nx, *ny, *nz);
+
+    #pragma omp parallel for private(i, j, k)
+    for (k=2; k<=*nz-1; k++)
+        for (j=2; j<=*ny-1; j++)
+            for (i=2; i<=*nx-1; i++)
+                VAT3(y, i, j, k) += *alpha * VAT3(x, i, j, k);
+}
+
+
+
+VPUBLIC double Vxdotf(int *nx, int *ny, int *nz, float *x, float *y) {
+
+    int i, j, k;
+    double xdot = 0.0;
+
+    MAT3(x, *nx, *ny, *nz);
+    MAT3(y, *nx, *ny, *nz);
+
+    #pragma omp parallel for private(i, j, k) reduction(+:xdot)
+    for (k=2; k<=*nz-1; k++)
+        for (j=2; j<=*ny-1; j++)
+            for (i=2; i<=*nx-1; i++)
+                xdot += (double)VAT3(x, i, j, k) * (double)VAT3(y, i, j, k);
+
+    return xdot;
+}
+
+
+
+VPUBLIC void VfboundPMG00f(int *nx, int *ny, int *nz, float *x) {
+
+    int i, j, k;
+
+    MAT3(  x, *nx, *ny, *nz);
+
+    // The (i=1) and (i=nx) boundaries
+    for (k=1; k<=*nz; k++) {
+        for (j=1; j<=*ny; j++) {
+            VAT3(x,   1, j, k) = 0.0;
+            VAT3(x, *nx, j, k) = 0.0;
+        }
+    }
+
+    // The (j=1) and (j=ny) boundaries
+    for (k=1; k<=*nz; k++) {
+        for(i=1; i<=*nx; i++) {
+            VAT3(x, i,   1, k) = 0.0;
+            VAT3(x, i, *ny, k) = 0.0;
+        }
+    }
+
+    // The (k=1) and (k=nz) boundaries
+    for (j=1; j<=*ny; j++) {
+        for (i=1; i<=*nx; i++) {
+            VAT3(x, i, j,   1) = 0.0;
+            VAT3(x, i, j, *nz) = 0.0;
+        }
+    }
+}
+
+
+
+VPUBLIC void Vgsrb7xf(int *nx,int *ny,int *nz,
+        int *ipc, double *rpc,
+        float *oC, float *cc, float *fc,
+        float *oE, float *oN, float *uC,
+        float *x, float *w1, float *w2, float *r,
+        int *itmax, int *iters,
+        double *errtol, double *omega,
+        int *iresid, int *iadjoint) {
+
+    int i, j, k, ioff;
+
+    MAT3(cc, *nx, *ny, *nz);
+    MAT3(fc, *nx, *ny, *nz);
+    MAT3( x, *nx, *ny, *nz);
+    MAT3(w1, *nx, *ny, *nz);
+    MAT3(w2, *nx, *ny, *nz);
+    MAT3( r, *nx, *ny, *nz);
+
+    MAT3(oE, *nx, *ny, *nz);
+    MAT3(oN, *nx, *ny, *nz);
+    MAT3(uC, *nx, *ny, *nz);
+    MAT3(oC, *nx, *ny, *nz);
+
+    for (*iters=1; *iters<=*itmax; (*iters)++) {
+
+        // Do the red points ***
+        #pragma omp parallel for private(i, j, k, ioff)
+        for (k=2; k<=*nz-1; k++) {
+            for (j=2; j<=*ny-1; j++) {
+                ioff = (1 - *iadjoint) * (    (j + k + 2) % 2)
+                     + (    *iadjoint) * (1 - (j + k + 2) % 2);
+                for (i=2+ioff; i<=*nx-1; i+=2) {
+                    VAT3(x, i, j, k) = (
+                            VAT3(fc,   i,  j,  k)
+                         +  VAT3(oN,   i,   j,   k) * VAT3(x,   i, j+1,   k)
+                         +  VAT3(oN,   i, j-1,   k) * VAT3(x,   i, j-1,   k)
+                         +  VAT3(oE,   i,   j,   k) * VAT3(x, i+1,   j,   k)
+                         +  VAT3(oE, i-1,   j,   k) * VAT3(x, i-1,   j,   k)
+                         + VAT3( uC,   i,   j, k-1) * VAT3(x,   i,   j, k-1)
+                         + VAT3( uC,   i,   j,   k) * VAT3(x,   i,   j, k+1)
+                         ) / (VAT3(oC, i, j, k) + VAT3(cc, i, j, k));
+                }
+            }
+        }
+
+        // Do the black points
+        #pragma omp parallel for private(i, j, k, ioff)
+        for (k=2; k<=*nz-1; k++) {
+            for (j=2; j<=*ny-1; j++) {
+                ioff =   (    *iadjoint) * (    (j + k + 2) % 2 )
+                       + (1 - *iadjoint) * (1 - (j + k + 2) % 2 );
+                for (i=2+ioff;i<=*nx-1; i+=2) {
+                    VAT3(x, i, j, k) = (
+                            VAT3(fc,   i,   j,   k)
+                         +  VAT3(oN,   i,   j,   k) * VAT3(x,   i,j+1,  k)
+                         +  VAT3(oN,   i, j-1,   k) * VAT3(x,   i,j-1,  k)
+                         +  VAT3(oE,   i,   j,   k) * VAT3(x, i+1,  j,  k)
+                         +  VAT3(oE, i-1,   j,   k) * VAT3(x, i-1,  j,  k)
+                         + VAT3( uC,   i,   j, k-1) * VAT3(x,   i,  j,k-1)
+                         + VAT3( uC,   i,   j,   k) * VAT3(x,   i,  j,k+1)
+                         ) / (VAT3(oC, i, j, k) + VAT3(cc, i, j, k));
+                }
+            }
+        }
+    }
+
+    if (*iresid == 1)
+        Vmresid7_1sf(nx, ny, nz, ipc, rpc, oC, cc, fc, oE, oN, uC, x, r);
+}
+
+
+
+VPUBLIC void Vgsrb27xf(int *nx,int *ny,int *nz,
+        int *ipc, double *rpc,
+        float  *oC, float  *cc, float  *fc,
+        float  *oE, float  *oN, float  *uC, float *oNE, float *oNW,
+        float  *uE, float  *uW, float  *uN, float  *uS,
+        float *uNE, float *uNW, float *uSE, float *uSW,
+        float *x, float *w1, float *w2, float *r,
+        int *itmax, int *iters,
+        double *errtol, double *omega,
+        int *iresid, int *iadjoint) {
+
+    int  i,  j,  k;
+    int i1, j1, k1;
+    int ic, icolor;
+
+    /* Parity offsets of the eight colors, red (i+j+k even) first */
+    static const int color[8][3] = {
+        {0, 0, 0}, {1, 1, 0}, {1, 0, 1}, {0, 1, 1},
+        {1, 0, 0}, {0, 1, 0}, {0, 0, 1}, {1, 1, 1}
+    };
+
+    float tmpO, tmpU, tmpD;
+
+    MAT3( cc, *nx, *ny, *nz);
+    MAT3(fc, *nx, *ny, *nz);
+    MAT3( x, *nx, *ny, *nz);
+    MAT3(w1, *nx, *ny, *nz);
+    MAT3(w2, *nx, *ny, *nz);
+    MAT3( r, *nx, *ny, *nz);
+
+    MAT3(oE, *nx, *ny, *nz);
+    MAT3(oN, *nx, *ny, *nz);
+    MAT3(uC, *nx, *ny, *nz);
+    MAT3(oC, *nx, *ny, *nz);
+
+    MAT3(oNE, *nx, *ny, *nz);
+    MAT3(oNW, *nx, *ny, *nz);
+
+    MAT3( uE, *nx, *ny, *nz);
+    MAT3( uW, *nx, *ny, *nz);
+    MAT3( uN, *nx, *ny, *nz);
+    MAT3( uS, *nx, *ny, *nz);
+    MAT3(uNE, *nx, *ny, *nz);
+    MAT3(uNW, *nx, *ny, *nz);
+    MAT3(uSE, *nx, *ny, *nz);
+    MAT3(uSW, *nx, *ny, *nz);
+
+    /* The 27-point stencil couples each point to neighbours of the same
+     * red/black parity, so the sweep is split into eight colors by the
+     * parity of (i,j,k).  Points of one color never neighbour each other,
+     * which makes every color sweep independent of the update order: the
+     * result is identical for any number of threads.  The four red colors
+     * (i+j+k even) go first, and the adjoint sweep visits the colors in
+     * reverse. */
+    for (*iters=1; *iters<=*itmax; (*iters)++) {
+
+        for (ic=0; ic<8; ic++) {
+
+            icolor = (1 - *iadjoint) * ic + (*iadjoint) * (7 - ic);
+            i1 = 2 + color[icolor][0];
+            j1 = 2 + color[icolor][1];
+            k1 = 2 + color[icolor][2];
+
+            #pragma omp parallel for collapse(2) private(i, j, k, tmpO, tmpU, tmpD)
+            for (k=k1; k<=*nz-1; k+=2) {
+
+                for (j=j1; j<=*ny-1; j+=2) {
+
+                    #pragma omp simd private(tmpO, tmpU, tmpD)
+                    for (i=i1; i<=*nx-1; i+=2) {
+
+                        tmpO =
+                             + VAT3(  oN,   i,   j,   k) * VAT3(x,   i, j+1,   k)
+                             + VAT3(  oN,   i, j-1,   k) * VAT3(x,   i, j-1,   k)
+                             + VAT3(  oE,   i,   j,   k) * VAT3(x, i+1,   j,   k)
+                             + VAT3(  oE, i-1,   j,   k) * VAT3(x, i-1,   j,   k)
+                             + VAT3( oNE,   i,   j,   k) * VAT3(x, i+1, j+1,   k)
+                             + VAT3( oNW,   i,   j,   k) * VAT3(x, i-1, j+1,   k)
+                             + VAT3( oNW, i+1, j-1,   k) * VAT3(x, i+1, j-1,   k)
+                             + VAT3( oNE, i-1, j-1,   k) * VAT3(x, i-1, j-1,   k);
+
+                        tmpU =
+                             + VAT3(  uC,   i,   j,   k) * VAT3(x,   i,   j, k+1)
+                             + VAT3(  uN,   i,   j,   k) * VAT3(x,   i, j+1, k+1)
+                             + VAT3(  uS,   i,   j,   k) * VAT3(x,   i, j-1, k+1)
+                             + VAT3(  uE,   i,   j,   k) * VAT3(x, i+1,   j, k+1)
+                             + VAT3(  uW,   i,   j,   k) * VAT3(x, i-1,   j, k+1)
+                             + VAT3( uNE,   i,   j,   k) * VAT3(x, i+1, j+1, k+1)
+                             + VAT3( uNW,   i,   j,   k) * VAT3(x, i-1, j+1, k+1)
+                             + VAT3( uSE,   i,   j,   k) * VAT3(x, i+1, j-1, k+1)
+                             + VAT3( uSW,   i,   j,   k) * VAT3(x, i-1, j-1, k+1);
+
+                        tmpD =
+                             + VAT3(  uC,   i,   j, k-1) * VAT3(x,   i,   j, k-1)
+                             + VAT3(  uS,   i, j+1, k-1) * VAT3(x,   i, j+1, k-1)
+                             + VAT3(  uN,   i, j-1, k-1) * VAT3(x,   i, j-1, k-1)
+                             + VAT3(  uW, i+1,   j, k-1) * VAT3(x, i+1,   j, k-1)
+                             + VAT3(  uE, i-1,   j, k-1) * VAT3(x, i-1,   j, k-1)
+                             + VAT3( uSW, i+1, j+1, k-1) * VAT3(x, i+1, j+1, k-1)
+                             + VAT3( uSE, i-1, j+1, k-1) * VAT3(x, i-1, j+1, k-1)
+                             + VAT3( uNW, i+1, j-1, k-1) * VAT3(x, i+1, j-1, k-1)
+                             + VAT3( uNE, i-1, j-1, k-1) * VAT3(x, i-1, j-1, k-1);
+
+                        VAT3(x, i,j,k) = (VAT3(fc, i, j, k) + (tmpO + tmpU + tmpD))
+                                 / (VAT3(oC, i, j, k) + VAT3(cc, i, j, k));
+                    }
+                }
+            }
+        }
+    }
+
+    // If specified, return the new residual as well
+    if (*iresid == 1)
+        Vmresid27_1sf(nx, ny, nz,
+                     ipc, rpc,
+                      oC,  cc,  fc,
+                      oE,  oN,  uC,
+                     oNE, oNW,
+                     uE,   uW,  uN,  uS,
+                     uNE, uNW, uSE, uSW,
+                       x,   r);
+}
+
+
+
+VPUBLIC void Vmatvec7_1sf(int *nx, int *ny, int *nz,
+        int *ipc, double *rpc,
+        float *oC, float *cc,
+        float *oE, float *oN, float *uC,
+        float  *x, float  *y) {
+
+    int i, j, k;
+
+    MAT3(oE, *nx, *ny, *nz);
+    MAT3(oN, *nx, *ny, *nz);
+    MAT3(uC, *nx, *ny, *nz);
+    MAT3(cc, *nx, *ny, *nz);
+    MAT3(oC, *nx, *ny, *nz);
+    MAT3(x, *nx, *ny, *nz);
+    MAT3(y, *nx, *ny, *nz);
+
+    // Do it
+    #pragma omp parallel for private(i, j, k)
+    for (k=2; k<=*nz-1; k++) {
+        for (j=2; j<=*ny-1; j++) {
+            for(i=2; i<=*nx-1; i++) {
+                VAT3(y, i, j, k) =
+                           - VAT3( oN,   i,   j,   k)                * VAT3(x,   i, j+1,  k)
+                           - VAT3( oN,   i, j-1,   k)                * VAT3(x,   i, j-1,  k)
+                           - VAT3( oE,   i,   j,   k)                * VAT3(x, i+1,   j,  k)
+                           - VAT3( oE, i-1,   j,   k)                * VAT3(x, i-1,   j,  k)
+                           - VAT3( uC,   i,   j, k-1)                * VAT3(x,   i,   j,k-1)
+                           - VAT3( uC,   i,   j,   k)                * VAT3(x,   i,   j,k+1)
+                           + (VAT3(oC,   i,   j,   k) + VAT3(cc, i, j, k)) * VAT3(x,   i,   j,  k);
+            }
+        }
+    }
+}
+
+
+
+VPUBLIC void Vmatvec27_1sf(int *nx, int *ny, int *nz,
+        int    *ipc, double *rpc,
+        float  *oC, float  *cc,
+        float  *oE, float  *oN, float  *uC,
+        float *oNE, float *oNW,
+        float  *uE, float  *uW, float  *uN, float  *uS,
+        float *uNE, float *uNW, float *uSE, float *uSW,
+        float   *x, float   *y) {
+
+    int i, j, k;
+
+    float tmpO, tmpU, tmpD;
+
+    MAT3(cc, *nx, *ny, *nz);
+    MAT3(x, *nx, *ny, *nz);
+    MAT3(y, *nx, *ny, *nz);
+
+    MAT3(oC, *nx, *ny, *nz);
+    MAT3(oE, *nx, *ny, *nz);
+    MAT3(oN, *nx, *ny, *nz);
+    MAT3(oNE, *nx, *ny, *nz);
+    MAT3(oNW, *nx, *ny, *nz);
+
+    MAT3(uC, *nx, *ny, *nz);
+    MAT3(uE, *nx, *ny, *nz);
+    MAT3(uW, *nx, *ny, *nz);
+    MAT3(uN, *nx, *ny, *nz);
+    MAT3(uS, *nx, *ny, *nz);
+    MAT3(uNE, *nx, *ny, *nz);
+    MAT3(uNW, *nx, *ny, *nz);
+    MAT3(uSE, *nx, *ny, *nz);
+    MAT3(uSW, *nx, *ny, *nz);
+
+    // Do it
+    #pragma omp parallel for private(i, j, k, tmpO, tmpU, tmpD)
+    for (k=2; k<=*nz-1; k++) {
+        for (j=2; j<=*ny-1; j++) {
+            for(i=2; i<=*nx-1; i++) {
+                tmpO =
+                     - VAT3(  oN,   i,   j,   k) * VAT3(x,   i, j+1,   k)
+                     - VAT3(  oN,   i, j-1,   k) * VAT3(x,   i, j-1,   k)
+                     - VAT3(  oE,   i,   j,   k) * VAT3(x, i+1,   j,   k)
+                     - VAT3(  oE, i-1,   j,   k) * VAT3(x, i-1,   j,   k)
+                     - VAT3( oNE,   i,   j,   k) * VAT3(x, i+1, j+1,   k)
+                     - VAT3( oNW,   i,   j,   k) * VAT3(x, i-1, j+1,   k)
+                     - VAT3( oNW, i+1, j-1,   k) * VAT3(x, i+1, j-1,   k)
+                     - VAT3( oNE, i-1, j-1,   k) * VAT3(x, i-1, j-1,   k);
+
+                tmpU =
+                     - VAT3(  uC,   i,   j,   k) * VAT3(x,   i,   j, k+1)
+                     - VAT3(  uN,   i,   j,   k) * VAT3(x,   i, j+1, k+1)
+                     - VAT3(  uS,   i,   j,   k) * VAT3(x,   i, j-1, k+1)
+                     - VAT3(  uE,   i,   j,   k) * VAT3(x, i+1,   j, k+1)
+                     - VAT3(  uW,   i,   j,   k) * VAT3(x, i-1,   j, k+1)
+                     - VAT3( uNE,   i,   j,   k) * VAT3(x, i+1, j+1, k+1)
+                     - VAT3( uNW,   i,   j,   k) * VAT3(x, i-1, j+1, k+1)
+                     - VAT3( uSE,   i,   j,   k) * VAT3(x, i+1, j-1, k+1)
+                     - VAT3( uSW,   i,   j,   k) * VAT3(x, i-1, j-1, k+1);
+
+                tmpD =
+                     - VAT3(  uC,   i,   j, k-1) * VAT3(x,   i,   j, k-1)
+                     - VAT3(  uS,   i, j+1, k-1) * VAT3(x,   i, j+1, k-1)
+                     - VAT3(  uN,   i, j-1, k-1) * VAT3(x,   i, j-1, k-1)
+                     - VAT3(  uW, i+1,   j, k-1) * VAT3(x, i+1,   j, k-1)
+                     - VAT3(  uE, i-1,   j, k-1) * VAT3(x, i-1,   j, k-1)
+                     - VAT3( uSW, i+1, j+1, k-1) * VAT3(x, i+1, j+1, k-1)
+                     - VAT3( uSE, i-1, j+1, k-1) * VAT3(x, i-1, j+1, k-1)
+                     - VAT3( uNW, i+1, j-1, k-1) * VAT3(x, i+1, j-1, k-1)
+                     - VAT3( uNE, i-1, j-1, k-1) * VAT3(x, i-1, j-1, k-1);
+
+                VAT3(y, i, j, k) = tmpO + tmpU + tmpD
+                           + (VAT3(oC, i, j, k) + VAT3(cc, i, j, k)) * VAT3(x, i, j, k);
+            }
+        }
+    }
+}
+
+
+
+VPUBLIC void Vmresid7_1sf(int *nx, int *ny, int *nz,
+        int *ipc, double *rpc,
+        float *oC, float *cc, float *fc,
+        float *oE, float *oN, float *uC,
+        float *x, float *r) {
+
+    int i, j, k;
+
+    MAT3(oE, *nx, *ny, *nz);
+    MAT3(oN, *nx, *ny, *nz);
+    MAT3(uC, *nx, *ny, *nz);
+    MAT3(cc, *nx, *ny, *nz);
+    MAT3(fc, *nx, *ny, *nz);
+    MAT3(oC, *nx, *ny, *nz);
+    MAT3(x, *nx, *ny, *nz);
+    MAT3(r, *nx, *ny, *nz);
+
+    // Do it
+    #pragma omp parallel for private(i, j, k)
+    for (k=2; k<=*nz-1; k++) {
+        for (j=2; j<=*ny-1; j++) {
+            for(i=2; i<=*nx-1; i++) {
+                VAT3(r, i,j,k) =  VAT3(fc,   i,   j,   k)
+                         + VAT3( oN,   i,   j,   k)                * VAT3(x,   i, j+1,   k)
+                         + VAT3( oN,   i, j-1,   k)                * VAT3(x,   i, j-1,   k)
+                         + VAT3( oE,   i,   j,   k)                * VAT3(x, i+1,   j,   k)
+                         + VAT3( oE, i-1,   j,   k)                * VAT3(x, i-1,   j,   k)
+                         + VAT3( uC,   i,   j, k-1)                * VAT3(x,   i,   j, k-1)
+                         + VAT3( uC,   i,   j,   k)                * VAT3(x,   i,   j, k+1)
+                         - (VAT3(oC,   i,   j,   k) + VAT3(cc, i, j, k)) * VAT3(x,   i,   j,   k);
+            }
+        }
+    }
+}
+
+
+
+VPUBLIC void Vmresid27_1sf(int *nx, int *ny, int *nz,
+        int *ipc, double *rpc,
+        float  *oC, float  *cc, float  *fc,
+        float  *oE, float  *oN, float  *uC,
+        float *oNE, float *oNW,
+        float  *uE, float  *uW, float  *uN, float  *uS,
+        float *uNE, float *uNW, float *uSE, float *uSW,
+        float *x, float *r) {
+
+    int i, j, k;
+
+    float tmpO, tmpU, tmpD;
+
+    MAT3(cc, *nx, *ny, *nz);
+    MAT3(fc, *nx, *ny, *nz);
+    MAT3(x, *nx, *ny, *nz);
+    MAT3(r, *nx, *ny, *nz);
+
+    MAT3(oC, *nx, *ny, *nz);
+    MAT3(oE, *nx, *ny, *nz);
+    MAT3(oN, *nx, *ny, *nz);
+    MAT3(oNE, *nx, *ny, *nz);
+    MAT3(oNW, *nx, *ny, *nz);
+
+    MAT3(uC, *nx, *ny, *nz);
+    MAT3(uE, *nx, *ny, *nz);
+    MAT3(uW, *nx, *ny, *nz);
+    MAT3(uN, *nx, *ny, *nz);
+    MAT3(uS, *nx, *ny, *nz);
+    MAT3(uNE, *nx, *ny, *nz);
+    MAT3(uNW, *nx, *ny, *nz);
+    MAT3(uSE, *nx, *ny, *nz);
+    MAT3(uSW, *nx, *ny, *nz);
+
+    #pragma omp parallel for private(i, j, k, tmpO, tmpU, tmpD)
+    for (k=2; k<=*nz-1; k++) {
+        for (j=2; j<=*ny-1; j++) {
+            for(i=2; i<=*nx-1; i++) {
+
+                tmpO  =
+                        + VAT3(  oN,   i,   j,   k) * VAT3(x,   i, j+1,   k)
+                        + VAT3(  oN,   i, j-1,   k) * VAT3(x,   i, j-1,   k)
+                        + VAT3(  oE,   i,   j,   k) * VAT3(x, i+1,   j,   k)
+                        + VAT3(  oE, i-1,   j,   k) * VAT3(x, i-1,   j,   k)
+                        + VAT3( oNE,   i,   j,   k) * VAT3(x, i+1, j+1,   k)
+                        + VAT3( oNW,   i,   j,   k) * VAT3(x, i-1, j+1,   k)
+                        + VAT3( oNW, i+1, j-1,   k) * VAT3(x, i+1, j-1,   k)
+                        + VAT3( oNE, i-1, j-1,   k) * VAT3(x, i-1, j-1,   k);
+
+                tmpU =
+                        + VAT3(  uC,   i,   j,   k) * VAT3(x,   i,   j, k+1)
+                        + VAT3(  uN,   i,   j,   k) * VAT3(x,   i, j+1, k+1)
+                        + VAT3(  uS,   i,   j,   k) * VAT3(x,   i, j-1, k+1)
+                        + VAT3(  uE,   i,   j,   k) * VAT3(x, i+1,   j, k+1)
+                        + VAT3(  uW,   i,   j,   k) * VAT3(x, i-1,   j, k+1)
+                        + VAT3( uNE,   i,   j,   k) * VAT3(x, i+1, j+1, k+1)
+                        + VAT3( uNW,   i,   j,   k) * VAT3(x, i-1, j+1, k+1)
+                        + VAT3( uSE,   i,   j,   k) * VAT3(x, i+1, j-1, k+1)
+                        + VAT3( uSW,   i,   j,   k) * VAT3(x, i-1, j-1, k+1);
+
+                tmpD =
+                        + VAT3(  uC,   i,   j, k-1) * VAT3(x,   i,   j, k-1)
+                        + VAT3(  uS,   i, j+1, k-1) * VAT3(x,   i, j+1, k-1)
+                        + VAT3(  uN,   i, j-1, k-1) * VAT3(x,   i, j-1, k-1)
+                        + VAT3(  uW, i+1,   j, k-1) * VAT3(x, i+1,   j, k-1)
+                        + VAT3(  uE, i-1,   j, k-1) * VAT3(x, i-1,   j, k-1)
+                        + VAT3( uSW, i+1, j+1, k-1) * VAT3(x, i+1, j+1, k-1)
+                        + VAT3( uSE, i-1, j+1, k-1) * VAT3(x, i-1, j+1, k-1)
+                        + VAT3( uNW, i+1, j-1, k-1) * VAT3(x, i+1, j-1, k-1)
+                        + VAT3( uNE, i-1, j-1, k-1) * VAT3(x, i-1, j-1, k-1);
+
+                VAT3(r, i, j, k) =  VAT3(fc, i, j, k) + tmpO + tmpU + tmpD
+                           - (VAT3(oC, i, j, k) + VAT3(cc, i, j, k)) * VAT3(x, i, j, k);
+            }
+        }
+    }
+}
+
+
+
+VPUBLIC void Vrestrc2f(int *nxf, int *nyf, int *nzf,
+        int *nxc, int *nyc, int *nzc,
+        float  *xin, float *xout,
+        float  *oPC, float  *oPN, float  *oPS, float  *oPE,  float *oPW,
+        float *oPNE, float *oPNW, float *oPSE, float *oPSW,
+        float  *uPC, float  *uPN, float  *uPS, float  *uPE,  float *uPW,
+        float *uPNE, float *uPNW, float *uPSE, float *uPSW,
+        float  *dPC, float  *dPN, float  *dPS, float  *dPE,  float *dPW,
+        float *dPNE, float *dPNW, float *dPSE, float *dPSW) {
+
+    int  i,  j,  k;
+    int ii, jj, kk;
+
+    float tmpO, tmpU, tmpD;
+
+    MAT3(xin, *nxf, *nyf, *nzf);
+    MAT3(xout, *nxc, *nyc, *nzc);
+
+    MAT3(oPC, *nxc, *nyc, *nzc);
+    MAT3(oPN, *nxc, *nyc, *nzc);
+    MAT3(oPS, *nxc, *nyc, *nzc);
+    MAT3(oPE, *nxc, *nyc, *nzc);
+    MAT3(oPW, *nxc, *nyc, *nzc);
+
+    MAT3(oPNE, *nxc, *nyc, *nzc);
+    MAT3(oPNW, *nxc, *nyc, *nzc);
+    MAT3(oPSE, *nxc, *nyc, *nzc);
+    MAT3(oPSW, *nxc, *nyc, *nzc);
+
+    MAT3(uPC, *nxc, *nyc, *nzc);
+    MAT3(uPN, *nxc, *nyc, *nzc);
+    MAT3(uPS, *nxc, *nyc, *nzc);
+    MAT3(uPE, *nxc, *nyc, *nzc);
+    MAT3(uPW, *nxc, *nyc, *nzc);
+
+    MAT3(uPNE, *nxc, *nyc, *nzc);
+    MAT3(uPNW, *nxc, *nyc, *nzc);
+    MAT3(uPSE, *nxc, *nyc, *nzc);
+    MAT3(uPSW, *nxc, *nyc, *nzc);
+
+    MAT3(dPC, *nxc, *nyc, *nzc);
+    MAT3(dPN, *nxc, *nyc, *nzc);
+    MAT3(dPS, *nxc, *nyc, *nzc);
+    MAT3(dPE, *nxc, *nyc, *nzc);
+    MAT3(dPW, *nxc, *nyc, *nzc);
+
+    MAT3(dPNE, *nxc, *nyc, *nzc);
+    MAT3(dPNW, *nxc, *nyc, *nzc);
+    MAT3(dPSE, *nxc, *nyc, *nzc);
+    MAT3(dPSW, *nxc, *nyc, *nzc);
+
+    // Verify correctness of the input boundary points
+    VfboundPMG00f(nxf, nyf, nzf, xin);
+
+    // Handle the interior points as average of 5 finer grid pts ***
+    #pragma omp parallel for private(k, kk, j, jj, i, ii, tmpO, tmpU, tmpD)
+    for (k=2; k<=*nzc-1; k++) {
+        kk = (k - 1) * 2 + 1;
+
+        for (j=2; j<=*nyc-1; j++) {
+            jj = (j - 1) * 2 + 1;
+
+            for (i=2; i<=*nxc-1; i++) {
+                ii = (i - 1) * 2 + 1;
+
+                // Compute the restriction
+                tmpO =
+                     + VAT3( oPC, i, j, k) * VAT3(xin,   ii,   jj,   kk)
+                     + VAT3( oPN, i, j, k) * VAT3(xin,   ii, jj+1,   kk)
+                     + VAT3( oPS, i, j, k) * VAT3(xin,   ii, jj-1,   kk)
+                     + VAT3( oPE, i, j, k) * VAT3(xin, ii+1,   jj,   kk)
+                     + VAT3( oPW, i, j, k) * VAT3(xin, ii-1,   jj,   kk)
+                     + VAT3(oPNE, i, j, k) * VAT3(xin, ii+1, jj+1,   kk)
+                     + VAT3(oPNW, i, j, k) * VAT3(xin, ii-1, jj+1,   kk)
+                     + VAT3(oPSE, i, j, k) * VAT3(xin, ii+1, jj-1,   kk)
+                     + VAT3(oPSW, i, j, k) * VAT3(xin, ii-1, jj-1,   kk);
+
+                tmpU =
+                     + VAT3( uPC, i, j, k) * VAT3(xin,   ii,   jj, kk+1)
+                     + VAT3( uPN, i, j, k) * VAT3(xin,   ii, jj+1, kk+1)
+                     + VAT3( uPS, i, j, k) * VAT3(xin,   ii, jj-1, kk+1)
+                     + VAT3( uPE, i, j, k) * VAT3(xin, ii+1,   jj, kk+1)
+                     + VAT3( uPW, i, j, k) * VAT3(xin, ii-1,   jj, kk+1)
+                     + VAT3(uPNE, i, j, k) * VAT3(xin, ii+1, jj+1, kk+1)
+                     + VAT3(uPNW, i, j, k) * VAT3(xin, ii-1, jj+1, kk+1)
+                     + VAT3(uPSE, i, j, k) * VAT3(xin, ii+1, jj-1, kk+1)
+                     + VAT3(uPSW, i, j, k) * VAT3(xin, ii-1, jj-1, kk+1);
+
+                tmpD =
+                     + VAT3( dPC, i, j, k) * VAT3(xin,   ii,   jj, kk-1)
+                     + VAT3( dPN, i, j, k) * VAT3(xin,   ii, jj+1, kk-1)
+                     + VAT3( dPS, i, j, k) * VAT3(xin,   ii, jj-1, kk-1)
+                     + VAT3( dPE, i, j, k) * VAT3(xin, ii+1,   jj, kk-1)
+                     + VAT3( dPW, i, j, k) * VAT3(xin, ii-1,   jj, kk-1)
+                     + VAT3(dPNE, i, j, k) * VAT3(xin, ii+1, jj+1, kk-1)
+                     + VAT3(dPNW, i, j, k) * VAT3(xin, ii-1, jj+1, kk-1)
+                     + VAT3(dPSE, i, j, k) * VAT3(xin, ii+1, jj-1, kk-1)
+                     + VAT3(dPSW, i, j, k) * VAT3(xin, ii-1, jj-1, kk-1);
+
+                VAT3(xout, i, j, k) = tmpO + tmpU + tmpD;
+            }
+        }
+    }
+
+    // Verify correctness of the output boundary points
+    VfboundPMG00f(nxc, nyc, nzc, xout);
+}
+
+
+
+VPUBLIC void VinterpPMG2f(int *nxc, int *nyc, int *nzc,
+        int *nxf, int *nyf, int *nzf,
+        float *xin, float *xout,
+        float  *oPC, float  *oPN, float  *oPS, float  *oPE, float  *oPW,
+        float *oPNE, float *oPNW, float *oPSE, float *oPSW,
+        float  *uPC, float  *uPN, float  *uPS, float  *uPE, float  *uPW,
+        float *uPNE, float *uPNW, float *uPSE, float *uPSW,
+        float  *dPC, float  *dPN, float  *dPS, float  *dPE, float  *dPW,
+        float *dPNE, float *dPNW, float *dPSE, float *dPSW) {
+
+    int  i,  j,  k;
+    int ii, jj, kk;
+
+    MAT3( xin, *nxc, *nyc, *nzc);
+    MAT3(xout, *nxf, *nyf, *nzf);
+
+    MAT3( oPC, *nxc, *nyc, *nzc);
+    MAT3( oPN, *nxc, *nyc, *nzc);
+    MAT3( oPS, *nxc, *nyc, *nzc);
+    MAT3( oPE, *nxc, *nyc, *nzc);
+    MAT3( oPW, *nxc, *nyc, *nzc);
+
+    MAT3(oPNE, *nxc, *nyc, *nzc);
+    MAT3(oPNW, *nxc, *nyc, *nzc);
+    MAT3(oPSE, *nxc, *nyc, *nzc);
+    MAT3(oPSW, *nxc, *nyc, *nzc);
+
+    MAT3( uPC, *nxc, *nyc, *nzc);
+    MAT3( uPN, *nxc, *nyc, *nzc);
+    MAT3( uPS, *nxc, *nyc, *nzc);
+    MAT3( uPE, *nxc, *nyc, *nzc);
+    MAT3( uPW, *nxc, *nyc, *nzc);
+
+    MAT3(uPNE, *nxc, *nyc, *nzc);
+    MAT3(uPNW, *nxc, *nyc, *nzc);
+    MAT3(uPSE, *nxc, *nyc, *nzc);
+    MAT3(uPSW, *nxc, *nyc, *nzc);
+
+    MAT3( dPC, *nxc, *nyc, *nzc);
+    MAT3( dPN, *nxc, *nyc, *nzc);
+    MAT3( dPS, *nxc, *nyc, *nzc);
+    MAT3( dPE, *nxc, *nyc, *nzc);
+    MAT3( dPW, *nxc, *nyc, *nzc);
+
+    MAT3(dPNE, *nxc, *nyc, *nzc);
+    MAT3(dPNW, *nxc, *nyc, *nzc);
+    MAT3(dPSE, *nxc, *nyc, *nzc);
+    MAT3(dPSW, *nxc, *nyc, *nzc);
+
+    /* *********************************************************************
+     * Setup
+     * *********************************************************************/
+
+    // Verify correctness of the input boundary points ***
+    VfboundPMG00f(nxc, nyc, nzc, xin);
+
+    // Do it
+    for (k=1; k<=*nzf-2; k+=2) {
+        kk = (k - 1) / 2 + 1;
+
+        for (j=1; j<=*nyf-2; j+=2) {
+            jj = (j - 1) / 2 + 1;
+
+            for (i=1; i<=*nxf-2; i+=2) {
+                ii = (i - 1) / 2 + 1;
+
+                /* ******************************************************** *
+                 * Type 1 -- Fine grid points common to a coarse grid point *
+                 * ******************************************************** */
+
+                // Copy coinciding points from coarse grid to fine grid
+                VAT3(xout, i, j, k) = VAT3(xin, ii, jj, kk);
+
+                /* ******************************************************** *
+                 * type 2 -- fine grid points common to a coarse grid plane *
+                 * ******************************************************** */
+
+                // Fine grid pts common only to y-z planes on coarse grid
+                // (intermediate pts between 2 grid points on x-row)
+                VAT3(xout, i+1, j, k) = VAT3(oPE,   ii, jj, kk) * VAT3(xin,   ii, jj, kk)
+                                + VAT3(oPW, ii+1, jj, kk) * VAT3(xin, ii+1, jj, kk);
+
+                // Fine grid pts common only to x-z planes on coarse grid
+                // (intermediate pts between 2 grid points on a y-row)
+                VAT3(xout, i, j+1, k) = VAT3(oPN, ii,   jj, kk) * VAT3(xin, ii,   jj, kk)
+                                + VAT3(oPS, ii, jj+1, kk) * VAT3(xin, ii, jj+1, kk);
+
+                // Fine grid pts common only to x-y planes on coarse grid
+                // (intermediate pts between 2 grid points on a z-row)
+                VAT3(xout, i, j, k+1) = VAT3(uPC, ii, jj,   kk) * VAT3(xin, ii, jj,   kk)
+                                + VAT3(dPC, ii, jj, kk+1) * VAT3(xin, ii, jj, kk+1);
+
+                /* ******************************************************* *
+                 * type 3 -- fine grid points common to a coarse grid line *
+                 * ******************************************************* */
+
+                // Fine grid pts common only to z planes on coarse grid
+                // (intermediate pts between 4 grid pts on the xy-plane
+
+                VAT3(xout, i+1, j+1, k) = VAT3(oPNE,   ii,   jj, kk) * VAT3(xin,   ii,   jj, kk)
+                                  + VAT3(oPNW, ii+1,   jj, kk) * VAT3(xin, ii+1,   jj, kk)
+                                  + VAT3(oPSE,   ii, jj+1, kk) * VAT3(xin,   ii, jj+1, kk)
+                                  + VAT3(oPSW, ii+1, jj+1, kk) * VAT3(xin, ii+1, jj+1, kk);
+
+                // Fine grid pts common only to y planes on coarse grid
+                // (intermediate pts between 4 grid pts on the xz-plane
+                VAT3(xout, i+1, j, k+1) = VAT3(uPE,   ii, jj,   kk) * VAT3(xin,   ii, jj,   kk)
+                                  + VAT3(uPW, ii+1, jj,   kk) * VAT3(xin, ii+1, jj,   kk)
+                                  + VAT3(dPE,   ii, jj, kk+1) * VAT3(xin,   ii, jj, kk+1)
+                                  + VAT3(dPW, ii+1, jj, kk+1) * VAT3(xin, ii+1, jj, kk+1);
+
+                // Fine grid pts common only to x planes on coarse grid
+                // (intermediate pts between 4 grid pts on the yz-plane***
+                VAT3(xout, i, j+1, k+1) = VAT3(uPN, ii,   jj,  kk) * VAT3(xin, ii,   jj,   kk)
+                                  + VAT3(uPS, ii, jj+1,  kk) * VAT3(xin, ii, jj+1,   kk)
+                                  + VAT3(dPN, ii,   jj,kk+1) * VAT3(xin, ii,   jj, kk+1)
+                                  + VAT3(dPS, ii, jj+1,kk+1) * VAT3(xin, ii, jj+1, kk+1);
+
+                /* **************************************** *
+                 * type 4 -- fine grid points not common to *
+                 *           coarse grid pts/lines/planes   *
+                 * **************************************** */
+
+                // Completely interior points
+                VAT3(xout, i+1,j+1,k+1) =
+                     + VAT3(uPNE,   ii,   jj,   kk) * VAT3(xin,   ii,   jj,   kk)
+                     + VAT3(uPNW, ii+1,   jj,   kk) * VAT3(xin, ii+1,   jj,   kk)
+                     + VAT3(uPSE,   ii, jj+1,   kk) * VAT3(xin,   ii, jj+1,   kk)
+                     + VAT3(uPSW, ii+1, jj+1,   kk) * VAT3(xin, ii+1, jj+1,   kk)
+                     + VAT3(dPNE,   ii,   jj, kk+1) * VAT3(xin,   ii,   jj, kk+1)
+                     + VAT3(dPNW, ii+1,   jj, kk+1) * VAT3(xin, ii+1,   jj, kk+1)
+                     + VAT3(dPSE,   ii, jj+1, kk+1) * VAT3(xin,   ii, jj+1, kk+1)
+                     + VAT3(dPSW, ii+1, jj+1, kk+1) * VAT3(xin, ii+1, jj+1, kk+1);
+            }
+        }
+    }
+
+    // Verify correctness of the output boundary points ***
+    VfboundPMG00f(nxf, nyf, nzf, xout);
+}
+
@@ -0,0 +1,284 @@
+/**
+ *  @ingroup PMGC
+ *  @brief  Single-precision multigrid cycle with double-precision
+ *          defect correction
+ *  @version $Id:
+ *
+ *  @attention
+ *  @verbatim
+ *
+ * APBS -- Adaptive Poisson-Boltzmann Solver
+ *
+ * Nathan A. Baker (nathan.baker@pnl.gov)
+ * Pacific Northwest National Laboratory
+ *
+ * Additional contributing authors listed in the code documentation.
+ *
+ * Copyright (c) 2010-2014 Battelle Memorial Institute. Developed at the Pacific Northwest National Laboratory, operated by Battelle Memorial Institute, Pacific Northwest Division for the U.S. Department Energy.  Portions Copyright (c) 2002-2010, Washington University in St. Louis.  Portions Copyright (c) 2002-2010, Nathan A. Baker.  Portions Copyright (c) 1999-2002, The Regents of the University of California. Portions Copyright (c) 1995, Michael Holst.
+ * All rights reserved.
+ *
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * -  Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * - Neither the name of Washington University in St. Louis nor the names of its
+ * contributors may be used to endorse or promote products derived from this
+ * software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @endverbatim
+ */
+
+#ifndef _MGMIXD_H_
+#define _MGMIXD_H_
+
+#include "apbscfg.h"
+
+#include "maloc/maloc.h"
+
+#include "generic/vhal.h"
+#include "generic/vmatrix.h"
+#include "pmgc/mgsubd.h"
+#include "pmgc/mikpckd.h"
+#include "pmgc/mgcsd.h"
+#include "pmgc/smoothd.h"
+#include "pmgc/mlinpckd.h"
+
+/** @brief   Mixed precision linear multilevel method.
+ *
+ *    Drop-in replacement for Vmvcs for the residual based stopping
+ *    criteria (istop = 0 or 1).  The operator hierarchy is copied to
+ *    single precision once; each iteration then computes the defect
+ *    d = f - A x in double precision, approximately solves A e = d with
+ *    one single precision v-cycle (Vmvcsf), and updates x = x + e in
+ *    double precision.  Since the v-cycle only has to reduce the current
+ *    defect, the iteration converges to the same double precision
+ *    tolerance as Vmvcs while the smoothing, restriction and
+ *    prolongation stream half as many bytes.  Other stopping criteria
+ *    fall back to Vmvcs.
+ *
+ *  @ingroup PMGC
+ *  @note    Arguments are identical to Vmvcs; the single precision copies
+ *           are allocated and freed internally.
+ */
+VEXTERNC void Vmvcsmix(int *nx, int *ny, int *nz,
+        double *x,
+        int *iz,
+        double *w0, double *w1, double *w2, double *w3,
+        int *istop, int *itmax, int *iters, int *ierror,
+        int *nlev, int *ilev, int *nlev_real,
+        int *mgsolv, int *iok, int *iinfo,
+        double *epsiln, double *errtol, double *omega,
+        int *nu1, int *nu2,
+        int *mgsmoo,
+        int *ipc, double *rpc,
+        double *pc, double *ac, double *cc, double *fc, double *tru);
+
+/** @brief   One single precision v-cycle with a zero initial guess.
+ *
+ *    Mirrors a single pass of Vmvcs using the float operator hierarchy
+ *    stored with the same iz offsets as the double precision arrays.
+ *    The coarsest level is solved in double precision with the original
+ *    operator (acd/ccd), using wd as scratch.
+ *
+ *  @ingroup PMGC
+ */
+VEXTERNC void Vmvcsf(int *nx, int *ny, int *nz,
+        float *x,
+        int *iz,
+        float *w0, float *w1, float *w2, float *w3,
+        int *nlev, int *ilev,
+        int *mgsolv,
+        double *epsiln, double *omega,
+        int *nu1, int *nu2,
+        int *ipc, double *rpc,
+        float *pc, float *ac, float *cc, float *fc,
+        double *acd, double *ccd, double *wd);
+
+/** @brief   Single precision red/black gauss-seidel dispatcher.
+ *  @ingroup PMGC
+ *  @note    Float analogue of Vgsrb
+ */
+VEXTERNC void Vgsrbf(int *nx, int *ny, int *nz,
+        int *ipc, double *rpc,
+        float *ac, float *cc, float *fc,
+        float *x, float *w1, float *w2, float *r,
+        int *itmax, int *iters,
+        double *errtol, double *omega,
+        int *iresid, int *iadjoint);
+
+/** @brief   Single precision operator application dispatcher.
+ *  @ingroup PMGC
+ *  @note    Float analogue of Vmatvec
+ */
+VEXTERNC void Vmatvecf(int *nx, int *ny, int *nz,
+        int    *ipc, double *rpc,
+        float  *ac, float  *cc,
+        float   *x, float   *y);
+
+/** @brief   Single precision restriction.
+ *  @ingroup PMGC
+ *  @note    Float analogue of Vrestrc
+ */
+VEXTERNC void Vrestrcf(int *nxf, int *nyf, int *nzf,
+        int *nxc, int *nyc, int *nzc,
+        float *xin, float *xout, float *pc);
+
+/** @brief   Single precision prolongation.
+ *  @ingroup PMGC
+ *  @note    Float analogue of VinterpPMG
+ */
+VEXTERNC void VinterpPMGf(int *nxc, int *nyc, int *nzc,
+        int *nxf, int *nyf, int *nzf,
+        float *xin, float *xout,
+        float *pc);
+
+/** @brief   Zero a single precision grid function.
+ *  @ingroup PMGC
+ */
+VEXTERNC void Vazerosf(int *nx, int *ny, int *nz, float *x);
+
+/** @brief   Copy the interior of a single precision grid function.
+ *  @ingroup PMGC
+ */
+VEXTERNC void Vxcopyf(int *nx, int *ny, int *nz, float *x, float *y);
+
+/** @brief   y = y + alpha * x on the interior of single precision grid functions.
+ *  @ingroup PMGC
+ */
+VEXTERNC void Vxaxpyf(int *nx, int *ny, int *nz,
+        float *alpha, float *x, float *y);
+
+/** @brief   Inner product of single precision grid functions, accumulated
+ *           in double precision.
+ *  @ingroup PMGC
+ */
+VEXTERNC double Vxdotf(int *nx, int *ny, int *nz, float *x, float *y);
+
+/** @brief   Zero the boundary of a single precision grid function.
+ *  @ingroup PMGC
+ *  @note    Float analogue of VfboundPMG00
+ */
+VEXTERNC void VfboundPMG00f(int *nx, int *ny, int *nz, float *x);
+
+/** @brief   Single precision 7-point red/black gauss-seidel.
+ *  @ingroup PMGC
+ *  @note    Float analogue of Vgsrb7x
+ */
+VEXTERNC void Vgsrb7xf(int *nx,int *ny,int *nz,
+        int *ipc, double *rpc,
+        float *oC, float *cc, float *fc,
+        float *oE, float *oN, float *uC,
+        float *x, float *w1, float *w2, float *r,
+        int *itmax, int *iters,
+        double *errtol, double *omega,
+        int *iresid, int *iadjoint);
+
+/** @brief   Single precision 27-point red/black gauss-seidel.
+ *  @ingroup PMGC
+ *  @note    Float analogue of Vgsrb27x
+ */
+VEXTERNC void Vgsrb27xf(int *nx,int *ny,int *nz,
+        int *ipc, double *rpc,
+        float  *oC, float  *cc, float  *fc,
+        float  *oE, float  *oN, float  *uC, float *oNE, float *oNW,
+        float  *uE, float  *uW, float  *uN, float  *uS,
+        float *uNE, float *uNW, float *uSE, float *uSW,
+        float *x, float *w1, float *w2, float *r,
+        int *itmax, int *iters,
+        double *errtol, double *omega,
+        int *iresid, int *iadjoint);
+
+/** @brief   Single precision 7-point operator application.
+ *  @ingroup PMGC
+ *  @note    Float analogue of Vmatvec7_1s
+ */
+VEXTERNC void Vmatvec7_1sf(int *nx, int *ny, int *nz,
+        int *ipc, double *rpc,
+        float *oC, float *cc,
+        float *oE, float *oN, float *uC,
+        float  *x, float  *y);
+
+/** @brief   Single precision 27-point operator application.
+ *  @ingroup PMGC
+ *  @note    Float analogue of Vmatvec27_1s
+ */
+VEXTERNC void Vmatvec27_1sf(int *nx, int *ny, int *nz,
+        int    *ipc, double *rpc,
+        float  *oC, float  *cc,
+        float  *oE, float  *oN, float  *uC,
+        float *oNE, float *oNW,
+        float  *uE, float  *uW, float  *uN, float  *uS,
+        float *uNE, float *uNW, float *uSE, float *uSW,
+        float   *x, float   *y);
+
+/** @brief   Single precision 7-point residual.
+ *  @ingroup PMGC
+ *  @note    Float analogue of Vmresid7_1s
+ */
+VEXTERNC void Vmresid7_1sf(int *nx, int *ny, int *nz,
+        int *ipc, double *rpc,
+        float *oC, float *cc, float *fc,
+        float *oE, float *oN, float *uC,
+        float *x, float *r);
+
+/** @brief   Single precision 27-point residual.
+ *  @ingroup PMGC
+ *  @note    Float analogue of Vmresid27_1s
+ */
+VEXTERNC void Vmresid27_1sf(int *nx, int *ny, int *nz,
+        int *ipc, double *rpc,
+        float  *oC, float  *cc, float  *fc,
+        float  *oE, float  *oN, float  *uC,
+        float *oNE, float *oNW,
+        float  *uE, float  *uW, float  *uN, float  *uS,
+        float *uNE, float *uNW, float *uSE, float *uSW,
+        float *x, float *r);
+
+/** @brief   Single precision restriction kernel.
+ *  @ingroup PMGC
+ *  @note    Float analogue of Vrestrc2
+ */
+VEXTERNC void Vrestrc2f(int *nxf, int *nyf, int *nzf,
+        int *nxc, int *nyc, int *nzc,
+        float  *xin, float *xout,
+        float  *oPC, float  *oPN, float  *oPS, float  *oPE,  float *oPW,
+        float *oPNE, float *oPNW, float *oPSE, float *oPSW,
+        float  *uPC, float  *uPN, float  *uPS, float  *uPE,  float *uPW,
+        float *uPNE, float *uPNW, float *uPSE, float *uPSW,
+        float  *dPC, float  *dPN, float  *dPS, float  *dPE,  float *dPW,
+        float *dPNE, float *dPNW, float *dPSE, float *dPSW);
+
+/** @brief   Single precision prolongation kernel.
+ *  @ingroup PMGC
+ *  @note    Float analogue of VinterpPMG2
+ */
+VEXTERNC void VinterpPMG2f(int *nxc, int *nyc, int *nzc,
+        int *nxf, int *nyf, int *nzf,
+        float *xin, float *xout,
+        float  *oPC, float  *oPN, float  *oPS, float  *oPE, float  *oPW,
+        float *oPNE, float *oPNW, float *oPSE, float *oPSW,
+        float  *uPC, float  *uPN, float  *uPS, float  *uPE, float  *uPW,
+        float *uPNE, float *uPNW, float *uPSE, float *uPSW,
+        float  *dPC, float  *dPN, float  *dPS, float  *dPE, float  *dPW,
+        float *dPNE, float *dPNW, float *dPSE, float *dPSW);
+
+#endif /* _MGMIXD_H_ */
@@ -53,8 +53,8 @@ VPUBLIC void Vbuildops(
         int *nx, int *ny, int *nz,
         int *nlev, int *ipkey, int *iinfo,
         int *ido, int *iz,
-        int *mgprol, int *mgcoar, int *mgsolv, int *mgdisc, int *ipc,
-        double *rpc, double *pc, double *ac, double *cc, double *fc,
+        int *mgprol, int *mgcoar, int *mgsolv, int *mgdisc, int *mgfree,
+        int *ipc, double *rpc, double *pc, double *ac, double *cc, double *fc,
         double *xf, double *yf, double *zf,
         double *gxcf, double *gycf, double *gzcf,
         double *a1cf, double *a2cf, double *a3cf,
@@ -72,6 +72,9 @@ VPUBLIC void Vbuildops(
     int numdia = 0;
     int key = 0;
 
+    // The coarse operators always store their diagonal
+    int mgfreec = 0;
+
     // Utility variables
     int i;
 
@@ -93,7 +96,7 @@ VPUBLIC void Vbuildops(
 
         // Finest level discretization
         VbuildA(&nxx, &nyy, &nzz,
-                ipkey, mgdisc, &numdia,
+                ipkey, mgdisc, mgfree, &numdia,
                  RAT(ipc, VAT2(iz, 5,lev)),  RAT(rpc, VAT2(iz, 6,lev)),
                   RAT(ac, VAT2(iz, 7,lev)),   RAT(cc, VAT2(iz, 1,lev)),   RAT(fc, VAT2(iz,  1,lev)),
                   RAT(xf, VAT2(iz, 8,lev)),   RAT(yf, VAT2(iz, 9,lev)),   RAT(zf, VAT2(iz, 10,lev)),
@@ -155,7 +158,7 @@ VPUBLIC void Vbuildops(
                              RAT(ccf, VAT2(iz, 1,lev-1)),  RAT(fcf, VAT2(iz, 1,lev-1)),  RAT(tcf, VAT2(iz,  1,lev-1)));
 
                     VbuildA(&nxx, &nyy, &nzz,
-                            ipkey, mgdisc, &numdia,
+                            ipkey, mgdisc, &mgfreec, &numdia,
                              RAT(ipc, VAT2(iz, 5,lev)),  RAT(rpc, VAT2(iz, 6,lev)),
                               RAT(ac, VAT2(iz, 7,lev)),   RAT(cc, VAT2(iz, 1,lev)),   RAT(fc, VAT2(iz,  1,lev)),
                               RAT(xf, VAT2(iz, 8,lev)),   RAT(yf, VAT2(iz, 9,lev)),   RAT(zf, VAT2(iz, 10,lev)),
@@ -182,7 +185,7 @@ VPUBLIC void Vbuildops(
                              RAT(ccf, VAT2(iz, 1, lev-1)),  RAT(fcf, VAT2(iz, 1, lev-1)),  RAT(tcf, VAT2(iz,  1, lev-1)));
 
                     VbuildA(&nxx, &nyy, &nzz,
-                            ipkey, mgdisc, &numdia,
+                            ipkey, mgdisc, &mgfreec, &numdia,
                              RAT(ipc, VAT2(iz, 5,lev)),  RAT(rpc, VAT2(iz, 6,lev)),
                               RAT(ac, VAT2(iz, 7,lev)),   RAT(cc, VAT2(iz, 1,lev)),   RAT(fc, VAT2(iz,  1,lev)),
                               RAT(xf, VAT2(iz, 8,lev)),   RAT(yf, VAT2(iz, 9,lev)),   RAT(zf, VAT2(iz, 10,lev)),
@@ -191,7 +194,9 @@ VPUBLIC void Vbuildops(
                              RAT(ccf, VAT2(iz, 1,lev)),  RAT(fcf, VAT2(iz, 1,lev)));
                 }
 
-                // Differential operator with galerkin formulation ***
+                /* Differential operator with galerkin formulation.  A fine
+                 * operator without its diagonal has it formed in a1cf,
+                 * which is only workspace once that operator is built */
                 else if (*mgcoar == 2) {
 
                     // Some i/o
@@ -204,6 +209,7 @@ VPUBLIC void Vbuildops(
                              RAT(pc, VAT2(iz, 11,lev-1)),
                             RAT(ipc, VAT2(iz,  5,lev-1)), RAT(rpc, VAT2(iz, 6,lev-1)),
                              RAT(ac, VAT2(iz,  7,lev-1)),  RAT(cc, VAT2(iz, 1,lev-1)), RAT(fc, VAT2(iz, 1,lev-1)),
+                            RAT(a1cf, VAT2(iz, 1,lev-1)),
                             RAT(ipc, VAT2(iz,  5,lev  )), RAT(rpc, VAT2(iz, 6,lev  )),
                              RAT(ac, VAT2(iz,  7,lev  )),  RAT(cc, VAT2(iz, 1,lev  )), RAT(fc, VAT2(iz, 1,lev  )));
 
@@ -243,6 +249,55 @@ VPUBLIC void Vbuildops(
                 VERRMSG0("Changing your mgsolv to iterative");
                 *mgsolv = 0;
             }
+        } else if (*mgsolv == 2) {
+            lev = *nlev;
+
+            Vbuildsparse(&key, &nxx, &nyy, &nzz,
+                    RAT(ipc, VAT2(iz, 5,lev  )), RAT(rpc, VAT2(iz, 6,lev  )), RAT(ac, VAT2(iz, 7,lev  )),
+                    RAT(cc, VAT2(iz, 1,lev  )),
+                    RAT(ipc, VAT2(iz, 5,lev+1)), RAT(rpc, VAT2(iz, 6,lev+1)), RAT(ac, VAT2(iz, 7,lev+1)));
+
+            if (key == 1) {
+                VERRMSG0("Changing your mgsolv to iterative");
+                *mgsolv = 0;
+            }
+        }
+    }
+
+    /* Reuse the coarse operators, prolongations and coarsest level factor
+     * left by an earlier build, and only carry the new fine level helmholtz
+     * term, source function and true solution down the levels */
+    if (*ido == 4) {
+
+        for (lev=2; lev<=*nlev; lev++) {
+            nxold = nxx;
+            nyold = nyy;
+            nzold = nzz;
+            i = 1;
+
+            Vmkcors(&i, &nxold, &nyold, &nzold, &nxx, &nyy, &nzz);
+
+            // Some i/o
+            if (*iinfo > 0)
+                VMESSAGE3("Reuse: (%03d, %03d, %03d)", nxx, nyy, nzz);
+
+            Vrestrc(&nxold, &nyold, &nzold,
+                    &nxx, &nyy, &nzz,
+                    RAT(cc, VAT2(iz, 1,lev-1)), RAT(cc, VAT2(iz, 1,lev)),
+                    RAT(pc, VAT2(iz, 11,lev-1)));
+
+            Vrestrc(&nxold, &nyold, &nzold,
+                    &nxx, &nyy, &nzz,
+                    RAT(fc, VAT2(iz, 1,lev-1)), RAT(fc, VAT2(iz, 1,lev)),
+                    RAT(pc, VAT2(iz, 11,lev-1)));
+
+            Vextrac(&nxold, &nyold, &nzold,
+                    &nxx, &nyy, &nzz,
+                    RAT(tcf, VAT2(iz, 1,lev-1)), RAT(tcf, VAT2(iz, 1,lev)));
+
+            // Restore the operator offset from the stored stencil size
+            numdia = (VAT(ipc, VAT2(iz, 5,lev) + 10) + 1) / 2;
+            VAT2(iz, 7, lev+1) = VAT2(iz, 7,lev) + numdia * nxx * nyy * nzz;
         }
     }
 }
@@ -337,7 +392,7 @@ VPUBLIC void Vbuildgaler0(int *nxf, int *nyf, int *nzf,
         int *nxc, int *nyc, int *nzc,
         int *ipkey, int *numdia,
         double *pcFF, int   *ipcFF, double *rpcFF,
-        double *acFF, double *ccFF, double *fcFF,
+        double *acFF, double *ccFF, double *fcFF, double *wkFF,
         int *ipc, double *rpc,
         double *ac, double *cc, double *fc) {
 
@@ -348,10 +403,13 @@ VPUBLIC void Vbuildgaler0(int *nxf, int *nyf, int *nzf,
     VbuildG(nxf, nyf, nzf,
             nxc, nyc, nzc,
             &numdia_loc,
-            pcFF, acFF, ac);
+            pcFF, acFF, (VAT(ipcFF, 13) == 1) ? wkFF : VNULL, ac);
 
     // Note how many nonzeros in this new discretization stencil
     VAT(ipc, 11) = 27;
+    VAT(ipc, 13) = 0;
+    VAT(ipc, 14) = 0;
+    VAT(ipc, 15) = 0;
     *numdia = 14;
 
     // Save the problem key with this new operator
@@ -369,6 +427,63 @@ VPUBLIC void Vbuildgaler0(int *nxf, int *nyf, int *nzf,
 
 
 
+/* Murmur3 finalizer: spreads every input bit over the whole word */
+VPRIVATE unsigned int Vmixkey(unsigned int h) {
+    h ^= h >> 16;
+    h *= 0x85ebca6bU;
+    h ^= h >> 13;
+    h *= 0xc2b2ae35U;
+    h ^= h >> 16;
+    return h;
+}
+
+VPUBLIC void Vbuildkey(int *nx, int *ny, int *nz,
+        int *nlev, int *ipkey, int *mgprol, int *mgdisc,
+        double *xf, double *yf, double *zf,
+        double *a1cf, double *a2cf, double *a3cf, double *ccf,
+        int *key) {
+
+    double *arr[7];
+    int len[7], iarr, i, n, w, nwrd;
+    unsigned int h0, h1, pos, word[sizeof(double)/sizeof(unsigned int)];
+
+    n = *nx * *ny * *nz;
+    arr[0] = xf;    len[0] = *nx;
+    arr[1] = yf;    len[1] = *ny;
+    arr[2] = zf;    len[2] = *nz;
+    arr[3] = a1cf;  len[3] = n;
+    arr[4] = a2cf;  len[4] = n;
+    arr[5] = a3cf;  len[5] = n;
+    arr[6] = ccf;   len[6] = n;
+    nwrd = sizeof(double)/sizeof(unsigned int);
+
+    // The parameters that shape the operators
+    h0 = Vmixkey((unsigned int)(*nx) ^ Vmixkey((unsigned int)(*ny)
+        ^ Vmixkey((unsigned int)(*nz) ^ Vmixkey((unsigned int)(*nlev)))));
+    h1 = Vmixkey((unsigned int)(*ipkey) ^ Vmixkey((unsigned int)(*mgprol)
+        ^ Vmixkey((unsigned int)(*mgdisc))));
+
+    /* Sum a mix of each word of the coefficients with its position, so
+     * the points can be visited in any order */
+    for (iarr=0; iarr<7; iarr++) {
+        #pragma omp parallel for private(i, w, pos, word) reduction(+:h0,h1)
+        for (i=0; i<len[iarr]; i++) {
+            memcpy(word, &(arr[iarr][i]), sizeof(double));
+            for (w=0; w<nwrd; w++) {
+                pos = (unsigned int)(nwrd*i + w) + 0x61c88647U*iarr;
+                h0 += Vmixkey(word[w] ^ (0x9e3779b9U*pos));
+                h1 += Vmixkey(word[w] ^ (0x7f4a7c15U*pos + 0x165667b1U));
+            }
+        }
+    }
+
+    // Keep 31 bits of each half so that they fit in an int
+    key[0] = (int)(h0 & 0x7fffffffU);
+    key[1] = (int)(h1 & 0x7fffffffU);
+}
+
+
+
 VPUBLIC void Vmkcors(int *numlev,
         int *nxold, int *nyold, int *nzold,
         int *nxnew, int *nynew, int *nznew) {
@@ -551,7 +666,8 @@ VPUBLIC void Vpackmg(int *iparm, double *rparm, size_t *nrwk, int *niwk,
         int *nx, int *ny, int *nz, int *nlev, int *nu1, int *nu2, int *mgkey,
         int *itmax, int *istop, int *ipcon, int *nonlin, int *mgsmoo, int *mgprol,
         int *mgcoar, int *mgsolv, int *mgdisc, int *iinfo, double *errtol,
-        int *ipkey, double *omegal, double *omegan, int *irite, int *iperf) {
+        int *ipkey, double *omegal, double *omegan, int *irite, int *iperf,
+        int *mgprec, int *mgcach, int *mgfree) {
 
     /// @todo  Convert this into a struct
 
@@ -578,11 +694,28 @@ VPUBLIC void Vpackmg(int *iparm, double *rparm, size_t *nrwk, int *niwk,
     VAT(iparm, 20) = *mgsmoo;
     VAT(iparm, 21) = *mgsolv;
     VAT(iparm, 22) = *iperf;
+    VAT(iparm, 23) = *mgprec;
+    VAT(iparm, 24) = *mgcach;
+    VAT(iparm, 28) = *mgfree;
+
+    // No operators are cached yet; see Vmgdriv2 for iparm(25-27)
+    VAT(iparm, 25) = 0;
+
+    // The drivers return the iterations of the last solve in iparm(29)
+    VAT(iparm, 29) = 0;
+
+    /* The drivers start from a zero guess unless iparm(30) is 1, in which
+     * case the interior of u is the initial guess (see Vpmg_update) */
+    VAT(iparm, 30) = 0;
 
     // Encode rparm parameters
     VAT(rparm, 1)  = *errtol;
     VAT(rparm, 9)  = *omegal;
     VAT(rparm, 10) = *omegan;
+
+    /* The drivers return the relative residual of the initial guess in
+     * rparm(11); a zero guess has 1 */
+    VAT(rparm, 11) = 1.0;
 }
 
 
@@ -952,3 +1085,63 @@ VPUBLIC void Vbuildalg(int *nx, int *ny, int *nz,
         }
     }
 }
+
+
+
+VPUBLIC void Vbuildnlidx(int *nx, int *ny, int *nz,
+        int *nlev, int *iz, int *ipc, double *cc, int *idx) {
+
+    int   nxx,   nyy,   nzz;
+    int nxold, nyold, nzold;
+    int lev, numlev, k_idx;
+
+    MAT2(iz, 50, *nlev);
+
+    nxx = *nx;
+    nyy = *ny;
+    nzz = *nz;
+
+    // Each level needs at most one more entry than it has points
+    k_idx = 1;
+    for (lev=1; lev<=*nlev; lev++) {
+        if (lev > 1) {
+            nxold = nxx;
+            nyold = nyy;
+            nzold = nzz;
+
+            numlev = 1;
+            Vmkcors(&numlev, &nxold, &nyold, &nzold, &nxx, &nyy, &nzz);
+        }
+
+        Vc_vecindex(&nxx, &nyy, &nzz,
+                RAT(ipc, VAT2(iz, 5, lev)), RAT(cc, VAT2(iz, 1, lev)),
+                RAT(idx, k_idx));
+        k_idx += nxx * nyy * nzz + 1;
+    }
+}
+
+
+
+VPUBLIC double Vguessres(int *nx, int *ny, int *nz, int *nonlin,
+        int *ipc, double *rpc, double *ac, double *cc, double *fc,
+        double *x, double *w1, double *w2, double *w3) {
+
+    double rsden, rsnrm;
+
+    if (*nonlin == 0) {
+        rsden = Vxnrm1(nx, ny, nz, fc);
+        Vmresid(nx, ny, nz, ipc, rpc, ac, cc, fc, x, w1);
+    } else {
+        // Zero guess residual, as in the istop=1 test of Vnewton
+        Vazeros(nx, ny, nz, w1);
+        Vnmresid(nx, ny, nz, ipc, rpc, ac, cc, fc, w1, w2, w3);
+        rsden = Vxnrm1(nx, ny, nz, w2);
+        Vnmresid(nx, ny, nz, ipc, rpc, ac, cc, fc, x, w1, w3);
+    }
+    rsnrm = Vxnrm1(nx, ny, nz, w1);
+
+    if (rsden == 0.0) {
+        return 1.0;
+    }
+    return rsnrm / rsden;
+}
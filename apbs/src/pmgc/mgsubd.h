@@ -60,6 +60,7 @@
 #include "pmgc/buildAd.h"
 #include "pmgc/buildPd.h"
 #include "pmgc/buildBd.h"
+#include "pmgc/buildSd.h"
 #include "pmgc/buildGd.h"
 
 #define HARMO2(a, b)                   (2.0 * (a) * (b) / ((a) + (b)))
@@ -74,6 +75,9 @@
  *             ido==1: do only coarse levels (including second op at coarsest)
  *             ido==2: do all levels
  *             ido==3: rebuild the second operator at the coarsest level
+ *             ido==4: reuse the coarse operators (Galerkin coarsening
+ *                     only) and just restrict the helmholtz term, source
+ *                     function and true solution to the coarse levels
  *
  *  @note    The fine level must be build before any coarse levels.
  *  @ingroup PMGC
@@ -94,6 +98,7 @@ VEXTERNC void Vbuildops(
         int    *mgcoar, ///< @todo: doc
         int    *mgsolv, ///< @todo: doc
         int    *mgdisc, ///< @todo: doc
+        int    *mgfree, ///< 1 to store the fine operator as its face weights
         int    *ipc,    ///< @todo: doc
         double *rpc,    ///< @todo: doc
         double *pc,     ///< @todo: doc
@@ -164,6 +169,8 @@ VEXTERNC void Vbuildgaler0(
         double *acFF,   ///< @todo: doc
         double *ccFF,   ///< @todo: doc
         double *fcFF,   ///< @todo: doc
+        double *wkFF,   ///< Work array on the fine level, used if the fine
+                        ///< operator is stored as its face weights
         int    *ipc,    ///< @todo: doc
         double *rpc,    ///< @todo: doc
         double *ac,     ///< @todo: doc
@@ -171,6 +178,32 @@ VEXTERNC void Vbuildgaler0(
         double *fc      ///< @todo: doc
         );
 
+/** @brief   Compute a key for the operators built from the given fine grid
+ *           coefficients, so that a later solve can tell whether it may
+ *           reuse them
+ *  @note    The key is a 62-bit hash of the grid, the operator options and
+ *           every bit of a1cf, a2cf, a3cf and ccf on the fine level.  The
+ *           source function and true solution do not enter it.
+ *  @ingroup PMGC
+ */
+VEXTERNC void Vbuildkey(
+        int *nx,      ///< Number of grid points in x
+        int *ny,      ///< Number of grid points in y
+        int *nz,      ///< Number of grid points in z
+        int *nlev,    ///< Number of multigrid levels
+        int *ipkey,   ///< Problem key
+        int *mgprol,  ///< Prolongation method
+        int *mgdisc,  ///< Discretization method
+        double *xf,   ///< Grid x coordinates
+        double *yf,   ///< Grid y coordinates
+        double *zf,   ///< Grid z coordinates
+        double *a1cf, ///< Fine x-direction diffusion coefficient
+        double *a2cf, ///< Fine y-direction diffusion coefficient
+        double *a3cf, ///< Fine z-direction diffusion coefficient
+        double *ccf,  ///< Fine helmholtz coefficient
+        int *key      ///< Set to the two 31-bit halves of the key
+        );
+
 
 
 /** @brief   Coarsen a grid
@@ -304,7 +337,10 @@ VEXTERNC void Vpackmg(
         double *omegal,
         double *omegan,
         int *irite,
-        int *iperf
+        int *iperf,
+        int *mgprec,
+        int *mgcach,
+        int *mgfree
         );
 
 
@@ -411,6 +447,47 @@ VEXTERNC void Vbuildalg(
         double  *tmp  ///< @todo  Document
 );
 
+/** @brief   Index the points of each level where the nonlinear term is
+ *           nonzero
+ *  @ingroup PMGC
+ *  @note    Calls Vc_vecindex on every level, so that Vc_vecjac skips the
+ *           points that are not ion-accessible.  idx needs narr+nlev
+ *           entries.  The index must be rebuilt whenever cc changes.
+ */
+VEXTERNC void Vbuildnlidx(
+        int  *nx,   ///< Fine grid x dimension
+        int  *ny,   ///< Fine grid y dimension
+        int  *nz,   ///< Fine grid z dimension
+        int  *nlev, ///< Number of levels
+        int  *iz,   ///< Level offsets
+        int  *ipc,  ///< Integer info of all levels
+        double *cc, ///< Helmholtz term of all levels
+        int  *idx   ///< The index of all levels
+);
+
+/** @brief   Residual of an initial guess relative to that of a zero guess
+ *  @ingroup PMGC
+ *  @note    Returns ||f - A(x)|| / ||f - A(0)|| in the 1-norm, which is the
+ *           relative residual the istop=1 stopping test starts from.  The
+ *           nonlinear residual is used if nonlin is not 0.  x must have
+ *           zero boundary values.
+ */
+VEXTERNC double Vguessres(
+        int  *nx,     ///< Grid x dimension
+        int  *ny,     ///< Grid y dimension
+        int  *nz,     ///< Grid z dimension
+        int  *nonlin, ///< Use the nonlinear residual if not 0
+        int  *ipc,    ///< Integer info of the operator
+        double *rpc,  ///< Real info of the operator
+        double *ac,   ///< The operator
+        double *cc,   ///< Helmholtz term
+        double *fc,   ///< Source function
+        double *x,    ///< Initial guess
+        double *w1,   ///< Work array
+        double *w2,   ///< Work array (nonlinear only)
+        double *w3    ///< Work array (nonlinear only)
+);
+
 
 
 #endif // _MGSUBD_H_
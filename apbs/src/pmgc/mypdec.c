@@ -541,3 +541,216 @@ VPUBLIC void Vdc_vecsmpbe(double *coef, double *uin, double *uout,
     if (ichopped > 0)
         Vnm_print(2, "Vdc_vecsmpbe: trapped exp overflows: %d\n", ichopped);
 }
+
+
+
+VPUBLIC void Vc_vecindex(int *nx, int *ny, int *nz, int *ipc,
+        double *coef, int *idx) {
+
+    int n, i, nrun;
+
+    n = *nx * *ny * *nz;
+
+    // Split the runs of nonzero coefficients into blocks of VNLBLOCK points
+    nrun = 0;
+    i = 1;
+    while (i <= n) {
+        if (VAT(coef, i) != 0.0) {
+            nrun++;
+            VAT(idx, 2*nrun-1) = i;
+            while ((i < n) && (VAT(coef, i+1) != 0.0)
+                    && (i - VAT(idx, 2*nrun-1) + 1 < VNLBLOCK)) {
+                i++;
+            }
+            VAT(idx, 2*nrun) = i;
+        }
+        i++;
+    }
+
+    VAT(ipc, 14) = nrun;
+    VAT(ipc, 15) = (int)(idx - ipc) + 1;
+}
+
+
+
+/* exp() of the chopped arguments, |x| <= SINH_MAX, without branches or
+ * calls so that the loop over a run vectorizes.  The scaling 2^k is formed
+ * from the bits of x*log2(e) shifted by 1.5*2^52 and the remainder is a
+ * Taylor polynomial on |r| <= log(2)/2; the error is about one ulp. */
+VPRIVATE double Vexp_chopped(double x) {
+
+    const double shift = 6755399441055744.0;
+    const double log2e = 1.4426950408889634;
+    const double ln2hi = 6.93147180369123816490e-01;
+    const double ln2lo = 1.90821492927058770002e-10;
+
+    double kd, r, p, s;
+    uint64_t k;
+
+    kd = x * log2e + shift;
+    memcpy(&k, &kd, sizeof(double));
+    kd = kd - shift;
+    r = (x - kd * ln2hi) - kd * ln2lo;
+
+    p = 1.0 / 6227020800.0;
+    p = 1.0 / 479001600.0 + r * p;
+    p = 1.0 / 39916800.0 + r * p;
+    p = 1.0 / 3628800.0 + r * p;
+    p = 1.0 / 362880.0 + r * p;
+    p = 1.0 / 40320.0 + r * p;
+    p = 1.0 / 5040.0 + r * p;
+    p = 1.0 / 720.0 + r * p;
+    p = 1.0 / 120.0 + r * p;
+    p = 1.0 / 24.0 + r * p;
+    p = 1.0 / 6.0 + r * p;
+    p = 0.5 + r * p;
+    p = 1.0 + r * p;
+    p = 1.0 + r * p;
+
+    // The low bits of k hold the rounded exponent in two's complement; the
+    // unsigned arithmetic wraps the high bits away without overflow
+    k = (k + 1023) << 52;
+    memcpy(&s, &k, sizeof(double));
+
+    return p * s;
+}
+
+
+
+VPUBLIC void Vc_vecjac(int *nx, int *ny, int *nz, int *ipc,
+        double *coef, double *uin, double *uout, double *duout) {
+
+    int n, i, m, len, nrun, irun, iion, ipkey;
+    int first, last, ichop;
+    int *idx;
+
+    double zcf2, zdc2, zu2;
+    double am_zero, am_zerod, am_neg, am_pos, fac;
+    double arg[VNLBLOCK], argd[VNLBLOCK], ex[VNLBLOCK];
+
+    int ichopped[MAXIONS], ichoppedd[MAXIONS];
+    int lchopped[MAXIONS], lchoppedd[MAXIONS];
+
+    n = *nx * *ny * *nz;
+    ipkey = VAT(ipc, 10);
+
+    // Only the full exponential model has the fused kernel
+    if (ipkey != 0) {
+        if (uout != VNULL)
+            Vc_vec(coef, uin, uout, nx, ny, nz, &ipkey);
+        if (duout != VNULL)
+            Vdc_vec(coef, uin, duout, nx, ny, nz, &ipkey);
+        return;
+    }
+
+    // Runs of ion-accessible points, or blocks of all points without index
+    if (VAT(ipc, 15) != 0) {
+        idx  = RAT(ipc, VAT(ipc, 15));
+        nrun = VAT(ipc, 14);
+    } else {
+        idx  = VNULL;
+        nrun = (n + VNLBLOCK - 1) / VNLBLOCK;
+    }
+
+    for (iion=1; iion<=nion; iion++) {
+        VAT(ichopped, iion)  = 0;
+        VAT(ichoppedd, iion) = 0;
+    }
+
+    #pragma omp parallel default(shared) \
+        private(i, m, len, irun, iion, first, last, ichop, \
+                zcf2, zdc2, zu2, am_zero, am_zerod, am_neg, am_pos, fac, \
+                arg, argd, ex, lchopped, lchoppedd)
+    {
+        #pragma omp for
+        for (i=1; i<=n; i++) {
+            if (uout != VNULL)
+                VAT(uout, i) = 0.0;
+            if (duout != VNULL)
+                VAT(duout, i) = 0.0;
+        }
+
+        for (iion=1; iion<=nion; iion++) {
+            VAT(lchopped, iion)  = 0;
+            VAT(lchoppedd, iion) = 0;
+        }
+
+        #pragma omp for schedule(dynamic, 16)
+        for (irun=1; irun<=nrun; irun++) {
+
+            if (idx != VNULL) {
+                first = VAT(idx, 2*irun-1);
+                last  = VAT(idx, 2*irun);
+            } else {
+                first = (irun - 1) * VNLBLOCK + 1;
+                last  = VMIN2(irun * VNLBLOCK, n);
+            }
+            len = last - first + 1;
+
+            for (iion=1; iion<=nion; iion++) {
+
+                // The coefficients of the term and of its derivative
+                zcf2 = -1.0 * VAT(sconc, iion) * VAT(charge, iion);
+                zdc2 = VAT(sconc, iion) * VAT(charge, iion) * VAT(charge, iion);
+                zu2  = -1.0 * VAT(charge, iion);
+
+                // Chopped arguments, exactly as in Vc_vecpmg and Vdc_vecpmg
+                for (m=0; m<len; m++) {
+                    i = first + m;
+
+                    am_zero  = VMIN2(ZSMALL, VABS(zcf2 * VAT(coef, i))) * ZLARGE;
+                    am_zerod = VMIN2(ZSMALL, VABS(zdc2 * VAT(coef, i))) * ZLARGE;
+                    am_neg = VMAX2(VMIN2(zu2 * VAT(uin, i), 0.0), SINH_MIN);
+                    am_pos = VMIN2(VMAX2(zu2 * VAT(uin, i), 0.0), SINH_MAX);
+
+                    arg[m]  = am_zero  * (am_neg + am_pos);
+                    argd[m] = am_zerod * (am_neg + am_pos);
+
+                    ichop = (int)(am_neg / SINH_MIN) + (int)(am_pos / SINH_MAX);
+                    VAT(lchopped, iion)  += (int)floor(am_zero + 0.5) * ichop;
+                    VAT(lchoppedd, iion) += (int)floor(am_zerod + 0.5) * ichop;
+                }
+
+                if (uout == VNULL) {
+                    for (m=0; m<len; m++)
+                        arg[m] = argd[m];
+                }
+
+                #pragma omp simd
+                for (m=0; m<len; m++) {
+                    ex[m] = Vexp_chopped(arg[m]);
+                }
+
+                // The arguments differ only for vanishing coefficients
+                for (m=0; m<len; m++) {
+                    i = first + m;
+                    if (uout != VNULL) {
+                        VAT(uout, i) += zcf2 * VAT(coef, i) * ex[m];
+                    }
+                    if (duout != VNULL) {
+                        fac = (argd[m] == arg[m]) ? ex[m] : exp(argd[m]);
+                        VAT(duout, i) += zdc2 * VAT(coef, i) * fac;
+                    }
+                }
+            }
+        }
+
+        #pragma omp critical (Vc_vecjac)
+        {
+            for (iion=1; iion<=nion; iion++) {
+                VAT(ichopped, iion)  += VAT(lchopped, iion);
+                VAT(ichoppedd, iion) += VAT(lchoppedd, iion);
+            }
+        }
+    }
+
+    // Info
+    for (iion=1; iion<=nion; iion++) {
+        if ((uout != VNULL) && (VAT(ichopped, iion) > 0))
+            Vnm_print(2, "Vc_vecpmg: trapped exp overflows: %d\n",
+                    VAT(ichopped, iion));
+        if ((duout != VNULL) && (VAT(ichoppedd, iion) > 0))
+            Vnm_print(2, "Vdc_vec: trapped exp overflows: %d\n",
+                    VAT(ichoppedd, iion));
+    }
+}
@@ -51,6 +51,8 @@
 #define _MYPDE_H_
 
 #include "math.h"
+#include <stdint.h>
+#include <string.h>
 
 #include "apbscfg.h"
 
@@ -65,6 +67,7 @@
 #define ZLARGE     1.0e20
 #define SINH_MIN -85.0
 #define SINH_MAX  85.0
+#define VNLBLOCK  256
 
 /// @todo  Remove dependencies on global variables
 double v1, v2, v3, conc1, conc2, conc3, vol, relSize;
@@ -220,4 +223,42 @@ VEXTERNC void Vc_vecsmpbe(
         int *ipkey    ///< @todo: Doc
         );
 
+/** @brief   Build the index of the points where the nonlinear term is
+ *           nonzero, for use by Vc_vecjac
+ *  @ingroup PMGC
+ *
+ *  The points with a nonzero coefficient are stored as runs of consecutive
+ *  points, (first, last) in pairs, each at most VNLBLOCK long.  There are at
+ *  most (n+1)/2 runs, so idx needs n+1 entries.  The number of runs is kept
+ *  in ipc(14) and the position of idx relative to ipc in ipc(15).
+ */
+VEXTERNC void Vc_vecindex(
+        int    *nx,   ///< Grid x dimension
+        int    *ny,   ///< Grid y dimension
+        int    *nz,   ///< Grid z dimension
+        int    *ipc,  ///< Integer info of the level; ipc(14-15) are set
+        double *coef, ///< Coefficient of the nonlinear term
+        int    *idx   ///< The index (n+1 entries, in the integer work array)
+        );
+
+/** @brief   Define the nonlinearity and its derivative in one pass
+ *  @ingroup PMGC
+ *
+ *  Gives the same values as Vc_vec and Vdc_vec, but evaluates each
+ *  exponential once for both and for all ion species, only at the points
+ *  listed by Vc_vecindex (all points if ipc(15) is 0).  The exponentials
+ *  of a run are evaluated in a loop the compiler can vectorize.  The
+ *  trapped overflows are counted and reported as by Vc_vec and Vdc_vec.
+ */
+VEXTERNC void Vc_vecjac(
+        int    *nx,    ///< Grid x dimension
+        int    *ny,    ///< Grid y dimension
+        int    *nz,    ///< Grid z dimension
+        int    *ipc,   ///< Integer info of the level; ipc(10) is the ipkey
+        double *coef,  ///< Coefficient of the nonlinear term
+        double *uin,   ///< Current solution
+        double *uout,  ///< The nonlinear term, or VNULL
+        double *duout  ///< Its derivative, or VNULL
+        );
+
 #endif /* _MYPDE_H_ */
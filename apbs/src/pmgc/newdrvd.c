@@ -83,10 +83,12 @@ VEXTERNC void Vnewdriv(
     int mgcoar; /// @todo: Doc
     int mgdisc; /// @todo: Doc
     int mgsolv; /// @todo: Doc
+    int mgfree; /// @todo: Doc
     int k_iz;   /// @todo: Doc
     int k_w1;   /// @todo: Doc
     int k_w2;   /// @todo: Doc
     int k_ipc;  /// @todo: Doc
+    int k_idx;  /// @todo: Doc
     int k_rpc;  /// @todo: Doc
     int k_ac;   /// @todo: Doc
     int k_cc;   /// @todo: Doc
@@ -115,8 +117,9 @@ VEXTERNC void Vnewdriv(
     mgcoar = VAT(iparm, 18);
     mgdisc = VAT(iparm, 19);
     mgsolv = VAT(iparm, 21);
+    mgfree = 0;
 
-    Vmgsz(&mgcoar, &mgdisc, &mgsolv,
+    Vmgsz(&mgcoar, &mgdisc, &mgsolv, &mgfree,
             &nx, &ny, &nz,
             &nlev,
             &nxc, &nyc, &nzc,
@@ -128,6 +131,9 @@ VEXTERNC void Vnewdriv(
     // Allocate space for two additional work vectors ***
     iretot = iretot + 2 * nf;
 
+    // And for the index of the ion-accessible points on each level
+    iintot = iintot + narr + nlev;
+
     // Some more checks on input
     VASSERT_MSG1( nrwk >= iretot, "Real work space must be: %d", iretot );
     VASSERT_MSG1( niwk >= iintot, "Integer work space must be: %d", iintot );
@@ -135,6 +141,7 @@ VEXTERNC void Vnewdriv(
     // Split up the integer work array
     k_iz   = 1;
     k_ipc  = k_iz   + n_iz;
+    k_idx  = k_ipc  + n_ipc;
 
     // Split up the real work array
     k_rpc  = 1;
@@ -151,6 +158,7 @@ VEXTERNC void Vnewdriv(
             &nx, &ny, &nz,
             u, RAT(iwork, k_iz),
             RAT(rwork, k_w1),  RAT(rwork, k_w2),
+            VNULL, VNULL, VNULL, RAT(iwork, k_idx),
             RAT(iwork, k_ipc), RAT(rwork, k_rpc),
             RAT(rwork, k_pc),  RAT(rwork, k_ac), RAT(rwork, k_cc), RAT(rwork, k_fc),
             xf, yf, zf,
@@ -165,6 +173,7 @@ VPUBLIC void Vnewdriv2(int *iparm, double *rparm,
         int *nx, int *ny, int *nz,
         double *u, int *iz,
         double *w1, double *w2,
+        double *zcg, double *pcg, double *qcg, int *nlidx,
         int *ipc, double *rpc,
         double *pc, double *ac, double *cc, double *fc,
         double *xf, double *yf, double *zf,
@@ -190,9 +199,11 @@ VPUBLIC void Vnewdriv2(int *iparm, double *rparm,
     int mgprol;     /// @todo:  Doc
     int mgcoar;     /// @todo:  Doc
     int mgsolv;     /// @todo:  Doc
+    int mgfree;     /// @todo:  Doc
     int mgdisc;     /// @todo:  Doc
     int mgsmoo;     /// @todo:  Doc
     int mode;       /// @todo:  Doc
+    int iguess;     ///< Start from the interior of u
     double epsiln;  /// @todo:  Doc
     double epsmac;  /// @todo:  Doc
     double errtol;  /// @todo:  Doc
@@ -217,6 +228,8 @@ VPUBLIC void Vnewdriv2(int *iparm, double *rparm,
 
     int i;
 
+    MAT2(iz, 50, 1);
+
 
 
     // Decode the iparm array
@@ -234,6 +247,9 @@ VPUBLIC void Vnewdriv2(int *iparm, double *rparm,
     mgsmoo = VAT(iparm, 20);
     mgsolv = VAT(iparm, 21);
 
+    // The nonlinear kernels need the diagonal of the fine operator stored
+    mgfree = 0;
+
     errtol = VAT(rparm,  1);
     omegal = VAT(rparm,  9);
     omegan = VAT(rparm, 10);
@@ -243,6 +259,9 @@ VPUBLIC void Vnewdriv2(int *iparm, double *rparm,
     // Build the multigrid data structure in iz
     Vbuildstr(nx, ny, nz, &nlev, iz);
 
+    // The Newton solve rebuilds the operators; none are kept for Vmgdriv2
+    VAT(iparm, 25) = 0;
+
     // Start the timer
     Vnm_tstart(30, "Vnewdrv2: fine problem setup");
 
@@ -250,7 +269,7 @@ VPUBLIC void Vnewdriv2(int *iparm, double *rparm,
     ido = 0;
     Vbuildops(nx, ny, nz,
             &nlev, &ipkey, &iinfo, &ido, iz,
-            &mgprol, &mgcoar, &mgsolv, &mgdisc,
+            &mgprol, &mgcoar, &mgsolv, &mgdisc, &mgfree,
             ipc, rpc,
             pc, ac, cc, fc,
             xf, yf, zf,
@@ -268,7 +287,7 @@ VPUBLIC void Vnewdriv2(int *iparm, double *rparm,
     ido = 1;
     Vbuildops(nx, ny, nz,
             &nlev, &ipkey, &iinfo, &ido, iz,
-            &mgprol, &mgcoar, &mgsolv, &mgdisc,
+            &mgprol, &mgcoar, &mgsolv, &mgdisc, &mgfree,
             ipc, rpc,
             pc, ac, cc, fc,
             xf, yf, zf,
@@ -276,6 +295,9 @@ VPUBLIC void Vnewdriv2(int *iparm, double *rparm,
             a1cf, a2cf, a3cf,
             ccf, fcf, tcf);
 
+    // Index the points where the nonlinear term is nonzero on every level
+    Vbuildnlidx(nx, ny, nz, &nlev, iz, ipc, cc, nlidx);
+
     // Stop the timer
     Vnm_tstop(30, "Vnewdrv2: coarse problem setup");
 
@@ -299,9 +321,30 @@ VPUBLIC void Vnewdriv2(int *iparm, double *rparm,
     // Determine machine epsilon
     epsiln = Vnm_epsmac();
 
+    /* Start from the interior of u if iparm(30) asks for it; full
+     * multigrid builds its own guess from the coarsest grid */
+    iguess = (VAT(iparm, 30) == 1) && (mgkey == 0);
+
     // Impose zero dirichlet boundary conditions (now in source fcn)
+    if (!iguess) {
+        Vazeros(nx, ny, nz, u);
+    }
     VfboundPMG00(nx, ny, nz, u);
 
+    // Relative residual of the initial guess; the coefficient arrays are free
+    VAT(rparm, 11) = 1.0;
+    if (iguess) {
+        VAT(rparm, 11) = Vguessres(nx, ny, nz, &mode,
+                RAT(ipc, VAT2(iz, 5, 1)), RAT(rpc, VAT2(iz, 6, 1)),
+                RAT( ac, VAT2(iz, 7, 1)), RAT( cc, VAT2(iz, 1, 1)),
+                RAT( fc, VAT2(iz, 1, 1)), u, a1cf, a2cf, a3cf);
+
+        // Newton need not converge from a guess worse than zero
+        if (VAT(rparm, 11) >= 1.0) {
+            Vazeros(nx, ny, nz, u);
+        }
+    }
+
     // Start the timer
     Vnm_tstart(30, "Vnewdrv2: solve");
 
@@ -319,6 +362,7 @@ VPUBLIC void Vnewdriv2(int *iparm, double *rparm,
                 &epsiln, &errtol, &omegan,
                 &nu1, &nu2, &mgsmoo,
                 a1cf, a2cf, a3cf,
+                zcg, pcg, qcg,
                 ipc, rpc,
                 pc, ac, cc, fc, tcf);
     } else if (mgkey == 1) {
@@ -330,6 +374,7 @@ VPUBLIC void Vnewdriv2(int *iparm, double *rparm,
                 &epsiln, &errtol, &omegan,
                 &nu1, &nu2, &mgsmoo,
                 a1cf, a2cf, a3cf,
+                zcg, pcg, qcg,
                 ipc, rpc,
                 pc, ac, cc, fc, tcf);
     } else {
@@ -338,6 +383,7 @@ VPUBLIC void Vnewdriv2(int *iparm, double *rparm,
 
     // Stop the timer
     Vnm_tstop(30, "Vnewdrv2: solve");
+    VAT(iparm, 29) = iters;
 
     // Restore boundary conditions
     ibound = 1;
@@ -132,6 +132,12 @@ VEXTERNC void Vnewdriv2(
         int    *iz,    ///< @todo:  Doc
         double *w1,    ///< @todo:  Doc
         double *w2,    ///< @todo:  Doc
+        double *zcg,   ///< VNULL, or a multilevel array to solve the Newton
+                       ///< correction equations with Vcgmg
+        double *pcg,   ///< Fine grid vector for Vcgmg (if zcg is set)
+        double *qcg,   ///< Fine grid vector for Vcgmg (if zcg is set)
+        int    *nlidx, ///< Space for the index of the points where the
+                       ///< nonlinear term is nonzero (narr+nlev ints)
         int    *ipc,   ///< @todo:  Doc
         double *rpc,   ///< @todo:  Doc
         double *pc,    ///< @todo:  Doc
@@ -64,6 +64,7 @@ VPUBLIC void Vfnewton(int *nx,int *ny,int *nz,
         double *epsiln, double *errtol, double *omega,
         int *nu1, int *nu2, int *mgsmoo,
         double *cprime, double *rhs, double *xtmp,
+        double *zcg, double *pcg, double *qcg,
         int *ipc, double *rpc,
         double *pc, double *ac, double *cc, double *fc, double *tru) {
 
@@ -110,6 +111,7 @@ VPUBLIC void Vfnewton(int *nx,int *ny,int *nz,
                 epsiln, &errd, omega,
                 nu1, nu2, mgsmoo,
                 cprime, rhs, xtmp,
+                zcg, pcg, qcg,
                 ipc, rpc,
                 pc, ac, cc, fc, tru);
 
@@ -153,6 +155,7 @@ VPUBLIC void Vfnewton(int *nx,int *ny,int *nz,
             epsiln, errtol, omega,
             nu1, nu2, mgsmoo,
             cprime, rhs, xtmp,
+            zcg, pcg, qcg,
             ipc, rpc,
             pc, ac, cc, fc, tru);
 }
@@ -168,6 +171,7 @@ VPUBLIC void Vnewton(int *nx, int *ny, int *nz,
         double *epsiln, double *errtol, double *omega,
         int *nu1, int *nu2, int *mgsmoo,
         double *cprime,  double *rhs, double *xtmp,
+        double *zcg, double *pcg, double *qcg,
         int *ipc, double *rpc,
         double *pc, double *ac, double *cc, double *fc, double *tru) {
 
@@ -178,7 +182,7 @@ VPUBLIC void Vnewton(int *nx, int *ny, int *nz,
 
     double xnorm_old, xnorm_new, damp, xnorm_med, xnorm_den;
     double rho_max, rho_min, rho_max_mod, rho_min_mod, errtol_p;
-    int iter_d, itmax_d, mode, idamp, ipkey;
+    int iter_d, itmax_d, mode, idamp, ipkey, jacok;
     int itmax_p, iters_p, iok_p, iinfo_p;
 
     // Utility and temproary parameters
@@ -258,13 +262,15 @@ VPUBLIC void Vnewton(int *nx, int *ny, int *nz,
      *** begin newton iteration
      *********************************************************************/
 
-    // Now compute residual with the initial guess
+    /* Now compute residual with the initial guess; the derivative of the
+     * nonlinear term for the first jacobian comes from the same pass */
 
-    Vnmresid(nx, ny, nz,
+    Vnmresidjac(nx, ny, nz,
             RAT(ipc, VAT2(iz, 5, lev)), RAT(rpc, VAT2(iz, 6, lev)),
             RAT( ac, VAT2(iz, 7, lev)), RAT( cc, VAT2(iz, 1, lev)),
             RAT( fc, VAT2(iz, 1, lev)), RAT(  x, VAT2(iz, 1, lev)),
-            w0, w2);
+            w0, w2, RAT(cprime, VAT2(iz, 1, lev)));
+    jacok = 1;
     xnorm_old = Vxnrm1(nx, ny, nz, w0);
     if (*iok != 0) {
         xnorm_den = rsden;
@@ -296,8 +302,9 @@ VPUBLIC void Vnewton(int *nx, int *ny, int *nz,
 
         // Compute the current jacobian system and rhs
         ipkey = VAT(ipc, 10);
-        Vgetjac(nx, ny, nz, nlev_real, iz, ilev, &ipkey,
+        Vgetjac(nx, ny, nz, nlev_real, iz, ilev, &ipkey, &jacok,
                 x, w0, cprime, rhs, cc, pc);
+        jacok = 0;
 
         // Determine number of correct digits in current residual
         // Algorithm 5.3 in the thesis, test version (1')
@@ -333,15 +340,29 @@ VPUBLIC void Vnewton(int *nx, int *ny, int *nz,
 
         // End of NAB hack.
 
-        Vmvcs(nx, ny, nz,
-                xtmp, iz,
-                w0, w1, w2, w3,
-                &istop_s, &itmax_s, &iters_s, &ierror_s,
-                nlev, ilev, nlev_real, mgsolv,
-                &iok_s, &iinfo_s,
-                epsiln, &errtol_s, omega,
-                nu1, nu2, mgsmoo,
-                ipc, rpc, pc, ac, cprime, rhs, tru);
+        // The correction equations are linear, so CG can accelerate them
+        if (zcg != VNULL) {
+            Vcgmg(nx, ny, nz,
+                    xtmp, iz,
+                    w0, w1, w2, w3,
+                    zcg, pcg, qcg,
+                    &istop_s, &itmax_s, &iters_s, &ierror_s,
+                    nlev, ilev, nlev_real, mgsolv,
+                    &iok_s, &iinfo_s,
+                    epsiln, &errtol_s, omega,
+                    nu1, nu2, mgsmoo,
+                    ipc, rpc, pc, ac, cprime, rhs, tru);
+        } else {
+            Vmvcs(nx, ny, nz,
+                    xtmp, iz,
+                    w0, w1, w2, w3,
+                    &istop_s, &itmax_s, &iters_s, &ierror_s,
+                    nlev, ilev, nlev_real, mgsolv,
+                    &iok_s, &iinfo_s,
+                    epsiln, &errtol_s, omega,
+                    nu1, nu2, mgsmoo,
+                    ipc, rpc, pc, ac, cprime, rhs, tru);
+        }
 
         /**************************************************************
          *** note: rhs and cprime are now available as temp vectors ***
@@ -427,12 +448,14 @@ VPUBLIC void Vnewton(int *nx, int *ny, int *nz,
             Vxaxpy(nx, ny, nz, &damp,
                     RAT(xtmp, VAT2(iz, 1, lev)), RAT(x, VAT2(iz, 1, lev)));
 
-            Vnmresid(nx, ny, nz,
+            Vnmresidjac(nx, ny, nz,
                     RAT(ipc, VAT2(iz, 5, lev)), RAT(rpc, VAT2(iz, 6, lev)),
                     RAT( ac, VAT2(iz, 7, lev)), RAT( cc, VAT2(iz, 1, lev)),
                     RAT( fc, VAT2(iz, 1, lev)), RAT(  x, VAT2(iz, 1, lev)),
                     w0,
-                    RAT(rhs, VAT2(iz, 1, lev)));
+                    RAT(rhs, VAT2(iz, 1, lev)),
+                    RAT(cprime, VAT2(iz, 1, lev)));
+            jacok = 1;
 
             xnorm_new = Vxnrm1(nx, ny, nz, w0);
             xnorm_old = xnorm_new;
@@ -548,7 +571,7 @@ VPUBLIC void Vnewton(int *nx, int *ny, int *nz,
 
 
 VPUBLIC void Vgetjac(int *nx, int *ny, int *nz,
-        int *nlev_real, int *iz, int *lev, int *ipkey,
+        int *nlev_real, int *iz, int *lev, int *ipkey, int *jacok,
         double *x, double *r,
         double *cprime, double *rhs,
         double *cc, double *pc) {
@@ -567,10 +590,12 @@ VPUBLIC void Vgetjac(int *nx, int *ny, int *nz,
     // Form the rhs of the newton system -- just current residual
     Vxcopy(nx, ny, nz, r, RAT(rhs, VAT2(iz, 1,*lev)));
 
-    // Get nonlinear part of the jacobian operator
-    Vdc_vec(RAT(cc, VAT2(iz, 1,*lev)), RAT(x, VAT2(iz, 1,*lev)),
-              RAT(cprime, VAT2(iz, 1,*lev)),
-            nx, ny, nz, ipkey);
+    // Get nonlinear part of the jacobian operator, unless the residual had it
+    if (*jacok == 0) {
+        Vdc_vec(RAT(cc, VAT2(iz, 1,*lev)), RAT(x, VAT2(iz, 1,*lev)),
+                  RAT(cprime, VAT2(iz, 1,*lev)),
+                nx, ny, nz, ipkey);
+    }
 
     // Build the (nlev-1) level operators
     for (level=*lev+1; level<=*nlev_real; level++) {
@@ -58,6 +58,7 @@
 #include "pmgc/matvecd.h"
 #include "pmgc/mikpckd.h"
 #include "pmgc/mgcsd.h"
+#include "pmgc/cgmgd.h"
 #include "pmgc/mgsubd.h"
 #include "pmgc/powerd.h"
 
@@ -96,6 +97,10 @@ VPUBLIC void Vfnewton(
         double *cprime, ///< @todo: Doc
         double *rhs,    ///< @todo: Doc
         double *xtmp,   ///< @todo: Doc
+        double *zcg,    ///< VNULL to solve the correction equations with
+                        ///< v-cycles; else a multilevel array for Vcgmg
+        double *pcg,    ///< Fine grid vector for Vcgmg (if zcg is set)
+        double *qcg,    ///< Fine grid vector for Vcgmg (if zcg is set)
         int *ipc,       ///< @todo: Doc
         double *rpc,    ///< @todo: Doc
         double *pc,     ///< @todo: Doc
@@ -140,6 +145,10 @@ VEXTERNC void Vnewton(
         double *cprime, ///< @todo: Doc
         double *rhs,    ///< @todo: Doc
         double *xtmp,   ///< @todo: Doc
+        double *zcg,    ///< VNULL to solve the correction equations with
+                        ///< v-cycles; else a multilevel array for Vcgmg
+        double *pcg,    ///< Fine grid vector for Vcgmg (if zcg is set)
+        double *qcg,    ///< Fine grid vector for Vcgmg (if zcg is set)
         int *ipc,       ///< @todo: Doc
         double *rpc,    ///< @todo: Doc
         double *pc,     ///< @todo: Doc
@@ -164,6 +173,8 @@ VEXTERNC void Vgetjac(
         int *iz,        ///< @todo: Doc
         int *lev,       ///< @todo: Doc
         int *ipkey,     ///< @todo: Doc
+        int *jacok,     /**< 1 if cprime already holds the derivative of the
+                             nonlinear term at x, 0 to evaluate it here */
         double *x,      ///< @todo: Doc
         double *r,      ///< @todo: Doc
         double *cprime, ///< @todo: Doc
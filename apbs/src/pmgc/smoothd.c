@@ -83,6 +83,14 @@ VEXTERNC void Vsmooth(int *nx, int *ny, int *nz,
                 itmax, iters,
                 errtol, omega,
                 iresid, iadjoint);
+    } else if (*meth == 5) {
+        Vgsrbtb(nx, ny, nz,
+                ipc, rpc,
+                ac, cc, fc,
+                x, w1, w2, r,
+                itmax, iters,
+                errtol, omega,
+                iresid, iadjoint);
     } else {
         VABORT_MSG1("Bad smoothing routine specified = %d", *meth);
     }
@@ -103,7 +111,7 @@ VEXTERNC void Vnsmooth(int *nx, int *ny, int *nz,
     if (*meth == 0) {
         VABORT_MSG0( "nwjac not yet translated" );
         //nwjac(nx,ny,nz,ipc,rpc,ac,cc,fc,x,w1,w2,r,itmax,iters,errtol,omega,iresid,iadjoint)
-    } else if (*meth == 1) {
+    } else if (*meth == 1 || *meth == 5) {
         VABORT_MSG0( "ngsrb not yet translated" );
         //ngsrb(nx,ny,nz,ipc,rpc,ac,cc,fc,x,w1,w2,r,itmax,iters,errtol,omega,iresid,iadjoint)
     } else if (*meth == 2) {
@@ -55,6 +55,24 @@
 
 VEMBED(rcsid="$Id$")
 
+/* Solutions of the multigrid calculations of recent ELEC statements, kept
+ * for the next statement when it asks for "guess previous" */
+VPRIVATE Vgrid *prevSol[NOSH_MAXCALC];
+/* Iterations each of them took, or would have taken, from a zero guess;
+ * -1 if unknown */
+VPRIVATE int prevIters[NOSH_MAXCALC];
+
+/* Level of a multigrid calculation in its ELEC statement */
+VPRIVATE int levelMG(NOsh *nosh, int icalc, int *ielec);
+/* Keep the solution of a calculation if the next ELEC statement starts
+ * from it */
+VPRIVATE void keepPrevMG(NOsh *nosh, int icalc, Vpmg *pmg);
+/* Start a calculation from the same level of the previous ELEC statement;
+ * returns the points set as for Vpmg_setGuessMap, or -1 if none was */
+VPRIVATE int guessPrevMG(NOsh *nosh, int icalc, Vpmg *pmg);
+/* Free the kept solutions that icalc and later calculations cannot use */
+VPRIVATE void dropPrevMG(NOsh *nosh, int icalc);
+
 VPUBLIC void startVio() { Vio_start(); }
 
 VPUBLIC Vparam* loadParameter(NOsh *nosh) {
@@ -1039,6 +1057,9 @@ conditions\n");
     } else if (pbeparm->bcfl == BCFL_MDH) {
         Vnm_tprint( 1, "  Multiple Debye-Huckel sphere boundary \
 conditions\n");
+    } else if (pbeparm->bcfl == BCFL_MDHTREE) {
+        Vnm_tprint( 1, "  Multiple Debye-Huckel sphere boundary \
+conditions (treecode, tolerance %g)\n", pbeparm->bctol);
     } else if (pbeparm->bcfl == BCFL_FOCUS) {
         Vnm_tprint( 1, "  Boundary conditions from focusing\n");
     } else if (pbeparm->bcfl == BCFL_MAP) {
@@ -1194,6 +1215,10 @@ VPUBLIC void printMGPARM(MGparm *mgparm, double realCenter[3]) {
         Vnm_tprint( 1, "  Processor array = %d x %d x %d\n",
                     mgparm->pdime[0], mgparm->pdime[1], mgparm->pdime[2]);
     }
+    if (mgparm->distrib) {
+        Vnm_tprint( 1, "  Distributed multigrid; owning z planes %d-%d of %d\n",
+                    mgparm->distOwn[0], mgparm->distOwn[1]-1, mgparm->distDime);
+    }
     Vnm_tprint( 1, "  Grid dimensions: %d x %d x %d\n",
                 mgparm->dime[0], mgparm->dime[1], mgparm->dime[2]);
     Vnm_tprint( 1, "  Grid spacings: %4.3f x %4.3f x %4.3f\n",
@@ -1203,7 +1228,32 @@ VPUBLIC void printMGPARM(MGparm *mgparm, double realCenter[3]) {
     Vnm_tprint( 1, "  Grid center: (%4.3f, %4.3f, %4.3f)\n",
                 realCenter[0], realCenter[1], realCenter[2]);
     Vnm_tprint( 1, "  Multigrid levels: %d\n", mgparm->nlev);
+    if (mgparm->useCGMG == 1) {
+        Vnm_tprint( 1, "  Using multigrid preconditioned conjugate gradients\n");
+    }
+
+}
+
+VPUBLIC Vpbe* initPbeMG(PBEparm *pbeparm,
+                        Valist *alist,
+                        int focusFlag
+                       ) {
+
+    double sparm;
+
+    Vnm_tprint(0, "Setting up PBE object...\n");
+    if (pbeparm->srfm == VSM_SPLINE) {
+        sparm = pbeparm->swin;
+    } else {
+        sparm = pbeparm->srad;
+    }
 
+    return Vpbe_ctor(alist, pbeparm->nion,
+                     pbeparm->ionc, pbeparm->ionr, pbeparm->ionq,
+                     pbeparm->temp, pbeparm->pdie,
+                     pbeparm->sdie, sparm, focusFlag, pbeparm->sdens,
+                     pbeparm->zmem, pbeparm->Lmem, pbeparm->mdie,
+                     pbeparm->memv);
 }
 
 /**
@@ -1227,12 +1277,13 @@ VPUBLIC int initMG(int icalc,
 
     int j,
         focusFlag,
-        iatom;
+        reuse,
+        guessPts,
+        iatom,
+        nlev;
     size_t bytesTotal,
            highWater;
-    double sparm,
-           iparm,
-           q;
+    double q;
     Vatom *atom = VNULL;
     Vgrid *theDielXMap = VNULL,
           *theDielYMap = VNULL,
@@ -1262,18 +1313,6 @@ VPUBLIC int initMG(int icalc,
     }
     */
 
-    /* Set up PBE object */
-    Vnm_tprint(0, "Setting up PBE object...\n");
-    if (pbeparm->srfm == VSM_SPLINE) {
-        sparm = pbeparm->swin;
-    } else {
-        sparm = pbeparm->srad;
-    }
-    if (pbeparm->nion > 0) {
-        iparm = pbeparm->ionr[0];
-    } else {
-        iparm = 0.0;
-    }
     if (pbeparm->bcfl == BCFL_FOCUS) {
         if (icalc == 0) {
             Vnm_tprint( 2, "Can't focus first calculation!\n");
@@ -1284,13 +1323,11 @@ VPUBLIC int initMG(int icalc,
         focusFlag = 0;
     }
 
-    // Construct Vpbe object
-    pbe[icalc] = Vpbe_ctor(myalist, pbeparm->nion,
-                           pbeparm->ionc, pbeparm->ionr, pbeparm->ionq,
-                           pbeparm->temp, pbeparm->pdie,
-                           pbeparm->sdie, sparm, focusFlag, pbeparm->sdens,
-                           pbeparm->zmem, pbeparm->Lmem, pbeparm->mdie,
-                           pbeparm->memv);
+    /* Set up PBE object, unless the caller shares one between calculations
+     * (see inprocMG) */
+    if (pbe[icalc] == VNULL) {
+        pbe[icalc] = initPbeMG(pbeparm, myalist, focusFlag);
+    }
 
     /* Set up PDE object */
     Vnm_tprint(0, "Setting up PDE object...\n");
@@ -1299,13 +1336,26 @@ VPUBLIC int initMG(int icalc,
             /* TEMPORARY USEAQUA */
             mgparm->nonlintype = NONLIN_NPBE;
             mgparm->method = (mgparm->useAqua == 1) ? VSOL_NewtonAqua : VSOL_Newton;
+            if (mgparm->useCGMG == 1) mgparm->method = VSOL_CGMG;
             pmgp[icalc] = Vpmgp_ctor(mgparm);
             break;
         case PBE_LPBE:
             /* TEMPORARY USEAQUA */
             mgparm->nonlintype = NONLIN_LPBE;
             mgparm->method = (mgparm->useAqua == 1) ? VSOL_CGMGAqua : VSOL_MG;
-            pmgp[icalc] = Vpmgp_ctor(mgparm);
+            if (mgparm->useCGMG == 1) mgparm->method = VSOL_CGMG;
+            if (mgparm->distrib) {
+                /* The slab only holds the fine mesh; Vmgdist builds the
+                 * levels of the undivided mesh itself, so keep PMG from
+                 * sizing a banded coarse solve for the whole slab */
+                nlev = mgparm->nlev;
+                mgparm->nlev = 1;
+                pmgp[icalc] = Vpmgp_ctor(mgparm);
+                pmgp[icalc]->mgsolv = 0;
+                mgparm->nlev = nlev;
+            } else {
+                pmgp[icalc] = Vpmgp_ctor(mgparm);
+            }
             break;
         case PBE_LRPBE:
             Vnm_tprint(2, "Sorry, LRPBE isn't supported with the MG solver!\n");
@@ -1335,8 +1385,28 @@ VPUBLIC int initMG(int icalc,
             Vnm_tprint(2, "Error!  Unknown PBE type (%d)!\n", pbeparm->pbetype);
             return 0;
     }
+    /* Keep the multigrid operators in the work arrays if this calculation
+     * reuses the previous one, the next one reuses this one or other charge
+     * sets are solved on them (see rhsMG) */
+    reuse = mgparm->reuse && (icalc > 0) && (pbeparm->bcfl != BCFL_FOCUS)
+        && (nosh->calc[icalc-1]->calctype == NCT_MG)
+        && (pmg[icalc-1] != VNULL);
+    if (mgparm->reuse || (mgparm->nrhs > 0) || ((icalc+1 < nosh->ncalc)
+        && (nosh->calc[icalc+1]->calctype == NCT_MG)
+        && nosh->calc[icalc+1]->mgparm->reuse)) {
+        pmgp[icalc]->mgcach = 1;
+    }
+    /* The previous calculation is destroyed below */
+    guessPts = -1;
+    if ((icalc > 0) && (nosh->calc[icalc-1]->calctype == NCT_MG)
+        && (pmg[icalc-1] != VNULL)) {
+        keepPrevMG(nosh, icalc-1, pmg[icalc-1]);
+    }
+    dropPrevMG(nosh, icalc);
+
     Vnm_tprint(0, "Setting PDE center to local center...\n");
     pmgp[icalc]->bcfl = pbeparm->bcfl;
+    pmgp[icalc]->bctol = pbeparm->bctol;
     pmgp[icalc]->xcent = realCenter[0];
     pmgp[icalc]->ycent = realCenter[1];
     pmgp[icalc]->zcent = realCenter[2];
@@ -1353,10 +1423,24 @@ VPUBLIC int initMG(int icalc,
         /* ...however, it should be done with the previous calculation now, so
         we should be able to destroy it here. */
         /* Vpmg_dtor(&(pmg[icalc-1])); */
+    } else if (reuse) {
+        /* Take the maps and operators of the previous calculation before
+         * it is destroyed */
+        pmg[icalc] = Vpmg_ctor(pmgp[icalc], pbe[icalc], 0, VNULL, mgparm, PCE_NO);
+        if (!Vpmg_copyCoef(pmg[icalc], pmg[icalc-1])) {
+            Vnm_tprint(1, "  Previous calculation is on a different mesh; not reusing it.\n");
+        }
+        Vpmg_dtor(&(pmg[icalc-1]));
     } else {
         if (icalc>0) Vpmg_dtor(&(pmg[icalc-1]));
         pmg[icalc] = Vpmg_ctor(pmgp[icalc], pbe[icalc], 0, VNULL, mgparm, PCE_NO);
     }
+    /* Focused levels already start from the coarser solution (see
+     * Vpmg_ctor); the same level of the previous ELEC statement replaces it
+     * if it is on the same mesh */
+    if (mgparm->guess == MGG_PREVIOUS) {
+        guessPts = guessPrevMG(nosh, icalc, pmg[icalc]);
+    }
     if (icalc>0) {
         Vpmgp_dtor(&(pmgp[icalc-1]));
         Vpbe_dtor(&(pbe[icalc-1]));
@@ -1416,6 +1500,14 @@ VPUBLIC int initMG(int icalc,
         }
     }
 
+    if (mgparm->guess == MGG_MAP) {
+        if (thePotMap == VNULL) {
+            Vnm_print(2, "Error!  'guess map' needs a 'usemap pot' statement!\n");
+            return 0;
+        }
+        guessPts = Vpmg_setGuessMap(pmg[icalc], thePotMap);
+    }
+
     if (pbeparm->bcfl == BCFL_MAP && thePotMap == VNULL) {
         Vnm_print(2, "Warning: You specified 'bcfl map' in the input file, but no potential map was found.\n");
         Vnm_print(2, "         You must specify 'usemap pot' statement in the APBS input file!\n");
@@ -1439,6 +1531,11 @@ VPUBLIC int initMG(int icalc,
     /* Print a few derived parameters */
 #ifndef VAPBSQUIET
     Vnm_tprint(1, "  Debye length:  %g A\n", Vpbe_getDeblen(pbe[icalc]));
+    if (guessPts > 0) {
+        Vnm_tprint(1, "  Initial guess set on %d interior points\n", guessPts);
+    } else if (guessPts == 0) {
+        Vnm_tprint(1, "  Initial guess does not overlap this mesh; starting from zero\n");
+    }
 #endif
 
     /* Setup time statistics */
@@ -1453,6 +1550,7 @@ VPUBLIC int initMG(int icalc,
 %4.3f MB high water\n", (double)(bytesTotal)/(1024.*1024.),
                 (double)(highWater)/(1024.*1024.));
 #endif
+    Vpmg_printMemChk(pmg[icalc], 0);
 
     return 1;
 
@@ -1481,7 +1579,117 @@ VPUBLIC void killMG(NOsh *nosh, Vpbe *pbe[NOSH_MAXCALC],
         Vpbe_dtor(&(pbe[i]));
         Vpmgp_dtor(&(pmgp[i]));
     }
+    for (i=0; i<NOSH_MAXCALC; i++) {
+        if (prevSol[i] != VNULL) Vgrid_dtor(&(prevSol[i]));
+    }
+
+}
 
+VPRIVATE int levelMG(NOsh *nosh, int icalc, int *ielec) {
+
+    int k;
+
+    for (k=0; k<nosh->nelec; k++) {
+        if (nosh->elec2calc[k] >= icalc) break;
+    }
+    *ielec = k;
+    if (k == 0) return icalc;
+    return icalc - nosh->elec2calc[k-1] - 1;
+}
+
+VPRIVATE void keepPrevMG(NOsh *nosh, int icalc, Vpmg *pmg) {
+
+    int ielec,
+        jcalc,
+        nx,
+        ny,
+        nz,
+        i;
+    double hx,
+           hy,
+           hzed;
+    Vgrid *grid = VNULL;
+
+    levelMG(nosh, icalc, &ielec);
+    if (ielec+1 >= nosh->nelec) return;
+    jcalc = nosh->elec2calc[ielec] + 1;
+    if ((nosh->calc[jcalc]->calctype != NCT_MG) ||
+        (nosh->calc[jcalc]->mgparm->guess != MGG_PREVIOUS)) return;
+
+    nx = pmg->pmgp->nx;
+    ny = pmg->pmgp->ny;
+    nz = pmg->pmgp->nz;
+    hx = pmg->pmgp->hx;
+    hy = pmg->pmgp->hy;
+    hzed = pmg->pmgp->hzed;
+    if (prevSol[icalc] != VNULL) Vgrid_dtor(&(prevSol[icalc]));
+    grid = Vgrid_ctor(nx, ny, nz, hx, hy, hzed,
+                      pmg->pmgp->xcent - ((double)(nx-1)*hx)/2.0,
+                      pmg->pmgp->ycent - ((double)(ny-1)*hy)/2.0,
+                      pmg->pmgp->zcent - ((double)(nz-1)*hzed)/2.0,
+                      VNULL);
+    grid->data = (double *)Vmem_malloc(grid->mem, nx*ny*nz, sizeof(double));
+    grid->readdata = 1;
+    for (i=0; i<nx*ny*nz; i++) grid->data[i] = pmg->u[i];
+    prevSol[icalc] = grid;
+
+    /* A guess carries the count of the solve from zero it is compared to */
+    if ((pmg->iparm[29] != 1) || ((pmg->pmgp->nonlin != NONLIN_LPBE)
+                                  && (pmg->rparm[10] >= 1.0))) {
+        prevIters[icalc] = pmg->iparm[28];
+    } else {
+        prevIters[icalc] = pmg->zeroIters;
+    }
+}
+
+VPRIVATE int guessPrevMG(NOsh *nosh, int icalc, Vpmg *pmg) {
+
+    int ielec,
+        ilev,
+        jcalc,
+        same;
+    Vgrid *grid = VNULL;
+    Vpmgp *pmgp = VNULL;
+
+    ilev = levelMG(nosh, icalc, &ielec);
+    if (ielec == 0) return -1;
+    jcalc = ilev;
+    if (ielec > 1) jcalc += nosh->elec2calc[ielec-2] + 1;
+    if ((jcalc > nosh->elec2calc[ielec-1]) || (prevSol[jcalc] == VNULL)) {
+        return -1;
+    }
+
+    grid = prevSol[jcalc];
+    pmgp = pmg->pmgp;
+    same = (grid->nx == pmgp->nx) && (grid->ny == pmgp->ny)
+        && (grid->nz == pmgp->nz)
+        && (VABS(grid->hx - pmgp->hx) < 1e-6*pmgp->hx)
+        && (VABS(grid->hy - pmgp->hy) < 1e-6*pmgp->hy)
+        && (VABS(grid->hzed - pmgp->hzed) < 1e-6*pmgp->hzed)
+        && (VABS(grid->xmin - (pmgp->xcent - ((double)(pmgp->nx-1)*pmgp->hx)/2.0))
+            < 1e-6*pmgp->hx)
+        && (VABS(grid->ymin - (pmgp->ycent - ((double)(pmgp->ny-1)*pmgp->hy)/2.0))
+            < 1e-6*pmgp->hy)
+        && (VABS(grid->zmin - (pmgp->zcent - ((double)(pmgp->nz-1)*pmgp->hzed)/2.0))
+            < 1e-6*pmgp->hzed);
+
+    /* A focused level is better off with the coarser solution than with a
+     * different box */
+    if (!same && (pmgp->bcfl == BCFL_FOCUS)) return -1;
+    if (same) pmg->zeroIters = prevIters[jcalc];
+    return Vpmg_setGuessMap(pmg, grid);
+}
+
+VPRIVATE void dropPrevMG(NOsh *nosh, int icalc) {
+
+    int ielec,
+        jcalc;
+
+    levelMG(nosh, icalc, &ielec);
+    if (ielec < 2) return;
+    for (jcalc=0; jcalc<=nosh->elec2calc[ielec-2]; jcalc++) {
+        if (prevSol[jcalc] != VNULL) Vgrid_dtor(&(prevSol[jcalc]));
+    }
 }
 
 VPUBLIC int solveMG(NOsh *nosh,
@@ -1493,6 +1701,8 @@ VPUBLIC int solveMG(NOsh *nosh,
         ny,
         nz,
         i;
+    double rsnrm,
+           errtol;
 
     if (nosh != VNULL) {
         if (nosh->bogus) return 1;
@@ -1506,6 +1716,27 @@ VPUBLIC int solveMG(NOsh *nosh,
             Vnm_print(2, "  Error during PDE solution!\n");
             return 0;
         }
+        Vnm_tprint( 1, "  Solver iterations: %d\n", pmg->iparm[28]);
+        if (pmg->iparm[29] == 1) {
+            /* The stopping test is relative to the residual of a zero
+             * guess, so the iterations are comparable with those of an
+             * earlier solve of this mesh from zero */
+            rsnrm = pmg->rparm[10];
+            errtol = pmg->rparm[0];
+            Vnm_tprint(1, "  Initial guess relative residual: %g\n", rsnrm);
+            if ((rsnrm >= 1.0) && (pmg->pmgp->nonlin != NONLIN_LPBE)) {
+                Vnm_tprint(1, "  Initial guess discarded; the nonlinear solve started from zero\n");
+            } else {
+                if (rsnrm <= errtol) {
+                    Vnm_tprint(1, "  Initial guess already met the tolerance\n");
+                }
+                if (pmg->zeroIters >= 0) {
+                    Vnm_tprint(1, "  Solver iterations saved against the \
+previous solve of this mesh: %d of %d\n", pmg->zeroIters - pmg->iparm[28],
+                               pmg->zeroIters);
+                }
+            }
+        }
     } else {
         Vnm_tprint( 1,"  Skipping solve for mg-dummy run; zeroing \
 solution array\n");
@@ -1520,6 +1751,39 @@ solution array\n");
 
 }
 
+VPUBLIC int solveDistMG(Vcom *com,
+                        NOsh *nosh,
+                        MGparm *mgparm,
+                        Vpmg *pmg
+                       ) {
+
+    Vmgdist *mgdist = VNULL;
+
+    if (nosh != VNULL) {
+        if (nosh->bogus) return 1;
+    }
+
+    Vnm_tstart(APBS_TIMER_SOLVER, "Solver timer");
+
+    mgdist = Vmgdist_ctor(com, pmg, mgparm);
+    if (mgdist == VNULL) {
+        Vnm_print(2, "  Error setting up distributed multigrid!\n");
+        return 0;
+    }
+    if (!Vmgdist_solve(mgdist)) {
+        Vnm_print(2, "  Error during PDE solution!\n");
+        Vmgdist_dtor(&mgdist);
+        return 0;
+    }
+    Vnm_tprint( 1, "  Solver iterations: %d\n", mgdist->iters);
+    Vmgdist_dtor(&mgdist);
+
+    Vnm_tstop(APBS_TIMER_SOLVER, "Solver timer");
+
+    return 1;
+
+}
+
 VPUBLIC int setPartMG(NOsh *nosh,
                       MGparm *mgparm,
                       Vpmg *pmg
@@ -1531,7 +1795,7 @@ VPUBLIC int setPartMG(NOsh *nosh,
 
     if (nosh->bogus) return 1;
 
-    if (mgparm->type == MCT_PARALLEL) {
+    if ((mgparm->type == MCT_PARALLEL) || mgparm->distrib) {
         for (j=0; j<3; j++) {
             partMin[j] = mgparm->partDisjCenter[j] - 0.5*mgparm->partDisjLength[j];
             partMax[j] = mgparm->partDisjCenter[j] + 0.5*mgparm->partDisjLength[j];
@@ -1633,6 +1897,79 @@ kJ/mol\n", Vunit_kb*pbeparm->temp*(1e-3)*Vunit_Na*(*totEnergy));
     return 1;
 }
 
+VPUBLIC int rhsMG(NOsh *nosh,
+                  int icalc,
+                  Vpmg *pmg,
+                  Valist *alist[NOSH_MAXMOL]
+                 ) {
+
+    MGparm *mgparm;
+    PBEparm *pbeparm;
+    Valist *myalist,
+           *rhsalist;
+    double *charges,
+           *energy;
+    int i,
+        irhs,
+        natoms,
+        nrhs,
+        rc;
+
+    mgparm = nosh->calc[icalc]->mgparm;
+    pbeparm = nosh->calc[icalc]->pbeparm;
+    nrhs = mgparm->nrhs;
+    if (nrhs == 0) return 1;
+
+    /* Each molecule only lends its charges to the atoms of this one */
+    myalist = alist[pbeparm->molid-1];
+    natoms = Valist_getNumberAtoms(myalist);
+    for (irhs=0; irhs<nrhs; irhs++) {
+        if (mgparm->rhsmol[irhs] > nosh->nmol) {
+            Vnm_tprint(2, "Error!  %d is not a valid molecule ID!\n",
+                       mgparm->rhsmol[irhs]);
+            return 0;
+        }
+        rhsalist = alist[mgparm->rhsmol[irhs]-1];
+        if (Valist_getNumberAtoms(rhsalist) != natoms) {
+            Vnm_tprint(2, "Error!  Molecule %d has %d atoms instead of %d!\n",
+                       mgparm->rhsmol[irhs],
+                       Valist_getNumberAtoms(rhsalist), natoms);
+            return 0;
+        }
+    }
+
+    Vnm_tstart(APBS_TIMER_SOLVER, "Solver timer");
+
+    charges = (double *)Vmem_malloc(VNULL, VMAX2(nrhs*natoms, 1),
+                                    sizeof(double));
+    energy = (double *)Vmem_malloc(VNULL, nrhs, sizeof(double));
+    for (irhs=0; irhs<nrhs; irhs++) {
+        rhsalist = alist[mgparm->rhsmol[irhs]-1];
+        for (i=0; i<natoms; i++) {
+            charges[irhs*natoms + i] =
+                Vatom_getCharge(Valist_getAtom(rhsalist, i));
+        }
+    }
+
+    rc = Vpmg_solveMulti(pmg, nrhs, charges, mgparm->rhsblock, energy,
+                         VNULL);
+    if (rc) {
+        for (irhs=0; irhs<nrhs; irhs++) {
+            Vnm_tprint(1, "  Charges of molecule %d:  total electrostatic \
+energy = %1.12E kJ/mol\n", mgparm->rhsmol[irhs],
+                       Vunit_kb*pbeparm->temp*(1e-3)*Vunit_Na*energy[irhs]);
+        }
+    }
+
+    Vmem_free(VNULL, VMAX2(nrhs*natoms, 1), sizeof(double),
+              (void **)&charges);
+    Vmem_free(VNULL, nrhs, sizeof(double), (void **)&energy);
+
+    Vnm_tstop(APBS_TIMER_SOLVER, "Solver timer");
+
+    return rc;
+}
+
 VPUBLIC int forceMG(Vmem *mem,
                     NOsh *nosh,
                     PBEparm *pbeparm,
@@ -1644,10 +1981,9 @@ VPUBLIC int forceMG(Vmem *mem,
                    ) {
 
     int j,
-        k;
-    double qfForce[3],
-           dbForce[3],
-           ibForce[3];
+        k,
+        natoms;
+    AtomForce *tforce = VNULL;
 
     Vnm_tstart(APBS_TIMER_FORCE, "Force timer");
 
@@ -1655,6 +1991,7 @@ VPUBLIC int forceMG(Vmem *mem,
     Vnm_tprint( 1,"  Calculating forces...\n");
 #endif
 
+    natoms = Valist_getNumberAtoms(alist[pbeparm->molid-1]);
     if (pbeparm->calcforce == PCF_TOTAL) {
         *nforce = 1;
         *atomForce = (AtomForce *)Vmem_malloc(mem, 1, sizeof(AtomForce));
@@ -1664,24 +2001,63 @@ VPUBLIC int forceMG(Vmem *mem,
             (*atomForce)[0].ibForce[j] = 0;
             (*atomForce)[0].dbForce[j] = 0;
         }
-        for (j=0;j<Valist_getNumberAtoms(alist[pbeparm->molid-1]);j++) {
-            if (nosh->bogus == 0) {
-                VASSERT(Vpmg_qfForce(pmg, qfForce, j, mgparm->chgm));
-                VASSERT(Vpmg_ibForce(pmg, ibForce, j, pbeparm->srfm));
-                VASSERT(Vpmg_dbForce(pmg, dbForce, j, pbeparm->srfm));
-            } else {
-                for (k=0; k<3; k++) {
-                    qfForce[k] = 0;
-                    ibForce[k] = 0;
-                    dbForce[k] = 0;
-                }
+        tforce = (AtomForce *)Vmem_malloc(mem, VMAX2(natoms,1),
+                                          sizeof(AtomForce));
+    } else if (pbeparm->calcforce == PCF_COMPS) {
+        *nforce = natoms;
+        *atomForce = (AtomForce *)Vmem_malloc(mem, *nforce,
+                                              sizeof(AtomForce));
+        tforce = *atomForce;
+    } else {
+        *nforce = 0;
+        Vnm_tstop(APBS_TIMER_FORCE, "Force timer");
+        return 1;
+    }
+
+    /* The atoms are independent, so they are spread over the threads in
+     * batches of neighbouring atoms, each writing only its own forces */
+#pragma omp parallel for default(shared) private(j,k) schedule(dynamic,16)
+    for (j=0; j<natoms; j++) {
+        if (nosh->bogus == 0) {
+            VASSERT(Vpmg_qfForce(pmg, tforce[j].qfForce, j, mgparm->chgm));
+            VASSERT(Vpmg_ibForce(pmg, tforce[j].ibForce, j, pbeparm->srfm));
+            VASSERT(Vpmg_dbForce(pmg, tforce[j].dbForce, j, pbeparm->srfm));
+        } else {
+            for (k=0; k<3; k++) {
+                tforce[j].qfForce[k] = 0;
+                tforce[j].ibForce[k] = 0;
+                tforce[j].dbForce[k] = 0;
             }
+        }
+    }
+
+    if (pbeparm->calcforce == PCF_TOTAL) {
+        /* Sum in atom order so the total does not depend on the number of
+         * threads */
+        for (j=0; j<natoms; j++) {
             for (k=0; k<3; k++) {
-                (*atomForce)[0].qfForce[k] += qfForce[k];
-                (*atomForce)[0].ibForce[k] += ibForce[k];
-                (*atomForce)[0].dbForce[k] += dbForce[k];
+                (*atomForce)[0].qfForce[k] += tforce[j].qfForce[k];
+                (*atomForce)[0].ibForce[k] += tforce[j].ibForce[k];
+                (*atomForce)[0].dbForce[k] += tforce[j].dbForce[k];
             }
         }
+        Vmem_free(mem, VMAX2(natoms,1), sizeof(AtomForce), (void **)&tforce);
+    }
+    printforceMG(pbeparm, *nforce, *atomForce);
+
+    Vnm_tstop(APBS_TIMER_FORCE, "Force timer");
+
+    return 1;
+}
+
+VPUBLIC void printforceMG(PBEparm *pbeparm,
+                          int nforce,
+                          AtomForce *atomForce
+                         ) {
+
+    int j;
+
+    if (pbeparm->calcforce == PCF_TOTAL) {
 #ifndef VAPBSQUIET
         Vnm_tprint( 1, "  Printing net forces for molecule %d (kJ/mol/A)\n",
                     pbeparm->molid);
@@ -1690,22 +2066,19 @@ VPUBLIC int forceMG(Vmem *mem,
         Vnm_tprint( 1, "    db  -- dielectric boundary force\n");
         Vnm_tprint( 1, "    ib  -- ionic boundary force\n");
         Vnm_tprint( 1, "  qf  %4.3e  %4.3e  %4.3e\n",
-                    Vunit_kb*pbeparm->temp*(1e-3)*Vunit_Na*(*atomForce)[0].qfForce[0],
-                    Vunit_kb*pbeparm->temp*(1e-3)*Vunit_Na*(*atomForce)[0].qfForce[1],
-                    Vunit_kb*pbeparm->temp*(1e-3)*Vunit_Na*(*atomForce)[0].qfForce[2]);
+                    Vunit_kb*pbeparm->temp*(1e-3)*Vunit_Na*atomForce[0].qfForce[0],
+                    Vunit_kb*pbeparm->temp*(1e-3)*Vunit_Na*atomForce[0].qfForce[1],
+                    Vunit_kb*pbeparm->temp*(1e-3)*Vunit_Na*atomForce[0].qfForce[2]);
         Vnm_tprint( 1, "  ib  %4.3e  %4.3e  %4.3e\n",
-                    Vunit_kb*pbeparm->temp*(1e-3)*Vunit_Na*(*atomForce)[0].ibForce[0],
-                    Vunit_kb*pbeparm->temp*(1e-3)*Vunit_Na*(*atomForce)[0].ibForce[1],
-                    Vunit_kb*pbeparm->temp*(1e-3)*Vunit_Na*(*atomForce)[0].ibForce[2]);
+                    Vunit_kb*pbeparm->temp*(1e-3)*Vunit_Na*atomForce[0].ibForce[0],
+                    Vunit_kb*pbeparm->temp*(1e-3)*Vunit_Na*atomForce[0].ibForce[1],
+                    Vunit_kb*pbeparm->temp*(1e-3)*Vunit_Na*atomForce[0].ibForce[2]);
         Vnm_tprint( 1, "  db  %4.3e  %4.3e  %4.3e\n",
-                    Vunit_kb*pbeparm->temp*(1e-3)*Vunit_Na*(*atomForce)[0].dbForce[0],
-                    Vunit_kb*pbeparm->temp*(1e-3)*Vunit_Na*(*atomForce)[0].dbForce[1],
-                    Vunit_kb*pbeparm->temp*(1e-3)*Vunit_Na*(*atomForce)[0].dbForce[2]);
+                    Vunit_kb*pbeparm->temp*(1e-3)*Vunit_Na*atomForce[0].dbForce[0],
+                    Vunit_kb*pbeparm->temp*(1e-3)*Vunit_Na*atomForce[0].dbForce[1],
+                    Vunit_kb*pbeparm->temp*(1e-3)*Vunit_Na*atomForce[0].dbForce[2]);
 #endif
-    } else if (pbeparm->calcforce == PCF_COMPS) {
-        *nforce = Valist_getNumberAtoms(alist[pbeparm->molid-1]);
-        *atomForce = (AtomForce *)Vmem_malloc(mem, *nforce,
-                                              sizeof(AtomForce));
+    } else {
 #ifndef VAPBSQUIET
         Vnm_tprint( 1, "  Printing per-atom forces for molecule %d (kJ/mol/A)\n",
                     pbeparm->molid);
@@ -1715,60 +2088,43 @@ VPUBLIC int forceMG(Vmem *mem,
         Vnm_tprint( 1, "    db  n -- dielectric boundary force for atom n\n");
         Vnm_tprint( 1, "    ib  n -- ionic boundary force for atom n\n");
 #endif
-        for (j=0;j<Valist_getNumberAtoms(alist[pbeparm->molid-1]);j++) {
-            if (nosh->bogus == 0) {
-                VASSERT(Vpmg_qfForce(pmg, (*atomForce)[j].qfForce, j,
-                                     mgparm->chgm));
-                VASSERT(Vpmg_ibForce(pmg, (*atomForce)[j].ibForce, j,
-                                     pbeparm->srfm));
-                VASSERT(Vpmg_dbForce(pmg, (*atomForce)[j].dbForce, j,
-                                     pbeparm->srfm));
-            } else {
-                for (k=0; k<3; k++) {
-                    (*atomForce)[j].qfForce[k] = 0;
-                    (*atomForce)[j].ibForce[k] = 0;
-                    (*atomForce)[j].dbForce[k] = 0;
-                }
-            }
+        for (j=0; j<nforce; j++) {
 #ifndef VAPBSQUIET
             Vnm_tprint( 1, "mgF  tot %d  %4.3e  %4.3e  %4.3e\n", j,
                         Vunit_kb*pbeparm->temp*(1e-3)*Vunit_Na \
-                        *((*atomForce)[j].qfForce[0]+(*atomForce)[j].ibForce[0]+
-                          (*atomForce)[j].dbForce[0]),
+                        *(atomForce[j].qfForce[0]+atomForce[j].ibForce[0]+
+                          atomForce[j].dbForce[0]),
                         Vunit_kb*pbeparm->temp*(1e-3)*Vunit_Na \
-                        *((*atomForce)[j].qfForce[1]+(*atomForce)[j].ibForce[1]+
-                          (*atomForce)[j].dbForce[1]),
+                        *(atomForce[j].qfForce[1]+atomForce[j].ibForce[1]+
+                          atomForce[j].dbForce[1]),
                         Vunit_kb*pbeparm->temp*(1e-3)*Vunit_Na \
-                        *((*atomForce)[j].qfForce[2]+(*atomForce)[j].ibForce[2]+
-                          (*atomForce)[j].dbForce[2]));
+                        *(atomForce[j].qfForce[2]+atomForce[j].ibForce[2]+
+                          atomForce[j].dbForce[2]));
             Vnm_tprint( 1, "mgF  qf  %d  %4.3e  %4.3e  %4.3e\n", j,
                         Vunit_kb*pbeparm->temp*(1e-3)*Vunit_Na \
-                        *(*atomForce)[j].qfForce[0],
+                        *atomForce[j].qfForce[0],
                         Vunit_kb*pbeparm->temp*(1e-3)*Vunit_Na \
-                        *(*atomForce)[j].qfForce[1],
+                        *atomForce[j].qfForce[1],
                         Vunit_kb*pbeparm->temp*(1e-3)*Vunit_Na \
-                        *(*atomForce)[j].qfForce[2]);
+                        *atomForce[j].qfForce[2]);
             Vnm_tprint( 1, "mgF  ib  %d  %4.3e  %4.3e  %4.3e\n", j,
                         Vunit_kb*pbeparm->temp*(1e-3)*Vunit_Na \
-                        *(*atomForce)[j].ibForce[0],
+                        *atomForce[j].ibForce[0],
                         Vunit_kb*pbeparm->temp*(1e-3)*Vunit_Na \
-                        *(*atomForce)[j].ibForce[1],
+                        *atomForce[j].ibForce[1],
                         Vunit_kb*pbeparm->temp*(1e-3)*Vunit_Na \
-                        *(*atomForce)[j].ibForce[2]);
+                        *atomForce[j].ibForce[2]);
             Vnm_tprint( 1, "mgF  db  %d  %4.3e  %4.3e  %4.3e\n", j,
                         Vunit_kb*pbeparm->temp*(1e-3)*Vunit_Na \
-                        *(*atomForce)[j].dbForce[0],
+                        *atomForce[j].dbForce[0],
                         Vunit_kb*pbeparm->temp*(1e-3)*Vunit_Na \
-                        *(*atomForce)[j].dbForce[1],
+                        *atomForce[j].dbForce[1],
                         Vunit_kb*pbeparm->temp*(1e-3)*Vunit_Na \
-                        *(*atomForce)[j].dbForce[2]);
+                        *atomForce[j].dbForce[2]);
 #endif
         }
-    } else *nforce = 0;
-
-    Vnm_tstop(APBS_TIMER_FORCE, "Force timer");
+    }
 
-    return 1;
 }
 
 VPUBLIC void killEnergy() {
@@ -2008,6 +2364,10 @@ VPUBLIC int writedataFlat(
             case BCFL_MDH:
                 fprintf(file,"    bcfl mdh\n");
                 break;
+            case BCFL_MDHTREE:
+                fprintf(file,"    bcfl mdhtree\n");
+                fprintf(file,"    bctol %g\n", pbeparm->bctol);
+                break;
             case BCFL_FOCUS:
                 fprintf(file,"    bcfl focus\n");
                 break;
@@ -2254,6 +2614,9 @@ VPUBLIC int writedataXML(NOsh *nosh, Vcom *com, const char *fname,
             case BCFL_MDH:
                 fprintf(file,"      <bcfl>mdh</bcfl>\n");
                 break;
+            case BCFL_MDHTREE:
+                fprintf(file,"      <bcfl>mdhtree</bcfl>\n");
+                break;
             case BCFL_FOCUS:
                 fprintf(file,"      <bcfl>focus</bcfl>\n");
                 break;
@@ -2380,275 +2743,254 @@ fclose(file);
 return 1;
 }
 
-VPUBLIC int writedataMG(int rank,
-                        NOsh *nosh,
-                        PBEparm *pbeparm,
-                        Vpmg *pmg
-                       ) {
+VPUBLIC int filldataMG(Vpmg *pmg,
+                       PBEparm *pbeparm,
+                       Vdata_Type type,
+                       double *vec,
+                       double origin[3],
+                       char what[72],
+                       char title[72]
+                      ) {
 
-    char writestem[VMAX_ARGLEN];
-    char outpath[VMAX_ARGLEN];
-    char title[72];
-    int i,
-        nx,
+    int nx,
         ny,
-        nz,
-        natoms;
+        nz;
     double hx,
            hy,
            hzed,
-           xcent,
-           ycent,
-           zcent,
-           xmin,
-           ymin,
-           zmin;
-
-    Vgrid *grid;
-    Vio *sock;
+           shift[3],
+           parm;
+
+    nx = pmg->pmgp->nx;
+    ny = pmg->pmgp->ny;
+    nz = pmg->pmgp->nz;
+    hx = pmg->pmgp->hx;
+    hy = pmg->pmgp->hy;
+    hzed = pmg->pmgp->hzed;
+    shift[0] = 0.0;
+    shift[1] = 0.0;
+    shift[2] = 0.0;
+    parm = 0.0;
+
+    switch (type) {
+
+        case VDT_CHARGE:
+            sprintf(what, "charge distribution");
+            sprintf(title, "CHARGE DISTRIBUTION (e)");
+            break;
 
-    if (nosh->bogus) return 1;
+        case VDT_POT:
+            sprintf(what, "potential");
+            sprintf(title, "POTENTIAL (kT/e)");
+            break;
 
-    for (i=0; i<pbeparm->numwrite; i++) {
+        case VDT_SMOL:
+            parm = pbeparm->srad;
+            sprintf(what, "molecular accessibility");
+            sprintf(title,
+                    "SOLVENT ACCESSIBILITY -- MOLECULAR (%4.3f PROBE)",
+                    pbeparm->srad);
+            break;
 
-        nx = pmg->pmgp->nx;
-        ny = pmg->pmgp->ny;
-        nz = pmg->pmgp->nz;
-        hx = pmg->pmgp->hx;
-        hy = pmg->pmgp->hy;
-        hzed = pmg->pmgp->hzed;
+        case VDT_SSPL:
+            parm = pbeparm->swin;
+            sprintf(what, "spline-based accessibility");
+            sprintf(title,
+                    "SOLVENT ACCESSIBILITY -- SPLINE (%4.3f WINDOW)",
+                    pbeparm->swin);
+            break;
 
-        switch (pbeparm->writetype[i]) {
+        case VDT_VDW:
+            sprintf(what, "van der Waals accessibility");
+            sprintf(title, "SOLVENT ACCESSIBILITY -- VAN DER WAALS");
+            break;
 
-            case VDT_CHARGE:
+        case VDT_IVDW:
+            parm = pmg->pbe->maxIonRadius;
+            sprintf(what, "ion accessibility");
+            sprintf(title,
+                    "ION ACCESSIBILITY -- SPLINE (%4.3f RADIUS)",
+                    pmg->pbe->maxIonRadius);
+            break;
 
-                Vnm_tprint(1, "  Writing charge distribution to ");
-                xcent = pmg->pmgp->xcent;
-                ycent = pmg->pmgp->ycent;
-                zcent = pmg->pmgp->zcent;
-                xmin = xcent - 0.5*(nx-1)*hx;
-                ymin = ycent - 0.5*(ny-1)*hy;
-                zmin = zcent - 0.5*(nz-1)*hzed;
-                VASSERT(Vpmg_fillArray(pmg, pmg->rwork, VDT_CHARGE, 0.0,
-                                       pbeparm->pbetype, pbeparm));
-                sprintf(title, "CHARGE DISTRIBUTION (e)");
-                break;
+        case VDT_LAP:
+            sprintf(what, "potential Laplacian");
+            sprintf(title,
+                    "POTENTIAL LAPLACIAN (kT/e/A^2)");
+            break;
 
-            case VDT_POT:
+        case VDT_EDENS:
+            sprintf(what, "energy density");
+            sprintf(title, "ENERGY DENSITY (kT/e/A)^2");
+            break;
 
-                Vnm_tprint(1, "  Writing potential to ");
-                xcent = pmg->pmgp->xcent;
-                ycent = pmg->pmgp->ycent;
-                zcent = pmg->pmgp->zcent;
-                xmin = xcent - 0.5*(nx-1)*hx;
-                ymin = ycent - 0.5*(ny-1)*hy;
-                zmin = zcent - 0.5*(nz-1)*hzed;
-                VASSERT(Vpmg_fillArray(pmg, pmg->rwork, VDT_POT, 0.0,
-                                       pbeparm->pbetype, pbeparm));
-                sprintf(title, "POTENTIAL (kT/e)");
-                break;
+        case VDT_NDENS:
+            sprintf(what, "number density");
+            sprintf(title,
+                    "ION NUMBER DENSITY (M)");
+            break;
 
-            case VDT_SMOL:
+        case VDT_QDENS:
+            sprintf(what, "charge density");
+            sprintf(title,
+                    "ION CHARGE DENSITY (e_c * M)");
+            break;
 
-                Vnm_tprint(1, "  Writing molecular accessibility to ");
-                xcent = pmg->pmgp->xcent;
-                ycent = pmg->pmgp->ycent;
-                zcent = pmg->pmgp->zcent;
-                xmin = xcent - 0.5*(nx-1)*hx;
-                ymin = ycent - 0.5*(ny-1)*hy;
-                zmin = zcent - 0.5*(nz-1)*hzed;
-                VASSERT(Vpmg_fillArray(pmg, pmg->rwork, VDT_SMOL,
-                                       pbeparm->srad, pbeparm->pbetype, pbeparm));
-                sprintf(title,
-                        "SOLVENT ACCESSIBILITY -- MOLECULAR (%4.3f PROBE)",
-                        pbeparm->srad);
-                break;
+        case VDT_DIELX:
+            shift[0] = 0.5*hx;
+            sprintf(what, "x-shifted dielectric map");
+            sprintf(title,
+                    "X-SHIFTED DIELECTRIC MAP");
+            break;
 
-            case VDT_SSPL:
+        case VDT_DIELY:
+            shift[1] = 0.5*hy;
+            sprintf(what, "y-shifted dielectric map");
+            sprintf(title,
+                    "Y-SHIFTED DIELECTRIC MAP");
+            break;
 
-                Vnm_tprint(1, "  Writing spline-based accessibility to ");
-                xcent = pmg->pmgp->xcent;
-                ycent = pmg->pmgp->ycent;
-                zcent = pmg->pmgp->zcent;
-                xmin = xcent - 0.5*(nx-1)*hx;
-                ymin = ycent - 0.5*(ny-1)*hy;
-                zmin = zcent - 0.5*(nz-1)*hzed;
-                VASSERT(Vpmg_fillArray(pmg, pmg->rwork, VDT_SSPL,
-                                       pbeparm->swin, pbeparm->pbetype, pbeparm));
-                sprintf(title,
-                        "SOLVENT ACCESSIBILITY -- SPLINE (%4.3f WINDOW)",
-                        pbeparm->swin);
-                break;
+        case VDT_DIELZ:
+            shift[2] = 0.5*hzed;
+            sprintf(what, "z-shifted dielectric map");
+            sprintf(title,
+                    "Z-SHIFTED DIELECTRIC MAP");
+            break;
 
-            case VDT_VDW:
+        case VDT_KAPPA:
+            sprintf(what, "kappa map");
+            sprintf(title,
+                    "KAPPA MAP");
+            break;
 
-                Vnm_tprint(1, "  Writing van der Waals accessibility to ");
-                xcent = pmg->pmgp->xcent;
-                ycent = pmg->pmgp->ycent;
-                zcent = pmg->pmgp->zcent;
-                xmin = xcent - 0.5*(nx-1)*hx;
-                ymin = ycent - 0.5*(ny-1)*hy;
-                zmin = zcent - 0.5*(nz-1)*hzed;
-                VASSERT(Vpmg_fillArray(pmg, pmg->rwork, VDT_VDW, 0.0,
-                                       pbeparm->pbetype, pbeparm));
-                sprintf(title, "SOLVENT ACCESSIBILITY -- VAN DER WAALS");
-                break;
+        case VDT_ATOMPOT:
+            sprintf(what, "atom potentials");
+            sprintf(title,
+                    "ATOM POTENTIALS");
+            break;
 
-            case VDT_IVDW:
+        default:
+            Vnm_tprint(2, "Invalid data type for writing!\n");
+            return 0;
+    }
 
-                Vnm_tprint(1, "  Writing ion accessibility to ");
-                xcent = pmg->pmgp->xcent;
-                ycent = pmg->pmgp->ycent;
-                zcent = pmg->pmgp->zcent;
-                xmin = xcent - 0.5*(nx-1)*hx;
-                ymin = ycent - 0.5*(ny-1)*hy;
-                zmin = zcent - 0.5*(nz-1)*hzed;
-                VASSERT(Vpmg_fillArray(pmg, pmg->rwork, VDT_IVDW,
-                                       pmg->pbe->maxIonRadius, pbeparm->pbetype, pbeparm));
-                sprintf(title,
-                        "ION ACCESSIBILITY -- SPLINE (%4.3f RADIUS)",
-                        pmg->pbe->maxIonRadius);
-                break;
+    origin[0] = pmg->pmgp->xcent + shift[0] - 0.5*(nx-1)*hx;
+    origin[1] = pmg->pmgp->ycent + shift[1] - 0.5*(ny-1)*hy;
+    origin[2] = pmg->pmgp->zcent + shift[2] - 0.5*(nz-1)*hzed;
+    VASSERT(Vpmg_fillArray(pmg, vec, type, parm, pbeparm->pbetype, pbeparm));
 
-            case VDT_LAP:
+    return 1;
+}
 
-                Vnm_tprint(1, "  Writing potential Laplacian to ");
-                xcent = pmg->pmgp->xcent;
-                ycent = pmg->pmgp->ycent;
-                zcent = pmg->pmgp->zcent;
-                xmin = xcent - 0.5*(nx-1)*hx;
-                ymin = ycent - 0.5*(ny-1)*hy;
-                zmin = zcent - 0.5*(nz-1)*hzed;
-                VASSERT(Vpmg_fillArray(pmg, pmg->rwork, VDT_LAP, 0.0,
-                                       pbeparm->pbetype, pbeparm));
-                sprintf(title,
-                        "POTENTIAL LAPLACIAN (kT/e/A^2)");
-                break;
+VPUBLIC int writegridMG(Vgrid *grid,
+                        double *pvec,
+                        int natoms,
+                        Vdata_Format format,
+                        char *writestem,
+                        char *title
+                       ) {
 
-            case VDT_EDENS:
+    char outpath[VMAX_ARGLEN];
+    int i;
+    Vio *sock;
 
-                Vnm_tprint(1, "  Writing energy density to ");
-                xcent = pmg->pmgp->xcent;
-                ycent = pmg->pmgp->ycent;
-                zcent = pmg->pmgp->zcent;
-                xmin = xcent - 0.5*(nx-1)*hx;
-                ymin = ycent - 0.5*(ny-1)*hy;
-                zmin = zcent - 0.5*(nz-1)*hzed;
-                VASSERT(Vpmg_fillArray(pmg, pmg->rwork, VDT_EDENS, 0.0,
-                                       pbeparm->pbetype, pbeparm));
-                sprintf(title, "ENERGY DENSITY (kT/e/A)^2");
-                break;
+    switch (format) {
 
-            case VDT_NDENS:
+        case VDF_DX:
+            sprintf(outpath, "%s.%s", writestem, "dx");
+            Vnm_tprint(1, "%s\n", outpath);
+            Vgrid_writeDX(grid, "FILE", "ASC", VNULL, outpath, title, pvec);
+            break;
 
-                Vnm_tprint(1, "  Writing number density to ");
-                xcent = pmg->pmgp->xcent;
-                ycent = pmg->pmgp->ycent;
-                zcent = pmg->pmgp->zcent;
-                xmin = xcent - 0.5*(nx-1)*hx;
-                ymin = ycent - 0.5*(ny-1)*hy;
-                zmin = zcent - 0.5*(nz-1)*hzed;
-                VASSERT(Vpmg_fillArray(pmg, pmg->rwork, VDT_NDENS, 0.0,
-                                       pbeparm->pbetype, pbeparm));
-                sprintf(title,
-                        "ION NUMBER DENSITY (M)");
-                break;
+        case VDF_DXBIN:
+            sprintf(outpath, "%s.%s", writestem, "dxbin");
+            Vnm_tprint(1, "%s\n", outpath);
+            //TODO: write Vgrid_writeDXBIN method
+            Vgrid_writeDXBIN(grid, "FILE", "ASC", VNULL, outpath, title, pvec);
+            break;
 
-            case VDT_QDENS:
+        case VDF_AVS:
+            sprintf(outpath, "%s.%s", writestem, "ucd");
+            Vnm_tprint(1, "%s\n", outpath);
+            Vnm_tprint(2, "Sorry, AVS format isn't supported for \
+uniform meshes yet!\n");
+            break;
 
-                Vnm_tprint(1, "  Writing charge density to ");
-                xcent = pmg->pmgp->xcent;
-                ycent = pmg->pmgp->ycent;
-                zcent = pmg->pmgp->zcent;
-                xmin = xcent - 0.5*(nx-1)*hx;
-                ymin = ycent - 0.5*(ny-1)*hy;
-                zmin = zcent - 0.5*(nz-1)*hzed;
-                VASSERT(Vpmg_fillArray(pmg, pmg->rwork, VDT_QDENS, 0.0,
-                                       pbeparm->pbetype, pbeparm));
-                sprintf(title,
-                        "ION CHARGE DENSITY (e_c * M)");
-                break;
+        case VDF_MCSF:
+            sprintf(outpath, "%s.%s", writestem, "mcsf");
+            Vnm_tprint(1, "%s\n", outpath);
+            Vnm_tprint(2, "Sorry, MCSF format isn't supported for \
+                       uniform meshes yet!\n");
+            break;
 
-            case VDT_DIELX:
+        case VDF_UHBD:
+            sprintf(outpath, "%s.%s", writestem, "grd");
+            Vnm_tprint(1, "%s\n", outpath);
+            Vgrid_writeUHBD(grid, "FILE", "ASC", VNULL, outpath, title, pvec);
+            break;
 
-                Vnm_tprint(1, "  Writing x-shifted dielectric map to ");
-                xcent = pmg->pmgp->xcent + 0.5*hx;
-                ycent = pmg->pmgp->ycent;
-                zcent = pmg->pmgp->zcent;
-                xmin = xcent - 0.5*(nx-1)*hx;
-                ymin = ycent - 0.5*(ny-1)*hy;
-                zmin = zcent - 0.5*(nz-1)*hzed;
-                VASSERT(Vpmg_fillArray(pmg, pmg->rwork, VDT_DIELX, 0.0,
-                                       pbeparm->pbetype, pbeparm));
-                sprintf(title,
-                        "X-SHIFTED DIELECTRIC MAP");
-                break;
+        case VDF_GZ:
+            sprintf(outpath, "%s.%s", writestem, "dx.gz");
+            Vnm_tprint(1, "%s\n", outpath);
+            Vgrid_writeGZ(grid, "FILE", "ASC", VNULL, outpath, title, pvec);
+            break;
 
-            case VDT_DIELY:
+        case VDF_FLAT:
+            sprintf(outpath, "%s.%s", writestem, "txt");
+            Vnm_tprint(1, "%s\n", outpath);
+            Vnm_print(0, "routines:  Opening virtual socket...\n");
+            sock = Vio_ctor("FILE","ASC",VNULL,outpath,"w");
+            if (sock == VNULL) {
+                Vnm_print(2, "routines:  Problem opening virtual socket %s\n",
+                          outpath);
+                return 0;
+            }
+            if (Vio_connect(sock, 0) < 0) {
+                Vnm_print(2, "routines: Problem connecting virtual socket %s\n",
+                          outpath);
+                return 0;
+            }
+            Vio_printf(sock, "# Data from %s\n", PACKAGE_STRING);
+            Vio_printf(sock, "# \n");
+            Vio_printf(sock, "# %s\n", title);
+            Vio_printf(sock, "# \n");
+            for (i=0; i<natoms; i++)
+                Vio_printf(sock, "%12.6e\n", grid->data[i]);
+            Vio_connectFree(sock);
+            Vio_dtor(&sock);
+            break;
 
-                Vnm_tprint(1, "  Writing y-shifted dielectric map to ");
-                xcent = pmg->pmgp->xcent;
-                ycent = pmg->pmgp->ycent + 0.5*hy;
-                zcent = pmg->pmgp->zcent;
-                xmin = xcent - 0.5*(nx-1)*hx;
-                ymin = ycent - 0.5*(ny-1)*hy;
-                zmin = zcent - 0.5*(nz-1)*hzed;
-                VASSERT(Vpmg_fillArray(pmg, pmg->rwork, VDT_DIELY, 0.0,
-                                       pbeparm->pbetype, pbeparm));
-                sprintf(title,
-                        "Y-SHIFTED DIELECTRIC MAP");
-                break;
+        default:
+            Vnm_tprint(2, "Bogus data format (%d)!\n", format);
+            break;
+    }
 
-            case VDT_DIELZ:
+    return 1;
+}
 
-                Vnm_tprint(1, "  Writing z-shifted dielectric map to ");
-                xcent = pmg->pmgp->xcent;
-                ycent = pmg->pmgp->ycent;
-                zcent = pmg->pmgp->zcent + 0.5*hzed;
-                xmin = xcent - 0.5*(nx-1)*hx;
-                ymin = ycent - 0.5*(ny-1)*hy;
-                zmin = zcent - 0.5*(nz-1)*hzed;
-                VASSERT(Vpmg_fillArray(pmg, pmg->rwork, VDT_DIELZ, 0.0,
-                                       pbeparm->pbetype, pbeparm));
-                sprintf(title,
-                        "Z-SHIFTED DIELECTRIC MAP");
-                break;
+VPUBLIC int writedataMG(int rank,
+                        NOsh *nosh,
+                        PBEparm *pbeparm,
+                        Vpmg *pmg
+                       ) {
 
-            case VDT_KAPPA:
+    char writestem[VMAX_ARGLEN];
+    char what[72];
+    char title[72];
+    int i;
+    double origin[3];
 
-                Vnm_tprint(1, "  Writing kappa map to ");
-                xcent = pmg->pmgp->xcent;
-                ycent = pmg->pmgp->ycent;
-                zcent = pmg->pmgp->zcent;
-                xmin = xcent - 0.5*(nx-1)*hx;
-                ymin = ycent - 0.5*(ny-1)*hy;
-                zmin = zcent - 0.5*(nz-1)*hzed;
-                VASSERT(Vpmg_fillArray(pmg, pmg->rwork, VDT_KAPPA, 0.0,
-                                       pbeparm->pbetype, pbeparm));
-                sprintf(title,
-                        "KAPPA MAP");
-                break;
+    Vgrid *grid;
 
-            case VDT_ATOMPOT:
+    if (nosh->bogus) return 1;
 
-                Vnm_tprint(1, "  Writing atom potentials to ");
-                xcent = pmg->pmgp->xcent;
-                ycent = pmg->pmgp->ycent;
-                zcent = pmg->pmgp->zcent;
-                xmin = xcent - 0.5*(nx-1)*hx;
-                ymin = ycent - 0.5*(ny-1)*hy;
-                zmin = zcent - 0.5*(nz-1)*hzed;
-                VASSERT(Vpmg_fillArray(pmg, pmg->rwork, VDT_ATOMPOT, 0.0,
-                                       pbeparm->pbetype, pbeparm));
-                sprintf(title,
-                        "ATOM POTENTIALS");
-                break;
-            default:
+    for (i=0; i<pbeparm->numwrite; i++) {
 
-                Vnm_tprint(2, "Invalid data type for writing!\n");
-                return 0;
+        if (!filldataMG(pmg, pbeparm, pbeparm->writetype[i], pmg->rwork,
+                        origin, what, title)) {
+            return 0;
         }
-
+        Vnm_tprint(1, "  Writing %s to ", what);
 
 #ifdef HAVE_MPI_H
         sprintf(writestem, "%s-PE%d", pbeparm->writestem[i], rank);
@@ -2660,94 +3002,519 @@ VPUBLIC int writedataMG(int rank,
         }
 #endif
 
-        switch (pbeparm->writefmt[i]) {
+        grid = Vgrid_ctor(pmg->pmgp->nx, pmg->pmgp->ny, pmg->pmgp->nz,
+                          pmg->pmgp->hx, pmg->pmgp->hy, pmg->pmgp->hzed,
+                          origin[0], origin[1], origin[2], pmg->rwork);
+        writegridMG(grid, pmg->pvec, Valist_getNumberAtoms(pmg->pbe->alist),
+                    pbeparm->writefmt[i], writestem, title);
+        Vgrid_dtor(&grid);
 
-            case VDF_DX:
-                sprintf(outpath, "%s.%s", writestem, "dx");
-                Vnm_tprint(1, "%s\n", outpath);
-                grid = Vgrid_ctor(nx, ny, nz, hx, hy, hzed, xmin, ymin, zmin,
-                                  pmg->rwork);
-                Vgrid_writeDX(grid, "FILE", "ASC", VNULL, outpath, title,
-                              pmg->pvec);
-                Vgrid_dtor(&grid);
-                break;
+    }
 
-            case VDF_DXBIN:
-        sprintf(outpath, "%s.%s", writestem, "dxbin");
-        Vnm_tprint(1, "%s\n", outpath);
-        grid = Vgrid_ctor(nx, ny, nz, hx, hy, hzed, xmin, ymin, zmin,
-                  pmg->rwork);
-        //TODO: write Vgrid_writeDXBIN method
-        Vgrid_writeDXBIN(grid, "FILE", "ASC", VNULL, outpath, title,
-                pmg->pvec);
-        Vgrid_dtor(&grid);
-        break;
+    return 1;
+}
 
-            case VDF_AVS:
-                sprintf(outpath, "%s.%s", writestem, "ucd");
-                Vnm_tprint(1, "%s\n", outpath);
-                Vnm_tprint(2, "Sorry, AVS format isn't supported for \
-uniform meshes yet!\n");
-                break;
+/* What one subdomain of an in-process parallel calculation contributes; kept
+ * until every subdomain is done so the sums do not depend on the order in
+ * which the threads finish */
+typedef struct InprocPart {
+    int rc;  /* 1 if the subdomain was solved */
+    double totEnergy;  /* Energies of the subdomain (in kT) */
+    double qfEnergy;
+    double qmEnergy;
+    double dielEnergy;
+    int nown;  /* Number of atoms with a positive partition weight */
+    int *own;  /* Their indices */
+    double *energy;  /* Their charge-potential energies */
+    AtomForce *force;  /* Their forces, scaled by the partition weight */
+    double *atompot;  /* Their potentials scaled by the partition weight,
+                       * nown for each write of atom potentials */
+    int natompot;  /* Length of atompot */
+    int npts;  /* Number of global mesh points this subdomain wrote */
+} InprocPart;
+
+VPUBLIC int inprocMG(Vmem *mem,
+                     NOsh *nosh,
+                     int ielec,
+                     int icalc,
+                     Valist *alist[NOSH_MAXMOL],
+                     Vgrid *dielXMap[NOSH_MAXMOL],
+                     Vgrid *dielYMap[NOSH_MAXMOL],
+                     Vgrid *dielZMap[NOSH_MAXMOL],
+                     Vgrid *kappaMap[NOSH_MAXMOL],
+                     Vgrid *chargeMap[NOSH_MAXMOL],
+                     Vgrid *potMap[NOSH_MAXMOL],
+                     Vpbe *pbe[NOSH_MAXCALC],
+                     Vpmgp *pmgp[NOSH_MAXCALC],
+                     Vpmg *pmg[NOSH_MAXCALC],
+                     int nenergy[NOSH_MAXCALC],
+                     double totEnergy[NOSH_MAXCALC],
+                     double qfEnergy[NOSH_MAXCALC],
+                     double qmEnergy[NOSH_MAXCALC],
+                     double dielEnergy[NOSH_MAXCALC],
+                     double *atomEnergy[NOSH_MAXCALC],
+                     int nforce[NOSH_MAXCALC],
+                     AtomForce *atomForce[NOSH_MAXCALC]
+                    ) {
 
-            case VDF_MCSF:
-                sprintf(outpath, "%s.%s", writestem, "mcsf");
-                Vnm_tprint(1, "%s\n", outpath);
-                Vnm_tprint(2, "Sorry, MCSF format isn't supported for \
-                           uniform meshes yet!\n");
-                break;
+    char writestem[VMAX_ARGLEN];
+    char what[PBEPARM_MAXWRITE][72];
+    char title[PBEPARM_MAXWRITE][72];
+    int i,
+        j,
+        k,
+        iw,
+        isub,
+        nsub,
+        ilast,
+        natoms,
+        ngrid,
+        npts,
+        rc,
+        gn[3];
+    double conversion,
+           h[3],
+           gmin[3],
+           origin[PBEPARM_MAXWRITE][3];
+    double *data[PBEPARM_MAXWRITE];
+    NOsh **sub = VNULL;
+    NOsh_calc *elec = VNULL;
+    MGparm *mgparm = VNULL,
+           *fine = VNULL;
+    PBEparm *pbeparm = VNULL;
+    Vpbe *thepbe = VNULL;
+    Valist *myalist = VNULL;
+    Vgrid *grid = VNULL;
+    InprocPart *part = VNULL;
+
+    /* The ELEC statement still holds the global mesh */
+    elec = nosh->elec[ielec];
+    mgparm = elec->mgparm;
+    pbeparm = elec->pbeparm;
+    ilast = nosh->elec2calc[ielec];
+    nsub = mgparm->pdime[0]*mgparm->pdime[1]*mgparm->pdime[2];
+    myalist = alist[pbeparm->molid-1];
+    natoms = Valist_getNumberAtoms(myalist);
+    conversion = Vunit_kb*pbeparm->temp*(1e-3)*Vunit_Na;
 
-            case VDF_UHBD:
-                sprintf(outpath, "%s.%s", writestem, "grd");
-                Vnm_tprint(1, "%s\n", outpath);
-                grid = Vgrid_ctor(nx, ny, nz, hx, hy, hzed, xmin, ymin, zmin,
-                                  pmg->rwork);
-                Vgrid_writeUHBD(grid, "FILE", "ASC", VNULL, outpath, title,
-                                pmg->pvec);
-                Vgrid_dtor(&grid);
-                break;
+    Vnm_tprint(1, "  Solving %d subdomains in this process...\n", nsub);
+    if (pbeparm->writemat == 1) {
+        Vnm_tprint(2, "  Matrices can't be written for 'inproc' \
+calculations; not writing %s!\n", pbeparm->writematstem);
+    }
 
-            case VDF_GZ:
-                sprintf(outpath, "%s.%s", writestem, "dx.gz");
-                Vnm_tprint(1, "%s\n", outpath);
-                grid = Vgrid_ctor(nx, ny, nz, hx, hy, hzed, xmin, ymin, zmin,
-                                  pmg->rwork);
-                Vgrid_writeGZ(grid, "FILE", "ASC", VNULL, outpath, title,
-                              pmg->pvec);
-                Vgrid_dtor(&grid);
+    /* The objects of the previous calculation are not needed anymore */
+    if (icalc > 0) {
+        Vpmg_dtor(&(pmg[icalc-1]));
+        Vpmgp_dtor(&(pmgp[icalc-1]));
+        Vpbe_dtor(&(pbe[icalc-1]));
+    }
+    for (i=icalc; i<=ilast; i++) {
+        nenergy[i] = 0;
+        nforce[i] = 0;
+        totEnergy[i] = 0.0;
+        qfEnergy[i] = 0.0;
+        qmEnergy[i] = 0.0;
+        dielEnergy[i] = 0.0;
+    }
+
+    /* Set up each subdomain as its own asynchronous mg-para calculation */
+    sub = (NOsh **)Vmem_malloc(mem, nsub, sizeof(NOsh *));
+    part = (InprocPart *)Vmem_malloc(mem, nsub, sizeof(InprocPart));
+    rc = 1;
+    for (isub=0; isub<nsub; isub++) {
+        sub[isub] = NOsh_ctor(isub, nsub);
+        sub[isub]->nmol = nosh->nmol;
+        sub[isub]->ndiel = nosh->ndiel;
+        sub[isub]->nkappa = nosh->nkappa;
+        sub[isub]->ncharge = nosh->ncharge;
+        sub[isub]->npot = nosh->npot;
+        sub[isub]->elec[0] = NOsh_calc_ctor(NCT_MG);
+        NOsh_calc_copy(sub[isub]->elec[0], elec);
+        sub[isub]->nelec = 1;
+        sub[isub]->elec[0]->mgparm->inproc = 0;
+        sub[isub]->elec[0]->mgparm->setinproc = 0;
+        sub[isub]->elec[0]->mgparm->async = isub;
+        sub[isub]->elec[0]->mgparm->setasync = 1;
+        if (!NOsh_setupElecCalc(sub[isub], alist)
+          || (sub[isub]->ncalc < 1)) {
+            Vnm_tprint(2, "  Error setting up subdomain %d!\n", isub);
+            rc = 0;
+        }
+    }
+    if (!rc) {
+        for (isub=0; isub<nsub; isub++) NOsh_dtor(&(sub[isub]));
+        Vmem_free(mem, nsub, sizeof(NOsh *), (void **)&sub);
+        Vmem_free(mem, nsub, sizeof(InprocPart), (void **)&part);
+        return 0;
+    }
+
+    /* The global mesh has the spacing of the finest subdomain meshes */
+    fine = sub[0]->calc[sub[0]->ncalc-1]->mgparm;
+    ngrid = 1;
+    for (j=0; j<3; j++) {
+        h[j] = fine->glen[j]/(double)(fine->dime[j]-1);
+        gmin[j] = mgparm->fcenter[j] - 0.5*mgparm->fglen[j];
+        gn[j] = (int)floor(mgparm->fglen[j]/h[j] + 0.5) + 1;
+        ngrid *= gn[j];
+    }
+    for (iw=0; iw<pbeparm->numwrite; iw++) {
+        if (pbeparm->writetype[iw] == VDT_ATOMPOT) {
+            data[iw] = (double *)Vmem_malloc(mem, VMAX2(natoms,1),
+                                             sizeof(double));
+            for (i=0; i<natoms; i++) data[iw][i] = 0.0;
+        } else {
+            data[iw] = (double *)Vmem_malloc(mem, ngrid, sizeof(double));
+            for (i=0; i<ngrid; i++) data[iw][i] = 0.0;
+        }
+    }
+
+    /* All subdomains and focusing levels share one PBE object; it only
+     * depends on the molecule and the PBE parameters */
+    thepbe = initPbeMG(pbeparm, myalist, 0);
+
+    /* Each subdomain is a task:  the focusing chain is solved and reduced to
+     * its share of the energies, forces and maps before the next is taken.
+     * The solver loops inside a task run on that task's thread.  The PMG ion
+     * parameters (see initIons) are global but every subdomain sets the
+     * same values. */
+#pragma omp parallel for default(shared) private(isub) schedule(dynamic,1)
+    for (isub=0; isub<nsub; isub++) {
+
+        NOsh *snosh = sub[isub];
+        InprocPart *res = &(part[isub]);
+        MGparm *smgparm = VNULL;
+        PBEparm *spbeparm = VNULL;
+        Vpbe *spbe[NOSH_MAXCALC];
+        Vpmgp *spmgp[NOSH_MAXCALC];
+        Vpmg *spmg[NOSH_MAXCALC];
+        Vpmg *thee = VNULL;
+        char swhat[72],
+             stitle[72];
+        double center[3],
+               sorigin[3],
+               smin[3],
+               tforce[3],
+               w;
+        int jc,
+            ja,
+            jw,
+            ii,
+            jj,
+            kk,
+            nx,
+            ny,
+            nz,
+            ok,
+            nap,
+            goff[3];
+
+        res->rc = 0;
+        res->totEnergy = 0.0;
+        res->qfEnergy = 0.0;
+        res->qmEnergy = 0.0;
+        res->dielEnergy = 0.0;
+        res->nown = 0;
+        res->own = VNULL;
+        res->energy = VNULL;
+        res->force = VNULL;
+        res->atompot = VNULL;
+        res->natompot = 0;
+        res->npts = 0;
+        for (jc=0; jc<NOSH_MAXCALC; jc++) {
+            spbe[jc] = VNULL;
+            spmgp[jc] = VNULL;
+            spmg[jc] = VNULL;
+        }
+
+        for (jc=0; jc<snosh->ncalc; jc++) {
+            smgparm = snosh->calc[jc]->mgparm;
+            spbeparm = snosh->calc[jc]->pbeparm;
+            spbe[jc] = thepbe;
+            if (jc > 0) spbe[jc-1] = VNULL;
+            if (!initMG(jc, snosh, smgparm, spbeparm, center, spbe, alist,
+                        dielXMap, dielYMap, dielZMap, kappaMap, chargeMap,
+                        spmgp, spmg, potMap)) {
+                Vnm_print(2, "inprocMG:  Error setting up subdomain %d!\n",
+                          isub);
                 break;
-            case VDF_FLAT:
-                sprintf(outpath, "%s.%s", writestem, "txt");
-                Vnm_tprint(1, "%s\n", outpath);
-                Vnm_print(0, "routines:  Opening virtual socket...\n");
-                sock = Vio_ctor("FILE","ASC",VNULL,outpath,"w");
-                if (sock == VNULL) {
-                    Vnm_print(2, "routines:  Problem opening virtual socket %s\n",
-                              outpath);
-                    return 0;
+            }
+            if (solveMG(snosh, spmg[jc], smgparm->type) != 1) {
+                Vnm_print(2, "inprocMG:  Error solving subdomain %d!\n",
+                          isub);
+                break;
+            }
+        }
+
+        if (jc == snosh->ncalc) {
+
+            thee = spmg[jc-1];
+            setPartMG(snosh, smgparm, thee);
+
+            /* Energies, including those outside this subdomain that no
+             * other subdomain counts */
+            if (pbeparm->calcenergy != PCE_NO) {
+                res->totEnergy = Vpmg_energy(thee, 1);
+            }
+            if (pbeparm->calcenergy == PCE_COMPS) {
+                res->qfEnergy = Vpmg_qfEnergy(thee, 1);
+                res->qmEnergy = Vpmg_qmEnergy(thee, 1);
+                res->dielEnergy = Vpmg_dielEnergy(thee, 1);
+            }
+
+            /* Per-atom results are only needed for the atoms in this
+             * subdomain */
+            nap = 0;
+            for (jw=0; jw<pbeparm->numwrite; jw++) {
+                if (pbeparm->writetype[jw] == VDT_ATOMPOT) nap++;
+            }
+            for (ja=0; ja<natoms; ja++) {
+                if (thee->apvec[ja] > 0.0) (res->nown)++;
+            }
+            res->own = (int *)Vmem_malloc(VNULL, VMAX2(res->nown,1),
+                                          sizeof(int));
+            res->energy = (double *)Vmem_malloc(VNULL, VMAX2(res->nown,1),
+                                                sizeof(double));
+            res->force = (AtomForce *)Vmem_malloc(VNULL, VMAX2(res->nown,1),
+                                                  sizeof(AtomForce));
+            res->natompot = VMAX2(nap*res->nown,1);
+            res->atompot = (double *)Vmem_malloc(VNULL, res->natompot,
+                                                 sizeof(double));
+            ii = 0;
+            for (ja=0; ja<natoms; ja++) {
+                if (thee->apvec[ja] > 0.0) res->own[ii++] = ja;
+            }
+
+            for (ii=0; ii<res->nown; ii++) {
+                ja = res->own[ii];
+                w = thee->apvec[ja];
+                res->energy[ii] = 0.0;
+                if (pbeparm->calcenergy == PCE_COMPS) {
+                    res->energy[ii] = Vpmg_qfAtomEnergy(thee,
+                                        Valist_getAtom(myalist, ja));
                 }
-                if (Vio_connect(sock, 0) < 0) {
-                    Vnm_print(2, "routines: Problem connecting virtual socket %s\n",
-                              outpath);
-                    return 0;
+                for (kk=0; kk<3; kk++) {
+                    res->force[ii].qfForce[kk] = 0.0;
+                    res->force[ii].ibForce[kk] = 0.0;
+                    res->force[ii].dbForce[kk] = 0.0;
                 }
-                Vio_printf(sock, "# Data from %s\n", PACKAGE_STRING);
-                Vio_printf(sock, "# \n");
-                Vio_printf(sock, "# %s\n", title);
-                Vio_printf(sock, "# \n");
-                natoms = pmg->pbe->alist[pbeparm->molid-1].number;
-                for(i=0;i<natoms;i++)
-                    Vio_printf(sock, "%12.6e\n", pmg->rwork[i]);
-                break;
-            default:
-                Vnm_tprint(2, "Bogus data format (%d)!\n",
-                           pbeparm->writefmt[i]);
+                if (pbeparm->calcforce != PCF_NO) {
+                    VASSERT(Vpmg_qfForce(thee, tforce, ja, smgparm->chgm));
+                    for (kk=0; kk<3; kk++) res->force[ii].qfForce[kk] = w*tforce[kk];
+                    VASSERT(Vpmg_ibForce(thee, tforce, ja, pbeparm->srfm));
+                    for (kk=0; kk<3; kk++) res->force[ii].ibForce[kk] = w*tforce[kk];
+                    VASSERT(Vpmg_dbForce(thee, tforce, ja, pbeparm->srfm));
+                    for (kk=0; kk<3; kk++) res->force[ii].dbForce[kk] = w*tforce[kk];
+                }
+            }
+
+            /* Copy the points this subdomain owns into the global maps; the
+             * disjoint partitions do not share mesh points */
+            nx = thee->pmgp->nx;
+            ny = thee->pmgp->ny;
+            nz = thee->pmgp->nz;
+            smin[0] = thee->pmgp->xcent - 0.5*(nx-1)*thee->pmgp->hx;
+            smin[1] = thee->pmgp->ycent - 0.5*(ny-1)*thee->pmgp->hy;
+            smin[2] = thee->pmgp->zcent - 0.5*(nz-1)*thee->pmgp->hzed;
+            for (kk=0; kk<3; kk++) {
+                goff[kk] = (int)floor((smin[kk] - gmin[kk])/h[kk] + 0.5);
+            }
+            nap = 0;
+            for (jw=0; jw<pbeparm->numwrite; jw++) {
+                /* The spline accessibility marks atoms in the shared Vacc */
+                if (pbeparm->writetype[jw] == VDT_SSPL) {
+#pragma omp critical (inprocMG_sspl)
+                    ok = filldataMG(thee, pbeparm, pbeparm->writetype[jw],
+                                    thee->rwork, sorigin, swhat, stitle);
+                } else {
+                    ok = filldataMG(thee, pbeparm, pbeparm->writetype[jw],
+                                    thee->rwork, sorigin, swhat, stitle);
+                }
+                if (!ok) break;
+                if (isub == 0) {
+                    strcpy(what[jw], swhat);
+                    strcpy(title[jw], stitle);
+                    for (kk=0; kk<3; kk++) {
+                        origin[jw][kk] = gmin[kk] + sorigin[kk] - smin[kk];
+                    }
+                }
+                if (pbeparm->writetype[jw] == VDT_ATOMPOT) {
+                    for (ii=0; ii<res->nown; ii++) {
+                        ja = res->own[ii];
+                        res->atompot[nap*res->nown + ii] =
+                            thee->apvec[ja]*thee->rwork[ja];
+                    }
+                    nap++;
+                    continue;
+                }
+                res->npts = 0;
+                for (kk=0; kk<nz; kk++) {
+                    for (jj=0; jj<ny; jj++) {
+                        for (ii=0; ii<nx; ii++) {
+                            if (!(thee->pvec[IJK(ii,jj,kk)] > 0.5)) continue;
+                            if ((goff[0]+ii < 0) || (goff[0]+ii >= gn[0])
+                              || (goff[1]+jj < 0) || (goff[1]+jj >= gn[1])
+                              || (goff[2]+kk < 0) || (goff[2]+kk >= gn[2])) {
+                                continue;
+                            }
+                            data[jw][(goff[2]+kk)*gn[0]*gn[1]
+                              + (goff[1]+jj)*gn[0] + goff[0]+ii]
+                              = thee->rwork[IJK(ii,jj,kk)];
+                            (res->npts)++;
+                        }
+                    }
+                }
+            }
+            if (jw == pbeparm->numwrite) res->rc = 1;
+        }
+
+        /* Only the last PMG object of the chain is left (see killMG); the
+         * PBE object belongs to inprocMG */
+        for (jc=NOSH_MAXCALC-1; jc>=0; jc--) {
+            if (spmg[jc] != VNULL) {
+                Vpmg_dtor(&(spmg[jc]));
                 break;
+            }
+        }
+        for (jc=0; jc<NOSH_MAXCALC; jc++) {
+            spbe[jc] = VNULL;
+            Vpmgp_dtor(&(spmgp[jc]));
         }
+    }
 
+    for (isub=0; isub<nsub; isub++) {
+        if (!part[isub].rc) rc = 0;
     }
 
-    return 1;
+    if (rc) {
+
+        /* Energies */
+        totEnergy[ilast] = 0.0;
+        for (isub=0; isub<nsub; isub++) {
+            totEnergy[ilast] += part[isub].totEnergy;
+            qfEnergy[ilast] += part[isub].qfEnergy;
+            qmEnergy[ilast] += part[isub].qmEnergy;
+            dielEnergy[ilast] += part[isub].dielEnergy;
+        }
+        if (pbeparm->calcenergy == PCE_TOTAL) {
+#ifndef VAPBSQUIET
+            Vnm_tprint( 1, "  Total electrostatic energy = %1.12E kJ/mol\n",
+                        conversion*totEnergy[ilast]);
+#endif
+        } else if (pbeparm->calcenergy == PCE_COMPS) {
+            nenergy[ilast] = natoms;
+            atomEnergy[ilast] = (double *)Vmem_malloc(mem, VMAX2(natoms,1),
+                                                      sizeof(double));
+            for (i=0; i<natoms; i++) atomEnergy[ilast][i] = 0.0;
+            for (isub=0; isub<nsub; isub++) {
+                for (i=0; i<part[isub].nown; i++) {
+                    atomEnergy[ilast][part[isub].own[i]] += part[isub].energy[i];
+                }
+            }
+#ifndef VAPBSQUIET
+            Vnm_tprint( 1, "  Total electrostatic energy = %1.12E \
+kJ/mol\n", conversion*totEnergy[ilast]);
+            Vnm_tprint( 1, "  Fixed charge energy = %g kJ/mol\n",
+                        0.5*conversion*qfEnergy[ilast]);
+            Vnm_tprint( 1, "  Mobile charge energy = %g kJ/mol\n",
+                        conversion*qmEnergy[ilast]);
+            Vnm_tprint( 1, "  Dielectric energy = %g kJ/mol\n",
+                        conversion*dielEnergy[ilast]);
+            Vnm_tprint( 1, "  Per-atom energies:\n");
+            for (i=0; i<natoms; i++) {
+                Vnm_tprint( 1, "      Atom %d:  %1.12E kJ/mol\n", i,
+                            0.5*conversion*atomEnergy[ilast][i]);
+            }
+#endif
+        }
+
+        /* Forces; atoms on a partition boundary are split between the
+         * subdomains that share them */
+        if (pbeparm->calcforce != PCF_NO) {
+            nforce[ilast] = (pbeparm->calcforce == PCF_TOTAL) ? 1 : natoms;
+            atomForce[ilast] = (AtomForce *)Vmem_malloc(mem, nforce[ilast],
+                                                        sizeof(AtomForce));
+            for (i=0; i<nforce[ilast]; i++) {
+                for (k=0; k<3; k++) {
+                    atomForce[ilast][i].qfForce[k] = 0.0;
+                    atomForce[ilast][i].ibForce[k] = 0.0;
+                    atomForce[ilast][i].dbForce[k] = 0.0;
+                }
+            }
+            for (isub=0; isub<nsub; isub++) {
+                for (i=0; i<part[isub].nown; i++) {
+                    j = (nforce[ilast] == 1) ? 0 : part[isub].own[i];
+                    for (k=0; k<3; k++) {
+                        atomForce[ilast][j].qfForce[k] += part[isub].force[i].qfForce[k];
+                        atomForce[ilast][j].ibForce[k] += part[isub].force[i].ibForce[k];
+                        atomForce[ilast][j].dbForce[k] += part[isub].force[i].dbForce[k];
+                    }
+                }
+            }
+            printforceMG(pbeparm, nforce[ilast], atomForce[ilast]);
+        }
+
+        /* Maps */
+        npts = 0;
+        for (isub=0; isub<nsub; isub++) npts += part[isub].npts;
+        k = 0;
+        for (iw=0; iw<pbeparm->numwrite; iw++) {
+            Vnm_tprint(1, "  Writing %s to ", what[iw]);
+            sprintf(writestem, "%s", pbeparm->writestem[iw]);
+            if (pbeparm->writetype[iw] == VDT_ATOMPOT) {
+                for (isub=0; isub<nsub; isub++) {
+                    for (i=0; i<part[isub].nown; i++) {
+                        data[iw][part[isub].own[i]] +=
+                            part[isub].atompot[k*part[isub].nown + i];
+                    }
+                }
+                k++;
+                grid = Vgrid_ctor(VMAX2(natoms,1), 1, 1, h[0], h[1], h[2],
+                                  origin[iw][0], origin[iw][1], origin[iw][2],
+                                  data[iw]);
+            } else {
+                grid = Vgrid_ctor(gn[0], gn[1], gn[2], h[0], h[1], h[2],
+                                  origin[iw][0], origin[iw][1], origin[iw][2],
+                                  data[iw]);
+            }
+            writegridMG(grid, VNULL, natoms, pbeparm->writefmt[iw], writestem,
+                        title[iw]);
+            Vgrid_dtor(&grid);
+            if ((pbeparm->writetype[iw] != VDT_ATOMPOT) && (npts != ngrid)) {
+                Vnm_tprint(2, "  Warning:  the subdomains cover %d of the %d \
+points of %s!\n", npts, ngrid, writestem);
+            }
+        }
+
+    } else {
+        Vnm_tprint(2, "  Error solving the subdomains!\n");
+    }
+
+    /* Clean up */
+    for (iw=0; iw<pbeparm->numwrite; iw++) {
+        if (pbeparm->writetype[iw] == VDT_ATOMPOT) {
+            Vmem_free(mem, VMAX2(natoms,1), sizeof(double),
+                      (void **)&(data[iw]));
+        } else {
+            Vmem_free(mem, ngrid, sizeof(double), (void **)&(data[iw]));
+        }
+    }
+    for (isub=0; isub<nsub; isub++) {
+        if (part[isub].own != VNULL) {
+            k = VMAX2(part[isub].nown,1);
+            Vmem_free(VNULL, k, sizeof(int), (void **)&(part[isub].own));
+            Vmem_free(VNULL, k, sizeof(double), (void **)&(part[isub].energy));
+            Vmem_free(VNULL, k, sizeof(AtomForce), (void **)&(part[isub].force));
+            Vmem_free(VNULL, part[isub].natompot, sizeof(double),
+                      (void **)&(part[isub].atompot));
+        }
+        NOsh_dtor(&(sub[isub]));
+    }
+    Vmem_free(mem, nsub, sizeof(NOsh *), (void **)&sub);
+    Vmem_free(mem, nsub, sizeof(InprocPart), (void **)&part);
+    Vpbe_dtor(&thepbe);
+
+    return rc;
 }
 
 VPUBLIC double returnEnergy(Vcom *com,
@@ -4503,7 +5270,6 @@ VPUBLIC int initAPOL(NOsh *nosh, /**< Input parameter object */
            srad,        /**< @todo document */
            *atomsasa,   /**< @todo document */
            *atomwcaEnergy,  /**< @todo document */
-           energy = 0.0,    /**< WCA energy per atom */
            dist,        /**< @todo document */
            charge,      /**< @todo document */
            xmin,        /**< @todo document */
@@ -4642,17 +5408,9 @@ VPUBLIC int initAPOL(NOsh *nosh, /**< Input parameter object */
 
         /* wcaEnergy integral code */
         if (VABS(apolparm->bconc) > VSMALL) {
-            /* wcaEnergy for each atom */
-            for (i = 0; i < len; i++) {
-                rc = Vacc_wcaEnergyAtom(acc, apolparm, alist, clist, i, &energy);
-                if (rc == 0)  {
-                    Vnm_print(2, "Error in apolar energy calculation!\n");
-                    return 0;
-                }
-                atomwcaEnergy[i] = energy;
-            }
-            /* Total WCA Energy */
-            rc = Vacc_wcaEnergy(acc, apolparm, alist, clist);
+            /* wcaEnergy for each atom and in total */
+            rc = Vacc_wcaEnergyAtoms(acc, apolparm, alist, clist,
+                                     atomwcaEnergy);
             if (rc == 0) {
                 Vnm_print(2, "Error in apolar energy calculation!\n");
                 return 0;
@@ -4745,20 +5503,20 @@ VPUBLIC int forceAPOL(Vacc *acc,
            zF,  /* Individual forces */
            press,
            gamma,
-           offset,
            bconc,
            dSASA[3],
            dSAV[3],
            force[3],
+           *wcaForce,
+           *sasaGrad,
+           *savGrad,
            *apos;
 
-    Vatom *atom = VNULL;
     ts_main = clock();
 
     srad = apolparm->srad;
     press = apolparm->press;
     gamma = apolparm->gamma;
-    offset = apolparm->dpos;
     bconc = apolparm->bconc;
 
     natom = Valist_getNumberAtoms(alist);
@@ -4766,18 +5524,27 @@ VPUBLIC int forceAPOL(Vacc *acc,
     /* Check to see if we need to build the surface */
     Vnm_print(0, "forceAPOL: Trying atom surf...\n");
     ts = clock();
-    if (acc->surf == VNULL) {
-        acc->surf = (VaccSurf**)Vmem_malloc(acc->mem, natom, sizeof(VaccSurf *));
-        for (i=0; i<natom; i++) {
-            atom = Valist_getAtom(acc->alist, i);
-            //apos = Vatom_getPosition(atom); // apos never referenced? - Peter
-            /* NOTE:  RIGHT NOW WE DO THIS FOR THE ENTIRE MOLECULE WHICH IS
-             * INCREDIBLY INEFFICIENT, PARTICULARLY DURING FOCUSING!!! */
-            acc->surf[i] = Vacc_atomSurf(acc, atom, acc->refSphere, srad);
-        }
-    }
+    Vacc_buildSurf(acc, srad, VNULL, VNULL);
     Vnm_print(0, "forceAPOL: atom surf: Time elapsed: %f\n", ((double)clock() - ts) / CLOCKS_PER_SEC);
 
+    /* The WCA forces of all atoms are integrated together, in parallel */
+    wcaForce = (double *)Vmem_malloc(mem, 3*VMAX2(1, natom), sizeof(double));
+    for (i=0; i<3*natom; i++) wcaForce[i] = 0.0;
+    if(VABS(bconc) > VSMALL) {
+        Vacc_wcaForceAtoms(acc, apolparm, clist, wcaForce);
+    }
+
+    /* So are the analytic area and volume derivatives */
+    sasaGrad = (double *)Vmem_malloc(mem, 3*VMAX2(1, natom), sizeof(double));
+    savGrad = (double *)Vmem_malloc(mem, 3*VMAX2(1, natom), sizeof(double));
+    for (i=0; i<3*natom; i++) {
+        sasaGrad[i] = 0.0;
+        savGrad[i] = 0.0;
+    }
+    if((VABS(gamma) > VSMALL) || (VABS(press) > VSMALL)) {
+        Vacc_dSASAdSAV(acc, srad, sasaGrad, savGrad);
+    }
+
     if(apolparm->calcforce == ACF_TOTAL){
         Vnm_print(0, "forceAPOL: calcforce == ACF_TOTAL\n");
         ts = clock();
@@ -4799,8 +5566,6 @@ VPUBLIC int forceAPOL(Vacc *acc,
 
         // problem block
         for (i=0; i<natom; i++) {
-            atom = Valist_getAtom(alist, i);
-
             for(j=0;j<3;j++){
                 dSASA[j] = 0.0;
                 dSAV[j] = 0.0;
@@ -4808,13 +5573,13 @@ VPUBLIC int forceAPOL(Vacc *acc,
             }
 
             if(VABS(gamma) > VSMALL) {
-                Vacc_atomdSASA(acc, offset, srad, atom, dSASA);
+                for(j=0;j<3;j++) dSASA[j] = sasaGrad[3*i+j];
             }
             if(VABS(press) > VSMALL) {
-                Vacc_atomdSAV(acc, srad, atom, dSAV);
+                for(j=0;j<3;j++) dSAV[j] = savGrad[3*i+j];
             }
             if(VABS(bconc) > VSMALL) {
-                Vacc_wcaForceAtom(acc, apolparm, clist, atom, force);
+                for(j=0;j<3;j++) force[j] = wcaForce[3*i+j];
             }
 
             for(j=0;j<3;j++){
@@ -4871,8 +5636,6 @@ VPUBLIC int forceAPOL(Vacc *acc,
 #endif
 
         for (i=0; i<natom; i++) {
-            atom = Valist_getAtom(alist, i);
-
             for(j=0;j<3;j++){
                 dSASA[j] = 0.0;
                 dSAV[j] = 0.0;
@@ -4886,9 +5649,15 @@ VPUBLIC int forceAPOL(Vacc *acc,
                 (*atomForce)[i].wcaForce[j] = 0.0;
             }
 
-            if(VABS(gamma) > VSMALL) Vacc_atomdSASA(acc, offset, srad, atom, dSASA);
-            if(VABS(press) > VSMALL) Vacc_atomdSAV(acc, srad, atom, dSAV);
-            if(VABS(bconc) > VSMALL) Vacc_wcaForceAtom(acc,apolparm,clist,atom,force);
+            if(VABS(gamma) > VSMALL) {
+                for(j=0;j<3;j++) dSASA[j] = sasaGrad[3*i+j];
+            }
+            if(VABS(press) > VSMALL) {
+                for(j=0;j<3;j++) dSAV[j] = savGrad[3*i+j];
+            }
+            if(VABS(bconc) > VSMALL) {
+                for(j=0;j<3;j++) force[j] = wcaForce[3*i+j];
+            }
 
             xF = -((gamma*dSASA[0]) + (press*dSAV[0]) + (bconc*force[0]));
             yF = -((gamma*dSASA[1]) + (press*dSAV[1]) + (bconc*force[1]));
@@ -4926,6 +5695,10 @@ VPUBLIC int forceAPOL(Vacc *acc,
         }
     } else *nforce = 0;
 
+    Vmem_free(mem, 3*VMAX2(1, natom), sizeof(double), (void **)&wcaForce);
+    Vmem_free(mem, 3*VMAX2(1, natom), sizeof(double), (void **)&sasaGrad);
+    Vmem_free(mem, 3*VMAX2(1, natom), sizeof(double), (void **)&savGrad);
+
 #ifndef VAPBSQUIET
     Vnm_print(1,"\n");
 #endif
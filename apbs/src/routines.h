@@ -233,6 +233,15 @@ VEXTERNC void printPBEPARM(PBEparm *pbeparm);
  * @param  mgparm  MGparm object */
 VEXTERNC void printMGPARM(MGparm *mgparm, double realCenter[3]);
 
+/**
+ * @brief  Construct the PBE object of an MG calculation
+ * @ingroup  Frontend
+ * @param  pbeparm  Generic PBE parameters
+ * @param  alist  Atom list of the molecule
+ * @param  focusFlag  1 if the calculation is focused, 0 otherwise
+ * @return  The new PBE object */
+VEXTERNC Vpbe* initPbeMG(PBEparm *pbeparm, Valist *alist, int focusFlag);
+
 /**
  * @brief  Initialize an MG calculation
  * @ingroup  Frontend
@@ -244,7 +253,8 @@ VEXTERNC int initMG(
                     MGparm *mgparm,  /**< Object with MG-specific parameters */
                     PBEparm *pbeparm,  /**< Object with generic PBE parameters  */
                     double realCenter[3],  /**< The actual center of the current mesh */
-                    Vpbe *pbe[NOSH_MAXCALC],  /**< Array of Vpbe objects (one for each calc) */
+                    Vpbe *pbe[NOSH_MAXCALC],  /**< Array of Vpbe objects (one for each calc); an entry
+                                               that is already set is used as it is */
                     Valist *alist[NOSH_MAXMOL],  /**< Array of atom lists */
                     Vgrid *dielXMap[NOSH_MAXMOL],  /**< Array of x-shifted dielectric maps */
                     Vgrid *dielYMap[NOSH_MAXMOL],  /**< Array of y-shifted dielectric maps */
@@ -278,6 +288,16 @@ VEXTERNC void killMG(
  * @return  1 if successful, 0 otherwise */
 VEXTERNC int solveMG(NOsh *nosh, Vpmg *pmg, MGparm_CalcType type);
 
+/**
+ * @brief  Solve the PDE across all processors with distributed multigrid
+ * @ingroup  Frontend
+ * @param com  Communications object
+ * @param nosh  Object with parsed input file parameters
+ * @param mgparm  MG parameters from input file
+ * @param pmg  MG object holding this processor's slab of the mesh
+ * @return  1 if successful, 0 otherwise */
+VEXTERNC int solveDistMG(Vcom *com, NOsh *nosh, MGparm *mgparm, Vpmg *pmg);
+
 /**
  * @brief  Set MG partitions for calculating observables and performing I/O
  * @ingroup  Frontend
@@ -305,6 +325,52 @@ VEXTERNC int energyMG(NOsh* nosh, int icalc, Vpmg *pmg,
   int *nenergy, double *totEnergy, double *qfEnergy, double *qmEnergy,
   double *dielEnergy);
 
+/**
+ * @brief  Solve the charge sets named by the rhs keyword on the maps and
+ *         operators of a solved MG calculation and print their energies
+ * @ingroup  Frontend
+ * @param nosh  Object with parsed input file parameters
+ * @param icalc  Index of calculation
+ * @param pmg  MG object, solved
+ * @param alist  Molecule list; each charge set is taken from a molecule
+ *               with the same number of atoms as the calculation's
+ * @return  1 if successful, 0 otherwise */
+VEXTERNC int rhsMG(NOsh *nosh, int icalc, Vpmg *pmg,
+  Valist *alist[NOSH_MAXMOL]);
+
+/**
+ * @brief  Solve the subdomains of an mg-para calculation concurrently in this
+ *         process and merge their energies, forces and maps
+ * @ingroup  Frontend
+ * @note  The results are stored for the last calculation of the ELEC
+ *        statement, as if it were solved by a single process; the maps are
+ *        written once for the whole mesh.
+ * @return  1 if successful, 0 otherwise */
+VEXTERNC int inprocMG(
+                      Vmem *mem,  /**< Memory management object */
+                      NOsh *nosh,  /**< Object with parsed input file parameters */
+                      int ielec,  /**< Index of the ELEC statement */
+                      int icalc,  /**< Index of its first calculation */
+                      Valist *alist[NOSH_MAXMOL],  /**< Array of atom lists */
+                      Vgrid *dielXMap[NOSH_MAXMOL],  /**< Array of x-shifted dielectric maps */
+                      Vgrid *dielYMap[NOSH_MAXMOL],  /**< Array of y-shifted dielectric maps */
+                      Vgrid *dielZMap[NOSH_MAXMOL],  /**< Array of z-shifted dielectric maps */
+                      Vgrid *kappaMap[NOSH_MAXMOL],  /**< Array of kappa maps  */
+                      Vgrid *chargeMap[NOSH_MAXMOL],  /**< Array of charge maps */
+                      Vgrid *potMap[NOSH_MAXMOL],  /**< Array of potential maps  */
+                      Vpbe *pbe[NOSH_MAXCALC],  /**< Array of Vpbe objects (one for each calc) */
+                      Vpmgp *pmgp[NOSH_MAXCALC],  /**< Array of MG parameter objects (one for each calc) */
+                      Vpmg *pmg[NOSH_MAXCALC],  /**< Array of MG objects (one for each calc) */
+                      int nenergy[NOSH_MAXCALC],  /**< Set to number of entries in energy arrays */
+                      double totEnergy[NOSH_MAXCALC],  /**< Set to total energies (in kT) */
+                      double qfEnergy[NOSH_MAXCALC],  /**< Set to charge-potential energies (in kT) */
+                      double qmEnergy[NOSH_MAXCALC],  /**< Set to mobile ion energies (in kT) */
+                      double dielEnergy[NOSH_MAXCALC],  /**< Set to polarization energies (in kT) */
+                      double *atomEnergy[NOSH_MAXCALC],  /**< Set to per-atom energies (in kT) */
+                      int nforce[NOSH_MAXCALC],  /**< Set to number of forces in arrays */
+                      AtomForce *atomForce[NOSH_MAXCALC]  /**< Set to atom forces */
+                      );
+
 /**
  * @brief  Kill arrays allocated for energies
  * @ingroup  Frontend
@@ -327,6 +393,14 @@ VEXTERNC void killEnergy();
 VEXTERNC int forceMG(Vmem *mem, NOsh *nosh, PBEparm *pbeparm,  MGparm *mgparm,
   Vpmg *pmg, int *nforce, AtomForce **atomForce, Valist *alist[NOSH_MAXMOL]);
 
+/**
+ * @brief  Print the forces of an MG calculation
+ * @ingroup  Frontend
+ * @param  pbeparm  Generic PBE parameters
+ * @param  nforce  Number of forces in the array
+ * @param  atomForce  Total force or per-atom forces */
+VEXTERNC void printforceMG(PBEparm *pbeparm, int nforce, AtomForce *atomForce);
+
 /**
  * @brief  Free memory from MG force calculation
  * @ingroup  Frontend
@@ -404,6 +478,34 @@ VEXTERNC int writedataXML(NOsh *nosh, Vcom *com, const char *fname,
  * @return  1 if successful, 0 otherwise */
 VEXTERNC int writedataMG(int rank, NOsh *nosh, PBEparm *pbeparm, Vpmg *pmg);
 
+/**
+ * @brief  Fill an array with observables from MG calculation
+ * @ingroup  Frontend
+ * @param  pmg  MG object
+ * @param  pbeparm  Generic PBE parameters
+ * @param  type  Type of data
+ * @param  vec  Set to the data on the mesh (or at the atoms)
+ * @param  origin  Set to the origin of the data
+ * @param  what  Set to the name of the data
+ * @param  title  Set to the title of the file the data is written to
+ * @return  1 if successful, 0 otherwise */
+VEXTERNC int filldataMG(Vpmg *pmg, PBEparm *pbeparm, Vdata_Type type,
+  double *vec, double origin[3], char what[72], char title[72]);
+
+/**
+ * @brief  Write a grid of observables to file
+ * @ingroup  Frontend
+ * @param  grid  Grid with the data
+ * @param  pvec  Partition weights of the mesh points, or VNULL to write them
+ *               all
+ * @param  natoms  Number of values written in the flat format
+ * @param  format  File format
+ * @param  writestem  File name without its extension
+ * @param  title  Title of the file
+ * @return  1 if successful, 0 otherwise */
+VEXTERNC int writegridMG(Vgrid *grid, double *pvec, int natoms,
+  Vdata_Format format, char *writestem, char *title);
+
 /**
  * @brief  Write out operator matrix from MG calculation to file
  * @ingroup  Frontend
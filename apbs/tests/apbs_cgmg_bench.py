@@ -0,0 +1,141 @@
+#! /usr/bin/env python
+
+"""
+Compares the multigrid preconditioned CG solver (the cgmg keyword) with the
+default multigrid solver on the example inputs
+
+Each input is run twice in a scratch copy of its example directory: once as
+it is and once with cgmg added to every mg-auto, mg-manual and mg-para ELEC
+block.  The wall time, the solver iterations of each ELEC calculation and the
+largest relative difference of the total energies are reported.
+"""
+
+from __future__ import print_function
+
+import os, re, shutil, subprocess, sys, tempfile, time
+from optparse import OptionParser
+
+# Inputs that solve with multigrid in a few seconds; the membrane and
+# ion-protein cases have the largest dielectric jumps
+default_cases = [
+    "born/apbs-mol-auto.in",
+    "born/apbs-smol-auto.in",
+    "membrane/memv.in",
+    "hca-bind/apbs-mol.in",
+    "ionize/apbs-mol.in",
+    "alkanes/alkanes.in",
+    "FKBP/1d7h-dmso-mol.in",
+    "ion-protein/apbs-mol-pdiel2.in",
+    "pka-lig/apbs-mol-surf.in",
+]
+
+mg_block_pattern = re.compile( r'^(\s*)(mg-auto|mg-manual|mg-para)\s*$', re.M )
+iters_pattern = re.compile( r'Solver iterations:\s*(\d+)' )
+energy_pattern = re.compile( r'Total electrostatic energy\s*=\s*(\S+)' )
+
+
+
+def add_cgmg( text ):
+    """
+    Adds the cgmg keyword after the header of each multigrid ELEC block
+    """
+
+    return mg_block_pattern.sub( r'\1\2\n\1    cgmg', text )
+
+
+
+def run_case( binary, example_dir, case, cgmg ):
+    """
+    Runs one input in a scratch copy of its directory and returns the wall
+    time, the iteration counts and the energies
+    """
+
+    directory, input_name = os.path.split( case )
+    scratch = tempfile.mkdtemp( prefix='cgmgbench' )
+    work_dir = os.path.join( scratch, directory )
+    shutil.copytree( os.path.join( example_dir, directory ), work_dir )
+
+    try:
+        input_path = os.path.join( work_dir, input_name )
+        if cgmg:
+            with open( input_path ) as input_file:
+                text = input_file.read()
+            with open( input_path, 'w' ) as input_file:
+                input_file.write( add_cgmg( text ) )
+
+        start = time.time()
+        process = subprocess.Popen( [ binary, input_name ], cwd=work_dir,
+                                    stdout=subprocess.PIPE,
+                                    stderr=subprocess.STDOUT )
+        output = process.communicate()[0].decode( 'utf-8', 'replace' )
+        wall = time.time() - start
+
+        if process.returncode != 0:
+            raise RuntimeError( '%s failed with status %d'
+                                % ( case, process.returncode ) )
+
+        iters = [ int( n ) for n in iters_pattern.findall( output ) ]
+        energies = [ float( e ) for e in energy_pattern.findall( output ) ]
+        return wall, iters, energies
+
+    finally:
+        shutil.rmtree( scratch )
+
+
+
+def main():
+    """
+    Parse the command line and run the comparison
+    """
+
+    parser = OptionParser( usage='%prog [options] [example/input.in ...]' )
+    parser.add_option(
+        '-b', '--binary', dest='binary', default='apbs',
+        help="Path to the apbs binary"
+        )
+    parser.add_option(
+        '-e', '--examples', dest='examples',
+        default=os.path.join( os.path.dirname( os.path.abspath( __file__ ) ),
+                              '..', 'examples' ),
+        help="Path to the examples directory"
+        )
+    parser.add_option(
+        '-r', '--repeat', dest='repeat', type='int', default=1,
+        help="Number of runs of each solver; the best time is reported"
+        )
+    ( options, cases ) = parser.parse_args()
+
+    if not cases:
+        cases = default_cases
+
+    print( '%-32s %9s %9s %7s  %s'
+           % ( 'input', 'MG (s)', 'CGMG (s)', 'dE', 'iterations MG / CGMG' ) )
+
+    for case in cases:
+        results = []
+        for cgmg in ( False, True ):
+            best = None
+            for i in range( options.repeat ):
+                result = run_case( options.binary, options.examples, case, cgmg )
+                if best is None or result[0] < best[0]:
+                    best = result
+            results.append( best )
+
+        ( mg_wall, mg_iters, mg_energies ) = results[0]
+        ( cg_wall, cg_iters, cg_energies ) = results[1]
+
+        energy_diff = 0.0
+        for ( e_mg, e_cg ) in zip( mg_energies, cg_energies ):
+            if e_mg != 0.0:
+                energy_diff = max( energy_diff, abs( e_cg - e_mg )/abs( e_mg ) )
+
+        print( '%-32s %9.2f %9.2f %7.1e  %s / %s'
+               % ( case, mg_wall, cg_wall, energy_diff,
+                   ' '.join( str( n ) for n in mg_iters ),
+                   ' '.join( str( n ) for n in cg_iters ) ) )
+        sys.stdout.flush()
+
+
+
+if __name__ == '__main__':
+    main()
@@ -81,6 +81,7 @@ def check_energies(input_file):
     input_lines = f.readlines()
     
     energy_list = extract_energy(ElecEnergy, input_lines, 'Total electrostatic energy')
+    energy_list += extract_energy(ElecEnergy, input_lines, 'Charges of molecule')
     energy_list += extract_energy(ElecEnergy, input_lines, 'Mobile charge energy')
     energy_list += extract_energy(ElecEnergy, input_lines, 'Fixed charge energy')
     energy_list += extract_energy(ElecEnergy, input_lines, 'Dielectric energy')
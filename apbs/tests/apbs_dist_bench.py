@@ -0,0 +1,212 @@
+#! /usr/bin/env python
+
+"""
+Strong-scaling benchmark of the distributed multigrid solver (the distrib
+keyword)
+
+One mg-manual calculation of a fixed mesh is run with mpirun on an
+increasing number of processes.  The wall time of each run, the speedup and
+parallel efficiency relative to the smallest run, the solver iterations and
+the relative difference of the total energy from the smallest run are
+reported.  The energy and the iterations should not depend on the number of
+processes.
+
+With --check the script is a regression test: it exits with status 1 unless
+every run takes as many iterations as the first and matches its energy.
+Uneven splits of the mesh and the force integrals near the cuts are covered
+by
+
+    apbs_dist_bench.py -p born/ion.pqr -d 97 -g 24 -n 1,3,5 --forces --check
+"""
+
+from __future__ import print_function
+
+import os, re, shutil, subprocess, sys, tempfile, time
+from optparse import OptionParser
+
+input_template = """read
+    mol pqr %(pqr)s
+end
+elec name dist
+    mg-manual
+    distrib
+    dime %(dime)d %(dime)d %(dime)d
+    nlev %(nlev)d
+    glen %(glen)g %(glen)g %(glen)g
+    gcent mol 1
+    mol 1
+    lpbe
+    bcfl mdh
+    ion charge 1 conc 0.150 radius 2.0
+    ion charge -1 conc 0.150 radius 2.0
+    pdie 2.0
+    sdie 78.54
+    chgm spl2
+    srfm %(srfm)s
+    srad 1.4
+    swin 0.3
+    sdens 10.0
+    temp 298.15
+    calcenergy total
+    calcforce %(calcforce)s
+end
+print elecEnergy dist end
+quit
+"""
+
+iters_pattern = re.compile( r'Solver iterations:\s*(\d+)' )
+energy_pattern = re.compile( r'Global net ELEC energy\s*=\s*(\S+)' )
+
+
+
+def run_case( options, nprocs ):
+    """
+    Runs the benchmark input on nprocs processes in a scratch directory and
+    returns the wall time, the iteration count and the energy
+    """
+
+    scratch = tempfile.mkdtemp( prefix='distbench' )
+    # Forces need a spline-based surface
+    calcforce, srfm = 'no', 'smol'
+    if options.forces:
+        calcforce, srfm = 'total', 'spl2'
+
+    try:
+        pqr_name = os.path.basename( options.pqr )
+        shutil.copy( os.path.join( options.examples, options.pqr ), scratch )
+        with open( os.path.join( scratch, 'dist.in' ), 'w' ) as input_file:
+            input_file.write( input_template % { 'pqr' : pqr_name,
+                                                 'dime' : options.dime,
+                                                 'nlev' : options.nlev,
+                                                 'glen' : options.glen,
+                                                 'srfm' : srfm,
+                                                 'calcforce' : calcforce } )
+
+        command = options.mpirun.split() + [ '-np', str( nprocs ),
+                                             options.binary, 'dist.in' ]
+        start = time.time()
+        process = subprocess.Popen( command, cwd=scratch,
+                                    stdout=subprocess.PIPE,
+                                    stderr=subprocess.STDOUT )
+        output = process.communicate()[0].decode( 'utf-8', 'replace' )
+        wall = time.time() - start
+
+        if process.returncode != 0:
+            raise RuntimeError( '%d processes failed with status %d'
+                                % ( nprocs, process.returncode ) )
+
+        iters = iters_pattern.findall( output )
+        energies = energy_pattern.findall( output )
+        if not iters or not energies:
+            raise RuntimeError( 'No result from the run on %d processes'
+                                % nprocs )
+        return wall, int( iters[0] ), float( energies[0] )
+
+    finally:
+        shutil.rmtree( scratch )
+
+
+
+def main():
+    """
+    Parse the command line and run the benchmark
+    """
+
+    parser = OptionParser( usage='%prog [options]' )
+    parser.add_option(
+        '-b', '--binary', dest='binary', default='apbs',
+        help="Path to the apbs binary, built with MPI"
+        )
+    parser.add_option(
+        '-e', '--examples', dest='examples',
+        default=os.path.join( os.path.dirname( os.path.abspath( __file__ ) ),
+                              '..', 'examples' ),
+        help="Path to the examples directory"
+        )
+    parser.add_option(
+        '-p', '--pqr', dest='pqr', default='hca-bind/hca.pqr',
+        help="Molecule, relative to the examples directory"
+        )
+    parser.add_option(
+        '-m', '--mpirun', dest='mpirun', default='mpirun',
+        help="MPI launcher, with any options it needs"
+        )
+    parser.add_option(
+        '-n', '--nprocs', dest='nprocs', default='1,2,4,8',
+        help="Comma-separated numbers of processes"
+        )
+    parser.add_option(
+        '-d', '--dime', dest='dime', type='int', default=161,
+        help="Mesh points in each direction"
+        )
+    parser.add_option(
+        '-l', '--nlev', dest='nlev', type='int', default=4,
+        help="Multigrid levels"
+        )
+    parser.add_option(
+        '-g', '--glen', dest='glen', type='float', default=80.0,
+        help="Mesh length in each direction (A)"
+        )
+    parser.add_option(
+        '-r', '--repeat', dest='repeat', type='int', default=1,
+        help="Number of runs on each number of processes; the best time is \
+reported"
+        )
+    parser.add_option(
+        '-f', '--forces', dest='forces', action='store_true', default=False,
+        help="Also compute the total forces (calcforce total, srfm spl2)"
+        )
+    parser.add_option(
+        '-c', '--check', dest='check', action='store_true', default=False,
+        help="Exit with status 1 unless every run takes the iterations of \
+the first run and matches its energy to the tolerance"
+        )
+    parser.add_option(
+        '-t', '--tolerance', dest='tolerance', type='float', default=1.0e-9,
+        help="Relative energy tolerance of --check"
+        )
+    ( options, args ) = parser.parse_args()
+
+    nprocs_list = [ int( n ) for n in options.nprocs.split( ',' ) ]
+
+    print( '%6s %10s %8s %10s %6s %9s'
+           % ( 'procs', 'time (s)', 'speedup', 'efficiency', 'iters', 'dE' ) )
+
+    reference = None
+    failed = False
+    for nprocs in nprocs_list:
+        best = None
+        for i in range( options.repeat ):
+            result = run_case( options, nprocs )
+            if best is None or result[0] < best[0]:
+                best = result
+        ( wall, iters, energy ) = best
+        if reference is None:
+            reference = ( nprocs, wall, energy, iters )
+
+        speedup = reference[1]/wall
+        efficiency = speedup*reference[0]/nprocs
+        energy_diff = 0.0
+        if reference[2] != 0.0:
+            energy_diff = abs( energy - reference[2] )/abs( reference[2] )
+
+        print( '%6d %10.2f %8.2f %10.2f %6d %9.1e'
+               % ( nprocs, wall, speedup, efficiency, iters, energy_diff ) )
+        sys.stdout.flush()
+
+        if iters != reference[3] or energy_diff > options.tolerance:
+            failed = True
+
+    if options.check:
+        if failed:
+            print( 'FAILED: the runs do not agree with the run on %d processes'
+                   % reference[0] )
+            return 1
+        print( 'PASSED' )
+
+    return 0
+
+
+
+if __name__ == '__main__':
+    sys.exit( main() )
@@ -166,8 +166,12 @@ def run_test( binary, test_files, test_name, test_directory, setup, logger, ocd
 
             computed_results = None
 
-            # Determine if this is a parallel run
-            match = re.search( r'\s*pdime((\s+\d+)+)', open( input_file, 'r' ).read() )
+            # Determine if this is a parallel run; with inproc, one process
+            # solves all the subdomains and reports the summed results
+            input_text = open( input_file, 'r' ).read()
+            match = re.search( r'\s*pdime((\s+\d+)+)', input_text )
+            if re.search( r'^\s*inproc\s*$', input_text, re.MULTILINE ):
+                match = None
             
             # If it is parallel, get the number of procs and do a parallel run
             if match:
@@ -0,0 +1,177 @@
+/**
+ *  @file    accbench.c
+ *  @brief   Timing benchmark for the molecular surface accessibility oracle
+ *  @version $Id$
+ */
+
+#include "apbs.h"
+
+#if defined(_OPENMP)
+#   include <omp.h>
+#endif
+
+/* Wall clock time in seconds; CPU time is useless for threaded loops */
+static double accbench_time() {
+#if defined(_OPENMP)
+    return omp_get_wtime();
+#else
+    return ((double)clock())/CLOCKS_PER_SEC;
+#endif
+}
+
+/* Vacc_molAcc as it was before the vectorized kernel: walk the atoms of the
+ * cell and then every one of each atom's surface points */
+static double accbench_walkMolAcc(Vacc *acc, double center[3], double radius) {
+
+    VclistCell *cell;
+    VaccSurf *surf;
+    Vatom *atom;
+    int iatom, ipt;
+    double dist2;
+
+    if (Vacc_ivdwAcc(acc, center, radius) == 1.0) return 1.0;
+    if (Vacc_vdwAcc(acc, center) == 0.0) return 0.0;
+
+    cell = Vclist_getCell(acc->clist, center);
+    if (cell == VNULL) return 1.0;
+    for (iatom=0; iatom<cell->natoms; iatom++) {
+        atom = cell->atoms[iatom];
+        surf = acc->surf[atom->id];
+        for (ipt=0; ipt<surf->npts; ipt++) {
+            dist2 = VSQR(center[0]-(surf->xpts[ipt]))
+                + VSQR(center[1]-(surf->ypts[ipt]))
+                + VSQR(center[2]-(surf->zpts[ipt]));
+            if (dist2 < radius*radius) return 1.0;
+        }
+    }
+    return 0.0;
+}
+
+int main(int argc, char **argv) {
+
+    /* OBJECTS */
+    Valist *alist = VNULL;
+    Vclist *clist = VNULL;
+    Vacc *acc = VNULL;
+    Vio *sock = VNULL;
+    int i, n[3], ntot, nhash[3], ndiff, ichop;
+    double h, srad, sdens, lower[3], upper[3], pos[3], t0, t[3], area;
+    double *walk, *fast;
+    char *path;
+    char *usage = "\n  accbench <molecule.pqr> [h [srad [sdens]]]\n\n"
+      "    Evaluates the molecular surface accessibility (srfm mol) on a grid\n"
+      "    of spacing h (default 0.5 A) around the molecule, with probe\n"
+      "    radius srad (default 1.4 A) and sdens surface points per A^2\n"
+      "    (default 10).  Times the per-atom walk over the SAS points against\n"
+      "    the vectorized Vacc_molAcc kernel and checks that they agree.\n\n";
+
+    /* PARSE ARGUMENTS */
+    Vio_start();
+    h = 0.5;
+    srad = 1.4;
+    sdens = 10.0;
+    if ((argc < 2) || (argc > 5)) {
+        Vnm_print(2, "%s", usage);
+        return 2;
+    }
+    path = argv[1];
+    if (argc > 2) h = atof(argv[2]);
+    if (argc > 3) srad = atof(argv[3]);
+    if (argc > 4) sdens = atof(argv[4]);
+    if ((h <= 0.0) || (srad <= 0.0) || (sdens <= 0.0)) {
+        Vnm_print(2, "%s", usage);
+        return 2;
+    }
+
+    /* READ THE MOLECULE */
+    alist = Valist_ctor();
+    sock = Vio_ctor("FILE", "ASC", VNULL, path, "r");
+    if (sock == VNULL) {
+        Vnm_print(2, "Problem opening virtual socket %s!\n", path);
+        return 1;
+    }
+    if (Vio_accept(sock, 0) < 0) {
+        Vnm_print(2, "Problem accepting virtual socket %s!\n", path);
+        return 1;
+    }
+    Valist_readPQR(alist, VNULL, sock);
+    Vio_acceptFree(sock);
+    Vio_dtor(&sock);
+
+    /* SET UP THE ACCESSIBILITY OBJECT (hash table sized as in Vpbe) */
+    for (i=0; i<3; i++) {
+        nhash[i] = (int)((alist->maxcrd[i] - alist->mincrd[i])/0.5);
+        if (nhash[i] < 3) nhash[i] = 3;
+        if (nhash[i] > MAX_HASH_DIM) nhash[i] = MAX_HASH_DIM;
+    }
+    clist = Vclist_ctor(alist, srad, nhash,
+                        CLIST_AUTO_DOMAIN, VNULL, VNULL);
+    acc = Vacc_ctor(alist, clist, sdens);
+
+    /* The grid covers the molecule and its probe-inflated surface */
+    ntot = 1;
+    for (i=0; i<3; i++) {
+        lower[i] = alist->mincrd[i] - 2.0*srad - 2.0;
+        upper[i] = alist->maxcrd[i] + 2.0*srad + 2.0;
+        n[i] = (int)((upper[i] - lower[i])/h) + 1;
+        ntot *= n[i];
+    }
+    walk = (double*)Vmem_malloc(VNULL, ntot, sizeof(double));
+    fast = (double*)Vmem_malloc(VNULL, ntot, sizeof(double));
+    Vnm_print(1, "accbench:  %d atoms, %d x %d x %d grid\n",
+              Valist_getNumberAtoms(alist), n[0], n[1], n[2]);
+
+    /* TIME THE PIECES */
+    t0 = accbench_time();
+    area = Vacc_SASA(acc, srad);
+    t[0] = accbench_time() - t0;
+
+    t0 = accbench_time();
+#pragma omp parallel for private(i,pos,ichop)
+    for (i=0; i<ntot; i++) {
+        ichop = i;
+        pos[2] = lower[2] + h*(ichop%n[2]);
+        ichop /= n[2];
+        pos[1] = lower[1] + h*(ichop%n[1]);
+        pos[0] = lower[0] + h*(ichop/n[1]);
+        walk[i] = accbench_walkMolAcc(acc, pos, srad);
+    }
+    t[1] = accbench_time() - t0;
+
+    t0 = accbench_time();
+#pragma omp parallel for private(i,pos,ichop)
+    for (i=0; i<ntot; i++) {
+        ichop = i;
+        pos[2] = lower[2] + h*(ichop%n[2]);
+        ichop /= n[2];
+        pos[1] = lower[1] + h*(ichop%n[1]);
+        pos[0] = lower[0] + h*(ichop/n[1]);
+        fast[i] = Vacc_molAcc(acc, pos, srad);
+    }
+    t[2] = accbench_time() - t0;
+
+    Vnm_print(1, "  SASA = %g A^2\n", area);
+    Vnm_print(1, "  %-28s %10.4f s\n", "build atom surfaces", t[0]);
+    Vnm_print(1, "  %-28s %10.4f s\n", "molAcc, per-atom walk", t[1]);
+    Vnm_print(1, "  %-28s %10.4f s\n", "molAcc, vectorized kernel", t[2]);
+
+    /* The vectorized kernel must reproduce the walk exactly */
+    ndiff = 0;
+    for (i=0; i<ntot; i++) {
+        if (walk[i] != fast[i]) ndiff++;
+    }
+    if (ndiff > 0) {
+        Vnm_print(2, "accbench:  vectorized accessibility differs at %d points\n",
+                  ndiff);
+        return 1;
+    }
+    Vnm_print(1, "accbench:  vectorized and per-atom accessibility agree\n");
+
+    Vmem_free(VNULL, ntot, sizeof(double), (void **)&walk);
+    Vmem_free(VNULL, ntot, sizeof(double), (void **)&fast);
+    Vacc_dtor(&acc);
+    Vclist_dtor(&clist);
+    Valist_dtor(&alist);
+
+    return 0;
+}
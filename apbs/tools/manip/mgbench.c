@@ -0,0 +1,167 @@
+/**
+ *  @file    mgbench.c
+ *  @brief   Memory bandwidth benchmark for the 7-point multigrid kernels
+ *  @version $Id$
+ */
+
+#include "apbs.h"
+#include "pmgc/gsd.h"
+#include "pmgc/matvecd.h"
+
+#if defined(_OPENMP)
+#   include <omp.h>
+#endif
+
+#define NKERNEL 5
+
+/* Wall clock time in seconds; CPU time is useless for threaded kernels */
+static double mgbench_time() {
+#if defined(_OPENMP)
+    return omp_get_wtime();
+#else
+    return ((double)clock())/CLOCKS_PER_SEC;
+#endif
+}
+
+int main(int argc, char **argv) {
+
+    /* OBJECTS */
+    int n, nu, nrep, len, i, irep, ikern, izero, ione, iters, ipc[100];
+    double rpc[100], errtol, omega, t0, t, best[NKERNEL], bytes[NKERNEL];
+    double *oC, *cc, *fc, *oE, *oN, *uC, *x, *x0, *r, *r0, *w;
+    const char *name[NKERNEL] = {
+        "Vmatvec7_1s", "Vmresid7_1s", "Vgsrb7x", "Vgsrb7x+Vmresid7_1s",
+        "Vgsrb7xtb (fused)"
+    };
+    char *usage = "\n  mgbench [n [nu [nrep]]]\n\n"
+      "    Times the 7-point multigrid kernels on an n^3 grid (default 129)\n"
+      "    with nu red-black sweeps per smoothing call (default 2), taking\n"
+      "    the best of nrep repetitions (default 5).  Bandwidth is the\n"
+      "    compulsory array traffic of the unfused kernels divided by the\n"
+      "    time, so the fused kernel reports an effective rate.\n\n";
+
+    /* PARSE ARGUMENTS */
+    Vio_start();
+    n = 129;
+    nu = 2;
+    nrep = 5;
+    if (argc > 4) {
+        Vnm_print(2, "\n*** Syntax error: got %d arguments, expected <= 3.\n",
+           argc-1);
+        Vnm_print(2, "%s", usage);
+        return 2;
+    }
+    if (argc > 1) n = atoi(argv[1]);
+    if (argc > 2) nu = atoi(argv[2]);
+    if (argc > 3) nrep = atoi(argv[3]);
+    if ((n < 3) || (nu < 1) || (nrep < 1)) {
+        Vnm_print(2, "%s", usage);
+        return 2;
+    }
+
+    /* SET UP A RANDOM DIAGONALLY DOMINANT OPERATOR */
+    len = n*n*n;
+    oC = (double*)Vmem_malloc(VNULL, len, sizeof(double));
+    cc = (double*)Vmem_malloc(VNULL, len, sizeof(double));
+    fc = (double*)Vmem_malloc(VNULL, len, sizeof(double));
+    oE = (double*)Vmem_malloc(VNULL, len, sizeof(double));
+    oN = (double*)Vmem_malloc(VNULL, len, sizeof(double));
+    uC = (double*)Vmem_malloc(VNULL, len, sizeof(double));
+    x = (double*)Vmem_malloc(VNULL, len, sizeof(double));
+    x0 = (double*)Vmem_malloc(VNULL, len, sizeof(double));
+    r = (double*)Vmem_malloc(VNULL, len, sizeof(double));
+    r0 = (double*)Vmem_malloc(VNULL, len, sizeof(double));
+    w = (double*)Vmem_malloc(VNULL, len, sizeof(double));
+    srand(1);
+    for (i=0; i<len; i++) {
+        oE[i] = 1.0 + 0.1*((double)rand())/RAND_MAX;
+        oN[i] = 1.0 + 0.1*((double)rand())/RAND_MAX;
+        uC[i] = 1.0 + 0.1*((double)rand())/RAND_MAX;
+        oC[i] = 6.6;
+        cc[i] = ((double)rand())/RAND_MAX;
+        fc[i] = ((double)rand())/RAND_MAX - 0.5;
+        x0[i] = 0.0;
+        r[i] = 0.0;
+        r0[i] = 0.0;
+    }
+    for (i=0; i<100; i++) {
+        ipc[i] = 0;
+        rpc[i] = 0.0;
+    }
+    ipc[10] = 7;
+    izero = 0;
+    ione = 1;
+    errtol = 0.0;
+    omega = 1.0;
+
+    /* Arrays streamed per pass: 6 operator arrays plus x, and the output */
+    bytes[0] = 7.0*len*sizeof(double);
+    bytes[1] = 8.0*len*sizeof(double);
+    bytes[2] = 2.0*nu*8.0*len*sizeof(double);
+    bytes[3] = bytes[2] + bytes[1];
+    bytes[4] = bytes[3];
+
+    Vnm_print(1, "mgbench:  %d^3 grid, %d sweeps, best of %d\n", n, nu, nrep);
+
+    /* TIME THE KERNELS */
+    for (ikern=0; ikern<NKERNEL; ikern++) {
+        best[ikern] = VLARGE;
+        for (irep=0; irep<nrep; irep++) {
+            for (i=0; i<len; i++) x[i] = x0[i];
+            t0 = mgbench_time();
+            switch (ikern) {
+                case 0:
+                    Vmatvec7_1s(&n, &n, &n, ipc, rpc, oC, cc, oE, oN, uC,
+                                fc, w);
+                    break;
+                case 1:
+                    Vmresid7_1s(&n, &n, &n, ipc, rpc, oC, cc, fc, oE, oN, uC,
+                                fc, w);
+                    break;
+                case 2:
+                    Vgsrb7x(&n, &n, &n, ipc, rpc, oC, cc, fc, oE, oN, uC,
+                            x, w, w, r, &nu, &iters, &errtol, &omega,
+                            &izero, &izero);
+                    break;
+                case 3:
+                    Vgsrb7x(&n, &n, &n, ipc, rpc, oC, cc, fc, oE, oN, uC,
+                            x, w, w, r0, &nu, &iters, &errtol, &omega,
+                            &ione, &izero);
+                    break;
+                case 4:
+                    Vgsrb7xtb(&n, &n, &n, ipc, rpc, oC, cc, fc, oE, oN, uC,
+                              x, w, w, r, &nu, &iters, &errtol, &omega,
+                              &ione, &izero);
+                    break;
+            }
+            t = mgbench_time() - t0;
+            if (t < best[ikern]) best[ikern] = t;
+        }
+        Vnm_print(1, "  %-22s %10.4f s %10.2f GB/s\n", name[ikern],
+                  best[ikern], bytes[ikern]/best[ikern]/1.0e9);
+    }
+
+    /* The fused kernel must reproduce the unfused sweeps exactly */
+    for (i=0; i<len; i++) {
+        if (r[i] != r0[i]) {
+            Vnm_print(2, "mgbench:  fused residual differs at %d (%g vs %g)\n",
+                      i, r[i], r0[i]);
+            return 1;
+        }
+    }
+    Vnm_print(1, "mgbench:  fused and unfused residuals agree\n");
+
+    Vmem_free(VNULL, len, sizeof(double), (void **)&oC);
+    Vmem_free(VNULL, len, sizeof(double), (void **)&cc);
+    Vmem_free(VNULL, len, sizeof(double), (void **)&fc);
+    Vmem_free(VNULL, len, sizeof(double), (void **)&oE);
+    Vmem_free(VNULL, len, sizeof(double), (void **)&oN);
+    Vmem_free(VNULL, len, sizeof(double), (void **)&uC);
+    Vmem_free(VNULL, len, sizeof(double), (void **)&x);
+    Vmem_free(VNULL, len, sizeof(double), (void **)&x0);
+    Vmem_free(VNULL, len, sizeof(double), (void **)&r);
+    Vmem_free(VNULL, len, sizeof(double), (void **)&r0);
+    Vmem_free(VNULL, len, sizeof(double), (void **)&w);
+
+    return 0;
+}
@@ -2785,7 +2785,7 @@ Vpmgp **new_pmgplist(int maxargs) {
 }
 
 Vpbe **new_pbelist(int maxargs) {
-   return (Vpbe **) malloc(maxargs*sizeof(Vpbe *));
+   return (Vpbe **) calloc(maxargs, sizeof(Vpbe *));
 }
 
 Vpbe *get_Vpbe(Vpbe **args, int n) { 
@@ -2978,6 +2978,7 @@ PyObject *getPotentials(NOsh *nosh, PBEparm *pbeparm, Vpmg *pmg, Valist *alist){
     double hx, hy, hzed, xcent, ycent, zcent, xmin, ymin, zmin;
     double value;
     double *position;
+    double *data;
     PyObject *values;
     
     values = PyList_New(Valist_getNumberAtoms(alist));
@@ -2994,9 +2995,12 @@ PyObject *getPotentials(NOsh *nosh, PBEparm *pbeparm, Vpmg *pmg, Valist *alist){
     ymin = ycent - 0.5*(ny-1)*hy;
     zmin = zcent - 0.5*(nz-1)*hzed;
    
-    Vpmg_fillArray(pmg, pmg->rwork, VDT_POT, 0.0, pbeparm->pbetype, pbeparm);
+    /* Not in pmg->rwork, which may hold the multigrid operators for
+     * solveMultiRHS */
+    data = (double *)Vmem_malloc(VNULL, nx*ny*nz, sizeof(double));
+    Vpmg_fillArray(pmg, data, VDT_POT, 0.0, pbeparm->pbetype, pbeparm);
     grid = Vgrid_ctor(nx, ny, nz, hx, hy, hzed, xmin, ymin, zmin,
-                  pmg->rwork);
+                  data);
     for (i=0;i<Valist_getNumberAtoms(alist);i++){
         atom = Valist_getAtom(alist, i);
         position = Vatom_getPosition(atom); 
@@ -3004,9 +3008,84 @@ PyObject *getPotentials(NOsh *nosh, PBEparm *pbeparm, Vpmg *pmg, Valist *alist){
         PyList_SetItem(values, i, PyFloat_FromDouble(value)); 
     } 
     Vgrid_dtor(&grid);    
+    Vmem_free(VNULL, nx*ny*nz, sizeof(double), (void **)&data);
     return values;
 }
 
+PyObject *solveMultiRHS(Vpmg *pmg, PyObject *chargeSets, int nblock){
+    Valist *alist;
+    int i, irhs, nrhs, natoms, rc;
+    double *charges, *energy, *atomPot;
+    PyObject *set, *energies, *potentials, *pots, *result;
+
+    alist = pmg->pbe->alist;
+    natoms = Valist_getNumberAtoms(alist);
+    if (!PyList_Check(chargeSets)){
+        PyErr_SetString(PyExc_TypeError,
+                        "the charge sets must be a list of lists");
+        return NULL;
+    }
+    nrhs = PyList_Size(chargeSets);
+    charges = (double *)Vmem_malloc(VNULL, VMAX2(nrhs*natoms, 1),
+                                    sizeof(double));
+    for (irhs=0;irhs<nrhs;irhs++){
+        set = PyList_GetItem(chargeSets, irhs);
+        if (!PyList_Check(set)){
+            Vmem_free(VNULL, VMAX2(nrhs*natoms, 1), sizeof(double),
+                      (void **)&charges);
+            PyErr_SetString(PyExc_TypeError,
+                            "each charge set must be a list");
+            return NULL;
+        }
+        if (PyList_Size(set) != natoms){
+            Vmem_free(VNULL, VMAX2(nrhs*natoms, 1), sizeof(double),
+                      (void **)&charges);
+            PyErr_SetString(PyExc_ValueError,
+                            "each charge set needs one charge per atom");
+            return NULL;
+        }
+        for (i=0;i<natoms;i++){
+            charges[irhs*natoms + i] = PyFloat_AsDouble(PyList_GetItem(set, i));
+            /* PyFloat_AsDouble has set a TypeError for a non-number */
+            if ((charges[irhs*natoms + i] == -1.0) && PyErr_Occurred()){
+                Vmem_free(VNULL, VMAX2(nrhs*natoms, 1), sizeof(double),
+                          (void **)&charges);
+                return NULL;
+            }
+        }
+    }
+
+    energy = (double *)Vmem_malloc(VNULL, VMAX2(nrhs, 1), sizeof(double));
+    atomPot = (double *)Vmem_malloc(VNULL, VMAX2(nrhs*natoms, 1),
+                                    sizeof(double));
+    rc = Vpmg_solveMulti(pmg, nrhs, charges, nblock, energy, atomPot);
+
+    result = NULL;
+    if (rc){
+        energies = PyList_New(nrhs);
+        potentials = PyList_New(nrhs);
+        for (irhs=0;irhs<nrhs;irhs++){
+            PyList_SetItem(energies, irhs, PyFloat_FromDouble(energy[irhs]));
+            pots = PyList_New(natoms);
+            for (i=0;i<natoms;i++){
+                PyList_SetItem(pots, i,
+                               PyFloat_FromDouble(atomPot[irhs*natoms + i]));
+            }
+            PyList_SetItem(potentials, irhs, pots);
+        }
+        result = PyTuple_New(2);
+        PyTuple_SetItem(result, 0, energies);
+        PyTuple_SetItem(result, 1, potentials);
+    } else {
+        PyErr_SetString(PyExc_RuntimeError, "error solving the charge sets");
+    }
+
+    Vmem_free(VNULL, VMAX2(nrhs*natoms, 1), sizeof(double), (void **)&charges);
+    Vmem_free(VNULL, VMAX2(nrhs, 1), sizeof(double), (void **)&energy);
+    Vmem_free(VNULL, VMAX2(nrhs*natoms, 1), sizeof(double), (void **)&atomPot);
+    return result;
+}
+
 PyObject *getEnergies(Vpmg *pmg, Valist *alist){
     Vatom *atom; 
     int i;
@@ -5900,6 +5979,40 @@ fail:
 }
 
 
+SWIGINTERN PyObject *_wrap_solveMultiRHS(PyObject *SWIGUNUSEDPARM(self), PyObject *args) {
+  PyObject *resultobj = 0;
+  Vpmg *arg1 = (Vpmg *) 0 ;
+  PyObject *arg2 = (PyObject *) 0 ;
+  int arg3 ;
+  PyObject *result = 0 ;
+  void *argp1 = 0 ;
+  int res1 = 0 ;
+  int val3 ;
+  int ecode3 = 0 ;
+  PyObject * obj0 = 0 ;
+  PyObject * obj1 = 0 ;
+  PyObject * obj2 = 0 ;
+  
+  if (!PyArg_ParseTuple(args,(char *)"OOO:solveMultiRHS",&obj0,&obj1,&obj2)) SWIG_fail;
+  res1 = SWIG_ConvertPtr(obj0, &argp1,SWIGTYPE_p_Vpmg, 0 |  0 );
+  if (!SWIG_IsOK(res1)) {
+    SWIG_exception_fail(SWIG_ArgError(res1), "in method '" "solveMultiRHS" "', argument " "1"" of type '" "Vpmg *""'"); 
+  }
+  arg1 = (Vpmg *)(argp1);
+  arg2 = obj1;
+  ecode3 = SWIG_AsVal_int(obj2, &val3);
+  if (!SWIG_IsOK(ecode3)) {
+    SWIG_exception_fail(SWIG_ArgError(ecode3), "in method '" "solveMultiRHS" "', argument " "3"" of type '" "int""'");
+  } 
+  arg3 = (int)(val3);
+  result = (PyObject *)solveMultiRHS(arg1,arg2,arg3);
+  resultobj = result;
+  return resultobj;
+fail:
+  return NULL;
+}
+
+
 SWIGINTERN PyObject *_wrap_getEnergies(PyObject *SWIGUNUSEDPARM(self), PyObject *args) {
   PyObject *resultobj = 0;
   Vpmg *arg1 = (Vpmg *) 0 ;
@@ -7522,6 +7635,7 @@ static PyMethodDef SwigMethods[] = {
 	 { (char *)"wrap_forceMG", _wrap_wrap_forceMG, METH_VARARGS, NULL},
 	 { (char *)"getAtomPosition", _wrap_getAtomPosition, METH_VARARGS, NULL},
 	 { (char *)"getPotentials", _wrap_getPotentials, METH_VARARGS, NULL},
+	 { (char *)"solveMultiRHS", _wrap_solveMultiRHS, METH_VARARGS, NULL},
 	 { (char *)"getEnergies", _wrap_getEnergies, METH_VARARGS, NULL},
 	 { (char *)"getForces", _wrap_getForces, METH_VARARGS, NULL},
 	 { (char *)"loadMolecules", _wrap_loadMolecules, METH_VARARGS, NULL},
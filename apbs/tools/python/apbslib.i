@@ -56,6 +56,7 @@ typedef struct {
 	MGparm();
 	~MGparm();
 	MGparm_CalcType type;                                           
+	int reuse;
 } MGparm; 
 extern void MGparm_setCenterX(MGparm *thee, double x);
 extern void MGparm_setCenterY(MGparm *thee, double y);
@@ -184,7 +185,7 @@ Vpmgp **new_pmgplist(int maxargs) {
 }
 
 Vpbe **new_pbelist(int maxargs) {
-   return (Vpbe **) malloc(maxargs*sizeof(Vpbe *));
+   return (Vpbe **) calloc(maxargs, sizeof(Vpbe *));
 }
 
 Vpbe *get_Vpbe(Vpbe **args, int n) { 
@@ -380,6 +381,7 @@ PyObject *getPotentials(NOsh *nosh, PBEparm *pbeparm, Vpmg *pmg, Valist *alist){
     double hx, hy, hzed, xcent, ycent, zcent, xmin, ymin, zmin;
     double value;
     double *position;
+    double *data;
     PyObject *values;
     
     values = PyList_New(Valist_getNumberAtoms(alist));
@@ -396,9 +398,12 @@ PyObject *getPotentials(NOsh *nosh, PBEparm *pbeparm, Vpmg *pmg, Valist *alist){
     ymin = ycent - 0.5*(ny-1)*hy;
     zmin = zcent - 0.5*(nz-1)*hzed;
    
-    Vpmg_fillArray(pmg, pmg->rwork, VDT_POT, 0.0, pbeparm->pbetype, pbeparm);
+    /* Not in pmg->rwork, which may hold the multigrid operators for
+     * solveMultiRHS */
+    data = (double *)Vmem_malloc(VNULL, nx*ny*nz, sizeof(double));
+    Vpmg_fillArray(pmg, data, VDT_POT, 0.0, pbeparm->pbetype, pbeparm);
     grid = Vgrid_ctor(nx, ny, nz, hx, hy, hzed, xmin, ymin, zmin,
-                  pmg->rwork);
+                  data);
     for (i=0;i<Valist_getNumberAtoms(alist);i++){
         atom = Valist_getAtom(alist, i);
         position = Vatom_getPosition(atom); 
@@ -406,9 +411,84 @@ PyObject *getPotentials(NOsh *nosh, PBEparm *pbeparm, Vpmg *pmg, Valist *alist){
         PyList_SetItem(values, i, PyFloat_FromDouble(value)); 
     } 
     Vgrid_dtor(&grid);    
+    Vmem_free(VNULL, nx*ny*nz, sizeof(double), (void **)&data);
     return values;
 }
 
+PyObject *solveMultiRHS(Vpmg *pmg, PyObject *chargeSets, int nblock){
+    Valist *alist;
+    int i, irhs, nrhs, natoms, rc;
+    double *charges, *energy, *atomPot;
+    PyObject *set, *energies, *potentials, *pots, *result;
+
+    alist = pmg->pbe->alist;
+    natoms = Valist_getNumberAtoms(alist);
+    if (!PyList_Check(chargeSets)){
+        PyErr_SetString(PyExc_TypeError,
+                        "the charge sets must be a list of lists");
+        return NULL;
+    }
+    nrhs = PyList_Size(chargeSets);
+    charges = (double *)Vmem_malloc(VNULL, VMAX2(nrhs*natoms, 1),
+                                    sizeof(double));
+    for (irhs=0;irhs<nrhs;irhs++){
+        set = PyList_GetItem(chargeSets, irhs);
+        if (!PyList_Check(set)){
+            Vmem_free(VNULL, VMAX2(nrhs*natoms, 1), sizeof(double),
+                      (void **)&charges);
+            PyErr_SetString(PyExc_TypeError,
+                            "each charge set must be a list");
+            return NULL;
+        }
+        if (PyList_Size(set) != natoms){
+            Vmem_free(VNULL, VMAX2(nrhs*natoms, 1), sizeof(double),
+                      (void **)&charges);
+            PyErr_SetString(PyExc_ValueError,
+                            "each charge set needs one charge per atom");
+            return NULL;
+        }
+        for (i=0;i<natoms;i++){
+            charges[irhs*natoms + i] = PyFloat_AsDouble(PyList_GetItem(set, i));
+            /* PyFloat_AsDouble has set a TypeError for a non-number */
+            if ((charges[irhs*natoms + i] == -1.0) && PyErr_Occurred()){
+                Vmem_free(VNULL, VMAX2(nrhs*natoms, 1), sizeof(double),
+                          (void **)&charges);
+                return NULL;
+            }
+        }
+    }
+
+    energy = (double *)Vmem_malloc(VNULL, VMAX2(nrhs, 1), sizeof(double));
+    atomPot = (double *)Vmem_malloc(VNULL, VMAX2(nrhs*natoms, 1),
+                                    sizeof(double));
+    rc = Vpmg_solveMulti(pmg, nrhs, charges, nblock, energy, atomPot);
+
+    result = NULL;
+    if (rc){
+        energies = PyList_New(nrhs);
+        potentials = PyList_New(nrhs);
+        for (irhs=0;irhs<nrhs;irhs++){
+            PyList_SetItem(energies, irhs, PyFloat_FromDouble(energy[irhs]));
+            pots = PyList_New(natoms);
+            for (i=0;i<natoms;i++){
+                PyList_SetItem(pots, i,
+                               PyFloat_FromDouble(atomPot[irhs*natoms + i]));
+            }
+            PyList_SetItem(potentials, irhs, pots);
+        }
+        result = PyTuple_New(2);
+        PyTuple_SetItem(result, 0, energies);
+        PyTuple_SetItem(result, 1, potentials);
+    } else {
+        PyErr_SetString(PyExc_RuntimeError, "error solving the charge sets");
+    }
+
+    Vmem_free(VNULL, VMAX2(nrhs*natoms, 1), sizeof(double), (void **)&charges);
+    Vmem_free(VNULL, VMAX2(nrhs, 1), sizeof(double), (void **)&energy);
+    Vmem_free(VNULL, VMAX2(nrhs*natoms, 1), sizeof(double), (void **)&atomPot);
+    return result;
+}
+
 PyObject *getEnergies(Vpmg *pmg, Valist *alist){
     Vatom *atom; 
     int i;
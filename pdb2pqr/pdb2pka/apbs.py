@@ -349,6 +349,34 @@ class runAPBS:
 
         return potentials
 
+    #
+    # ------
+    #
+
+    def get_potentials_multi(self, charge_sets, nblock=1):
+        """
+            Solve the last calculation of runAPBS again for other sets of
+            atom charges, on its dielectric and kappa maps and its
+            multigrid operators
+
+            Parameters
+                charge_sets: A list of lists of atom charges, in the atom
+                             order of the protein given to runAPBS
+                nblock:      The number of charge sets solved at the same
+                             time (int)
+            Returns
+                energies:    The total electrostatic energy of each set
+                             (kT)
+                potentials:  A list of lists of potentials at atom
+                             locations (kT/e) - one list for each set
+        """
+        try:
+            energies, potentials = solveMultiRHS(self.thispmg, charge_sets,
+                                                 nblock)
+        except (ValueError, RuntimeError), details:
+            raise APBSError(str(details))
+        return energies, potentials
+
 
     #
     # ------